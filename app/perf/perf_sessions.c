@@ -0,0 +1,961 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+
+#include "../sample/sample_util.h"
+
+/*
+ * End to end sessions scaling benchmark, tx sessions on P port and rx sessions on R
+ * port of one instance, the two ports should be connected as a loopback, e.g. a NIC
+ * cable loop, a veth pair with af_xdp or a memif pair.
+ * One result record is produced for each point of the sweep matrix:
+ * type x resolution x fps x packing x sessions count.
+ * The scheduler quota is an init time parameter, use perf_sessions.sh to sweep it.
+ */
+
+#define PERF_LIST_MAX (16)
+#define PERF_UDP_PORT_BASE (20000)
+#define PERF_FB_CNT (3)
+#define PERF_SCH_MAX (64)
+/* the fps target ratio to treat a session as sustained */
+#define PERF_SUSTAINED_RATIO (0.99)
+/* st30: 1ms packet time, 10 packets per frame */
+#define PERF_ST30_PKTS_PER_FRAME (10)
+#define PERF_ST30_FPS (100)
+/* st40 udw bytes per frame */
+#define PERF_ST40_UDW_SIZE (255)
+
+enum perf_type {
+  PERF_TYPE_ST20 = 0,
+  PERF_TYPE_ST22,
+  PERF_TYPE_ST30,
+  PERF_TYPE_ST40,
+  PERF_TYPE_MAX,
+};
+
+static const char* perf_type_names[PERF_TYPE_MAX] = {"st20", "st22", "st30", "st40"};
+
+struct perf_res {
+  const char* name;
+  uint32_t width;
+  uint32_t height;
+};
+
+static const struct perf_res perf_resolutions[] = {
+    {"720p", 1280, 720},
+    {"1080p", 1920, 1080},
+    {"2160p", 3840, 2160},
+};
+
+struct perf_fps {
+  const char* name;
+  enum st_fps fps;
+};
+
+static const struct perf_fps perf_fpss[] = {
+    {"p25", ST_FPS_P25},
+    {"p29", ST_FPS_P29_97},
+    {"p50", ST_FPS_P50},
+    {"p59", ST_FPS_P59_94},
+};
+
+static const char* perf_packing_names[ST20_PACKING_MAX] = {"bpm", "gpm", "gpm_sl"};
+
+struct perf_context;
+
+struct perf_session {
+  int idx;
+  struct perf_context* ctx;
+  void* tx_handle;
+  void* rx_handle;
+  uint16_t tx_fb_idx;
+  uint32_t sampling_rate; /* media clock rate for latency */
+  uint8_t* st40_udw;
+
+  /* stats, updated from the tasklet context */
+  bool measure;
+  uint64_t tx_frames;
+  uint64_t rx_frames;
+  uint64_t rx_dropped;
+  uint64_t* lat_ns;
+  uint32_t lat_cnt;
+  uint32_t lat_max;
+};
+
+struct perf_point {
+  enum perf_type type;
+  const struct perf_res* res;
+  const struct perf_fps* fps;
+  enum st20_packing packing;
+  int sessions;
+};
+
+struct perf_context {
+  struct st_sample_context sample;
+
+  enum perf_type type;
+  int sessions_list[PERF_LIST_MAX];
+  int sessions_nb;
+  int res_list[PERF_LIST_MAX];
+  int res_nb;
+  int fps_list[PERF_LIST_MAX];
+  int fps_nb;
+  int packing_list[PERF_LIST_MAX];
+  int packing_nb;
+  int sch_quota; /* number of 1080p59 streams per sch, 0 for lib default */
+  bool sch_sleep;
+  int warmup_s;
+  int duration_s;
+
+  char json_url[ST_SAMPLE_URL_MAX_LEN];
+  FILE* json;
+  int json_records;
+};
+
+enum perf_args_cmd {
+  PERF_ARG_UNKNOWN = 0,
+
+  PERF_ARG_TYPE = 0x100, /* start from end of ascii */
+  PERF_ARG_SESSIONS_LIST,
+  PERF_ARG_RES_LIST,
+  PERF_ARG_FPS_LIST,
+  PERF_ARG_PACKING_LIST,
+  PERF_ARG_SCH_QUOTA,
+  PERF_ARG_SCH_SLEEP,
+  PERF_ARG_WARMUP,
+  PERF_ARG_DURATION,
+  PERF_ARG_JSON,
+
+  PERF_ARG_MAX,
+};
+
+static struct option perf_args_options[] = {
+    {"type", required_argument, 0, PERF_ARG_TYPE},
+    {"sessions_list", required_argument, 0, PERF_ARG_SESSIONS_LIST},
+    {"res_list", required_argument, 0, PERF_ARG_RES_LIST},
+    {"fps_list", required_argument, 0, PERF_ARG_FPS_LIST},
+    {"packing_list", required_argument, 0, PERF_ARG_PACKING_LIST},
+    {"sch_quota", required_argument, 0, PERF_ARG_SCH_QUOTA},
+    {"sch_sleep", no_argument, 0, PERF_ARG_SCH_SLEEP},
+    {"warmup", required_argument, 0, PERF_ARG_WARMUP},
+    {"duration", required_argument, 0, PERF_ARG_DURATION},
+    {"json", required_argument, 0, PERF_ARG_JSON},
+
+    {0, 0, 0, 0}};
+
+static int perf_parse_int_list(const char* str, int* list) {
+  char buf[256];
+  char *token, *save = NULL;
+  int nb = 0;
+
+  snprintf(buf, sizeof(buf), "%s", str);
+  token = strtok_r(buf, ",", &save);
+  while (token && (nb < PERF_LIST_MAX)) {
+    if (atoi(token) > 0) list[nb++] = atoi(token);
+    token = strtok_r(NULL, ",", &save);
+  }
+
+  return nb;
+}
+
+static int perf_parse_name_list(const char* str, int* list, const char* const* names,
+                                int names_nb, size_t name_stride) {
+  char buf[256];
+  char *token, *save = NULL;
+  int nb = 0;
+
+  snprintf(buf, sizeof(buf), "%s", str);
+  token = strtok_r(buf, ",", &save);
+  while (token && (nb < PERF_LIST_MAX)) {
+    int i;
+    for (i = 0; i < names_nb; i++) {
+      const char* name = *(const char* const*)((const uint8_t*)names + i * name_stride);
+      if (!strcmp(token, name)) break;
+    }
+    if (i < names_nb)
+      list[nb++] = i;
+    else
+      err("%s, unknown item %s\n", __func__, token);
+    token = strtok_r(NULL, ",", &save);
+  }
+
+  return nb;
+}
+
+static int perf_parse_args(struct perf_context* ctx, int argc, char** argv) {
+  int cmd = -1, optIdx = 0;
+
+  /* the sample options are parsed by sample_parse_args already */
+  optind = 1;
+  while (1) {
+    cmd = getopt_long_only(argc, argv, "hv", perf_args_options, &optIdx);
+    if (cmd == -1) break;
+    dbg("%s, cmd %d %s\n", __func__, cmd, optarg);
+
+    switch (cmd) {
+      case PERF_ARG_TYPE: {
+        int i;
+        for (i = 0; i < PERF_TYPE_MAX; i++) {
+          if (!strcmp(optarg, perf_type_names[i])) break;
+        }
+        if (i < PERF_TYPE_MAX)
+          ctx->type = i;
+        else
+          err("%s, unknown type %s\n", __func__, optarg);
+        break;
+      }
+      case PERF_ARG_SESSIONS_LIST:
+        ctx->sessions_nb = perf_parse_int_list(optarg, ctx->sessions_list);
+        break;
+      case PERF_ARG_RES_LIST:
+        ctx->res_nb = perf_parse_name_list(optarg, ctx->res_list,
+                                           &perf_resolutions[0].name,
+                                           MTL_ARRAY_SIZE(perf_resolutions),
+                                           sizeof(struct perf_res));
+        break;
+      case PERF_ARG_FPS_LIST:
+        ctx->fps_nb =
+            perf_parse_name_list(optarg, ctx->fps_list, &perf_fpss[0].name,
+                                 MTL_ARRAY_SIZE(perf_fpss), sizeof(struct perf_fps));
+        break;
+      case PERF_ARG_PACKING_LIST:
+        ctx->packing_nb = perf_parse_name_list(optarg, ctx->packing_list,
+                                               perf_packing_names, ST20_PACKING_MAX,
+                                               sizeof(perf_packing_names[0]));
+        break;
+      case PERF_ARG_SCH_QUOTA:
+        ctx->sch_quota = atoi(optarg);
+        break;
+      case PERF_ARG_SCH_SLEEP:
+        ctx->sch_sleep = true;
+        break;
+      case PERF_ARG_WARMUP:
+        ctx->warmup_s = atoi(optarg);
+        break;
+      case PERF_ARG_DURATION:
+        ctx->duration_s = atoi(optarg);
+        break;
+      case PERF_ARG_JSON:
+        snprintf(ctx->json_url, sizeof(ctx->json_url), "%s", optarg);
+        break;
+      default:
+        break;
+    }
+  };
+
+  /* default sweep */
+  if (!ctx->sessions_nb) {
+    ctx->sessions_list[0] = 1;
+    ctx->sessions_list[1] = 2;
+    ctx->sessions_list[2] = 4;
+    ctx->sessions_list[3] = 8;
+    ctx->sessions_nb = 4;
+  }
+  if (!ctx->res_nb) {
+    ctx->res_list[0] = 1; /* 1080p */
+    ctx->res_nb = 1;
+  }
+  if (!ctx->fps_nb) {
+    ctx->fps_list[0] = 3; /* p59 */
+    ctx->fps_nb = 1;
+  }
+  if (!ctx->packing_nb) {
+    ctx->packing_list[0] = ST20_PACKING_BPM;
+    ctx->packing_nb = 1;
+  }
+  /* audio and anc have no resolution/packing */
+  if ((ctx->type == PERF_TYPE_ST30) || (ctx->type == PERF_TYPE_ST40)) {
+    ctx->res_nb = 1;
+    ctx->packing_nb = 1;
+  }
+  if (ctx->type == PERF_TYPE_ST30) ctx->fps_nb = 1;
+  if (ctx->type != PERF_TYPE_ST20) ctx->packing_nb = 1;
+
+  return 0;
+}
+
+static void perf_latency_add(struct perf_session* s, enum st10_timestamp_fmt tfmt,
+                             uint64_t timestamp) {
+  uint32_t now, media_ts;
+
+  if (s->lat_cnt >= s->lat_max) return;
+  /* both ports share the same ptp source in one instance */
+  now = st10_tai_to_media_clk(mtl_ptp_read_time(s->ctx->sample.st), s->sampling_rate);
+  media_ts = st10_get_media_clk(tfmt, timestamp, s->sampling_rate);
+  s->lat_ns[s->lat_cnt++] = st10_media_clk_to_ns(now - media_ts, s->sampling_rate);
+}
+
+static void perf_rx_frame(struct perf_session* s, enum st_frame_status status,
+                          enum st10_timestamp_fmt tfmt, uint64_t timestamp) {
+  if (!s->measure) return;
+
+  if (st_is_frame_complete(status)) {
+    s->rx_frames++;
+    perf_latency_add(s, tfmt, timestamp);
+  } else {
+    s->rx_dropped++;
+  }
+}
+
+static int perf_tx_next_idx(struct perf_session* s, uint16_t* next_frame_idx) {
+  if (!s->tx_handle) return -EIO; /* not ready */
+
+  /* the frames are built once at create, just round robin */
+  *next_frame_idx = s->tx_fb_idx;
+  s->tx_fb_idx++;
+  if (s->tx_fb_idx >= PERF_FB_CNT) s->tx_fb_idx = 0;
+  return 0;
+}
+
+static int perf_tx_done(struct perf_session* s) {
+  if (s->measure) s->tx_frames++;
+  return 0;
+}
+
+static int perf_st20_next_frame(void* priv, uint16_t* next_frame_idx,
+                                struct st20_tx_frame_meta* meta) {
+  return perf_tx_next_idx(priv, next_frame_idx);
+}
+
+static int perf_st20_frame_done(void* priv, uint16_t frame_idx,
+                                struct st20_tx_frame_meta* meta) {
+  return perf_tx_done(priv);
+}
+
+static int perf_st20_frame_ready(void* priv, void* frame,
+                                 struct st20_rx_frame_meta* meta) {
+  struct perf_session* s = priv;
+
+  if (!s->rx_handle) return -EIO;
+  perf_rx_frame(s, meta->status, meta->tfmt, meta->timestamp);
+  st20_rx_put_framebuff(s->rx_handle, frame);
+  return 0;
+}
+
+static int perf_st22_next_frame(void* priv, uint16_t* next_frame_idx,
+                                struct st22_tx_frame_meta* meta) {
+  struct perf_session* s = priv;
+  int ret = perf_tx_next_idx(s, next_frame_idx);
+
+  if (ret >= 0) /* constant bitrate, bpp 3 */
+    meta->codestream_size = (size_t)meta->width * meta->height * 3 / 8;
+  return ret;
+}
+
+static int perf_st22_frame_done(void* priv, uint16_t frame_idx,
+                                struct st22_tx_frame_meta* meta) {
+  return perf_tx_done(priv);
+}
+
+static int perf_st22_frame_ready(void* priv, void* frame,
+                                 struct st22_rx_frame_meta* meta) {
+  struct perf_session* s = priv;
+
+  if (!s->rx_handle) return -EIO;
+  perf_rx_frame(s, meta->status, meta->tfmt, meta->timestamp);
+  st22_rx_put_framebuff(s->rx_handle, frame);
+  return 0;
+}
+
+static int perf_st30_next_frame(void* priv, uint16_t* next_frame_idx,
+                                struct st30_tx_frame_meta* meta) {
+  return perf_tx_next_idx(priv, next_frame_idx);
+}
+
+static int perf_st30_frame_done(void* priv, uint16_t frame_idx,
+                                struct st30_tx_frame_meta* meta) {
+  return perf_tx_done(priv);
+}
+
+static int perf_st30_frame_ready(void* priv, void* frame,
+                                 struct st30_rx_frame_meta* meta) {
+  struct perf_session* s = priv;
+
+  if (!s->rx_handle) return -EIO;
+  perf_rx_frame(s, ST_FRAME_STATUS_COMPLETE, meta->tfmt, meta->timestamp);
+  st30_rx_put_framebuff(s->rx_handle, frame);
+  return 0;
+}
+
+static int perf_st40_next_frame(void* priv, uint16_t* next_frame_idx,
+                                struct st40_tx_frame_meta* meta) {
+  return perf_tx_next_idx(priv, next_frame_idx);
+}
+
+static int perf_st40_frame_done(void* priv, uint16_t frame_idx,
+                                struct st40_tx_frame_meta* meta) {
+  return perf_tx_done(priv);
+}
+
+static int perf_st40_rtp_ready(void* priv) {
+  struct perf_session* s = priv;
+  struct st_rfc3550_rtp_hdr* hdr;
+  void* usrptr;
+  uint16_t len;
+  void* mbuf;
+
+  if (!s->rx_handle) return -EIO;
+
+  while ((mbuf = st40_rx_get_mbuf(s->rx_handle, &usrptr, &len))) {
+    hdr = usrptr;
+    /* one rtp packet for each anc frame */
+    perf_rx_frame(s, ST_FRAME_STATUS_COMPLETE, ST10_TIMESTAMP_FMT_MEDIA_CLK,
+                  ntohl(hdr->tmstamp));
+    st40_rx_put_mbuf(s->rx_handle, mbuf);
+  }
+
+  return 0;
+}
+
+static int perf_st20_create(struct perf_context* ctx, struct perf_session* s,
+                            struct perf_point* point) {
+  struct st_sample_context* sample = &ctx->sample;
+  struct mtl_init_params* p = &sample->param;
+  uint16_t udp_port = PERF_UDP_PORT_BASE + s->idx * 2;
+
+  struct st20_rx_ops ops_rx;
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = "perf_st20_rx";
+  ops_rx.priv = s;
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], mtl_p_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], mtl_r_port(p), MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = udp_port;
+  ops_rx.pacing = ST21_PACING_NARROW;
+  ops_rx.type = ST20_TYPE_FRAME_LEVEL;
+  ops_rx.packing = point->packing;
+  ops_rx.width = point->res->width;
+  ops_rx.height = point->res->height;
+  ops_rx.fps = point->fps->fps;
+  ops_rx.fmt = sample->fmt;
+  ops_rx.payload_type = sample->payload_type;
+  ops_rx.flags = ST20_RX_FLAG_RECEIVE_INCOMPLETE_FRAME;
+  ops_rx.framebuff_cnt = PERF_FB_CNT;
+  ops_rx.notify_frame_ready = perf_st20_frame_ready;
+  s->rx_handle = st20_rx_create(sample->st, &ops_rx);
+  if (!s->rx_handle) return -EIO;
+
+  struct st20_tx_ops ops_tx;
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = "perf_st20_tx";
+  ops_tx.priv = s;
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], mtl_r_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_tx.port[MTL_PORT_P], mtl_p_port(p), MTL_PORT_MAX_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = udp_port;
+  ops_tx.pacing = ST21_PACING_NARROW;
+  ops_tx.type = ST20_TYPE_FRAME_LEVEL;
+  ops_tx.packing = point->packing;
+  ops_tx.width = point->res->width;
+  ops_tx.height = point->res->height;
+  ops_tx.fps = point->fps->fps;
+  ops_tx.fmt = sample->fmt;
+  ops_tx.payload_type = sample->payload_type;
+  ops_tx.framebuff_cnt = PERF_FB_CNT;
+  ops_tx.get_next_frame = perf_st20_next_frame;
+  ops_tx.notify_frame_done = perf_st20_frame_done;
+  s->tx_handle = st20_tx_create(sample->st, &ops_tx);
+  if (!s->tx_handle) return -EIO;
+
+  s->sampling_rate = 90 * 1000;
+  return 0;
+}
+
+static int perf_st22_create(struct perf_context* ctx, struct perf_session* s,
+                            struct perf_point* point) {
+  struct st_sample_context* sample = &ctx->sample;
+  struct mtl_init_params* p = &sample->param;
+  uint16_t udp_port = PERF_UDP_PORT_BASE + s->idx * 2;
+  size_t fb_size = (size_t)point->res->width * point->res->height * 3 / 8;
+
+  struct st22_rx_ops ops_rx;
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = "perf_st22_rx";
+  ops_rx.priv = s;
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], mtl_p_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], mtl_r_port(p), MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = udp_port;
+  ops_rx.pacing = ST21_PACING_NARROW;
+  ops_rx.type = ST22_TYPE_FRAME_LEVEL;
+  ops_rx.pack_type = ST22_PACK_CODESTREAM;
+  ops_rx.width = point->res->width;
+  ops_rx.height = point->res->height;
+  ops_rx.fps = point->fps->fps;
+  ops_rx.payload_type = sample->payload_type;
+  ops_rx.flags = ST22_RX_FLAG_RECEIVE_INCOMPLETE_FRAME;
+  ops_rx.framebuff_cnt = PERF_FB_CNT;
+  ops_rx.framebuff_max_size = fb_size;
+  ops_rx.notify_frame_ready = perf_st22_frame_ready;
+  s->rx_handle = st22_rx_create(sample->st, &ops_rx);
+  if (!s->rx_handle) return -EIO;
+
+  struct st22_tx_ops ops_tx;
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = "perf_st22_tx";
+  ops_tx.priv = s;
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], mtl_r_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_tx.port[MTL_PORT_P], mtl_p_port(p), MTL_PORT_MAX_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = udp_port;
+  ops_tx.pacing = ST21_PACING_NARROW;
+  ops_tx.type = ST22_TYPE_FRAME_LEVEL;
+  ops_tx.pack_type = ST22_PACK_CODESTREAM;
+  ops_tx.width = point->res->width;
+  ops_tx.height = point->res->height;
+  ops_tx.fps = point->fps->fps;
+  ops_tx.payload_type = sample->payload_type;
+  ops_tx.framebuff_cnt = PERF_FB_CNT;
+  ops_tx.framebuff_max_size = fb_size;
+  ops_tx.get_next_frame = perf_st22_next_frame;
+  ops_tx.notify_frame_done = perf_st22_frame_done;
+  s->tx_handle = st22_tx_create(sample->st, &ops_tx);
+  if (!s->tx_handle) return -EIO;
+
+  s->sampling_rate = 90 * 1000;
+  return 0;
+}
+
+static int perf_st30_create(struct perf_context* ctx, struct perf_session* s,
+                            struct perf_point* point) {
+  struct st_sample_context* sample = &ctx->sample;
+  struct mtl_init_params* p = &sample->param;
+  uint16_t udp_port = PERF_UDP_PORT_BASE + s->idx * 2;
+  enum st30_fmt fmt = ST30_FMT_PCM24;
+  enum st30_sampling sampling = ST30_SAMPLING_48K;
+  enum st30_ptime ptime = ST30_PTIME_1MS;
+  uint16_t channel = 2;
+  uint16_t sample_size = st30_get_sample_size(fmt);
+  uint16_t sample_num = st30_get_sample_num(ptime, sampling);
+  uint32_t fb_size = sample_size * sample_num * channel * PERF_ST30_PKTS_PER_FRAME;
+
+  struct st30_rx_ops ops_rx;
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = "perf_st30_rx";
+  ops_rx.priv = s;
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], mtl_p_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], mtl_r_port(p), MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = udp_port;
+  ops_rx.type = ST30_TYPE_FRAME_LEVEL;
+  ops_rx.fmt = fmt;
+  ops_rx.channel = channel;
+  ops_rx.sampling = sampling;
+  ops_rx.ptime = ptime;
+  ops_rx.payload_type = 111;
+  ops_rx.sample_size = sample_size;
+  ops_rx.sample_num = sample_num;
+  ops_rx.framebuff_cnt = PERF_FB_CNT;
+  ops_rx.framebuff_size = fb_size;
+  ops_rx.notify_frame_ready = perf_st30_frame_ready;
+  s->rx_handle = st30_rx_create(sample->st, &ops_rx);
+  if (!s->rx_handle) return -EIO;
+
+  struct st30_tx_ops ops_tx;
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = "perf_st30_tx";
+  ops_tx.priv = s;
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], mtl_r_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_tx.port[MTL_PORT_P], mtl_p_port(p), MTL_PORT_MAX_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = udp_port;
+  ops_tx.type = ST30_TYPE_FRAME_LEVEL;
+  ops_tx.fmt = fmt;
+  ops_tx.channel = channel;
+  ops_tx.sampling = sampling;
+  ops_tx.ptime = ptime;
+  ops_tx.payload_type = 111;
+  ops_tx.sample_size = sample_size;
+  ops_tx.sample_num = sample_num;
+  ops_tx.framebuff_cnt = PERF_FB_CNT;
+  ops_tx.framebuff_size = fb_size;
+  ops_tx.get_next_frame = perf_st30_next_frame;
+  ops_tx.notify_frame_done = perf_st30_frame_done;
+  s->tx_handle = st30_tx_create(sample->st, &ops_tx);
+  if (!s->tx_handle) return -EIO;
+
+  s->sampling_rate = st30_get_sample_rate(sampling);
+  return 0;
+}
+
+static int perf_st40_create(struct perf_context* ctx, struct perf_session* s,
+                            struct perf_point* point) {
+  struct st_sample_context* sample = &ctx->sample;
+  struct mtl_init_params* p = &sample->param;
+  uint16_t udp_port = PERF_UDP_PORT_BASE + s->idx * 2;
+
+  struct st40_rx_ops ops_rx;
+  memset(&ops_rx, 0, sizeof(ops_rx));
+  ops_rx.name = "perf_st40_rx";
+  ops_rx.priv = s;
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], mtl_p_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], mtl_r_port(p), MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = udp_port;
+  ops_rx.payload_type = 113;
+  ops_rx.rtp_ring_size = 1024;
+  ops_rx.notify_rtp_ready = perf_st40_rtp_ready;
+  s->rx_handle = st40_rx_create(sample->st, &ops_rx);
+  if (!s->rx_handle) return -EIO;
+
+  struct st40_tx_ops ops_tx;
+  memset(&ops_tx, 0, sizeof(ops_tx));
+  ops_tx.name = "perf_st40_tx";
+  ops_tx.priv = s;
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], mtl_r_sip_addr(p), MTL_IP_ADDR_LEN);
+  strncpy(ops_tx.port[MTL_PORT_P], mtl_p_port(p), MTL_PORT_MAX_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = udp_port;
+  ops_tx.type = ST40_TYPE_FRAME_LEVEL;
+  ops_tx.fps = point->fps->fps;
+  ops_tx.payload_type = 113;
+  ops_tx.framebuff_cnt = PERF_FB_CNT;
+  ops_tx.get_next_frame = perf_st40_next_frame;
+  ops_tx.notify_frame_done = perf_st40_frame_done;
+  st40_tx_handle tx_handle = st40_tx_create(sample->st, &ops_tx);
+  if (!tx_handle) return -EIO;
+
+  s->st40_udw = malloc(PERF_ST40_UDW_SIZE);
+  if (!s->st40_udw) {
+    st40_tx_free(tx_handle);
+    return -ENOMEM;
+  }
+  for (int i = 0; i < PERF_ST40_UDW_SIZE; i++) s->st40_udw[i] = i;
+  for (uint16_t i = 0; i < PERF_FB_CNT; i++) {
+    struct st40_frame* frame = st40_tx_get_framebuffer(tx_handle, i);
+    frame->meta[0].c = 0;
+    frame->meta[0].line_number = 10;
+    frame->meta[0].hori_offset = 0;
+    frame->meta[0].s = 0;
+    frame->meta[0].stream_num = 0;
+    frame->meta[0].did = 0x43;
+    frame->meta[0].sdid = 0x02;
+    frame->meta[0].udw_size = PERF_ST40_UDW_SIZE;
+    frame->meta[0].udw_offset = 0;
+    frame->data = s->st40_udw;
+    frame->data_size = PERF_ST40_UDW_SIZE;
+    frame->meta_num = 1;
+  }
+  /* frames are ready now */
+  s->tx_handle = tx_handle;
+
+  s->sampling_rate = 90 * 1000;
+  return 0;
+}
+
+static void perf_session_free(struct perf_context* ctx, struct perf_session* s) {
+  void* tx_handle = s->tx_handle;
+  void* rx_handle = s->rx_handle;
+
+  s->tx_handle = NULL;
+  s->rx_handle = NULL;
+  switch (ctx->type) {
+    case PERF_TYPE_ST20:
+      if (tx_handle) st20_tx_free(tx_handle);
+      if (rx_handle) st20_rx_free(rx_handle);
+      break;
+    case PERF_TYPE_ST22:
+      if (tx_handle) st22_tx_free(tx_handle);
+      if (rx_handle) st22_rx_free(rx_handle);
+      break;
+    case PERF_TYPE_ST30:
+      if (tx_handle) st30_tx_free(tx_handle);
+      if (rx_handle) st30_rx_free(rx_handle);
+      break;
+    case PERF_TYPE_ST40:
+      if (tx_handle) st40_tx_free(tx_handle);
+      if (rx_handle) st40_rx_free(rx_handle);
+      break;
+    default:
+      break;
+  }
+  if (s->st40_udw) {
+    free(s->st40_udw);
+    s->st40_udw = NULL;
+  }
+  if (s->lat_ns) {
+    free(s->lat_ns);
+    s->lat_ns = NULL;
+  }
+}
+
+static double perf_point_fps(struct perf_point* point) {
+  if (point->type == PERF_TYPE_ST30) return PERF_ST30_FPS;
+  return st_frame_rate(point->fps->fps);
+}
+
+static int perf_session_create(struct perf_context* ctx, struct perf_session* s,
+                               struct perf_point* point) {
+  /* margin for the fps drift */
+  s->lat_max = perf_point_fps(point) * ctx->duration_s * 1.1 + 16;
+  s->lat_ns = malloc(sizeof(*s->lat_ns) * s->lat_max);
+  if (!s->lat_ns) return -ENOMEM;
+
+  switch (ctx->type) {
+    case PERF_TYPE_ST20:
+      return perf_st20_create(ctx, s, point);
+    case PERF_TYPE_ST22:
+      return perf_st22_create(ctx, s, point);
+    case PERF_TYPE_ST30:
+      return perf_st30_create(ctx, s, point);
+    case PERF_TYPE_ST40:
+      return perf_st40_create(ctx, s, point);
+    default:
+      return -EINVAL;
+  }
+}
+
+static int perf_sch_idx(struct perf_context* ctx, struct perf_session* s, bool tx) {
+  switch (ctx->type) {
+    case PERF_TYPE_ST20:
+      return tx ? st20_tx_get_sch_idx(s->tx_handle) : st20_rx_get_sch_idx(s->rx_handle);
+    case PERF_TYPE_ST22:
+      return tx ? st22_tx_get_sch_idx(s->tx_handle) : st22_rx_get_sch_idx(s->rx_handle);
+    default:
+      return 0; /* audio and anc tasklets are on the main sch */
+  }
+}
+
+static int perf_u64_cmp(const void* a, const void* b) {
+  uint64_t va = *(const uint64_t*)a;
+  uint64_t vb = *(const uint64_t*)b;
+
+  if (va < vb) return -1;
+  if (va > vb) return 1;
+  return 0;
+}
+
+static double perf_percentile_us(uint64_t* lat, uint32_t cnt, double percent) {
+  if (!cnt) return 0;
+  uint32_t pos = (uint32_t)(percent * (cnt - 1) / 100.0 + 0.5);
+  return (double)lat[pos] / 1000;
+}
+
+static void perf_sleep_s(struct perf_context* ctx, int s) {
+  for (int i = 0; i < s * 10; i++) {
+    if (ctx->sample.exit) break;
+    st_usleep(100 * 1000);
+  }
+}
+
+static int perf_run_point(struct perf_context* ctx, struct perf_point* point) {
+  int sessions = point->sessions;
+  struct perf_session* app;
+  bool sch_used[PERF_SCH_MAX];
+  int ret;
+
+  app = calloc(sessions, sizeof(*app));
+  if (!app) return -ENOMEM;
+
+  /* create all sessions in the same order, keep the queue pairing for memif */
+  for (int i = 0; i < sessions; i++) {
+    app[i].idx = i;
+    app[i].ctx = ctx;
+    ret = perf_session_create(ctx, &app[i], point);
+    if (ret < 0) {
+      err("%s(%d), session create fail %d\n", __func__, i, ret);
+      goto exit;
+    }
+  }
+
+  perf_sleep_s(ctx, ctx->warmup_s);
+  for (int i = 0; i < sessions; i++) app[i].measure = true;
+  uint64_t start_ns = mtl_ptp_read_time(ctx->sample.st);
+  perf_sleep_s(ctx, ctx->duration_s);
+  for (int i = 0; i < sessions; i++) app[i].measure = false;
+  uint64_t dur_ns = mtl_ptp_read_time(ctx->sample.st) - start_ns;
+  double dur_s = (double)dur_ns / (1000 * 1000 * 1000);
+
+  /* collect the result */
+  uint64_t tx_frames = 0, rx_frames = 0, rx_dropped = 0;
+  uint32_t lat_cnt = 0;
+  double expect_fps = perf_point_fps(point);
+  double min_rx_fps = expect_fps * 100;
+  for (int i = 0; i < sessions; i++) {
+    tx_frames += app[i].tx_frames;
+    rx_frames += app[i].rx_frames;
+    rx_dropped += app[i].rx_dropped;
+    lat_cnt += app[i].lat_cnt;
+    double rx_fps = (double)app[i].rx_frames / dur_s;
+    if (rx_fps < min_rx_fps) min_rx_fps = rx_fps;
+  }
+  uint64_t* lat = malloc(sizeof(*lat) * (lat_cnt + 1));
+  if (!lat) {
+    ret = -ENOMEM;
+    goto exit;
+  }
+  uint32_t pos = 0;
+  for (int i = 0; i < sessions; i++) {
+    memcpy(&lat[pos], app[i].lat_ns, sizeof(*lat) * app[i].lat_cnt);
+    pos += app[i].lat_cnt;
+  }
+  qsort(lat, lat_cnt, sizeof(*lat), perf_u64_cmp);
+
+  struct mtl_stats stats;
+  memset(&stats, 0, sizeof(stats));
+  mtl_get_stats(ctx->sample.st, &stats);
+  int sch_cnt = 0;
+  memset(sch_used, 0, sizeof(sch_used));
+  for (int i = 0; i < sessions; i++) {
+    int tx_sch = perf_sch_idx(ctx, &app[i], true);
+    int rx_sch = perf_sch_idx(ctx, &app[i], false);
+    if ((tx_sch >= 0) && (tx_sch < PERF_SCH_MAX)) sch_used[tx_sch] = true;
+    if ((rx_sch >= 0) && (rx_sch < PERF_SCH_MAX)) sch_used[rx_sch] = true;
+  }
+  for (int i = 0; i < PERF_SCH_MAX; i++) {
+    if (sch_used[i]) sch_cnt++;
+  }
+  bool sustained =
+      (min_rx_fps >= (expect_fps * PERF_SUSTAINED_RATIO)) && (rx_dropped == 0);
+  double sessions_per_core = sch_cnt ? (double)sessions / sch_cnt : 0;
+
+  info("%s, %s %s %.2ffps %s sessions %d, sustained %s, sch %d, rx fps min %f\n",
+       __func__, perf_type_names[point->type], point->res->name, expect_fps,
+       perf_packing_names[point->packing], sessions, sustained ? "yes" : "no", sch_cnt,
+       min_rx_fps);
+
+  /* the json record */
+  FILE* fp = ctx->json;
+  if (fp) {
+    fprintf(fp, "%s\n    {\n", ctx->json_records ? "," : "");
+    fprintf(fp, "      \"type\": \"%s\",\n", perf_type_names[point->type]);
+    fprintf(fp, "      \"width\": %u,\n", point->res->width);
+    fprintf(fp, "      \"height\": %u,\n", point->res->height);
+    /* the frame rate, for st30 it's the frames per second of the packet time */
+    fprintf(fp, "      \"fps\": %.2f,\n", expect_fps);
+    fprintf(fp, "      \"packing\": \"%s\",\n", perf_packing_names[point->packing]);
+    fprintf(fp, "      \"sessions\": %d,\n", sessions);
+    fprintf(fp, "      \"sch_quota\": %d,\n", ctx->sch_quota);
+    fprintf(fp, "      \"sch_cnt\": %d,\n", sch_cnt);
+    fprintf(fp, "      \"lcore_cnt\": %u,\n", stats.lcore_cnt);
+    fprintf(fp, "      \"sustained\": %s,\n", sustained ? "true" : "false");
+    fprintf(fp, "      \"sessions_per_core\": %.2f,\n", sessions_per_core);
+    fprintf(fp, "      \"duration_s\": %.2f,\n", dur_s);
+    fprintf(fp, "      \"expect_fps\": %.2f,\n", expect_fps);
+    fprintf(fp, "      \"min_rx_fps\": %.2f,\n", min_rx_fps);
+    fprintf(fp, "      \"tx_frames\": %" PRIu64 ",\n", tx_frames);
+    fprintf(fp, "      \"rx_frames\": %" PRIu64 ",\n", rx_frames);
+    fprintf(fp, "      \"rx_dropped\": %" PRIu64 ",\n", rx_dropped);
+    fprintf(fp,
+            "      \"latency_us\": {\"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, "
+            "\"p999\": %.1f, \"max\": %.1f},\n",
+            perf_percentile_us(lat, lat_cnt, 50), perf_percentile_us(lat, lat_cnt, 90),
+            perf_percentile_us(lat, lat_cnt, 99), perf_percentile_us(lat, lat_cnt, 99.9),
+            perf_percentile_us(lat, lat_cnt, 100));
+    fprintf(fp, "      \"sch\": [");
+    bool first = true;
+    for (int i = 0; i < PERF_SCH_MAX; i++) {
+      struct mtl_sch_stats sch_stats;
+      if (!sch_used[i]) continue;
+      if (mtl_sch_get_stats(ctx->sample.st, i, &sch_stats) < 0) continue;
+      fprintf(fp,
+              "%s\n        {\"idx\": %d, \"lcore\": %u, \"tasklets\": %d, "
+              "\"busy_ratio\": %.1f}",
+              first ? "" : ",", i, sch_stats.lcore, sch_stats.tasklet_cnt,
+              sch_stats.busy_ratio);
+      first = false;
+    }
+    fprintf(fp, "\n      ]\n    }");
+    fflush(fp);
+    ctx->json_records++;
+  }
+  free(lat);
+  ret = sustained ? 1 : 0;
+
+exit:
+  for (int i = sessions - 1; i >= 0; i--) perf_session_free(ctx, &app[i]);
+  free(app);
+  return ret;
+}
+
+static int perf_sweep(struct perf_context* ctx) {
+  struct perf_point point;
+  int ret;
+
+  memset(&point, 0, sizeof(point));
+  point.type = ctx->type;
+  for (int r = 0; r < ctx->res_nb; r++) {
+    point.res = &perf_resolutions[ctx->res_list[r]];
+    for (int f = 0; f < ctx->fps_nb; f++) {
+      point.fps = &perf_fpss[ctx->fps_list[f]];
+      for (int k = 0; k < ctx->packing_nb; k++) {
+        point.packing = ctx->packing_list[k];
+        for (int n = 0; n < ctx->sessions_nb; n++) {
+          if (ctx->sample.exit) return 0;
+          point.sessions = ctx->sessions_list[n];
+          ret = perf_run_point(ctx, &point);
+          if (ret < 0) {
+            err("%s, run fail %d with %d sessions\n", __func__, ret, point.sessions);
+            return ret;
+          }
+          /* stop scaling if it can't sustain already */
+          if (!ret) break;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  struct perf_context ctx;
+  struct mtl_init_params* p = &ctx.sample.param;
+  int ret;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.warmup_s = 2;
+  ctx.duration_s = 10;
+  snprintf(ctx.json_url, sizeof(ctx.json_url), "%s", "perf_sessions.json");
+  /* perf options are unknown to the sample parser */
+  opterr = 0;
+  ret = fwd_sample_parse_args(&ctx.sample, argc, argv);
+  if (ret < 0) return ret;
+  perf_parse_args(&ctx, argc, argv);
+
+  /* tx on p_port and rx on r_port, the two ports should be a loopback */
+  p->num_ports = 2;
+
+  int max_sessions = 0;
+  for (int i = 0; i < ctx.sessions_nb; i++) {
+    if (ctx.sessions_list[i] > max_sessions) max_sessions = ctx.sessions_list[i];
+  }
+  p->tx_sessions_cnt_max = max_sessions;
+  p->rx_sessions_cnt_max = max_sessions;
+  if (ctx.sch_quota)
+    p->data_quota_mbs_per_sch = ctx.sch_quota * st20_1080p59_yuv422_10bit_bandwidth_mps();
+  if (ctx.sch_sleep) p->flags |= MTL_FLAG_TASKLET_SLEEP;
+
+  ctx.json = fopen(ctx.json_url, "w");
+  if (!ctx.json) {
+    err("%s, open %s fail\n", __func__, ctx.json_url);
+    return -EIO;
+  }
+  fprintf(ctx.json, "{\n  \"results\": [");
+
+  ctx.sample.st = mtl_init(p);
+  if (!ctx.sample.st) {
+    err("%s: mtl_init fail\n", __func__);
+    fclose(ctx.json);
+    return -EIO;
+  }
+
+  ret = mtl_start(ctx.sample.st);
+  if (ret < 0) {
+    err("%s: mtl_start fail %d\n", __func__, ret);
+  } else {
+    ret = perf_sweep(&ctx);
+    mtl_stop(ctx.sample.st);
+  }
+
+  fprintf(ctx.json, "\n  ]\n}\n");
+  fclose(ctx.json);
+  info("%s, %d records saved to %s\n", __func__, ctx.json_records, ctx.json_url);
+
+  mtl_uninit(ctx.sample.st);
+  ctx.sample.st = NULL;
+  return ret;
+}
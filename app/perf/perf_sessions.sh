@@ -0,0 +1,78 @@
+#!/bin/bash
+
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2023 Intel Corporation
+
+# Sweep the scheduler quota for PerfSessions, one process for each quota since the
+# quota is an init time parameter, all results are merged into one json file.
+
+set -e
+
+P_PORT=${P_PORT:-0000:af:01.0}
+R_PORT=${R_PORT:-0000:af:01.1}
+P_SIP=${P_SIP:-192.168.89.80}
+R_SIP=${R_SIP:-192.168.89.81}
+
+TEST_BIN_PATH=${TEST_BIN_PATH:-../../build/app}
+LOG_LEVEL=${LOG_LEVEL:-notice}
+OUT_JSON=${OUT_JSON:-perf_sessions.json}
+
+# quota in number of 1080p59 streams per sch, 0 for lib default
+SCH_QUOTA_LIST=${SCH_QUOTA_LIST:-"0 2 4 8"}
+TYPE_LIST=${TYPE_LIST:-"st20 st22 st30 st40"}
+# extra args for PerfSessions, e.g. "--sessions_list 1,2,4,8,16 --res_list 1080p,2160p"
+PERF_ARGS=${PERF_ARGS:-""}
+
+perf_sessions() {
+	local type=$1
+	local quota=$2
+	local out=$3
+	echo "Start to run: type ${type} sch_quota ${quota}"
+	${TEST_BIN_PATH}/PerfSessions --log_level ${LOG_LEVEL} --p_port ${P_PORT} --r_port ${R_PORT} \
+		--p_sip ${P_SIP} --r_sip ${R_SIP} --sch_sleep --type ${type} --sch_quota ${quota} \
+		--json ${out} ${PERF_ARGS}
+	echo ""
+}
+
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf ${TMP_DIR}' EXIT
+
+for type in ${TYPE_LIST}; do
+	for quota in ${SCH_QUOTA_LIST}; do
+		perf_sessions "${type}" "${quota}" "${TMP_DIR}/${type}_${quota}.json"
+	done
+done
+
+# merge the results and report the max sustained sessions per core for each config
+python3 - "${OUT_JSON}" "${TMP_DIR}"/*.json <<'PY'
+import json
+import sys
+
+results = []
+for url in sys.argv[2:]:
+    with open(url) as f:
+        results += json.load(f)["results"]
+
+summary = {}
+for r in results:
+    if not r["sustained"]:
+        continue
+    key = (r["type"], r["width"], r["height"], r["fps"], r["packing"])
+    best = summary.get(key)
+    if not best or r["sessions_per_core"] > best["sessions_per_core"]:
+        summary[key] = {
+            "type": r["type"],
+            "width": r["width"],
+            "height": r["height"],
+            "fps": r["fps"],
+            "packing": r["packing"],
+            "sessions": r["sessions"],
+            "sch_quota": r["sch_quota"],
+            "sessions_per_core": r["sessions_per_core"],
+        }
+
+with open(sys.argv[1], "w") as f:
+    json.dump({"results": results, "summary": list(summary.values())}, f, indent=2)
+PY
+
+echo "****** All Perf sessions test OK, result saved to ${OUT_JSON} ******"
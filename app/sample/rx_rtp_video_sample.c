@@ -4,6 +4,8 @@
 
 #include "sample_util.h"
 
+#define RX_RTP_BURST_SIZE (32)
+
 struct rv_rtp_sample_ctx {
   int idx;
   int fb_rec;
@@ -25,14 +27,13 @@ static int rx_rtp_ready(void* priv) {
 
 static void* app_rx_video_rtp_thread(void* arg) {
   struct rv_rtp_sample_ctx* s = arg;
-  void* usrptr;
-  uint16_t len;
-  void* mbuf;
+  struct st_rtp_buf bufs[RX_RTP_BURST_SIZE];
+  uint16_t nb;
   struct st20_rfc4175_rtp_hdr* hdr;
 
   while (!s->stop) {
-    mbuf = st20_rx_get_mbuf(s->handle, &usrptr, &len);
-    if (!mbuf) {
+    nb = st20_rx_get_mbufs(s->handle, bufs, RX_RTP_BURST_SIZE);
+    if (!nb) {
       /* no buffer */
       st_pthread_mutex_lock(&s->wake_mutex);
       if (!s->stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
@@ -40,14 +41,16 @@ static void* app_rx_video_rtp_thread(void* arg) {
       continue;
     }
 
-    /* get one packet */
-    hdr = (struct st20_rfc4175_rtp_hdr*)usrptr;
-    /* handle the rtp packet, should not handle the heavy work, if the st20_rx_get_mbuf is
-     * not called timely, the rtp queue in the lib will be full and rtp will be enqueued
-     * fail in the lib, packet will be dropped*/
-    if (hdr->base.marker) s->fb_rec++;
+    /* get a burst of packets, one bulk dequeue from the lib rtp ring */
+    for (uint16_t i = 0; i < nb; i++) {
+      hdr = (struct st20_rfc4175_rtp_hdr*)bufs[i].usrptr;
+      /* handle the rtp packet, should not handle the heavy work, if the
+       * st20_rx_get_mbufs is not called timely, the rtp queue in the lib will be full
+       * and rtp will be enqueued fail in the lib, packet will be dropped*/
+      if (hdr->base.marker) s->fb_rec++;
+    }
     /* free to lib */
-    st20_rx_put_mbuf(s->handle, mbuf);
+    st20_rx_put_mbufs(s->handle, bufs, nb);
   }
 
   return NULL;
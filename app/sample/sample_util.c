@@ -154,6 +154,8 @@ static int _sample_parse_args(struct st_sample_context* ctx, int argc, char** ar
           ctx->st22p_codec = ST22_CODEC_JPEGXS;
         else if (!strcmp(optarg, "h264_cbr"))
           ctx->st22p_codec = ST22_CODEC_H264_CBR;
+        else if (!strcmp(optarg, "h265_cbr"))
+          ctx->st22p_codec = ST22_CODEC_H265_CBR;
         else
           err("%s, unknown codec %s\n", __func__, optarg);
         break;
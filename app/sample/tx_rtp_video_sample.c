@@ -4,6 +4,8 @@
 
 #include "sample_util.h"
 
+#define TX_RTP_BURST_SIZE (32)
+
 struct tv_rtp_sample_ctx {
   int idx;
   st20_tx_handle handle;
@@ -73,16 +75,16 @@ static int app_tx_build_rtp_packet(struct tv_rtp_sample_ctx* s,
 
 static void* app_tx_rtp_thread(void* arg) {
   struct tv_rtp_sample_ctx* s = arg;
-  void *mbuf, *usrptr;
-  uint16_t mbuf_len;
+  struct st_rtp_buf bufs[TX_RTP_BURST_SIZE];
+  uint16_t nb;
   while (!s->stop) {
-    /* get available buffer*/
-    mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-    if (!mbuf) {
+    /* get available buffers */
+    nb = st20_tx_get_mbufs(s->handle, bufs, TX_RTP_BURST_SIZE);
+    if (!nb) {
       st_pthread_mutex_lock(&s->wake_mutex);
       /* try again */
-      mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-      if (mbuf) {
+      nb = st20_tx_get_mbufs(s->handle, bufs, TX_RTP_BURST_SIZE);
+      if (nb) {
         st_pthread_mutex_unlock(&s->wake_mutex);
       } else {
         if (!s->stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
@@ -90,8 +92,10 @@ static void* app_tx_rtp_thread(void* arg) {
         continue;
       }
     }
-    app_tx_build_rtp_packet(s, (struct st20_rfc4175_rtp_hdr*)usrptr, &mbuf_len);
-    st20_tx_put_mbuf(s->handle, mbuf, mbuf_len);
+    for (uint16_t i = 0; i < nb; i++)
+      app_tx_build_rtp_packet(s, (struct st20_rfc4175_rtp_hdr*)bufs[i].usrptr,
+                              &bufs[i].len);
+    st20_tx_put_mbufs(s->handle, bufs, nb);
   }
 
   return NULL;
@@ -23,6 +23,7 @@
 #include <unistd.h>
 
 #include "app_platform.h"
+#include "app_worker.h"
 #include "fmt.h"
 #include "parse_json.h"
 
@@ -39,6 +40,10 @@
 
 #define ST_APP_MAX_LCORES (32)
 
+#define ST_APP_RTP_BURST_SIZE (32)
+
+#define ST_APP_DEFAULT_VIDEO_IO_DEPTH (4)
+
 #define ST_APP_EXPECT_NEAR(val, expect, delta) \
   ((val > (expect - delta)) && (val < (expect + delta)))
 
@@ -48,6 +53,9 @@
 
 #define UTC_OFFSSET (37) /* 2022/07 */
 
+/* streaming file io, see app_io.h */
+struct st_app_io;
+
 struct st_display {
   char name[36];
   SDL_Window* window;
@@ -94,7 +102,6 @@ struct st_app_tx_video_session {
   uint16_t framebuff_consumer_idx;
   struct st_tx_frame* framebuffs;
 
-  pcap_t* st20_pcap;
   bool st20_pcap_input;
 
   char st20_source_url[ST_APP_URL_MAX_LEN];
@@ -103,11 +110,17 @@ struct st_app_tx_video_session {
   uint8_t* st20_frame_cursor;
   int st20_source_fd;
   bool st20_frames_copied;
+  struct st_app_io* st20_io; /* streaming source, NULL if the source is loaded */
+  off_t st20_io_offset;      /* file offset of next frame to read */
 
   int st20_frame_size;
   bool st20_second_field;
   struct st20_pgroup st20_pg;
   uint16_t lines_per_slice;
+  /* the slice frame waits the first lines query of the lib, NULL if none */
+  struct st_tx_frame* slice_framebuff;
+  uint8_t* slice_src;
+  uint8_t* slice_dst;
 
   int width;
   int height;
@@ -139,6 +152,7 @@ struct st_app_tx_video_session {
   bool st20_app_thread_stop;
   pthread_cond_t st20_wake_cond;
   pthread_mutex_t st20_wake_mutex;
+  struct st_app_job st20_job; /* served by the worker pool instead of the thread */
 
   struct st_display* display;
   int lcore;
@@ -170,6 +184,7 @@ struct st_app_tx_audio_session {
   bool st30_app_thread_stop;
   pthread_cond_t st30_wake_cond;
   pthread_mutex_t st30_wake_mutex;
+  struct st_app_job st30_job; /* the frame mode served by the worker pool */
   uint32_t st30_rtp_tmstamp;
   uint16_t st30_seq_id;
 };
@@ -199,6 +214,7 @@ struct st_app_tx_anc_session {
   bool st40_app_thread_stop;
   pthread_cond_t st40_wake_cond;
   pthread_mutex_t st40_wake_mutex;
+  struct st_app_job st40_job; /* the frame mode served by the worker pool */
   uint32_t st40_rtp_tmstamp;
   uint32_t st40_seq_id;
 };
@@ -218,6 +234,8 @@ struct st_app_rx_video_session {
   uint8_t* st20_dst_begin;
   uint8_t* st20_dst_end;
   uint8_t* st20_dst_cursor;
+  struct st_app_io* st20_io; /* streaming recorder for frame type */
+  off_t st20_io_offset;      /* file offset of next frame to write */
 
   /* frame info */
   uint16_t framebuff_producer_idx;
@@ -242,6 +260,7 @@ struct st_app_rx_video_session {
   pthread_cond_t st20_wake_cond;
   pthread_mutex_t st20_wake_mutex;
   bool st20_app_thread_stop;
+  struct st_app_job st20_job; /* served by the worker pool instead of the thread */
 
   struct st_display* display;
   uint32_t pcapng_max_pkts;
@@ -312,6 +331,7 @@ struct st22_app_tx_session {
 
   bool st22_app_thread_stop;
   pthread_t st22_app_thread;
+  struct st_app_job st22_job; /* served by the worker pool instead of the thread */
   char st22_source_url[ST_APP_URL_MAX_LEN];
   int st22_source_fd;
   uint8_t* st22_source_begin;
@@ -339,6 +359,7 @@ struct st22_app_rx_session {
 
   bool st22_app_thread_stop;
   pthread_t st22_app_thread;
+  struct st_app_job st22_job; /* served by the worker pool instead of the thread */
   int fb_decoded;
 
   char st22_dst_url[ST_APP_URL_MAX_LEN];
@@ -371,6 +392,7 @@ struct st_app_tx_st22p_session {
   pthread_cond_t st22p_wake_cond;
   pthread_mutex_t st22p_wake_mutex;
   bool st22p_app_thread_stop;
+  struct st_app_job st22p_job; /* served by the worker pool instead of the thread */
 };
 
 struct st_app_rx_st22p_session {
@@ -394,6 +416,7 @@ struct st_app_rx_st22p_session {
   pthread_cond_t st22p_wake_cond;
   pthread_mutex_t st22p_wake_mutex;
   bool st22p_app_thread_stop;
+  struct st_app_job st22p_job; /* served by the worker pool instead of the thread */
 
   struct st_display* display;
   uint32_t pcapng_max_pkts;
@@ -424,6 +447,7 @@ struct st_app_tx_st20p_session {
   pthread_cond_t st20p_wake_cond;
   pthread_mutex_t st20p_wake_mutex;
   bool st20p_app_thread_stop;
+  struct st_app_job st20p_job; /* served by the worker pool instead of the thread */
 };
 
 struct st_app_rx_st20p_session {
@@ -446,6 +470,7 @@ struct st_app_rx_st20p_session {
   pthread_cond_t st20p_wake_cond;
   pthread_mutex_t st20p_wake_mutex;
   bool st20p_app_thread_stop;
+  struct st_app_job st20p_job; /* served by the worker pool instead of the thread */
 
   struct st_display* display;
   uint32_t pcapng_max_pkts;
@@ -477,6 +502,9 @@ struct st_app_context {
   bool enable_hdr_split;
   bool tx_copy_once;
   bool app_thread;
+  int video_io_depth; /* read-ahead/write-behind frames of video file io, 0: mmap */
+  int app_workers;    /* shared workers of frame sessions, 0: thread per session */
+  struct st_app_worker_pool* worker_pool;
 
   char tx_video_url[ST_APP_URL_MAX_LEN]; /* send video content url*/
   struct st_app_tx_video_session* tx_video_sessions;
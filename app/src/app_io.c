@@ -0,0 +1,390 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <sys/stat.h>
+
+#include "app_io.h"
+
+#ifdef APP_HAS_LIBURING
+#include <liburing.h>
+#endif
+
+enum st_app_io_req_status {
+  ST_APP_IO_REQ_FREE = 0,
+  ST_APP_IO_REQ_QUEUED,
+};
+
+struct st_app_io_req {
+  enum st_app_io_req_status stat;
+  void* buf;
+  size_t len;
+  off_t offset;
+  void* priv;
+  int result;
+};
+
+struct st_app_io {
+  char url[ST_APP_URL_MAX_LEN];
+  int fd;
+  int buffered_fd; /* same to fd if not direct, for the io not aligned to O_DIRECT */
+  bool write;
+  bool direct; /* O_DIRECT */
+  size_t file_size;
+
+  st_app_io_done_cb done;
+  void* priv;
+
+  struct st_app_io_req* reqs;
+  int depth;
+  int submit_idx; /* next req to fill by app */
+  int io_idx;     /* next req to serve by io thread */
+
+  pthread_t thread;
+  bool thread_created;
+  bool stop;
+  pthread_mutex_t mutex;
+  pthread_cond_t io_cond;  /* wake io thread for new req */
+  pthread_cond_t app_cond; /* wake app for free req */
+
+#ifdef APP_HAS_LIBURING
+  struct io_uring ring;
+  bool ring_inited;
+  bool ring_ready; /* false if the ring is broken */
+#endif
+};
+
+#ifndef WINDOWSENV
+/* O_DIRECT only if the buf, len and offset are all aligned, buffered io otherwise */
+static int app_io_fd(struct st_app_io* io, void* buf, size_t len, off_t offset) {
+  if (io->direct &&
+      !(((uintptr_t)buf | len | (size_t)offset) % ST_APP_IO_DIRECT_ALIGN))
+    return io->fd;
+  return io->buffered_fd;
+}
+
+static int app_io_rw(struct st_app_io* io, struct st_app_io_req* req, size_t done) {
+  ssize_t ret;
+  int fd;
+
+  while (done < req->len) {
+    /* a short io may leave an unaligned tail for O_DIRECT */
+    fd = app_io_fd(io, req->buf + done, req->len - done, req->offset + done);
+    if (io->write)
+      ret = pwrite(fd, req->buf + done, req->len - done, req->offset + done);
+    else
+      ret = pread(fd, req->buf + done, req->len - done, req->offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return -errno;
+    }
+    if (!ret) return -EIO; /* unexpected eof */
+    done += ret;
+  }
+
+  return 0;
+}
+
+#ifdef APP_HAS_LIBURING
+/* wait one completion and set the result of its request */
+static int app_io_uring_reap(struct st_app_io* io) {
+  struct io_uring_cqe* cqe;
+  struct st_app_io_req* req;
+  int ret;
+
+  do {
+    ret = io_uring_wait_cqe(&io->ring, &cqe);
+  } while (ret == -EINTR);
+  if (ret < 0) {
+    err("%s, wait cqe fail %d\n", __func__, ret);
+    return ret;
+  }
+
+  req = io_uring_cqe_get_data(cqe);
+  if (cqe->res < 0)
+    req->result = cqe->res;
+  else if ((size_t)cqe->res < req->len) /* short io, finish the left by sync */
+    req->result = app_io_rw(io, req, cqe->res);
+  else
+    req->result = 0;
+  io_uring_cqe_seen(&io->ring, cqe);
+  return 0;
+}
+
+/* return the number of requests done by the ring, the left are for the sync path */
+static int app_io_uring_batch(struct st_app_io* io, int start, int n) {
+  struct io_uring_sqe* sqe;
+  struct st_app_io_req* req;
+  int submitted = 0, reaped = 0;
+  int ret;
+
+  for (int i = 0; i < n; i++) {
+    req = &io->reqs[(start + i) % io->depth];
+    sqe = io_uring_get_sqe(&io->ring);
+    if (!sqe) { /* never happen as the ring has depth entries */
+      n = i;
+      break;
+    }
+    int fd = app_io_fd(io, req->buf, req->len, req->offset);
+    if (io->write)
+      io_uring_prep_write(sqe, fd, req->buf, req->len, req->offset);
+    else
+      io_uring_prep_read(sqe, fd, req->buf, req->len, req->offset);
+    io_uring_sqe_set_data(sqe, req);
+  }
+
+  /* the sqes are consumed in order, only the unsubmitted tail is retried */
+  while (submitted < n) {
+    ret = io_uring_submit(&io->ring);
+    if (ret > 0) {
+      submitted += ret;
+      continue;
+    }
+    if (ret == -EINTR) continue;
+    if (((ret == -EAGAIN) || (ret == -EBUSY) || !ret) && (reaped < submitted)) {
+      /* no room for now, free one completion and try again */
+      if (app_io_uring_reap(io) < 0) break;
+      reaped++;
+      continue;
+    }
+    /* the tail stays in the sq, never use the ring again */
+    err("%s, submit %d of %d fail %d, disable io_uring\n", __func__, submitted, n, ret);
+    io->ring_ready = false;
+    break;
+  }
+
+  /* reap all the submitted part before the requests are reused */
+  while (reaped < submitted) {
+    if (app_io_uring_reap(io) < 0) {
+      io->ring_ready = false;
+      break;
+    }
+    reaped++;
+  }
+  for (int i = reaped; i < submitted; i++) {
+    req = &io->reqs[(start + i) % io->depth];
+    req->result = -EIO; /* the completion is lost */
+  }
+
+  return submitted;
+}
+#endif
+
+static void app_io_batch(struct st_app_io* io, int start, int n) {
+  struct st_app_io_req* req;
+  int done = 0;
+
+#ifdef APP_HAS_LIBURING
+  if (io->ring_ready) done = app_io_uring_batch(io, start, n);
+#endif
+  /* sync path, or the requests not submitted to the io_uring */
+  for (int i = done; i < n; i++) {
+    req = &io->reqs[(start + i) % io->depth];
+    req->result = app_io_rw(io, req, 0);
+  }
+}
+
+static void* app_io_thread(void* arg) {
+  struct st_app_io* io = arg;
+  struct st_app_io_req* req;
+  int start, n;
+
+  info("%s, start for %s\n", __func__, io->url);
+  while (true) {
+    st_pthread_mutex_lock(&io->mutex);
+    while (!io->stop && (io->reqs[io->io_idx].stat != ST_APP_IO_REQ_QUEUED))
+      st_pthread_cond_wait(&io->io_cond, &io->mutex);
+    /* serve all the queued reqs in one batch */
+    start = io->io_idx;
+    n = 0;
+    while ((n < io->depth) &&
+           (io->reqs[(start + n) % io->depth].stat == ST_APP_IO_REQ_QUEUED))
+      n++;
+    st_pthread_mutex_unlock(&io->mutex);
+    if (!n) break; /* stop and all requests drained */
+
+    app_io_batch(io, start, n);
+    for (int i = 0; i < n; i++) {
+      req = &io->reqs[(start + i) % io->depth];
+      if (req->result < 0)
+        err("%s, %s %s at %" PRId64 " fail %d\n", __func__, io->write ? "write" : "read",
+            io->url, (int64_t)req->offset, req->result);
+      io->done(io->priv, req->buf, req->priv, req->result);
+    }
+
+    st_pthread_mutex_lock(&io->mutex);
+    for (int i = 0; i < n; i++)
+      io->reqs[(start + i) % io->depth].stat = ST_APP_IO_REQ_FREE;
+    io->io_idx = (start + n) % io->depth;
+    st_pthread_cond_signal(&io->app_cond);
+    st_pthread_mutex_unlock(&io->mutex);
+  }
+  info("%s, stop for %s\n", __func__, io->url);
+
+  return NULL;
+}
+
+struct st_app_io* st_app_io_open(const char* url, bool write, size_t file_size,
+                                 size_t block_size, int depth, st_app_io_done_cb done,
+                                 void* priv) {
+  struct st_app_io* io;
+  int flags = write ? (O_CREAT | O_RDWR) : O_RDONLY;
+  int ret;
+
+  if (depth < 1 || !done) {
+    err("%s, invalid depth %d or done cb\n", __func__, depth);
+    return NULL;
+  }
+
+  io = st_app_zmalloc(sizeof(*io));
+  if (!io) return NULL;
+  snprintf(io->url, sizeof(io->url), "%s", url);
+  io->write = write;
+  io->done = done;
+  io->priv = priv;
+  io->depth = depth;
+  io->fd = -1;
+  io->buffered_fd = -1;
+  st_pthread_mutex_init(&io->mutex, NULL);
+  st_pthread_cond_init(&io->io_cond, NULL);
+  st_pthread_cond_init(&io->app_cond, NULL);
+
+#ifdef O_DIRECT
+  /* bypass the page cache, constant memory and no fault on the hot path */
+  if (block_size && !(block_size % ST_APP_IO_DIRECT_ALIGN)) {
+    io->fd = st_open_mode(url, flags | O_DIRECT, S_IRUSR | S_IWUSR);
+    if (io->fd >= 0)
+      io->direct = true;
+    else
+      warn("%s, O_DIRECT open %s fail, fallback to buffered io\n", __func__, url);
+  }
+#endif
+  if (io->fd < 0) io->fd = st_open_mode(url, flags, S_IRUSR | S_IWUSR);
+  if (io->fd < 0) {
+    err("%s, open %s fail\n", __func__, url);
+    st_app_io_close(io);
+    return NULL;
+  }
+  if (io->direct) {
+    /* for a short last frame or the unaligned tail of a short io */
+    io->buffered_fd = st_open_mode(url, flags, S_IRUSR | S_IWUSR);
+    if (io->buffered_fd < 0) {
+      err("%s, open buffered %s fail\n", __func__, url);
+      st_app_io_close(io);
+      return NULL;
+    }
+  } else {
+    io->buffered_fd = io->fd;
+  }
+
+  if (write) {
+    ret = ftruncate(io->fd, file_size);
+    if (ret < 0) {
+      err("%s, ftruncate %s fail\n", __func__, url);
+      st_app_io_close(io);
+      return NULL;
+    }
+    io->file_size = file_size;
+  } else {
+    struct stat i;
+
+    fstat(io->fd, &i);
+    io->file_size = i.st_size;
+    if (!io->direct) posix_fadvise(io->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+  io->reqs = st_app_zmalloc(sizeof(*io->reqs) * depth);
+  if (!io->reqs) {
+    err("%s, reqs malloc fail\n", __func__);
+    st_app_io_close(io);
+    return NULL;
+  }
+
+#ifdef APP_HAS_LIBURING
+  ret = io_uring_queue_init(depth, &io->ring, 0);
+  if (ret < 0)
+    warn("%s, io_uring init fail %d, fallback to sync io thread\n", __func__, ret);
+  else
+    io->ring_inited = io->ring_ready = true;
+#endif
+
+  ret = pthread_create(&io->thread, NULL, app_io_thread, io);
+  if (ret) {
+    err("%s, thread create fail %d\n", __func__, ret);
+    st_app_io_close(io);
+    return NULL;
+  }
+  io->thread_created = true;
+
+  info("%s, %s %s size %" PRIu64 " depth %d%s\n", __func__, write ? "write" : "read",
+       url, (uint64_t)io->file_size, depth, io->direct ? " direct" : "");
+  return io;
+}
+
+int st_app_io_submit(struct st_app_io* io, void* buf, size_t len, off_t offset,
+                     void* req_priv) {
+  struct st_app_io_req* req;
+
+  st_pthread_mutex_lock(&io->mutex);
+  req = &io->reqs[io->submit_idx];
+  while (!io->stop && (req->stat != ST_APP_IO_REQ_FREE))
+    st_pthread_cond_wait(&io->app_cond, &io->mutex);
+  if (io->stop) {
+    st_pthread_mutex_unlock(&io->mutex);
+    return -EIO;
+  }
+  req->buf = buf;
+  req->len = len;
+  req->offset = offset;
+  req->priv = req_priv;
+  req->result = 0;
+  req->stat = ST_APP_IO_REQ_QUEUED;
+  io->submit_idx = (io->submit_idx + 1) % io->depth;
+  st_pthread_cond_signal(&io->io_cond);
+  st_pthread_mutex_unlock(&io->mutex);
+
+  return 0;
+}
+
+size_t st_app_io_file_size(struct st_app_io* io) { return io->file_size; }
+
+int st_app_io_close(struct st_app_io* io) {
+  st_pthread_mutex_lock(&io->mutex);
+  io->stop = true;
+  st_pthread_cond_signal(&io->io_cond);
+  st_pthread_cond_signal(&io->app_cond);
+  st_pthread_mutex_unlock(&io->mutex);
+  /* the thread exits after all queued requests are done */
+  if (io->thread_created) pthread_join(io->thread, NULL);
+
+#ifdef APP_HAS_LIBURING
+  if (io->ring_inited) io_uring_queue_exit(&io->ring);
+#endif
+  if (io->reqs) st_app_free(io->reqs);
+  if ((io->buffered_fd >= 0) && (io->buffered_fd != io->fd)) close(io->buffered_fd);
+  if (io->fd >= 0) close(io->fd);
+  st_pthread_mutex_destroy(&io->mutex);
+  st_pthread_cond_destroy(&io->io_cond);
+  st_pthread_cond_destroy(&io->app_cond);
+  st_app_free(io);
+
+  return 0;
+}
+#else
+struct st_app_io* st_app_io_open(const char* url, bool write, size_t file_size,
+                                 size_t block_size, int depth, st_app_io_done_cb done,
+                                 void* priv) {
+  err("%s, streaming io not support on this platform\n", __func__);
+  return NULL;
+}
+
+int st_app_io_submit(struct st_app_io* io, void* buf, size_t len, off_t offset,
+                     void* req_priv) {
+  return -ENOTSUP;
+}
+
+size_t st_app_io_file_size(struct st_app_io* io) { return 0; }
+
+int st_app_io_close(struct st_app_io* io) { return -ENOTSUP; }
+#endif
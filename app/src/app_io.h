@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include "app_base.h"
+#include "log.h"
+
+#ifndef _APP_IO_HEAD_H_
+#define _APP_IO_HEAD_H_
+
+/* O_DIRECT requires the buf, len and file offset aligned to the logical block */
+#define ST_APP_IO_DIRECT_ALIGN (512)
+
+/* called from the io thread once the read or write of one request is done */
+typedef void (*st_app_io_done_cb)(void* priv, void* buf, void* req_priv, int result);
+
+/*
+ * Open a streaming file io with up to depth requests in flight. The requests are
+ * served in submit order by a dedicated io thread, with io_uring if APP_HAS_LIBURING.
+ * O_DIRECT is used if the block_size is aligned, the buf of the request should then
+ * be hugepage(page aligned) memory, like the framebuffer of the session.
+ * file_size is the size to truncate for write, ignored for read.
+ */
+struct st_app_io* st_app_io_open(const char* url, bool write, size_t file_size,
+                                 size_t block_size, int depth, st_app_io_done_cb done,
+                                 void* priv);
+/* queue one request, wait if the depth is full, return 0 if success */
+int st_app_io_submit(struct st_app_io* io, void* buf, size_t len, off_t offset,
+                     void* req_priv);
+size_t st_app_io_file_size(struct st_app_io* io);
+/* drain all the requests in flight and close */
+int st_app_io_close(struct st_app_io* io);
+
+#endif
@@ -52,6 +52,7 @@ typedef unsigned long int nfds_t;
 
 enum st_tx_frame_status {
   ST_TX_FRAME_FREE = 0,
+  ST_TX_FRAME_IN_READING, /* streaming from the source file */
   ST_TX_FRAME_READY,
   ST_TX_FRAME_IN_TRANSMITTING,
   ST_TX_FRAME_STATUS_MAX,
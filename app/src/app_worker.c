@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <inttypes.h>
+
+#include "app_base.h"
+#include "log.h"
+
+#define ST_APP_WORKER_QUEUE_MASK (ST_APP_WORKER_QUEUE_SIZE - 1)
+
+/* cell of the bounded mpsc ring, seq tells if the cell is free or published */
+struct st_app_worker_cell {
+  atomic_uint_fast64_t seq;
+  struct st_app_job* job;
+};
+
+struct st_app_worker {
+  struct st_app_worker_pool* pool;
+  int idx;
+  unsigned int lcore;
+  bool lcore_get;
+
+  struct st_app_worker_cell cells[ST_APP_WORKER_QUEUE_SIZE];
+  atomic_uint_fast64_t enq_pos; /* producers, any thread */
+  uint64_t deq_pos;             /* consumer, the worker thread only */
+
+  atomic_bool sleeping;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_t thread;
+  bool thread_created;
+  atomic_bool stop;
+
+  int nb_jobs; /* protected by the pool mutex */
+  uint64_t stat_runs;
+  uint64_t stat_wakeups;
+};
+
+struct st_app_worker_pool {
+  mtl_handle st;
+  bool bind;
+  pthread_mutex_t mutex;
+  int nb_workers;
+  struct st_app_worker workers[];
+};
+
+static int app_worker_push(struct st_app_worker* w, struct st_app_job* job) {
+  uint64_t pos = atomic_load(&w->enq_pos);
+  struct st_app_worker_cell* cell;
+  int64_t diff;
+
+  while (true) {
+    cell = &w->cells[pos & ST_APP_WORKER_QUEUE_MASK];
+    diff = (int64_t)atomic_load(&cell->seq) - (int64_t)pos;
+    if (!diff) {
+      if (atomic_compare_exchange_weak(&w->enq_pos, &pos, pos + 1)) break;
+    } else if (diff < 0) {
+      return -EBUSY; /* full, never happen as nb_jobs is below the queue size */
+    } else {
+      pos = atomic_load(&w->enq_pos);
+    }
+  }
+  cell->job = job;
+  atomic_store(&cell->seq, pos + 1);
+
+  return 0;
+}
+
+static struct st_app_worker_cell* app_worker_head(struct st_app_worker* w) {
+  struct st_app_worker_cell* cell = &w->cells[w->deq_pos & ST_APP_WORKER_QUEUE_MASK];
+
+  if (atomic_load(&cell->seq) != (w->deq_pos + 1)) return NULL; /* empty */
+  return cell;
+}
+
+static struct st_app_job* app_worker_pop(struct st_app_worker* w) {
+  struct st_app_worker_cell* cell = app_worker_head(w);
+  struct st_app_job* job;
+
+  if (!cell) return NULL;
+  job = cell->job;
+  atomic_store(&cell->seq, w->deq_pos + ST_APP_WORKER_QUEUE_SIZE);
+  w->deq_pos++;
+  return job;
+}
+
+static void app_worker_sleep(struct st_app_worker* w) {
+  atomic_store(&w->sleeping, true);
+  /* recheck after the sleeping flag is visible, pair with st_app_job_notify */
+  if (app_worker_head(w)) {
+    atomic_store(&w->sleeping, false);
+    return;
+  }
+  st_pthread_mutex_lock(&w->mutex);
+  while (atomic_load(&w->sleeping) && !atomic_load(&w->stop))
+    st_pthread_cond_wait(&w->cond, &w->mutex);
+  st_pthread_mutex_unlock(&w->mutex);
+  w->stat_wakeups++;
+}
+
+static void* app_worker_thread(void* arg) {
+  struct st_app_worker* w = arg;
+  struct st_app_job* job;
+  int ret;
+
+  if (w->lcore_get) mtl_bind_to_lcore(w->pool->st, pthread_self(), w->lcore);
+  info("%s(%d), start\n", __func__, w->idx);
+  while (!atomic_load(&w->stop)) {
+    job = app_worker_pop(w);
+    if (!job) {
+      app_worker_sleep(w);
+      continue;
+    }
+
+    atomic_store(&job->running, true);
+    atomic_store(&job->queued, false);
+    if (!atomic_load(&job->detached)) {
+      ret = job->func(job->priv);
+      w->stat_runs++;
+      /* more work pending, requeue at the tail to round robin with other sessions */
+      if (ret > 0) st_app_job_notify(job);
+    }
+    atomic_store(&job->running, false);
+  }
+  info("%s(%d), stop, runs %" PRIu64 " wakeups %" PRIu64 "\n", __func__, w->idx,
+       w->stat_runs, w->stat_wakeups);
+
+  return NULL;
+}
+
+void st_app_job_notify(struct st_app_job* job) {
+  struct st_app_worker* w = job->worker;
+
+  if (!w) return;
+  if (atomic_exchange(&job->queued, true)) return; /* already in the queue */
+  if (atomic_load(&job->detached)) {
+    atomic_store(&job->queued, false);
+    return;
+  }
+  if (app_worker_push(w, job) < 0) {
+    err("%s(%d), queue full\n", __func__, w->idx);
+    atomic_store(&job->queued, false);
+    return;
+  }
+  if (atomic_exchange(&w->sleeping, false)) {
+    st_pthread_mutex_lock(&w->mutex);
+    st_pthread_cond_signal(&w->cond);
+    st_pthread_mutex_unlock(&w->mutex);
+  }
+}
+
+int st_app_job_attach(struct st_app_worker_pool* pool, struct st_app_job* job,
+                      st_app_job_func func, void* priv) {
+  struct st_app_worker* w = NULL;
+
+  st_pthread_mutex_lock(&pool->mutex);
+  for (int i = 0; i < pool->nb_workers; i++) {
+    if (!w || (pool->workers[i].nb_jobs < w->nb_jobs)) w = &pool->workers[i];
+  }
+  if (w->nb_jobs >= ST_APP_WORKER_QUEUE_SIZE) {
+    st_pthread_mutex_unlock(&pool->mutex);
+    err("%s, all workers full\n", __func__);
+    return -EBUSY;
+  }
+  w->nb_jobs++;
+  st_pthread_mutex_unlock(&pool->mutex);
+
+  job->func = func;
+  job->priv = priv;
+  atomic_store(&job->queued, false);
+  atomic_store(&job->running, false);
+  atomic_store(&job->detached, false);
+  job->worker = w;
+  dbg("%s, attach to worker %d\n", __func__, w->idx);
+  st_app_job_notify(job); /* first run */
+
+  return 0;
+}
+
+void st_app_job_detach(struct st_app_job* job) {
+  struct st_app_worker* w = job->worker;
+
+  if (!w) return;
+  atomic_store(&job->detached, true);
+  /* the worker skips a detached job, wait it leave the queue and the run in flight */
+  while (atomic_load(&job->queued)) st_usleep(100);
+  while (atomic_load(&job->running)) st_usleep(100);
+  job->worker = NULL;
+
+  st_pthread_mutex_lock(&w->pool->mutex);
+  w->nb_jobs--;
+  st_pthread_mutex_unlock(&w->pool->mutex);
+}
+
+void st_app_worker_pool_free(struct st_app_worker_pool* pool) {
+  struct st_app_worker* w;
+
+  for (int i = 0; i < pool->nb_workers; i++) {
+    w = &pool->workers[i];
+    if (w->thread_created) {
+      atomic_store(&w->stop, true);
+      st_pthread_mutex_lock(&w->mutex);
+      st_pthread_cond_signal(&w->cond);
+      st_pthread_mutex_unlock(&w->mutex);
+      pthread_join(w->thread, NULL);
+    }
+    if (w->nb_jobs) warn("%s(%d), still %d jobs attached\n", __func__, i, w->nb_jobs);
+    if (w->lcore_get) mtl_put_lcore(pool->st, w->lcore);
+    st_pthread_mutex_destroy(&w->mutex);
+    st_pthread_cond_destroy(&w->cond);
+  }
+  st_pthread_mutex_destroy(&pool->mutex);
+  st_app_free(pool);
+}
+
+struct st_app_worker_pool* st_app_worker_pool_create(mtl_handle st, int nb_workers,
+                                                     bool bind) {
+  struct st_app_worker_pool* pool;
+  struct st_app_worker* w;
+  int ret;
+
+  if (nb_workers < 1 || nb_workers > ST_APP_MAX_WORKERS) {
+    err("%s, invalid nb_workers %d\n", __func__, nb_workers);
+    return NULL;
+  }
+
+  pool = st_app_zmalloc(sizeof(*pool) + sizeof(*w) * nb_workers);
+  if (!pool) return NULL;
+  pool->st = st;
+  pool->bind = bind;
+  st_pthread_mutex_init(&pool->mutex, NULL);
+
+  for (int i = 0; i < nb_workers; i++) {
+    w = &pool->workers[i];
+    w->pool = pool;
+    w->idx = i;
+    for (int j = 0; j < ST_APP_WORKER_QUEUE_SIZE; j++) atomic_init(&w->cells[j].seq, j);
+    atomic_init(&w->enq_pos, 0);
+    w->deq_pos = 0;
+    atomic_init(&w->sleeping, false);
+    atomic_init(&w->stop, false);
+    st_pthread_mutex_init(&w->mutex, NULL);
+    st_pthread_cond_init(&w->cond, NULL);
+    pool->nb_workers++; /* from now on the free can clean up this worker */
+
+    if (bind) {
+      ret = mtl_get_lcore(st, &w->lcore);
+      if (ret < 0) {
+        err("%s(%d), get lcore fail %d\n", __func__, i, ret);
+        st_app_worker_pool_free(pool);
+        return NULL;
+      }
+      w->lcore_get = true;
+    }
+    ret = pthread_create(&w->thread, NULL, app_worker_thread, w);
+    if (ret) {
+      err("%s(%d), thread create fail %d\n", __func__, i, ret);
+      st_app_worker_pool_free(pool);
+      return NULL;
+    }
+    w->thread_created = true;
+  }
+
+  info("%s, %d workers%s\n", __func__, nb_workers, bind ? " pinned" : "");
+  return pool;
+}
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include <mtl/mtl_api.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#ifndef _APP_WORKER_HEAD_H_
+#define _APP_WORKER_HEAD_H_
+
+#define ST_APP_MAX_WORKERS (32)
+/* max jobs on one worker, power of 2 as each job is at most once in the queue */
+#define ST_APP_WORKER_QUEUE_SIZE (1024)
+
+struct st_app_worker;
+struct st_app_worker_pool;
+
+/* run one unit of work of the session, return > 0 if more work is pending */
+typedef int (*st_app_job_func)(void* priv);
+
+/* one session served by the worker pool, embedded in the session */
+struct st_app_job {
+  st_app_job_func func;
+  void* priv;
+  struct st_app_worker* worker; /* NULL if not attached */
+  atomic_bool queued;           /* in the event queue of the worker */
+  atomic_bool running;
+  atomic_bool detached;
+};
+
+/* nb_workers threads, each pinned to one lcore from mtl_get_lcore if bind */
+struct st_app_worker_pool* st_app_worker_pool_create(mtl_handle st, int nb_workers,
+                                                     bool bind);
+void st_app_worker_pool_free(struct st_app_worker_pool* pool);
+
+/* attach to the least loaded worker and queue the first run */
+int st_app_job_attach(struct st_app_worker_pool* pool, struct st_app_job* job,
+                      st_app_job_func func, void* priv);
+/* wait the job drained from the worker, no more run after this */
+void st_app_job_detach(struct st_app_job* job);
+/*
+ * Lock-free event from any thread(the lib callbacks), queue the job if not queued
+ * yet and wake the worker only if it sleeps. No-op if the job is not attached.
+ */
+void st_app_job_notify(struct st_app_job* job);
+
+#endif
@@ -20,6 +20,8 @@ enum st_args_cmd {
   ST_ARG_R_RX_IP,
   ST_ARG_P_SIP,
   ST_ARG_R_SIP,
+  ST_ARG_P_SIP6,
+  ST_ARG_R_SIP6,
 
   ST_ARG_TX_VIDEO_URL = 0x200,
   ST_ARG_TX_VIDEO_SESSIONS_CNT,
@@ -63,6 +65,11 @@ enum st_args_cmd {
   ST_ARG_NB_TX_DESC,
   ST_ARG_NB_RX_DESC,
   ST_ARG_DMA_DEV,
+  ST_ARG_DMA_CPU_ENGINE,
+  ST_ARG_SCH_ELASTIC,
+  ST_ARG_SCH_MAX_LCORES,
+  ST_ARG_RX_INTR,
+  ST_ARG_RX_INTR_IDLE_US,
   ST_ARG_RX_SEPARATE_VIDEO_LCORE,
   ST_ARG_RX_MIX_VIDEO_LCORE,
   ST_ARG_TSC_PACING,
@@ -70,6 +77,11 @@ enum st_args_cmd {
   ST_ARG_RUNTIME_SESSION,
   ST_ARG_TTF_FILE,
   ST_ARG_AF_XDP_ZC_DISABLE,
+  ST_ARG_AF_XDP_SHARED_UMEM,
+  ST_ARG_AF_XDP_BUSY_BUDGET,
+  ST_ARG_MEMIF_RX_LOSS,
+  ST_ARG_MEMIF_RX_REORDER,
+  ST_ARG_MEMIF_RX_JITTER,
   ST_ARG_START_QUEUE,
   ST_ARG_P_START_QUEUE,
   ST_ARG_R_START_QUEUE,
@@ -82,6 +94,9 @@ enum st_args_cmd {
   ST_ARG_TASKLET_SLEEP_US,
   ST_ARG_APP_THREAD,
   ST_ARG_RXTX_SIMD_512,
+  ST_ARG_VIDEO_IO_DEPTH,
+  ST_ARG_APP_WORKERS,
+  ST_ARG_STATE_FILE,
   ST_ARG_MAX,
 };
 
@@ -102,6 +117,8 @@ static struct option st_app_args_options[] = {
     {"r_rx_ip", required_argument, 0, ST_ARG_R_RX_IP},
     {"p_sip", required_argument, 0, ST_ARG_P_SIP},
     {"r_sip", required_argument, 0, ST_ARG_R_SIP},
+    {"p_sip6", required_argument, 0, ST_ARG_P_SIP6},
+    {"r_sip6", required_argument, 0, ST_ARG_R_SIP6},
 
     {"tx_video_url", required_argument, 0, ST_ARG_TX_VIDEO_URL},
     {"tx_video_sessions_count", required_argument, 0, ST_ARG_TX_VIDEO_SESSIONS_CNT},
@@ -148,11 +165,21 @@ static struct option st_app_args_options[] = {
     {"nb_tx_desc", required_argument, 0, ST_ARG_NB_TX_DESC},
     {"nb_rx_desc", required_argument, 0, ST_ARG_NB_RX_DESC},
     {"dma_dev", required_argument, 0, ST_ARG_DMA_DEV},
+    {"dma_cpu_engine", no_argument, 0, ST_ARG_DMA_CPU_ENGINE},
+    {"sch_elastic", no_argument, 0, ST_ARG_SCH_ELASTIC},
+    {"sch_max_lcores", required_argument, 0, ST_ARG_SCH_MAX_LCORES},
+    {"rx_intr", no_argument, 0, ST_ARG_RX_INTR},
+    {"rx_intr_idle_us", required_argument, 0, ST_ARG_RX_INTR_IDLE_US},
     {"tsc", no_argument, 0, ST_ARG_TSC_PACING},
     {"pcapng_dump", required_argument, 0, ST_ARG_PCAPNG_DUMP},
     {"runtime_session", no_argument, 0, ST_ARG_RUNTIME_SESSION},
     {"ttf_file", required_argument, 0, ST_ARG_TTF_FILE},
     {"afxdp_zc_disable", no_argument, 0, ST_ARG_AF_XDP_ZC_DISABLE},
+    {"afxdp_shared_umem", no_argument, 0, ST_ARG_AF_XDP_SHARED_UMEM},
+    {"afxdp_busy_budget", required_argument, 0, ST_ARG_AF_XDP_BUSY_BUDGET},
+    {"memif_rx_loss", required_argument, 0, ST_ARG_MEMIF_RX_LOSS},
+    {"memif_rx_reorder", required_argument, 0, ST_ARG_MEMIF_RX_REORDER},
+    {"memif_rx_jitter", required_argument, 0, ST_ARG_MEMIF_RX_JITTER},
     {"start_queue", required_argument, 0, ST_ARG_START_QUEUE},
     {"p_start_queue", required_argument, 0, ST_ARG_P_START_QUEUE},
     {"r_start_queue", required_argument, 0, ST_ARG_R_START_QUEUE},
@@ -165,6 +192,9 @@ static struct option st_app_args_options[] = {
     {"tasklet_sleep_us", required_argument, 0, ST_ARG_TASKLET_SLEEP_US},
     {"app_thread", no_argument, 0, ST_ARG_APP_THREAD},
     {"rxtx_simd_512", no_argument, 0, ST_ARG_RXTX_SIMD_512},
+    {"video_io_depth", required_argument, 0, ST_ARG_VIDEO_IO_DEPTH},
+    {"app_workers", required_argument, 0, ST_ARG_APP_WORKERS},
+    {"state_file", required_argument, 0, ST_ARG_STATE_FILE},
 
     {0, 0, 0, 0}};
 
@@ -287,6 +317,12 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_R_SIP:
         inet_pton(AF_INET, optarg, mtl_r_sip_addr(p));
         break;
+      case ST_ARG_P_SIP6:
+        inet_pton(AF_INET6, optarg, p->sip6_addr[MTL_PORT_P]);
+        break;
+      case ST_ARG_R_SIP6:
+        inet_pton(AF_INET6, optarg, p->sip6_addr[MTL_PORT_R]);
+        break;
       case ST_ARG_P_TX_IP:
         inet_pton(AF_INET, optarg, ctx->tx_dip_addr[MTL_PORT_P]);
         break;
@@ -459,6 +495,21 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_DMA_DEV:
         app_args_dma_dev(p, optarg);
         break;
+      case ST_ARG_DMA_CPU_ENGINE:
+        p->flags |= MTL_FLAG_DMA_CPU_ENGINE;
+        break;
+      case ST_ARG_SCH_ELASTIC:
+        p->flags |= MTL_FLAG_SCH_ELASTIC;
+        break;
+      case ST_ARG_SCH_MAX_LCORES:
+        p->sch_elastic.max_lcores = atoi(optarg);
+        break;
+      case ST_ARG_RX_INTR:
+        p->flags |= MTL_FLAG_RX_INTR;
+        break;
+      case ST_ARG_RX_INTR_IDLE_US:
+        p->rx_intr_idle_us = atoi(optarg);
+        break;
       case ST_ARG_PCAPNG_DUMP:
         ctx->pcapng_max_pkts = atoi(optarg);
         break;
@@ -471,6 +522,30 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_AF_XDP_ZC_DISABLE:
         p->flags |= MTL_FLAG_AF_XDP_ZC_DISABLE;
         break;
+      case ST_ARG_AF_XDP_SHARED_UMEM:
+        p->flags |= MTL_FLAG_AF_XDP_SHARED_UMEM;
+        break;
+      case ST_ARG_AF_XDP_BUSY_BUDGET:
+        nb = atoi(optarg);
+        if (nb > 0) {
+          p->xdp_info[MTL_PORT_P].busy_budget = nb;
+          p->xdp_info[MTL_PORT_R].busy_budget = nb;
+        } else {
+          p->flags |= MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE;
+        }
+        break;
+      case ST_ARG_MEMIF_RX_LOSS:
+        p->memif_info[MTL_PORT_P].rx_loss_ppm = atoi(optarg);
+        p->memif_info[MTL_PORT_R].rx_loss_ppm = atoi(optarg);
+        break;
+      case ST_ARG_MEMIF_RX_REORDER:
+        p->memif_info[MTL_PORT_P].rx_reorder_ppm = atoi(optarg);
+        p->memif_info[MTL_PORT_R].rx_reorder_ppm = atoi(optarg);
+        break;
+      case ST_ARG_MEMIF_RX_JITTER:
+        p->memif_info[MTL_PORT_P].rx_jitter_us = atoi(optarg);
+        p->memif_info[MTL_PORT_R].rx_jitter_us = atoi(optarg);
+        break;
       case ST_ARG_START_QUEUE:
         p->xdp_info[MTL_PORT_P].start_queue = atoi(optarg);
         p->xdp_info[MTL_PORT_R].start_queue = atoi(optarg);
@@ -508,6 +583,15 @@ int st_app_parse_args(struct st_app_context* ctx, struct mtl_init_params* p, int
       case ST_ARG_RXTX_SIMD_512:
         p->flags |= MTL_FLAG_RXTX_SIMD_512;
         break;
+      case ST_ARG_VIDEO_IO_DEPTH:
+        ctx->video_io_depth = atoi(optarg);
+        break;
+      case ST_ARG_APP_WORKERS:
+        ctx->app_workers = atoi(optarg);
+        break;
+      case ST_ARG_STATE_FILE:
+        p->state_file = optarg;
+        break;
       case '?':
         break;
       default:
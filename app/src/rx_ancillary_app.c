@@ -59,14 +59,13 @@ static void app_rx_anc_handle_rtp(struct st_app_rx_anc_session* s, void* usrptr)
 static void* app_rx_anc_read_thread(void* arg) {
   struct st_app_rx_anc_session* s = arg;
   int idx = s->idx;
-  void* usrptr;
-  uint16_t len;
-  void* mbuf;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st40_app_thread_stop) {
-    mbuf = st40_rx_get_mbuf(s->handle, &usrptr, &len);
-    if (!mbuf) {
+    nb = st40_rx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       /* no buffer */
       st_pthread_mutex_lock(&s->st40_wake_mutex);
       if (!s->st40_app_thread_stop)
@@ -74,9 +73,9 @@ static void* app_rx_anc_read_thread(void* arg) {
       st_pthread_mutex_unlock(&s->st40_wake_mutex);
       continue;
     }
-    /* parse the packet */
-    app_rx_anc_handle_rtp(s, usrptr);
-    st40_rx_put_mbuf(s->handle, mbuf);
+    /* parse the packets */
+    for (uint16_t i = 0; i < nb; i++) app_rx_anc_handle_rtp(s, bufs[i].usrptr);
+    st40_rx_put_mbufs(s->handle, bufs, nb);
   }
   info("%s(%d), stop\n", __func__, idx);
 
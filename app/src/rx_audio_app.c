@@ -97,15 +97,13 @@ static int app_rx_audio_handle_rtp(struct st_app_rx_audio_session* s,
 static void* app_rx_audio_rtp_thread(void* arg) {
   struct st_app_rx_audio_session* s = arg;
   int idx = s->idx;
-  void* usrptr;
-  uint16_t len;
-  void* mbuf;
-  struct st_rfc3550_rtp_hdr* hdr;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st30_app_thread_stop) {
-    mbuf = st30_rx_get_mbuf(s->handle, &usrptr, &len);
-    if (!mbuf) {
+    nb = st30_rx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       /* no buffer */
       st_pthread_mutex_lock(&s->st30_wake_mutex);
       if (!s->st30_app_thread_stop)
@@ -114,11 +112,11 @@ static void* app_rx_audio_rtp_thread(void* arg) {
       continue;
     }
 
-    /* get one packet */
-    hdr = (struct st_rfc3550_rtp_hdr*)usrptr;
-    app_rx_audio_handle_rtp(s, hdr);
+    /* get a burst of packets */
+    for (uint16_t i = 0; i < nb; i++)
+      app_rx_audio_handle_rtp(s, (struct st_rfc3550_rtp_hdr*)bufs[i].usrptr);
     /* free to lib */
-    st30_rx_put_mbuf(s->handle, mbuf);
+    st30_rx_put_mbufs(s->handle, bufs, nb);
   }
   info("%s(%d), stop\n", __func__, idx);
 
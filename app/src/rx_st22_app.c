@@ -87,6 +87,7 @@ static int app_rx_st22_frame_ready(void* priv, void* frame,
   }
   st_pthread_cond_signal(&s->wake_cond);
   st_pthread_mutex_unlock(&s->wake_mutex);
+  st_app_job_notify(&s->st22_job);
 
   return 0;
 }
@@ -102,34 +103,47 @@ static void app_rx_st22_decode_frame(struct st22_app_rx_session* s, void* codest
   s->fb_decoded++;
 }
 
+/* decode one frame, return 0 if no ready frame, run by the thread or a worker */
+static int app_rx_st22_decode_job(void* priv) {
+  struct st22_app_rx_session* s = priv;
+  int consumer_idx;
+  struct st_rx_frame* framebuff;
+
+  st_pthread_mutex_lock(&s->wake_mutex);
+  consumer_idx = s->framebuff_consumer_idx;
+  framebuff = &s->framebuffs[consumer_idx];
+  if (!framebuff->frame) {
+    /* no ready frame */
+    st_pthread_mutex_unlock(&s->wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->wake_mutex);
+
+  dbg("%s(%d), frame idx %d\n", __func__, s->idx, consumer_idx);
+  app_rx_st22_decode_frame(s, framebuff->frame, framebuff->size);
+  st22_rx_put_framebuff(s->handle, framebuff->frame);
+  /* point to next */
+  st_pthread_mutex_lock(&s->wake_mutex);
+  framebuff->frame = NULL;
+  consumer_idx++;
+  if (consumer_idx >= s->framebuff_cnt) consumer_idx = 0;
+  s->framebuff_consumer_idx = consumer_idx;
+  st_pthread_mutex_unlock(&s->wake_mutex);
+
+  return 1;
+}
+
 static void* app_rx_st22_decode_thread(void* arg) {
   struct st22_app_rx_session* s = arg;
   int idx = s->idx;
-  int consumer_idx;
-  struct st_rx_frame* framebuff;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st22_app_thread_stop) {
-    st_pthread_mutex_lock(&s->wake_mutex);
-    consumer_idx = s->framebuff_consumer_idx;
-    framebuff = &s->framebuffs[consumer_idx];
-    if (!framebuff->frame) {
-      /* no ready frame */
-      if (!s->st22_app_thread_stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
-      st_pthread_mutex_unlock(&s->wake_mutex);
-      continue;
-    }
-    st_pthread_mutex_unlock(&s->wake_mutex);
+    if (app_rx_st22_decode_job(s) > 0) continue;
 
-    dbg("%s(%d), frame idx %d\n", __func__, idx, consumer_idx);
-    app_rx_st22_decode_frame(s, framebuff->frame, framebuff->size);
-    st22_rx_put_framebuff(s->handle, framebuff->frame);
-    /* point to next */
     st_pthread_mutex_lock(&s->wake_mutex);
-    framebuff->frame = NULL;
-    consumer_idx++;
-    if (consumer_idx >= s->framebuff_cnt) consumer_idx = 0;
-    s->framebuff_consumer_idx = consumer_idx;
+    if (!s->st22_app_thread_stop && !s->framebuffs[s->framebuff_consumer_idx].frame)
+      st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
     st_pthread_mutex_unlock(&s->wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
@@ -140,6 +154,7 @@ static void* app_rx_st22_decode_thread(void* arg) {
 static int app_rx_st22_uinit(struct st22_app_rx_session* s) {
   int ret, idx = s->idx;
 
+  st_app_job_detach(&s->st22_job);
   s->st22_app_thread_stop = true;
   if (s->st22_app_thread) {
     /* wake up the thread */
@@ -239,7 +254,10 @@ static int app_rx_st22_init(struct st_app_context* ctx, struct st22_app_rx_sessi
   s->handle = handle;
 
   s->st22_app_thread_stop = false;
-  ret = pthread_create(&s->st22_app_thread, NULL, app_rx_st22_decode_thread, s);
+  if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st22_job, app_rx_st22_decode_job, s);
+  else
+    ret = pthread_create(&s->st22_app_thread, NULL, app_rx_st22_decode_thread, s);
   if (ret < 0) {
     err("%s(%d), init thread fail %d\n", __func__, idx, ret);
     app_rx_st22_uinit(s);
@@ -10,6 +10,7 @@ static int app_rx_st22p_frame_available(void* priv) {
   st_pthread_mutex_lock(&s->st22p_wake_mutex);
   st_pthread_cond_signal(&s->st22p_wake_cond);
   st_pthread_mutex_unlock(&s->st22p_wake_mutex);
+  st_app_job_notify(&s->st22p_job);
 
   return 0;
 }
@@ -37,52 +38,64 @@ static void app_rx_st22p_consume_frame(struct st_app_rx_st22p_session* s,
   }
 }
 
+/* consume one frame, return 0 if no ready frame, run by the thread or a worker */
+static int app_rx_st22p_frame_job(void* priv) {
+  struct st_app_rx_st22p_session* s = priv;
+  struct st_frame* frame;
+
+  frame = st22p_rx_get_frame(s->handle);
+  if (!frame) return 0; /* no frame */
+
+  s->stat_frame_received++;
+  if (s->measure_latency) {
+    uint64_t latency_ns;
+    uint64_t ptp_ns = mtl_ptp_read_time(s->st);
+    uint32_t sampling_rate = 90 * 1000;
+
+    if (frame->tfmt == ST10_TIMESTAMP_FMT_MEDIA_CLK) {
+      uint32_t latency_media_clk =
+          st10_tai_to_media_clk(ptp_ns, sampling_rate) - frame->timestamp;
+      latency_ns = st10_media_clk_to_ns(latency_media_clk, sampling_rate);
+    } else {
+      latency_ns = ptp_ns - frame->timestamp;
+    }
+    dbg("%s, latency_us %lu\n", __func__, latency_ns / 1000);
+    s->stat_latency_us_sum += latency_ns / 1000;
+  }
+
+  app_rx_st22p_consume_frame(s, frame);
+  s->stat_frame_total_received++;
+  if (!s->stat_frame_frist_rx_time)
+    s->stat_frame_frist_rx_time = st_app_get_monotonic_time();
+  st22p_rx_put_frame(s->handle, frame);
+
+  return 1;
+}
+
 static void* app_rx_st22p_frame_thread(void* arg) {
   struct st_app_rx_st22p_session* s = arg;
-  struct st_frame* frame;
 
   info("%s(%d), start\n", __func__, s->idx);
   while (!s->st22p_app_thread_stop) {
-    frame = st22p_rx_get_frame(s->handle);
-    if (!frame) { /* no frame */
-      st_pthread_mutex_lock(&s->st22p_wake_mutex);
-      if (!s->st22p_app_thread_stop)
-        st_pthread_cond_wait(&s->st22p_wake_cond, &s->st22p_wake_mutex);
-      st_pthread_mutex_unlock(&s->st22p_wake_mutex);
-      continue;
-    }
-
-    s->stat_frame_received++;
-    if (s->measure_latency) {
-      uint64_t latency_ns;
-      uint64_t ptp_ns = mtl_ptp_read_time(s->st);
-      uint32_t sampling_rate = 90 * 1000;
-
-      if (frame->tfmt == ST10_TIMESTAMP_FMT_MEDIA_CLK) {
-        uint32_t latency_media_clk =
-            st10_tai_to_media_clk(ptp_ns, sampling_rate) - frame->timestamp;
-        latency_ns = st10_media_clk_to_ns(latency_media_clk, sampling_rate);
-      } else {
-        latency_ns = ptp_ns - frame->timestamp;
-      }
-      dbg("%s, latency_us %lu\n", __func__, latency_ns / 1000);
-      s->stat_latency_us_sum += latency_ns / 1000;
-    }
+    if (app_rx_st22p_frame_job(s) > 0) continue;
 
-    app_rx_st22p_consume_frame(s, frame);
-    s->stat_frame_total_received++;
-    if (!s->stat_frame_frist_rx_time)
-      s->stat_frame_frist_rx_time = st_app_get_monotonic_time();
-    st22p_rx_put_frame(s->handle, frame);
+    st_pthread_mutex_lock(&s->st22p_wake_mutex);
+    if (!s->st22p_app_thread_stop)
+      st_pthread_cond_wait(&s->st22p_wake_cond, &s->st22p_wake_mutex);
+    st_pthread_mutex_unlock(&s->st22p_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, s->idx);
 
   return NULL;
 }
 
-static int app_rx_st22p_init_frame_thread(struct st_app_rx_st22p_session* s) {
+static int app_rx_st22p_init_frame_thread(struct st_app_context* ctx,
+                                          struct st_app_rx_st22p_session* s) {
   int ret, idx = s->idx;
 
+  if (ctx->worker_pool)
+    return st_app_job_attach(ctx->worker_pool, &s->st22p_job, app_rx_st22p_frame_job, s);
+
   ret = pthread_create(&s->st22p_app_thread, NULL, app_rx_st22p_frame_thread, s);
   if (ret < 0) {
     err("%s(%d), st22p_app_thread create fail %d\n", __func__, ret, idx);
@@ -95,6 +108,7 @@ static int app_rx_st22p_init_frame_thread(struct st_app_rx_st22p_session* s) {
 static int app_rx_st22p_uinit(struct st_app_rx_st22p_session* s) {
   int ret, idx = s->idx;
 
+  st_app_job_detach(&s->st22p_job);
   st_app_uinit_display(s->display);
   if (s->display) {
     st_app_free(s->display);
@@ -102,7 +116,7 @@ static int app_rx_st22p_uinit(struct st_app_rx_st22p_session* s) {
   }
 
   s->st22p_app_thread_stop = true;
-  if (s->st22p_app_thread_stop) {
+  if (s->st22p_app_thread) {
     /* wake up the thread */
     st_pthread_mutex_lock(&s->st22p_wake_mutex);
     st_pthread_cond_signal(&s->st22p_wake_cond);
@@ -198,7 +212,7 @@ static int app_rx_st22p_init(struct st_app_context* ctx,
 
   s->st22p_frame_size = st22p_rx_frame_size(handle);
 
-  ret = app_rx_st22p_init_frame_thread(s);
+  ret = app_rx_st22p_init_frame_thread(ctx, s);
   if (ret < 0) {
     err("%s(%d), app_rx_st22p_init_thread fail %d\n", __func__, idx, ret);
     app_rx_st22p_uinit(s);
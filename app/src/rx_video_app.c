@@ -72,35 +72,68 @@ static void app_rx_video_consume_frame(struct st_app_rx_video_session* s, void*
   }
 }
 
-static void* app_rx_video_frame_thread(void* arg) {
-  struct st_app_rx_video_session* s = arg;
-  int idx = s->idx;
+static void app_rx_video_write_done(void* priv, void* buf, void* req_priv, int result) {
+  struct st_app_rx_video_session* s = priv;
+
+  st20_rx_put_framebuff(s->handle, buf);
+}
+
+static void app_rx_video_write_frame(struct st_app_rx_video_session* s, void* frame,
+                                     size_t frame_size) {
+  off_t offset = s->st20_io_offset;
+
+  if (offset + frame_size > st_app_io_file_size(s->st20_io)) offset = 0;
+  s->st20_io_offset = offset + frame_size;
+  /* write behind from the session frame, put back to lib on the io done */
+  if (st_app_io_submit(s->st20_io, frame, frame_size, offset, NULL) < 0)
+    st20_rx_put_framebuff(s->handle, frame);
+}
+
+/* consume the next ready frame, return 0 if none, run by the thread or a worker */
+static int app_rx_video_frame_job(void* priv) {
+  struct st_app_rx_video_session* s = priv;
   int consumer_idx;
   struct st_rx_frame* framebuff;
 
-  info("%s(%d), start\n", __func__, idx);
-  while (!s->st20_app_thread_stop) {
-    st_pthread_mutex_lock(&s->st20_wake_mutex);
-    consumer_idx = s->framebuff_consumer_idx;
-    framebuff = &s->framebuffs[consumer_idx];
-    if (!framebuff->frame) {
-      /* no ready frame */
-      if (!s->st20_app_thread_stop)
-        st_pthread_cond_wait(&s->st20_wake_cond, &s->st20_wake_mutex);
-      st_pthread_mutex_unlock(&s->st20_wake_mutex);
-      continue;
-    }
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  consumer_idx = s->framebuff_consumer_idx;
+  framebuff = &s->framebuffs[consumer_idx];
+  if (!framebuff->frame) {
+    /* no ready frame */
     st_pthread_mutex_unlock(&s->st20_wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
 
-    dbg("%s(%d), frame idx %d\n", __func__, idx, consumer_idx);
+  dbg("%s(%d), frame idx %d\n", __func__, s->idx, consumer_idx);
+  if (s->st20_io && !s->display) {
+    app_rx_video_write_frame(s, framebuff->frame, framebuff->size);
+  } else {
     app_rx_video_consume_frame(s, framebuff->frame, framebuff->size);
     st20_rx_put_framebuff(s->handle, framebuff->frame);
-    /* point to next */
+  }
+  /* point to next */
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  framebuff->frame = NULL;
+  consumer_idx++;
+  if (consumer_idx >= s->framebuff_cnt) consumer_idx = 0;
+  s->framebuff_consumer_idx = consumer_idx;
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
+
+  return 1;
+}
+
+static void* app_rx_video_frame_thread(void* arg) {
+  struct st_app_rx_video_session* s = arg;
+  int idx = s->idx;
+
+  info("%s(%d), start\n", __func__, idx);
+  while (!s->st20_app_thread_stop) {
+    if (app_rx_video_frame_job(s) > 0) continue;
+
     st_pthread_mutex_lock(&s->st20_wake_mutex);
-    framebuff->frame = NULL;
-    consumer_idx++;
-    if (consumer_idx >= s->framebuff_cnt) consumer_idx = 0;
-    s->framebuff_consumer_idx = consumer_idx;
+    if (!s->st20_app_thread_stop && !s->framebuffs[s->framebuff_consumer_idx].frame)
+      st_pthread_cond_wait(&s->st20_wake_cond, &s->st20_wake_mutex);
     st_pthread_mutex_unlock(&s->st20_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
@@ -187,15 +220,13 @@ static int app_rx_video_handle_rtp(struct st_app_rx_video_session* s,
 static void* app_rx_video_rtp_thread(void* arg) {
   struct st_app_rx_video_session* s = arg;
   int idx = s->idx;
-  void* usrptr;
-  uint16_t len;
-  void* mbuf;
-  struct st20_rfc4175_rtp_hdr* hdr;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st20_app_thread_stop) {
-    mbuf = st20_rx_get_mbuf(s->handle, &usrptr, &len);
-    if (!mbuf) {
+    nb = st20_rx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       /* no buffer */
       st_pthread_mutex_lock(&s->st20_wake_mutex);
       if (!s->st20_app_thread_stop)
@@ -204,11 +235,11 @@ static void* app_rx_video_rtp_thread(void* arg) {
       continue;
     }
 
-    /* get one packet */
-    hdr = (struct st20_rfc4175_rtp_hdr*)usrptr;
-    app_rx_video_handle_rtp(s, hdr);
+    /* get a burst of packets */
+    for (uint16_t i = 0; i < nb; i++)
+      app_rx_video_handle_rtp(s, (struct st20_rfc4175_rtp_hdr*)bufs[i].usrptr);
     /* free to lib */
-    st20_rx_put_mbuf(s->handle, mbuf);
+    st20_rx_put_mbufs(s->handle, bufs, nb);
   }
   info("%s(%d), stop\n", __func__, idx);
 
@@ -225,13 +256,26 @@ static int app_rx_video_close_source(struct st_app_rx_video_session* s) {
   return 0;
 }
 
-static int app_rx_video_open_source(struct st_app_rx_video_session* s) {
+static int app_rx_video_open_source(struct st_app_rx_video_session* s, int io_depth) {
   int fd, ret, idx = s->idx;
   off_t f_size;
 
   /* user do not require fb save to file */
   if (s->st20_dst_fb_cnt < 1) return 0;
 
+  if (io_depth > 0) {
+    /* stream the frames to file, no page fault on the rx path */
+    f_size = s->st20_dst_fb_cnt * s->st20_frame_size;
+    s->st20_io = st_app_io_open(s->st20_dst_url, true, f_size, s->st20_frame_size,
+                                io_depth, app_rx_video_write_done, s);
+    if (!s->st20_io) {
+      err("%s(%d), io open %s fail\n", __func__, idx, s->st20_dst_url);
+      return -EIO;
+    }
+    s->st20_io_offset = 0;
+    return 0;
+  }
+
   fd = st_open_mode(s->st20_dst_url, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
   if (fd < 0) {
     err("%s(%d), open %s fail\n", __func__, idx, s->st20_dst_url);
@@ -263,12 +307,16 @@ static int app_rx_video_open_source(struct st_app_rx_video_session* s) {
   return 0;
 }
 
-static int app_rx_video_init_frame_thread(struct st_app_rx_video_session* s) {
+static int app_rx_video_init_frame_thread(struct st_app_context* ctx,
+                                          struct st_app_rx_video_session* s) {
   int ret, idx = s->idx;
 
   /* user do not require fb save to file or display */
   if (s->st20_dst_fb_cnt < 1 && s->display == NULL) return 0;
 
+  if (ctx->worker_pool)
+    return st_app_job_attach(ctx->worker_pool, &s->st20_job, app_rx_video_frame_job, s);
+
   ret = pthread_create(&s->st20_app_thread, NULL, app_rx_video_frame_thread, s);
   if (ret < 0) {
     err("%s(%d), st20_app_thread create fail %d\n", __func__, ret, idx);
@@ -323,7 +371,7 @@ static int app_rx_video_frame_ready(void* priv, void* frame,
   if (!s->stat_frame_frist_rx_time)
     s->stat_frame_frist_rx_time = st_app_get_monotonic_time();
 
-  if (s->st20_dst_fd < 0 && s->display == NULL) {
+  if (s->st20_dst_fd < 0 && !s->st20_io && s->display == NULL) {
     /* free the queue directly as no read thread is running */
     st20_rx_put_framebuff(s->handle, frame);
     return 0;
@@ -339,6 +387,7 @@ static int app_rx_video_frame_ready(void* priv, void* frame,
   }
   st_pthread_cond_signal(&s->st20_wake_cond);
   st_pthread_mutex_unlock(&s->st20_wake_mutex);
+  st_app_job_notify(&s->st20_job);
 
   return 0;
 }
@@ -392,6 +441,7 @@ static int app_rx_video_detected(void* priv, const struct st20_detect_meta* meta
 static int app_rx_video_uinit(struct st_app_rx_video_session* s) {
   int ret, idx = s->idx;
 
+  st_app_job_detach(&s->st20_job);
   st_app_uinit_display(s->display);
   if (s->display) {
     st_app_free(s->display);
@@ -406,6 +456,11 @@ static int app_rx_video_uinit(struct st_app_rx_video_session* s) {
     info("%s(%d), wait app thread stop\n", __func__, idx);
     pthread_join(s->st20_app_thread, NULL);
   }
+  /* drain the writes in flight, the frames are put back to lib on done */
+  if (s->st20_io) {
+    st_app_io_close(s->st20_io);
+    s->st20_io = NULL;
+  }
 
   st_pthread_mutex_destroy(&s->st20_wake_mutex);
   st_pthread_cond_destroy(&s->st20_wake_cond);
@@ -550,7 +605,9 @@ static int app_rx_video_init(struct st_app_context* ctx, st_json_video_session_t
 
   s->st20_frame_size = st20_rx_get_framebuffer_size(handle);
 
-  ret = app_rx_video_open_source(s);
+  /* rtp type writes the pkts to the mmap file directly */
+  ret = app_rx_video_open_source(
+      s, app_rx_video_is_frame_type(ops.type) ? ctx->video_io_depth : 0);
   if (ret < 0) {
     err("%s(%d), app_rx_video_open_source fail %d\n", __func__, idx, ret);
     app_rx_video_uinit(s);
@@ -558,7 +615,7 @@ static int app_rx_video_init(struct st_app_context* ctx, st_json_video_session_t
   }
 
   if (app_rx_video_is_frame_type(ops.type)) {
-    ret = app_rx_video_init_frame_thread(s);
+    ret = app_rx_video_init_frame_thread(ctx, s);
   } else if (ops.type == ST20_TYPE_RTP_LEVEL) {
     ret = app_rx_video_init_rtp_thread(s);
   } else {
@@ -8,6 +8,7 @@
 #include <sys/types.h>
 
 #include "app_base.h"
+#include "app_io.h"
 #include "fmt.h"
 #include "log.h"
 #include "player.h"
@@ -103,6 +103,9 @@ static void st_app_ctx_init(struct st_app_context* ctx) {
   ctx->st22_bpp = 3; /* 3bit per pixel */
 
   ctx->utc_offset = UTC_OFFSSET;
+#ifndef WINDOWSENV
+  ctx->video_io_depth = ST_APP_DEFAULT_VIDEO_IO_DEPTH;
+#endif
 
   /* init lcores and sch */
   for (int i = 0; i < ST_APP_MAX_LCORES; i++) {
@@ -160,6 +163,12 @@ static void st_app_ctx_free(struct st_app_context* ctx) {
   st_app_rx_st20r_sessions_uinit(ctx);
   st22_app_rx_sessions_uinit(ctx);
 
+  /* all jobs detached in the sessions uinit */
+  if (ctx->worker_pool) {
+    st_app_worker_pool_free(ctx->worker_pool);
+    ctx->worker_pool = NULL;
+  }
+
   if (ctx->runtime_session) {
     if (ctx->st) mtl_stop(ctx->st);
   }
@@ -316,6 +325,16 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (ctx->app_workers > 0) {
+    ctx->worker_pool =
+        st_app_worker_pool_create(ctx->st, ctx->app_workers, !ctx->app_thread);
+    if (!ctx->worker_pool) {
+      err("%s, worker pool create fail\n", __func__);
+      st_app_ctx_free(ctx);
+      return -EIO;
+    }
+  }
+
   ret = st_app_tx_video_sessions_init(ctx);
   if (ret < 0) {
     err("%s, st_app_tx_video_sessions_init fail %d\n", __func__, ret);
@@ -49,6 +49,7 @@ static int app_tx_anc_frame_done(void* priv, uint16_t frame_idx,
   }
   st_pthread_cond_signal(&s->st40_wake_cond);
   st_pthread_mutex_unlock(&s->st40_wake_mutex);
+  st_app_job_notify(&s->st40_job);
 
   s->st40_frame_done_cnt++;
   dbg("%s(%d), framebuffer index %d\n", __func__, s->idx, frame_idx);
@@ -86,36 +87,49 @@ static void app_tx_anc_build_frame(struct st_app_tx_anc_session* s,
     s->st40_frame_cursor = s->st40_source_begin;
 }
 
+/* fill the next free frame, return 0 if none, run by the thread or a worker */
+static int app_tx_anc_frame_job(void* priv) {
+  struct st_app_tx_anc_session* s = priv;
+  uint16_t producer_idx;
+  struct st_tx_frame* framebuff;
+
+  st_pthread_mutex_lock(&s->st40_wake_mutex);
+  producer_idx = s->framebuff_producer_idx;
+  framebuff = &s->framebuffs[producer_idx];
+  if (ST_TX_FRAME_FREE != framebuff->stat) {
+    /* not in free */
+    st_pthread_mutex_unlock(&s->st40_wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->st40_wake_mutex);
+
+  struct st40_frame* frame_addr = st40_tx_get_framebuffer(s->handle, producer_idx);
+  app_tx_anc_build_frame(s, frame_addr);
+
+  st_pthread_mutex_lock(&s->st40_wake_mutex);
+  framebuff->size = sizeof(*frame_addr);
+  framebuff->stat = ST_TX_FRAME_READY;
+  /* point to next */
+  producer_idx++;
+  if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
+  s->framebuff_producer_idx = producer_idx;
+  st_pthread_mutex_unlock(&s->st40_wake_mutex);
+
+  return 1;
+}
+
 static void* app_tx_anc_frame_thread(void* arg) {
   struct st_app_tx_anc_session* s = arg;
   int idx = s->idx;
-  uint16_t producer_idx;
-  struct st_tx_frame* framebuff;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st40_app_thread_stop) {
-    st_pthread_mutex_lock(&s->st40_wake_mutex);
-    producer_idx = s->framebuff_producer_idx;
-    framebuff = &s->framebuffs[producer_idx];
-    if (ST_TX_FRAME_FREE != framebuff->stat) {
-      /* not in free */
-      if (!s->st40_app_thread_stop)
-        st_pthread_cond_wait(&s->st40_wake_cond, &s->st40_wake_mutex);
-      st_pthread_mutex_unlock(&s->st40_wake_mutex);
-      continue;
-    }
-    st_pthread_mutex_unlock(&s->st40_wake_mutex);
-
-    struct st40_frame* frame_addr = st40_tx_get_framebuffer(s->handle, producer_idx);
-    app_tx_anc_build_frame(s, frame_addr);
+    if (app_tx_anc_frame_job(s) > 0) continue;
 
     st_pthread_mutex_lock(&s->st40_wake_mutex);
-    framebuff->size = sizeof(*frame_addr);
-    framebuff->stat = ST_TX_FRAME_READY;
-    /* point to next */
-    producer_idx++;
-    if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
-    s->framebuff_producer_idx = producer_idx;
+    if (!s->st40_app_thread_stop &&
+        (ST_TX_FRAME_FREE != s->framebuffs[s->framebuff_producer_idx].stat))
+      st_pthread_cond_wait(&s->st40_wake_cond, &s->st40_wake_mutex);
     st_pthread_mutex_unlock(&s->st40_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
@@ -244,19 +258,18 @@ static void app_tx_anc_build_rtp(struct st_app_tx_anc_session* s, void* usrptr,
 static void* app_tx_anc_rtp_thread(void* arg) {
   struct st_app_tx_anc_session* s = arg;
   int idx = s->idx;
-  void* mbuf;
-  void* usrptr = NULL;
-  uint16_t mbuf_len = 0;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st40_app_thread_stop) {
-    /* get available buffer*/
-    mbuf = st40_tx_get_mbuf(s->handle, &usrptr);
-    if (!mbuf) {
+    /* get available buffers */
+    nb = st40_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       st_pthread_mutex_lock(&s->st40_wake_mutex);
       /* try again */
-      mbuf = st40_tx_get_mbuf(s->handle, &usrptr);
-      if (mbuf) {
+      nb = st40_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+      if (nb) {
         st_pthread_mutex_unlock(&s->st40_wake_mutex);
       } else {
         if (!s->st40_app_thread_stop)
@@ -266,10 +279,11 @@ static void* app_tx_anc_rtp_thread(void* arg) {
       }
     }
 
-    /* build the rtp pkt */
-    app_tx_anc_build_rtp(s, usrptr, &mbuf_len);
+    /* build the rtp pkts */
+    for (uint16_t i = 0; i < nb; i++)
+      app_tx_anc_build_rtp(s, bufs[i].usrptr, &bufs[i].len);
 
-    st40_tx_put_mbuf(s->handle, mbuf, mbuf_len);
+    st40_tx_put_mbufs(s->handle, bufs, nb);
   }
   info("%s(%d), stop\n", __func__, idx);
 
@@ -326,7 +340,8 @@ static int app_tx_anc_close_source(struct st_app_tx_anc_session* s) {
   return 0;
 }
 
-static int app_tx_anc_start_source(struct st_app_tx_anc_session* s) {
+static int app_tx_anc_start_source(struct st_app_context* ctx,
+                                   struct st_app_tx_anc_session* s) {
   int ret = -EINVAL;
 
   s->st40_app_thread_stop = false;
@@ -334,6 +349,8 @@ static int app_tx_anc_start_source(struct st_app_tx_anc_session* s) {
     ret = pthread_create(&s->st40_app_thread, NULL, app_tx_anc_pcap_thread, (void*)s);
   else if (s->st40_rtp_input)
     ret = pthread_create(&s->st40_app_thread, NULL, app_tx_anc_rtp_thread, (void*)s);
+  else if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st40_job, app_tx_anc_frame_job, s);
   else
     ret = pthread_create(&s->st40_app_thread, NULL, app_tx_anc_frame_thread, (void*)s);
   if (ret < 0) {
@@ -345,6 +362,7 @@ static int app_tx_anc_start_source(struct st_app_tx_anc_session* s) {
 }
 
 static void app_tx_anc_stop_source(struct st_app_tx_anc_session* s) {
+  st_app_job_detach(&s->st40_job);
   if (s->st40_source_fd >= 0) {
     s->st40_app_thread_stop = true;
     /* wake up the thread */
@@ -473,7 +491,7 @@ static int app_tx_anc_init(struct st_app_context* ctx, st_json_ancillary_session
     return ret;
   }
 
-  ret = app_tx_anc_start_source(s);
+  ret = app_tx_anc_start_source(ctx, s);
   if (ret < 0) {
     err("%s(%d), app_tx_audio_session_start_source fail %d\n", __func__, idx, ret);
     app_tx_anc_uinit(s);
@@ -49,6 +49,7 @@ static int app_tx_audio_frame_done(void* priv, uint16_t frame_idx,
   }
   st_pthread_cond_signal(&s->st30_wake_cond);
   st_pthread_mutex_unlock(&s->st30_wake_mutex);
+  st_app_job_notify(&s->st30_job);
 
   s->st30_frame_done_cnt++;
   dbg("%s(%d), framebuffer index %d\n", __func__, s->idx, frame_idx);
@@ -82,36 +83,49 @@ static void app_tx_audio_build_frame(struct st_app_tx_audio_session* s, void* fr
   }
 }
 
+/* fill the next free frame, return 0 if none, run by the thread or a worker */
+static int app_tx_audio_frame_job(void* priv) {
+  struct st_app_tx_audio_session* s = priv;
+  uint16_t producer_idx;
+  struct st_tx_frame* framebuff;
+
+  st_pthread_mutex_lock(&s->st30_wake_mutex);
+  producer_idx = s->framebuff_producer_idx;
+  framebuff = &s->framebuffs[producer_idx];
+  if (ST_TX_FRAME_FREE != framebuff->stat) {
+    /* not in free */
+    st_pthread_mutex_unlock(&s->st30_wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->st30_wake_mutex);
+
+  void* frame_addr = st30_tx_get_framebuffer(s->handle, producer_idx);
+  app_tx_audio_build_frame(s, frame_addr, s->st30_frame_size);
+
+  st_pthread_mutex_lock(&s->st30_wake_mutex);
+  framebuff->size = s->st30_frame_size;
+  framebuff->stat = ST_TX_FRAME_READY;
+  /* point to next */
+  producer_idx++;
+  if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
+  s->framebuff_producer_idx = producer_idx;
+  st_pthread_mutex_unlock(&s->st30_wake_mutex);
+
+  return 1;
+}
+
 static void* app_tx_audio_frame_thread(void* arg) {
   struct st_app_tx_audio_session* s = arg;
   int idx = s->idx;
-  uint16_t producer_idx;
-  struct st_tx_frame* framebuff;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st30_app_thread_stop) {
-    st_pthread_mutex_lock(&s->st30_wake_mutex);
-    producer_idx = s->framebuff_producer_idx;
-    framebuff = &s->framebuffs[producer_idx];
-    if (ST_TX_FRAME_FREE != framebuff->stat) {
-      /* not in free */
-      if (!s->st30_app_thread_stop)
-        st_pthread_cond_wait(&s->st30_wake_cond, &s->st30_wake_mutex);
-      st_pthread_mutex_unlock(&s->st30_wake_mutex);
-      continue;
-    }
-    st_pthread_mutex_unlock(&s->st30_wake_mutex);
-
-    void* frame_addr = st30_tx_get_framebuffer(s->handle, producer_idx);
-    app_tx_audio_build_frame(s, frame_addr, s->st30_frame_size);
+    if (app_tx_audio_frame_job(s) > 0) continue;
 
     st_pthread_mutex_lock(&s->st30_wake_mutex);
-    framebuff->size = s->st30_frame_size;
-    framebuff->stat = ST_TX_FRAME_READY;
-    /* point to next */
-    producer_idx++;
-    if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
-    s->framebuff_producer_idx = producer_idx;
+    if (!s->st30_app_thread_stop &&
+        (ST_TX_FRAME_FREE != s->framebuffs[s->framebuff_producer_idx].stat))
+      st_pthread_cond_wait(&s->st30_wake_cond, &s->st30_wake_mutex);
     st_pthread_mutex_unlock(&s->st30_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
@@ -214,19 +228,18 @@ static void app_tx_audio_build_rtp(struct st_app_tx_audio_session* s, void* usrp
 static void* app_tx_audio_rtp_thread(void* arg) {
   struct st_app_tx_audio_session* s = arg;
   int idx = s->idx;
-  void* mbuf;
-  void* usrptr = NULL;
-  uint16_t mbuf_len = 0;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st30_app_thread_stop) {
-    /* get available buffer*/
-    mbuf = st30_tx_get_mbuf(s->handle, &usrptr);
-    if (!mbuf) {
+    /* get available buffers */
+    nb = st30_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       st_pthread_mutex_lock(&s->st30_wake_mutex);
       /* try again */
-      mbuf = st30_tx_get_mbuf(s->handle, &usrptr);
-      if (mbuf) {
+      nb = st30_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+      if (nb) {
         st_pthread_mutex_unlock(&s->st30_wake_mutex);
       } else {
         if (!s->st30_app_thread_stop)
@@ -236,10 +249,11 @@ static void* app_tx_audio_rtp_thread(void* arg) {
       }
     }
 
-    /* build the rtp pkt */
-    app_tx_audio_build_rtp(s, usrptr, &mbuf_len);
+    /* build the rtp pkts */
+    for (uint16_t i = 0; i < nb; i++)
+      app_tx_audio_build_rtp(s, bufs[i].usrptr, &bufs[i].len);
 
-    st30_tx_put_mbuf(s->handle, mbuf, mbuf_len);
+    st30_tx_put_mbufs(s->handle, bufs, nb);
   }
   info("%s(%d), stop\n", __func__, idx);
 
@@ -296,7 +310,8 @@ static int app_tx_audio_close_source(struct st_app_tx_audio_session* s) {
   return 0;
 }
 
-static int app_tx_audio_start_source(struct st_app_tx_audio_session* s) {
+static int app_tx_audio_start_source(struct st_app_context* ctx,
+                                     struct st_app_tx_audio_session* s) {
   int ret = -EINVAL;
 
   s->st30_app_thread_stop = false;
@@ -304,6 +319,8 @@ static int app_tx_audio_start_source(struct st_app_tx_audio_session* s) {
     ret = pthread_create(&s->st30_app_thread, NULL, app_tx_audio_pcap_thread, (void*)s);
   else if (s->st30_rtp_input)
     ret = pthread_create(&s->st30_app_thread, NULL, app_tx_audio_rtp_thread, (void*)s);
+  else if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st30_job, app_tx_audio_frame_job, s);
   else
     ret = pthread_create(&s->st30_app_thread, NULL, app_tx_audio_frame_thread, (void*)s);
 
@@ -316,6 +333,7 @@ static int app_tx_audio_start_source(struct st_app_tx_audio_session* s) {
 }
 
 static void app_tx_audio_stop_source(struct st_app_tx_audio_session* s) {
+  st_app_job_detach(&s->st30_job);
   if (s->st30_source_fd >= 0) {
     s->st30_app_thread_stop = true;
     /* wake up the thread */
@@ -459,7 +477,7 @@ static int app_tx_audio_init(struct st_app_context* ctx, st_json_audio_session_t
     return ret;
   }
 
-  ret = app_tx_audio_start_source(s);
+  ret = app_tx_audio_start_source(ctx, s);
   if (ret < 0) {
     err("%s(%d), app_tx_audio_session_start_source fail %d\n", __func__, idx, ret);
     app_tx_audio_uinit(s);
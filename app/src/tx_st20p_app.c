@@ -33,6 +33,7 @@ static int app_tx_st20p_frame_available(void* priv) {
   st_pthread_mutex_lock(&s->st20p_wake_mutex);
   st_pthread_cond_signal(&s->st20p_wake_cond);
   st_pthread_mutex_unlock(&s->st20p_wake_mutex);
+  st_app_job_notify(&s->st20p_job);
 
   return 0;
 }
@@ -51,24 +52,31 @@ static void app_tx_st20p_build_frame(struct st_app_tx_st20p_session* s,
   app_tx_st20p_display_frame(s, frame);
 }
 
+/* build one frame, return 0 if no free frame, run by the thread or a worker */
+static int app_tx_st20p_frame_job(void* priv) {
+  struct st_app_tx_st20p_session* s = priv;
+  struct st_frame* frame;
+
+  frame = st20p_tx_get_frame(s->handle);
+  if (!frame) return 0; /* no frame */
+  app_tx_st20p_build_frame(s, frame);
+  st20p_tx_put_frame(s->handle, frame);
+
+  return 1;
+}
+
 static void* app_tx_st20p_frame_thread(void* arg) {
   struct st_app_tx_st20p_session* s = arg;
-  st20p_tx_handle handle = s->handle;
   int idx = s->idx;
-  struct st_frame* frame;
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st20p_app_thread_stop) {
-    frame = st20p_tx_get_frame(handle);
-    if (!frame) { /* no frame */
-      st_pthread_mutex_lock(&s->st20p_wake_mutex);
-      if (!s->st20p_app_thread_stop)
-        st_pthread_cond_wait(&s->st20p_wake_cond, &s->st20p_wake_mutex);
-      st_pthread_mutex_unlock(&s->st20p_wake_mutex);
-      continue;
-    }
-    app_tx_st20p_build_frame(s, frame);
-    st20p_tx_put_frame(handle, frame);
+    if (app_tx_st20p_frame_job(s) > 0) continue;
+
+    st_pthread_mutex_lock(&s->st20p_wake_mutex);
+    if (!s->st20p_app_thread_stop)
+      st_pthread_cond_wait(&s->st20p_wake_cond, &s->st20p_wake_mutex);
+    st_pthread_mutex_unlock(&s->st20p_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
 
@@ -121,7 +129,10 @@ static int app_tx_st20p_start_source(struct st_app_context* ctx,
                                      struct st_app_tx_st20p_session* s) {
   int ret = -EINVAL;
 
-  ret = pthread_create(&s->st20p_app_thread, NULL, app_tx_st20p_frame_thread, s);
+  if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st20p_job, app_tx_st20p_frame_job, s);
+  else
+    ret = pthread_create(&s->st20p_app_thread, NULL, app_tx_st20p_frame_thread, s);
   if (ret < 0) {
     err("%s, st20p_app_thread create fail err = %d\n", __func__, ret);
     return ret;
@@ -133,6 +144,7 @@ static int app_tx_st20p_start_source(struct st_app_context* ctx,
 
 static void app_tx_st20p_stop_source(struct st_app_tx_st20p_session* s) {
   s->st20p_app_thread_stop = true;
+  st_app_job_detach(&s->st20p_job);
   /* wake up the thread */
   st_pthread_mutex_lock(&s->st20p_wake_mutex);
   st_pthread_cond_signal(&s->st20p_wake_cond);
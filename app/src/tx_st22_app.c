@@ -52,6 +52,7 @@ static int app_tx_st22_frame_done(void* priv, uint16_t frame_idx,
   }
   st_pthread_cond_signal(&s->wake_cond);
   st_pthread_mutex_unlock(&s->wake_mutex);
+  st_app_job_notify(&s->st22_job);
 
   return ret;
 }
@@ -95,41 +96,56 @@ static void app_tx_st22_build_frame(struct st22_app_tx_session* s, void* codestr
   *codestream_size = framesize;
 }
 
+/* fill the next free frame, return 0 if none, run by the thread or a worker */
+static int app_tx_st22_frame_job(void* priv) {
+  struct st22_app_tx_session* s = priv;
+  uint16_t producer_idx;
+  struct st_tx_frame* framebuff;
+
+  st_pthread_mutex_lock(&s->wake_mutex);
+  producer_idx = s->framebuff_producer_idx;
+  framebuff = &s->framebuffs[producer_idx];
+  if (ST_TX_FRAME_FREE != framebuff->stat) {
+    /* not in free */
+    st_pthread_mutex_unlock(&s->wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->wake_mutex);
+
+  /* the pool workers are pinned already */
+  if (!s->st22_job.worker) app_tx_st22_check_lcore(s, false);
+
+  void* frame_addr = st22_tx_get_fb_addr(s->handle, producer_idx);
+  size_t max_framesize = s->bytes_per_frame;
+  size_t codestream_size = s->bytes_per_frame;
+  app_tx_st22_build_frame(s, frame_addr, max_framesize, &codestream_size);
+
+  st_pthread_mutex_lock(&s->wake_mutex);
+  framebuff->size = codestream_size;
+  framebuff->stat = ST_TX_FRAME_READY;
+  /* point to next */
+  producer_idx++;
+  if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
+  s->framebuff_producer_idx = producer_idx;
+  st_pthread_mutex_unlock(&s->wake_mutex);
+
+  return 1;
+}
+
 static void* app_tx_st22_frame_thread(void* arg) {
   struct st22_app_tx_session* s = arg;
   int idx = s->idx;
-  uint16_t producer_idx;
-  struct st_tx_frame* framebuff;
 
   app_tx_st22_thread_bind(s);
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st22_app_thread_stop) {
-    st_pthread_mutex_lock(&s->wake_mutex);
-    producer_idx = s->framebuff_producer_idx;
-    framebuff = &s->framebuffs[producer_idx];
-    if (ST_TX_FRAME_FREE != framebuff->stat) {
-      /* not in free */
-      if (!s->st22_app_thread_stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
-      st_pthread_mutex_unlock(&s->wake_mutex);
-      continue;
-    }
-    st_pthread_mutex_unlock(&s->wake_mutex);
-
-    app_tx_st22_check_lcore(s, false);
-
-    void* frame_addr = st22_tx_get_fb_addr(s->handle, producer_idx);
-    size_t max_framesize = s->bytes_per_frame;
-    size_t codestream_size = s->bytes_per_frame;
-    app_tx_st22_build_frame(s, frame_addr, max_framesize, &codestream_size);
+    if (app_tx_st22_frame_job(s) > 0) continue;
 
     st_pthread_mutex_lock(&s->wake_mutex);
-    framebuff->size = codestream_size;
-    framebuff->stat = ST_TX_FRAME_READY;
-    /* point to next */
-    producer_idx++;
-    if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
-    s->framebuff_producer_idx = producer_idx;
+    if (!s->st22_app_thread_stop &&
+        (ST_TX_FRAME_FREE != s->framebuffs[s->framebuff_producer_idx].stat))
+      st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
     st_pthread_mutex_unlock(&s->wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
@@ -139,6 +155,7 @@ static void* app_tx_st22_frame_thread(void* arg) {
 
 static void app_tx_st22_stop_source(struct st22_app_tx_session* s) {
   s->st22_app_thread_stop = true;
+  st_app_job_detach(&s->st22_job);
   /* wake up the thread */
   st_pthread_mutex_lock(&s->wake_mutex);
   st_pthread_cond_signal(&s->wake_cond);
@@ -154,7 +171,10 @@ static int app_tx_st22_start_source(struct st_app_context* ctx,
   int ret = -EINVAL;
 
   s->st22_app_thread_stop = false;
-  ret = pthread_create(&s->st22_app_thread, NULL, app_tx_st22_frame_thread, s);
+  if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st22_job, app_tx_st22_frame_job, s);
+  else
+    ret = pthread_create(&s->st22_app_thread, NULL, app_tx_st22_frame_thread, s);
   if (ret < 0) {
     err("%s, st22_app_thread create fail err = %d\n", __func__, ret);
     return ret;
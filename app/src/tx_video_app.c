@@ -81,6 +81,7 @@ static int app_tx_video_frame_done(void* priv, uint16_t frame_idx,
   }
   st_pthread_cond_signal(&s->st20_wake_cond);
   st_pthread_mutex_unlock(&s->st20_wake_mutex);
+  st_app_job_notify(&s->st20_job);
 
   s->st20_frame_done_cnt++;
   if (!s->stat_frame_frist_tx_time)
@@ -94,12 +95,17 @@ static int app_tx_video_frame_lines_ready(void* priv, uint16_t frame_idx,
   struct st_app_tx_video_session* s = priv;
   struct st_tx_frame* framebuff = &s->framebuffs[frame_idx];
 
+  bool trigger;
+
   st_pthread_mutex_lock(&s->st20_wake_mutex);
+  trigger = !framebuff->slice_trigger;
   framebuff->slice_trigger = true;
   meta->lines_ready = framebuff->lines_ready;
   dbg("%s(%d), frame %u ready %d lines\n", __func__, s->idx, frame_idx,
       framebuff->lines_ready);
+  if (trigger) st_pthread_cond_signal(&s->st20_wake_cond);
   st_pthread_mutex_unlock(&s->st20_wake_mutex);
+  if (trigger) st_app_job_notify(&s->st20_job);
 
   return 0;
 }
@@ -150,24 +156,45 @@ static void app_tx_video_build_frame(struct st_app_tx_video_session* s, void* fr
   app_tx_video_display_frame(s, frame);
 }
 
-static void app_tx_video_build_slice(struct st_app_tx_video_session* s,
-                                     struct st_tx_frame* framebuff, void* frame_addr) {
+static void app_tx_video_read_done(void* priv, void* buf, void* req_priv, int result) {
+  struct st_app_tx_video_session* s = priv;
+  struct st_tx_frame* framebuff = req_priv;
+
+  /* send the frame anyway even if the read fail, error already logged by io */
+  app_tx_video_display_frame(s, buf);
+
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  framebuff->stat = ST_TX_FRAME_READY;
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
+}
+
+static int app_tx_video_read_frame(struct st_app_tx_video_session* s,
+                                   struct st_tx_frame* framebuff, void* frame,
+                                   size_t frame_size) {
+  off_t offset = s->st20_io_offset;
+
+  /* read into the session frame directly, ready on the io done */
+  s->st20_io_offset += frame_size;
+  if (s->st20_io_offset + frame_size > st_app_io_file_size(s->st20_io))
+    s->st20_io_offset = 0;
+
+  return st_app_io_submit(s->st20_io, frame, frame_size, offset, framebuff);
+}
+
+/* build the pending slice frame, return 0 if the lib not query the lines yet */
+static int app_tx_video_build_slice(struct st_app_tx_video_session* s) {
+  struct st_tx_frame* framebuff = s->slice_framebuff;
   int lines_build = 0;
   int bytes_per_slice = framebuff->size / s->height * s->lines_per_slice;
-  int frame_size = framebuff->size;
-
-  if (s->st20_frame_cursor + frame_size > s->st20_source_end) {
-    s->st20_frame_cursor = s->st20_source_begin;
-  }
-  uint8_t* src = s->st20_frame_cursor;
-  uint8_t* dst = frame_addr;
-  /* point to next frame */
-  s->st20_frame_cursor += frame_size;
+  uint8_t* src = s->slice_src;
+  uint8_t* dst = s->slice_dst;
+  bool trigger;
 
   /* simulate the timing */
-  while (!framebuff->slice_trigger) {
-    st_usleep(1);
-  }
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  trigger = framebuff->slice_trigger;
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
+  if (!trigger) return 0;
 
   mtl_memcpy(dst, src, bytes_per_slice);
   dst += bytes_per_slice;
@@ -192,42 +219,59 @@ static void app_tx_video_build_slice(struct st_app_tx_video_session* s,
     framebuff->lines_ready = lines_build;
     st_pthread_mutex_unlock(&s->st20_wake_mutex);
   }
+
+  s->slice_framebuff = NULL;
+  return 1;
 }
 
-static void* app_tx_video_frame_thread(void* arg) {
-  struct st_app_tx_video_session* s = arg;
-  int idx = s->idx;
+static void app_tx_video_start_slice(struct st_app_tx_video_session* s,
+                                     struct st_tx_frame* framebuff, void* frame_addr) {
+  int frame_size = s->st20_frame_size;
+
+  if (s->st20_frame_cursor + frame_size > s->st20_source_end) {
+    s->st20_frame_cursor = s->st20_source_begin;
+  }
+  s->slice_src = s->st20_frame_cursor;
+  s->slice_dst = frame_addr;
+  s->slice_framebuff = framebuff;
+  /* point to next frame */
+  s->st20_frame_cursor += frame_size;
+}
+
+/* with the wake mutex held, true if the job has nothing to do */
+static bool app_tx_video_frame_idle(struct st_app_tx_video_session* s) {
+  if (s->slice_framebuff) return !s->slice_framebuff->slice_trigger;
+  return ST_TX_FRAME_FREE != s->framebuffs[s->framebuff_producer_idx].stat;
+}
+
+/* fill the next free frame, return 0 if none, run by the thread or a worker */
+static int app_tx_video_frame_job(void* priv) {
+  struct st_app_tx_video_session* s = priv;
   uint16_t producer_idx;
   struct st_tx_frame* framebuff;
 
-  app_tx_video_thread_bind(s);
+  /* the slice frame in building, no new frame before it's done */
+  if (s->slice_framebuff) return app_tx_video_build_slice(s);
 
-  info("%s(%d), start\n", __func__, idx);
-  while (!s->st20_app_thread_stop) {
-    st_pthread_mutex_lock(&s->st20_wake_mutex);
-    producer_idx = s->framebuff_producer_idx;
-    framebuff = &s->framebuffs[producer_idx];
-    if (ST_TX_FRAME_FREE != framebuff->stat) {
-      /* not in free */
-      if (!s->st20_app_thread_stop)
-        st_pthread_cond_wait(&s->st20_wake_cond, &s->st20_wake_mutex);
-      st_pthread_mutex_unlock(&s->st20_wake_mutex);
-      continue;
-    }
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  producer_idx = s->framebuff_producer_idx;
+  framebuff = &s->framebuffs[producer_idx];
+  if (ST_TX_FRAME_FREE != framebuff->stat) {
+    /* not in free */
     st_pthread_mutex_unlock(&s->st20_wake_mutex);
+    return 0;
+  }
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
 
-    app_tx_video_check_lcore(s, false);
-
-    void* frame_addr = st20_tx_get_framebuffer(s->handle, producer_idx);
-    if (!s->slice) {
-      /* interlaced use different layout? */
-      app_tx_video_build_frame(s, frame_addr, s->st20_frame_size);
-    }
+  /* the pool workers are pinned already */
+  if (!s->st20_job.worker) app_tx_video_check_lcore(s, false);
 
+  void* frame_addr = st20_tx_get_framebuffer(s->handle, producer_idx);
+  if (s->st20_io) {
     st_pthread_mutex_lock(&s->st20_wake_mutex);
     framebuff->size = s->st20_frame_size;
     framebuff->second_field = s->second_field;
-    framebuff->stat = ST_TX_FRAME_READY;
+    framebuff->stat = ST_TX_FRAME_IN_READING;
     /* point to next */
     producer_idx++;
     if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
@@ -237,79 +281,53 @@ static void* app_tx_video_frame_thread(void* arg) {
     }
     st_pthread_mutex_unlock(&s->st20_wake_mutex);
 
-    if (s->slice) {
-      app_tx_video_build_slice(s, framebuff, frame_addr);
-    }
+    app_tx_video_read_frame(s, framebuff, frame_addr, s->st20_frame_size);
+    return 1;
+  }
+  if (!s->slice) {
+    /* interlaced use different layout? */
+    app_tx_video_build_frame(s, frame_addr, s->st20_frame_size);
   }
-  info("%s(%d), stop\n", __func__, idx);
 
-  return NULL;
+  st_pthread_mutex_lock(&s->st20_wake_mutex);
+  if (s->slice) {
+    framebuff->slice_trigger = false;
+    framebuff->lines_ready = 0;
+  }
+  framebuff->size = s->st20_frame_size;
+  framebuff->second_field = s->second_field;
+  framebuff->stat = ST_TX_FRAME_READY;
+  /* point to next */
+  producer_idx++;
+  if (producer_idx >= s->framebuff_cnt) producer_idx = 0;
+  s->framebuff_producer_idx = producer_idx;
+  if (s->interlaced) {
+    s->second_field = !s->second_field;
+  }
+  st_pthread_mutex_unlock(&s->st20_wake_mutex);
+
+  if (s->slice) {
+    app_tx_video_start_slice(s, framebuff, frame_addr);
+    app_tx_video_build_slice(s);
+  }
+
+  return 1;
 }
 
-static void* app_tx_video_pcap_thread(void* arg) {
+static void* app_tx_video_frame_thread(void* arg) {
   struct st_app_tx_video_session* s = arg;
   int idx = s->idx;
-  void* mbuf;
-  void* usrptr = NULL;
-  struct pcap_pkthdr hdr;
-  uint8_t* packet;
-  struct ether_header* eth_hdr;
-  struct ip* ip_hdr;
-  struct udphdr* udp_hdr;
-  uint16_t udp_data_len;
 
   app_tx_video_thread_bind(s);
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st20_app_thread_stop) {
-    /* get available buffer*/
-    mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-    if (!mbuf) {
-      st_pthread_mutex_lock(&s->st20_wake_mutex);
-      /* try again */
-      mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-      if (mbuf) {
-        st_pthread_mutex_unlock(&s->st20_wake_mutex);
-      } else {
-        if (!s->st20_app_thread_stop)
-          st_pthread_cond_wait(&s->st20_wake_cond, &s->st20_wake_mutex);
-        st_pthread_mutex_unlock(&s->st20_wake_mutex);
-        continue;
-      }
-    }
-    udp_data_len = 0;
-    packet = (uint8_t*)pcap_next(s->st20_pcap, &hdr);
-    if (packet) {
-      eth_hdr = (struct ether_header*)packet;
-      if (ntohs(eth_hdr->ether_type) == ETHERTYPE_IP) {
-        ip_hdr = (struct ip*)(packet + sizeof(struct ether_header));
-        if (ip_hdr->ip_p == IPPROTO_UDP) {
-          udp_hdr =
-              (struct udphdr*)(packet + sizeof(struct ether_header) + sizeof(struct ip));
-          udp_data_len = ntohs(udp_hdr->uh_ulen) - sizeof(struct udphdr);
-          mtl_memcpy(usrptr,
-                     packet + sizeof(struct ether_header) + sizeof(struct ip) +
-                         sizeof(struct udphdr),
-                     udp_data_len);
-        }
-      }
-    } else {
-      char err_buf[PCAP_ERRBUF_SIZE];
-      pcap_close(s->st20_pcap);
-      /* open capture file for offline processing */
-      s->st20_pcap = pcap_open_offline(s->st20_source_url, err_buf);
-      if (s->st20_pcap == NULL) {
-        err("pcap_open_offline %s() failed: %s\n:", s->st20_source_url, err_buf);
-        return NULL;
-      }
-    }
-
-    struct st_rfc3550_rtp_hdr* hdr = (struct st_rfc3550_rtp_hdr*)usrptr;
-    if (hdr->payload_type != s->payload_type) udp_data_len = 0;
-
-    st20_tx_put_mbuf(s->handle, mbuf, udp_data_len);
+    if (app_tx_video_frame_job(s) > 0) continue;
 
-    app_tx_video_check_lcore(s, true);
+    st_pthread_mutex_lock(&s->st20_wake_mutex);
+    if (!s->st20_app_thread_stop && app_tx_video_frame_idle(s))
+      st_pthread_cond_wait(&s->st20_wake_cond, &s->st20_wake_mutex);
+    st_pthread_mutex_unlock(&s->st20_wake_mutex);
   }
   info("%s(%d), stop\n", __func__, idx);
 
@@ -475,21 +493,20 @@ static int app_tx_video_build_rtp_packet(struct st_app_tx_video_session* s,
 static void* app_tx_video_rtp_thread(void* arg) {
   struct st_app_tx_video_session* s = arg;
   int idx = s->idx;
-  void* mbuf;
-  void* usrptr = NULL;
-  uint16_t mbuf_len = 0;
+  struct st_rtp_buf bufs[ST_APP_RTP_BURST_SIZE];
+  uint16_t nb;
 
   app_tx_video_thread_bind(s);
 
   info("%s(%d), start\n", __func__, idx);
   while (!s->st20_app_thread_stop) {
-    /* get available buffer*/
-    mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-    if (!mbuf) {
+    /* get available buffers */
+    nb = st20_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+    if (!nb) {
       st_pthread_mutex_lock(&s->st20_wake_mutex);
       /* try again */
-      mbuf = st20_tx_get_mbuf(s->handle, &usrptr);
-      if (mbuf) {
+      nb = st20_tx_get_mbufs(s->handle, bufs, ST_APP_RTP_BURST_SIZE);
+      if (nb) {
         st_pthread_mutex_unlock(&s->st20_wake_mutex);
       } else {
         if (!s->st20_app_thread_stop)
@@ -499,10 +516,12 @@ static void* app_tx_video_rtp_thread(void* arg) {
       }
     }
 
-    /* build the rtp pkt */
-    app_tx_video_build_rtp_packet(s, (struct st20_rfc4175_rtp_hdr*)usrptr, &mbuf_len);
+    /* build the rtp pkts */
+    for (uint16_t i = 0; i < nb; i++)
+      app_tx_video_build_rtp_packet(s, (struct st20_rfc4175_rtp_hdr*)bufs[i].usrptr,
+                                    &bufs[i].len);
 
-    st20_tx_put_mbuf(s->handle, mbuf, mbuf_len);
+    st20_tx_put_mbufs(s->handle, bufs, nb);
 
     app_tx_video_check_lcore(s, true);
   }
@@ -512,7 +531,28 @@ static void* app_tx_video_rtp_thread(void* arg) {
 }
 
 static int app_tx_video_open_source(struct st_app_tx_video_session* s) {
-  if (!s->st20_pcap_input) {
+  struct st_app_context* ctx = s->ctx;
+
+  if (!s->st20_pcap_input && !s->st20_rtp_input && !s->slice && !ctx->tx_copy_once &&
+      (ctx->video_io_depth > 0)) {
+    /* stream the source into the session frames, constant memory for big clips */
+    s->st20_io = st_app_io_open(s->st20_source_url, false, 0, s->st20_frame_size,
+                                ctx->video_io_depth, app_tx_video_read_done, s);
+    if (!s->st20_io) {
+      err("%s, io open fail '%s'\n", __func__, s->st20_source_url);
+      return -EIO;
+    }
+    if (st_app_io_file_size(s->st20_io) < s->st20_frame_size) {
+      err("%s, %s file size small then a frame %d\n", __func__, s->st20_source_url,
+          s->st20_frame_size);
+      st_app_io_close(s->st20_io);
+      s->st20_io = NULL;
+      return -EIO;
+    }
+    s->st20_io_offset = 0;
+  } else if (s->st20_pcap_input) {
+    /* replayed by the lib from the capture, see replay_url */
+  } else {
     int fd;
     struct stat i;
 
@@ -550,15 +590,6 @@ static int app_tx_video_open_source(struct st_app_tx_video_session* s) {
       s->st20_source_end = s->st20_source_begin + i.st_size;
       close(fd);
     }
-  } else {
-    char err_buf[PCAP_ERRBUF_SIZE];
-
-    /* open capture file for offline processing */
-    s->st20_pcap = pcap_open_offline(s->st20_source_url, err_buf);
-    if (!s->st20_pcap) {
-      err("pcap_open_offline %s() failed: %s\n:", s->st20_source_url, err_buf);
-      return -EIO;
-    }
   }
 
   return 0;
@@ -569,9 +600,11 @@ static int app_tx_video_start_source(struct st_app_context* ctx,
   int ret = -EINVAL;
 
   if (s->st20_pcap_input)
-    ret = pthread_create(&s->st20_app_thread, NULL, app_tx_video_pcap_thread, s);
+    ret = 0; /* no app thread, the lib feeds the pkts */
   else if (s->st20_rtp_input)
     ret = pthread_create(&s->st20_app_thread, NULL, app_tx_video_rtp_thread, s);
+  else if (ctx->worker_pool)
+    ret = st_app_job_attach(ctx->worker_pool, &s->st20_job, app_tx_video_frame_job, s);
   else
     ret = pthread_create(&s->st20_app_thread, NULL, app_tx_video_frame_thread, s);
   if (ret < 0) {
@@ -585,6 +618,7 @@ static int app_tx_video_start_source(struct st_app_context* ctx,
 
 static void app_tx_video_stop_source(struct st_app_tx_video_session* s) {
   s->st20_app_thread_stop = true;
+  st_app_job_detach(&s->st20_job);
   /* wake up the thread */
   st_pthread_mutex_lock(&s->st20_wake_mutex);
   st_pthread_cond_signal(&s->st20_wake_cond);
@@ -593,6 +627,11 @@ static void app_tx_video_stop_source(struct st_app_tx_video_session* s) {
     pthread_join(s->st20_app_thread, NULL);
     s->st20_app_thread = 0;
   }
+  /* drain the reads in flight before the session frames are freed */
+  if (s->st20_io) {
+    st_app_io_close(s->st20_io);
+    s->st20_io = NULL;
+  }
 }
 
 static int app_tx_video_close_source(struct st_app_tx_video_session* s) {
@@ -605,11 +644,6 @@ static int app_tx_video_close_source(struct st_app_tx_video_session* s) {
     close(s->st20_source_fd);
     s->st20_source_fd = -1;
   }
-  if (s->st20_pcap) {
-    pcap_close(s->st20_pcap);
-    s->st20_pcap = NULL;
-  }
-
   return 0;
 }
 
@@ -751,7 +785,9 @@ static int app_tx_video_init(struct st_app_context* ctx, st_json_video_session_t
 
   /* select rtp type for pcap file or tx_video_rtp_ring_size */
   if (strstr(s->st20_source_url, ".pcap")) {
+    /* replay the first udp flow with the recorded timing */
     ops.type = ST20_TYPE_RTP_LEVEL;
+    ops.replay_url = s->st20_source_url;
     s->st20_pcap_input = true;
   } else if (ctx->tx_video_rtp_ring_size > 0) {
     ops.type = ST20_TYPE_RTP_LEVEL;
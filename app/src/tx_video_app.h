@@ -10,6 +10,7 @@
 #include <sys/types.h>
 
 #include "app_base.h"
+#include "app_io.h"
 #include "log.h"
 #include "player.h"
 
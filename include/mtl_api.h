@@ -65,6 +65,10 @@ extern "C" {
  * Length of a IPV4 address
  */
 #define MTL_IP_ADDR_LEN (4)
+/**
+ * Length of a IPV6 address
+ */
+#define MTL_IP6_ADDR_LEN (16)
 /**
  * Defined if current platform is little endian
  */
@@ -148,6 +152,12 @@ enum mtl_pmd_type {
   MTL_PMD_DPDK_USER = 0,
   /** address family(kernel) high performance packet processing */
   MTL_PMD_DPDK_AF_XDP,
+  /**
+   * shared memory packet interface, the port name is memif:<server|client>:<id>.
+   * The tx queue of one side connect to the rx queue with same index of the peer, the
+   * peer can be another port in this instance or another MTL process on the host.
+   */
+  MTL_PMD_DPDK_MEMIF,
   /** max value of this enum */
   MTL_PMD_TYPE_MAX,
 };
@@ -184,6 +194,7 @@ enum st21_tx_pacing_way {
 /**
  * Flag bit in flags of struct mtl_init_params.
  * If set, lib will call numa_bind to bind app thread and memory to NIC socket also.
+ * With NICs on different sockets, the bind covers the sockets of all ports.
  */
 #define MTL_FLAG_BIND_NUMA (MTL_BIT64(0))
 /**
@@ -231,6 +242,36 @@ enum st21_tx_pacing_way {
  * Enable the UDP transport feature support.
  */
 #define MTL_FLAG_UDP_TRANSPORT (MTL_BIT64(8))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Share one UMEM(mempool) across all the rx queues of a MTL_PMD_DPDK_AF_XDP port,
+ * the tx sessions with zero copy also reuse this UMEM.
+ */
+#define MTL_FLAG_AF_XDP_SHARED_UMEM (MTL_BIT64(9))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Enable the cpu dma engine as the fallback of the hw dma dev, the copy is offloaded to a
+ * dedicated helper lcore with non-temporal store to reduce the LLC pollution.
+ * Only for IOVA VA mode, and only the sessions with ST20_RX_FLAG_DMA_OFFLOAD use it.
+ */
+#define MTL_FLAG_DMA_CPU_ENGINE (MTL_BIT64(10))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Enable the elastic scheduler pool, the lcores are spawned and retired at runtime by the
+ * measured busy ratio, see struct mtl_sch_elastic_params. The video sessions are handed
+ * off by the migrate, so use with MTL_FLAG_TX_VIDEO_MIGRATE/MTL_FLAG_RX_VIDEO_MIGRATE.
+ * The busy ratio is measured by the tasklet loops with pending work, it works with or
+ * without MTL_FLAG_TASKLET_SLEEP, add MTL_FLAG_TASKLET_SLEEP to release the idle cpu.
+ */
+#define MTL_FLAG_SCH_ELASTIC (MTL_BIT64(11))
+/**
+ * Flag bit in flags of struct mtl_init_params.
+ * Hybrid interrupt/poll rx for the idle sessions. When all the rx queues of a scheduler
+ * are quiet for longer than rx_intr_idle_us, the NIC rx interrupt is armed and the
+ * scheduler blocks on it until packets arrive, then it goes back to busy polling.
+ * Work with MTL_FLAG_TASKLET_SLEEP, the queue without rx interrupt keeps the timer sleep.
+ */
+#define MTL_FLAG_RX_INTR (MTL_BIT64(12))
 
 /**
  * Flag bit in flags of struct mtl_init_params, debug usage only.
@@ -283,6 +324,17 @@ enum st21_tx_pacing_way {
  * Disable system rx queues, pls use mcast or manual TX mac.
  */
 #define MTL_FLAG_DISABLE_SYSTEM_RX_QUEUES (MTL_BIT64(28))
+/**
+ * Flag bit in flags of struct mtl_init_params, debug usage only.
+ * Disable the SO_PREFER_BUSY_POLL busy polling for af_xdp socket.
+ */
+#define MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE (MTL_BIT64(29))
+/**
+ * Flag bit in flags of struct mtl_init_params, debug usage only.
+ * The tx video sessions with FEC send the first pkt of the first rows of each frame to
+ * the next UDP port, so the rx sees them lost. For the FEC recovery test.
+ */
+#define MTL_FLAG_TX_VIDEO_FEC_TEST_DROP (MTL_BIT64(30))
 
 /**
  * The structure describing how to init af_xdp interface.
@@ -293,6 +345,69 @@ struct mtl_af_xdp_params {
   uint8_t start_queue;
   /** total netdev queue number, must > 0 */
   uint8_t queue_count;
+  /**
+   * busy poll budget of the SO_PREFER_BUSY_POLL socket option,
+   * 0 means determined by the PMD. Use MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE to disable.
+   * The napi_defer_hard_irqs and gro_flush_timeout of the netdev should be set also.
+   */
+  uint16_t busy_budget;
+  /**
+   * number of descriptors for the xsk rx ring and the fill ring refilled from it,
+   * 0 means use nb_rx_desc in mtl_init_params.
+   */
+  uint16_t rx_ring_size;
+  /**
+   * number of descriptors for the xsk tx ring and the completion ring drained from it,
+   * 0 means use nb_tx_desc in mtl_init_params.
+   */
+  uint16_t tx_ring_size;
+};
+
+/**
+ * The structure describing the impairment injected on a MTL_PMD_DPDK_MEMIF port.
+ * Applied on the rx path of the session queues, the system queue(arp, igmp) is kept.
+ */
+struct mtl_memif_params {
+  /** packet loss rate, in parts per million */
+  uint32_t rx_loss_ppm;
+  /** rate of swapping one packet with the next one, in parts per million */
+  uint32_t rx_reorder_ppm;
+  /**
+   * max random delay(us) of each packet, the packets are held in a queue and released
+   * on the later rx polls in the original order.
+   */
+  uint32_t rx_jitter_us;
+};
+
+/**
+ * The event of the scheduler(lcore) pool, see sch_event_cb in struct mtl_init_params.
+ */
+enum mtl_sch_event {
+  /** a new scheduler lcore is started at runtime */
+  MTL_SCH_EVENT_SPAWN = 0,
+  /** a scheduler lcore is stopped at runtime and given back to the system */
+  MTL_SCH_EVENT_RETIRE,
+  /** a scheduler stays above busy_high, sessions will be moved out */
+  MTL_SCH_EVENT_OVERLOAD,
+  /** a scheduler stays below busy_low, it will be drained if others can hold it */
+  MTL_SCH_EVENT_IDLE,
+  /** max value of this enum */
+  MTL_SCH_EVENT_MAX,
+};
+
+/**
+ * The structure describing the elastic scheduler pool, only for MTL_FLAG_SCH_ELASTIC.
+ * The busy ratio is sampled in every admin period(5s).
+ */
+struct mtl_sch_elastic_params {
+  /** max lcores for the schedulers, 0 means no limit */
+  uint8_t max_lcores;
+  /** busy ratio(0-100) to scale up, 0 means determined by lib */
+  uint8_t busy_high;
+  /** busy ratio(0-100) to scale down, 0 means determined by lib */
+  uint8_t busy_low;
+  /** continuous periods above/below the ratio before act, 0 means determined by lib */
+  uint8_t hysteresis_periods;
 };
 
 /**
@@ -330,6 +445,8 @@ struct mtl_init_params {
    * MTL_PMD_DPDK_AF_XDP will use the IP of kernel itself.
    */
   struct mtl_af_xdp_params xdp_info[MTL_PORT_MAX];
+  /** memif port impairment info, only for MTL_PMD_DPDK_MEMIF */
+  struct mtl_memif_params memif_info[MTL_PORT_MAX];
   /**
    * logical cores list can be used, e.g. "28,29,30,31".
    * NULL means determined by system itself
@@ -356,6 +473,19 @@ struct mtl_init_params {
   void (*stat_dump_cb_fn)(void* priv);
   /** data quota for each lcore, 0 means determined by lib */
   uint32_t data_quota_mbs_per_sch;
+  /** elastic scheduler pool info, only for MTL_FLAG_SCH_ELASTIC */
+  struct mtl_sch_elastic_params sch_elastic;
+  /**
+   * scheduler pool event callback, lcore is the one spawned or retired.
+   * Called from the lib admin thread or the session create/free, should not block.
+   */
+  void (*sch_event_cb)(void* priv, enum mtl_sch_event event, int sch_idx,
+                       unsigned int lcore);
+  /**
+   * quiet time(us) of the rx queues before the rx interrupt is armed, only for
+   * MTL_FLAG_RX_INTR. 0 means determined by lib.
+   */
+  uint32_t rx_intr_idle_us;
   /**
    * number of transmit descriptors for each NIC TX queue, 0 means determined by lib.
    * It will affect the memory usage and the performance.
@@ -385,6 +515,27 @@ struct mtl_init_params {
    * The st21 tx pacing way, leave to zero(auto) if you don't known the detail.
    */
   enum st21_tx_pacing_way pacing;
+  /** threads of the shared plugin worker pool, 0 means determined by lib */
+  uint8_t plugin_workers;
+  /**
+   * cpu list the plugin workers pinned to, ex: "28,29,30-31", each worker takes one cpu
+   * in turn. NULL means not pinned.
+   */
+  char* plugin_worker_cores;
+  /**
+   * Path of the warm restart state file. The tsc calibration, pacing training results,
+   * arp cache and ptp servo state are restored from it in mtl_init and saved back in
+   * mtl_uninit, so a restarted process skips the slow convergence. Use mtl_state_save
+   * to also save it at runtime for a process which may crash. The device setup,
+   * mempools and frame buffers are not saved, they are created again. NULL to disable.
+   */
+  char* state_file;
+  /**
+   * Optional global IPV6 address of each port, answered by the NDP together with the
+   * link-local address derived from the port mac, and the source of the ipv6 sessions
+   * to a global dst. All zero for link-local only.
+   */
+  uint8_t sip6_addr[MTL_PORT_MAX][MTL_IP6_ADDR_LEN];
 };
 
 /**
@@ -431,6 +582,35 @@ struct mtl_stats {
   uint8_t dev_started;
 };
 
+/**
+ * A structure used to retrieve state for a scheduler of MTL instance.
+ */
+struct mtl_sch_stats {
+  /** the lcore this scheduler is running on */
+  unsigned int lcore;
+  /** number of tasklets attached to this scheduler */
+  int tasklet_cnt;
+  /**
+   * busy ratio(0-100) of the lcore in last 5s, the time share of the scheduler loops
+   * which have pending work, the idle polling and the sleep are not counted.
+   */
+  float busy_ratio;
+  /** wakeups by the rx interrupt, only for MTL_FLAG_RX_INTR */
+  uint64_t rx_intr_wakeups;
+  /** max latency(us) from the rx interrupt to the scheduler back to polling */
+  uint32_t rx_intr_wake_max_us;
+  /** average latency(us) from the rx interrupt to the scheduler back to polling */
+  float rx_intr_wake_avg_us;
+  /** numa socket of the lcore, -1(SOCKET_ID_ANY) if the scheduler runs in a thread */
+  int socket_id;
+  /**
+   * estimated cross socket memory traffic(MB/s) in the last stat period: the frame
+   * bytes of the st20/st22 video sessions on this scheduler whose port is on another
+   * socket. It's an estimate from the frame rate, not a hardware counter.
+   */
+  float numa_remote_est_mbs;
+};
+
 /**
  * Inline function returning primary port pointer from mtl_init_params
  * @param p
@@ -591,6 +771,35 @@ int mtl_sch_enable_sleep(mtl_handle mt, int sch_idx, bool enable);
  */
 int mtl_sch_set_sleep_us(mtl_handle mt, uint64_t us);
 
+/**
+ * Save the warm restart state to the state_file of struct mtl_init_params now. It's
+ * also saved in mtl_uninit, call it periodically so a crashed process still leaves a
+ * recent state for the next mtl_init.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code, -EINVAL if no state_file.
+ */
+int mtl_state_save(mtl_handle mt);
+
+/**
+ * Retrieve the stat info of one scheduler.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param sch_idx
+ *   The sch index, get from st20_tx_get_sch_idx or st20_rx_get_sch_idx.
+ * @param stats
+ *   A pointer to a structure of type *mtl_sch_stats* to be filled.
+ * @return
+ *   - 0: Success.
+ *   - -ENODEV: The sch is not active.
+ *   - <0: Error code.
+ */
+int mtl_sch_get_stats(mtl_handle mt, int sch_idx, struct mtl_sch_stats* stats);
+
 /**
  * Request one DPDK lcore from the media transport device context.
  *
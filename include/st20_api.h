@@ -28,6 +28,11 @@ extern "C" {
  */
 #define ST22_FB_MAX_COUNT (8)
 
+/**
+ * Max allowed columns(L) or rows(D) of the st20 FEC matrix
+ */
+#define ST20_FEC_MAX_DIM (32)
+
 /**
  * Flag bit in flags of struct st20_tx_ops.
  * P TX destination mac assigned by user
@@ -60,6 +65,34 @@ extern "C" {
  * If enabled, lib will pass ST_EVENT_VSYNC by the notify_event on every epoch start.
  */
 #define ST20_TX_FLAG_ENABLE_VSYNC (MTL_BIT32(5))
+/**
+ * Flag bit in flags of struct st20_tx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL.
+ * If enabled, lib will calculate the CRC32C of each frame payload during the packet
+ * build and pass it by the crc of st20_tx_frame_meta in notify_frame_done.
+ * The zero copy payload is not touched by the cpu otherwise, so it costs one more
+ * read pass over the frame on the tx core.
+ */
+#define ST20_TX_FLAG_ENABLE_CRC (MTL_BIT32(6))
+/**
+ * Flag bit in flags of struct st20_tx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL with two ports.
+ * If enabled, the pkts of the frame are striped across the two ports by the pkt index
+ * instead of the 2022-7 duplicate, so one session can exceed the capacity of one link.
+ * The P port sends the even pkts and the R port the odd ones, each port is a rtp stream
+ * with its own seq. The R seq restarts each frame at the seq of the P frame head, so it
+ * skips one for a frame with odd pkts. Tsc pacing is always used. The stripe is over the
+ * P/R pair only, not more ports.
+ */
+#define ST20_TX_FLAG_PORT_STRIPE (MTL_BIT32(7))
+/**
+ * Flag bit in flags of struct st20_tx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL without fec, MTL_PMD_DPDK_USER only.
+ * If enabled, the pkts are sent over IPV6 to dip6_addr, the dst mac is resolved by NDP
+ * and the source is the sip6_addr(or the link-local) of the port. Unicast only, the
+ * udp checksum is offloaded to the nic if capable, else done in software.
+ */
+#define ST20_TX_FLAG_IPV6 (MTL_BIT32(8))
 
 /**
  * Flag bit in flags of struct st22_tx_ops.
@@ -142,6 +175,29 @@ extern "C" {
  * Always disable MIGRATE for this session.
  */
 #define ST20_RX_FLAG_DISABLE_MIGRATE (MTL_BIT32(20))
+/**
+ * Flag bit in flags of struct st20_rx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL without uframe.
+ * If enabled, lib will calculate the CRC32C of each frame payload during the packet
+ * copy and pass it by the crc of st20_rx_frame_meta in notify_frame_ready.
+ */
+#define ST20_RX_FLAG_ENABLE_CRC (MTL_BIT32(21))
+/**
+ * Flag bit in flags of struct st20_rx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL with two ports.
+ * The two ports receive the partial streams of a ST20_TX_FLAG_PORT_STRIPE sender, which
+ * are merged into one frame by the per port seq. The frame is reported as complete, not
+ * reconstructed, and it's incomplete if one port misses its pkts. Only the P/R pair.
+ */
+#define ST20_RX_FLAG_PORT_STRIPE (MTL_BIT32(22))
+/**
+ * Flag bit in flags of struct st20_rx_ops.
+ * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL, MTL_PMD_DPDK_USER only.
+ * If enabled, the session receives the IPV6 stream from the unicast sender sip6_addr
+ * to the address of the port. No multicast(MLDv2), auto detect, hdr split and fec yet,
+ * st20_rx_update_source returns -ENOTSUP for the ipv6 session.
+ */
+#define ST20_RX_FLAG_IPV6 (MTL_BIT32(23))
 
 /**
  * Flag bit in flags of struct st22_rx_ops, for non MTL_PMD_DPDK_USER.
@@ -297,6 +353,11 @@ struct st20_tx_frame_meta {
   enum st10_timestamp_fmt tfmt;
   /** Timestamp value */
   uint64_t timestamp;
+  /**
+   * CRC32C of the frame payload(pixel group data without line padding), set by lib
+   * before notify_frame_done if ST20_TX_FLAG_ENABLE_CRC.
+   */
+  uint32_t crc;
 };
 
 /**
@@ -338,6 +399,11 @@ struct st20_rx_frame_meta {
   size_t frame_recv_size;
   /** Private data for user, get from query_ext_frame callback */
   void* opaque;
+  /**
+   * CRC32C of the frame payload(pixel group data without line padding), only valid
+   * for the complete frame if ST20_RX_FLAG_ENABLE_CRC.
+   */
+  uint32_t crc;
 };
 
 /**
@@ -533,6 +599,47 @@ MTL_PACK(struct st20_rfc4175_extra_rtp_hdr {
   uint16_t row_offset;
 });
 
+/** The FEC pkt protects one row(L consecutive pkts) of the FEC matrix */
+#define ST20_FEC_TYPE_ROW (0)
+/** The FEC pkt protects one column(D pkts with L stride) of the FEC matrix */
+#define ST20_FEC_TYPE_COL (1)
+/**
+ * Length of the sample row data headers in the FEC xor unit, the two SRD of one
+ * rfc4175 pkt(row_length, row_number, row_offset), zero for the second if absent.
+ */
+#define ST20_FEC_SRD_LEN (12)
+
+/**
+ * A structure describing a st2110-20(video) SMPTE 2022-5 style XOR FEC rtp header,
+ * size: 28. The payload followed is the xor of the protected pkts, each pkt is
+ * ST20_FEC_SRD_LEN bytes SRD plus the payload, zero padded to length.
+ */
+MTL_PACK(struct st20_fec_rtp_hdr {
+  /** Rtp rfc3550 base hdr, tmstamp is the same as the protected frame */
+  struct st_rfc3550_rtp_hdr base;
+  /** Index of the first media pkt of the FEC matrix within the frame */
+  uint32_t base_idx;
+  /**
+   * Extended(32 bits) seq number of the media pkt at base_idx, the rx gets the seq
+   * base of the frame from it if the first media pkt is lost.
+   */
+  uint32_t base_seq;
+  /** Length of the xor data, SRD included */
+  uint16_t length;
+  /** ST20_FEC_TYPE_ROW or ST20_FEC_TYPE_COL */
+  uint8_t type;
+  /** Row or column index within the FEC matrix */
+  uint8_t index;
+  /** Columns(L) of the FEC matrix */
+  uint8_t cols;
+  /** Rows(D) of the FEC matrix */
+  uint8_t rows;
+  /** Number of pkts protected, less than L(D) for the last matrix of frame */
+  uint8_t count;
+  /** Reserved */
+  uint8_t reserved;
+});
+
 /** Pixel Group describing two image pixels in YUV 4:4:4 or RGB 12-bit format */
 #ifdef MTL_LITTLE_ENDIAN
 MTL_PACK(struct st20_rfc4175_444_12_pg2_be {
@@ -881,6 +988,33 @@ struct st20_tx_ops {
    * Valid if ST20_TX_FLAG_USER_P(R)_MAC is enabled
    */
   uint8_t tx_dst_mac[MTL_PORT_MAX][6];
+  /**
+   * Optional. Columns(L) and rows(D) of the SMPTE 2022-5 style XOR FEC matrix,
+   * should be in range [0, ST20_FEC_MAX_DIM], 0 for both means FEC disabled.
+   * Row FEC pkts are sent if fec_cols > 1 and column FEC pkts if fec_rows > 1, all
+   * after the media pkts of each frame within the frame time.
+   * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL with one port.
+   */
+  uint8_t fec_cols;
+  /** Rows(D) of the FEC matrix, see fec_cols */
+  uint8_t fec_rows;
+  /** 7 bits payload type of the FEC pkts, valid if FEC enabled */
+  uint8_t fec_payload_type;
+
+  /**
+   * Optional. Path of a pcap/pcapng capture the lib replays in a loop with the
+   * recorded inter-packet gaps, only for ST20_TYPE_RTP_LEVEL.
+   * The flow should be a ST2110-20(RFC4175) one. The payload is sent as is, the dst
+   * ip/mac, udp port and SSRC are rewritten to this session, and the RTP seq and
+   * timestamp continue across the loops. The rtp ring API(rtp_ring_size, notify_rtp_done)
+   * is not used then, rtp_pkt_size should not be less than the largest RTP pkt of the
+   * flow. Not supported on Windows.
+   */
+  const char* replay_url;
+  /** dst UDP port of the flow to replay in the capture, 0 for the first UDP flow */
+  uint16_t replay_udp_port;
+  /** replay speed in percent of the recorded timing, 0 means 100(original) */
+  uint16_t replay_speed;
 
   /**
    * the frame buffer count requested for one st20 tx session,
@@ -946,6 +1080,8 @@ struct st20_tx_ops {
    * Ex, cast to struct st10_vsync_meta for ST_EVENT_VSYNC.
    */
   int (*notify_event)(void* priv, enum st_event event, void* args);
+  /** Destination IPV6 address, only for ST20_TX_FLAG_IPV6 */
+  uint8_t dip6_addr[MTL_PORT_MAX][MTL_IP6_ADDR_LEN];
 };
 
 /**
@@ -1128,6 +1264,13 @@ struct st20_rx_ops {
   uint32_t flags;
   /** interlace or not false: non-interlaced: true: interlaced*/
   bool interlaced;
+  /**
+   * Optional. 7 bits payload type of the SMPTE 2022-5 style XOR FEC pkts, the lost
+   * pkts are rebuilt into the frame from the FEC pkts. 0 means FEC disabled.
+   * Only for ST20_TYPE_FRAME_LEVEL/ST20_TYPE_SLICE_LEVEL with one port, not for
+   * uframe, dma offload or header split mode.
+   */
+  uint8_t fec_payload_type;
 
   /**
    * the ST20_TYPE_FRAME_LEVEL frame buffer count requested,
@@ -1223,6 +1366,13 @@ struct st20_rx_ops {
    * Ex, cast to struct st10_vsync_meta for ST_EVENT_VSYNC.
    */
   int (*notify_event)(void* priv, enum st_event event, void* args);
+  /**
+   * Optional. Source filter IP address of multicast(SSM), only receive the group
+   * from this sender if set. All zero means any source.
+   */
+  uint8_t mcast_sip_addr[MTL_PORT_MAX][MTL_IP_ADDR_LEN];
+  /** Sender IPV6 address, only for ST20_RX_FLAG_IPV6 */
+  uint8_t sip6_addr[MTL_PORT_MAX][MTL_IP6_ADDR_LEN];
 };
 
 /**
@@ -1306,6 +1456,11 @@ struct st22_rx_ops {
    * Ex, cast to struct st10_vsync_meta for ST_EVENT_VSYNC.
    */
   int (*notify_event)(void* priv, enum st_event event, void* args);
+  /**
+   * Optional. Source filter IP address of multicast(SSM), only receive the group
+   * from this sender if set. All zero means any source.
+   */
+  uint8_t mcast_sip_addr[MTL_PORT_MAX][MTL_IP_ADDR_LEN];
 };
 
 /**
@@ -1414,6 +1569,41 @@ void* st20_tx_get_mbuf(st20_tx_handle handle, void** usrptr);
  */
 int st20_tx_put_mbuf(st20_tx_handle handle, void* mbuf, uint16_t len);
 
+/**
+ * Bulk version of st20_tx_get_mbuf, get up to nb mbufs from the
+ * tx st2110-20(video) session.
+ * For ST20_TYPE_RTP_LEVEL.
+ * Must call st20_tx_put_mbufs to return the mbufs after rtp pack done.
+ *
+ * @param handle
+ *   The handle to the tx st2110-20(video) session.
+ * @param bufs
+ *   The array to hold the mbuf and usrptr of each got pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st20_tx_get_mbufs(st20_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st20_tx_put_mbuf, put back the mbufs which get by
+ * st20_tx_get_mbufs.
+ * For ST20_TYPE_RTP_LEVEL.
+ * The len of each buf should be set to the rtp package length before put, the pkt
+ * with an invalid len is freed by lib.
+ *
+ * @param handle
+ *   The handle to the tx st2110-20(video) session.
+ * @param bufs
+ *   The bufs array by st20_tx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ * @return
+ *   - The number of pkts enqueued to the session, the others are freed.
+ */
+uint16_t st20_tx_put_mbufs(st20_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Get the scheduler index for the tx st2110-20(video) session.
  *
@@ -1539,6 +1729,41 @@ void* st22_tx_get_mbuf(st22_tx_handle handle, void** usrptr);
  */
 int st22_tx_put_mbuf(st22_tx_handle handle, void* mbuf, uint16_t len);
 
+/**
+ * Bulk version of st22_tx_get_mbuf, get up to nb mbufs from the
+ * tx st2110-22(compressed video) session.
+ * For ST22_TYPE_RTP_LEVEL.
+ * Must call st22_tx_put_mbufs to return the mbufs after rtp pack done.
+ *
+ * @param handle
+ *   The handle to the tx st2110-22(compressed video) session.
+ * @param bufs
+ *   The array to hold the mbuf and usrptr of each got pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st22_tx_get_mbufs(st22_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st22_tx_put_mbuf, put back the mbufs which get by
+ * st22_tx_get_mbufs.
+ * For ST22_TYPE_RTP_LEVEL.
+ * The len of each buf should be set to the rtp package length before put, the pkt
+ * with an invalid len is freed by lib.
+ *
+ * @param handle
+ *   The handle to the tx st2110-22(compressed video) session.
+ * @param bufs
+ *   The bufs array by st22_tx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ * @return
+ *   - The number of pkts enqueued to the session, the others are freed.
+ */
+uint16_t st22_tx_put_mbufs(st22_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Get the scheduler index for the tx st2110-22(compressed video) session.
  *
@@ -1693,6 +1918,37 @@ void* st20_rx_get_mbuf(st20_rx_handle handle, void** usrptr, uint16_t* len);
  */
 void st20_rx_put_mbuf(st20_rx_handle handle, void* mbuf);
 
+/**
+ * Bulk version of st20_rx_get_mbuf, get up to nb mbufs from the
+ * rx st2110-20(video) session.
+ * For ST20_TYPE_RTP_LEVEL.
+ * Must call st20_rx_put_mbufs to return the mbufs after consume it.
+ *
+ * @param handle
+ *   The handle to the rx st2110-20(video) session.
+ * @param bufs
+ *   The array to hold the mbuf, usrptr and rtp len of each received pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st20_rx_get_mbufs(st20_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st20_rx_put_mbuf, put back the mbufs which get by
+ * st20_rx_get_mbufs.
+ * For ST20_TYPE_RTP_LEVEL.
+ *
+ * @param handle
+ *   The handle to the rx st2110-20(video) session.
+ * @param bufs
+ *   The bufs array by st20_rx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ */
+void st20_rx_put_mbufs(st20_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Get the queue meta attached to rx st2110-20(video) session.
  *
@@ -1813,6 +2069,37 @@ void* st22_rx_get_mbuf(st22_rx_handle handle, void** usrptr, uint16_t* len);
  */
 void st22_rx_put_mbuf(st22_rx_handle handle, void* mbuf);
 
+/**
+ * Bulk version of st22_rx_get_mbuf, get up to nb mbufs from the
+ * rx st2110-22(compressed video) session.
+ * For ST22_TYPE_RTP_LEVEL.
+ * Must call st22_rx_put_mbufs to return the mbufs after consume it.
+ *
+ * @param handle
+ *   The handle to the rx st2110-22(compressed video) session.
+ * @param bufs
+ *   The array to hold the mbuf, usrptr and rtp len of each received pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st22_rx_get_mbufs(st22_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st22_rx_put_mbuf, put back the mbufs which get by
+ * st22_rx_get_mbufs.
+ * For ST22_TYPE_RTP_LEVEL.
+ *
+ * @param handle
+ *   The handle to the rx st2110-22(compressed video) session.
+ * @param bufs
+ *   The bufs array by st22_rx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ */
+void st22_rx_put_mbufs(st22_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Put back the received buff get from notify_frame_ready.
  * For ST22_TYPE_FRAME_LEVEL.
@@ -310,6 +310,11 @@ struct st40_rx_ops {
    * routine.
    */
   int (*notify_rtp_ready)(void* priv);
+  /**
+   * Optional. Source filter IP address of multicast(SSM), only receive the group
+   * from this sender if set. All zero means any source.
+   */
+  uint8_t mcast_sip_addr[MTL_PORT_MAX][MTL_IP_ADDR_LEN];
 };
 
 /**
@@ -382,6 +387,39 @@ void* st40_tx_get_mbuf(st40_tx_handle handle, void** usrptr);
  */
 int st40_tx_put_mbuf(st40_tx_handle handle, void* mbuf, uint16_t len);
 
+/**
+ * Bulk version of st40_tx_get_mbuf, get up to nb mbufs from the
+ * tx st2110-40(ancillary) session.
+ * Must call st40_tx_put_mbufs to return the mbufs after rtp pack done.
+ *
+ * @param handle
+ *   The handle to the tx st2110-40(ancillary) session.
+ * @param bufs
+ *   The array to hold the mbuf and usrptr of each got pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st40_tx_get_mbufs(st40_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st40_tx_put_mbuf, put back the mbufs which get by
+ * st40_tx_get_mbufs.
+ * The len of each buf should be set to the rtp package length before put, the pkt
+ * with an invalid len is freed by lib.
+ *
+ * @param handle
+ *   The handle to the tx st2110-40(ancillary) session.
+ * @param bufs
+ *   The bufs array by st40_tx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ * @return
+ *   - The number of pkts enqueued to the session, the others are freed.
+ */
+uint16_t st40_tx_put_mbufs(st40_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Create one rx st2110-40(ancillary) session.
  *
@@ -448,6 +486,35 @@ void* st40_rx_get_mbuf(st40_rx_handle handle, void** usrptr, uint16_t* len);
  */
 void st40_rx_put_mbuf(st40_rx_handle handle, void* mbuf);
 
+/**
+ * Bulk version of st40_rx_get_mbuf, get up to nb mbufs from the
+ * rx st2110-40(ancillary) session.
+ * Must call st40_rx_put_mbufs to return the mbufs after consume it.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40(ancillary) session.
+ * @param bufs
+ *   The array to hold the mbuf, usrptr and rtp len of each received pkt.
+ * @param nb
+ *   The max number of mbufs to get.
+ * @return
+ *   - The number of mbufs got, 0 if no avaiable mbuf in the ring.
+ */
+uint16_t st40_rx_get_mbufs(st40_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
+/**
+ * Bulk version of st40_rx_put_mbuf, put back the mbufs which get by
+ * st40_rx_get_mbufs.
+ *
+ * @param handle
+ *   The handle to the rx st2110-40(ancillary) session.
+ * @param bufs
+ *   The bufs array by st40_rx_get_mbufs.
+ * @param nb
+ *   The number of bufs to put.
+ */
+void st40_rx_put_mbufs(st40_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb);
+
 /**
  * Get the queue meta attached to rx st2110-40(ancillary) session.
  *
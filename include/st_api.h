@@ -116,6 +116,22 @@ MTL_PACK(struct st_rfc3550_rtp_hdr {
 });
 #endif
 
+/**
+ * The structure describing one rtp pkt of the bulk mbuf APIs of RTP level sessions,
+ * like st20_tx_get_mbufs/st20_tx_put_mbufs and st20_rx_get_mbufs/st20_rx_put_mbufs.
+ */
+struct st_rtp_buf {
+  /** the dpdk mbuf pointer */
+  void* mbuf;
+  /** point to the user data(rtp) area inside the mbuf */
+  void* usrptr;
+  /**
+   * the rtp packet length, include both the header and payload.
+   * Filled by lib for rx, set by user before put for tx.
+   */
+  uint16_t len;
+};
+
 /**
  * The structure describing the source address(ip addr and port) info for RX.
  * Leave redundant info to zero if the session only has primary port.
@@ -170,6 +186,11 @@ enum st_event {
    * args point to struct st10_vsync_meta.
    */
   ST_EVENT_VSYNC = 0,
+  /**
+   * the dst mac resolve by arp fail on a tx session, lib will resolve it again,
+   * args point to the int error code.
+   */
+  ST_EVENT_ARP_FAIL,
   /** max value of this enum */
   ST_EVENT_MAX,
 };
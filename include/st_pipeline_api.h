@@ -35,6 +35,8 @@ typedef struct st22_encode_dev_impl* st22_encoder_dev_handle;
 typedef struct st22_decode_dev_impl* st22_decoder_dev_handle;
 /** Handle to st2110-20 convert device of lib */
 typedef struct st20_convert_dev_impl* st20_converter_dev_handle;
+/** Handle to one job of the shared plugin worker pool */
+typedef struct st_plugin_job_impl* st_plugin_job_handle;
 
 /** Handle to the st22 encode session private data */
 typedef void* st22_encode_priv;
@@ -180,6 +182,8 @@ enum st_frame_fmt {
   ST_FRAME_FMT_JPEGXS_CODESTREAM = 56,
   /** ST22 h264 cbr codestream */
   ST_FRAME_FMT_H264_CBR_CODESTREAM = 57,
+  /** ST22 h265 cbr codestream */
+  ST_FRAME_FMT_H265_CBR_CODESTREAM = 58,
   /** End of codestream format list */
   ST_FRAME_FMT_CODESTREAM_END,
   /** max value(< sizeof(uint64_t)) of this enum */
@@ -210,6 +214,8 @@ enum st_frame_fmt {
 #define ST_FMT_CAP_JPEGXS_CODESTREAM (MTL_BIT64(ST_FRAME_FMT_JPEGXS_CODESTREAM))
 /** ST format cap of ST_FRAME_FMT_H264_CBR_CODESTREAM, used in the st22_plugin caps */
 #define ST_FMT_CAP_H264_CBR_CODESTREAM (MTL_BIT64(ST_FRAME_FMT_H264_CBR_CODESTREAM))
+/** ST format cap of ST_FRAME_FMT_H265_CBR_CODESTREAM, used in the st22_plugin caps */
+#define ST_FMT_CAP_H265_CBR_CODESTREAM (MTL_BIT64(ST_FRAME_FMT_H265_CBR_CODESTREAM))
 
 /**
  * Flag bit in flags of struct st_frame.
@@ -265,6 +271,8 @@ struct st_frame {
   uint32_t flags;
   /** frame status, complete or not */
   enum st_frame_status status;
+  /** CRC32C of the transport frame payload, for ST20P_*X_FLAG_ENABLE_CRC */
+  uint32_t crc;
 
   /** priv pointer for lib, do not touch this */
   void* priv;
@@ -296,6 +304,8 @@ enum st22_codec {
   ST22_CODEC_JPEGXS = 0,
   /** h264 cbr codec */
   ST22_CODEC_H264_CBR,
+  /** h265 cbr codec */
+  ST22_CODEC_H265_CBR,
   /** max value of this enum */
   ST22_CODEC_MAX,
 };
@@ -377,6 +387,12 @@ enum st22_quality_mode {
  * If enabled, lib will pass ST_EVENT_VSYNC by the notify_event on every epoch start.
  */
 #define ST20P_TX_FLAG_ENABLE_VSYNC (MTL_BIT32(5))
+/**
+ * Flag bit in flags of struct st20p_tx_ops.
+ * If enabled, lib will pass the CRC32C of the transport frame payload by the crc of
+ * st_frame in notify_frame_done.
+ */
+#define ST20P_TX_FLAG_ENABLE_CRC (MTL_BIT32(6))
 
 /**
  * Flag bit in flags of struct st22p_rx_ops, for non MTL_PMD_DPDK_USER.
@@ -440,6 +456,12 @@ enum st22_quality_mode {
  * Always disable MIGRATE for this session.
  */
 #define ST20P_RX_FLAG_DISABLE_MIGRATE (MTL_BIT32(20))
+/**
+ * Flag bit in flags of struct st20p_rx_ops.
+ * If enabled, lib will pass the CRC32C of the transport frame payload by the crc of
+ * st_frame, only valid for the complete frame.
+ */
+#define ST20P_RX_FLAG_ENABLE_CRC (MTL_BIT32(21))
 
 /** The structure info for st plugin encode session create request. */
 struct st22_encoder_create_req {
@@ -596,6 +618,41 @@ struct st20_convert_frame_meta {
   void* priv;
 };
 
+/**
+ * The structure info for one job of the shared plugin worker pool, usually one job
+ * for each codec session. The workers are shared by all the jobs of all plugins.
+ */
+struct st_plugin_job_ops {
+  /** name */
+  const char* name;
+  /** private data to the callback function */
+  void* priv;
+  /**
+   * Process one frame of the job, ex: st22_encoder_get_frame, encode and
+   * st22_encoder_put_frame. Called from a pool worker, never run concurrently for the
+   * same job. Return 0 if one frame is done, -EBUSY if no frame is ready.
+   */
+  int (*process)(void* priv);
+};
+
+/** The structure info for the stats of the shared plugin worker pool. */
+struct st_plugin_worker_stats {
+  /** number of the worker threads */
+  uint16_t nb_workers;
+  /** number of the jobs attached */
+  uint16_t nb_jobs;
+  /** jobs waiting in the queue now */
+  uint32_t queued;
+  /** max jobs waiting in the queue since last read */
+  uint32_t queued_max;
+  /** frames processed since last read */
+  uint64_t frames;
+  /** max time(ns) a ready job waited for a worker since last read */
+  uint64_t wait_max_ns;
+  /** workers busy ratio(0-100) since last read, close to 100 means backpressure */
+  float busy_ratio;
+};
+
 /** The structure info for st tx port, used in creating session. */
 struct st_tx_port {
   /** destination IP address */
@@ -1045,6 +1102,59 @@ int st_plugin_unregister(mtl_handle mt, const char* path);
  */
 int st_get_plugins_nb(mtl_handle mt);
 
+/**
+ * Attach one job to the shared plugin worker pool, the pool is started at the first job.
+ * The worker number and the cpus are from plugin_workers and plugin_worker_cores of
+ * struct mtl_init_params.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param ops
+ *   The pointer to the structure describing the job.
+ * @return
+ *   - NULL: fail.
+ *   - Others: the handle to the job.
+ */
+st_plugin_job_handle st_plugin_job_create(mtl_handle mt, struct st_plugin_job_ops* ops);
+
+/**
+ * Detach one job from the shared plugin worker pool, wait until it is not running.
+ * The process callback is never called after it returns, the caller must not notify
+ * the job concurrently or after.
+ *
+ * @param job
+ *   The handle to the job.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code.
+ */
+int st_plugin_job_free(st_plugin_job_handle job);
+
+/**
+ * Queue one job to the shared plugin worker pool, usually called from the
+ * notify_frame_available of the codec session. Non-block.
+ *
+ * @param job
+ *   The handle to the job.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code.
+ */
+int st_plugin_job_notify(st_plugin_job_handle job);
+
+/**
+ * Get the stats of the shared plugin worker pool, the max/ratio fields are reset.
+ *
+ * @param mt
+ *   The handle to the media transport device context.
+ * @param stats
+ *   The pointer to the stats.
+ * @return
+ *   - 0: Success.
+ *   - <0: Error code.
+ */
+int st_plugin_worker_get_stats(mtl_handle mt, struct st_plugin_worker_stats* stats);
+
 /**
  * Create one tx st2110-22 pipeline session.
  *
@@ -98,23 +98,31 @@ static inline void tx_video_set_sch(struct st_tx_video_session_impl* s,
     s->st20_handle->sch = sch;
 }
 
+/*
+ * Move the session on the from_idx slot to to_sch, return the new slot. The planned
+ * session is resolved again under the lock as it may be freed since the plan snapshot.
+ */
 static int tx_video_migrate_to(struct mtl_main_impl* impl,
-                               struct st_tx_video_session_impl* s,
+                               struct st_tx_video_session_impl* expect, int from_idx,
                                struct mt_sch_impl* from_sch, struct mt_sch_impl* to_sch) {
   struct st_tx_video_sessions_mgr* to_tx_mgr = &to_sch->tx_video_mgr;
   int to_midx = to_tx_mgr->idx;
   struct st_tx_video_sessions_mgr* from_tx_mgr = &from_sch->tx_video_mgr;
   int from_midx = from_tx_mgr->idx;
-  int from_idx = s->idx;
+  struct st_tx_video_session_impl* s;
+  float cpu_busy;
 
   mt_pthread_mutex_lock(&to_sch->tx_video_mgr_mutex);
   mt_pthread_mutex_lock(&from_sch->tx_video_mgr_mutex);
-  if (!tx_video_session_get(from_tx_mgr, from_idx)) {
-    err("%s, get session(%d,%d) fail\n", __func__, from_midx, from_idx);
+  s = tx_video_session_get(from_tx_mgr, from_idx);
+  if (!s || (s != expect)) {
+    if (s) tx_video_session_put(from_tx_mgr, from_idx);
+    err("%s, session(%d,%d) changed since the plan\n", __func__, from_midx, from_idx);
     mt_pthread_mutex_unlock(&from_sch->tx_video_mgr_mutex);
     mt_pthread_mutex_unlock(&to_sch->tx_video_mgr_mutex);
     return -EIO;
   }
+  cpu_busy = tx_video_session_get_cpu_busy(s);
   int i;
   /* find one empty slot in the new sch */
   for (i = 0; i < ST_SCH_MAX_TX_VIDEO_SESSIONS; i++) {
@@ -134,69 +142,15 @@ static int tx_video_migrate_to(struct mtl_main_impl* impl,
   mt_pthread_mutex_unlock(&from_sch->tx_video_mgr_mutex);
   mt_pthread_mutex_unlock(&to_sch->tx_video_mgr_mutex);
 
-  info("%s, session(%d,%d,%f) move to (%d,%d)\n", __func__, from_midx, from_idx,
-       tx_video_session_get_cpu_busy(s), to_midx, i);
-
-  return 0;
-}
-
-static int admin_tx_video_migrate(struct mtl_main_impl* impl, bool* migrated) {
-  struct st_tx_video_session_impl* busy_s = NULL;
-  struct mt_sch_impl* from_sch = NULL;
-  int ret;
-
-  for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
-    struct mt_sch_impl* sch = mt_sch_instance(impl, sch_idx);
-    if (!mt_sch_started(sch)) continue;
-    if (!mt_sch_has_busy(sch)) continue;
-
-    /* check if any busy session in this cpu */
-    struct st_tx_video_session_impl* busy_s_in_sch = NULL;
-    struct st_tx_video_sessions_mgr* tx_mgr = &sch->tx_video_mgr;
-    for (int j = 0; j < tx_mgr->max_idx; j++) {
-      struct st_tx_video_session_impl* tx_s = tx_video_session_get(tx_mgr, j);
-      if (!tx_s) continue;
-      if (tx_video_session_is_cpu_busy(tx_s)) {
-        busy_s_in_sch = tx_s; /* last one as the busy one */
-      }
-      tx_video_session_put(tx_mgr, j);
-    }
-
-    if (busy_s_in_sch) {
-      mt_sch_set_cpu_busy(sch, true);
-      busy_s = busy_s_in_sch; /* last one as the busy one */
-      from_sch = sch;
-    }
-  }
-
-  if (!busy_s) return 0; /* no busy session */
-
-  int quota_mbs = tx_video_quota_mbs(busy_s);
-  if (quota_mbs >= from_sch->data_quota_mbs_total) {
-    return 0; /* only one video session in this sch */
-  }
-
-  dbg("%s, find one busy session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
-  struct mt_sch_impl* to_sch =
-      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL);
-  if (!to_sch) {
-    err("%s, no idle sch for session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
+  if (i >= ST_SCH_MAX_TX_VIDEO_SESSIONS) {
+    err("%s, no free slot in sch %d for session(%d,%d)\n", __func__, to_sch->idx,
+        from_midx, from_idx);
     return -EIO;
   }
+  info("%s, session(%d,%d,%f) move to (%d,%d)\n", __func__, from_midx, from_idx,
+       cpu_busy, to_midx, i);
 
-  mt_pthread_mutex_lock(&to_sch->tx_video_mgr_mutex);
-  st_tx_video_sessions_sch_init(impl, to_sch); /* ensure video sch context */
-  mt_pthread_mutex_unlock(&to_sch->tx_video_mgr_mutex);
-
-  ret = tx_video_migrate_to(impl, busy_s, from_sch, to_sch);
-  if (ret < 0) {
-    err("%s, session(%d,%d) migrate to fail\n", __func__, from_sch->idx, busy_s->idx);
-    mt_sch_put(to_sch, quota_mbs); /* put back new sch */
-    return ret;
-  }
-  mt_sch_put(from_sch, quota_mbs); /* put back old sch */
-  *migrated = true;
-  return 0;
+  return i;
 }
 
 static inline int rx_video_quota_mbs(struct st_rx_video_session_impl* s) {
@@ -214,23 +168,31 @@ static inline void rx_video_set_sch(struct st_rx_video_session_impl* s,
     s->st20_handle->sch = sch;
 }
 
+/*
+ * Move the session on the from_idx slot to to_sch, return the new slot. The planned
+ * session is resolved again under the lock as it may be freed since the plan snapshot.
+ */
 static int rx_video_migrate_to(struct mtl_main_impl* impl,
-                               struct st_rx_video_session_impl* s,
+                               struct st_rx_video_session_impl* expect, int from_idx,
                                struct mt_sch_impl* from_sch, struct mt_sch_impl* to_sch) {
   struct st_rx_video_sessions_mgr* to_rx_mgr = &to_sch->rx_video_mgr;
   int to_midx = to_rx_mgr->idx;
   struct st_rx_video_sessions_mgr* from_rx_mgr = &from_sch->rx_video_mgr;
   int from_midx = from_rx_mgr->idx;
-  int from_idx = s->idx;
+  struct st_rx_video_session_impl* s;
+  float cpu_busy;
 
   mt_pthread_mutex_lock(&to_sch->rx_video_mgr_mutex);
   mt_pthread_mutex_lock(&from_sch->rx_video_mgr_mutex);
-  if (!rx_video_session_get(from_rx_mgr, from_idx)) {
-    err("%s, get session(%d,%d) fail\n", __func__, from_midx, from_idx);
+  s = rx_video_session_get(from_rx_mgr, from_idx);
+  if (!s || (s != expect)) {
+    if (s) rx_video_session_put(from_rx_mgr, from_idx);
+    err("%s, session(%d,%d) changed since the plan\n", __func__, from_midx, from_idx);
     mt_pthread_mutex_unlock(&from_sch->rx_video_mgr_mutex);
     mt_pthread_mutex_unlock(&to_sch->rx_video_mgr_mutex);
     return -EIO;
   }
+  cpu_busy = rx_video_session_get_cpu_busy(s);
   int i;
   /* find one empty slot in the new sch */
   for (i = 0; i < ST_SCH_MAX_RX_VIDEO_SESSIONS; i++) {
@@ -250,68 +212,455 @@ static int rx_video_migrate_to(struct mtl_main_impl* impl,
   mt_pthread_mutex_unlock(&from_sch->rx_video_mgr_mutex);
   mt_pthread_mutex_unlock(&to_sch->rx_video_mgr_mutex);
 
+  if (i >= ST_SCH_MAX_RX_VIDEO_SESSIONS) {
+    err("%s, no free slot in sch %d for session(%d,%d)\n", __func__, to_sch->idx,
+        from_midx, from_idx);
+    return -EIO;
+  }
   info("%s, session(%d,%d,%f) move to (%d,%d)\n", __func__, from_midx, from_idx,
-       rx_video_session_get_cpu_busy(s), to_midx, i);
+       cpu_busy, to_midx, i);
+
+  return i;
+}
+
+static inline bool admin_socket_match(int a, int b) {
+  if ((a == SOCKET_ID_ANY) || (b == SOCKET_ID_ANY)) return true;
+  return a == b;
+}
+
+static inline float admin_item_weight(int quota_mbs, float cpu_busy) {
+  /* a session which can't feed the nic costs more than its bandwidth */
+  return (float)quota_mbs * (1.0 + cpu_busy / 100.0);
+}
 
+static int admin_plan_add(struct admin_plan* plan, struct admin_item* item) {
+  struct admin_bin* bin = &plan->bins[item->from];
+
+  if (plan->item_num >= plan->item_max) return -1;
+  item->to = item->from;
+  plan->items[plan->item_num++] = *item;
+  bin->quota_mbs += item->quota_mbs;
+  bin->load += item->weight;
+  bin->items++;
   return 0;
 }
 
-static int admin_rx_video_migrate(struct mtl_main_impl* impl, bool* migrated) {
-  struct st_rx_video_session_impl* busy_s = NULL;
-  struct mt_sch_impl* from_sch = NULL;
-  int ret;
+static inline bool admin_bin_overload(struct admin_bin* bin) {
+  if (bin->load > bin->quota_limit) return true;
+  if (bin->busy && !bin->relieved) return true;
+  return false;
+}
+
+/* the part of the sch busy ratio contributed by the item */
+static inline float admin_item_busy_ratio(struct admin_plan* plan,
+                                          struct admin_item* item) {
+  struct admin_bin* bin = &plan->bins[item->to];
+
+  if (bin->load <= 0) return 0;
+  return bin->busy_ratio * item->weight / bin->load;
+}
+
+/* best fit: the valid bin with the least room left which still holds the item */
+static int admin_best_fit(struct admin_plan* plan, struct admin_item* item,
+                                 float ratio, int exclude) {
+  int best = -1;
+  float best_room = 0;
+  int type = plan->bins[item->from].type;
+
+  for (int i = 0; i < MT_MAX_SCH_NUM; i++) {
+    struct admin_bin* bin = &plan->bins[i];
+    if (!bin->valid || (i == exclude) || (i == item->to)) continue;
+    if (bin->busy || bin->drained || (bin->type != type)) continue;
+    if (!admin_socket_match(bin->socket, item->socket)) continue;
+    if ((bin->quota_mbs + item->quota_mbs) > bin->quota_limit) continue;
+    float room = bin->quota_limit * ratio - bin->load - item->weight;
+    if (room < 0) continue;
+    if (plan->elastic &&
+        ((bin->busy_ratio + admin_item_busy_ratio(plan, item)) > plan->busy_high * ratio))
+      continue;
+    if ((best < 0) || (room < best_room)) {
+      best = i;
+      best_room = room;
+    }
+  }
+
+  return best;
+}
+
+/* a new sch in the plan, the real one is created by mt_sch_get at execution */
+static int admin_new_bin(struct admin_plan* plan, struct admin_item* item) {
+  struct admin_bin* from = &plan->bins[item->from];
+
+  if ((plan->spawn_max >= 0) && (plan->new_bins >= plan->spawn_max)) return -1;
+
+  for (int i = 0; i < MT_MAX_SCH_NUM; i++) {
+    struct admin_bin* bin = &plan->bins[i];
+    if (bin->valid || !bin->can_new) continue;
+    bin->valid = true;
+    bin->is_new = true;
+    bin->type = from->type;
+    bin->socket = item->socket; /* the new sch lcore is local to the session port */
+    bin->quota_limit = from->quota_limit;
+    plan->new_bins++;
+    return i;
+  }
+
+  return -1;
+}
+
+static void admin_plan_move(struct admin_plan* plan, struct admin_item* item,
+                                   int to) {
+  struct admin_bin* from = &plan->bins[item->to];
+  struct admin_bin* bin = &plan->bins[to];
+  float busy_ratio = admin_item_busy_ratio(plan, item);
+
+  from->busy_ratio -= busy_ratio;
+  bin->busy_ratio += busy_ratio;
+  from->quota_mbs -= item->quota_mbs;
+  from->load -= item->weight;
+  from->items--;
+  from->touched = true;
+  bin->quota_mbs += item->quota_mbs;
+  bin->load += item->weight;
+  bin->items++;
+  bin->touched = true;
+  if (item->to == item->from) plan->moves++; /* a planned item moves again is free */
+  item->to = to;
+}
+
+/* the heaviest item planned on the bin */
+static struct admin_item* admin_plan_heavy(struct admin_plan* plan, int b) {
+  struct admin_item* heavy = NULL;
+
+  for (int i = 0; i < plan->item_num; i++) {
+    struct admin_item* item = &plan->items[i];
+    if (item->to != b) continue;
+    if (!heavy || (item->weight > heavy->weight)) heavy = item;
+  }
+
+  return heavy;
+}
+
+/* relieve the overload bins, heaviest item first to get the least moves */
+static void admin_plan_relieve(struct admin_plan* plan) {
+  for (int b = 0; b < MT_MAX_SCH_NUM; b++) {
+    struct admin_bin* bin = &plan->bins[b];
+    if (!bin->valid || bin->is_new) continue;
+
+    while (admin_bin_overload(bin) && (bin->items > 1) &&
+           (plan->moves < MT_ADMIN_PLAN_MOVES_MAX)) {
+      struct admin_item* heavy = admin_plan_heavy(plan, b);
+      if (!heavy) break;
+
+      int to = admin_best_fit(plan, heavy, MT_ADMIN_TARGET_LOAD_RATIO, b);
+      if (to < 0) to = admin_new_bin(plan, heavy);
+      if (to < 0) break; /* no sch for it */
+      admin_plan_move(plan, heavy, to);
+      bin->relieved = true;
+    }
+  }
+}
+
+/* move the items which sit on a sch of another numa node */
+static void admin_plan_numa(struct admin_plan* plan) {
+  for (int i = 0; i < plan->item_num; i++) {
+    struct admin_item* item = &plan->items[i];
+    if (plan->moves >= MT_ADMIN_PLAN_MOVES_MAX) return;
+    if (admin_socket_match(plan->bins[item->to].socket, item->socket)) continue;
+    int to = admin_best_fit(plan, item, MT_ADMIN_TARGET_LOAD_RATIO, -1);
+    if (to < 0) to = admin_new_bin(plan, item);
+    if (to >= 0) admin_plan_move(plan, item, to);
+  }
+}
+
+/* drain the lightest sch into the others so its lcore can be released */
+static void admin_plan_consolidate(struct admin_plan* plan) {
+  struct admin_bin saved[MT_MAX_SCH_NUM];
+  int saved_moves;
+
+  while (plan->moves < MT_ADMIN_PLAN_MOVES_MAX) {
+    int light = -1;
+    for (int b = 0; b < MT_MAX_SCH_NUM; b++) {
+      struct admin_bin* bin = &plan->bins[b];
+      if (!bin->valid || bin->touched || bin->busy || bin->is_new) continue;
+      if (!bin->items || bin->pinned || bin->has_others) continue;
+      /* the elastic pool scale down only when it stays idle */
+      if (plan->elastic && !bin->idle) continue;
+      if ((light < 0) || (bin->load < plan->bins[light].load)) light = b;
+    }
+    if (light < 0) return;
+
+    memcpy(saved, plan->bins, sizeof(saved));
+    for (int i = 0; i < plan->item_num; i++) plan->items[i].saved_to = plan->items[i].to;
+    saved_moves = plan->moves;
+
+    bool done = true;
+    plan->bins[light].drained = true;
+    /* first fit decreasing */
+    while (plan->bins[light].items) {
+      struct admin_item* heavy = admin_plan_heavy(plan, light);
+      if (!heavy) break;
+      int to = admin_best_fit(plan, heavy, MT_ADMIN_CONSOLIDATE_LOAD_RATIO, light);
+      if ((to < 0) || plan->bins[to].is_new) {
+        done = false;
+        break;
+      }
+      admin_plan_move(plan, heavy, to);
+    }
+
+    if (!done || (plan->moves > MT_ADMIN_PLAN_MOVES_MAX) || plan->bins[light].items) {
+      /* roll back, and never try this bin again in this period */
+      memcpy(plan->bins, saved, sizeof(saved));
+      for (int i = 0; i < plan->item_num; i++)
+        plan->items[i].to = plan->items[i].saved_to;
+      plan->moves = saved_moves;
+      plan->bins[light].touched = true;
+      continue;
+    }
+  }
+}
+
+/* the socket the sch serves, its lcore is on it unless no local lcore was left */
+static int admin_sch_socket(struct mtl_main_impl* impl, struct mt_sch_impl* sch) {
+  if (sch->run_in_thread) return SOCKET_ID_ANY;
+  return sch->socket_id;
+}
+
+static int admin_plan_build(struct mtl_main_impl* impl, struct admin_plan* plan) {
+  bool tx_migrate = mt_has_tx_video_migrate(impl);
+  bool rx_migrate = mt_has_rx_video_migrate(impl);
+  struct admin_item item;
 
   for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
     struct mt_sch_impl* sch = mt_sch_instance(impl, sch_idx);
+    struct admin_bin* bin = &plan->bins[sch_idx];
+    bin->can_new = !mt_sch_is_active(sch);
     if (!mt_sch_started(sch)) continue;
-    if (!mt_sch_has_busy(sch)) continue;
 
-    /* check if any busy session in this cpu */
-    struct st_rx_video_session_impl* busy_s_in_sch = NULL;
+    bin->valid = true;
+    bin->sch = sch;
+    bin->type = sch->type;
+    bin->socket = admin_sch_socket(impl, sch);
+    bin->quota_limit = sch->data_quota_mbs_limit;
+    bin->busy_ratio = mt_sch_busy_ratio(sch);
+    if (plan->elastic) {
+      /* the elastic pool scale up, move out sessions of the overload sch */
+      if (mt_sch_elastic_overload(sch)) bin->busy = true;
+      bin->idle = mt_sch_elastic_idle(sch);
+    }
+    /* busy only if the sch can't sleep and one session can't catch up */
+    bool sch_busy = mt_sch_has_busy(sch);
+
+    memset(&item, 0, sizeof(item));
+    item.from = sch_idx;
+
+    struct st_tx_video_sessions_mgr* tx_mgr = &sch->tx_video_mgr;
+    for (int j = 0; tx_migrate && (j < tx_mgr->max_idx); j++) {
+      struct st_tx_video_session_impl* tx_s = tx_video_session_get(tx_mgr, j);
+      if (!tx_s) continue;
+      item.type = ADMIN_ITEM_TX_VIDEO;
+      item.s = tx_s;
+      item.idx = j;
+      item.quota_mbs = tx_video_quota_mbs(tx_s);
+      item.weight =
+          admin_item_weight(item.quota_mbs, tx_video_session_get_cpu_busy(tx_s));
+      item.socket =
+          mt_socket_id(impl, mt_port_logic2phy(tx_s->port_maps, MT_SESSION_PORT_P));
+      admin_plan_add(plan, &item);
+      if (sch_busy && tx_video_session_is_cpu_busy(tx_s)) bin->busy = true;
+      tx_video_session_put(tx_mgr, j);
+    }
+
     struct st_rx_video_sessions_mgr* rx_mgr = &sch->rx_video_mgr;
-    for (int j = 0; j < rx_mgr->max_idx; j++) {
+    for (int j = 0; rx_migrate && (j < rx_mgr->max_idx); j++) {
       struct st_rx_video_session_impl* rx_s = rx_video_session_get(rx_mgr, j);
       if (!rx_s) continue;
-      if (rx_video_session_can_migrate(rx_s) && rx_video_session_is_cpu_busy(rx_s)) {
-        busy_s_in_sch = rx_s; /* last one as the busy one */
+      if (rx_video_session_can_migrate(rx_s)) {
+        item.type = ADMIN_ITEM_RX_VIDEO;
+        item.s = rx_s;
+        item.idx = j;
+        item.quota_mbs = rx_video_quota_mbs(rx_s);
+        item.weight =
+            admin_item_weight(item.quota_mbs, rx_video_session_get_cpu_busy(rx_s));
+        item.socket =
+            mt_socket_id(impl, mt_port_logic2phy(rx_s->port_maps, MT_SESSION_PORT_P));
+        admin_plan_add(plan, &item);
+        if (sch_busy && rx_video_session_is_cpu_busy(rx_s)) bin->busy = true;
+      } else {
+        /* pinned, only count the capacity */
+        int quota_mbs = rx_video_quota_mbs(rx_s);
+        bin->quota_mbs += quota_mbs;
+        bin->load += quota_mbs;
+        bin->pinned++;
       }
       rx_video_session_put(rx_mgr, j);
     }
 
-    if (busy_s_in_sch) {
-      mt_sch_set_cpu_busy(sch, true);
-      busy_s = busy_s_in_sch; /* last one as the busy one */
-      from_sch = sch;
+    /* the quota of other users(audio, anc, etc) */
+    if (sch->data_quota_mbs_total > bin->quota_mbs) {
+      bin->has_others = true;
+      bin->quota_mbs = sch->data_quota_mbs_total;
     }
   }
 
-  if (!busy_s) return 0; /* no busy session */
+  return 0;
+}
+
+/* move the session between two sch, the quota on to_sch is already got */
+static int admin_session_move(struct mtl_main_impl* impl, struct admin_item* item,
+                              struct mt_sch_impl* from_sch, struct mt_sch_impl* to_sch) {
+  int ret;
+
+  if (item->type == ADMIN_ITEM_TX_VIDEO) {
+    mt_pthread_mutex_lock(&to_sch->tx_video_mgr_mutex);
+    st_tx_video_sessions_sch_init(impl, to_sch); /* ensure video sch context */
+    mt_pthread_mutex_unlock(&to_sch->tx_video_mgr_mutex);
+    ret = tx_video_migrate_to(impl, item->s, item->idx, from_sch, to_sch);
+  } else {
+    mt_pthread_mutex_lock(&to_sch->rx_video_mgr_mutex);
+    st_rx_video_sessions_sch_init(impl, to_sch); /* ensure video sch context */
+    mt_pthread_mutex_unlock(&to_sch->rx_video_mgr_mutex);
+    ret = rx_video_migrate_to(impl, item->s, item->idx, from_sch, to_sch);
+  }
+  if (ret < 0) {
+    mt_sch_put(to_sch, item->quota_mbs); /* put back new sch */
+    return ret;
+  }
+  mt_sch_put(from_sch, item->quota_mbs); /* put back old sch */
+  item->idx = ret; /* the slot on to_sch, for the rollback */
+  return 0;
+}
+
+static int admin_item_migrate(struct mtl_main_impl* impl, struct admin_plan* plan,
+                              struct admin_item* item) {
+  struct admin_bin* from = &plan->bins[item->from];
+  struct admin_bin* to = &plan->bins[item->to];
+  struct mt_sch_impl* to_sch = to->sch;
+  mt_sch_mask_t mask;
+  int ret;
 
-  int quota_mbs = rx_video_quota_mbs(busy_s);
-  if (quota_mbs >= from_sch->data_quota_mbs_total) {
-    return 0; /* only one video session in this sch */
+  if (to_sch) {
+    mask = MTL_BIT64(to_sch->idx);
+  } else {
+    /* a new bin, any free sch */
+    mask = 0;
+    for (int i = 0; i < MT_MAX_SCH_NUM; i++) {
+      if (!mt_sch_is_active(mt_sch_instance(impl, i))) mask |= MTL_BIT64(i);
+    }
   }
 
-  dbg("%s, find one busy session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
-  struct mt_sch_impl* to_sch =
-      mt_sch_get(impl, quota_mbs, from_sch->type, MT_SCH_MASK_ALL);
+  to_sch = mt_sch_get(impl, item->quota_mbs, from->type, mask, to->socket);
   if (!to_sch) {
-    err("%s, no idle sch for session(%d,%d)\n", __func__, from_sch->idx, busy_s->idx);
+    err("%s, no sch for session on sch %d\n", __func__, item->from);
     return -EIO;
   }
+  if (to->is_new) to->sch = to_sch;
 
-  mt_pthread_mutex_lock(&to_sch->rx_video_mgr_mutex);
-  st_rx_video_sessions_sch_init(impl, to_sch); /* ensure video sch context */
-  mt_pthread_mutex_unlock(&to_sch->rx_video_mgr_mutex);
+  ret = admin_session_move(impl, item, from->sch, to_sch);
+  if (ret < 0) {
+    err("%s, session migrate from sch %d fail %d\n", __func__, item->from, ret);
+    return ret;
+  }
+  return 0;
+}
+
+/* move a migrated item back to the sch it was on */
+static int admin_item_rollback(struct mtl_main_impl* impl, struct admin_plan* plan,
+                               struct admin_item* item) {
+  struct admin_bin* from = &plan->bins[item->from];
+  struct admin_bin* to = &plan->bins[item->to];
+  struct mt_sch_impl* from_sch = from->sch;
+  int ret;
 
-  ret = rx_video_migrate_to(impl, busy_s, from_sch, to_sch);
+  from_sch = mt_sch_get(impl, item->quota_mbs, from->type, MTL_BIT64(from_sch->idx),
+                        from->socket);
+  if (!from_sch) {
+    err("%s, sch %d get fail\n", __func__, item->from);
+    return -EIO;
+  }
+  ret = admin_session_move(impl, item, to->sch, from_sch);
   if (ret < 0) {
-    err("%s, session(%d,%d) migrate fail\n", __func__, from_sch->idx, busy_s->idx);
-    mt_sch_put(to_sch, quota_mbs); /* put back new sch */
+    err("%s, session back to sch %d fail %d\n", __func__, item->from, ret);
     return ret;
   }
-  mt_sch_put(from_sch, quota_mbs); /* put back old sch */
-  *migrated = true;
+  item->migrated = false;
+  return 0;
+}
+
+/*
+ * Treat the placement as bin packing: relieve the overload sch with the heaviest
+ * sessions first, fix the numa misplaced sessions, then drain the lightest sch to
+ * release lcores. All moves of one period are planned together on a snapshot, and
+ * rolled back together if one of them fails.
+ */
+static int admin_video_rebalance(struct mtl_main_impl* impl, bool* migrated) {
+  struct mt_admin* admin = mt_get_admin(impl);
+  struct mt_sch_mgr* sch_mgr = mt_sch_get_mgr(impl);
+  struct admin_plan* plan;
+  int drained = 0, done = 0, committed = 0;
+  int ret = 0;
+
+  plan = mt_zmalloc(sizeof(*plan));
+  if (!plan) return -ENOMEM;
+  plan->item_max = MT_MAX_SCH_NUM *
+                   (ST_SCH_MAX_TX_VIDEO_SESSIONS + ST_SCH_MAX_RX_VIDEO_SESSIONS);
+  plan->items = mt_zmalloc(sizeof(*plan->items) * plan->item_max);
+  if (!plan->items) {
+    mt_free(plan);
+    return -ENOMEM;
+  }
+
+  plan->spawn_max = -1;
+  if (mt_has_sch_elastic(impl)) {
+    plan->elastic = true;
+    plan->busy_high = sch_mgr->elastic.busy_high;
+    if (sch_mgr->elastic.max_lcores)
+      plan->spawn_max = RTE_MAX(
+          sch_mgr->elastic.max_lcores - rte_atomic32_read(&sch_mgr->sch_cnt), 0);
+  }
+
+  admin_plan_build(impl, plan);
+  admin_plan_relieve(plan);
+  for (int b = 0; b < MT_MAX_SCH_NUM; b++) {
+    struct admin_bin* bin = &plan->bins[b];
+    if (bin->busy && bin->sch) mt_sch_set_cpu_busy(bin->sch, true);
+  }
+  admin_plan_numa(plan);
+  admin_plan_consolidate(plan);
+
+  if (plan->moves) {
+    for (int b = 0; b < MT_MAX_SCH_NUM; b++)
+      if (plan->bins[b].drained) drained++;
+    info("%s, %d sessions, %d moves, %d new sch, %d sch to release\n", __func__,
+         plan->item_num, plan->moves, plan->new_bins, drained);
+  }
+
+  for (int i = 0; i < plan->item_num; i++) {
+    struct admin_item* item = &plan->items[i];
+    if (item->to == item->from) continue;
+    ret = admin_item_migrate(impl, plan, item);
+    if (ret < 0) break;
+    item->migrated = true;
+    done++;
+  }
+
+  if (done && (ret < 0)) {
+    /* a half done plan may leave a drained sch with sessions, move all back */
+    warn("%s, plan fail after %d moves, roll back\n", __func__, done);
+    for (int i = plan->item_num - 1; i >= 0; i--) {
+      struct admin_item* item = &plan->items[i];
+      if (!item->migrated) continue;
+      admin_item_rollback(impl, plan, item);
+    }
+  }
+  /* the rolled back ones are not counted, but the moves still disturb the busy stat */
+  for (int i = 0; i < plan->item_num; i++)
+    if (plan->items[i].migrated) committed++;
+  if (done) *migrated = true;
+  admin->stat_migrate += committed;
+
+  mt_free(plan->items);
+  mt_free(plan);
   return 0;
 }
 
@@ -334,17 +683,20 @@ static int admin_func(struct mtl_main_impl* impl) {
   dbg("%s, start\n", __func__);
 
   admin_cal_cpu_busy(impl);
+  mt_sch_elastic_update(impl);
 
   bool migrated = false;
-  /* only one migrate(both tx and rx) for this period */
-  if (mt_has_tx_video_migrate(impl)) {
-    admin_tx_video_migrate(impl, &migrated);
-  }
-  if (!migrated && mt_has_rx_video_migrate(impl)) {
-    admin_rx_video_migrate(impl, &migrated);
+  if (admin->cooldown) {
+    /* wait the cpu busy of the moved sessions settle down */
+    admin->cooldown--;
+  } else if (mt_has_tx_video_migrate(impl) || mt_has_rx_video_migrate(impl)) {
+    admin_video_rebalance(impl, &migrated);
   }
 
-  if (migrated) admin_clear_cpu_busy(impl);
+  if (migrated) {
+    admin_clear_cpu_busy(impl);
+    admin->cooldown = MT_ADMIN_COOLDOWN_PERIODS;
+  }
 
   rte_eal_alarm_set(admin->period_us, admin_alarm_handler, impl);
 
@@ -394,6 +746,9 @@ int mt_admin_uinit(struct mtl_main_impl* impl) {
   }
   rte_eal_alarm_cancel(admin_alarm_handler, impl);
 
+  if (admin->stat_migrate)
+    info("%s, %u sessions migrated\n", __func__, admin->stat_migrate);
+
   mt_pthread_mutex_destroy(&admin->admin_wake_mutex);
   mt_pthread_cond_destroy(&admin->admin_wake_cond);
   return 0;
@@ -7,6 +7,69 @@
 
 #include "mt_main.h"
 
+/* periods to skip after a migration */
+#define MT_ADMIN_COOLDOWN_PERIODS (2)
+/* max session moves in one admin period */
+#define MT_ADMIN_PLAN_MOVES_MAX (8)
+/* the load(quota scaled by cpu busy) target of a sch which receives sessions */
+#define MT_ADMIN_TARGET_LOAD_RATIO (0.9)
+/* lower target for consolidation to leave headroom and avoid ping-pong */
+#define MT_ADMIN_CONSOLIDATE_LOAD_RATIO (0.7)
+
+enum admin_item_type {
+  ADMIN_ITEM_TX_VIDEO = 0,
+  ADMIN_ITEM_RX_VIDEO,
+};
+
+/* one video session in the placement plan */
+struct admin_item {
+  enum admin_item_type type;
+  void* s;       /* only to check the slot still holds it, never deref */
+  int idx;       /* the slot in the video mgr of the sch now */
+  int from;      /* sch idx now */
+  int to;        /* planned bin, same to from if not move */
+  int saved_to;  /* the planned bin before a consolidate try */
+  bool migrated; /* moved by the plan execution */
+  int quota_mbs; /* the hard capacity in the sch */
+  float weight;  /* quota scaled by the measured cpu busy, the soft capacity */
+  int socket;    /* numa of nic and frame buffers */
+};
+
+/* one sch(or a new sch to create) in the plan */
+struct admin_bin {
+  bool valid;
+  bool is_new;  /* a new sch, created when the first item moves in */
+  bool can_new; /* the sch is not active, can be a new bin */
+  enum mt_sch_type type;
+  int socket;
+  int quota_mbs;
+  int quota_limit;
+  float load;
+  float busy_ratio; /* measured sch busy ratio, moved with the items in the plan */
+  int items;
+  int pinned;      /* sessions can't migrate */
+  bool has_others; /* other users(audio, anc, etc) keep the sch */
+  bool idle;       /* the elastic pool reports it stays idle */
+  bool busy;       /* the sch reports cpu busy */
+  bool relieved;   /* one item moved out for the busy sch */
+  bool drained;    /* all items moved out, the lcore will be released */
+  bool touched;    /* source or target of a move */
+  struct mt_sch_impl* sch; /* NULL for a new bin */
+};
+
+struct admin_plan {
+  struct admin_item* items;
+  int item_num;
+  int item_max;
+  struct admin_bin bins[MT_MAX_SCH_NUM];
+  int moves;
+  int new_bins;
+  int spawn_max; /* the new sch allowed, negative for no limit */
+  /* elastic pool, the busy ratio is also checked */
+  bool elastic;
+  float busy_high;
+};
+
 int mt_admin_init(struct mtl_main_impl* impl);
 int mt_admin_uinit(struct mtl_main_impl* impl);
 
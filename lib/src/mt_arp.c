@@ -4,6 +4,8 @@
 
 #include "mt_arp.h"
 
+#include <rte_jhash.h>
+
 #include "mt_dev.h"
 //#define DEBUG
 #include "mt_log.h"
@@ -13,12 +15,208 @@ static inline struct mt_arp_impl* get_arp(struct mtl_main_impl* impl,
   return &impl->arp[port];
 }
 
-static void arp_reset(struct mt_arp_impl* arp) {
-  for (int i = 0; i > MT_ARP_ENTRY_MAX; i++) {
-    rte_atomic32_set(&arp->mac_ready[i], 0);
-    arp->ip[i] = 0;
-    memset(&arp->ea[i], 0, sizeof(arp->ea[i]));
+static inline struct mt_arp_entry* arp_bucket(struct mt_arp_impl* arp, uint32_t ip) {
+  uint32_t b = rte_jhash_1word(ip, 0) & (MT_ARP_BUCKET_NUM - 1);
+  return &arp->entries[b * MT_ARP_BUCKET_WAYS];
+}
+
+static inline struct mt_arp_entry* arp_overflow(struct mt_arp_impl* arp) {
+  return &arp->entries[MT_ARP_ENTRY_MAX];
+}
+
+static inline bool arp_is_overflow(struct mt_arp_impl* arp, struct mt_arp_entry* entry) {
+  return entry >= arp_overflow(arp);
+}
+
+static struct mt_arp_entry* arp_lookup(struct mt_arp_impl* arp, uint32_t ip) {
+  struct mt_arp_entry* bucket = arp_bucket(arp, ip);
+  struct mt_arp_entry* overflow = arp_overflow(arp);
+
+  for (int i = 0; i < MT_ARP_BUCKET_WAYS; i++) {
+    if ((bucket[i].state != MT_ARP_STATE_FREE) && (bucket[i].ip == ip)) return &bucket[i];
+  }
+  if (!arp->overflow_cnt) return NULL;
+  for (int i = 0; i < MT_ARP_OVERFLOW_NUM; i++) {
+    if ((overflow[i].state != MT_ARP_STATE_FREE) && (overflow[i].ip == ip))
+      return &overflow[i];
+  }
+
+  return NULL;
+}
+
+/*
+ * find a free way in the bucket, or evict the least recently used ready one. If all
+ * ways are pending, take a free overflow entry, the pending ones are never evicted.
+ */
+static struct mt_arp_entry* arp_alloc(struct mt_arp_impl* arp, uint32_t ip) {
+  struct mt_arp_entry* bucket = arp_bucket(arp, ip);
+  struct mt_arp_entry* overflow = arp_overflow(arp);
+  struct mt_arp_entry* victim = NULL;
+
+  for (int i = 0; i < MT_ARP_BUCKET_WAYS; i++) {
+    if (bucket[i].state == MT_ARP_STATE_FREE) {
+      arp->entry_cnt++;
+      return &bucket[i];
+    }
+    if (bucket[i].state != MT_ARP_STATE_READY) continue;
+    if (!victim || (bucket[i].access_ns < victim->access_ns)) victim = &bucket[i];
+  }
+
+  if (victim) {
+    uint8_t* addr = (uint8_t*)&victim->ip;
+    dbg("%s(%d), evict %d.%d.%d.%d\n", __func__, arp->port, addr[0], addr[1], addr[2],
+        addr[3]);
+    arp->stat_evict++;
+    return victim;
+  }
+
+  for (int i = 0; i < MT_ARP_OVERFLOW_NUM; i++) {
+    if (overflow[i].state != MT_ARP_STATE_FREE) continue;
+    arp->entry_cnt++;
+    arp->overflow_cnt++;
+    arp->stat_overflow++;
+    return &overflow[i];
+  }
+
+  return NULL;
+}
+
+static void arp_free(struct mt_arp_impl* arp, struct mt_arp_entry* entry) {
+  entry->state = MT_ARP_STATE_FREE;
+  entry->ip = 0;
+  arp->entry_cnt--;
+  if (arp_is_overflow(arp, entry)) arp->overflow_cnt--;
+}
+
+/* call and remove all the waiters of this ip */
+static void arp_wake_waiters(struct mt_arp_impl* arp, uint32_t ip,
+                             struct rte_ether_addr* ea, int result) {
+  struct mt_arp_waiter *waiter, *tmp_waiter;
+
+  for (waiter = MT_TAILQ_FIRST(&arp->waiters); waiter != NULL; waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (waiter->ip != ip) continue;
+    MT_TAILQ_REMOVE(&arp->waiters, waiter, next);
+    waiter->cb(waiter->priv, arp->port, ip, ea, result);
+    mt_free(waiter);
+  }
+}
+
+static struct rte_mbuf* arp_build_request(struct mtl_main_impl* impl, enum mtl_port port,
+                                          uint32_t ip) {
+  uint16_t port_id = mt_port_id(impl, port);
+  struct rte_mbuf* req_pkt = rte_pktmbuf_alloc(mt_get_tx_mempool(impl, port));
+  if (!req_pkt) return NULL;
+
+  req_pkt->pkt_len = req_pkt->data_len =
+      sizeof(struct rte_ether_hdr) + sizeof(struct rte_arp_hdr);
+
+  struct rte_ether_hdr* eth = rte_pktmbuf_mtod(req_pkt, struct rte_ether_hdr*);
+  rte_eth_macaddr_get(port_id, mt_eth_s_addr(eth));
+  memset(mt_eth_d_addr(eth), 0xFF, RTE_ETHER_ADDR_LEN);
+  eth->ether_type = htons(RTE_ETHER_TYPE_ARP);  // ARP_PROTOCOL
+  struct rte_arp_hdr* arp =
+      rte_pktmbuf_mtod_offset(req_pkt, struct rte_arp_hdr*, sizeof(struct rte_ether_hdr));
+  arp->arp_hardware = htons(RTE_ARP_HRD_ETHER);
+  arp->arp_protocol = htons(RTE_ETHER_TYPE_IPV4);  // IP protocol
+  arp->arp_hlen = RTE_ETHER_ADDR_LEN;              // size of MAC
+  arp->arp_plen = 4;                               // size of fo IP
+  arp->arp_opcode = htons(RTE_ARP_OP_REQUEST);
+  arp->arp_data.arp_tip = ip;
+  arp->arp_data.arp_sip = *(uint32_t*)mt_sip_addr(impl, port);
+  rte_eth_macaddr_get(port_id, &arp->arp_data.arp_sha);
+  memset(&arp->arp_data.arp_tha, 0, RTE_ETHER_ADDR_LEN);
+
+  return req_pkt;
+}
+
+static void arp_send_requests(struct mt_arp_impl* arp, struct rte_mbuf** pkts,
+                              uint16_t nb_pkts) {
+  if (!nb_pkts) return;
+
+  uint16_t tx = mt_dev_tx_sys_queue_burst(arp->parnet, arp->port, pkts, nb_pkts);
+  if (tx < nb_pkts) {
+    err("%s(%d), tx fail, only %u of %u sent\n", __func__, arp->port, tx, nb_pkts);
+    rte_pktmbuf_free_bulk(&pkts[tx], nb_pkts - tx);
   }
+  arp->stat_request += tx;
+}
+
+/* retry the pending entries, refresh or age the ready ones, expire the waiters */
+static void arp_timer_handler(void* param) {
+  struct mt_arp_impl* arp = param;
+  struct mtl_main_impl* impl = arp->parnet;
+  enum mtl_port port = arp->port;
+  uint64_t now = mt_get_monotonic_time();
+  uint64_t retry_ns = (uint64_t)MT_ARP_RETRY_INTERVAL_MS * NS_PER_MS;
+  uint64_t aging_ns = (uint64_t)MT_ARP_AGING_S * NS_PER_S;
+  struct rte_mbuf* pkts[MT_ARP_BURST_SIZE];
+  uint16_t nb_pkts = 0;
+  struct mt_arp_entry* entry;
+  struct mt_arp_waiter *waiter, *tmp_waiter;
+
+  mt_pthread_mutex_lock(&arp->mutex);
+
+  for (waiter = MT_TAILQ_FIRST(&arp->waiters); waiter != NULL; waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (!waiter->expire_ns || (now < waiter->expire_ns)) {
+      /* keep the entry alive while someone is waiting it */
+      entry = arp_lookup(arp, waiter->ip);
+      if (entry) entry->access_ns = now;
+      continue;
+    }
+    MT_TAILQ_REMOVE(&arp->waiters, waiter, next);
+    waiter->cb(waiter->priv, port, waiter->ip, NULL, -ETIMEDOUT);
+    mt_free(waiter);
+  }
+
+  for (int e = 0; e < MT_ARP_ENTRY_MAX + MT_ARP_OVERFLOW_NUM; e++) {
+    entry = &arp->entries[e];
+    if (entry->state == MT_ARP_STATE_FREE) continue;
+
+    if (entry->state == MT_ARP_STATE_PENDING) {
+      /* nobody wait it anymore */
+      if ((now - entry->access_ns) >= aging_ns) {
+        arp_free(arp, entry);
+        continue;
+      }
+    } else {
+      if ((now - entry->update_ns) < aging_ns) continue;
+      /* aged, refresh only if someone looked it up since the last reply */
+      if ((entry->access_ns < entry->update_ns) ||
+          ((now - entry->update_ns) >= (aging_ns * 2))) {
+        arp_free(arp, entry);
+        continue;
+      }
+    }
+    if (entry->request_ns && ((now - entry->request_ns) < retry_ns)) continue;
+
+    uint8_t* addr = (uint8_t*)&entry->ip;
+    if ((entry->state == MT_ARP_STATE_PENDING) && entry->retry &&
+        (0 == (entry->retry % 10)))
+      info("%s(%d), waiting arp from %d.%d.%d.%d\n", __func__, port, addr[0], addr[1],
+           addr[2], addr[3]);
+    pkts[nb_pkts] = arp_build_request(impl, port, entry->ip);
+    if (!pkts[nb_pkts]) {
+      err("%s(%d), req_pkt alloc fail\n", __func__, port);
+      continue;
+    }
+    nb_pkts++;
+    entry->request_ns = now;
+    entry->retry++;
+    if (nb_pkts >= MT_ARP_BURST_SIZE) {
+      arp_send_requests(arp, pkts, nb_pkts);
+      nb_pkts = 0;
+    }
+  }
+  arp_send_requests(arp, pkts, nb_pkts);
+
+  if (arp->entry_cnt > 0)
+    rte_eal_alarm_set(MT_ARP_TIMER_US, arp_timer_handler, arp);
+  else
+    arp->timer_active = false;
+
+  mt_pthread_mutex_unlock(&arp->mutex);
 }
 
 static bool arp_is_valid_hdr(struct rte_arp_hdr* hdr) {
@@ -97,19 +295,21 @@ static int arp_receive_reply(struct mtl_main_impl* impl, struct rte_arp_hdr* rep
 
   /* save to arp table */
   mt_pthread_mutex_lock(&arp_impl->mutex);
-  int i;
-  for (i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    if (arp_impl->ip[i] == reply->arp_data.arp_sip) break;
-  }
-  if (i >= MT_ARP_ENTRY_MAX) {
+  struct mt_arp_entry* entry = arp_lookup(arp_impl, reply->arp_data.arp_sip);
+  if (!entry) {
     err_once("%s(%d), not our arp request, from %d.%d.%d.%d\n", __func__, port, ip[0],
              ip[1], ip[2], ip[3]);
     mt_pthread_mutex_unlock(&arp_impl->mutex);
     return -EINVAL;
   }
-  memcpy(arp_impl->ea[i].addr_bytes, reply->arp_data.arp_sha.addr_bytes,
-         RTE_ETHER_ADDR_LEN);
-  rte_atomic32_set(&arp_impl->mac_ready[i], 1);
+  rte_ether_addr_copy(&reply->arp_data.arp_sha, &entry->ea);
+  entry->update_ns = mt_get_monotonic_time();
+  entry->request_ns = 0;
+  entry->retry = 0;
+  if (entry->state != MT_ARP_STATE_READY) {
+    entry->state = MT_ARP_STATE_READY;
+    arp_wake_waiters(arp_impl, entry->ip, &entry->ea, 0);
+  }
   mt_pthread_mutex_unlock(&arp_impl->mutex);
 
   return 0;
@@ -132,105 +332,180 @@ int mt_arp_parse(struct mtl_main_impl* impl, struct rte_arp_hdr* hdr,
   return 0;
 }
 
-int mt_arp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
-                       enum mtl_port port, uint32_t ip, int timeout_ms) {
+int mt_arp_cni_get_mac_async(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                             enum mtl_port port, uint32_t ip, int timeout_ms,
+                             mt_arp_cb_t cb, void* priv) {
   struct mt_arp_impl* arp_impl = get_arp(impl, port);
-  uint16_t port_id = mt_port_id(impl, port);
-  uint16_t tx;
-  int retry = 0;
-  uint8_t* addr = (uint8_t*)&ip;
-  int max_retry = 0;
-  int sleep_interval_ms = 500;
-
-  if (timeout_ms) max_retry = (timeout_ms / sleep_interval_ms) + 1;
+  uint64_t now = mt_get_monotonic_time();
+  struct mt_arp_entry* entry;
 
   mt_pthread_mutex_lock(&arp_impl->mutex);
-  int i;
-  for (i = 0; i < MT_ARP_ENTRY_MAX; i++) {
-    if (arp_impl->ip[i] == ip) { /* arp request sent already */
+
+  entry = arp_lookup(arp_impl, ip);
+  if (entry && (entry->state == MT_ARP_STATE_READY)) {
+    entry->access_ns = now;
+    rte_ether_addr_copy(&entry->ea, ea);
+    mt_pthread_mutex_unlock(&arp_impl->mutex);
+    return 0;
+  }
+
+  if (!entry) {
+    entry = arp_alloc(arp_impl, ip);
+    if (!entry) {
+      err("%s(%d), no free entry, all ways and overflow busy\n", __func__, port);
       mt_pthread_mutex_unlock(&arp_impl->mutex);
-      /* wait the result */
-      while (!rte_atomic32_read(&arp_impl->mac_ready[i])) {
-        if (mt_aborted(impl)) {
-          err("%s(%d), cache fail as user aborted\n", __func__, port);
-          return -EIO;
-        }
-        if ((max_retry > 0) && (retry > max_retry)) {
-          err("%s(%d), cache fail as timeout to %d ms\n", __func__, port, timeout_ms);
-          return -EIO;
-        }
-        mt_sleep_ms(sleep_interval_ms);
-        retry++;
-        if (0 == (retry % 10))
-          info("%s(%d), cache waiting arp from %d.%d.%d.%d\n", __func__, port, addr[0],
-               addr[1], addr[2], addr[3]);
-      }
-      /* ready now, copy the mac addr arp result */
-      memcpy(ea->addr_bytes, arp_impl->ea[i].addr_bytes, RTE_ETHER_ADDR_LEN);
-      return 0;
+      return -EBUSY;
     }
-    /* find a null slot */
-    if (arp_impl->ip[i] == 0) break;
+    entry->ip = ip;
+    entry->state = MT_ARP_STATE_PENDING;
+    entry->request_ns = 0; /* the timer will send it in next batch */
+    entry->retry = 0;
   }
-  if (i >= MT_ARP_ENTRY_MAX) {
-    warn("%s(%d), reset arp\n", __func__, port);
-    /* arp table full, flush it */
-    arp_reset(arp_impl);
-    i = 0;
+  entry->access_ns = now;
+
+  struct mt_arp_waiter* waiter = mt_zmalloc(sizeof(*waiter));
+  if (!waiter) {
+    err("%s(%d), waiter malloc fail\n", __func__, port);
+    mt_pthread_mutex_unlock(&arp_impl->mutex);
+    return -ENOMEM;
   }
-  arp_impl->ip[i] = ip;
-  rte_atomic32_set(&arp_impl->mac_ready[i], 0);
+  waiter->ip = ip;
+  waiter->cb = cb;
+  waiter->priv = priv;
+  if (timeout_ms) waiter->expire_ns = now + (uint64_t)timeout_ms * NS_PER_MS;
+  MT_TAILQ_INSERT_TAIL(&arp_impl->waiters, waiter, next);
+
+  if (!arp_impl->timer_active) {
+    rte_eal_alarm_set(MT_ARP_TIMER_US, arp_timer_handler, arp_impl);
+    arp_impl->timer_active = true;
+  }
+
   mt_pthread_mutex_unlock(&arp_impl->mutex);
+  return -EINPROGRESS;
+}
 
-  struct rte_mbuf* req_pkt = rte_pktmbuf_alloc(mt_get_tx_mempool(impl, port));
-  if (!req_pkt) return -ENOMEM;
+int mt_arp_cni_cancel(struct mtl_main_impl* impl, enum mtl_port port, void* priv) {
+  struct mt_arp_impl* arp_impl = get_arp(impl, port);
+  struct mt_arp_waiter *waiter, *tmp_waiter;
 
-  req_pkt->pkt_len = req_pkt->data_len =
-      sizeof(struct rte_ether_hdr) + sizeof(struct rte_arp_hdr);
+  mt_pthread_mutex_lock(&arp_impl->mutex);
+  for (waiter = MT_TAILQ_FIRST(&arp_impl->waiters); waiter != NULL;
+       waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (waiter->priv != priv) continue;
+    MT_TAILQ_REMOVE(&arp_impl->waiters, waiter, next);
+    mt_free(waiter);
+  }
+  mt_pthread_mutex_unlock(&arp_impl->mutex);
 
-  struct rte_ether_hdr* eth = rte_pktmbuf_mtod(req_pkt, struct rte_ether_hdr*);
-  rte_eth_macaddr_get(port_id, mt_eth_s_addr(eth));
-  memset(mt_eth_d_addr(eth), 0xFF, RTE_ETHER_ADDR_LEN);
-  eth->ether_type = htons(RTE_ETHER_TYPE_ARP);  // ARP_PROTOCOL
-  struct rte_arp_hdr* arp =
-      rte_pktmbuf_mtod_offset(req_pkt, struct rte_arp_hdr*, sizeof(struct rte_ether_hdr));
-  arp->arp_hardware = htons(RTE_ARP_HRD_ETHER);
-  arp->arp_protocol = htons(RTE_ETHER_TYPE_IPV4);  // IP protocol
-  arp->arp_hlen = RTE_ETHER_ADDR_LEN;              // size of MAC
-  arp->arp_plen = 4;                               // size of fo IP
-  arp->arp_opcode = htons(RTE_ARP_OP_REQUEST);
-  arp->arp_data.arp_tip = ip;
-  arp->arp_data.arp_sip = *(uint32_t*)mt_sip_addr(impl, port);
-  rte_eth_macaddr_get(port_id, &arp->arp_data.arp_sha);
-  memset(&arp->arp_data.arp_tha, 0, RTE_ETHER_ADDR_LEN);
+  return 0;
+}
 
-  /* send arp request packet */
-  while (rte_atomic32_read(&arp_impl->mac_ready[i]) == 0) {
+int mt_arp_dump(struct mtl_main_impl* impl, enum mtl_port port, uint32_t* ips,
+                struct rte_ether_addr* eas, int max) {
+  struct mt_arp_impl* arp_impl = get_arp(impl, port);
+  struct mt_arp_entry* entry;
+  int cnt = 0;
+
+  mt_pthread_mutex_lock(&arp_impl->mutex);
+  for (int e = 0; e < MT_ARP_ENTRY_MAX + MT_ARP_OVERFLOW_NUM; e++) {
+    entry = &arp_impl->entries[e];
+    if (entry->state != MT_ARP_STATE_READY) continue;
+    if (cnt >= max) break;
+    ips[cnt] = entry->ip;
+    rte_ether_addr_copy(&entry->ea, &eas[cnt]);
+    cnt++;
+  }
+
+  mt_pthread_mutex_unlock(&arp_impl->mutex);
+  return cnt;
+}
+
+int mt_arp_restore(struct mtl_main_impl* impl, enum mtl_port port, uint32_t ip,
+                   struct rte_ether_addr* ea) {
+  struct mt_arp_impl* arp_impl = get_arp(impl, port);
+  uint64_t now = mt_get_monotonic_time();
+  uint64_t aging_ns = (uint64_t)MT_ARP_AGING_S * NS_PER_S;
+  struct mt_arp_entry* entry;
+
+  mt_pthread_mutex_lock(&arp_impl->mutex);
+
+  if (arp_lookup(arp_impl, ip)) {
+    mt_pthread_mutex_unlock(&arp_impl->mutex);
+    return 0;
+  }
+  entry = arp_alloc(arp_impl, ip);
+  if (!entry) {
+    mt_pthread_mutex_unlock(&arp_impl->mutex);
+    return -EBUSY;
+  }
+  entry->ip = ip;
+  entry->state = MT_ARP_STATE_READY;
+  rte_ether_addr_copy(ea, &entry->ea);
+  /* age it early, the timer refreshes it by a request as it's accessed after update */
+  if (now > aging_ns)
+    entry->update_ns = now - aging_ns + (uint64_t)MT_ARP_RESTORE_VERIFY_S * NS_PER_S;
+  else
+    entry->update_ns = 0;
+  entry->access_ns = now;
+  entry->request_ns = 0;
+  entry->retry = 0;
+
+  if (!arp_impl->timer_active) {
+    rte_eal_alarm_set(MT_ARP_TIMER_US, arp_timer_handler, arp_impl);
+    arp_impl->timer_active = true;
+  }
+
+  mt_pthread_mutex_unlock(&arp_impl->mutex);
+  return 0;
+}
+
+struct arp_sync_ctx {
+  rte_atomic32_t done;
+  int result;
+  struct rte_ether_addr ea;
+};
+
+static void arp_sync_done(void* priv, enum mtl_port port, uint32_t ip,
+                          struct rte_ether_addr* ea, int result) {
+  struct arp_sync_ctx* ctx = priv;
+
+  ctx->result = result;
+  if (ea) rte_ether_addr_copy(ea, &ctx->ea);
+  rte_atomic32_set(&ctx->done, 1);
+}
+
+int mt_arp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                       enum mtl_port port, uint32_t ip, int timeout_ms) {
+  uint8_t* addr = (uint8_t*)&ip;
+  struct arp_sync_ctx ctx;
+  int ret;
+  int retry = 0;
+
+  memset(&ctx, 0, sizeof(ctx));
+  rte_atomic32_set(&ctx.done, 0);
+  ret = mt_arp_cni_get_mac_async(impl, ea, port, ip, timeout_ms, arp_sync_done, &ctx);
+  if (ret != -EINPROGRESS) return ret;
+
+  /* the timer thread sends the request, wait the reply */
+  while (!rte_atomic32_read(&ctx.done)) {
     if (mt_aborted(impl)) {
+      mt_arp_cni_cancel(impl, port, &ctx);
       err("%s(%d), fail as user aborted\n", __func__, port);
       return -EIO;
     }
-    if ((max_retry > 0) && (retry > max_retry)) {
-      err("%s(%d), fail as timeout to %d ms\n", __func__, port, timeout_ms);
-      return -EIO;
-    }
-
-    rte_mbuf_refcnt_update(req_pkt, 1);
-    tx = mt_dev_tx_sys_queue_burst(impl, port, &req_pkt, 1);
-    if (tx < 1) {
-      err("%s(%d), tx fail\n", __func__, port);
-      rte_mbuf_refcnt_update(req_pkt, -1);
-    }
-
-    mt_sleep_ms(sleep_interval_ms);
+    mt_sleep_ms(MT_ARP_SYNC_POLL_MS);
     retry++;
-    if (0 == (retry % 10))
+    if (0 == (retry % (5000 / MT_ARP_SYNC_POLL_MS)))
       info("%s(%d), waiting arp from %d.%d.%d.%d\n", __func__, port, addr[0], addr[1],
            addr[2], addr[3]);
   }
-  memcpy(ea->addr_bytes, arp_impl->ea[i].addr_bytes, RTE_ETHER_ADDR_LEN);
-  rte_pktmbuf_free(req_pkt);
 
+  if (ctx.result < 0) {
+    err("%s(%d), fail %d, timeout %d ms\n", __func__, port, ctx.result, timeout_ms);
+    return -EIO;
+  }
+  rte_ether_addr_copy(&ctx.ea, ea);
   return 0;
 }
 
@@ -238,16 +513,32 @@ int mt_arp_init(struct mtl_main_impl* impl) {
   for (int port = 0; port < MTL_PORT_MAX; ++port) {
     struct mt_arp_impl* arp = get_arp(impl, port);
 
+    arp->parnet = impl;
+    arp->port = port;
     mt_pthread_mutex_init(&arp->mutex, NULL);
+    MT_TAILQ_INIT(&arp->waiters);
   }
 
   return 0;
 }
 
 int mt_arp_uinit(struct mtl_main_impl* impl) {
+  struct mt_arp_waiter* waiter;
+
   for (int port = 0; port < MTL_PORT_MAX; ++port) {
     struct mt_arp_impl* arp = get_arp(impl, port);
 
+    rte_eal_alarm_cancel(arp_timer_handler, arp);
+    arp->timer_active = false;
+
+    while ((waiter = MT_TAILQ_FIRST(&arp->waiters))) {
+      MT_TAILQ_REMOVE(&arp->waiters, waiter, next);
+      mt_free(waiter);
+    }
+    if (arp->stat_request)
+      info("%s(%d), entries %d, requests %u, evicts %u, overflow %u\n", __func__, port,
+           arp->entry_cnt, arp->stat_request, arp->stat_evict, arp->stat_overflow);
+
     mt_pthread_mutex_destroy(&arp->mutex);
   }
 
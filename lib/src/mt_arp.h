@@ -7,11 +7,42 @@
 
 #include "mt_main.h"
 
+/* the timer period to batch the requests and handle the aging */
+#define MT_ARP_TIMER_US (10 * 1000)
+#define MT_ARP_RETRY_INTERVAL_MS (500)
+/* the tx sessions give up an async resolve after 10 retries, then report and retry */
+#define MT_ARP_ASYNC_TIMEOUT_MS (MT_ARP_RETRY_INTERVAL_MS * 10)
+/* max requests in one tx burst */
+#define MT_ARP_BURST_SIZE (32)
+/* ready entry refreshed(if used) or evicted after this time */
+#define MT_ARP_AGING_S (300)
+/* poll interval for the blocking mt_arp_cni_get_mac */
+#define MT_ARP_SYNC_POLL_MS (1)
+/* a restored entry is usable at once and revalidated after this time */
+#define MT_ARP_RESTORE_VERIFY_S (5)
+
 int mt_arp_parse(struct mtl_main_impl* impl, struct rte_arp_hdr* hdr, enum mtl_port port);
 
 int mt_arp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
                        enum mtl_port port, uint32_t ip, int timeout_ms);
 
+/*
+ * Non-blocking resolve, return 0 with ea filled if it's in the cache already, or
+ * -EINPROGRESS and cb will be called once the reply arrives or timeout.
+ */
+int mt_arp_cni_get_mac_async(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                             enum mtl_port port, uint32_t ip, int timeout_ms,
+                             mt_arp_cb_t cb, void* priv);
+/* remove all the pending callbacks of priv */
+int mt_arp_cni_cancel(struct mtl_main_impl* impl, enum mtl_port port, void* priv);
+
+/* copy at most max ready entries out, return the count, for the warm restart state */
+int mt_arp_dump(struct mtl_main_impl* impl, enum mtl_port port, uint32_t* ips,
+                struct rte_ether_addr* eas, int max);
+/* add a ready entry saved by the previous process, no-op if the ip is known already */
+int mt_arp_restore(struct mtl_main_impl* impl, enum mtl_port port, uint32_t ip,
+                   struct rte_ether_addr* ea);
+
 int mt_arp_init(struct mtl_main_impl* impl);
 int mt_arp_uinit(struct mtl_main_impl* impl);
 
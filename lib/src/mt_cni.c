@@ -9,6 +9,7 @@
 #include "mt_kni.h"
 // #define DEBUG
 #include "mt_log.h"
+#include "mt_ndp.h"
 #include "mt_ptp.h"
 #include "mt_sch.h"
 #include "mt_tap.h"
@@ -24,6 +25,7 @@ static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
   struct mt_ptp_header* ptp_hdr;
   struct rte_arp_hdr* arp_hdr;
   struct mt_ptp_ipv4_udp* ipv4_hdr;
+  struct rte_ipv6_hdr* ipv6_hdr;
   size_t hdr_offset = sizeof(struct rte_ether_hdr);
 
   // mt_mbuf_dump(port, 0, "cni_rx", m);
@@ -57,6 +59,13 @@ static int cni_rx_handle(struct mtl_main_impl* impl, struct rte_mbuf* m,
         mt_ptp_parse(ptp, ptp_hdr, vlan, MT_PTP_L4, m->timesync, ipv4_hdr);
       }
       break;
+    case RTE_ETHER_TYPE_IPV6:
+      ipv6_hdr = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr*, hdr_offset);
+      hdr_offset += sizeof(*ipv6_hdr);
+      /* the payload is parsed in place, drop the truncated one */
+      if (m->data_len < (hdr_offset + ntohs(ipv6_hdr->payload_len))) break;
+      if (ipv6_hdr->proto == IPPROTO_ICMPV6) mt_ndp_parse(impl, eth_hdr, ipv6_hdr, port);
+      break;
     default:
       // dbg("%s(%d), unknown ether_type %d\n", __func__, port, ether_type);
       break;
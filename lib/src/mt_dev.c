@@ -7,8 +7,10 @@
 #include "mt_arp.h"
 #include "mt_cni.h"
 #include "mt_dma.h"
+#include "mt_ip6.h"
 #include "mt_log.h"
 #include "mt_mcast.h"
+#include "mt_ndp.h"
 #include "mt_ptp.h"
 #include "mt_sch.h"
 #include "mt_socket.h"
@@ -59,6 +61,11 @@ static const struct mt_dev_driver_info dev_drvs[] = {
         .port_type = MT_PORT_PF,
         .drv_type = MT_DRV_IGC,
     },
+    {
+        .name = "net_memif",
+        .port_type = MT_PORT_MEMIF,
+        .drv_type = MT_DRV_MEMIF,
+    },
 };
 
 static int parse_driver_info(const char* driver, enum mt_port_type* port,
@@ -107,6 +114,54 @@ static void dev_eth_xstat(uint16_t port_id) {
   }
 }
 
+/* the burst stats of all pmd, the xsk ring full/empty for af_xdp */
+static void dev_queue_burst_stat(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_interface* inf = mt_if(impl, port);
+  bool xdp = mt_pmd_is_af_xdp(impl, port);
+  struct mt_tx_queue* tx_queue;
+  struct mt_rx_queue* rx_queue;
+
+  for (uint16_t q = 0; inf->tx_queues && (q < inf->max_tx_queues); q++) {
+    tx_queue = &inf->tx_queues[q];
+    if (!tx_queue->active || !tx_queue->stat_burst_full) continue;
+    notice("DEV(%d): tx q %u, %s %" PRIu64 "\n", port, q,
+           xdp ? "xsk ring full" : "burst not all sent", tx_queue->stat_burst_full);
+    tx_queue->stat_burst_full = 0;
+  }
+  for (uint16_t q = 0; inf->rx_queues && (q < inf->max_rx_queues); q++) {
+    rx_queue = &inf->rx_queues[q];
+    if (!rx_queue->active || !rx_queue->stat_burst_empty) continue;
+    notice("DEV(%d): rx q %u, %s %" PRIu64 "\n", port, q,
+           xdp ? "xsk ring empty" : "empty poll", rx_queue->stat_burst_empty);
+    rx_queue->stat_burst_empty = 0;
+  }
+}
+
+static void dev_memif_queue_stat(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_interface* inf = mt_if(impl, port);
+  struct mt_rx_queue* rx_queue;
+
+  for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
+    rx_queue = &inf->rx_queues[q];
+    if (rx_queue->stat_filter_drop) {
+      notice("DEV(%d): memif rx q %u, filter drop %" PRIu64 "\n", port, q,
+             rx_queue->stat_filter_drop);
+      rx_queue->stat_filter_drop = 0;
+    }
+    if (!rx_queue->impair_cb) continue;
+    if (!rx_queue->stat_impair_drop && !rx_queue->stat_impair_reorder &&
+        !rx_queue->stat_impair_delay_us)
+      continue;
+    notice("DEV(%d): memif rx q %u, drop %" PRIu64 " reorder %" PRIu64
+           " delay %" PRIu64 "us\n",
+           port, q, rx_queue->stat_impair_drop, rx_queue->stat_impair_reorder,
+           rx_queue->stat_impair_delay_us);
+    rx_queue->stat_impair_drop = 0;
+    rx_queue->stat_impair_reorder = 0;
+    rx_queue->stat_impair_delay_us = 0;
+  }
+}
+
 static void dev_eth_stat(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl);
   uint16_t port_id;
@@ -133,6 +188,9 @@ static void dev_eth_stat(struct mtl_main_impl* impl) {
       rte_eth_stats_reset(port_id);
       rte_eth_xstats_reset(port_id);
     }
+
+    dev_queue_burst_stat(impl, i);
+    if (mt_pmd_is_memif(impl, i)) dev_memif_queue_stat(impl, i);
   }
 }
 
@@ -198,13 +256,52 @@ static void* dev_stat_thread(void* arg) {
   return NULL;
 }
 
+static void dev_af_xdp_port_param(struct mtl_init_params* p, int port, char* param,
+                                  size_t len) {
+  struct mtl_af_xdp_params* xdp = &p->xdp_info[port];
+  int n;
+
+  n = snprintf(param, len, "net_af_xdp%d,iface=%s,start_queue=%u,queue_count=%u", port,
+               p->port[port], xdp->start_queue, xdp->queue_count);
+  /* all rx queues of the port share one umem if they use the same mempool */
+  if (p->flags & MTL_FLAG_AF_XDP_SHARED_UMEM)
+    n += snprintf(param + n, len - n, ",shared_umem=1");
+  /* the PMD set SO_PREFER_BUSY_POLL and SO_BUSY_POLL_BUDGET if budget > 0 */
+  if (p->flags & MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE)
+    snprintf(param + n, len - n, ",busy_budget=0");
+  else if (xdp->busy_budget)
+    snprintf(param + n, len - n, ",busy_budget=%u", xdp->busy_budget);
+}
+
+static int dev_memif_port_param(struct mtl_init_params* p, int port, char* param,
+                                size_t len) {
+  char role[16];
+  unsigned int id;
+
+  /* memif:<server|client>:<id> */
+  if (sscanf(p->port[port] + strlen(MT_MEMIF_PORT_PREFIX), "%15[^:]:%u", role, &id) !=
+      2) {
+    err("%s(%d), invalid memif port %s, should be memif:<server|client>:<id>\n",
+        __func__, port, p->port[port]);
+    return -EINVAL;
+  }
+  if (strcmp(role, "server") && strcmp(role, "client")) {
+    err("%s(%d), invalid memif role %s\n", __func__, port, role);
+    return -EINVAL;
+  }
+
+  snprintf(param, len, "net_memif%d,role=%s,id=%u,socket=%s", port, role, id,
+           MT_MEMIF_SOCKET);
+  return 0;
+}
+
 static int dev_eal_init(struct mtl_init_params* p, struct mt_kport_info* kport_info) {
   char* argv[MT_EAL_MAX_ARGS];
   int argc, ret;
   int num_ports = RTE_MIN(p->num_ports, MTL_PORT_MAX);
   static bool eal_inited = false; /* eal cann't re-enter in one process */
   bool has_afxdp = false;
-  char port_params[MTL_PORT_MAX][2 * MTL_PORT_MAX_LEN];
+  char port_params[MTL_PORT_MAX][MT_DEV_PORT_PARAM_MAX_LEN];
   char* port_param;
   int pci_ports = 0;
 
@@ -227,21 +324,27 @@ static int dev_eal_init(struct mtl_init_params* p, struct mt_kport_info* kport_i
     if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       argv[argc] = "--vdev";
       has_afxdp = true;
+    } else if (p->pmd[i] == MTL_PMD_DPDK_MEMIF) {
+      argv[argc] = "--vdev";
     } else {
       argv[argc] = "-a";
       pci_ports++;
     }
     argc++;
     port_param = port_params[i];
-    memset(port_param, 0, 2 * MTL_PORT_MAX_LEN);
+    memset(port_param, 0, MT_DEV_PORT_PARAM_MAX_LEN);
     if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
-      snprintf(port_param, 2 * MTL_PORT_MAX_LEN,
-               "net_af_xdp%d,iface=%s,start_queue=%u,queue_count=%u", i, p->port[i],
-               p->xdp_info[i].start_queue, p->xdp_info[i].queue_count);
+      dev_af_xdp_port_param(p, i, port_param, MT_DEV_PORT_PARAM_MAX_LEN);
       /* save port name */
       snprintf(kport_info->port[i], MTL_PORT_MAX_LEN, "net_af_xdp%d", i);
+    } else if (p->pmd[i] == MTL_PMD_DPDK_MEMIF) {
+      ret = dev_memif_port_param(p, i, port_param, MT_DEV_PORT_PARAM_MAX_LEN);
+      if (ret < 0) return ret;
+      /* save port name */
+      snprintf(kport_info->port[i], MTL_PORT_MAX_LEN, "net_memif%d", i);
     } else {
-      snprintf(port_param, 2 * MTL_PORT_MAX_LEN, "%s,max_burst_size=2048", p->port[i]);
+      snprintf(port_param, MT_DEV_PORT_PARAM_MAX_LEN, "%s,max_burst_size=2048",
+               p->port[i]);
     }
     info("%s(%d), port_param: %s\n", __func__, i, port_param);
     argv[argc] = port_param;
@@ -590,6 +693,78 @@ static struct rte_flow* dev_rx_queue_create_flow_raw(struct mt_interface* inf, u
   return r_flow;
 }
 
+/* the unicast ipv6 udp flow, from the sender to the address of this port */
+static struct rte_flow* dev_rx_queue_create_flow6(struct mt_interface* inf, uint16_t q,
+                                                  struct mt_rx_flow* flow) {
+  struct rte_flow_attr attr;
+  struct rte_flow_item pattern[4];
+  struct rte_flow_action action[2];
+  struct rte_flow_action_queue queue;
+  struct rte_flow_item_ipv6 ipv6_spec;
+  struct rte_flow_item_ipv6 ipv6_mask;
+  struct rte_flow_item_udp udp_spec;
+  struct rte_flow_item_udp udp_mask;
+  struct rte_flow_error error;
+  struct rte_flow* r_flow;
+  int ret;
+
+  uint16_t port_id = inf->port_id;
+
+  /* queue */
+  queue.index = q;
+
+  /* ipv6 flow */
+  memset(&ipv6_spec, 0, sizeof(ipv6_spec));
+  memset(&ipv6_mask, 0, sizeof(ipv6_mask));
+  ipv6_spec.hdr.proto = IPPROTO_UDP;
+  if (inf->drv_type != MT_DRV_IGC) {
+    rte_memcpy(ipv6_spec.hdr.src_addr, flow->src6_addr, MTL_IP6_ADDR_LEN);
+    rte_memcpy(ipv6_spec.hdr.dst_addr, flow->dst6_addr, MTL_IP6_ADDR_LEN);
+    memset(ipv6_mask.hdr.src_addr, 0xFF, MTL_IP6_ADDR_LEN);
+    memset(ipv6_mask.hdr.dst_addr, 0xFF, MTL_IP6_ADDR_LEN);
+  }
+
+  /* udp flow */
+  memset(&udp_spec, 0, sizeof(udp_spec));
+  memset(&udp_mask, 0, sizeof(udp_mask));
+  udp_spec.hdr.dst_port = htons(flow->dst_port);
+  udp_mask.hdr.dst_port = htons(0xFFFF);
+
+  memset(&attr, 0, sizeof(attr));
+  attr.ingress = 1;
+
+  memset(action, 0, sizeof(action));
+  action[0].type = RTE_FLOW_ACTION_TYPE_QUEUE;
+  action[0].conf = &queue;
+  action[1].type = RTE_FLOW_ACTION_TYPE_END;
+
+  memset(pattern, 0, sizeof(pattern));
+  pattern[0].type = RTE_FLOW_ITEM_TYPE_ETH;
+  pattern[1].type = RTE_FLOW_ITEM_TYPE_IPV6;
+  pattern[1].spec = &ipv6_spec;
+  pattern[1].mask = &ipv6_mask;
+  pattern[2].type = RTE_FLOW_ITEM_TYPE_UDP;
+  pattern[2].spec = &udp_spec;
+  pattern[2].mask = &udp_mask;
+  pattern[3].type = RTE_FLOW_ITEM_TYPE_END;
+
+  ret = rte_flow_validate(port_id, &attr, pattern, action, &error);
+  if (ret < 0) {
+    err("%s(%d), rte_flow_validate fail %d for queue %d, %s\n", __func__, port_id, ret, q,
+        error.message);
+    return NULL;
+  }
+
+  r_flow = rte_flow_create(port_id, &attr, pattern, action, &error);
+  if (!r_flow) {
+    err("%s(%d), rte_flow_create fail for queue %d, %s\n", __func__, port_id, q,
+        error.message);
+    return NULL;
+  }
+
+  return r_flow;
+}
+
 static struct rte_flow* dev_rx_queue_create_flow(struct mt_interface* inf, uint16_t q,
                                                  struct mt_rx_flow* flow) {
   struct rte_flow_attr attr;
@@ -613,6 +788,7 @@ static struct rte_flow* dev_rx_queue_create_flow(struct mt_interface* inf, uint1
   if (mt_if_hdr_split_pool(inf, q)) {
     return dev_rx_queue_create_flow_raw(inf, q, flow);
   }
+  if (flow->ipv6) return dev_rx_queue_create_flow6(inf, q, flow);
 
   /* queue */
   queue.index = q;
@@ -630,6 +806,10 @@ static struct rte_flow* dev_rx_queue_create_flow(struct mt_interface* inf, uint1
     memset(&ipv4_mask.hdr.dst_addr, 0xFF, MTL_IP_ADDR_LEN);
     if (mt_is_multicast_ip(flow->dip_addr)) {
       rte_memcpy(&ipv4_spec.hdr.dst_addr, flow->dip_addr, MTL_IP_ADDR_LEN);
+      if (mt_ip_to_u32(flow->ssm_addr)) { /* drop the other sources of the group */
+        rte_memcpy(&ipv4_spec.hdr.src_addr, flow->ssm_addr, MTL_IP_ADDR_LEN);
+        memset(&ipv4_mask.hdr.src_addr, 0xFF, MTL_IP_ADDR_LEN);
+      }
     } else {
       rte_memcpy(&ipv4_spec.hdr.src_addr, flow->dip_addr, MTL_IP_ADDR_LEN);
       rte_memcpy(&ipv4_spec.hdr.dst_addr, flow->sip_addr, MTL_IP_ADDR_LEN);
@@ -815,6 +995,14 @@ static int dev_config_port(struct mtl_main_impl* impl, enum mtl_port port) {
 #endif
   }
 
+  if (inf->feature & MT_IF_FEATURE_TX_OFFLOAD_UDP_CKSUM) {
+#if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
+    port_conf.txmode.offloads |= RTE_ETH_TX_OFFLOAD_UDP_CKSUM;
+#else
+    port_conf.txmode.offloads |= DEV_TX_OFFLOAD_UDP_CKSUM;
+#endif
+  }
+
   if (inf->feature & MT_IF_FEATURE_RX_OFFLOAD_TIMESTAMP) {
 #if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
     port_conf.rxmode.offloads |= RTE_ETH_RX_OFFLOAD_TIMESTAMP;
@@ -823,15 +1011,28 @@ static int dev_config_port(struct mtl_main_impl* impl, enum mtl_port port) {
 #endif
   }
 
+  if (mt_has_rx_intr(impl)) port_conf.intr_conf.rxq = 1;
+
   ret = rte_eth_dev_configure(port_id, nb_rx_q, nb_tx_q, &port_conf);
+  if ((ret < 0) && port_conf.intr_conf.rxq) {
+    warn("%s(%d), rx intr not supported %d, fallback to poll\n", __func__, port, ret);
+    port_conf.intr_conf.rxq = 0;
+    ret = rte_eth_dev_configure(port_id, nb_rx_q, nb_tx_q, &port_conf);
+  }
   if (ret < 0) {
     err("%s(%d), rte_eth_dev_configure fail %d\n", __func__, port, ret);
     return ret;
   }
+  inf->rx_intr = port_conf.intr_conf.rxq ? true : false;
 
   /* apply if user has rx_tx_desc config */
   if (p->nb_tx_desc) nb_tx_desc = p->nb_tx_desc;
   if (p->nb_rx_desc) nb_rx_desc = p->nb_rx_desc;
+  if (mt_pmd_is_af_xdp(impl, port)) {
+    /* the xsk rings are sized by the queue desc number */
+    if (p->xdp_info[port].tx_ring_size) nb_tx_desc = p->xdp_info[port].tx_ring_size;
+    if (p->xdp_info[port].rx_ring_size) nb_rx_desc = p->xdp_info[port].rx_ring_size;
+  }
 
   ret = rte_eth_dev_adjust_nb_rx_tx_desc(port_id, &nb_rx_desc, &nb_tx_desc);
   if (ret < 0) {
@@ -841,7 +1042,7 @@ static int dev_config_port(struct mtl_main_impl* impl, enum mtl_port port) {
   inf->nb_tx_desc = nb_tx_desc;
   inf->nb_rx_desc = nb_rx_desc;
 
-  if (!mt_pmd_is_kernel(impl, port)) {
+  if (mt_pmd_type(impl, port) == MTL_PMD_DPDK_USER) {
     /* enable PTYPE for packet classification by NIC */
     uint32_t ptypes[16];
     uint32_t set_ptypes[16];
@@ -1087,7 +1288,7 @@ static int dev_filelock_unlock(struct mtl_main_impl* impl) {
   return 0;
 }
 
-int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
+int mt_dev_get_socket_lcore(struct mtl_main_impl* impl, int socket, unsigned int* lcore) {
   unsigned int cur_lcore = 0;
   int ret;
   struct mt_lcore_shm* lcore_shm = impl->lcore_shm;
@@ -1101,8 +1302,9 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
   do {
     cur_lcore = rte_get_next_lcore(cur_lcore, 1, 0);
 
-    if ((cur_lcore < RTE_MAX_LCORE) && mt_socket_match(rte_lcore_to_socket_id(cur_lcore),
-                                                       mt_socket_id(impl, MTL_PORT_P))) {
+    if ((cur_lcore < RTE_MAX_LCORE) &&
+        ((socket == SOCKET_ID_ANY) ||
+         mt_socket_match(rte_lcore_to_socket_id(cur_lcore), socket))) {
       if (!lcore_shm->lcores_active[cur_lcore]) {
         *lcore = cur_lcore;
         lcore_shm->lcores_active[cur_lcore] = true;
@@ -1110,7 +1312,8 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
         rte_atomic32_inc(&impl->lcore_cnt);
         impl->local_lcores_active[cur_lcore] = true;
         ret = dev_filelock_unlock(impl);
-        info("%s, available lcore %d\n", __func__, cur_lcore);
+        info("%s, available lcore %d on socket %d\n", __func__, cur_lcore,
+             rte_lcore_to_socket_id(cur_lcore));
         if (ret < 0) {
           err("%s, dev_filelock_unlock fail\n", __func__);
           return ret;
@@ -1121,10 +1324,14 @@ int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
   } while (cur_lcore < RTE_MAX_LCORE);
 
   dev_filelock_unlock(impl);
-  err("%s, fail to find lcore\n", __func__);
+  err("%s, fail to find lcore on socket %d\n", __func__, socket);
   return -EIO;
 }
 
+int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore) {
+  return mt_dev_get_socket_lcore(impl, mt_socket_id(impl, MTL_PORT_P), lcore);
+}
+
 int mt_dev_put_lcore(struct mtl_main_impl* impl, unsigned int lcore) {
   int ret;
   struct mt_lcore_shm* lcore_shm = impl->lcore_shm;
@@ -1315,6 +1522,254 @@ static int dev_if_free_rx_queue_flow(struct mt_interface* inf,
   return 0;
 }
 
+/*
+ * Hold the pkts with a random delay each and return the ones due, the order is kept
+ * as the release time never goes backwards. The pkts beyond the queue size are dropped
+ * like a full buffer in the network.
+ */
+static uint16_t dev_memif_rx_delay(struct mt_rx_queue* rx_queue, struct rte_mbuf* pkts[],
+                                   uint16_t nb_pkts, uint16_t max_pkts) {
+  uint32_t jitter_us = rx_queue->impair->rx_jitter_us;
+  const uint32_t mask = MT_DEV_MEMIF_DELAY_Q_SIZE - 1;
+  struct mt_rx_delay_pkt* slot;
+  uint64_t now = mt_get_monotonic_time();
+  uint64_t release;
+  uint16_t nb = 0;
+
+  for (uint16_t i = 0; i < nb_pkts; i++) {
+    if ((rx_queue->delay_tail - rx_queue->delay_head) >= MT_DEV_MEMIF_DELAY_Q_SIZE) {
+      rte_pktmbuf_free(pkts[i]);
+      rx_queue->stat_impair_drop++;
+      continue;
+    }
+    uint32_t delay_us = rte_rand() % (jitter_us + 1);
+    release = RTE_MAX(now + (uint64_t)delay_us * NS_PER_US, rx_queue->delay_last_ns);
+    rx_queue->delay_last_ns = release;
+    slot = &rx_queue->delay_q[rx_queue->delay_tail & mask];
+    slot->pkt = pkts[i];
+    slot->release_ns = release;
+    rx_queue->delay_tail++;
+    rx_queue->stat_impair_delay_us += delay_us;
+  }
+
+  while ((nb < max_pkts) && (rx_queue->delay_head != rx_queue->delay_tail)) {
+    slot = &rx_queue->delay_q[rx_queue->delay_head & mask];
+    if (slot->release_ns > now) break;
+    pkts[nb++] = slot->pkt;
+    slot->pkt = NULL;
+    rx_queue->delay_head++;
+  }
+
+  return nb;
+}
+
+static void dev_memif_rx_delay_flush(struct mt_rx_queue* rx_queue) {
+  const uint32_t mask = MT_DEV_MEMIF_DELAY_Q_SIZE - 1;
+  struct mt_rx_delay_pkt* slot;
+
+  while (rx_queue->delay_head != rx_queue->delay_tail) {
+    slot = &rx_queue->delay_q[rx_queue->delay_head & mask];
+    rte_pktmbuf_free(slot->pkt);
+    slot->pkt = NULL;
+    rx_queue->delay_head++;
+  }
+}
+
+/* rx callback to emulate the loss, reorder and jitter of a real network */
+static uint16_t dev_memif_rx_impair(uint16_t port_id, uint16_t queue,
+                                   struct rte_mbuf* pkts[], uint16_t nb_pkts,
+                                   uint16_t max_pkts, void* priv) {
+  struct mt_rx_queue* rx_queue = priv;
+  struct mtl_memif_params* impair = rx_queue->impair;
+  struct rte_mbuf* tmp;
+  uint16_t nb = 0;
+
+  MT_MAY_UNUSED(port_id);
+  MT_MAY_UNUSED(queue);
+
+  /* the delayed pkts are released on the polls even nothing new arrives */
+  if (rx_queue->delay_q) nb_pkts = dev_memif_rx_delay(rx_queue, pkts, nb_pkts, max_pkts);
+  if (!nb_pkts) return 0;
+
+  for (uint16_t i = 0; i < nb_pkts; i++) {
+    if (impair->rx_loss_ppm && ((rte_rand() % MT_DEV_PPM) < impair->rx_loss_ppm)) {
+      rte_pktmbuf_free(pkts[i]);
+      rx_queue->stat_impair_drop++;
+      continue;
+    }
+    pkts[nb++] = pkts[i];
+  }
+
+  if (impair->rx_reorder_ppm) {
+    for (uint16_t i = 0; (i + 1) < nb; i++) {
+      if ((rte_rand() % MT_DEV_PPM) >= impair->rx_reorder_ppm) continue;
+      tmp = pkts[i];
+      pkts[i] = pkts[i + 1];
+      pkts[i + 1] = tmp;
+      rx_queue->stat_impair_reorder++;
+      i++; /* skip the swapped one */
+    }
+  }
+
+  return nb;
+}
+
+/* the software version of dev_rx_queue_create_flow as no rte_flow on memif */
+static bool dev_memif_rx_match(struct mt_rx_flow* flow, struct rte_mbuf* pkt) {
+  struct rte_ether_hdr* eth = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr*);
+  struct rte_udp_hdr* udp;
+  uint8_t* dip;
+
+  if (eth->ether_type == htons(RTE_ETHER_TYPE_IPV4)) {
+    struct mt_udp_hdr* hdr = (struct mt_udp_hdr*)eth;
+
+    if (flow->ipv6 || (pkt->data_len < sizeof(*hdr))) return false;
+    if (hdr->ipv4.next_proto_id != IPPROTO_UDP) return false;
+    /* the unicast flow from the sender(dip) to this port(sip) */
+    dip = mt_is_multicast_ip(flow->dip_addr) ? flow->dip_addr : flow->sip_addr;
+    if (memcmp(&hdr->ipv4.dst_addr, dip, MTL_IP_ADDR_LEN)) return false;
+    if ((dip == flow->dip_addr) && mt_ip_to_u32(flow->ssm_addr) &&
+        memcmp(&hdr->ipv4.src_addr, flow->ssm_addr, MTL_IP_ADDR_LEN))
+      return false;
+    udp = &hdr->udp;
+  } else if (eth->ether_type == htons(RTE_ETHER_TYPE_IPV6)) {
+    struct mt_udp_hdr6* hdr6 = (struct mt_udp_hdr6*)eth;
+
+    if (!flow->ipv6 || (pkt->data_len < sizeof(*hdr6))) return false;
+    if (hdr6->ipv6.proto != IPPROTO_UDP) return false;
+    if (memcmp(hdr6->ipv6.dst_addr, flow->dst6_addr, MTL_IP6_ADDR_LEN)) return false;
+    udp = &hdr6->udp;
+  } else {
+    return false;
+  }
+
+  if (flow->port_flow && (udp->dst_port != htons(flow->dst_port))) return false;
+  return true;
+}
+
+/* rx callback to drop the pkts not for the flow of this queue */
+static uint16_t dev_memif_rx_filter(uint16_t port_id, uint16_t queue,
+                                   struct rte_mbuf* pkts[], uint16_t nb_pkts,
+                                   uint16_t max_pkts, void* priv) {
+  struct mt_rx_queue* rx_queue = priv;
+  uint16_t nb = 0;
+
+  MT_MAY_UNUSED(port_id);
+  MT_MAY_UNUSED(queue);
+  MT_MAY_UNUSED(max_pkts);
+
+  /* no flow attached */
+  if (!rx_queue->st_flow.dst_port) return nb_pkts;
+
+  for (uint16_t i = 0; i < nb_pkts; i++) {
+    if (!dev_memif_rx_match(&rx_queue->st_flow, pkts[i])) {
+      rte_pktmbuf_free(pkts[i]);
+      rx_queue->stat_filter_drop++;
+      continue;
+    }
+    pkts[nb++] = pkts[i];
+  }
+
+  return nb;
+}
+
+static int dev_memif_uinit_filter(struct mt_interface* inf) {
+  struct mt_rx_queue* rx_queue;
+
+  if (!inf->rx_queues) return 0;
+
+  for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
+    rx_queue = &inf->rx_queues[q];
+    if (rx_queue->filter_cb) {
+      rte_eth_remove_rx_callback(inf->port_id, q, rx_queue->filter_cb);
+      /* the port is stopped, no burst in flight any more */
+      rte_free((void*)rx_queue->filter_cb);
+      rx_queue->filter_cb = NULL;
+    }
+  }
+
+  return 0;
+}
+
+static int dev_memif_init_filter(struct mt_interface* inf) {
+  struct mt_rx_queue* rx_queue;
+
+  /* the system queues(arp, igmp) take all, only the session queues */
+  for (uint16_t q = inf->system_rx_queues_end; q < inf->max_rx_queues; q++) {
+    rx_queue = &inf->rx_queues[q];
+    rx_queue->filter_cb =
+        rte_eth_add_rx_callback(inf->port_id, q, dev_memif_rx_filter, rx_queue);
+    if (!rx_queue->filter_cb) {
+      err("%s(%d), add rx callback fail for queue %u\n", __func__, inf->port, q);
+      dev_memif_uinit_filter(inf);
+      return -EIO;
+    }
+  }
+
+  return 0;
+}
+
+static int dev_memif_uinit_impair(struct mt_interface* inf) {
+  struct mt_rx_queue* rx_queue;
+
+  if (!inf->rx_queues) return 0;
+
+  for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
+    rx_queue = &inf->rx_queues[q];
+    if (rx_queue->impair_cb) {
+      rte_eth_remove_rx_callback(inf->port_id, q, rx_queue->impair_cb);
+      /* the port is stopped, no burst in flight any more */
+      rte_free((void*)rx_queue->impair_cb);
+      rx_queue->impair_cb = NULL;
+    }
+    if (rx_queue->delay_q) {
+      dev_memif_rx_delay_flush(rx_queue);
+      mt_rte_free(rx_queue->delay_q);
+      rx_queue->delay_q = NULL;
+    }
+  }
+
+  return 0;
+}
+
+static int dev_memif_init_impair(struct mtl_main_impl* impl, struct mt_interface* inf) {
+  enum mtl_port port = inf->port;
+  struct mtl_memif_params* impair = &mt_get_user_params(impl)->memif_info[port];
+  struct mt_rx_queue* rx_queue;
+
+  if (!impair->rx_loss_ppm && !impair->rx_reorder_ppm && !impair->rx_jitter_us)
+    return 0;
+
+  /* keep the system queues(arp, igmp) clean, only the session queues */
+  for (uint16_t q = inf->system_rx_queues_end; q < inf->max_rx_queues; q++) {
+    rx_queue = &inf->rx_queues[q];
+    rx_queue->impair = impair;
+    if (impair->rx_jitter_us) {
+      size_t sz = sizeof(*rx_queue->delay_q) * MT_DEV_MEMIF_DELAY_Q_SIZE;
+
+      rx_queue->delay_q = mt_rte_zmalloc_socket(sz, mt_socket_id(impl, port));
+      if (!rx_queue->delay_q) {
+        err("%s(%d), delay queue malloc fail for queue %u\n", __func__, port, q);
+        dev_memif_uinit_impair(inf);
+        return -ENOMEM;
+      }
+      rx_queue->delay_head = rx_queue->delay_tail = 0;
+      rx_queue->delay_last_ns = 0;
+    }
+    rx_queue->impair_cb =
+        rte_eth_add_rx_callback(inf->port_id, q, dev_memif_rx_impair, rx_queue);
+    if (!rx_queue->impair_cb) {
+      err("%s(%d), add rx callback fail for queue %u\n", __func__, port, q);
+      dev_memif_uinit_impair(inf);
+      return -EIO;
+    }
+  }
+
+  info("%s(%d), loss %u ppm reorder %u ppm jitter %u us\n", __func__, port,
+       impair->rx_loss_ppm, impair->rx_reorder_ppm, impair->rx_jitter_us);
+  return 0;
+}
+
 static int dev_if_uinit_rx_queues(struct mt_interface* inf) {
   enum mtl_port port = inf->port;
   struct mt_rx_queue* rx_queue;
@@ -1356,12 +1811,15 @@ static int dev_if_init_rx_queues(struct mtl_main_impl* impl, struct mt_interface
     return -ENOMEM;
   }
 
-  if (!mt_has_rx_mono_pool(impl)) {
-    for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
-      rx_queues[q].queue_id = q;
-      rx_queues[q].port = inf->port;
-      rx_queues[q].port_id = inf->port_id;
+  for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
+    rx_queues[q].queue_id = q;
+    rx_queues[q].port = inf->port;
+    rx_queues[q].port_id = inf->port_id;
+  }
 
+  /* mono pool or shared umem, all queues use the rx_mbuf_pool of the interface */
+  if (!mt_has_rx_mono_pool(impl) && !mt_has_af_xdp_shared_umem(impl, inf->port)) {
+    for (uint16_t q = 0; q < inf->max_rx_queues; q++) {
       /* Create mempool to hold the rx queue mbufs. */
       unsigned int mbuf_elements = inf->nb_rx_desc + 1024;
       char pool_name[ST_MAX_NAME_LEN];
@@ -1584,6 +2042,8 @@ struct mt_rx_queue* mt_dev_get_rx_queue(struct mtl_main_impl* impl, enum mtl_por
           mt_pthread_mutex_unlock(&inf->rx_queues_mutex);
           return NULL;
         }
+      } else if (mt_pmd_is_memif(impl, port)) {
+        /* no flow on memif, filtered by dev_memif_rx_filter on the st_flow */
       } else {
         struct rte_flow* r_flow;
 
@@ -1719,6 +2179,9 @@ int mt_dev_put_rx_queue(struct mtl_main_impl* impl, struct mt_rx_queue* queue) {
     return -EIO;
   }
 
+  /* detach from the rx interrupt of the sch */
+  mt_sch_del_rx_intr(rx_queue);
+
   st_flow = &rx_queue->st_flow;
 
   if (mt_pmd_is_kernel(impl, port))
@@ -1779,7 +2242,10 @@ int mt_dev_create(struct mtl_main_impl* impl) {
       /* leave time as reset */
       mt_sleep_ms(5 * 1000);
     }
-    ret = dev_detect_link(impl, i); /* some port can only detect link after start */
+    if (mt_pmd_is_memif(impl, i)) /* link up when peer connected, detect it later */
+      ret = 0;
+    else
+      ret = dev_detect_link(impl, i); /* some port can only detect link after start */
     if (ret < 0) {
       err("%s(%d), dev_detect_link fail %d retry %d\n", __func__, i, ret, detect_retry);
       if (detect_retry < 3) {
@@ -1812,6 +2278,16 @@ int mt_dev_create(struct mtl_main_impl* impl) {
          st_tx_pacing_way_name(inf->tx_pacing_way));
   }
 
+  /* the memif peer can be the other port of this instance, wait after all started */
+  for (int i = 0; i < num_ports; i++) {
+    if (!mt_pmd_is_memif(impl, i)) continue;
+    ret = dev_detect_link(impl, i);
+    if (ret < 0) {
+      err("%s(%d), memif peer not connected %d\n", __func__, i, ret);
+      goto err_exit;
+    }
+  }
+
   /* init sch with one lcore scheduler */
   int data_quota_mbs_per_sch;
   if (mt_has_user_quota(impl)) {
@@ -1828,7 +2304,8 @@ int mt_dev_create(struct mtl_main_impl* impl) {
   }
 
   /* create system sch */
-  impl->main_sch = mt_sch_get(impl, 0, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  impl->main_sch = mt_sch_get(impl, 0, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL,
+                              mt_socket_id(impl, MTL_PORT_P));
   if (ret < 0) {
     err("%s, get sch fail\n", __func__);
     goto err_exit;
@@ -1968,6 +2445,67 @@ int mt_dev_dst_ip_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
   return 0;
 }
 
+int mt_dev_dst_ip_mac_async(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
+                            struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms,
+                            mt_arp_cb_t cb, void* priv) {
+  int ret;
+
+  /* only the cni arp path can resolve in background */
+  if (mt_is_multicast_ip(dip) || mt_pmd_is_kernel(impl, port))
+    return mt_dev_dst_ip_mac(impl, dip, ea, port, timeout_ms);
+
+  ret = mt_arp_cni_get_mac_async(impl, ea, port, mt_ip_to_u32(dip), timeout_ms, cb, priv);
+  if ((ret < 0) && (ret != -EINPROGRESS)) {
+    err("%s(%d), failed to get mac from cni %d\n", __func__, port, ret);
+    return ret;
+  }
+
+  return ret;
+}
+
+int mt_dev_dst_ip_mac_cancel(struct mtl_main_impl* impl, enum mtl_port port,
+                             void* priv) {
+  if (mt_pmd_is_kernel(impl, port)) return 0;
+  mt_ndp_cni_cancel(impl, port, priv);
+  return mt_arp_cni_cancel(impl, port, priv);
+}
+
+int mt_dev_dst_ip6_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP6_ADDR_LEN],
+                       struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms) {
+  int ret;
+
+  if (mt_ip6_is_multicast(dip)) {
+    mt_ip6_mcast_mac(dip, ea->addr_bytes);
+    return 0;
+  }
+  /* no NDP path with the kernel socket yet */
+  if (mt_pmd_is_kernel(impl, port)) return -ENOTSUP;
+
+  ret = mt_ndp_cni_get_mac(impl, ea, port, dip, timeout_ms);
+  if (ret < 0) {
+    err("%s(%d), failed to get mac from cni %d\n", __func__, port, ret);
+    return ret;
+  }
+  return 0;
+}
+
+int mt_dev_dst_ip6_mac_async(struct mtl_main_impl* impl, uint8_t dip[MTL_IP6_ADDR_LEN],
+                             struct rte_ether_addr* ea, enum mtl_port port,
+                             int timeout_ms, mt_ndp_cb_t cb, void* priv) {
+  int ret;
+
+  if (mt_ip6_is_multicast(dip) || mt_pmd_is_kernel(impl, port))
+    return mt_dev_dst_ip6_mac(impl, dip, ea, port, timeout_ms);
+
+  ret = mt_ndp_cni_get_mac_async(impl, ea, port, dip, timeout_ms, cb, priv);
+  if ((ret < 0) && (ret != -EINPROGRESS)) {
+    err("%s(%d), failed to get mac from cni %d\n", __func__, port, ret);
+    return ret;
+  }
+
+  return ret;
+}
+
 int mt_dev_if_uinit(struct mtl_main_impl* impl) {
   int num_ports = mt_num_ports(impl), ret;
   struct mt_interface* inf;
@@ -1986,6 +2524,8 @@ int mt_dev_if_uinit(struct mtl_main_impl* impl) {
     }
 
     dev_if_uinit_tx_queues(inf);
+    dev_memif_uinit_impair(inf);
+    dev_memif_uinit_filter(inf);
     dev_if_uinit_rx_queues(inf);
 
     if (inf->mcast_mac_lists) {
@@ -2025,7 +2565,7 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
   for (int i = 0; i < num_ports; i++) {
     inf = mt_if(impl, i);
 
-    if (mt_pmd_is_kernel(impl, i))
+    if (mt_pmd_type(impl, i) != MTL_PMD_DPDK_USER)
       port = impl->kport_info.port[i];
     else
       port = p->port[i];
@@ -2055,6 +2595,9 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
     mt_pthread_mutex_init(&inf->rx_queues_mutex, NULL);
     mt_pthread_mutex_init(&inf->tx_sys_queue_mutex, NULL);
 
+    if (mt_pmd_is_af_xdp(impl, i) && mt_has_af_xdp_busy_poll(impl))
+      mt_socket_check_busy_poll(impl, i);
+
     if (mt_has_user_ptp(impl)) /* user provide the ptp source */
       inf->ptp_get_time_fn = ptp_from_user;
     else
@@ -2094,7 +2637,8 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
     }
 
     /* when using VF, num_queue_pairs will be set as the max of tx/rx */
-    if (inf->port_type == MT_PORT_VF) {
+    /* memif peer tx queue N is connected to local rx queue N, keep them symmetric */
+    if ((inf->port_type == MT_PORT_VF) || (inf->port_type == MT_PORT_MEMIF)) {
       inf->max_tx_queues = RTE_MAX(inf->max_rx_queues, inf->max_tx_queues);
       inf->max_rx_queues = inf->max_tx_queues;
     }
@@ -2118,6 +2662,14 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       inf->feature |= MT_IF_FEATURE_TX_OFFLOAD_IPV4_CKSUM;
 #endif
 
+#if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
+    if (dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_UDP_CKSUM)
+      inf->feature |= MT_IF_FEATURE_TX_OFFLOAD_UDP_CKSUM;
+#else
+    if (dev_info.tx_offload_capa & DEV_TX_OFFLOAD_UDP_CKSUM)
+      inf->feature |= MT_IF_FEATURE_TX_OFFLOAD_UDP_CKSUM;
+#endif
+
     if (mt_has_ebu(impl) &&
 #if RTE_VERSION >= RTE_VERSION_NUM(22, 3, 0, 0)
         (dev_info.rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP)
@@ -2168,6 +2720,21 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       inf->rx_mbuf_pool = mbuf_pool;
     }
 
+    /* Create the umem shared by all af_xdp rx queues */
+    if (mt_has_af_xdp_shared_umem(impl, i) && !inf->rx_mbuf_pool) {
+      mbuf_elements = inf->max_rx_queues * (inf->nb_rx_desc + 1024);
+      snprintf(pool_name, ST_MAX_NAME_LEN, "ST%d_RX_UMEM_MBUF_POOL", i);
+      mbuf_pool = mt_mempool_create_by_ops(
+          impl, i, pool_name, mbuf_elements, MT_MBUF_CACHE_SIZE,
+          sizeof(struct mt_muf_priv_data), 2048 - MT_MBUF_CACHE_SIZE, NULL);
+      if (!mbuf_pool) {
+        mt_dev_if_uinit(impl);
+        return -ENOMEM;
+      }
+      inf->rx_mbuf_pool = mbuf_pool;
+      info("%s(%d), shared umem with %u elements\n", __func__, i, mbuf_elements);
+    }
+
     /* Create default mempool in memory to hold the system tx mbufs */
     mbuf_elements = 1024;
     if (mt_has_tx_mono_pool(impl)) {
@@ -2192,6 +2759,19 @@ int mt_dev_if_init(struct mtl_main_impl* impl) {
       mt_dev_if_uinit(impl);
       return -ENOMEM;
     }
+    if (mt_pmd_is_memif(impl, i)) {
+      /* filter before the impairment, the loss applies to the pkts of the flow */
+      ret = dev_memif_init_filter(inf);
+      if (ret < 0) {
+        mt_dev_if_uinit(impl);
+        return ret;
+      }
+      ret = dev_memif_init_impair(impl, inf);
+      if (ret < 0) {
+        mt_dev_if_uinit(impl);
+        return ret;
+      }
+    }
 
     inf->pad = mt_build_pad(impl, mt_get_tx_mempool(impl, i), port_id,
                             RTE_ETHER_TYPE_IPV4, 1024);
@@ -16,6 +16,13 @@
 
 #define MT_EAL_MAX_ARGS (32)
 
+/* max length of the devargs for one port */
+#define MT_DEV_PORT_PARAM_MAX_LEN (3 * MTL_PORT_MAX_LEN)
+
+#define MT_DEV_PPM (1000 * 1000) /* parts per million */
+/* max pkts held by the memif jitter impairment per rx queue, power of 2 */
+#define MT_DEV_MEMIF_DELAY_Q_SIZE (4096)
+
 int mt_dev_get_socket(const char* port);
 
 int mt_dev_init(struct mtl_init_params* p, struct mt_kport_info* kport_info);
@@ -29,6 +36,17 @@ int mt_dev_stop(struct mtl_main_impl* impl);
 
 int mt_dev_dst_ip_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
                       struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms);
+/* return -EINPROGRESS if the mac will be delivered later by cb */
+int mt_dev_dst_ip_mac_async(struct mtl_main_impl* impl, uint8_t dip[MTL_IP_ADDR_LEN],
+                            struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms,
+                            mt_arp_cb_t cb, void* priv);
+int mt_dev_dst_ip_mac_cancel(struct mtl_main_impl* impl, enum mtl_port port, void* priv);
+/* the ipv6 counterparts by NDP, the cancel above removes the NDP callbacks also */
+int mt_dev_dst_ip6_mac(struct mtl_main_impl* impl, uint8_t dip[MTL_IP6_ADDR_LEN],
+                       struct rte_ether_addr* ea, enum mtl_port port, int timeout_ms);
+int mt_dev_dst_ip6_mac_async(struct mtl_main_impl* impl, uint8_t dip[MTL_IP6_ADDR_LEN],
+                             struct rte_ether_addr* ea, enum mtl_port port,
+                             int timeout_ms, mt_ndp_cb_t cb, void* priv);
 
 struct mt_tx_queue* mt_dev_get_tx_queue(struct mtl_main_impl* impl, enum mtl_port port,
                                         uint64_t bytes_per_sec);
@@ -40,7 +58,9 @@ int mt_dev_flush_tx_queue(struct mtl_main_impl* impl, struct mt_tx_queue* queue,
                           struct rte_mbuf* pad);
 static inline uint16_t mt_dev_tx_burst(struct mt_tx_queue* queue,
                                        struct rte_mbuf** tx_pkts, uint16_t nb_pkts) {
-  return rte_eth_tx_burst(queue->port_id, queue->queue_id, tx_pkts, nb_pkts);
+  uint16_t tx = rte_eth_tx_burst(queue->port_id, queue->queue_id, tx_pkts, nb_pkts);
+  if (unlikely(tx < nb_pkts)) queue->stat_burst_full++;
+  return tx;
 }
 uint16_t mt_dev_tx_burst_busy(struct mtl_main_impl* impl, struct mt_tx_queue* queue,
                               struct rte_mbuf** tx_pkts, uint16_t nb_pkts,
@@ -58,7 +78,12 @@ static inline uint16_t mt_dev_rx_queue_id(struct mt_rx_queue* queue) {
 static inline uint16_t mt_dev_rx_burst(struct mt_rx_queue* queue,
                                        struct rte_mbuf** rx_pkts,
                                        const uint16_t nb_pkts) {
-  return rte_eth_rx_burst(queue->port_id, queue->queue_id, rx_pkts, nb_pkts);
+  uint16_t rx = rte_eth_rx_burst(queue->port_id, queue->queue_id, rx_pkts, nb_pkts);
+  if (!rx)
+    queue->stat_burst_empty++;
+  else
+    queue->intr_pkt_seen = true; /* for the idle check of the hybrid rx interrupt */
+  return rx;
 }
 
 int mt_dev_if_init(struct mtl_main_impl* impl);
@@ -66,6 +91,8 @@ int mt_dev_if_uinit(struct mtl_main_impl* impl);
 
 int mt_dev_put_lcore(struct mtl_main_impl* impl, unsigned int lcore);
 int mt_dev_get_lcore(struct mtl_main_impl* impl, unsigned int* lcore);
+/* one free lcore on the numa socket, any socket if SOCKET_ID_ANY */
+int mt_dev_get_socket_lcore(struct mtl_main_impl* impl, int socket, unsigned int* lcore);
 bool mt_dev_lcore_valid(struct mtl_main_impl* impl, unsigned int lcore);
 
 #endif
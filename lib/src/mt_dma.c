@@ -4,12 +4,71 @@
 
 #include "mt_dma.h"
 
+#include "mt_dev.h"
 #include "mt_log.h"
+#include "mt_simd.h"
 
 static inline struct mt_map_mgr* mt_get_map_mgr(struct mtl_main_impl* impl) {
   return &impl->map_mgr;
 }
 
+struct mt_map_msl_check {
+  mtl_iova_t start;
+  mtl_iova_t end;     /* exclusive */
+  mtl_iova_t hit_end; /* the end of the overlapped memseg list, 0 if no overlap */
+};
+
+static int map_msl_overlap(const struct rte_memseg_list* msl, void* arg) {
+  struct mt_map_msl_check* check = arg;
+  mtl_iova_t msl_start = (mtl_iova_t)(uintptr_t)msl->base_va;
+  mtl_iova_t msl_end = msl_start + msl->len;
+
+  if (!msl->base_va || !msl->len) return 0;
+  if ((check->start < msl_end) && (msl_start < check->end)) {
+    check->hit_end = msl_end;
+    return 1; /* stop the walk */
+  }
+  return 0;
+}
+
+/*
+ * First free iova range from MT_MAP_IOVA_BASE, not overlapped with any mapped item. The
+ * cpu dma engine tell the user iova from the mbuf va, so the whole range also has to be
+ * out of all memseg lists va.
+ */
+static mtl_iova_t map_find_iova(struct mt_map_mgr* mgr, size_t size) {
+  mtl_iova_t base = MT_MAP_IOVA_BASE;
+  struct mt_map_msl_check check;
+  struct mt_map_item* i_item;
+  bool moved;
+
+  do {
+    moved = false;
+    if ((base + size) < base) return MTL_BAD_IOVA; /* wrapped */
+
+    for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
+      i_item = mgr->items[i];
+      if (!i_item) continue;
+      if ((base < (i_item->iova + i_item->size)) && (i_item->iova < (base + size))) {
+        base = i_item->iova + i_item->size;
+        moved = true;
+      }
+    }
+    if (moved) continue;
+
+    check.start = base;
+    check.end = base + size;
+    check.hit_end = 0;
+    rte_memseg_list_walk(map_msl_overlap, &check);
+    if (check.hit_end) {
+      base = check.hit_end;
+      moved = true;
+    }
+  } while (moved);
+
+  return base;
+}
+
 int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
   struct mt_map_mgr* mgr = mt_get_map_mgr(impl);
   void* start = item->vaddr;
@@ -17,8 +76,6 @@ int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
   struct mt_map_item* i_item;
   void* i_start;
   void* i_end;
-  mtl_iova_t iova_base = 0x10000; /* assume user IOVA start from 1M */
-  mtl_iova_t iova_end;
 
   mt_pthread_mutex_lock(&mgr->mutex);
 
@@ -38,11 +95,13 @@ int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
       mt_pthread_mutex_unlock(&mgr->mutex);
       return -EINVAL;
     }
-    /* simply set iova_base to max iova in previous item */
-    iova_end = i_item->iova + i_item->size;
-    if (iova_end > iova_base) iova_base = iova_end;
   }
-  item->iova = iova_base;
+  item->iova = map_find_iova(mgr, item->size);
+  if (item->iova == MTL_BAD_IOVA) {
+    err("%s, no free iova for size %" PRIu64 "\n", __func__, item->size);
+    mt_pthread_mutex_unlock(&mgr->mutex);
+    return -ENOMEM;
+  }
 
   /* find empty slot and insert */
   for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
@@ -56,6 +115,7 @@ int mt_map_add(struct mtl_main_impl* impl, struct mt_map_item* item) {
     }
     *i_item = *item;
     mgr->items[i] = i_item;
+    if (item->iova + item->size > mgr->iova_end) mgr->iova_end = item->iova + item->size;
     mt_pthread_mutex_unlock(&mgr->mutex);
     info("%s(%d), start %p end %p iova 0x%" PRIx64 "\n", __func__, i, start, end,
          i_item->iova);
@@ -256,7 +316,7 @@ static int dma_hw_start(struct mtl_main_impl* impl, struct mt_dma_dev* dev,
   return dma_copy_test(impl, &dev->lenders[0], 0, 32);
 }
 
-static int dma_hw_stop(struct mt_dma_dev* dev) {
+static int dma_hw_stop(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
   int16_t dev_id = dev->dev_id;
   int ret, idx = dev->idx;
 
@@ -266,6 +326,350 @@ static int dma_hw_stop(struct mt_dma_dev* dev) {
   return 0;
 }
 
+static int dma_hw_copy(struct mt_dma_dev* dev, rte_iova_t dst, rte_iova_t src,
+                       uint32_t length) {
+  return rte_dma_copy(dev->dev_id, 0, src, dst, length, 0);
+}
+
+static int dma_hw_fill(struct mt_dma_dev* dev, rte_iova_t dst, uint64_t pattern,
+                       uint32_t length) {
+  return rte_dma_fill(dev->dev_id, 0, pattern, dst, length, 0);
+}
+
+static int dma_hw_submit(struct mt_dma_dev* dev) {
+  return rte_dma_submit(dev->dev_id, 0);
+}
+
+static uint16_t dma_hw_completed(struct mt_dma_dev* dev, uint16_t nb_cpls) {
+  return rte_dma_completed(dev->dev_id, 0, nb_cpls, NULL, NULL);
+}
+
+static int dma_hw_stat(struct mt_dma_dev* dev, uint64_t avg_nb_inflight) {
+  int16_t dev_id = dev->dev_id;
+  struct rte_dma_stats stats;
+
+  rte_dma_stats_get(dev_id, 0, &stats);
+  rte_dma_stats_reset(dev_id, 0);
+  notice("DMA(%d), s %" PRIu64 " c %" PRIu64 " e %" PRIu64 " avg q %" PRIu64 "\n",
+         dev->idx, stats.submitted, stats.completed, stats.errors, avg_nb_inflight);
+
+  return 0;
+}
+
+/* the iova to va for cpu engine */
+static inline void* dma_cpu_iova2va(struct mt_dma_dev* dev, rte_iova_t iova) {
+  struct mt_map_mgr* map_mgr = dev->map_mgr;
+  struct mt_map_item* item;
+
+  /* the iova from mtl_dma_map, no lock as app never unmap a buffer in use */
+  if (map_mgr && (iova >= MT_MAP_IOVA_BASE) && (iova < map_mgr->iova_end)) {
+    for (int i = 0; i < MT_MAP_MAX_ITEMS; i++) {
+      item = map_mgr->items[i];
+      if (!item) continue;
+      if ((iova >= item->iova) && (iova < (item->iova + item->size)))
+        return item->vaddr + (iova - item->iova);
+    }
+  }
+
+  /* not a mapped user iova, cpu engine is enabled only for RTE_IOVA_VA */
+  return (void*)(uintptr_t)iova;
+}
+
+static int dma_cpu_copy(struct mt_dma_dev* dev, rte_iova_t dst, rte_iova_t src,
+                       uint32_t length) {
+  struct mt_dma_cpu_desc* desc;
+
+  if ((dev->cpu_enq_idx - dev->cpu_cpl_idx) > dev->cpu_desc_mask) return -ENOSPC;
+
+  desc = &dev->cpu_descs[dev->cpu_enq_idx & dev->cpu_desc_mask];
+  desc->dst = dma_cpu_iova2va(dev, dst);
+  desc->src = dma_cpu_iova2va(dev, src);
+  desc->len = length;
+  desc->fill = false;
+  return (uint16_t)(dev->cpu_enq_idx++);
+}
+
+static int dma_cpu_fill(struct mt_dma_dev* dev, rte_iova_t dst, uint64_t pattern,
+                       uint32_t length) {
+  struct mt_dma_cpu_desc* desc;
+
+  if ((dev->cpu_enq_idx - dev->cpu_cpl_idx) > dev->cpu_desc_mask) return -ENOSPC;
+
+  desc = &dev->cpu_descs[dev->cpu_enq_idx & dev->cpu_desc_mask];
+  desc->dst = dma_cpu_iova2va(dev, dst);
+  desc->src = NULL;
+  desc->pattern = pattern;
+  desc->len = length;
+  desc->fill = true;
+  return (uint16_t)(dev->cpu_enq_idx++);
+}
+
+static int dma_cpu_submit(struct mt_dma_dev* dev) {
+  /* make the descs visible before the index */
+  rte_smp_wmb();
+  dev->stat_cpu_submitted += dev->cpu_enq_idx - dev->cpu_sub_idx;
+  dev->cpu_sub_idx = dev->cpu_enq_idx;
+  return 0;
+}
+
+static uint16_t dma_cpu_completed(struct mt_dma_dev* dev, uint16_t nb_cpls) {
+  uint32_t done = dev->cpu_done_idx;
+  uint32_t nb;
+
+  rte_smp_rmb();
+  nb = done - dev->cpu_cpl_idx;
+  if (nb > nb_cpls) nb = nb_cpls;
+  dev->cpu_cpl_idx += nb;
+  dev->stat_cpu_completed += nb;
+  return nb;
+}
+
+static int dma_cpu_stat(struct mt_dma_dev* dev, uint64_t avg_nb_inflight) {
+  notice("DMA(%d), cpu s %" PRIu64 " c %" PRIu64 " avg q %" PRIu64 "\n", dev->idx,
+         dev->stat_cpu_submitted, dev->stat_cpu_completed, avg_nb_inflight);
+  dev->stat_cpu_submitted = 0;
+  dev->stat_cpu_completed = 0;
+  return 0;
+}
+
+#ifdef MTL_HAS_AVX512
+MT_TARGET_CODE_START_AVX512
+static void dma_cpu_copy_nt_avx512(void* dst, const void* src, uint32_t len) {
+  uint32_t head = (64 - ((uintptr_t)dst & 63)) & 63;
+
+  /* align the dst to cache line for the streaming store */
+  if (head > len) head = len;
+  if (head) {
+    rte_memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    len -= head;
+  }
+  while (len >= 64) {
+    __m512i v = _mm512_loadu_si512(src);
+    _mm512_stream_si512((__m512i*)dst, v);
+    dst += 64;
+    src += 64;
+    len -= 64;
+  }
+  if (len) rte_memcpy(dst, src, len);
+}
+MT_TARGET_CODE_STOP
+#endif
+
+static void dma_cpu_copy_nt(void* dst, const void* src, uint32_t len) {
+  uint32_t head = (16 - ((uintptr_t)dst & 15)) & 15;
+
+  if (head > len) head = len;
+  if (head) {
+    rte_memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    len -= head;
+  }
+  while (len >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)src);
+    _mm_stream_si128((__m128i*)dst, v);
+    dst += 16;
+    src += 16;
+    len -= 16;
+  }
+  if (len) rte_memcpy(dst, src, len);
+}
+
+static void dma_cpu_fill_pattern(void* dst, uint64_t pattern, uint32_t len) {
+  uint32_t i;
+
+  for (i = 0; i + 8 <= len; i += 8) *(uint64_t*)(dst + i) = pattern;
+  if (i < len) rte_memcpy(dst + i, &pattern, len - i);
+}
+
+static int dma_cpu_engine_func(void* arg) {
+  struct mt_dma_mgr* mgr = arg;
+  struct mt_dma_dev* dev;
+  struct mt_dma_cpu_desc* descs;
+  struct mt_dma_cpu_desc* desc;
+  uint32_t done, sub, end;
+
+  info("%s, start on lcore %u simd_512 %s\n", __func__, rte_lcore_id(),
+       mgr->cpu_simd_512 ? "yes" : "no");
+  while (!rte_atomic32_read(&mgr->cpu_engine_stop)) {
+    for (int i = mgr->num_hw_dma_dev; i < mgr->num_dma_dev; i++) {
+      dev = &mgr->devs[i];
+      descs = dev->cpu_descs;
+      if (!descs) continue;
+      done = dev->cpu_done_idx;
+      sub = dev->cpu_sub_idx;
+      if (done == sub) continue;
+      rte_smp_rmb();
+
+      /* burst for the fairness between devs */
+      end = done + RTE_MIN(sub - done, MT_DMA_CPU_BURST_SIZE);
+      for (; done != end; done++) {
+        desc = &descs[done & dev->cpu_desc_mask];
+        if (desc->fill) {
+          dma_cpu_fill_pattern(desc->dst, desc->pattern, desc->len);
+          continue;
+        }
+#ifdef MTL_HAS_AVX512
+        if (mgr->cpu_simd_512) {
+          dma_cpu_copy_nt_avx512(desc->dst, desc->src, desc->len);
+          continue;
+        }
+#endif
+        dma_cpu_copy_nt(desc->dst, desc->src, desc->len);
+      }
+      /* drain the non-temporal stores before publish */
+      rte_wmb();
+      dev->cpu_done_idx = done;
+    }
+    rte_atomic32_inc(&mgr->cpu_engine_loop);
+  }
+
+  rte_atomic32_set(&mgr->cpu_engine_stopped, 1);
+  info("%s, stop\n", __func__);
+  return 0;
+}
+
+static int dma_cpu_lcore_start(struct mtl_main_impl* impl, struct mt_dma_mgr* mgr) {
+  unsigned int lcore;
+  int ret;
+
+  ret = mt_dev_get_lcore(impl, &lcore);
+  if (ret < 0) {
+    err("%s, get lcore fail %d\n", __func__, ret);
+    return ret;
+  }
+
+  rte_atomic32_set(&mgr->cpu_engine_stop, 0);
+  rte_atomic32_set(&mgr->cpu_engine_stopped, 0);
+  ret = rte_eal_remote_launch(dma_cpu_engine_func, mgr, lcore);
+  if (ret < 0) {
+    err("%s, launch fail %d\n", __func__, ret);
+    mt_dev_put_lcore(impl, lcore);
+    return ret;
+  }
+  mgr->cpu_lcore = lcore;
+  mgr->has_cpu_lcore = true;
+
+  return 0;
+}
+
+static int dma_cpu_lcore_stop(struct mtl_main_impl* impl, struct mt_dma_mgr* mgr) {
+  if (!mgr->has_cpu_lcore) return 0;
+
+  rte_atomic32_set(&mgr->cpu_engine_stop, 1);
+  rte_eal_wait_lcore(mgr->cpu_lcore);
+  mt_dev_put_lcore(impl, mgr->cpu_lcore);
+  mgr->has_cpu_lcore = false;
+
+  return 0;
+}
+
+/* wait until the helper lcore leaves the removed dev */
+static void dma_cpu_engine_sync(struct mt_dma_mgr* mgr) {
+  uint32_t loop = rte_atomic32_read(&mgr->cpu_engine_loop);
+
+  if (!mgr->has_cpu_lcore) return;
+  while (((uint32_t)rte_atomic32_read(&mgr->cpu_engine_loop) - loop) < 2) {
+    if (rte_atomic32_read(&mgr->cpu_engine_stopped)) break;
+    rte_pause();
+  }
+}
+
+static int dma_cpu_stop(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
+  struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
+  struct mt_dma_cpu_desc* descs = dev->cpu_descs;
+
+  if (!descs) return 0;
+
+  dev->cpu_descs = NULL;
+  dma_cpu_engine_sync(mgr);
+  mt_rte_free(descs);
+
+  mgr->cpu_engine_users--;
+  if (!mgr->cpu_engine_users) dma_cpu_lcore_stop(impl, mgr);
+  return 0;
+}
+
+static int dma_cpu_start(struct mtl_main_impl* impl, struct mt_dma_dev* dev,
+                        uint16_t nb_desc) {
+  struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
+  uint32_t nb = rte_align32pow2(nb_desc);
+  struct mt_dma_cpu_desc* descs;
+  int ret, idx = dev->idx;
+
+  descs = mt_rte_zmalloc_socket(sizeof(*descs) * nb, dev->soc_id);
+  if (!descs) {
+    err("%s(%d), descs malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  dev->cpu_desc_mask = nb - 1;
+  dev->cpu_enq_idx = 0;
+  dev->cpu_cpl_idx = 0;
+  dev->cpu_sub_idx = 0;
+  dev->cpu_done_idx = 0;
+  dev->stat_cpu_submitted = 0;
+  dev->stat_cpu_completed = 0;
+  /* publish the descs to helper lcore at last */
+  rte_smp_wmb();
+  dev->cpu_descs = descs;
+
+  if (!mgr->cpu_engine_users) {
+    ret = dma_cpu_lcore_start(impl, mgr);
+    if (ret < 0) {
+      dev->cpu_descs = NULL;
+      mt_rte_free(descs);
+      return ret;
+    }
+  }
+  mgr->cpu_engine_users++;
+
+  /* perform the copy ops check */
+  ret = dma_copy_test(impl, &dev->lenders[0], 0, 32);
+  if (ret < 0) {
+    dma_cpu_stop(impl, dev);
+    return ret;
+  }
+
+  return 0;
+}
+
+struct dma_engine_ops {
+  int (*start)(struct mtl_main_impl* impl, struct mt_dma_dev* dev, uint16_t nb_desc);
+  int (*stop)(struct mtl_main_impl* impl, struct mt_dma_dev* dev);
+  int (*copy)(struct mt_dma_dev* dev, rte_iova_t dst, rte_iova_t src, uint32_t length);
+  int (*fill)(struct mt_dma_dev* dev, rte_iova_t dst, uint64_t pattern, uint32_t length);
+  int (*submit)(struct mt_dma_dev* dev);
+  uint16_t (*completed)(struct mt_dma_dev* dev, uint16_t nb_cpls);
+  int (*stat)(struct mt_dma_dev* dev, uint64_t avg_nb_inflight);
+};
+
+static const struct dma_engine_ops dma_engines[MT_DMA_ENGINE_MAX] = {
+    [MT_DMA_ENGINE_HW] =
+        {
+            .start = dma_hw_start,
+            .stop = dma_hw_stop,
+            .copy = dma_hw_copy,
+            .fill = dma_hw_fill,
+            .submit = dma_hw_submit,
+            .completed = dma_hw_completed,
+            .stat = dma_hw_stat,
+        },
+    [MT_DMA_ENGINE_CPU] =
+        {
+            .start = dma_cpu_start,
+            .stop = dma_cpu_stop,
+            .copy = dma_cpu_copy,
+            .fill = dma_cpu_fill,
+            .submit = dma_cpu_submit,
+            .completed = dma_cpu_completed,
+            .stat = dma_cpu_stat,
+        },
+};
+
+static const char* dma_engine_names[MT_DMA_ENGINE_MAX] = {"hw", "cpu"};
+
 static int dma_sw_init(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
   int idx = dev->idx;
 #if MT_DMA_RTE_RING
@@ -326,21 +730,14 @@ static int dma_sw_uinit(struct mt_dma_dev* dev) {
 }
 
 static int dma_stat(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
-  int16_t dev_id = dev->dev_id;
-  int idx = dev->idx;
-  struct rte_dma_stats stats;
   uint64_t avg_nb_inflight = 0;
 
-  rte_dma_stats_get(dev_id, 0, &stats);
-  rte_dma_stats_reset(dev_id, 0);
   if (dev->stat_commit_sum)
     avg_nb_inflight = dev->stat_inflight_sum / dev->stat_commit_sum;
   dev->stat_inflight_sum = 0;
   dev->stat_commit_sum = 0;
-  notice("DMA(%d), s %" PRIu64 " c %" PRIu64 " e %" PRIu64 " avg q %" PRIu64 "\n", idx,
-         stats.submitted, stats.completed, stats.errors, avg_nb_inflight);
 
-  return 0;
+  return dma_engines[dev->engine].stat(dev, avg_nb_inflight);
 }
 
 static int dma_free(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
@@ -349,29 +746,28 @@ static int dma_free(struct mtl_main_impl* impl, struct mt_dma_dev* dev) {
     return -EIO;
   }
 
-  dma_hw_stop(dev);
+  dma_engines[dev->engine].stop(impl, dev);
   dma_sw_uinit(dev);
   dev->active = false;
 
   return 0;
 }
 
-struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
-                                              struct mt_dma_request_req* req) {
+static struct mtl_dma_lender_dev* dma_request_dev(struct mtl_main_impl* impl,
+                                                  struct mt_dma_request_req* req,
+                                                  enum mt_dma_engine engine) {
   struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
   struct mt_dma_dev* dev;
   struct mtl_dma_lender_dev* lender_dev;
   int idx, ret;
 
-  if (!mgr->num_dma_dev) return NULL;
-
   uint16_t nb_desc = req->nb_desc;
   if (!nb_desc) nb_desc = 128;
 
-  mt_pthread_mutex_lock(&mgr->mutex);
   /* first try to find a shared dma */
   for (idx = 0; idx < MTL_DMA_DEV_MAX; idx++) {
     dev = &mgr->devs[idx];
+    if (dev->engine != engine) continue;
     if (dev->active && (dev->sch_idx == req->sch_idx) &&
         (dev->soc_id == req->socket_id) && (dev->nb_session < dev->max_shared)) {
       for (int render = 0; render < dev->max_shared; render++) {
@@ -382,8 +778,8 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
           lender_dev->priv = req->priv;
           lender_dev->cb = req->drop_mbuf_cb;
           dev->nb_session++;
-          mt_pthread_mutex_unlock(&mgr->mutex);
-          info("%s(%d), shared dma with id %u\n", __func__, idx, render);
+          info("%s(%d), shared %s dma with id %u\n", __func__, idx,
+               dma_engine_names[engine], render);
           return lender_dev;
         }
       }
@@ -392,10 +788,12 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
   /* now try to create a new dma */
   for (idx = 0; idx < MTL_DMA_DEV_MAX; idx++) {
     dev = &mgr->devs[idx];
+    if (dev->engine != engine) continue;
     if (dev->usable && !dev->active && (dev->soc_id == req->socket_id)) {
-      ret = dma_hw_start(impl, dev, nb_desc);
+      ret = dma_engines[engine].start(impl, dev, nb_desc);
       if (ret < 0) {
-        err("%s(%d), dma hw start fail %d\n", __func__, idx, ret);
+        err("%s(%d), dma %s start fail %d\n", __func__, idx, dma_engine_names[engine],
+            ret);
         dev->usable = false; /* mark to un-usable */
         continue;
       }
@@ -405,7 +803,7 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
       ret = dma_sw_init(impl, dev);
       if (ret < 0) {
         err("%s(%d), dma sw init fail %d\n", __func__, idx, ret);
-        dma_hw_stop(dev);
+        dma_engines[engine].stop(impl, dev);
         continue;
       }
       lender_dev = &dev->lenders[0];
@@ -416,18 +814,34 @@ struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
       dev->nb_session++;
       dev->active = true;
       rte_atomic32_inc(&mgr->num_dma_dev_active);
-      mt_pthread_mutex_unlock(&mgr->mutex);
-      info("%s(%d), dma created with max share %u nb_desc %u\n", __func__, idx,
-           dev->max_shared, dev->nb_desc);
+      info("%s(%d), %s dma created with max share %u nb_desc %u\n", __func__, idx,
+           dma_engine_names[engine], dev->max_shared, dev->nb_desc);
       return lender_dev;
     }
   }
-  mt_pthread_mutex_unlock(&mgr->mutex);
 
-  err("%s, fail to find free dev\n", __func__);
   return NULL;
 }
 
+struct mtl_dma_lender_dev* mt_dma_request_dev(struct mtl_main_impl* impl,
+                                              struct mt_dma_request_req* req) {
+  struct mt_dma_mgr* mgr = mt_get_dma_mgr(impl);
+  struct mtl_dma_lender_dev* lender_dev = NULL;
+
+  if (!mgr->num_dma_dev) return NULL;
+
+  mt_pthread_mutex_lock(&mgr->mutex);
+  /* prefer the hw engine, the cpu engine is the fallback */
+  for (int engine = 0; engine < MT_DMA_ENGINE_MAX; engine++) {
+    lender_dev = dma_request_dev(impl, req, engine);
+    if (lender_dev) break;
+  }
+  mt_pthread_mutex_unlock(&mgr->mutex);
+
+  if (!lender_dev) err("%s, fail to find free dev\n", __func__);
+  return lender_dev;
+}
+
 int mt_dma_free_dev(struct mtl_main_impl* impl, struct mtl_dma_lender_dev* dev) {
   struct mt_dma_dev* dma_dev = dev->parent;
   int idx = dev->lender_id;
@@ -439,6 +853,7 @@ int mt_dma_free_dev(struct mtl_main_impl* impl, struct mtl_dma_lender_dev* dev)
     return -EIO;
   }
 
+  mt_pthread_mutex_lock(&mgr->mutex);
   dev->active = false;
   dev->cb = NULL;
   dma_dev->nb_session--;
@@ -447,6 +862,7 @@ int mt_dma_free_dev(struct mtl_main_impl* impl, struct mtl_dma_lender_dev* dev)
     dma_free(impl, dma_dev);
     rte_atomic32_dec(&mgr->num_dma_dev_active);
   }
+  mt_pthread_mutex_unlock(&mgr->mutex);
 
   info("%s(%d,%d), nb_session now %u\n", __func__, dma_idx, idx, dma_dev->nb_session);
   return 0;
@@ -455,26 +871,26 @@ int mt_dma_free_dev(struct mtl_main_impl* impl, struct mtl_dma_lender_dev* dev)
 int mt_dma_copy(struct mtl_dma_lender_dev* dev, rte_iova_t dst, rte_iova_t src,
                 uint32_t length) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_copy(dma_dev->dev_id, 0, src, dst, length, 0);
+  return dma_engines[dma_dev->engine].copy(dma_dev, dst, src, length);
 }
 
 int mt_dma_fill(struct mtl_dma_lender_dev* dev, rte_iova_t dst, uint64_t pattern,
                 uint32_t length) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_fill(dma_dev->dev_id, 0, pattern, dst, length, 0);
+  return dma_engines[dma_dev->engine].fill(dma_dev, dst, pattern, length);
 }
 
 int mt_dma_submit(struct mtl_dma_lender_dev* dev) {
   struct mt_dma_dev* dma_dev = dev->parent;
   dma_dev->stat_commit_sum++;
   dma_dev->stat_inflight_sum += dma_dev->nb_inflight;
-  return rte_dma_submit(dma_dev->dev_id, 0);
+  return dma_engines[dma_dev->engine].submit(dma_dev);
 }
 
 uint16_t mt_dma_completed(struct mtl_dma_lender_dev* dev, uint16_t nb_cpls,
                           uint16_t* last_idx, bool* has_error) {
   struct mt_dma_dev* dma_dev = dev->parent;
-  return rte_dma_completed(dma_dev->dev_id, 0, nb_cpls, NULL, NULL);
+  return dma_engines[dma_dev->engine].completed(dma_dev, nb_cpls);
 }
 
 int mt_dma_borrow_mbuf(struct mtl_dma_lender_dev* dev, struct rte_mbuf* mbuf) {
@@ -529,9 +945,16 @@ int mt_dma_init(struct mtl_main_impl* impl) {
 
   idx = 0;
   RTE_DMA_FOREACH_DEV(dev_id) {
+    if (idx >= MTL_DMA_DEV_MAX) break;
     rte_dma_info_get(dev_id, &dev_info);
     if (!mt_is_valid_socket(impl, dev_info.numa_node)) continue;
+    if (!(dev_info.dev_capa & RTE_DMA_CAPA_MEM_TO_MEM)) {
+      warn("%s, dma dev id %u name %s no mem to mem capa\n", __func__, dev_id,
+           dev_info.dev_name);
+      continue;
+    }
     dev = &mgr->devs[idx];
+    dev->engine = MT_DMA_ENGINE_HW;
     dev->dev_id = dev_id;
     dev->soc_id = dev_info.numa_node;
     dev->usable = true;
@@ -547,6 +970,48 @@ int mt_dma_init(struct mtl_main_impl* impl) {
     }
     idx++;
   }
+  mgr->num_hw_dma_dev = idx;
+
+  /* the cpu engine, one dev for each socket */
+  if (mt_has_dma_cpu_engine(impl)) {
+    if (impl->iova_mode == RTE_IOVA_VA) {
+      mgr->cpu_simd_512 = false;
+#ifdef MTL_HAS_AVX512
+      if (mtl_get_simd_level() >= MTL_SIMD_LEVEL_AVX512) mgr->cpu_simd_512 = true;
+#endif
+      for (int port = 0; port < mt_num_ports(impl); port++) {
+        int soc_id = mt_socket_id(impl, port);
+        bool exist = false;
+
+        for (int i = mgr->num_hw_dma_dev; i < idx; i++) {
+          if (mgr->devs[i].soc_id == soc_id) exist = true;
+        }
+        if (exist) continue;
+        if (idx >= MTL_DMA_DEV_MAX) {
+          warn("%s, no space for cpu engine on socket %d\n", __func__, soc_id);
+          break;
+        }
+        dev = &mgr->devs[idx];
+        dev->engine = MT_DMA_ENGINE_CPU;
+        dev->dev_id = -1;
+        dev->soc_id = soc_id;
+        dev->usable = true;
+        dev->nb_session = 0;
+        dev->map_mgr = &impl->map_mgr;
+        info("%s(%d), cpu dma engine on socket %d simd_512 %s\n", __func__, idx, soc_id,
+             mgr->cpu_simd_512 ? "yes" : "no");
+        for (int render = 0; render < MT_DMA_MAX_SESSIONS; render++) {
+          lender_dev = &dev->lenders[render];
+          lender_dev->parent = dev;
+          lender_dev->lender_id = render;
+          lender_dev->active = false;
+        }
+        idx++;
+      }
+    } else {
+      warn("%s, cpu dma engine only for iova va mode\n", __func__);
+    }
+  }
   mgr->num_dma_dev = idx;
 
   return 0;
@@ -28,6 +28,7 @@ enum mt_handle_type {
   MT_ST22_HANDLE_DEV_ENCODE = 27,
   MT_ST22_HANDLE_DEV_DECODE = 28,
   MT_ST20_HANDLE_DEV_CONVERT = 29,
+  MT_ST_HANDLE_PLUGIN_JOB = 30,
 
   MT_HANDLE_UDMA = 40,
   MT_HANDLE_UDP = 41,
@@ -48,4 +49,11 @@ struct mt_udp_hdr {
   struct rte_udp_hdr udp;   /* size: 8 */
 } __attribute__((__packed__)) __rte_aligned(2);
 
+/* total size: 62 */
+struct mt_udp_hdr6 {
+  struct rte_ether_hdr eth; /* size: 14 */
+  struct rte_ipv6_hdr ipv6; /* size: 40 */
+  struct rte_udp_hdr udp;   /* size: 8 */
+} __attribute__((__packed__)) __rte_aligned(2);
+
 #endif
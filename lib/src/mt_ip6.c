@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_ip6.h"
+
+#include <string.h>
+
+bool mt_ip6_is_zero(const uint8_t* addr) {
+  for (int i = 0; i < MT_IP6_LEN; i++) {
+    if (addr[i]) return false;
+  }
+  return true;
+}
+
+bool mt_ip6_is_multicast(const uint8_t* addr) {
+  return addr[0] == 0xff;
+}
+
+bool mt_ip6_equal(const uint8_t* a, const uint8_t* b) {
+  return !memcmp(a, b, MT_IP6_LEN);
+}
+
+/* fe80::/64 with the modified EUI-64 interface id of the mac */
+void mt_ip6_link_local(const uint8_t* mac, uint8_t* addr) {
+  memset(addr, 0, MT_IP6_LEN);
+  addr[0] = 0xfe;
+  addr[1] = 0x80;
+  addr[8] = mac[0] ^ 0x02;
+  addr[9] = mac[1];
+  addr[10] = mac[2];
+  addr[11] = 0xff;
+  addr[12] = 0xfe;
+  addr[13] = mac[3];
+  addr[14] = mac[4];
+  addr[15] = mac[5];
+}
+
+/* the solicited-node group ff02::1:ffxx:xxxx of the low 24 bits */
+void mt_ip6_sn_addr(const uint8_t* addr, uint8_t* sn) {
+  memset(sn, 0, MT_IP6_LEN);
+  sn[0] = 0xff;
+  sn[1] = 0x02;
+  sn[11] = 0x01;
+  sn[12] = 0xff;
+  sn[13] = addr[13];
+  sn[14] = addr[14];
+  sn[15] = addr[15];
+}
+
+bool mt_ip6_is_sn_of(const uint8_t* dst, const uint8_t* addr) {
+  uint8_t sn[MT_IP6_LEN];
+
+  mt_ip6_sn_addr(addr, sn);
+  return mt_ip6_equal(dst, sn);
+}
+
+/* the multicast mac, 33:33 + the low 32 bits */
+void mt_ip6_mcast_mac(const uint8_t* addr, uint8_t* mac) {
+  mac[0] = 0x33;
+  mac[1] = 0x33;
+  memcpy(&mac[2], &addr[12], 4);
+}
+
+/*
+ * RFC 4861 7.1.1 and 7.2.3, a NS for target is only ours if it's sent to the
+ * solicited-node group of target or to target itself. The DAD probe(unspecified
+ * source) is always sent to the solicited-node group.
+ */
+bool mt_ip6_ns_dst_valid(const uint8_t* dst, const uint8_t* target, bool dad) {
+  if (mt_ip6_is_sn_of(dst, target)) return true;
+  if (dad) return false;
+  return mt_ip6_equal(dst, target);
+}
@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+/* the IPv6 address helpers of the NDP and the IPv6 sessions, on the raw 16 bytes addr */
+
+#ifndef _MT_LIB_IP6_HEAD_H_
+#define _MT_LIB_IP6_HEAD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MT_IP6_LEN (16)
+#define MT_IP6_MAC_LEN (6)
+
+bool mt_ip6_is_zero(const uint8_t* addr);
+
+bool mt_ip6_is_multicast(const uint8_t* addr);
+
+bool mt_ip6_equal(const uint8_t* a, const uint8_t* b);
+
+/* fe80::/64 with the modified EUI-64 interface id of the mac */
+void mt_ip6_link_local(const uint8_t* mac, uint8_t* addr);
+
+/* the solicited-node group ff02::1:ffxx:xxxx of the low 24 bits */
+void mt_ip6_sn_addr(const uint8_t* addr, uint8_t* sn);
+
+bool mt_ip6_is_sn_of(const uint8_t* dst, const uint8_t* addr);
+
+/* the multicast mac, 33:33 + the low 32 bits */
+void mt_ip6_mcast_mac(const uint8_t* addr, uint8_t* mac);
+
+/* RFC 4861 7.2.3, a NS is only ours if sent to the sn group of target or target */
+bool mt_ip6_ns_dst_valid(const uint8_t* dst, const uint8_t* target, bool dad);
+
+#endif
@@ -12,10 +12,12 @@
 #include "mt_dma.h"
 #include "mt_log.h"
 #include "mt_mcast.h"
+#include "mt_ndp.h"
 #include "mt_ptp.h"
 #include "mt_sch.h"
 #include "mt_socket.h"
 #include "mt_stat.h"
+#include "mt_state.h"
 #include "mt_util.h"
 #include "st2110/pipeline/st_plugin.h"
 #include "st2110/st_ancillary_transmitter.h"
@@ -132,6 +134,7 @@ static int st_rx_anc_uinit(struct mtl_main_impl* impl) {
 }
 
 static int mt_main_create(struct mtl_main_impl* impl) {
+  bool tsc_restored;
   int ret;
 
   ret = mt_dev_create(impl);
@@ -160,6 +163,15 @@ static int mt_main_create(struct mtl_main_impl* impl) {
     return ret;
   }
 
+  ret = mt_ndp_init(impl);
+  if (ret < 0) {
+    err("%s, mt_ndp_init fail %d\n", __func__, ret);
+    return ret;
+  }
+
+  /* warm restart, before the ptp and cni start to use the restored servo and arp */
+  tsc_restored = mt_state_load(impl);
+
   ret = mt_ptp_init(impl);
   if (ret < 0) {
     err("%s, mt_ptp_init fail %d\n", __func__, ret);
@@ -196,7 +208,8 @@ static int mt_main_create(struct mtl_main_impl* impl) {
     return ret;
   }
 
-  pthread_create(&impl->tsc_cal_tid, NULL, mt_calibrate_tsc, impl);
+  /* no calibration if the tsc of last run is restored */
+  if (!tsc_restored) pthread_create(&impl->tsc_cal_tid, NULL, mt_calibrate_tsc, impl);
 
   info("%s, succ\n", __func__);
   return 0;
@@ -208,11 +221,13 @@ static int mt_main_free(struct mtl_main_impl* impl) {
     impl->tsc_cal_tid = 0;
   }
 
+  mt_state_save(impl);
   mt_config_uinit(impl);
   st_plugins_uinit(impl);
   mt_admin_uinit(impl);
   mt_cni_uinit(impl);
   mt_ptp_uinit(impl);
+  mt_ndp_uinit(impl);
   mt_arp_uinit(impl);
   mt_mcast_uinit(impl);
 
@@ -307,7 +322,8 @@ static int mt_user_params_check(struct mtl_init_params* p) {
   }
 
   for (int i = 0; i < num_ports; i++) {
-    if (p->pmd[i] != MTL_PMD_DPDK_USER) continue;
+    /* af_xdp use the ip of kernel interface */
+    if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) continue;
     ip = p->sip_addr[i];
     ret = mt_ip_addr_check(ip);
     if (ret < 0) {
@@ -316,8 +332,8 @@ static int mt_user_params_check(struct mtl_init_params* p) {
     }
   }
 
-  if ((num_ports > 1) && (p->pmd[0] == MTL_PMD_DPDK_USER) &&
-      (p->pmd[1] == MTL_PMD_DPDK_USER)) {
+  if ((num_ports > 1) && (p->pmd[0] != MTL_PMD_DPDK_AF_XDP) &&
+      (p->pmd[1] != MTL_PMD_DPDK_AF_XDP)) {
     if (0 == memcmp(p->sip_addr[0], p->sip_addr[1], MTL_IP_ADDR_LEN)) {
       ip = p->sip_addr[0];
       err("%s, same %d.%d.%d.%d for both ip\n", __func__, ip[0], ip[1], ip[2], ip[3]);
@@ -372,9 +388,11 @@ mtl_handle mtl_init(struct mtl_init_params* p) {
 #ifdef MTL_HAS_ASAN
   mt_asan_init();
 #endif
+  mt_crc32c_init();
 
   RTE_BUILD_BUG_ON(MT_SESSION_PORT_MAX > (int)MTL_PORT_MAX);
   RTE_BUILD_BUG_ON(sizeof(struct mt_udp_hdr) != 42);
+  RTE_BUILD_BUG_ON(sizeof(struct mt_udp_hdr6) != 62);
 
   ret = mt_user_params_check(p);
   if (ret < 0) {
@@ -404,12 +422,14 @@ mtl_handle mtl_init(struct mtl_init_params* p) {
   int numa_nodes = 0;
   if (numa_available() >= 0) numa_nodes = numa_max_node() + 1;
   if ((p->flags & MTL_FLAG_BIND_NUMA) && (numa_nodes > 1)) {
-    /* bind current thread and its children to socket node */
+    /* bind current thread and its children to the socket nodes of all ports */
     struct bitmask* mask = numa_bitmask_alloc(numa_nodes);
 
-    info("%s, bind to socket %d, numa_nodes %d\n", __func__, socket[MTL_PORT_P],
-         numa_nodes);
-    numa_bitmask_setbit(mask, socket[MTL_PORT_P]);
+    for (int i = 0; i < num_ports; i++) {
+      info("%s, bind to socket %d for port %d, numa_nodes %d\n", __func__, socket[i], i,
+           numa_nodes);
+      numa_bitmask_setbit(mask, socket[i]);
+    }
     numa_bind(mask);
     numa_bitmask_free(mask);
   }
@@ -426,7 +446,7 @@ mtl_handle mtl_init(struct mtl_init_params* p) {
   rte_memcpy(&impl->kport_info, &kport_info, sizeof(kport_info));
   impl->type = MT_HANDLE_MAIN;
   for (int i = 0; i < num_ports; i++) {
-    if (p->pmd[i] != MTL_PMD_DPDK_USER) {
+    if (p->pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       uint8_t if_ip[MTL_IP_ADDR_LEN];
       ret = mt_socket_get_if_ip(impl->user_para.port[i], if_ip);
       if (ret < 0) {
@@ -938,6 +958,27 @@ int mtl_sch_enable_sleep(mtl_handle mt, int sch_idx, bool enable) {
   return 0;
 }
 
+int mtl_sch_get_stats(mtl_handle mt, int sch_idx, struct mtl_sch_stats* stats) {
+  struct mtl_main_impl* impl = mt;
+
+  if ((sch_idx < 0) || (sch_idx >= MT_MAX_SCH_NUM)) {
+    err("%s, invalid sch_idx %d\n", __func__, sch_idx);
+    return -EINVAL;
+  }
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return -EIO;
+  }
+
+  struct mt_sch_impl* sch = mt_sch_instance(impl, sch_idx);
+  if (!mt_sch_is_active(sch)) {
+    dbg("%s(%d), not allocated\n", __func__, sch_idx);
+    return -ENODEV;
+  }
+
+  return mt_sch_get_stats(sch, stats);
+}
+
 int mtl_sch_set_sleep_us(mtl_handle mt, uint64_t us) {
   struct mtl_main_impl* impl = mt;
 
@@ -951,6 +992,22 @@ int mtl_sch_set_sleep_us(mtl_handle mt, uint64_t us) {
   return 0;
 }
 
+int mtl_state_save(mtl_handle mt) {
+  struct mtl_main_impl* impl = mt;
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return -EIO;
+  }
+
+  if (!mt_get_user_params(impl)->state_file) {
+    err("%s, no state_file\n", __func__);
+    return -EINVAL;
+  }
+
+  return mt_state_save(impl);
+}
+
 uint64_t mtl_ptp_read_time(mtl_handle mt) {
   struct mtl_main_impl* impl = mt;
 
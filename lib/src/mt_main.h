@@ -8,6 +8,8 @@
 #include <rte_arp.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
+#include <rte_hash_crc.h>
+#include <rte_random.h>
 #ifdef MTL_HAS_KNI
 #include <rte_kni.h>
 #endif
@@ -39,18 +41,35 @@
 /* max RL items */
 #define MT_MAX_RL_ITEMS (64)
 
-#define MT_ARP_ENTRY_MAX (60)
+/* arp cache, hashed into buckets with MT_ARP_BUCKET_WAYS entries each */
+#define MT_ARP_BUCKET_NUM (64) /* power of 2 */
+#define MT_ARP_BUCKET_WAYS (4)
+#define MT_ARP_ENTRY_MAX (MT_ARP_BUCKET_NUM * MT_ARP_BUCKET_WAYS)
+/* the overflow entries shared by all buckets, used when all ways of a bucket are busy */
+#define MT_ARP_OVERFLOW_NUM (64)
 
-#define MT_MCAST_GROUP_MAX (60)
+/* mcast group hash table, groups are chained in the bucket so no cap on the number */
+#define MT_MCAST_HASH_SIZE (256) /* power of 2 */
+/* max source filters(SSM) for one group */
+#define MT_MCAST_SOURCE_MAX (8)
 
 #define MT_DMA_MAX_SESSIONS (16)
 /* if use rte ring for dma enqueue/dequeue */
 #define MT_DMA_RTE_RING (1)
+/* max copies for one dev in one loop of the cpu dma engine */
+#define MT_DMA_CPU_BURST_SIZE (64)
 
 #define MT_MAP_MAX_ITEMS (256)
+/* the iova of mtl_dma_map start from here, assume user IOVA start from 64k */
+#define MT_MAP_IOVA_BASE (0x10000)
 
 #define MT_IP_DONT_FRAGMENT_FLAG (0x0040)
 
+/* memif port name: memif:<server|client>:<id> */
+#define MT_MEMIF_PORT_PREFIX "memif:"
+/* the unix socket shared by all memif ports on the host */
+#define MT_MEMIF_SOCKET "/run/mtl_memif.sock"
+
 /* Port supports Rx queue setup after device started. */
 #define MT_IF_FEATURE_RUNTIME_RX_QUEUE (MTL_BIT32(0))
 /* Timesync enabled on the port */
@@ -63,6 +82,8 @@
 #define MT_IF_FEATURE_TX_OFFLOAD_IPV4_CKSUM (MTL_BIT32(5))
 /* Rx queue support hdr split */
 #define MT_IF_FEATURE_RXQ_OFFLOAD_BUFFER_SPLIT (MTL_BIT32(6))
+/* tx udp checksum offload */
+#define MT_IF_FEATURE_TX_OFFLOAD_UDP_CKSUM (MTL_BIT32(7))
 
 #define MT_IF_STAT_PORT_CONFIGED (MTL_BIT32(0))
 #define MT_IF_STAT_PORT_STARTED (MTL_BIT32(1))
@@ -100,6 +121,7 @@ enum mt_port_type {
   MT_PORT_VF,
   MT_PORT_PF,
   MT_PORT_AF_XDP,
+  MT_PORT_MEMIF,
 };
 
 enum mt_driver_type {
@@ -110,6 +132,7 @@ enum mt_driver_type {
   MT_DRV_AF_XDP,    /* af xdp, net_af_xdp */
   MT_DRV_E1000_IGB, /* e1000 igb, net_e1000_igb */
   MT_DRV_IGC,       /* igc, net_igc */
+  MT_DRV_MEMIF,     /* memif, net_memif */
 };
 
 enum mt_ptp_l_mode {
@@ -169,6 +192,9 @@ struct mt_ptp_impl {
   double coefficient_result_min;
   double coefficient_result_max;
   int32_t coefficient_result_cnt;
+  /* warm restart, used as the first result if the master is not changed, 0 if none */
+  double restored_coefficient;
+  struct mt_ptp_clock_id restored_master;
 
   /* status */
   int64_t stat_delta_min;
@@ -222,18 +248,145 @@ struct mt_cni_impl {
 #endif
 };
 
+enum mt_arp_state {
+  MT_ARP_STATE_FREE = 0,
+  MT_ARP_STATE_PENDING, /* request sent, wait the reply */
+  MT_ARP_STATE_READY,
+};
+
+struct mt_arp_entry {
+  uint32_t ip;
+  enum mt_arp_state state;
+  struct rte_ether_addr ea;
+  uint64_t update_ns;  /* last reply time */
+  uint64_t request_ns; /* last request time, 0 means not sent yet */
+  uint64_t access_ns;  /* last lookup time, for lru evict and refresh */
+  uint32_t retry;
+};
+
+/* async resolve done callback, called with the arp mutex held */
+typedef void (*mt_arp_cb_t)(void* priv, enum mtl_port port, uint32_t ip,
+                            struct rte_ether_addr* ea, int result);
+
+struct mt_arp_waiter {
+  uint32_t ip;
+  mt_arp_cb_t cb;
+  void* priv;
+  uint64_t expire_ns; /* 0 means no timeout */
+  /* linked list */
+  MT_TAILQ_ENTRY(mt_arp_waiter) next;
+};
+
+MT_TAILQ_HEAD(mt_arp_waiters_list, mt_arp_waiter);
+
 struct mt_arp_impl {
-  pthread_mutex_t mutex; /* entry protect */
-  uint32_t ip[MT_ARP_ENTRY_MAX];
-  struct rte_ether_addr ea[MT_ARP_ENTRY_MAX];
-  rte_atomic32_t mac_ready[MT_ARP_ENTRY_MAX];
+  struct mtl_main_impl* parnet;
+  enum mtl_port port;
+  pthread_mutex_t mutex; /* entry and waiter protect */
+  /* MT_ARP_BUCKET_NUM buckets then the MT_ARP_OVERFLOW_NUM overflow entries */
+  struct mt_arp_entry entries[MT_ARP_ENTRY_MAX + MT_ARP_OVERFLOW_NUM];
+  int entry_cnt;
+  int overflow_cnt;
+  struct mt_arp_waiters_list waiters;
+  bool timer_active;
+  /* stat */
+  uint32_t stat_request;
+  uint32_t stat_evict;
+  uint32_t stat_overflow;
 };
 
+#define MT_NDP_ADDR_MAX (2) /* link-local and the optional global address */
+#define MT_NDP_ENTRY_MAX (32)
+
+/* the neighbor cache entry, same states as arp */
+struct mt_ndp_entry {
+  uint8_t ip[MTL_IP6_ADDR_LEN];
+  enum mt_arp_state state;
+  struct rte_ether_addr ea;
+  uint64_t request_ns; /* last NS time, 0 means not sent yet */
+  uint64_t access_ns;  /* last lookup time, for lru evict */
+  uint32_t retry;
+};
+
+/* async resolve done callback, called with the ndp mutex held */
+typedef void (*mt_ndp_cb_t)(void* priv, enum mtl_port port, const uint8_t* ip,
+                            struct rte_ether_addr* ea, int result);
+
+struct mt_ndp_waiter {
+  uint8_t ip[MTL_IP6_ADDR_LEN];
+  mt_ndp_cb_t cb;
+  void* priv;
+  uint64_t expire_ns; /* 0 means no timeout */
+  /* linked list */
+  MT_TAILQ_ENTRY(mt_ndp_waiter) next;
+};
+
+MT_TAILQ_HEAD(mt_ndp_waiters_list, mt_ndp_waiter);
+
+struct mt_ndp_impl {
+  struct mtl_main_impl* parnet;
+  enum mtl_port port;
+  uint8_t addr[MT_NDP_ADDR_MAX][MTL_IP6_ADDR_LEN];
+  /* solicited-node multicast mac of each address */
+  struct rte_ether_addr sn_mac[MT_NDP_ADDR_MAX];
+  bool sn_joined[MT_NDP_ADDR_MAX];
+  int addr_num;
+  pthread_mutex_t mutex; /* entry and waiter protect */
+  struct mt_ndp_entry entries[MT_NDP_ENTRY_MAX];
+  int entry_cnt;
+  struct mt_ndp_waiters_list waiters;
+  bool timer_active;
+  /* stat */
+  uint32_t stat_ns;
+  uint32_t stat_na;
+  uint32_t stat_ns_sent;
+  uint32_t stat_na_recv;
+};
+
+struct mt_mcast_src {
+  uint32_t ip;
+  uint32_t ref_cnt;
+};
+
+struct mt_mcast_group {
+  uint32_t ip;
+  /* users of any source, the group is in EXCLUDE{} mode if not zero */
+  uint32_t asm_ref_cnt;
+  /* source filters, used in INCLUDE{srcs} mode if no any source user */
+  struct mt_mcast_src srcs[MT_MCAST_SOURCE_MAX];
+  uint16_t src_num;
+  /* linked list */
+  MT_TAILQ_ENTRY(mt_mcast_group) next;
+};
+
+MT_TAILQ_HEAD(mt_mcast_group_list, mt_mcast_group);
+
+/* one pending state change record, RFC3376 - 5.1 */
+struct mt_mcast_delta {
+  uint32_t group;
+  uint8_t type; /* enum mcast_group_record_type */
+  uint32_t srcs[MT_MCAST_SOURCE_MAX];
+  uint16_t src_num;
+  int retrans; /* remaining transmissions */
+  /* linked list */
+  MT_TAILQ_ENTRY(mt_mcast_delta) next;
+};
+
+MT_TAILQ_HEAD(mt_mcast_delta_list, mt_mcast_delta);
+
 struct mt_mcast_impl {
+  struct mtl_main_impl* parnet;
+  enum mtl_port port;
   pthread_mutex_t group_mutex;
-  uint32_t group_ip[MT_MCAST_GROUP_MAX];
-  uint32_t group_ref_cnt[MT_MCAST_GROUP_MAX];
-  uint16_t group_num;
+  struct mt_mcast_group_list groups[MT_MCAST_HASH_SIZE];
+  uint32_t group_num;
+  /* pending state change records, flushed by the report alarm */
+  struct mt_mcast_delta_list deltas;
+  bool report_active;
+  uint64_t last_report_ns;
+  /* stat */
+  uint32_t stat_state_change_pkts;
+  uint32_t stat_current_state_pkts;
 };
 
 #define MT_TASKLET_HAS_PENDING (1)
@@ -261,6 +414,11 @@ struct mt_sch_tasklet_ops {
    * leave to zero if you don't know.
    */
   uint64_t advice_sleep_us;
+  /*
+   * all the work is driven by the rx queues added with mt_sch_add_rx_intr, the
+   * advice_sleep_us is skipped when the rx interrupt is armed.
+   */
+  bool intr_rx;
 };
 
 struct mt_sch_tasklet_impl {
@@ -287,11 +445,15 @@ typedef uint64_t mt_sch_mask_t;
 /* all sch */
 #define MT_SCH_MASK_ALL ((mt_sch_mask_t)-1)
 
+/* rx queues of one sch for the hybrid rx interrupt */
+MT_TAILQ_HEAD(mt_rx_intr_queues, mt_rx_queue);
+
 struct mt_sch_impl {
   pthread_mutex_t mutex; /* protect sch context */
   struct mt_sch_tasklet_impl* tasklet[MT_MAX_TASKLET_PER_SCH];
   int max_tasklet_idx; /* max tasklet index */
   unsigned int lcore;
+  int socket_id;      /* numa socket the sch serves, the lcore is chosen on it */
   bool run_in_thread; /* Run the tasklet inside one thread instead of a pinned lcore. */
   pthread_t tid;      /* thread id for run_in_thread */
 
@@ -328,11 +490,40 @@ struct mt_sch_impl {
   float sleep_ratio_score;
   uint64_t sleep_ratio_start_ns;
   uint64_t sleep_ratio_sleep_ns;
+  /* the sch busy ratio, measured by the tasklet loop time with pending work */
+  float busy_ratio_score;
+  uint64_t busy_ratio_start_ns;
+  uint64_t busy_ratio_busy_ns;
 
   uint64_t stat_sleep_ns;
   uint32_t stat_sleep_cnt;
   uint64_t stat_sleep_ns_min;
   uint64_t stat_sleep_ns_max;
+
+  /* elastic pool, continuous admin periods above high or below low */
+  int elastic_high_cnt;
+  int elastic_low_cnt;
+
+  /* hybrid rx interrupt, only for MTL_FLAG_RX_INTR */
+  pthread_mutex_t intr_mutex; /* protect intr_queues */
+  struct mt_rx_intr_queues intr_queues;
+  int intr_poll_q_num; /* queues without rx interrupt, intr sleep is not possible */
+  int intr_epfd;
+  int intr_wake_fd; /* eventfd to wake the intr sleep */
+  struct rte_epoll_event intr_wake_ev;
+  bool intr_armed;
+  uint64_t stat_intr_sleep_cnt;
+  uint64_t stat_intr_wake_cnt;
+  uint64_t stat_intr_timeout_cnt;
+  uint64_t stat_intr_wake_ns_sum;
+  uint64_t stat_intr_wake_ns_max;
+};
+
+struct mt_sch_elastic {
+  int max_lcores; /* 0 means no limit */
+  float busy_high;
+  float busy_low;
+  int periods;
 };
 
 struct mt_sch_mgr {
@@ -340,6 +531,10 @@ struct mt_sch_mgr {
   /* active sch cnt */
   rte_atomic32_t sch_cnt;
   pthread_mutex_t mgr_mutex; /* protect sch mgr */
+  struct mt_sch_elastic elastic; /* only for MTL_FLAG_SCH_ELASTIC */
+  uint64_t rx_intr_idle_ns;       /* only for MTL_FLAG_RX_INTR */
+  uint32_t stat_spawn;
+  uint32_t stat_retire;
 };
 
 struct mt_pacing_train_result {
@@ -356,6 +551,7 @@ struct mt_rl_shaper {
 struct mt_rx_flow {
   uint8_t dip_addr[MTL_IP_ADDR_LEN]; /* rx destination IP */
   uint8_t sip_addr[MTL_IP_ADDR_LEN]; /* source IP */
+  uint8_t ssm_addr[MTL_IP_ADDR_LEN]; /* the only source allowed for a mcast dip */
   uint16_t dst_port;                 /* udp destination port */
   int flow_id;                       /* flow id in the eth tool */
   bool port_flow;                    /* if apply port flow */
@@ -364,6 +560,15 @@ struct mt_rx_flow {
 #ifdef ST_HAS_DPDK_HDR_SPLIT /* rte_eth_hdrs_mbuf_callback_fn define with this marco */
   rte_eth_hdrs_mbuf_callback_fn hdr_split_mbuf_cb;
 #endif
+  /* ipv6 flow, from the unicast sender src6_addr to dst6_addr of this port */
+  bool ipv6;
+  uint8_t src6_addr[MTL_IP6_ADDR_LEN];
+  uint8_t dst6_addr[MTL_IP6_ADDR_LEN];
+};
+
+struct mt_rx_delay_pkt {
+  struct rte_mbuf* pkt;
+  uint64_t release_ns;
 };
 
 struct mt_rx_queue {
@@ -377,6 +582,28 @@ struct mt_rx_queue {
   unsigned int mbuf_elements;
   /* pool for hdr split payload */
   struct rte_mempool* mbuf_payload_pool;
+  /* stat for the polls which return no pkt, xsk rx ring empty for af_xdp */
+  uint64_t stat_burst_empty;
+  /* software flow filter for memif, no rte_flow */
+  const struct rte_eth_rxtx_callback* filter_cb;
+  uint64_t stat_filter_drop;
+  /* rx impairment callback for memif */
+  const struct rte_eth_rxtx_callback* impair_cb;
+  struct mtl_memif_params* impair;
+  /* pkts held by the jitter impairment, released on the later polls */
+  struct mt_rx_delay_pkt* delay_q;
+  uint32_t delay_head; /* next to release */
+  uint32_t delay_tail; /* next to hold */
+  uint64_t delay_last_ns;
+  uint64_t stat_impair_drop;
+  uint64_t stat_impair_reorder;
+  uint64_t stat_impair_delay_us;
+  /* hybrid rx interrupt, only for MTL_FLAG_RX_INTR */
+  struct mt_sch_impl* intr_sch; /* the sch waits on this queue */
+  bool intr_capable;            /* the rx interrupt is attached */
+  bool intr_pkt_seen;           /* set by the rx burst, cleared by the idle check */
+  uint64_t intr_idle_ns;        /* last time pkt seen */
+  MT_TAILQ_ENTRY(mt_rx_queue) intr_next;
 };
 
 struct mt_tx_queue {
@@ -386,6 +613,8 @@ struct mt_tx_queue {
   bool active;
   int rl_shapers_mapping; /* map to tx_rl_shapers */
   uint64_t bps;           /* bytes per sec for rate limit */
+  /* stat for the bursts which not all sent, xsk tx ring full for af_xdp */
+  uint64_t stat_burst_full;
 };
 
 struct mt_interface {
@@ -400,6 +629,7 @@ struct mt_interface {
   struct rte_ether_addr* mcast_mac_lists; /* pool of multicast mac addrs */
   uint32_t mcast_nb;                      /* number of address */
   uint32_t status;                        /* MT_IF_STAT_* */
+  bool rx_intr;                           /* rx queue interrupt configured */
 
   /* default tx mbuf_pool */
   struct rte_mempool* tx_mbuf_pool;
@@ -457,7 +687,23 @@ struct mtl_dma_lender_dev {
   mt_dma_drop_mbuf_cb cb;
 };
 
+enum mt_dma_engine {
+  MT_DMA_ENGINE_HW = 0, /* rte_dma dev, CBDMA(ioat) or DSA(idxd) */
+  MT_DMA_ENGINE_CPU,    /* cpu copy with non-temporal store on a helper lcore */
+  MT_DMA_ENGINE_MAX,
+};
+
+/* copy descriptor for the cpu engine */
+struct mt_dma_cpu_desc {
+  void* dst;
+  const void* src;
+  uint64_t pattern;
+  uint32_t len;
+  bool fill;
+};
+
 struct mt_dma_dev {
+  enum mt_dma_engine engine;
   int16_t dev_id;
   uint16_t nb_desc;
   bool active;
@@ -479,13 +725,34 @@ struct mt_dma_dev {
 #endif
   uint64_t stat_inflight_sum;
   uint64_t stat_commit_sum;
+
+  /* cpu engine only, single producer(session) and single consumer(helper lcore) */
+  struct mt_dma_cpu_desc* cpu_descs;
+  uint32_t cpu_desc_mask;
+  uint32_t cpu_enq_idx;           /* producer private */
+  uint32_t cpu_cpl_idx;           /* producer private */
+  volatile uint32_t cpu_sub_idx;  /* published by producer in submit */
+  volatile uint32_t cpu_done_idx; /* published by helper lcore */
+  struct mt_map_mgr* map_mgr;     /* for the user iova of mtl_dma_map */
+  uint64_t stat_cpu_submitted;
+  uint64_t stat_cpu_completed;
 };
 
 struct mt_dma_mgr {
   struct mt_dma_dev devs[MTL_DMA_DEV_MAX];
   pthread_mutex_t mutex; /* protect devs */
   uint8_t num_dma_dev;
+  uint8_t num_hw_dma_dev; /* hw devs first, then cpu devs */
   rte_atomic32_t num_dma_dev_active;
+
+  /* the helper lcore for cpu engine */
+  bool cpu_simd_512; /* avx512 non-temporal store */
+  int cpu_engine_users;
+  unsigned int cpu_lcore;
+  bool has_cpu_lcore;
+  rte_atomic32_t cpu_engine_stop;
+  rte_atomic32_t cpu_engine_stopped;
+  rte_atomic32_t cpu_engine_loop; /* loop counter for the dev remove sync */
 };
 
 struct mtl_dma_mem {
@@ -503,6 +770,8 @@ struct mt_admin {
   pthread_cond_t admin_wake_cond;
   pthread_mutex_t admin_wake_mutex;
   rte_atomic32_t admin_stop;
+  int cooldown; /* periods to skip the rebalance */
+  uint32_t stat_migrate;
 };
 
 struct mt_kport_info {
@@ -519,6 +788,7 @@ struct mt_map_item {
 struct mt_map_mgr {
   pthread_mutex_t mutex;
   struct mt_map_item* items[MT_MAP_MAX_ITEMS];
+  mtl_iova_t iova_end; /* the max iova end ever mapped */
 };
 
 struct mt_var_params {
@@ -586,6 +856,9 @@ struct mtl_main_impl {
   /* arp context */
   struct mt_arp_impl arp[MTL_PORT_MAX];
 
+  /* ipv6 neighbor discovery context */
+  struct mt_ndp_impl ndp[MTL_PORT_MAX];
+
   /* mcast context */
   struct mt_mcast_impl mcast[MTL_PORT_MAX];
 
@@ -679,10 +952,17 @@ static inline enum mtl_pmd_type mt_pmd_type(struct mtl_main_impl* impl,
 }
 
 static inline bool mt_pmd_is_kernel(struct mtl_main_impl* impl, enum mtl_port port) {
-  if (MTL_PMD_DPDK_USER == mt_get_user_params(impl)->pmd[port])
-    return false;
+  if (MTL_PMD_DPDK_AF_XDP == mt_get_user_params(impl)->pmd[port])
+    return true;
   else
+    return false;
+}
+
+static inline bool mt_pmd_is_memif(struct mtl_main_impl* impl, enum mtl_port port) {
+  if (MTL_PMD_DPDK_MEMIF == mt_get_user_params(impl)->pmd[port])
     return true;
+  else
+    return false;
 }
 
 static inline bool mt_pmd_is_af_xdp(struct mtl_main_impl* impl, enum mtl_port port) {
@@ -723,6 +1003,22 @@ static inline bool mt_has_af_xdp_zc(struct mtl_main_impl* impl) {
     return true;
 }
 
+static inline bool mt_has_af_xdp_shared_umem(struct mtl_main_impl* impl,
+                                             enum mtl_port port) {
+  if (mt_pmd_is_af_xdp(impl, port) &&
+      (mt_get_user_params(impl)->flags & MTL_FLAG_AF_XDP_SHARED_UMEM))
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_af_xdp_busy_poll(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE)
+    return false;
+  else
+    return true;
+}
+
 static inline bool mt_has_user_ptp(struct mtl_main_impl* impl) {
   if (mt_get_user_params(impl)->ptp_get_time_fn)
     return true;
@@ -737,6 +1033,27 @@ static inline bool mt_has_user_quota(struct mtl_main_impl* impl) {
     return false;
 }
 
+static inline bool mt_has_dma_cpu_engine(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_DMA_CPU_ENGINE)
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_sch_elastic(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_SCH_ELASTIC)
+    return true;
+  else
+    return false;
+}
+
+static inline bool mt_has_rx_intr(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_RX_INTR)
+    return true;
+  else
+    return false;
+}
+
 static inline bool mt_has_ebu(struct mtl_main_impl* impl) {
   if (mt_get_user_params(impl)->flags & MTL_FLAG_RX_VIDEO_EBU)
     return true;
@@ -765,6 +1082,13 @@ static inline bool mt_has_rx_video_migrate(struct mtl_main_impl* impl) {
     return false;
 }
 
+static inline bool mt_has_tx_video_fec_test_drop(struct mtl_main_impl* impl) {
+  if (mt_get_user_params(impl)->flags & MTL_FLAG_TX_VIDEO_FEC_TEST_DROP)
+    return true;
+  else
+    return false;
+}
+
 static inline bool mt_has_tasklet_time_measure(struct mtl_main_impl* impl) {
   if (mt_get_user_params(impl)->flags & MTL_FLAG_TASKLET_TIME_MEASURE)
     return true;
@@ -822,6 +1146,14 @@ static inline bool mt_if_has_offload_ipv4_cksum(struct mtl_main_impl* impl,
     return false;
 }
 
+static inline bool mt_if_has_offload_udp_cksum(struct mtl_main_impl* impl,
+                                               enum mtl_port port) {
+  if (mt_if(impl, port)->feature & MT_IF_FEATURE_TX_OFFLOAD_UDP_CKSUM)
+    return true;
+  else
+    return false;
+}
+
 static inline bool mt_if_has_chain_buff(struct mtl_main_impl* impl, enum mtl_port port) {
   if (mt_if(impl, port)->feature & MT_IF_FEATURE_TX_MULTI_SEGS)
     return true;
@@ -937,6 +1269,25 @@ static inline void mt_mbuf_init_ipv4(struct rte_mbuf* pkt) {
 #endif
 }
 
+static inline void mt_mbuf_init_ipv6(struct rte_mbuf* pkt) {
+  pkt->l2_len = sizeof(struct rte_ether_hdr); /* 14 */
+  pkt->l3_len = sizeof(struct rte_ipv6_hdr);  /* 40 */
+#if RTE_VERSION >= RTE_VERSION_NUM(21, 11, 0, 0)
+  pkt->ol_flags |= RTE_MBUF_F_TX_IPV6;
+#else
+  pkt->ol_flags |= PKT_TX_IPV6;
+#endif
+}
+
+/* the nic fills the udp cksum, the udp hdr should carry the pseudo hdr cksum */
+static inline void mt_mbuf_init_udp_cksum(struct rte_mbuf* pkt) {
+#if RTE_VERSION >= RTE_VERSION_NUM(21, 11, 0, 0)
+  pkt->ol_flags |= RTE_MBUF_F_TX_UDP_CKSUM;
+#else
+  pkt->ol_flags |= PKT_TX_UDP_CKSUM;
+#endif
+}
+
 static inline uint64_t mt_timespec_to_ns(const struct timespec* ts) {
   return ((uint64_t)ts->tv_sec * NS_PER_S) + ts->tv_nsec;
 }
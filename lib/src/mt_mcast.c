@@ -4,6 +4,8 @@
 
 #include "mt_mcast.h"
 
+#include <rte_jhash.h>
+
 #include "mt_dev.h"
 #include "mt_log.h"
 #include "mt_socket.h"
@@ -17,7 +19,8 @@ static inline struct mt_mcast_impl* get_mcast(struct mtl_main_impl* impl,
 }
 
 /* Computing the Internet Checksum based on rfc1071 */
-static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t num) {
+static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg,
+                                   size_t report_len) {
   size_t size = 0;
 
   switch (type) {
@@ -25,8 +28,7 @@ static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t
       size = sizeof(struct mcast_mb_query_v3);
       break;
     case MEMBERSHIP_REPORT_V3:
-      size = (sizeof(struct mcast_mb_report_v3_wo_gr) +
-              num * sizeof(struct mcast_group_record));
+      size = report_len;
       break;
     default:
       err("%s, wrong mcast msg type: %d\n", __func__, type);
@@ -36,18 +38,6 @@ static uint16_t mcast_msg_checksum(enum mcast_msg_type type, void* msg, uint16_t
   return mt_rf1071_check_sum(msg, size, true);
 }
 
-/* group record shaping, refer to RFC3376 - 4.2.4 */
-static inline void mcast_create_group_record(uint32_t group_addr,
-                                             enum mcast_group_record_type type,
-                                             struct mcast_group_record* group_record) {
-  group_record->record_type = type;
-  group_record->aux_data_len = 0;
-  group_record->num_sources = 0;  // not specify source
-  group_record->multicast_addr = group_addr;
-  // group_record.source_addr = 0;
-  // group_record.auxiliary_data = 0;
-}
-
 /* 224.0.0.22 */
 static struct rte_ether_addr const mcast_mac_dst = {{0x01, 0x00, 0x5e, 0x00, 0x00, 0x16}};
 
@@ -120,32 +110,41 @@ int mcast_membership_general_query(struct mtl_main_impl* impl, enum mtl_port por
   return 0;
 }
 
+static inline struct mt_mcast_group_list* mcast_bucket(struct mt_mcast_impl* mcast,
+                                                       uint32_t group) {
+  return &mcast->groups[rte_jhash_1word(group, 0) & (MT_MCAST_HASH_SIZE - 1)];
+}
+
+static struct mt_mcast_group* mcast_group_find(struct mt_mcast_impl* mcast,
+                                               uint32_t group) {
+  struct mt_mcast_group* g;
+
+  MT_TAILQ_FOREACH(g, mcast_bucket(mcast, group), next) {
+    if (g->ip == group) return g;
+  }
+  return NULL;
+}
+
+static int mcast_group_src_idx(struct mt_mcast_group* g, uint32_t source) {
+  for (int i = 0; i < g->src_num; i++) {
+    if (g->srcs[i].ip == source) return i;
+  }
+  return -1;
+}
+
 /* membership report shaping, refer to RFC3376 - 4.2 */
-static int mcast_membership_report(struct mtl_main_impl* impl,
-                                   enum mcast_group_record_type type,
-                                   enum mtl_port port) {
-  struct mt_mcast_impl* mcast = get_mcast(impl, port);
-  uint16_t group_num = mcast->group_num;
+static struct rte_mbuf* mcast_report_alloc(struct mtl_main_impl* impl,
+                                           enum mtl_port port) {
   struct rte_mbuf* pkt;
   struct rte_ether_hdr* eth_hdr;
   struct rte_ipv4_hdr* ip_hdr;
   struct mcast_mb_report_v3_wo_gr* mb_report;
-  struct mcast_group_record* group_records;
   size_t hdr_offset = 0;
-  size_t mb_report_len = sizeof(struct mcast_mb_report_v3_wo_gr) +
-                         group_num * sizeof(struct mcast_group_record);
-
-  if (group_num <= 0) {
-    dbg("%s(%d), no group to join\n", __func__, port);
-    return 0;
-  }
-
-  dbg("%s(%d), group_num: %d\n", __func__, port, group_num);
 
   pkt = rte_pktmbuf_alloc(mt_get_tx_mempool(impl, port));
   if (!pkt) {
     err("%s, report packet alloc failed\n", __func__);
-    return -ENOMEM;
+    return NULL;
   }
 
   eth_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ether_hdr*, hdr_offset);
@@ -160,7 +159,6 @@ static int mcast_membership_report(struct mtl_main_impl* impl,
   ip_hdr->type_of_service = IP_IGMP_DSCP_VALUE;
   ip_hdr->fragment_offset = MT_IP_DONT_FRAGMENT_FLAG;
   ip_hdr->hdr_checksum = 0;
-  ip_hdr->total_length = htons(sizeof(struct rte_ipv4_hdr) + mb_report_len);
   ip_hdr->next_proto_id = IGMP_PROTOCOL;
   ip_hdr->src_addr = *(uint32_t*)mt_sip_addr(impl, port);
   inet_pton(AF_INET, IGMP_REPORT_IP, &ip_hdr->dst_addr);
@@ -171,41 +169,168 @@ static int mcast_membership_report(struct mtl_main_impl* impl,
   mb_report->reserved_1 = 0x00;
   mb_report->checksum = 0x00;
   mb_report->reserved_2 = 0x00;
-  mb_report->num_group_records = htons(group_num);
+  mb_report->num_group_records = 0;
   hdr_offset += sizeof(struct mcast_mb_report_v3_wo_gr);
-  group_records = rte_pktmbuf_mtod_offset(pkt, struct mcast_group_record*, hdr_offset);
-  for (int i = 0; i < group_num; i++) {
-    mcast_create_group_record(mcast->group_ip[i], type, &group_records[i]);
-  }
-  uint16_t checksum = mcast_msg_checksum(MEMBERSHIP_REPORT_V3, mb_report, group_num);
+
+  mt_mbuf_init_ipv4(pkt);
+  pkt->data_len = pkt->pkt_len = hdr_offset;
+  return pkt;
+}
+
+static inline struct mcast_mb_report_v3_wo_gr* mcast_report_hdr(struct rte_mbuf* pkt) {
+  return rte_pktmbuf_mtod_offset(pkt, struct mcast_mb_report_v3_wo_gr*,
+                                 pkt->l2_len + pkt->l3_len);
+}
+
+/* group record shaping, refer to RFC3376 - 4.2.4 */
+static int mcast_report_add_record(struct rte_mbuf* pkt, uint8_t type, uint32_t group,
+                                   uint32_t* srcs, uint16_t src_num) {
+  struct mcast_mb_report_v3_wo_gr* mb_report = mcast_report_hdr(pkt);
+  size_t report_len = pkt->data_len - pkt->l2_len - pkt->l3_len;
+  size_t record_len = sizeof(struct mcast_group_record) + src_num * sizeof(uint32_t);
+
+  if ((report_len + record_len) > IGMP_REPORT_MAX_LEN) return -ENOSPC;
+
+  struct mcast_group_record* record =
+      rte_pktmbuf_mtod_offset(pkt, struct mcast_group_record*, pkt->data_len);
+  record->record_type = type;
+  record->aux_data_len = 0;
+  record->num_sources = htons(src_num);
+  record->multicast_addr = group;
+  uint32_t* source_addr = (uint32_t*)(record + 1);
+  for (uint16_t i = 0; i < src_num; i++) source_addr[i] = srcs[i];
+
+  mb_report->num_group_records = htons(ntohs(mb_report->num_group_records) + 1);
+  pkt->data_len += record_len;
+  pkt->pkt_len = pkt->data_len;
+  return 0;
+}
+
+static int mcast_report_finish(struct rte_mbuf* pkt) {
+  struct mcast_mb_report_v3_wo_gr* mb_report = mcast_report_hdr(pkt);
+  struct rte_ipv4_hdr* ip_hdr =
+      rte_pktmbuf_mtod_offset(pkt, struct rte_ipv4_hdr*, pkt->l2_len);
+  size_t mb_report_len = pkt->data_len - pkt->l2_len - pkt->l3_len;
+
+  ip_hdr->total_length = htons(sizeof(struct rte_ipv4_hdr) + mb_report_len);
+  uint16_t checksum = mcast_msg_checksum(MEMBERSHIP_REPORT_V3, mb_report, mb_report_len);
   if (checksum <= 0) {
     err("%s, err checksum %d\n", __func__, checksum);
     return -EIO;
   }
   dbg("%s, checksum %d\n", __func__, checksum);
   mb_report->checksum = htons(checksum);
+  return 0;
+}
 
-  mt_mbuf_init_ipv4(pkt);
-  pkt->pkt_len = pkt->l2_len + pkt->l3_len + mb_report_len;
-  pkt->data_len = pkt->pkt_len;
+/* the report builder, split the records to multiple packets if exceeds one mtu */
+struct mcast_report_ctx {
+  struct mtl_main_impl* impl;
+  enum mtl_port port;
+  struct rte_mbuf* pkts[IGMP_REPORT_BURST];
+  uint16_t nb_pkts;
+  uint32_t sent;
+};
+
+static void mcast_report_flush(struct mcast_report_ctx* ctx) {
+  if (!ctx->nb_pkts) return;
 
 #ifdef MCAST_DEBUG
   /* send packet to kni for capturing */
-  struct mt_kni_impl* kni = &impl->kni;
-  struct rte_kni* rkni = kni->rkni[port];
-  if (rkni) rte_kni_tx_burst(rkni, (struct rte_mbuf**)&report_pkt, 1);
+  struct mt_kni_impl* kni = &ctx->impl->kni;
+  struct rte_kni* rkni = kni->rkni[ctx->port];
+  if (rkni) rte_kni_tx_burst(rkni, ctx->pkts, ctx->nb_pkts);
 #endif
 
-  uint16_t tx = mt_dev_tx_sys_queue_burst(impl, port, &pkt, 1);
-  if (tx < 1) {
-    err("%s, send pkt fail\n", __func__);
-    rte_pktmbuf_free(pkt);
-    return -EIO;
+  uint16_t tx = mt_dev_tx_sys_queue_burst(ctx->impl, ctx->port, ctx->pkts, ctx->nb_pkts);
+  if (tx < ctx->nb_pkts) {
+    err("%s(%d), send pkt fail, only %u of %u sent\n", __func__, ctx->port, tx,
+        ctx->nb_pkts);
+    rte_pktmbuf_free_bulk(&ctx->pkts[tx], ctx->nb_pkts - tx);
   }
+  ctx->sent += tx;
+  ctx->nb_pkts = 0;
+}
+
+static int mcast_report_ctx_add(struct mcast_report_ctx* ctx, uint8_t type,
+                                uint32_t group, uint32_t* srcs, uint16_t src_num) {
+  struct rte_mbuf* pkt = ctx->nb_pkts ? ctx->pkts[ctx->nb_pkts - 1] : NULL;
+  int ret;
+
+  if (pkt && !mcast_report_add_record(pkt, type, group, srcs, src_num)) return 0;
 
+  /* current packet full, finish it and start a new one */
+  if (pkt) {
+    ret = mcast_report_finish(pkt);
+    if (ret < 0) return ret;
+    /* burst full, send them out */
+    if (ctx->nb_pkts >= IGMP_REPORT_BURST) mcast_report_flush(ctx);
+  }
+  pkt = mcast_report_alloc(ctx->impl, ctx->port);
+  if (!pkt) return -ENOMEM;
+  ctx->pkts[ctx->nb_pkts++] = pkt;
+
+  return mcast_report_add_record(pkt, type, group, srcs, src_num);
+}
+
+static int mcast_report_ctx_done(struct mcast_report_ctx* ctx) {
+  int ret;
+
+  if (ctx->nb_pkts) {
+    ret = mcast_report_finish(ctx->pkts[ctx->nb_pkts - 1]);
+    if (ret < 0) {
+      rte_pktmbuf_free_bulk(ctx->pkts, ctx->nb_pkts);
+      ctx->nb_pkts = 0;
+      return ret;
+    }
+  }
+  mcast_report_flush(ctx);
   return 0;
 }
 
+/* current state report of all groups, refer to RFC3376 - 4.2.12 */
+static int mcast_membership_report(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_mcast_impl* mcast = get_mcast(impl, port);
+  struct mcast_report_ctx ctx;
+  struct mt_mcast_group* g;
+  uint32_t srcs[MT_MCAST_SOURCE_MAX];
+  int ret = 0;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.impl = impl;
+  ctx.port = port;
+
+  mt_pthread_mutex_lock(&mcast->group_mutex);
+  if (!mcast->group_num) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    dbg("%s(%d), no group to join\n", __func__, port);
+    return 0;
+  }
+  dbg("%s(%d), group_num: %u\n", __func__, port, mcast->group_num);
+  for (int i = 0; i < MT_MCAST_HASH_SIZE; i++) {
+    MT_TAILQ_FOREACH(g, &mcast->groups[i], next) {
+      if (g->asm_ref_cnt) {
+        ret = mcast_report_ctx_add(&ctx, MCAST_MODE_IS_EXCLUDE, g->ip, NULL, 0);
+      } else {
+        for (int j = 0; j < g->src_num; j++) srcs[j] = g->srcs[j].ip;
+        ret = mcast_report_ctx_add(&ctx, MCAST_MODE_IS_INCLUDE, g->ip, srcs, g->src_num);
+      }
+      if (ret < 0) break;
+    }
+    if (ret < 0) break;
+  }
+  mt_pthread_mutex_unlock(&mcast->group_mutex);
+
+  if (ret < 0) {
+    err("%s(%d), build report fail %d\n", __func__, port, ret);
+    rte_pktmbuf_free_bulk(ctx.pkts, ctx.nb_pkts);
+    return ret;
+  }
+  ret = mcast_report_ctx_done(&ctx);
+  mcast->stat_current_state_pkts += ctx.sent;
+  return ret;
+}
+
 static void mcast_membership_report_cb(void* param) {
   struct mtl_main_impl* impl = (struct mtl_main_impl*)param;
   int num_ports = mt_num_ports(impl);
@@ -213,7 +338,7 @@ static void mcast_membership_report_cb(void* param) {
 
   for (int port = 0; port < num_ports; port++) {
     if (!mt_pmd_is_kernel(impl, port)) {
-      ret = mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
+      ret = mcast_membership_report(impl, port);
       if (ret < 0) {
         err("%s(%d), mcast_membership_report fail %d\n", __func__, port, ret);
       }
@@ -224,6 +349,125 @@ static void mcast_membership_report_cb(void* param) {
   if (ret < 0) err("%s, set igmp alarm fail %d\n", __func__, ret);
 }
 
+/* send all the pending state change records in one burst, RFC3376 - 5.1 */
+static void mcast_state_change_cb(void* param) {
+  struct mt_mcast_impl* mcast = param;
+  struct mcast_report_ctx ctx;
+  struct mt_mcast_delta *delta, *tmp_delta;
+  int ret = 0;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.impl = mcast->parnet;
+  ctx.port = mcast->port;
+
+  mt_pthread_mutex_lock(&mcast->group_mutex);
+  MT_TAILQ_FOREACH(delta, &mcast->deltas, next) {
+    ret = mcast_report_ctx_add(&ctx, delta->type, delta->group, delta->srcs,
+                               delta->src_num);
+    if (ret < 0) break;
+  }
+  if (ret < 0) {
+    err("%s(%d), build report fail %d\n", __func__, mcast->port, ret);
+    rte_pktmbuf_free_bulk(ctx.pkts, ctx.nb_pkts);
+  } else {
+    mcast_report_ctx_done(&ctx);
+    mcast->stat_state_change_pkts += ctx.sent;
+    /* drop the records which reach the robustness count */
+    for (delta = MT_TAILQ_FIRST(&mcast->deltas); delta != NULL; delta = tmp_delta) {
+      tmp_delta = MT_TAILQ_NEXT(delta, next);
+      delta->retrans--;
+      if (delta->retrans > 0) continue;
+      MT_TAILQ_REMOVE(&mcast->deltas, delta, next);
+      mt_free(delta);
+    }
+  }
+  mcast->last_report_ns = mt_get_monotonic_time();
+
+  if (MT_TAILQ_FIRST(&mcast->deltas))
+    rte_eal_alarm_set(IGMP_STATE_CHANGE_INTERVAL_MS * US_PER_MS, mcast_state_change_cb,
+                      mcast);
+  else
+    mcast->report_active = false;
+  mt_pthread_mutex_unlock(&mcast->group_mutex);
+}
+
+/* arm the state change alarm, rate limited by IGMP_STATE_CHANGE_INTERVAL_MS */
+static void mcast_state_change_kick(struct mt_mcast_impl* mcast) {
+  uint64_t interval_ns = (uint64_t)IGMP_STATE_CHANGE_INTERVAL_MS * NS_PER_MS;
+  uint64_t delta_ns = mt_get_monotonic_time() - mcast->last_report_ns;
+  uint64_t delay_us = IGMP_STATE_CHANGE_DELAY_US;
+
+  if (mcast->report_active) return;
+
+  if (delta_ns < interval_ns)
+    delay_us = RTE_MAX(delay_us, (interval_ns - delta_ns) / NS_PER_US);
+  rte_eal_alarm_set(delay_us, mcast_state_change_cb, mcast);
+  mcast->report_active = true;
+}
+
+static void mcast_delta_remove_src(struct mt_mcast_delta* delta, uint32_t source) {
+  for (int i = 0; i < delta->src_num; i++) {
+    if (delta->srcs[i] != source) continue;
+    delta->srcs[i] = delta->srcs[delta->src_num - 1];
+    delta->src_num--;
+    return;
+  }
+}
+
+/*
+ * Queue a state change record. A filter mode change carries the full state so it
+ * supersedes all the pending records of the group, ALLOW and BLOCK of the same
+ * source cancel each other and the ones of the same type are merged.
+ */
+static int mcast_queue_delta(struct mt_mcast_impl* mcast, uint32_t group, uint8_t type,
+                             uint32_t* srcs, uint16_t src_num) {
+  struct mt_mcast_delta *delta, *tmp_delta, *merge = NULL;
+  bool mode_change =
+      (type == MCAST_CHANGE_TO_INCLUDE_MODE) || (type == MCAST_CHANGE_TO_EXCLUDE_MODE);
+  uint8_t opposite = (type == MCAST_ALLOW_NEW_SOURCES) ? MCAST_BLOCK_OLD_SOURCES
+                                                       : MCAST_ALLOW_NEW_SOURCES;
+
+  for (delta = MT_TAILQ_FIRST(&mcast->deltas); delta != NULL; delta = tmp_delta) {
+    tmp_delta = MT_TAILQ_NEXT(delta, next);
+    if (delta->group != group) continue;
+    if (mode_change) {
+      MT_TAILQ_REMOVE(&mcast->deltas, delta, next);
+      mt_free(delta);
+      continue;
+    }
+    if (delta->type == opposite) {
+      for (uint16_t i = 0; i < src_num; i++) mcast_delta_remove_src(delta, srcs[i]);
+      if (!delta->src_num) {
+        MT_TAILQ_REMOVE(&mcast->deltas, delta, next);
+        mt_free(delta);
+      }
+    } else if ((delta->type == type) &&
+               ((delta->src_num + src_num) <= MT_MCAST_SOURCE_MAX)) {
+      merge = delta;
+    }
+  }
+
+  if (merge) {
+    for (uint16_t i = 0; i < src_num; i++) merge->srcs[merge->src_num++] = srcs[i];
+    merge->retrans = IGMP_ROBUSTNESS;
+  } else {
+    delta = mt_zmalloc(sizeof(*delta));
+    if (!delta) {
+      err("%s(%d), delta malloc fail\n", __func__, mcast->port);
+      return -ENOMEM;
+    }
+    delta->group = group;
+    delta->type = type;
+    for (uint16_t i = 0; i < src_num; i++) delta->srcs[i] = srcs[i];
+    delta->src_num = src_num;
+    delta->retrans = IGMP_ROBUSTNESS;
+    MT_TAILQ_INSERT_TAIL(&mcast->deltas, delta, next);
+  }
+
+  mcast_state_change_kick(mcast);
+  return 0;
+}
+
 static int mcast_addr_pool_extend(struct mt_interface* inf) {
   struct rte_ether_addr* mc_list;
   size_t mc_list_size;
@@ -320,7 +564,11 @@ int mt_mcast_init(struct mtl_main_impl* impl) {
   for (int port = 0; port < MTL_PORT_MAX; ++port) {
     struct mt_mcast_impl* mcast = get_mcast(impl, port);
 
+    mcast->parnet = impl;
+    mcast->port = port;
     mt_pthread_mutex_init(&mcast->group_mutex, NULL);
+    for (int i = 0; i < MT_MCAST_HASH_SIZE; i++) MT_TAILQ_INIT(&mcast->groups[i]);
+    MT_TAILQ_INIT(&mcast->deltas);
   }
 
   ret = rte_eal_alarm_set(IGMP_JOIN_GROUP_PERIOD_US, mcast_membership_report_cb, impl);
@@ -332,45 +580,90 @@ int mt_mcast_init(struct mtl_main_impl* impl) {
 
 int mt_mcast_uinit(struct mtl_main_impl* impl) {
   int ret;
+  struct mt_mcast_group* g;
+  struct mt_mcast_delta* delta;
+
+  ret = rte_eal_alarm_cancel(mcast_membership_report_cb, impl);
+  if (ret < 0) err("%s, alarm cancel fail %d\n", __func__, ret);
 
   for (int port = 0; port < MTL_PORT_MAX; ++port) {
     struct mt_mcast_impl* mcast = get_mcast(impl, port);
 
+    rte_eal_alarm_cancel(mcast_state_change_cb, mcast);
+    mcast->report_active = false;
+    while ((delta = MT_TAILQ_FIRST(&mcast->deltas))) {
+      MT_TAILQ_REMOVE(&mcast->deltas, delta, next);
+      mt_free(delta);
+    }
+    for (int i = 0; i < MT_MCAST_HASH_SIZE; i++) {
+      while ((g = MT_TAILQ_FIRST(&mcast->groups[i]))) {
+        uint8_t* ip = (uint8_t*)&g->ip;
+        warn("%s(%d), group %d.%d.%d.%d still active\n", __func__, port, ip[0], ip[1],
+             ip[2], ip[3]);
+        MT_TAILQ_REMOVE(&mcast->groups[i], g, next);
+        mt_free(g);
+      }
+    }
+    mcast->group_num = 0;
+    if (mcast->stat_state_change_pkts || mcast->stat_current_state_pkts)
+      info("%s(%d), state change pkts %u, current state pkts %u\n", __func__, port,
+           mcast->stat_state_change_pkts, mcast->stat_current_state_pkts);
+
     mt_pthread_mutex_destroy(&mcast->group_mutex);
   }
 
-  ret = rte_eal_alarm_cancel(mcast_membership_report_cb, impl);
-  if (ret < 0) err("%s, alarm cancel fail %d\n", __func__, ret);
-
   info("%s, succ\n", __func__);
   return 0;
 }
 
-/* add a group address to the group ip list */
-int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port) {
+/* add a group address(with an optional source filter) to the group table */
+int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                  enum mtl_port port) {
   struct mt_mcast_impl* mcast = get_mcast(impl, port);
   struct rte_ether_addr mcast_mac;
   struct mt_interface* inf = mt_if(impl, port);
-  int group_num = mcast->group_num;
   uint8_t* ip = (uint8_t*)&group_addr;
+  uint8_t* src = (uint8_t*)&source_addr;
+  bool kernel = mt_pmd_is_kernel(impl, port);
+  struct mt_mcast_group* g;
   int ret;
 
-  if (group_num >= MT_MCAST_GROUP_MAX) {
-    err("%s, reach max multicast group number!\n", __func__);
-    return -EIO;
-  }
-
   mt_pthread_mutex_lock(&mcast->group_mutex);
-  for (int i = 0; i < group_num; ++i) {
-    if (mcast->group_ip[i] == group_addr) {
-      mcast->group_ref_cnt[i]++;
-      mt_pthread_mutex_unlock(&mcast->group_mutex);
-      info("%s(%d), group %d.%d.%d.%d ref cnt %u\n", __func__, port, ip[0], ip[1], ip[2],
-           ip[3], mcast->group_ref_cnt[i]);
-      return 0;
+  g = mcast_group_find(mcast, group_addr);
+  if (g) {
+    if (!source_addr) {
+      g->asm_ref_cnt++;
+      /* switch to EXCLUDE{} mode, receive from any source */
+      if ((g->asm_ref_cnt == 1) && !kernel)
+        mcast_queue_delta(mcast, group_addr, MCAST_CHANGE_TO_EXCLUDE_MODE, NULL, 0);
+    } else {
+      int idx = mcast_group_src_idx(g, source_addr);
+      if (idx >= 0) {
+        g->srcs[idx].ref_cnt++;
+      } else {
+        if (g->src_num >= MT_MCAST_SOURCE_MAX) {
+          mt_pthread_mutex_unlock(&mcast->group_mutex);
+          err("%s(%d), reach max source number for group %d.%d.%d.%d\n", __func__, port,
+              ip[0], ip[1], ip[2], ip[3]);
+          return -EIO;
+        }
+        g->srcs[g->src_num].ip = source_addr;
+        g->srcs[g->src_num].ref_cnt = 1;
+        g->src_num++;
+        /* no need to report in EXCLUDE{} mode as it has all the sources */
+        if (!g->asm_ref_cnt && !kernel)
+          mcast_queue_delta(mcast, group_addr, MCAST_ALLOW_NEW_SOURCES, &source_addr, 1);
+      }
     }
+    info("%s(%d), group %d.%d.%d.%d source %d.%d.%d.%d, asm ref cnt %u src num %u\n",
+         __func__, port, ip[0], ip[1], ip[2], ip[3], src[0], src[1], src[2], src[3],
+         g->asm_ref_cnt, g->src_num);
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    return 0;
   }
-  if (mt_pmd_is_kernel(impl, port)) {
+
+  if (kernel) {
+    /* the kernel autojoin is group based, no source filter */
     ret = mt_socket_join_mcast(impl, port, group_addr);
     if (ret < 0) {
       mt_pthread_mutex_unlock(&mcast->group_mutex);
@@ -379,59 +672,104 @@ int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port
       return ret;
     }
   }
-  mcast->group_ip[group_num] = group_addr;
-  mcast->group_ref_cnt[group_num] = 1;
+  g = mt_zmalloc(sizeof(*g));
+  if (!g) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    err("%s(%d), group malloc fail\n", __func__, port);
+    if (kernel) mt_socket_drop_mcast(impl, port, group_addr);
+    return -ENOMEM;
+  }
+  g->ip = group_addr;
+  if (source_addr) {
+    g->srcs[0].ip = source_addr;
+    g->srcs[0].ref_cnt = 1;
+    g->src_num = 1;
+  } else {
+    g->asm_ref_cnt = 1;
+  }
+  MT_TAILQ_INSERT_TAIL(mcast_bucket(mcast, group_addr), g, next);
   mcast->group_num++;
+  /* report to switch to join group */
+  if (!kernel) {
+    if (source_addr)
+      mcast_queue_delta(mcast, group_addr, MCAST_ALLOW_NEW_SOURCES, &source_addr, 1);
+    else
+      mcast_queue_delta(mcast, group_addr, MCAST_CHANGE_TO_EXCLUDE_MODE, NULL, 0);
+  }
   mt_pthread_mutex_unlock(&mcast->group_mutex);
 
   /* add mcast mac to interface */
   mt_mcast_ip_to_mac(ip, &mcast_mac);
   mcast_inf_add_mac(inf, &mcast_mac);
 
-  /* report to switch to join group */
-  if (!mt_pmd_is_kernel(impl, port)) {
-    mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
-  }
-
-  info("%s(%d), new group %d.%d.%d.%d\n", __func__, port, ip[0], ip[1], ip[2], ip[3]);
+  info("%s(%d), new group %d.%d.%d.%d source %d.%d.%d.%d\n", __func__, port, ip[0],
+       ip[1], ip[2], ip[3], src[0], src[1], src[2], src[3]);
   return 0;
 }
 
-/* not implement fast leave report for IGMPv3, just stop sending join report, */
-/* after a while the switch will delete the port in the multicast group */
-int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port) {
+/* drop a user of the group, send the leave(or block) report to the switch */
+int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                   enum mtl_port port) {
   struct mt_mcast_impl* mcast = get_mcast(impl, port);
-  int group_num = mcast->group_num;
   struct mt_interface* inf = mt_if(impl, port);
   uint8_t* ip = (uint8_t*)&group_addr;
   struct rte_ether_addr mcast_mac;
+  bool kernel = mt_pmd_is_kernel(impl, port);
+  struct mt_mcast_group* g;
+  uint32_t srcs[MT_MCAST_SOURCE_MAX];
 
   mt_pthread_mutex_lock(&mcast->group_mutex);
-  /* search the group ip list and delete the addr */
-  for (int i = 0; i < group_num; ++i) {
-    if (mcast->group_ip[i] == group_addr) {
-      dbg("%s, found group ip in the group list, delete it\n", __func__);
-      mcast->group_ref_cnt[i]--;
-      info("%s(%d), group %d.%d.%d.%d ref cnt %u\n", __func__, port, ip[0], ip[1], ip[2],
-           ip[3], mcast->group_ref_cnt[i]);
-      if (mcast->group_ref_cnt[i]) {
-        mt_pthread_mutex_unlock(&mcast->group_mutex);
-        return 0;
-      }
-      mcast->group_ip[i] = mcast->group_ip[group_num - 1];
-      mcast->group_num--;
-      if (mt_pmd_is_kernel(impl, port)) {
-        mt_socket_drop_mcast(impl, port, group_addr);
-      }
+  g = mcast_group_find(mcast, group_addr);
+  if (!g) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    warn("%s, group ip not found, nothing to delete\n", __func__);
+    return 0;
+  }
+
+  if (!source_addr) {
+    if (!g->asm_ref_cnt) {
+      mt_pthread_mutex_unlock(&mcast->group_mutex);
+      warn("%s(%d), no any source user, nothing to delete\n", __func__, port);
+      return 0;
+    }
+    g->asm_ref_cnt--;
+    if (!g->asm_ref_cnt && !kernel) {
+      /* back to INCLUDE{srcs}, INCLUDE{} is the leave */
+      for (int i = 0; i < g->src_num; i++) srcs[i] = g->srcs[i].ip;
+      mcast_queue_delta(mcast, group_addr, MCAST_CHANGE_TO_INCLUDE_MODE, srcs,
+                        g->src_num);
+    }
+  } else {
+    int idx = mcast_group_src_idx(g, source_addr);
+    if (idx < 0) {
       mt_pthread_mutex_unlock(&mcast->group_mutex);
-      /* remove mcast mac from interface */
-      mt_mcast_ip_to_mac(ip, &mcast_mac);
-      mcast_inf_remove_mac(inf, &mcast_mac);
+      warn("%s(%d), source not found, nothing to delete\n", __func__, port);
       return 0;
     }
+    g->srcs[idx].ref_cnt--;
+    if (!g->srcs[idx].ref_cnt) {
+      g->srcs[idx] = g->srcs[g->src_num - 1];
+      g->src_num--;
+      if (!g->asm_ref_cnt && !kernel)
+        mcast_queue_delta(mcast, group_addr, MCAST_BLOCK_OLD_SOURCES, &source_addr, 1);
+    }
   }
+  info("%s(%d), group %d.%d.%d.%d asm ref cnt %u src num %u\n", __func__, port, ip[0],
+       ip[1], ip[2], ip[3], g->asm_ref_cnt, g->src_num);
+  if (g->asm_ref_cnt || g->src_num) {
+    mt_pthread_mutex_unlock(&mcast->group_mutex);
+    return 0;
+  }
+
+  MT_TAILQ_REMOVE(mcast_bucket(mcast, group_addr), g, next);
+  mt_free(g);
+  mcast->group_num--;
+  if (kernel) mt_socket_drop_mcast(impl, port, group_addr);
   mt_pthread_mutex_unlock(&mcast->group_mutex);
-  warn("%s, group ip not found, nothing to delete\n", __func__);
+
+  /* remove mcast mac from interface */
+  mt_mcast_ip_to_mac(ip, &mcast_mac);
+  mcast_inf_remove_mac(inf, &mcast_mac);
   return 0;
 }
 
@@ -445,7 +783,7 @@ int mt_mcast_restore(struct mtl_main_impl* impl, enum mtl_port port) {
     for (uint32_t i = 0; i < inf->mcast_nb; i++)
       rte_eth_dev_mac_addr_add(port_id, &inf->mcast_mac_lists[i], 0);
   }
-  mcast_membership_report(impl, MCAST_MODE_IS_EXCLUDE, port);
+  mcast_membership_report(impl, port);
   return 0;
 }
 
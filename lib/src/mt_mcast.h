@@ -15,6 +15,16 @@
 #define IGMP_QUERY_IP "224.0.0.1"
 #define IGMP_JOIN_GROUP_PERIOD_S (10)
 #define IGMP_JOIN_GROUP_PERIOD_US (IGMP_JOIN_GROUP_PERIOD_S * US_PER_S)
+/* times to send a state change record, RFC3376 - 8.1 */
+#define IGMP_ROBUSTNESS (2)
+/* coalesce window before the state change report is sent */
+#define IGMP_STATE_CHANGE_DELAY_US (1000)
+/* min interval between two state change reports on one port */
+#define IGMP_STATE_CHANGE_INTERVAL_MS (100)
+/* max igmp payload in one report packet, keep below the mtu */
+#define IGMP_REPORT_MAX_LEN (1400)
+/* max report packets in one tx burst */
+#define IGMP_REPORT_BURST (16)
 
 enum mcast_msg_type {
   MEMBERSHIP_QUERY = 0x11,
@@ -74,8 +84,11 @@ struct mcast_mb_query_v3 {
 
 int mt_mcast_init(struct mtl_main_impl* impl);
 int mt_mcast_uinit(struct mtl_main_impl* impl);
-int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port);
-int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, enum mtl_port port);
+/* source_addr 0 means any source, otherwise join as SSM with source filter */
+int mt_mcast_join(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                  enum mtl_port port);
+int mt_mcast_leave(struct mtl_main_impl* impl, uint32_t group_addr, uint32_t source_addr,
+                   enum mtl_port port);
 int mt_mcast_restore(struct mtl_main_impl* impl, enum mtl_port port);
 int mt_mcast_l2_join(struct mtl_main_impl* impl, struct rte_ether_addr* addr,
                      enum mtl_port port);
@@ -0,0 +1,546 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_ndp.h"
+
+#include "mt_dev.h"
+#include "mt_ip6.h"
+//#define DEBUG
+#include "mt_log.h"
+#include "mt_mcast.h"
+
+static const uint8_t ndp_all_nodes[MTL_IP6_ADDR_LEN] = {0xff, 0x02, [15] = 0x01};
+
+static inline struct mt_ndp_impl* get_ndp(struct mtl_main_impl* impl,
+                                          enum mtl_port port) {
+  return &impl->ndp[port];
+}
+
+static int ndp_find(struct mt_ndp_impl* ndp, const uint8_t* target) {
+  for (int i = 0; i < ndp->addr_num; i++) {
+    if (mt_ip6_equal(ndp->addr[i], target)) return i;
+  }
+  return -1;
+}
+
+static struct mt_ndp_entry* ndp_lookup(struct mt_ndp_impl* ndp, const uint8_t* ip) {
+  for (int i = 0; i < MT_NDP_ENTRY_MAX; i++) {
+    struct mt_ndp_entry* entry = &ndp->entries[i];
+    if ((entry->state != MT_ARP_STATE_FREE) && mt_ip6_equal(entry->ip, ip)) return entry;
+  }
+  return NULL;
+}
+
+/* a free entry, or evict the least recently used ready one */
+static struct mt_ndp_entry* ndp_alloc(struct mt_ndp_impl* ndp) {
+  struct mt_ndp_entry* victim = NULL;
+
+  for (int i = 0; i < MT_NDP_ENTRY_MAX; i++) {
+    struct mt_ndp_entry* entry = &ndp->entries[i];
+    if (entry->state == MT_ARP_STATE_FREE) {
+      ndp->entry_cnt++;
+      return entry;
+    }
+    if (entry->state != MT_ARP_STATE_READY) continue;
+    if (!victim || (entry->access_ns < victim->access_ns)) victim = entry;
+  }
+
+  return victim;
+}
+
+static void ndp_free(struct mt_ndp_impl* ndp, struct mt_ndp_entry* entry) {
+  entry->state = MT_ARP_STATE_FREE;
+  ndp->entry_cnt--;
+}
+
+/* call and remove all the waiters of this ip */
+static void ndp_wake_waiters(struct mt_ndp_impl* ndp, const uint8_t* ip,
+                             struct rte_ether_addr* ea, int result) {
+  struct mt_ndp_waiter *waiter, *tmp_waiter;
+
+  for (waiter = MT_TAILQ_FIRST(&ndp->waiters); waiter != NULL; waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (!mt_ip6_equal(waiter->ip, ip)) continue;
+    MT_TAILQ_REMOVE(&ndp->waiters, waiter, next);
+    waiter->cb(waiter->priv, ndp->port, ip, ea, result);
+    mt_free(waiter);
+  }
+}
+
+/* the mac of the link-layer address option type, NULL if not present */
+static struct rte_ether_addr* ndp_opt_lla(struct mt_ndp_hdr* hdr, uint16_t len,
+                                          uint8_t type) {
+  uint8_t* opt = (uint8_t*)(hdr + 1);
+  uint16_t left = len - sizeof(*hdr);
+  uint16_t opt_len;
+
+  while (left >= sizeof(struct mt_ndp_lla_opt)) {
+    opt_len = opt[1] * 8;
+    if (!opt_len || opt_len > left) return NULL; /* malformed */
+    if (opt[0] == type) return &((struct mt_ndp_lla_opt*)opt)->mac;
+    opt += opt_len;
+    left -= opt_len;
+  }
+
+  return NULL;
+}
+
+/* the NA to a NS, or the NS to resolve dip if ns is true */
+static struct rte_mbuf* ndp_build_pkt(struct mt_ndp_impl* ndp,
+                                      struct rte_ether_addr* d_mac, const uint8_t* sip,
+                                      const uint8_t* dip, const uint8_t* target,
+                                      bool ns, uint32_t flags) {
+  struct mtl_main_impl* impl = ndp->parnet;
+  enum mtl_port port = ndp->port;
+  uint16_t port_id = mt_port_id(impl, port);
+  struct rte_mbuf* pkt;
+  struct rte_ether_hdr* eth;
+  struct rte_ipv6_hdr* ipv6;
+  struct mt_ndp_hdr* hdr;
+  struct mt_ndp_lla_opt* opt;
+
+  pkt = rte_pktmbuf_alloc(mt_get_tx_mempool(impl, port));
+  if (!pkt) return NULL;
+
+  pkt->pkt_len = pkt->data_len =
+      sizeof(*eth) + sizeof(*ipv6) + sizeof(*hdr) + sizeof(*opt);
+
+  eth = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr*);
+  rte_eth_macaddr_get(port_id, mt_eth_s_addr(eth));
+  rte_ether_addr_copy(d_mac, mt_eth_d_addr(eth));
+  eth->ether_type = htons(RTE_ETHER_TYPE_IPV6);
+
+  ipv6 = (struct rte_ipv6_hdr*)(eth + 1);
+  ipv6->vtc_flow = htonl(6 << 28);
+  ipv6->payload_len = htons(sizeof(*hdr) + sizeof(*opt));
+  ipv6->proto = IPPROTO_ICMPV6;
+  ipv6->hop_limits = MT_NDP_HOP_LIMIT;
+  memcpy(ipv6->src_addr, sip, MTL_IP6_ADDR_LEN);
+  memcpy(ipv6->dst_addr, dip, MTL_IP6_ADDR_LEN);
+
+  hdr = (struct mt_ndp_hdr*)(ipv6 + 1);
+  hdr->type = ns ? MT_ICMP6_TYPE_NS : MT_ICMP6_TYPE_NA;
+  hdr->code = 0;
+  hdr->flags = htonl(flags);
+  memcpy(hdr->target, target, MTL_IP6_ADDR_LEN);
+
+  opt = (struct mt_ndp_lla_opt*)(hdr + 1);
+  opt->type = ns ? MT_NDP_OPT_SLLA : MT_NDP_OPT_TLLA;
+  opt->len = 1;
+  rte_eth_macaddr_get(port_id, &opt->mac);
+
+  hdr->cksum = 0;
+  hdr->cksum = rte_ipv6_udptcp_cksum(ipv6, hdr);
+
+  return pkt;
+}
+
+static int ndp_send_na(struct mt_ndp_impl* ndp, struct rte_ether_addr* d_mac,
+                       const uint8_t* dip, int idx, bool dad) {
+  struct mtl_main_impl* impl = ndp->parnet;
+  enum mtl_port port = ndp->port;
+  /* an answer to DAD is not solicited by an unicast address */
+  uint32_t flags = dad ? MT_NDP_NA_FLAG_O : (MT_NDP_NA_FLAG_S | MT_NDP_NA_FLAG_O);
+  struct rte_mbuf* pkt;
+
+  pkt = ndp_build_pkt(ndp, d_mac, ndp->addr[idx], dip, ndp->addr[idx], false, flags);
+  if (!pkt) {
+    err("%s(%d), pkt alloc fail\n", __func__, port);
+    return -ENOMEM;
+  }
+
+  uint16_t send = mt_dev_tx_sys_queue_burst(impl, port, &pkt, 1);
+  if (send < 1) {
+    err_once("%s(%d), tx fail\n", __func__, port);
+    rte_pktmbuf_free(pkt);
+    return -EIO;
+  }
+
+  ndp->stat_na++;
+  return 0;
+}
+
+/* the NS to the solicited-node group of ip */
+static int ndp_send_ns(struct mt_ndp_impl* ndp, const uint8_t* ip) {
+  struct mtl_main_impl* impl = ndp->parnet;
+  enum mtl_port port = ndp->port;
+  const uint8_t* sip = mt_ndp_sip6(impl, port, ip);
+  uint8_t sn[MTL_IP6_ADDR_LEN];
+  struct rte_ether_addr sn_mac;
+  struct rte_mbuf* pkt;
+
+  if (!sip) return -EINVAL;
+  mt_ip6_sn_addr(ip, sn);
+  mt_ip6_mcast_mac(sn, sn_mac.addr_bytes);
+
+  pkt = ndp_build_pkt(ndp, &sn_mac, sip, sn, ip, true, 0);
+  if (!pkt) {
+    err("%s(%d), pkt alloc fail\n", __func__, port);
+    return -ENOMEM;
+  }
+
+  uint16_t send = mt_dev_tx_sys_queue_burst(impl, port, &pkt, 1);
+  if (send < 1) {
+    err_once("%s(%d), tx fail\n", __func__, port);
+    rte_pktmbuf_free(pkt);
+    return -EIO;
+  }
+
+  ndp->stat_ns_sent++;
+  return 0;
+}
+
+/* send the NS of the pending entries, expire the waiters */
+static void ndp_timer_handler(void* param) {
+  struct mt_ndp_impl* ndp = param;
+  enum mtl_port port = ndp->port;
+  uint64_t now = mt_get_monotonic_time();
+  uint64_t retry_ns = (uint64_t)MT_NDP_RETRY_INTERVAL_MS * NS_PER_MS;
+  uint64_t expire_ns = (uint64_t)MT_NDP_PENDING_EXPIRE_S * NS_PER_S;
+  struct mt_ndp_waiter *waiter, *tmp_waiter;
+  struct mt_ndp_entry* entry;
+  int pending = 0;
+
+  mt_pthread_mutex_lock(&ndp->mutex);
+
+  for (waiter = MT_TAILQ_FIRST(&ndp->waiters); waiter != NULL; waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (!waiter->expire_ns || (now < waiter->expire_ns)) {
+      /* keep the entry alive while someone is waiting it */
+      entry = ndp_lookup(ndp, waiter->ip);
+      if (entry) entry->access_ns = now;
+      continue;
+    }
+    MT_TAILQ_REMOVE(&ndp->waiters, waiter, next);
+    waiter->cb(waiter->priv, port, waiter->ip, NULL, -ETIMEDOUT);
+    mt_free(waiter);
+  }
+
+  for (int e = 0; e < MT_NDP_ENTRY_MAX; e++) {
+    entry = &ndp->entries[e];
+    if (entry->state != MT_ARP_STATE_PENDING) continue;
+    if ((now - entry->access_ns) >= expire_ns) {
+      ndp_free(ndp, entry);
+      continue;
+    }
+    pending++;
+    if (entry->request_ns && ((now - entry->request_ns) < retry_ns)) continue;
+
+    if (entry->retry && (0 == (entry->retry % 10)))
+      info("%s(%d), waiting na, retry %u\n", __func__, port, entry->retry);
+    ndp_send_ns(ndp, entry->ip);
+    entry->request_ns = now;
+    entry->retry++;
+  }
+
+  if (pending > 0)
+    rte_eal_alarm_set(MT_NDP_TIMER_US, ndp_timer_handler, ndp);
+  else
+    ndp->timer_active = false;
+
+  mt_pthread_mutex_unlock(&ndp->mutex);
+}
+
+static int ndp_receive_ns(struct mt_ndp_impl* ndp, struct rte_ether_hdr* eth,
+                          struct rte_ipv6_hdr* ipv6, struct mt_ndp_hdr* ns,
+                          uint16_t len) {
+  enum mtl_port port = ndp->port;
+  struct rte_ether_addr* d_mac;
+  struct rte_ether_addr all_nodes_mac;
+  bool dad;
+  int idx;
+
+  idx = ndp_find(ndp, ns->target);
+  if (idx < 0) {
+    dbg("%s(%d), not our ns\n", __func__, port);
+    return -EINVAL;
+  }
+
+  dad = mt_ip6_is_zero(ipv6->src_addr);
+  /* RFC 4861 7.1.1, sent to the solicited-node group or the target only */
+  if (!mt_ip6_ns_dst_valid(ipv6->dst_addr, ns->target, dad)) {
+    dbg("%s(%d), invalid ns dst\n", __func__, port);
+    return -EINVAL;
+  }
+  ndp->stat_ns++;
+
+  if (dad) {
+    /* the address is in use by us, tell all nodes */
+    mt_ip6_mcast_mac(ndp_all_nodes, all_nodes_mac.addr_bytes);
+    warn("%s(%d), dad probe for our address %d\n", __func__, port, idx);
+    return ndp_send_na(ndp, &all_nodes_mac, ndp_all_nodes, idx, true);
+  }
+
+  d_mac = ndp_opt_lla(ns, len, MT_NDP_OPT_SLLA);
+  if (!d_mac) d_mac = mt_eth_s_addr(eth);
+  return ndp_send_na(ndp, d_mac, ipv6->src_addr, idx, false);
+}
+
+static int ndp_receive_na(struct mt_ndp_impl* ndp, struct rte_ether_hdr* eth,
+                          struct rte_ipv6_hdr* ipv6, struct mt_ndp_hdr* na,
+                          uint16_t len) {
+  enum mtl_port port = ndp->port;
+  struct rte_ether_addr* ea;
+  struct mt_ndp_entry* entry;
+
+  /* RFC 4861 7.1.2, a solicited NA is never sent to a multicast address */
+  if (mt_ip6_is_multicast(ipv6->dst_addr) && (ntohl(na->flags) & MT_NDP_NA_FLAG_S)) {
+    dbg("%s(%d), solicited na to multicast\n", __func__, port);
+    return -EINVAL;
+  }
+
+  ea = ndp_opt_lla(na, len, MT_NDP_OPT_TLLA);
+  if (!ea) ea = mt_eth_s_addr(eth);
+
+  mt_pthread_mutex_lock(&ndp->mutex);
+  entry = ndp_lookup(ndp, na->target);
+  if (!entry) {
+    dbg("%s(%d), not our ns target\n", __func__, port);
+    mt_pthread_mutex_unlock(&ndp->mutex);
+    return -EINVAL;
+  }
+  ndp->stat_na_recv++;
+  rte_ether_addr_copy(ea, &entry->ea);
+  entry->request_ns = 0;
+  entry->retry = 0;
+  if (entry->state != MT_ARP_STATE_READY) {
+    entry->state = MT_ARP_STATE_READY;
+    ndp_wake_waiters(ndp, entry->ip, &entry->ea, 0);
+  }
+  mt_pthread_mutex_unlock(&ndp->mutex);
+
+  return 0;
+}
+
+int mt_ndp_parse(struct mtl_main_impl* impl, struct rte_ether_hdr* eth,
+                 struct rte_ipv6_hdr* ipv6, enum mtl_port port) {
+  struct mt_ndp_impl* ndp = get_ndp(impl, port);
+  struct mt_ndp_hdr* hdr = (struct mt_ndp_hdr*)(ipv6 + 1);
+  uint16_t len = ntohs(ipv6->payload_len);
+
+  if (!ndp->addr_num) return -EINVAL;
+  if (ipv6->proto != IPPROTO_ICMPV6) return -EINVAL;
+  if (len < sizeof(*hdr)) return -EINVAL;
+  if ((hdr->type != MT_ICMP6_TYPE_NS) && (hdr->type != MT_ICMP6_TYPE_NA)) {
+    dbg("%s(%d), icmpv6 type %u not handled\n", __func__, port, hdr->type);
+    return 0;
+  }
+  /* RFC 4861 7.1, drop the NDP pkt which may be forwarded by a router */
+  if (ipv6->hop_limits != MT_NDP_HOP_LIMIT || hdr->code) {
+    dbg("%s(%d), invalid ndp, hop limit %u code %u\n", __func__, port, ipv6->hop_limits,
+        hdr->code);
+    return -EINVAL;
+  }
+
+  if (hdr->type == MT_ICMP6_TYPE_NS) return ndp_receive_ns(ndp, eth, ipv6, hdr, len);
+  return ndp_receive_na(ndp, eth, ipv6, hdr, len);
+}
+
+const uint8_t* mt_ndp_sip6(struct mtl_main_impl* impl, enum mtl_port port,
+                           const uint8_t* dip) {
+  struct mt_ndp_impl* ndp = get_ndp(impl, port);
+
+  if (!ndp->addr_num) return NULL;
+  /* the link-local scope is only reached from the link-local address */
+  if (ndp->addr_num > 1 && !(dip[0] == 0xfe && (dip[1] & 0xc0) == 0x80))
+    return ndp->addr[1];
+  return ndp->addr[0];
+}
+
+int mt_ndp_cni_get_mac_async(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                             enum mtl_port port, const uint8_t* ip, int timeout_ms,
+                             mt_ndp_cb_t cb, void* priv) {
+  struct mt_ndp_impl* ndp = get_ndp(impl, port);
+  uint64_t now = mt_get_monotonic_time();
+  struct mt_ndp_entry* entry;
+
+  if (!ndp->addr_num) {
+    err("%s(%d), no ipv6 address on this port\n", __func__, port);
+    return -EINVAL;
+  }
+
+  mt_pthread_mutex_lock(&ndp->mutex);
+
+  entry = ndp_lookup(ndp, ip);
+  if (entry && (entry->state == MT_ARP_STATE_READY)) {
+    entry->access_ns = now;
+    rte_ether_addr_copy(&entry->ea, ea);
+    mt_pthread_mutex_unlock(&ndp->mutex);
+    return 0;
+  }
+
+  if (!entry) {
+    entry = ndp_alloc(ndp);
+    if (!entry) {
+      err("%s(%d), no free entry, all pending\n", __func__, port);
+      mt_pthread_mutex_unlock(&ndp->mutex);
+      return -EBUSY;
+    }
+    memcpy(entry->ip, ip, MTL_IP6_ADDR_LEN);
+    entry->state = MT_ARP_STATE_PENDING;
+    entry->request_ns = 0; /* the timer will send it */
+    entry->retry = 0;
+  }
+  entry->access_ns = now;
+
+  struct mt_ndp_waiter* waiter = mt_zmalloc(sizeof(*waiter));
+  if (!waiter) {
+    err("%s(%d), waiter malloc fail\n", __func__, port);
+    mt_pthread_mutex_unlock(&ndp->mutex);
+    return -ENOMEM;
+  }
+  memcpy(waiter->ip, ip, MTL_IP6_ADDR_LEN);
+  waiter->cb = cb;
+  waiter->priv = priv;
+  if (timeout_ms) waiter->expire_ns = now + (uint64_t)timeout_ms * NS_PER_MS;
+  MT_TAILQ_INSERT_TAIL(&ndp->waiters, waiter, next);
+
+  if (!ndp->timer_active) {
+    rte_eal_alarm_set(MT_NDP_TIMER_US, ndp_timer_handler, ndp);
+    ndp->timer_active = true;
+  }
+
+  mt_pthread_mutex_unlock(&ndp->mutex);
+  return -EINPROGRESS;
+}
+
+int mt_ndp_cni_cancel(struct mtl_main_impl* impl, enum mtl_port port, void* priv) {
+  struct mt_ndp_impl* ndp = get_ndp(impl, port);
+  struct mt_ndp_waiter *waiter, *tmp_waiter;
+
+  mt_pthread_mutex_lock(&ndp->mutex);
+  for (waiter = MT_TAILQ_FIRST(&ndp->waiters); waiter != NULL; waiter = tmp_waiter) {
+    tmp_waiter = MT_TAILQ_NEXT(waiter, next);
+    if (waiter->priv != priv) continue;
+    MT_TAILQ_REMOVE(&ndp->waiters, waiter, next);
+    mt_free(waiter);
+  }
+  mt_pthread_mutex_unlock(&ndp->mutex);
+
+  return 0;
+}
+
+struct ndp_sync_ctx {
+  rte_atomic32_t done;
+  int result;
+  struct rte_ether_addr ea;
+};
+
+static void ndp_sync_done(void* priv, enum mtl_port port, const uint8_t* ip,
+                          struct rte_ether_addr* ea, int result) {
+  struct ndp_sync_ctx* ctx = priv;
+
+  ctx->result = result;
+  if (ea) rte_ether_addr_copy(ea, &ctx->ea);
+  rte_atomic32_set(&ctx->done, 1);
+}
+
+int mt_ndp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                       enum mtl_port port, const uint8_t* ip, int timeout_ms) {
+  struct ndp_sync_ctx ctx;
+  int ret;
+  int retry = 0;
+
+  memset(&ctx, 0, sizeof(ctx));
+  rte_atomic32_set(&ctx.done, 0);
+  ret = mt_ndp_cni_get_mac_async(impl, ea, port, ip, timeout_ms, ndp_sync_done, &ctx);
+  if (ret != -EINPROGRESS) return ret;
+
+  /* the timer thread sends the NS, wait the NA */
+  while (!rte_atomic32_read(&ctx.done)) {
+    if (mt_aborted(impl)) {
+      mt_ndp_cni_cancel(impl, port, &ctx);
+      err("%s(%d), fail as user aborted\n", __func__, port);
+      return -EIO;
+    }
+    mt_sleep_ms(MT_NDP_SYNC_POLL_MS);
+    retry++;
+    if (0 == (retry % (5000 / MT_NDP_SYNC_POLL_MS)))
+      info("%s(%d), waiting na\n", __func__, port);
+  }
+
+  if (ctx.result < 0) {
+    err("%s(%d), fail %d, timeout %d ms\n", __func__, port, ctx.result, timeout_ms);
+    return -EIO;
+  }
+  rte_ether_addr_copy(&ctx.ea, ea);
+  return 0;
+}
+
+int mt_ndp_init(struct mtl_main_impl* impl) {
+  struct mtl_init_params* p = mt_get_user_params(impl);
+  int num_ports = mt_num_ports(impl);
+  struct rte_ether_addr mac;
+  uint8_t sn[MTL_IP6_ADDR_LEN];
+  int ret;
+
+  for (int port = 0; port < MTL_PORT_MAX; ++port) {
+    struct mt_ndp_impl* ndp = get_ndp(impl, port);
+
+    ndp->parnet = impl;
+    ndp->port = port;
+    mt_pthread_mutex_init(&ndp->mutex, NULL);
+    MT_TAILQ_INIT(&ndp->waiters);
+  }
+
+  for (int port = 0; port < num_ports; ++port) {
+    struct mt_ndp_impl* ndp = get_ndp(impl, port);
+
+    /* the kernel answers the NDP for the af_xdp port */
+    if (mt_pmd_is_kernel(impl, port)) continue;
+
+    rte_eth_macaddr_get(mt_port_id(impl, port), &mac);
+    mt_ip6_link_local(mac.addr_bytes, ndp->addr[ndp->addr_num++]);
+    if (!mt_ip6_is_zero(p->sip6_addr[port]))
+      memcpy(ndp->addr[ndp->addr_num++], p->sip6_addr[port], MTL_IP6_ADDR_LEN);
+
+    for (int i = 0; i < ndp->addr_num; i++) {
+      mt_ip6_sn_addr(ndp->addr[i], sn);
+      mt_ip6_mcast_mac(sn, ndp->sn_mac[i].addr_bytes);
+      ret = mt_mcast_l2_join(impl, &ndp->sn_mac[i], port);
+      if (ret < 0) {
+        warn("%s(%d), join solicited-node group %d fail %d\n", __func__, port, i, ret);
+        continue;
+      }
+      ndp->sn_joined[i] = true;
+    }
+
+    uint8_t* a = ndp->addr[0];
+    info("%s(%d), link-local fe80::%02x%02x:%02x%02x:%02x%02x:%02x%02x, %d addrs\n",
+         __func__, port, a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15],
+         ndp->addr_num);
+  }
+
+  return 0;
+}
+
+int mt_ndp_uinit(struct mtl_main_impl* impl) {
+  struct mt_ndp_waiter* waiter;
+
+  for (int port = 0; port < MTL_PORT_MAX; ++port) {
+    struct mt_ndp_impl* ndp = get_ndp(impl, port);
+
+    rte_eal_alarm_cancel(ndp_timer_handler, ndp);
+    ndp->timer_active = false;
+
+    while ((waiter = MT_TAILQ_FIRST(&ndp->waiters))) {
+      MT_TAILQ_REMOVE(&ndp->waiters, waiter, next);
+      mt_free(waiter);
+    }
+
+    for (int i = 0; i < ndp->addr_num; i++) {
+      if (!ndp->sn_joined[i]) continue;
+      mt_mcast_l2_leave(impl, &ndp->sn_mac[i], port);
+      ndp->sn_joined[i] = false;
+    }
+    if (ndp->stat_ns || ndp->stat_ns_sent)
+      info("%s(%d), ns %u, na %u, ns sent %u, na recv %u\n", __func__, port, ndp->stat_ns,
+           ndp->stat_na, ndp->stat_ns_sent, ndp->stat_na_recv);
+    ndp->addr_num = 0;
+
+    mt_pthread_mutex_destroy(&ndp->mutex);
+  }
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_NDP_HEAD_H_
+#define _MT_LIB_NDP_HEAD_H_
+
+#include "mt_main.h"
+
+#define MT_ICMP6_TYPE_NS (135) /* neighbor solicitation */
+#define MT_ICMP6_TYPE_NA (136) /* neighbor advertisement */
+#define MT_NDP_OPT_SLLA (1)    /* source link-layer address option */
+#define MT_NDP_OPT_TLLA (2)    /* target link-layer address option */
+/* the NA flags, in network order of the 32 bits flags field */
+#define MT_NDP_NA_FLAG_S (0x40000000) /* solicited */
+#define MT_NDP_NA_FLAG_O (0x20000000) /* override */
+/* all NDP pkts are sent with this hop limit and must be received with it */
+#define MT_NDP_HOP_LIMIT (255)
+
+/* the timer period to send the NS and expire the waiters */
+#define MT_NDP_TIMER_US (10 * 1000)
+#define MT_NDP_RETRY_INTERVAL_MS (500)
+/* the tx sessions give up an async resolve after 10 retries, then report and retry */
+#define MT_NDP_ASYNC_TIMEOUT_MS (MT_NDP_RETRY_INTERVAL_MS * 10)
+/* a pending entry nobody waits is freed after this time */
+#define MT_NDP_PENDING_EXPIRE_S (10)
+/* poll interval for the blocking mt_ndp_cni_get_mac */
+#define MT_NDP_SYNC_POLL_MS (1)
+
+struct mt_ndp_hdr {
+  uint8_t type;
+  uint8_t code;
+  uint16_t cksum;
+  uint32_t flags; /* reserved for NS */
+  uint8_t target[MTL_IP6_ADDR_LEN];
+} __attribute__((__packed__));
+
+struct mt_ndp_lla_opt {
+  uint8_t type;
+  uint8_t len; /* in units of 8 bytes */
+  struct rte_ether_addr mac;
+} __attribute__((__packed__));
+
+/*
+ * handle the ICMPv6 pkt from cni, answer the NS for the addresses of this port and
+ * fill the neighbor cache from the NA
+ */
+int mt_ndp_parse(struct mtl_main_impl* impl, struct rte_ether_hdr* eth,
+                 struct rte_ipv6_hdr* ipv6, enum mtl_port port);
+
+/* the source address for the pkts to dip, NULL if no address on this port */
+const uint8_t* mt_ndp_sip6(struct mtl_main_impl* impl, enum mtl_port port,
+                           const uint8_t* dip);
+
+/* the counterpart of mt_arp_cni_get_mac, block until the NA arrives or timeout */
+int mt_ndp_cni_get_mac(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                       enum mtl_port port, const uint8_t* ip, int timeout_ms);
+/*
+ * Non-blocking resolve, return 0 with ea filled if it's in the cache already, or
+ * -EINPROGRESS and cb will be called once the NA arrives or timeout.
+ */
+int mt_ndp_cni_get_mac_async(struct mtl_main_impl* impl, struct rte_ether_addr* ea,
+                             enum mtl_port port, const uint8_t* ip, int timeout_ms,
+                             mt_ndp_cb_t cb, void* priv);
+/* remove all the pending callbacks of priv */
+int mt_ndp_cni_cancel(struct mtl_main_impl* impl, enum mtl_port port, void* priv);
+
+int mt_ndp_init(struct mtl_main_impl* impl);
+int mt_ndp_uinit(struct mtl_main_impl* impl);
+
+#endif
@@ -13,6 +13,8 @@
 #include <net/if_arp.h>
 #include <numa.h>
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/shm.h>
 #include <sys/socket.h>
@@ -72,6 +74,10 @@ static inline int mt_pthread_mutex_lock(pthread_mutex_t* mutex) {
   return pthread_mutex_lock(mutex);
 }
 
+static inline int mt_pthread_mutex_trylock(pthread_mutex_t* mutex) {
+  return pthread_mutex_trylock(mutex);
+}
+
 static inline int mt_pthread_mutex_unlock(pthread_mutex_t* mutex) {
   return pthread_mutex_unlock(mutex);
 }
@@ -102,6 +108,10 @@ static inline int mt_pthread_cond_signal(pthread_cond_t* cond) {
   return pthread_cond_signal(cond);
 }
 
+static inline int mt_pthread_cond_broadcast(pthread_cond_t* cond) {
+  return pthread_cond_broadcast(cond);
+}
+
 static inline bool mt_socket_match(int cpu_socket, int dev_socket) {
 #ifdef WINDOWSENV
   return true;  // windows cpu socket always 0
@@ -10,6 +10,7 @@
 #include "mt_log.h"
 #include "mt_mcast.h"
 #include "mt_sch.h"
+#include "mt_state.h"
 #include "mt_util.h"
 
 #define MT_PTP_USE_TX_TIME_STAMP (1)
@@ -124,8 +125,11 @@ static void ptp_calculate_coefficient(struct mt_ptp_impl* ptp, int64_t delta) {
   ptp->coefficient_result_min = RTE_MIN(coefficient, ptp->coefficient_result_min);
   ptp->coefficient_result_max = RTE_MAX(coefficient, ptp->coefficient_result_max);
   ptp->coefficient_result_cnt++;
-  if (ptp->coefficient - 1.0 < 1e-9) /* store first result */
+  if (ptp->coefficient - 1.0 < 1e-9) { /* store first result, or the restored one */
+    if (ptp->restored_coefficient) coefficient = ptp->restored_coefficient;
     ptp->coefficient = coefficient;
+    ptp->restored_coefficient = 0;
+  }
   if (ptp->coefficient_result_cnt == 10) {
     /* get every 10 results' average */
     ptp->coefficient_result_sum -= ptp->coefficient_result_min;
@@ -514,6 +518,12 @@ static int ptp_parse_annouce(struct mt_ptp_impl* ptp, struct mt_ptp_announce_msg
     info("%s(%d), master initialized, mode %s utc_offset %d domain_number %d\n", __func__,
          port, ptp_mode_str(mode), ptp->master_utc_offset, msg->hdr.domain_number);
     ptp_print_port_id(port, &ptp->master_port_id);
+    if (ptp->restored_coefficient &&
+        memcmp(&ptp->restored_master, &ptp->master_port_id.clock_identity,
+               sizeof(ptp->restored_master))) {
+      warn("%s(%d), master changed, drop the restored coefficient\n", __func__, port);
+      ptp->restored_coefficient = 0;
+    }
     if (mode == MT_PTP_L4) {
       struct mt_ptp_ipv4_udp* dst_udp = &ptp->dst_udp;
 
@@ -696,7 +706,7 @@ static int ptp_init(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp,
   }
 
   /* join mcast */
-  ret = mt_mcast_join(impl, mt_ip_to_u32(ptp->mcast_group_addr), port);
+  ret = mt_mcast_join(impl, mt_ip_to_u32(ptp->mcast_group_addr), 0, port);
   if (ret < 0) {
     err("%s(%d), join ptp multicast group fail\n", __func__, port);
     return ret;
@@ -721,7 +731,7 @@ static int ptp_uinit(struct mtl_main_impl* impl, struct mt_ptp_impl* ptp) {
   if (!mt_if_has_ptp(impl, port)) return 0;
 
   mt_mcast_l2_leave(impl, &ptp_l2_multicast_eaddr, port);
-  mt_mcast_leave(impl, mt_ip_to_u32(ptp->mcast_group_addr), port);
+  mt_mcast_leave(impl, mt_ip_to_u32(ptp->mcast_group_addr), 0, port);
 
   if (ptp->rx_queue) {
     mt_dev_put_rx_queue(impl, ptp->rx_queue);
@@ -854,8 +864,8 @@ int mt_ptp_init(struct mtl_main_impl* impl) {
   struct mt_ptp_impl* ptp;
 
   for (int i = 0; i < num_ports; i++) {
-    /* no ptp for kernel based pmd */
-    if (mt_pmd_is_kernel(impl, i)) continue;
+    /* no ptp for kernel based pmd and memif */
+    if (mt_pmd_is_kernel(impl, i) || mt_pmd_is_memif(impl, i)) continue;
 
     ptp = mt_get_ptp(impl, i);
     ret = ptp_init(impl, ptp, i);
@@ -881,6 +891,32 @@ int mt_ptp_uinit(struct mtl_main_impl* impl) {
   return 0;
 }
 
+int mt_ptp_servo_get(struct mtl_main_impl* impl, enum mtl_port port,
+                     struct mt_ptp_clock_id* master, double* coefficient) {
+  struct mt_ptp_impl* ptp = mt_get_ptp(impl, port);
+
+  if (!ptp->master_initialized || (ptp->coefficient == 1.0)) return -EINVAL;
+
+  rte_memcpy(master, &ptp->master_port_id.clock_identity, sizeof(*master));
+  *coefficient = ptp->coefficient;
+  return 0;
+}
+
+int mt_ptp_servo_restore(struct mtl_main_impl* impl, enum mtl_port port,
+                         struct mt_ptp_clock_id* master, double coefficient) {
+  struct mt_ptp_impl* ptp = mt_get_ptp(impl, port);
+
+  if (!mt_state_ptp_coefficient_valid(coefficient)) {
+    err("%s(%d), invalid coefficient %.15lf\n", __func__, port, coefficient);
+    return -EINVAL;
+  }
+
+  rte_memcpy(&ptp->restored_master, master, sizeof(*master));
+  ptp->restored_coefficient = coefficient;
+  info("%s(%d), coefficient %.15lf\n", __func__, port, coefficient);
+  return 0;
+}
+
 uint64_t mt_get_raw_ptp_time(struct mtl_main_impl* impl, enum mtl_port port) {
   return ptp_get_raw_time(mt_get_ptp(impl, port));
 }
@@ -116,4 +116,11 @@ int mt_ptp_parse(struct mt_ptp_impl* ptp, struct mt_ptp_header* hdr, bool vlan,
 
 void mt_ptp_stat(struct mtl_main_impl* impl);
 
+/* the sw frequency correction learned from the master, for the warm restart state */
+int mt_ptp_servo_get(struct mtl_main_impl* impl, enum mtl_port port,
+                     struct mt_ptp_clock_id* master, double* coefficient);
+/* applied on the first sync if the master is still the same one */
+int mt_ptp_servo_restore(struct mtl_main_impl* impl, enum mtl_port port,
+                         struct mt_ptp_clock_id* master, double coefficient);
+
 #endif
@@ -25,6 +25,13 @@ static inline void sch_unlock(struct mt_sch_impl* sch) {
   mt_pthread_mutex_unlock(&sch->mutex);
 }
 
+static void sch_notify_event(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
+                             enum mtl_sch_event event) {
+  struct mtl_init_params* p = mt_get_user_params(impl);
+
+  if (p->sch_event_cb) p->sch_event_cb(p->priv, event, sch->idx, sch->lcore);
+}
+
 static void sch_sleep_wakeup(struct mt_sch_impl* sch) {
   mt_pthread_mutex_lock(&sch->sleep_wake_mutex);
   mt_pthread_cond_signal(&sch->sleep_wake_cond);
@@ -37,6 +44,156 @@ static void sch_sleep_alarm_handler(void* param) {
   sch_sleep_wakeup(sch);
 }
 
+static void sch_rx_intr_wake_cb(int fd, void* arg) {
+  uint64_t v;
+
+  MT_MAY_UNUSED(arg);
+  if (read(fd, &v, sizeof(v)) < 0) dbg("%s, read fail\n", __func__);
+}
+
+static void sch_rx_intr_wakeup(struct mt_sch_impl* sch) {
+  uint64_t v = 1;
+
+  if (sch->intr_wake_fd < 0) return;
+  if (write(sch->intr_wake_fd, &v, sizeof(v)) < 0) dbg("%s, write fail\n", __func__);
+}
+
+static int sch_rx_intr_init(struct mt_sch_impl* sch) {
+  int idx = sch->idx;
+#ifdef WINDOWSENV
+  warn("%s(%d), no rx intr support\n", __func__, idx);
+  return -ENOTSUP;
+#else
+  struct rte_epoll_event* ev = &sch->intr_wake_ev;
+  int ret;
+
+  sch->intr_epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (sch->intr_epfd < 0) {
+    err("%s(%d), epoll create fail %d\n", __func__, idx, errno);
+    return -EIO;
+  }
+  sch->intr_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (sch->intr_wake_fd < 0) {
+    err("%s(%d), eventfd create fail %d\n", __func__, idx, errno);
+    close(sch->intr_epfd);
+    sch->intr_epfd = -1;
+    return -EIO;
+  }
+
+  memset(ev, 0, sizeof(*ev));
+  ev->epdata.event = EPOLLIN | EPOLLET;
+  ev->epdata.data = sch;
+  ev->epdata.cb_fun = sch_rx_intr_wake_cb;
+  ev->epdata.cb_arg = sch;
+  ret = rte_epoll_ctl(sch->intr_epfd, EPOLL_CTL_ADD, sch->intr_wake_fd, ev);
+  if (ret < 0) {
+    err("%s(%d), epoll add wake fd fail %d\n", __func__, idx, ret);
+    close(sch->intr_wake_fd);
+    sch->intr_wake_fd = -1;
+    close(sch->intr_epfd);
+    sch->intr_epfd = -1;
+    return ret;
+  }
+
+  return 0;
+#endif
+}
+
+static void sch_rx_intr_uinit(struct mt_sch_impl* sch) {
+  if (sch->intr_wake_fd >= 0) {
+    close(sch->intr_wake_fd);
+    sch->intr_wake_fd = -1;
+  }
+  if (sch->intr_epfd >= 0) {
+    close(sch->intr_epfd);
+    sch->intr_epfd = -1;
+  }
+}
+
+/* call with intr_mutex */
+static void sch_rx_intr_disarm(struct mt_sch_impl* sch) {
+  struct mt_rx_queue* q;
+
+  if (!sch->intr_armed) return;
+  MT_TAILQ_FOREACH(q, &sch->intr_queues, intr_next) {
+    rte_eth_dev_rx_intr_disable(q->port_id, q->queue_id);
+  }
+  sch->intr_armed = false;
+}
+
+/* arm the rx interrupt if all the rx queues are quiet for the idle time */
+static bool sch_rx_intr_arm(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
+                            uint64_t now) {
+  uint64_t idle_ns = mt_sch_get_mgr(impl)->rx_intr_idle_ns;
+  struct mt_rx_queue* q;
+  bool idle = true;
+
+  if (sch->intr_epfd < 0) return false;
+  /* never block the tasklet loop */
+  if (mt_pthread_mutex_trylock(&sch->intr_mutex)) return false;
+
+  if (sch->intr_poll_q_num || !MT_TAILQ_FIRST(&sch->intr_queues)) {
+    mt_pthread_mutex_unlock(&sch->intr_mutex);
+    return false;
+  }
+
+  MT_TAILQ_FOREACH(q, &sch->intr_queues, intr_next) {
+    if (q->intr_pkt_seen) {
+      q->intr_pkt_seen = false;
+      q->intr_idle_ns = now;
+    }
+    if ((now - q->intr_idle_ns) < idle_ns) idle = false;
+  }
+  if (!idle) {
+    mt_pthread_mutex_unlock(&sch->intr_mutex);
+    return false;
+  }
+
+  MT_TAILQ_FOREACH(q, &sch->intr_queues, intr_next) {
+    rte_eth_dev_rx_intr_enable(q->port_id, q->queue_id);
+  }
+  sch->intr_armed = true;
+  /* the pkts landed before the interrupt enabled will not fire it */
+  MT_TAILQ_FOREACH(q, &sch->intr_queues, intr_next) {
+    if (rte_eth_rx_queue_count(q->port_id, q->queue_id) > 0) {
+      q->intr_pkt_seen = true;
+      idle = false;
+      break;
+    }
+  }
+  if (!idle) sch_rx_intr_disarm(sch);
+
+  mt_pthread_mutex_unlock(&sch->intr_mutex);
+  return idle;
+}
+
+static void sch_rx_intr_wait(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
+                             uint64_t sleep_us) {
+  struct rte_epoll_event events[MT_SCH_RX_INTR_EVENTS];
+  int timeout_ms = RTE_MAX(sleep_us / US_PER_MS, 1);
+  int rx_events = 0;
+
+  int n = rte_epoll_wait(sch->intr_epfd, events, MT_SCH_RX_INTR_EVENTS, timeout_ms);
+  uint64_t wake = mt_get_tsc(impl);
+  for (int i = 0; i < n; i++) {
+    if (events[i].epdata.data != sch) rx_events++;
+  }
+
+  mt_pthread_mutex_lock(&sch->intr_mutex);
+  sch_rx_intr_disarm(sch);
+  sch->stat_intr_sleep_cnt++;
+  if (rx_events) {
+    /* the latency from the rx interrupt to the polling */
+    uint64_t delta = mt_get_tsc(impl) - wake;
+    sch->stat_intr_wake_cnt++;
+    sch->stat_intr_wake_ns_sum += delta;
+    sch->stat_intr_wake_ns_max = RTE_MAX(delta, sch->stat_intr_wake_ns_max);
+  } else if (!n) {
+    sch->stat_intr_timeout_cnt++;
+  }
+  mt_pthread_mutex_unlock(&sch->intr_mutex);
+}
+
 static int sch_tasklet_sleep(struct mtl_main_impl* impl, struct mt_sch_impl* sch) {
   /* get sleep us */
   uint64_t sleep_us = mt_sch_default_sleep_us(impl);
@@ -44,22 +201,28 @@ static int sch_tasklet_sleep(struct mtl_main_impl* impl, struct mt_sch_impl* sch
   int num_tasklet = sch->max_tasklet_idx;
   struct mt_sch_tasklet_impl* tasklet;
   uint64_t advice_sleep_us;
+  uint64_t start = mt_get_tsc(impl);
+  /* all rx queues are quiet, wait on the rx interrupt */
+  bool intr = sch_rx_intr_arm(impl, sch, start);
 
+  if (intr) sleep_us = MT_SCH_RX_INTR_SLEEP_MAX_US;
   if (force_sleep_us) {
     sleep_us = force_sleep_us;
   } else {
     for (int i = 0; i < num_tasklet; i++) {
       tasklet = sch->tasklet[i];
       if (!tasklet) continue;
+      if (intr && tasklet->ops.intr_rx) continue;
       advice_sleep_us = tasklet->ops.advice_sleep_us;
       if (advice_sleep_us && (advice_sleep_us < sleep_us)) sleep_us = advice_sleep_us;
     }
   }
-  dbg("%s(%d), sleep_us %" PRIu64 "\n", __func__, sch->idx, sleep_us);
+  dbg("%s(%d), sleep_us %" PRIu64 " intr %d\n", __func__, sch->idx, sleep_us, intr);
 
   /* sleep now */
-  uint64_t start = mt_get_tsc(impl);
-  if (sleep_us < mt_sch_zero_sleep_thresh_us(impl)) {
+  if (intr) {
+    sch_rx_intr_wait(impl, sch, sleep_us);
+  } else if (sleep_us < mt_sch_zero_sleep_thresh_us(impl)) {
     mt_sleep_ms(0);
   } else {
     struct timespec abs_time;
@@ -94,6 +257,18 @@ static int sch_tasklet_sleep(struct mtl_main_impl* impl, struct mt_sch_impl* sch
   return 0;
 }
 
+static void sch_busy_ratio_update(struct mt_sch_impl* sch, uint64_t loop_s,
+                                  uint64_t loop_e, bool busy) {
+  if (busy) sch->busy_ratio_busy_ns += loop_e - loop_s;
+  /* cal cpu busy ratio on every 5s, no matter the sch sleep or busy polling */
+  uint64_t busy_ratio_dur_ns = loop_e - sch->busy_ratio_start_ns;
+  if (busy_ratio_dur_ns > (5 * (uint64_t)NS_PER_S)) {
+    sch->busy_ratio_score = (float)sch->busy_ratio_busy_ns * 100.0 / busy_ratio_dur_ns;
+    sch->busy_ratio_busy_ns = 0;
+    sch->busy_ratio_start_ns = loop_e;
+  }
+}
+
 static int sch_tasklet_func(void* args) {
   struct mt_sch_impl* sch = args;
   struct mtl_main_impl* impl = sch->parnet;
@@ -103,6 +278,7 @@ static int sch_tasklet_func(void* args) {
   struct mt_sch_tasklet_impl* tasklet;
   bool time_measure = mt_has_tasklet_time_measure(impl);
   uint64_t tsc_s = 0;
+  uint64_t loop_s, loop_e;
 
   num_tasklet = sch->max_tasklet_idx;
   info("%s(%d), start with %d tasklets\n", __func__, idx, num_tasklet);
@@ -122,10 +298,14 @@ static int sch_tasklet_func(void* args) {
   }
 
   sch->sleep_ratio_start_ns = mt_get_tsc(impl);
+  sch->busy_ratio_start_ns = sch->sleep_ratio_start_ns;
+  sch->busy_ratio_busy_ns = 0;
+  sch->busy_ratio_score = 0;
 
   while (rte_atomic32_read(&sch->request_stop) == 0) {
     int pending = MT_TASKLET_ALL_DONE;
 
+    loop_s = mt_get_tsc(impl);
     num_tasklet = sch->max_tasklet_idx;
     for (i = 0; i < num_tasklet; i++) {
       tasklet = sch->tasklet[i];
@@ -141,6 +321,8 @@ static int sch_tasklet_func(void* args) {
         tasklet->stat_time_cnt++;
       }
     }
+    loop_e = mt_get_tsc(impl);
+    sch_busy_ratio_update(sch, loop_s, loop_e, pending != MT_TASKLET_ALL_DONE);
     if (sch->allow_sleep && (pending == MT_TASKLET_ALL_DONE)) {
       sch_tasklet_sleep(impl, sch);
     }
@@ -177,11 +359,19 @@ static int sch_start(struct mt_sch_impl* sch) {
   }
 
   mt_sch_set_cpu_busy(sch, false);
+  sch->elastic_high_cnt = 0;
+  sch->elastic_low_cnt = 0;
   rte_atomic32_set(&sch->request_stop, 0);
   rte_atomic32_set(&sch->stopped, 0);
 
   if (!sch->run_in_thread) {
-    ret = mt_dev_get_lcore(sch->parnet, &sch->lcore);
+    ret = mt_dev_get_socket_lcore(sch->parnet, sch->socket_id, &sch->lcore);
+    if (ret < 0) {
+      /* no lcore local to the port, fallback to any lcore with remote memory access */
+      warn("%s(%d), no lcore on socket %d, try other sockets\n", __func__, idx,
+           sch->socket_id);
+      ret = mt_dev_get_socket_lcore(sch->parnet, SOCKET_ID_ANY, &sch->lcore);
+    }
     if (ret < 0) {
       err("%s(%d), get lcore fail %d\n", __func__, idx, ret);
       sch_unlock(sch);
@@ -199,7 +389,8 @@ static int sch_start(struct mt_sch_impl* sch) {
 
   rte_atomic32_set(&sch->started, 1);
   if (!sch->run_in_thread)
-    info("%s(%d), succ on lcore %u\n", __func__, idx, sch->lcore);
+    info("%s(%d), succ on lcore %u socket %d\n", __func__, idx, sch->lcore,
+         rte_lcore_to_socket_id(sch->lcore));
   else
     info("%s(%d), succ on tid %lu\n", __func__, idx, sch->tid);
   sch_unlock(sch);
@@ -218,6 +409,7 @@ static int sch_stop(struct mt_sch_impl* sch) {
   }
 
   rte_atomic32_set(&sch->request_stop, 1);
+  sch_rx_intr_wakeup(sch);
   while (rte_atomic32_read(&sch->stopped) == 0) {
     mt_sleep_ms(10);
   }
@@ -236,8 +428,13 @@ static int sch_stop(struct mt_sch_impl* sch) {
   return 0;
 }
 
+static bool sch_socket_match(int sch_socket, int socket) {
+  if ((sch_socket == SOCKET_ID_ANY) || (socket == SOCKET_ID_ANY)) return true;
+  return mt_socket_match(sch_socket, socket);
+}
+
 static struct mt_sch_impl* sch_request(struct mtl_main_impl* impl, enum mt_sch_type type,
-                                       mt_sch_mask_t mask) {
+                                       mt_sch_mask_t mask, int socket) {
   struct mt_sch_impl* sch;
 
   for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
@@ -249,6 +446,7 @@ static struct mt_sch_impl* sch_request(struct mtl_main_impl* impl, enum mt_sch_t
     sch_lock(sch);
     if (!mt_sch_is_active(sch)) { /* find one free sch */
       sch->type = type;
+      sch->socket_id = socket;
       rte_atomic32_inc(&sch->active);
       rte_atomic32_inc(&mt_sch_get_mgr(impl)->sch_cnt);
       sch_unlock(sch);
@@ -350,6 +548,8 @@ static void sch_stat(struct mt_sch_impl* sch) {
     }
   }
 
+  if (mt_has_sch_elastic(sch->parnet))
+    notice("SCH(%d): busy ratio %f\n", idx, mt_sch_busy_ratio(sch));
   if (sch->allow_sleep) {
     notice("SCH(%d): sleep %fms(ratio:%f), cnt %u, min %" PRIu64 "us, max %" PRIu64
            "us\n",
@@ -361,6 +561,12 @@ static void sch_stat(struct mt_sch_impl* sch) {
     sch->stat_sleep_ns_min = -1;
     sch->stat_sleep_ns_max = 0;
   }
+  if (sch->stat_intr_sleep_cnt) {
+    notice("SCH(%d): rx intr sleep %" PRIu64 ", wake %" PRIu64 ", timeout %" PRIu64
+           ", wake max %" PRIu64 "us\n",
+           idx, sch->stat_intr_sleep_cnt, sch->stat_intr_wake_cnt,
+           sch->stat_intr_timeout_cnt, sch->stat_intr_wake_ns_max / NS_PER_US);
+  }
   if (!mt_sch_started(sch)) {
     notice("SCH(%d): still not started\n", idx);
   }
@@ -481,6 +687,39 @@ int mt_sch_mrg_init(struct mtl_main_impl* impl, int data_quota_mbs_limit) {
     /* init mgr lock for video */
     mt_pthread_mutex_init(&sch->tx_video_mgr_mutex, NULL);
     mt_pthread_mutex_init(&sch->rx_video_mgr_mutex, NULL);
+
+    /* rx intr info init */
+    mt_pthread_mutex_init(&sch->intr_mutex, NULL);
+    MT_TAILQ_INIT(&sch->intr_queues);
+    sch->intr_epfd = -1;
+    sch->intr_wake_fd = -1;
+    if (mt_has_rx_intr(impl)) sch_rx_intr_init(sch);
+  }
+
+  if (mt_has_rx_intr(impl)) {
+    uint32_t idle_us = mt_get_user_params(impl)->rx_intr_idle_us;
+    if (!idle_us) idle_us = MT_SCH_RX_INTR_IDLE_US;
+    mgr->rx_intr_idle_ns = (uint64_t)idle_us * NS_PER_US;
+    info("%s, rx intr idle %uus\n", __func__, idle_us);
+  }
+
+  if (mt_has_sch_elastic(impl)) {
+    struct mtl_sch_elastic_params* p = &mt_get_user_params(impl)->sch_elastic;
+    struct mt_sch_elastic* elastic = &mgr->elastic;
+
+    elastic->max_lcores = p->max_lcores;
+    elastic->busy_high = p->busy_high ? p->busy_high : MT_SCH_ELASTIC_BUSY_HIGH;
+    elastic->busy_low = p->busy_low ? p->busy_low : MT_SCH_ELASTIC_BUSY_LOW;
+    elastic->periods =
+        p->hysteresis_periods ? p->hysteresis_periods : MT_SCH_ELASTIC_PERIODS;
+    if (elastic->busy_low >= elastic->busy_high) {
+      warn("%s, busy_low %f not below busy_high %f, use default\n", __func__,
+           elastic->busy_low, elastic->busy_high);
+      elastic->busy_high = MT_SCH_ELASTIC_BUSY_HIGH;
+      elastic->busy_low = MT_SCH_ELASTIC_BUSY_LOW;
+    }
+    info("%s, elastic max lcores %d, busy %f:%f, periods %d\n", __func__,
+         elastic->max_lcores, elastic->busy_high, elastic->busy_low, elastic->periods);
   }
 
   info("%s, succ with data quota %d M\n", __func__, data_quota_mbs_limit);
@@ -500,9 +739,15 @@ int mt_sch_mrg_uinit(struct mtl_main_impl* impl) {
     mt_pthread_mutex_destroy(&sch->sleep_wake_mutex);
     mt_pthread_cond_destroy(&sch->sleep_wake_cond);
 
+    sch_rx_intr_uinit(sch);
+    mt_pthread_mutex_destroy(&sch->intr_mutex);
+
     mt_pthread_mutex_destroy(&sch->mutex);
   }
 
+  if (mgr->stat_spawn || mgr->stat_retire)
+    info("%s, lcore spawn %u retire %u\n", __func__, mgr->stat_spawn, mgr->stat_retire);
+
   mt_pthread_mutex_destroy(&mgr->mgr_mutex);
   return 0;
 };
@@ -543,7 +788,15 @@ int mt_sch_put(struct mt_sch_impl* sch, int quota_mbs) {
       err("%s(%d), still has %d data_quota_mbs_total\n", __func__, sidx,
           sch->data_quota_mbs_total);
     /* stop and free sch */
+    bool retire = mt_started(impl) && mt_sch_started(sch);
+    unsigned int lcore = sch->lcore;
     ret = sch_stop(sch);
+    if ((ret >= 0) && retire) {
+      struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+      mgr->stat_retire++;
+      info("%s(%d), lcore %u retired\n", __func__, sidx, lcore);
+      sch_notify_event(impl, sch, MTL_SCH_EVENT_RETIRE);
+    }
     if (ret < 0) {
       err("%s(%d), sch_stop fail %d\n", __func__, sidx, ret);
     }
@@ -562,7 +815,7 @@ int mt_sch_put(struct mt_sch_impl* sch, int quota_mbs) {
 }
 
 struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
-                               enum mt_sch_type type, mt_sch_mask_t mask) {
+                               enum mt_sch_type type, mt_sch_mask_t mask, int socket) {
   int ret, idx;
   struct mt_sch_impl* sch;
   struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
@@ -576,11 +829,14 @@ struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
     if (!(mask & MTL_BIT64(idx))) continue;
     /* active and busy check */
     if (!mt_sch_is_active(sch) || sch->cpu_busy) continue;
+    /* numa check, keep the session on a lcore local to its port */
+    if (!sch_socket_match(sch->socket_id, socket)) continue;
     /* quota check */
     if (!sch_is_capable(sch, quota_mbs, type)) continue;
     ret = mt_sch_add_quota(sch, quota_mbs);
     if (ret >= 0) {
-      info("%s(%d), succ with quota_mbs %d\n", __func__, idx, quota_mbs);
+      info("%s(%d), succ with quota_mbs %d socket %d\n", __func__, idx, quota_mbs,
+           socket);
       rte_atomic32_inc(&sch->ref_cnt);
       sch_mgr_unlock(mgr);
       return sch;
@@ -588,7 +844,12 @@ struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
   }
 
   /* no quota, try to create one */
-  sch = sch_request(impl, type, mask);
+  if (!mt_sch_elastic_can_spawn(impl, 1)) {
+    err("%s, elastic max lcores %d reached\n", __func__, mgr->elastic.max_lcores);
+    sch_mgr_unlock(mgr);
+    return NULL;
+  }
+  sch = sch_request(impl, type, mask, socket);
   if (!sch) {
     err("%s, no free sch\n", __func__);
     sch_mgr_unlock(mgr);
@@ -612,6 +873,8 @@ struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
       sch_mgr_unlock(mgr);
       return NULL;
     }
+    mgr->stat_spawn++;
+    sch_notify_event(impl, sch, MTL_SCH_EVENT_SPAWN);
   }
 
   rte_atomic32_inc(&sch->ref_cnt);
@@ -668,3 +931,135 @@ void mt_sch_stat(struct mtl_main_impl* impl) {
     }
   }
 }
+
+int mt_sch_get_stats(struct mt_sch_impl* sch, struct mtl_sch_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+
+  /* the tasklet array is updated by the register/unregister under sch lock */
+  sch_lock(sch);
+  stats->lcore = sch->lcore;
+  for (int i = 0; i < sch->max_tasklet_idx; i++) {
+    if (sch->tasklet[i]) stats->tasklet_cnt++;
+  }
+  stats->busy_ratio = mt_sch_busy_ratio(sch);
+  stats->socket_id = mt_sch_socket_id(sch);
+  if (sch->tx_video_init)
+    stats->numa_remote_est_mbs += sch->tx_video_mgr.stat_numa_remote_est_mbs;
+  if (sch->rx_video_init)
+    stats->numa_remote_est_mbs += sch->rx_video_mgr.stat_numa_remote_est_mbs;
+  sch_unlock(sch);
+
+  mt_pthread_mutex_lock(&sch->intr_mutex);
+  stats->rx_intr_wakeups = sch->stat_intr_wake_cnt;
+  stats->rx_intr_wake_max_us = sch->stat_intr_wake_ns_max / NS_PER_US;
+  if (sch->stat_intr_wake_cnt)
+    stats->rx_intr_wake_avg_us =
+        (float)sch->stat_intr_wake_ns_sum / sch->stat_intr_wake_cnt / NS_PER_US;
+  mt_pthread_mutex_unlock(&sch->intr_mutex);
+
+  return 0;
+}
+
+bool mt_sch_elastic_can_spawn(struct mtl_main_impl* impl, int num) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+
+  if (!mt_has_sch_elastic(impl) || !mgr->elastic.max_lcores) return true;
+  if ((rte_atomic32_read(&mgr->sch_cnt) + num) > mgr->elastic.max_lcores) return false;
+  return true;
+}
+
+void mt_sch_elastic_update(struct mtl_main_impl* impl) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(impl);
+  struct mt_sch_elastic* elastic = &mgr->elastic;
+  struct mt_sch_impl* sch;
+
+  if (!mt_has_sch_elastic(impl)) return;
+
+  for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
+    sch = mt_sch_instance(impl, sch_idx);
+    if (!mt_sch_started(sch)) continue;
+
+    float ratio = mt_sch_busy_ratio(sch);
+    if (ratio > elastic->busy_high) {
+      sch->elastic_low_cnt = 0;
+      sch->elastic_high_cnt++;
+      if (sch->elastic_high_cnt == elastic->periods) {
+        info("%s(%d), overload, busy %f\n", __func__, sch_idx, ratio);
+        /* no new session on this sch */
+        mt_sch_set_cpu_busy(sch, true);
+        sch_notify_event(impl, sch, MTL_SCH_EVENT_OVERLOAD);
+      }
+    } else if (ratio < elastic->busy_low) {
+      sch->elastic_high_cnt = 0;
+      sch->elastic_low_cnt++;
+      if (sch->elastic_low_cnt == elastic->periods) {
+        info("%s(%d), idle, busy %f\n", __func__, sch_idx, ratio);
+        /* hysteresis, accept new session again only when it's idle */
+        mt_sch_set_cpu_busy(sch, false);
+        sch_notify_event(impl, sch, MTL_SCH_EVENT_IDLE);
+      }
+    } else {
+      sch->elastic_high_cnt = 0;
+      sch->elastic_low_cnt = 0;
+    }
+  }
+}
+
+int mt_sch_add_rx_intr(struct mt_sch_impl* sch, struct mt_rx_queue* queue) {
+  struct mtl_main_impl* impl = sch->parnet;
+  int idx = sch->idx;
+  int ret;
+
+  if (!mt_has_rx_intr(impl)) return 0;
+  if (queue->intr_sch) {
+    err("%s(%d), queue %u already on sch %d\n", __func__, idx, queue->queue_id,
+        queue->intr_sch->idx);
+    return -EIO;
+  }
+
+  mt_pthread_mutex_lock(&sch->intr_mutex);
+  queue->intr_capable = false;
+  if ((sch->intr_epfd >= 0) && mt_if(impl, queue->port)->rx_intr) {
+    ret = rte_eth_dev_rx_intr_ctl_q(queue->port_id, queue->queue_id, sch->intr_epfd,
+                                    RTE_INTR_EVENT_ADD, queue);
+    if (ret >= 0)
+      queue->intr_capable = true;
+    else
+      warn("%s(%d), rx intr ctl fail %d on queue %u, keep polling\n", __func__, idx,
+           ret, queue->queue_id);
+  }
+  if (!queue->intr_capable) sch->intr_poll_q_num++;
+  queue->intr_pkt_seen = true;
+  queue->intr_idle_ns = 0;
+  queue->intr_sch = sch;
+  MT_TAILQ_INSERT_TAIL(&sch->intr_queues, queue, intr_next);
+  mt_pthread_mutex_unlock(&sch->intr_mutex);
+
+  /* back to polling */
+  sch_rx_intr_wakeup(sch);
+  dbg("%s(%d), queue %u capable %d\n", __func__, idx, queue->queue_id,
+      queue->intr_capable);
+  return 0;
+}
+
+int mt_sch_del_rx_intr(struct mt_rx_queue* queue) {
+  struct mt_sch_impl* sch = queue->intr_sch;
+
+  if (!sch) return 0;
+
+  mt_pthread_mutex_lock(&sch->intr_mutex);
+  if (sch->intr_armed) rte_eth_dev_rx_intr_disable(queue->port_id, queue->queue_id);
+  if (queue->intr_capable) {
+    rte_eth_dev_rx_intr_ctl_q(queue->port_id, queue->queue_id, sch->intr_epfd,
+                              RTE_INTR_EVENT_DEL, NULL);
+    queue->intr_capable = false;
+  } else {
+    sch->intr_poll_q_num--;
+  }
+  MT_TAILQ_REMOVE(&sch->intr_queues, queue, intr_next);
+  queue->intr_sch = NULL;
+  mt_pthread_mutex_unlock(&sch->intr_mutex);
+
+  dbg("%s(%d), queue %u\n", __func__, sch->idx, queue->queue_id);
+  return 0;
+}
@@ -7,6 +7,18 @@
 
 #include "mt_main.h"
 
+/* default busy ratio to scale up/down for the elastic pool */
+#define MT_SCH_ELASTIC_BUSY_HIGH (90)
+#define MT_SCH_ELASTIC_BUSY_LOW (30)
+/* default continuous admin periods before scale */
+#define MT_SCH_ELASTIC_PERIODS (3)
+
+/* default quiet time of the rx queues before arm the rx interrupt */
+#define MT_SCH_RX_INTR_IDLE_US (100 * 1000)
+/* max sleep when the rx interrupt armed, the other tasklets may advise a shorter one */
+#define MT_SCH_RX_INTR_SLEEP_MAX_US (100 * 1000)
+#define MT_SCH_RX_INTR_EVENTS (8)
+
 static inline struct mt_sch_mgr* mt_sch_get_mgr(struct mtl_main_impl* impl) {
   return &impl->sch_mgr;
 }
@@ -29,6 +41,12 @@ static inline bool mt_sch_started(struct mt_sch_impl* sch) {
     return false;
 }
 
+/* numa socket of the running lcore, SOCKET_ID_ANY if run in thread or not started */
+static inline int mt_sch_socket_id(struct mt_sch_impl* sch) {
+  if (sch->run_in_thread || !mt_sch_started(sch)) return SOCKET_ID_ANY;
+  return rte_lcore_to_socket_id(sch->lcore);
+}
+
 static inline void mt_sch_enable_allow_sleep(struct mt_sch_impl* sch, bool enable) {
   sch->allow_sleep = enable;
 }
@@ -40,6 +58,27 @@ static inline bool mt_sch_has_busy(struct mt_sch_impl* sch) {
     return false;
 }
 
+/* busy ratio(0-100) in last 5s, the time of the tasklet loops which have pending work */
+static inline float mt_sch_busy_ratio(struct mt_sch_impl* sch) {
+  return sch->busy_ratio_score;
+}
+
+static inline bool mt_sch_elastic_overload(struct mt_sch_impl* sch) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(sch->parnet);
+  return sch->elastic_high_cnt >= mgr->elastic.periods;
+}
+
+static inline bool mt_sch_elastic_idle(struct mt_sch_impl* sch) {
+  struct mt_sch_mgr* mgr = mt_sch_get_mgr(sch->parnet);
+  return sch->elastic_low_cnt >= mgr->elastic.periods;
+}
+
+int mt_sch_add_rx_intr(struct mt_sch_impl* sch, struct mt_rx_queue* queue);
+int mt_sch_del_rx_intr(struct mt_rx_queue* queue);
+
+bool mt_sch_elastic_can_spawn(struct mtl_main_impl* impl, int num);
+void mt_sch_elastic_update(struct mtl_main_impl* impl);
+
 int mt_sch_mrg_init(struct mtl_main_impl* impl, int data_quota_mbs_limit);
 int mt_sch_mrg_uinit(struct mtl_main_impl* impl);
 
@@ -54,14 +93,17 @@ static inline void mt_tasklet_set_sleep(struct mt_sch_tasklet_impl* tasklet,
 
 int mt_sch_add_quota(struct mt_sch_impl* sch, int quota_mbs);
 
+/* socket: numa of the session port, only the sch serving this socket is selected */
 struct mt_sch_impl* mt_sch_get(struct mtl_main_impl* impl, int quota_mbs,
-                               enum mt_sch_type type, mt_sch_mask_t mask);
+                               enum mt_sch_type type, mt_sch_mask_t mask, int socket);
 int mt_sch_put(struct mt_sch_impl* sch, int quota_mbs);
 
 int mt_sch_start_all(struct mtl_main_impl* impl);
 int mt_sch_stop_all(struct mtl_main_impl* impl);
 
 void mt_sch_stat(struct mtl_main_impl* impl);
+/* snapshot for mtl_sch_get_stats, safe against the tasklet register/unregister */
+int mt_sch_get_stats(struct mt_sch_impl* sch, struct mtl_sch_stats* stats);
 
 static inline void mt_sch_set_cpu_busy(struct mt_sch_impl* sch, bool busy) {
   sch->cpu_busy = busy;
@@ -297,6 +297,53 @@ int mt_socket_remove_flow(struct mtl_main_impl* impl, enum mtl_port port,
 
   return 0;
 }
+static int socket_read_sysfs_u64(const char* if_name, const char* attr,
+                                 uint64_t* value) {
+  char path[128];
+  FILE* fp;
+  int ret;
+
+  snprintf(path, sizeof(path), "/sys/class/net/%s/%s", if_name, attr);
+  fp = fopen(path, "r");
+  if (!fp) {
+    dbg("%s, open %s fail\n", __func__, path);
+    return -EIO;
+  }
+  ret = fscanf(fp, "%" SCNu64, value);
+  fclose(fp);
+  if (ret != 1) return -EIO;
+
+  return 0;
+}
+
+int mt_socket_check_busy_poll(struct mtl_main_impl* impl, enum mtl_port port) {
+  const char* if_name = mt_get_user_params(impl)->port[port];
+  uint64_t defer_hard_irqs = 0, gro_flush_timeout = 0;
+  int ret;
+
+  ret = socket_read_sysfs_u64(if_name, "napi_defer_hard_irqs", &defer_hard_irqs);
+  if (ret < 0) {
+    warn("%s(%d), no napi_defer_hard_irqs for %s, kernel too old?\n", __func__, port,
+         if_name);
+    return ret;
+  }
+  ret = socket_read_sysfs_u64(if_name, "gro_flush_timeout", &gro_flush_timeout);
+  if (ret < 0) return ret;
+
+  /* preferred busy polling only take effect if irq is deferred */
+  if (!defer_hard_irqs || !gro_flush_timeout) {
+    warn("%s(%d), busy poll not effective for %s, defer_hard_irqs %" PRIu64
+         " gro_flush_timeout %" PRIu64 "\n",
+         __func__, port, if_name, defer_hard_irqs, gro_flush_timeout);
+    warn("%s(%d), pls set both napi_defer_hard_irqs and gro_flush_timeout\n", __func__,
+         port);
+    return -EINVAL;
+  }
+
+  info("%s(%d), defer_hard_irqs %" PRIu64 " gro_flush_timeout %" PRIu64 "\n", __func__,
+       port, defer_hard_irqs, gro_flush_timeout);
+  return 0;
+}
 #else
 int mt_socket_get_if_ip(char* if_name, uint8_t ip[MTL_IP_ADDR_LEN]) { return -ENOTSUP; }
 
@@ -325,6 +372,10 @@ int mt_socket_remove_flow(struct mtl_main_impl* impl, enum mtl_port port,
                           uint16_t queue_id, struct mt_rx_flow* flow) {
   return -ENOTSUP;
 }
+
+int mt_socket_check_busy_poll(struct mtl_main_impl* impl, enum mtl_port port) {
+  return -ENOTSUP;
+}
 #endif
 
 int mtl_get_if_ip(char* if_name, uint8_t ip[MTL_IP_ADDR_LEN]) {
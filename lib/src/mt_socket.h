@@ -25,4 +25,6 @@ int mt_socket_add_flow(struct mtl_main_impl* impl, enum mtl_port port, uint16_t
 int mt_socket_remove_flow(struct mtl_main_impl* impl, enum mtl_port port,
                           uint16_t queue_id, struct mt_rx_flow* flow);
 
+int mt_socket_check_busy_poll(struct mtl_main_impl* impl, enum mtl_port port);
+
 #endif
@@ -0,0 +1,253 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "mt_state.h"
+
+#include "mt_arp.h"
+#include "mt_log.h"
+#include "mt_ptp.h"
+#include "mt_util.h"
+
+/* not the same cpu, or the file is broken, if the saved tsc is too far */
+static bool state_tsc_match(uint64_t saved_hz, uint64_t eal_hz) {
+  uint64_t diff = (saved_hz > eal_hz) ? (saved_hz - eal_hz) : (eal_hz - saved_hz);
+
+  if (!saved_hz) return false;
+  return diff <= eal_hz / 1000 / 1000 * MT_STATE_TSC_TOLERANCE_PPM;
+}
+
+static int state_clock_id_parse(const char* str, uint8_t* id) {
+  char end;
+  int ret = sscanf(str, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx:%hhx%c", &id[0], &id[1],
+                   &id[2], &id[3], &id[4], &id[5], &id[6], &id[7], &end);
+
+  return (ret == MT_STATE_CLOCK_ID_LEN) ? 0 : -EINVAL;
+}
+
+static void state_clock_id_format(const uint8_t* id, char* str, size_t len) {
+  snprintf(str, len, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", id[0], id[1], id[2],
+           id[3], id[4], id[5], id[6], id[7]);
+}
+
+static int state_port_by_name(struct mtl_main_impl* impl, const char* name) {
+  struct mtl_init_params* p = mt_get_user_params(impl);
+  int num_ports = mt_num_ports(impl);
+
+  for (int i = 0; i < num_ports; i++) {
+    if (!strncmp(p->port[i], name, MTL_PORT_MAX_LEN)) return i;
+  }
+
+  return -1;
+}
+
+static void state_load_pacing(struct mtl_main_impl* impl, enum mtl_port port,
+                              json_object* array) {
+  int num = json_object_array_length(array);
+  float pad_interval;
+  int cnt = 0, ret;
+
+  for (int i = 0; i < num; i++) {
+    json_object* item = json_object_array_get_idx(array, i);
+    json_object* bps_obj = mt_json_object_get(item, "rl_bps");
+    json_object* pad_obj = mt_json_object_get(item, "pad_interval");
+    if (!bps_obj || !pad_obj) continue;
+    uint64_t rl_bps = json_object_get_int64(bps_obj);
+    if (!rl_bps) continue;
+    /* trained already in this process */
+    if (mt_pacing_train_result_search(impl, port, rl_bps, &pad_interval) >= 0) continue;
+    ret = mt_pacing_train_result_add(impl, port, rl_bps, json_object_get_double(pad_obj));
+    if (ret < 0) break;
+    cnt++;
+  }
+
+  if (cnt) info("%s(%d), %d pacing results\n", __func__, port, cnt);
+}
+
+static void state_load_arp(struct mtl_main_impl* impl, enum mtl_port port,
+                           json_object* array) {
+  struct rte_ether_addr ea;
+  int num = json_object_array_length(array);
+  uint32_t ip;
+  int cnt = 0;
+
+  for (int i = 0; i < num; i++) {
+    json_object* item = json_object_array_get_idx(array, i);
+    json_object* ip_obj = mt_json_object_get(item, "ip");
+    json_object* mac_obj = mt_json_object_get(item, "mac");
+    if (!ip_obj || !mac_obj) continue;
+    if (inet_pton(AF_INET, json_object_get_string(ip_obj), &ip) != 1) continue;
+    if (rte_ether_unformat_addr(json_object_get_string(mac_obj), &ea) < 0) continue;
+    if (mt_arp_restore(impl, port, ip, &ea) < 0) continue;
+    cnt++;
+  }
+
+  if (cnt) info("%s(%d), %d arp entries\n", __func__, port, cnt);
+}
+
+static void state_load_ptp(struct mtl_main_impl* impl, enum mtl_port port,
+                           json_object* ptp_obj) {
+  json_object* master_obj = mt_json_object_get(ptp_obj, "master");
+  json_object* co_obj = mt_json_object_get(ptp_obj, "coefficient");
+  struct mt_ptp_clock_id master;
+
+  if (!mt_if_has_ptp(impl, port)) return;
+  if (!master_obj || !co_obj) return;
+  if (state_clock_id_parse(json_object_get_string(master_obj), &master.id[0]) < 0)
+    return;
+  mt_ptp_servo_restore(impl, port, &master, json_object_get_double(co_obj));
+}
+
+static bool state_load_tsc(struct mtl_main_impl* impl, json_object* root) {
+  json_object* obj = mt_json_object_get(root, "tsc_hz");
+  uint64_t eal_hz = rte_get_tsc_hz();
+  uint64_t tsc_hz;
+
+  if (!obj) return false;
+  tsc_hz = json_object_get_int64(obj);
+  if (!state_tsc_match(tsc_hz, eal_hz)) {
+    warn("%s, saved tsc_hz %" PRIu64 " too far from %" PRIu64 ", calibrate again\n",
+         __func__, tsc_hz, eal_hz);
+    return false;
+  }
+
+  impl->tsc_hz = tsc_hz;
+  info("%s, tsc_hz %" PRIu64 "\n", __func__, tsc_hz);
+  return true;
+}
+
+bool mt_state_load(struct mtl_main_impl* impl) {
+  const char* path = mt_get_user_params(impl)->state_file;
+  json_object *root, *obj, *ports;
+  bool tsc_restored;
+  int num_ports, port;
+
+  if (!path) return false;
+
+  root = json_object_from_file(path);
+  if (!root) {
+    info("%s, no state in %s, cold start\n", __func__, path);
+    return false;
+  }
+  obj = mt_json_object_get(root, "version");
+  if (!obj || (json_object_get_int(obj) != MT_STATE_VERSION)) {
+    warn("%s, version mismatch in %s, cold start\n", __func__, path);
+    json_object_put(root);
+    return false;
+  }
+
+  tsc_restored = state_load_tsc(impl, root);
+
+  ports = mt_json_object_get(root, "ports");
+  num_ports = ports ? json_object_array_length(ports) : 0;
+  for (int i = 0; i < num_ports; i++) {
+    json_object* port_obj = json_object_array_get_idx(ports, i);
+    obj = mt_json_object_get(port_obj, "port");
+    if (!obj) continue;
+    /* the port list may change between the two runs */
+    port = state_port_by_name(impl, json_object_get_string(obj));
+    if (port < 0) continue;
+
+    obj = mt_json_object_get(port_obj, "pacing");
+    if (obj) state_load_pacing(impl, port, obj);
+    obj = mt_json_object_get(port_obj, "arp");
+    if (obj) state_load_arp(impl, port, obj);
+    obj = mt_json_object_get(port_obj, "ptp");
+    if (obj) state_load_ptp(impl, port, obj);
+  }
+
+  json_object_put(root);
+  info("%s, warm start from %s\n", __func__, path);
+  return tsc_restored;
+}
+
+static json_object* state_save_port(struct mtl_main_impl* impl, enum mtl_port port) {
+  struct mt_pacing_train_result* pt = &mt_if(impl, port)->pt_results[0];
+  json_object* port_obj = json_object_new_object();
+  json_object *array, *item;
+  char str[64];
+
+  json_object_object_add(port_obj, "port",
+                         json_object_new_string(mt_get_user_params(impl)->port[port]));
+
+  array = json_object_new_array();
+  for (int i = 0; i < MT_MAX_RL_ITEMS; i++) {
+    if (!pt[i].rl_bps) continue;
+    item = json_object_new_object();
+    json_object_object_add(item, "rl_bps", json_object_new_int64(pt[i].rl_bps));
+    json_object_object_add(item, "pad_interval",
+                           json_object_new_double(pt[i].pacing_pad_interval));
+    json_object_array_add(array, item);
+  }
+  json_object_object_add(port_obj, "pacing", array);
+
+  uint32_t* ips = mt_zmalloc(sizeof(*ips) * MT_STATE_ARP_MAX);
+  struct rte_ether_addr* eas = mt_zmalloc(sizeof(*eas) * MT_STATE_ARP_MAX);
+  array = json_object_new_array();
+  if (ips && eas) {
+    int cnt = mt_arp_dump(impl, port, ips, eas, MT_STATE_ARP_MAX);
+    for (int i = 0; i < cnt; i++) {
+      item = json_object_new_object();
+      inet_ntop(AF_INET, &ips[i], str, sizeof(str));
+      json_object_object_add(item, "ip", json_object_new_string(str));
+      rte_ether_format_addr(str, sizeof(str), &eas[i]);
+      json_object_object_add(item, "mac", json_object_new_string(str));
+      json_object_array_add(array, item);
+    }
+  }
+  if (ips) mt_free(ips);
+  if (eas) mt_free(eas);
+  json_object_object_add(port_obj, "arp", array);
+
+  struct mt_ptp_clock_id master;
+  double coefficient;
+  if (mt_ptp_servo_get(impl, port, &master, &coefficient) >= 0) {
+    item = json_object_new_object();
+    state_clock_id_format(&master.id[0], str, sizeof(str));
+    json_object_object_add(item, "master", json_object_new_string(str));
+    json_object_object_add(item, "coefficient", json_object_new_double(coefficient));
+    json_object_object_add(port_obj, "ptp", item);
+  }
+
+  return port_obj;
+}
+
+bool mt_state_ptp_coefficient_valid(double coefficient) {
+  return fabs(coefficient - 1.0) <= MT_STATE_PTP_COEFFICIENT_MAX_DIFF;
+}
+
+int mt_state_save(struct mtl_main_impl* impl) {
+  const char* path = mt_get_user_params(impl)->state_file;
+  int num_ports = mt_num_ports(impl);
+  char tmp_path[256];
+  json_object *root, *ports;
+  int ret;
+
+  if (!path) return 0;
+
+  root = json_object_new_object();
+  json_object_object_add(root, "version", json_object_new_int(MT_STATE_VERSION));
+  json_object_object_add(root, "tsc_hz", json_object_new_int64(impl->tsc_hz));
+  ports = json_object_new_array();
+  for (int i = 0; i < num_ports; i++) {
+    json_object_array_add(ports, state_save_port(impl, i));
+  }
+  json_object_object_add(root, "ports", ports);
+
+  /* write a tmp file and rename, a crash never leaves a half written state */
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+  ret = json_object_to_file_ext(tmp_path, root, JSON_C_TO_STRING_PRETTY);
+  json_object_put(root);
+  if (ret < 0) {
+    err("%s, write %s fail\n", __func__, tmp_path);
+    return -EIO;
+  }
+  if (rename(tmp_path, path) < 0) {
+    err("%s, rename to %s fail\n", __func__, path);
+    remove(tmp_path);
+    return -EIO;
+  }
+
+  info("%s, saved to %s\n", __func__, path);
+  return 0;
+}
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _MT_LIB_STATE_HEAD_H_
+#define _MT_LIB_STATE_HEAD_H_
+
+#include "mt_main.h"
+
+#define MT_STATE_VERSION (1)
+/* the saved tsc hz is reused only if it's within this ppm of the eal estimate */
+#define MT_STATE_TSC_TOLERANCE_PPM (50)
+/* max arp entries saved for one port */
+#define MT_STATE_ARP_MAX (256)
+/* a ptp frequency coefficient out of 1.0 +- this is from a broken file */
+#define MT_STATE_PTP_COEFFICIENT_MAX_DIFF (1e-3)
+/* the ptp clock identity, 8 bytes */
+#define MT_STATE_CLOCK_ID_LEN (8)
+
+/*
+ * Warm restart, restore the state saved by the last process from the state_file of
+ * mtl_init_params: the tsc calibration, the pacing training results, the arp cache and
+ * the ptp servo. Call after the arp init and before the ptp and cni start, so the first
+ * ptp sync and arp request already use it. Return true if the tsc is restored.
+ */
+bool mt_state_load(struct mtl_main_impl* impl);
+
+/* save the state to the state_file for the next process, call before the modules uinit */
+int mt_state_save(struct mtl_main_impl* impl);
+
+/* a stale value from a broken file is worse than the 10 syncs to learn it again */
+bool mt_state_ptp_coefficient_valid(double coefficient);
+
+#endif
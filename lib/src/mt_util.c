@@ -4,6 +4,10 @@
 
 #include "mt_util.h"
 
+#if defined(RTE_ARCH_X86_64) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
 #include "mt_log.h"
 #include "mt_main.h"
 
@@ -123,6 +127,109 @@ void mt_rte_free(void* p) {
 }
 #endif
 
+#if defined(RTE_ARCH_X86_64) && defined(__SSE4_2__)
+#define MT_CRC32C_POLY (0x82F63B78) /* reflected castagnoli */
+/* bytes of each of the three interleaved streams */
+#define MT_CRC32C_LONG (2048)
+#define MT_CRC32C_SHORT (128)
+
+/* the ops to move a crc over MT_CRC32C_LONG/MT_CRC32C_SHORT zero bytes */
+static uint32_t g_crc32c_long[4][256];
+static uint32_t g_crc32c_short[4][256];
+
+/* a * b modulo the poly, reflected so x^0 is the top bit */
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b) {
+  uint32_t m = (uint32_t)1 << 31;
+  uint32_t p = 0;
+
+  for (;;) {
+    if (a & m) {
+      p ^= b;
+      if ((a & (m - 1)) == 0) break;
+    }
+    m >>= 1;
+    b = (b & 1) ? (b >> 1) ^ MT_CRC32C_POLY : b >> 1;
+  }
+  return p;
+}
+
+static void crc32c_zeros(uint32_t zeros[4][256], uint32_t len) {
+  uint32_t xn = (uint32_t)1 << 31; /* x^0 */
+  uint32_t x8 = (uint32_t)1 << 23; /* x^8, one zero byte */
+
+  for (uint32_t i = 0; i < len; i++) xn = crc32c_multmodp(x8, xn);
+  for (int k = 0; k < 4; k++) {
+    for (uint32_t b = 0; b < 256; b++) zeros[k][b] = crc32c_multmodp(xn, b << (8 * k));
+  }
+}
+
+static inline uint32_t crc32c_shift(uint32_t zeros[4][256], uint32_t crc) {
+  return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+         zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+static inline uint64_t crc32c_load(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/* three independent crc32 chains hide the 3 cycles latency of the instruction */
+static inline const uint8_t* crc32c_3way(uint64_t* crc, const uint8_t* p, uint32_t blk,
+                                         uint32_t zeros[4][256]) {
+  uint64_t crc0 = *crc, crc1 = 0, crc2 = 0;
+  const uint8_t* end = p + blk;
+
+  while (p < end) {
+    crc0 = _mm_crc32_u64(crc0, crc32c_load(p));
+    crc1 = _mm_crc32_u64(crc1, crc32c_load(p + blk));
+    crc2 = _mm_crc32_u64(crc2, crc32c_load(p + blk * 2));
+    p += 8;
+  }
+  crc0 = crc32c_shift(zeros, crc0) ^ crc1;
+  *crc = crc32c_shift(zeros, crc0) ^ crc2;
+  return p + blk * 2;
+}
+
+void mt_crc32c_init(void) {
+  crc32c_zeros(g_crc32c_long, MT_CRC32C_LONG);
+  crc32c_zeros(g_crc32c_short, MT_CRC32C_SHORT);
+}
+
+uint32_t mt_crc32c_update(uint32_t crc, const void* data, uint32_t len) {
+  const uint8_t* p = data;
+  uint64_t crc64 = crc;
+
+  while (len >= MT_CRC32C_LONG * 3) {
+    p = crc32c_3way(&crc64, p, MT_CRC32C_LONG, g_crc32c_long);
+    len -= MT_CRC32C_LONG * 3;
+  }
+  while (len >= MT_CRC32C_SHORT * 3) {
+    p = crc32c_3way(&crc64, p, MT_CRC32C_SHORT, g_crc32c_short);
+    len -= MT_CRC32C_SHORT * 3;
+  }
+  while (len >= 8) {
+    crc64 = _mm_crc32_u64(crc64, crc32c_load(p));
+    p += 8;
+    len -= 8;
+  }
+  crc = crc64;
+  while (len--) crc = _mm_crc32_u8(crc, *p++);
+  return crc;
+}
+#else
+void mt_crc32c_init(void) {}
+
+uint32_t mt_crc32c_update(uint32_t crc, const void* data, uint32_t len) {
+  /* armv8 crc32c instruction if available */
+  return rte_hash_crc(data, len, crc);
+}
+#endif
+
+bool mt_bitmap_test(uint8_t* bitmap, int idx) {
+  return (bitmap[idx / 8] & (0x1 << (idx % 8))) ? true : false;
+}
+
 bool mt_bitmap_test_and_set(uint8_t* bitmap, int idx) {
   int pos = idx / 8;
   int off = idx % 8;
@@ -153,6 +260,98 @@ int mt_ring_dequeue_clean(struct rte_ring* ring) {
   return 0;
 }
 
+uint16_t mt_rtp_tx_get_mbufs(struct rte_mempool* mp, struct rte_ring* ring,
+                             struct st_rtp_buf* bufs, uint16_t nb) {
+  struct rte_mbuf* pkts[MT_RTP_BULK_SIZE];
+  uint16_t got = 0;
+
+  /* no more than the ring can take back */
+  nb = RTE_MIN(nb, rte_ring_free_count(ring));
+
+  while (got < nb) {
+    uint16_t n = RTE_MIN(nb - got, MT_RTP_BULK_SIZE);
+    if (rte_pktmbuf_alloc_bulk(mp, pkts, n) < 0) {
+      dbg("%s, pkts alloc fail %u\n", __func__, n);
+      break;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+      bufs[got].mbuf = pkts[i];
+      bufs[got].usrptr = rte_pktmbuf_mtod(pkts[i], void*);
+      bufs[got].len = 0;
+      got++;
+    }
+  }
+
+  return got;
+}
+
+uint16_t mt_rtp_tx_put_mbufs(struct rte_ring* ring, struct st_rtp_buf* bufs,
+                             uint16_t nb, uint16_t max_len) {
+  struct rte_mbuf* pkts[MT_RTP_BULK_SIZE];
+  uint16_t valid = 0, done = 0;
+  unsigned int n;
+
+  for (uint16_t i = 0; i < nb; i++) {
+    struct rte_mbuf* pkt = bufs[i].mbuf;
+    uint16_t len = bufs[i].len;
+
+    if (!mt_rtp_len_valid(len) || (max_len && (len > max_len))) {
+      if (len) err("%s, invalid len %u at %u, allowed %u\n", __func__, len, i, max_len);
+      rte_pktmbuf_free(pkt);
+    } else {
+      pkt->data_len = pkt->pkt_len = len;
+      pkts[valid++] = pkt;
+    }
+    if ((valid < MT_RTP_BULK_SIZE) && (i < (nb - 1))) continue;
+
+    /* enqueue the chunk, it's full or the last one */
+    n = rte_ring_sp_enqueue_burst(ring, (void**)pkts, valid, NULL);
+    if (n < valid) {
+      err("%s, only %u of %u enqueued to the rte ring\n", __func__, n, valid);
+      rte_pktmbuf_free_bulk(&pkts[n], valid - n);
+    }
+    done += n;
+    valid = 0;
+  }
+
+  return done;
+}
+
+uint16_t mt_rtp_rx_get_mbufs(struct rte_ring* ring, struct st_rtp_buf* bufs,
+                             uint16_t nb) {
+  struct rte_mbuf* pkts[MT_RTP_BULK_SIZE];
+  size_t hdr_len = sizeof(struct rte_ether_hdr) + sizeof(struct rte_ipv4_hdr) +
+                   sizeof(struct rte_udp_hdr);
+  uint16_t got = 0;
+
+  while (got < nb) {
+    uint16_t burst = RTE_MIN(nb - got, MT_RTP_BULK_SIZE);
+    unsigned int n = rte_ring_sc_dequeue_burst(ring, (void**)pkts, burst, NULL);
+    for (unsigned int i = 0; i < n; i++) {
+      bufs[got].mbuf = pkts[i];
+      bufs[got].usrptr = rte_pktmbuf_mtod_offset(pkts[i], void*, hdr_len);
+      bufs[got].len = pkts[i]->data_len - hdr_len;
+      got++;
+    }
+    if (n < burst) break; /* ring empty */
+  }
+
+  return got;
+}
+
+void mt_rtp_free_mbufs(struct st_rtp_buf* bufs, uint16_t nb) {
+  struct rte_mbuf* pkts[MT_RTP_BULK_SIZE];
+  uint16_t cnt = 0;
+
+  for (uint16_t i = 0; i < nb; i++) {
+    if (bufs[i].mbuf) pkts[cnt++] = bufs[i].mbuf;
+    if ((cnt == MT_RTP_BULK_SIZE) || ((i == (nb - 1)) && cnt)) {
+      rte_pktmbuf_free_bulk(pkts, cnt);
+      cnt = 0;
+    }
+  }
+}
+
 void mt_mbuf_sanity_check(struct rte_mbuf** mbufs, uint16_t nb, char* tag) {
   struct rte_mbuf* mbuf;
 
@@ -200,6 +399,17 @@ int mt_build_port_map(struct mtl_main_impl* impl, char** ports, enum mtl_port* m
   return 0;
 }
 
+int mt_port_socket_id(struct mtl_main_impl* impl, const char* port) {
+  struct mtl_init_params* p = mt_get_user_params(impl);
+
+  for (int i = 0; i < p->num_ports; i++) {
+    if (0 == strncmp(p->port[i], port, MTL_PORT_MAX_LEN)) return mt_socket_id(impl, i);
+  }
+
+  /* invalid port name, reported by mt_build_port_map later */
+  return mt_socket_id(impl, MTL_PORT_P);
+}
+
 int mt_pacing_train_result_add(struct mtl_main_impl* impl, enum mtl_port port,
                                uint64_t rl_bps, float pad_interval) {
   struct mt_pacing_train_result* ptr = &mt_if(impl, port)->pt_results[0];
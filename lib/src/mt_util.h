@@ -37,10 +37,34 @@ static inline void mt_u32_to_ip(uint32_t group, uint8_t ip[MTL_IP_ADDR_LEN]) {
   ip[3] = group >> 24;
 }
 
+/* CRC32C(Castagnoli), start from MT_CRC32C_INIT and chain the data by update */
+#define MT_CRC32C_INIT (0xFFFFFFFF)
+
+/* build the tables to combine the interleaved streams, once before any update */
+void mt_crc32c_init(void);
+
+uint32_t mt_crc32c_update(uint32_t crc, const void* data, uint32_t len);
+
+static inline uint32_t mt_crc32c_final(uint32_t crc) { return ~crc; }
+
+bool mt_bitmap_test(uint8_t* bitmap, int idx);
+
 bool mt_bitmap_test_and_set(uint8_t* bitmap, int idx);
 
 int mt_ring_dequeue_clean(struct rte_ring* ring);
 
+/* max pkts moved in one mempool/ring op by the bulk rtp helpers, nb is split by it */
+#define MT_RTP_BULK_SIZE (64)
+
+/* bulk helpers of the rtp level get/put mbuf APIs, return the number of pkts */
+uint16_t mt_rtp_tx_get_mbufs(struct rte_mempool* mp, struct rte_ring* ring,
+                             struct st_rtp_buf* bufs, uint16_t nb);
+uint16_t mt_rtp_tx_put_mbufs(struct rte_ring* ring, struct st_rtp_buf* bufs,
+                             uint16_t nb, uint16_t max_len);
+uint16_t mt_rtp_rx_get_mbufs(struct rte_ring* ring, struct st_rtp_buf* bufs,
+                             uint16_t nb);
+void mt_rtp_free_mbufs(struct st_rtp_buf* bufs, uint16_t nb);
+
 void mt_mbuf_sanity_check(struct rte_mbuf** mbufs, uint16_t nb, char* tag);
 
 int mt_pacing_train_result_add(struct mtl_main_impl* impl, enum mtl_port port,
@@ -51,6 +75,8 @@ int mt_pacing_train_result_search(struct mtl_main_impl* impl, enum mtl_port port
 
 int mt_build_port_map(struct mtl_main_impl* impl, char** ports, enum mtl_port* maps,
                       int num_ports);
+/* numa socket of the port by name, the session memory and sch lcore are placed on it */
+int mt_port_socket_id(struct mtl_main_impl* impl, const char* port);
 
 /* logical session port to main(physical) port */
 static inline enum mtl_port mt_port_logic2phy(enum mtl_port* maps,
@@ -158,6 +184,36 @@ static inline void mt_mbuf_chain_sw(struct rte_mbuf* pkt, struct rte_mbuf* pkt_c
   pkt->data_len += pkt_chain->pkt_len;
 }
 
+/* the udp pseudo hdr sum over ipv6 without the length, fixed for one flow */
+static inline uint32_t mt_udp6_phdr_sum(const struct rte_ipv6_hdr* ipv6) {
+  uint32_t proto = htonl(IPPROTO_UDP);
+  uint32_t sum = __rte_raw_cksum(ipv6->src_addr, MTL_IP6_ADDR_LEN * 2, 0);
+
+  return __rte_raw_cksum(&proto, sizeof(proto), sum);
+}
+
+/* the pseudo hdr cksum for the udp cksum offload, len is the udp dgram_len */
+static inline uint16_t mt_udp6_phdr_cksum(uint32_t phdr_sum, rte_be16_t len) {
+  return __rte_raw_cksum_reduce(phdr_sum + len);
+}
+
+/*
+ * The udp cksum over ipv6, mandatory as no ipv4 like hdr cksum. l4_len(even) bytes of
+ * the udp and the following hdrs at l4, payload_sum is the __rte_raw_cksum of the
+ * payload after them, so the payload which is shared by the redundant pkt is read once.
+ */
+static inline uint16_t mt_udp6_cksum(uint32_t phdr_sum, rte_be16_t len, const void* l4,
+                                     uint16_t l4_len, uint32_t payload_sum) {
+  uint32_t sum = phdr_sum + len;
+  uint16_t cksum;
+
+  sum += __rte_raw_cksum(l4, l4_len, 0);
+  sum += payload_sum;
+  cksum = ~__rte_raw_cksum_reduce(sum);
+  /* zero means no cksum for udp, RFC 768 */
+  return cksum ? cksum : 0xffff;
+}
+
 int mt_ip_addr_check(uint8_t* ip);
 
 int st_rx_source_info_check(struct st_rx_source_info* src, int num_ports);
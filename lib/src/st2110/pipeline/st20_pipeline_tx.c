@@ -101,6 +101,7 @@ static int tx_st20p_frame_done(void* priv, uint16_t frame_idx,
   framebuff->dst.tfmt = meta->tfmt;
   framebuff->src.timestamp = meta->timestamp;
   framebuff->dst.timestamp = meta->timestamp;
+  framebuff->src.crc = framebuff->dst.crc = meta->crc;
 
   if (ctx->ops.notify_frame_done) { /* notify app which frame done */
     ctx->ops.notify_frame_done(ctx->ops.priv,
@@ -260,6 +261,7 @@ static int tx_st20p_create_transport(struct mtl_main_impl* impl, struct st20p_tx
   if (ops->flags & ST20P_TX_FLAG_USER_TIMESTAMP)
     ops_tx.flags |= ST20_TX_FLAG_USER_TIMESTAMP;
   if (ops->flags & ST20P_TX_FLAG_ENABLE_VSYNC) ops_tx.flags |= ST20_TX_FLAG_ENABLE_VSYNC;
+  if (ops->flags & ST20P_TX_FLAG_ENABLE_CRC) ops_tx.flags |= ST20_TX_FLAG_ENABLE_CRC;
 
   transport = st20_tx_create(impl, &ops_tx);
   if (!transport) {
@@ -412,6 +412,8 @@ st22p_rx_handle st22p_rx_create(mtl_handle mt, struct st22p_rx_ops* ops) {
     codestream_fmt = ST_FRAME_FMT_JPEGXS_CODESTREAM;
   } else if (ops->codec == ST22_CODEC_H264_CBR) {
     codestream_fmt = ST_FRAME_FMT_H264_CBR_CODESTREAM;
+  } else if (ops->codec == ST22_CODEC_H265_CBR) {
+    codestream_fmt = ST_FRAME_FMT_H265_CBR_CODESTREAM;
   } else {
     err("%s(%d), unknow codec %d\n", __func__, idx, ops->codec);
     return NULL;
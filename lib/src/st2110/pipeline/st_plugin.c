@@ -12,6 +12,54 @@ static inline struct st_plugin_mgr* st_get_plugins_mgr(struct mtl_main_impl* imp
   return &impl->plugin_mgr;
 }
 
+static void st_plugin_cost_get(struct st_plugin_session_cost* cost, void* meta) {
+  for (int i = 0; i < ST_PLUGIN_COST_SLOTS; i++) {
+    if (cost->metas[i]) continue;
+    if (!rte_atomic64_cmpset(&cost->metas[i], 0, (uint64_t)meta)) continue;
+    cost->get_ns[i] = mt_get_monotonic_time();
+    return;
+  }
+  /* more frames in flight than the slots, skip this sample */
+}
+
+static void st_plugin_cost_put(struct st_plugin_session_cost* cost, void* meta) {
+  uint64_t cost_ns;
+
+  for (int i = 0; i < ST_PLUGIN_COST_SLOTS; i++) {
+    if (cost->metas[i] != (uint64_t)meta) continue;
+    cost_ns = mt_get_monotonic_time() - cost->get_ns[i];
+    cost->metas[i] = 0;
+    /* ewma with 1/8 weight for the new sample */
+    if (cost->frames)
+      cost->cost_ns = (cost->cost_ns * 7 + cost_ns) / 8;
+    else
+      cost->cost_ns = cost_ns;
+    cost->frames++;
+    cost->stat_frames++;
+    cost->stat_cost_ns += cost_ns;
+    return;
+  }
+}
+
+/* busy time(ns) of one second, a session without sample yet uses the default cost */
+static uint64_t st_plugin_cost_load(struct st_plugin_session_cost* cost, enum st_fps fps,
+                                    uint64_t default_cost_ns) {
+  uint64_t cost_ns = cost->frames ? cost->cost_ns : default_cost_ns;
+
+  return cost_ns * st_frame_rate(fps);
+}
+
+static void st_plugin_cost_dump(const char* dev, int idx,
+                                struct st_plugin_session_cost* cost, enum st_fps fps) {
+  if (!cost->stat_frames) return;
+
+  notice("%s(%d), frames %u, avg cost %.2fus, load %.1f%%\n", dev, idx,
+         cost->stat_frames, (float)cost->stat_cost_ns / cost->stat_frames / NS_PER_US,
+         (float)st_plugin_cost_load(cost, fps, 0) * 100 / NS_PER_S);
+  cost->stat_frames = 0;
+  cost->stat_cost_ns = 0;
+}
+
 static int st_plugin_free(struct st_dl_plugin_impl* plugin) {
   if (plugin->free) plugin->free(plugin->handle);
   if (plugin->dl_handle) {
@@ -28,14 +76,19 @@ int st_plugins_init(struct mtl_main_impl* impl) {
 
   mt_pthread_mutex_init(&mgr->lock, NULL);
   mt_pthread_mutex_init(&mgr->plugins_lock, NULL);
+  mt_pthread_mutex_init(&mgr->workers_lock, NULL);
 
   info("%s, succ\n", __func__);
   return 0;
 }
 
+static int st_plugin_workers_stop(struct mtl_main_impl* impl);
+
 int st_plugins_uinit(struct mtl_main_impl* impl) {
   struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
 
+  st_plugin_workers_stop(impl);
+
   for (int i = 0; i < ST_MAX_DL_PLUGINS; i++) {
     if (mgr->plugins[i]) {
       dbg("%s, active plugin in %d\n", __func__, i);
@@ -66,6 +119,7 @@ int st_plugins_uinit(struct mtl_main_impl* impl) {
   }
   mt_pthread_mutex_destroy(&mgr->lock);
   mt_pthread_mutex_destroy(&mgr->plugins_lock);
+  mt_pthread_mutex_destroy(&mgr->workers_lock);
 
   return 0;
 }
@@ -113,6 +167,7 @@ static struct st22_encode_session_impl* st22_get_encoder_session(
       session_impl->session = session;
       session_impl->codestream_max_size = create_req->max_codestream_size;
       session_impl->req = *req;
+      memset(&session_impl->cost, 0, sizeof(session_impl->cost));
       session_impl->type = MT_ST22_HANDLE_PIPELINE_ENCODE;
       info("%s(%d), get one session at %d on dev %s, max codestream size %ld\n", __func__,
            idx, i, dev->name, session_impl->codestream_max_size);
@@ -143,28 +198,68 @@ static bool st22_encoder_is_capable(struct st22_encoder_dev* dev,
   return true;
 }
 
+static uint64_t st22_encode_dev_load(struct st22_encode_dev_impl* dev_impl) {
+  struct st22_encode_session_impl* session;
+  uint64_t cost_sum = 0, load = 0;
+  int measured = 0;
+
+  /* the sessions just created cost as much as the average of this dev */
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_ENCODER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session || !session->cost.frames) continue;
+    cost_sum += session->cost.cost_ns;
+    measured++;
+  }
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_ENCODER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session) continue;
+    load += st_plugin_cost_load(&session->cost, session->req.req.fps,
+                                measured ? cost_sum / measured : 0);
+  }
+
+  return load;
+}
+
 struct st22_encode_session_impl* st22_get_encoder(struct mtl_main_impl* impl,
                                                   struct st22_get_encoder_request* req) {
   struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
   struct st22_encoder_dev* dev;
   struct st22_encode_dev_impl* dev_impl;
+  struct st22_encode_dev_impl* best;
   struct st22_encode_session_impl* session_impl;
+  bool tried[ST_MAX_ENCODER_DEV];
+  uint64_t load, best_load;
 
+  memset(tried, 0, sizeof(tried));
   mt_pthread_mutex_lock(&mgr->lock);
-  for (int i = 0; i < ST_MAX_ENCODER_DEV; i++) {
-    dev_impl = mgr->encode_devs[i];
-    if (!dev_impl) continue;
-    dbg("%s(%d), try to find one dev\n", __func__, i);
-    dev = &mgr->encode_devs[i]->dev;
-    if (!st22_encoder_is_capable(dev, req)) {
-      dbg("%s(%d), %s not capable\n", __func__, i, dev->name);
-      continue;
+  /* least loaded capable dev first, then the next one if it has no free slot */
+  while (true) {
+    best = NULL;
+    best_load = UINT64_MAX;
+    for (int i = 0; i < ST_MAX_ENCODER_DEV; i++) {
+      dev_impl = mgr->encode_devs[i];
+      if (!dev_impl || tried[i]) continue;
+      dev = &dev_impl->dev;
+      if (!st22_encoder_is_capable(dev, req)) {
+        dbg("%s(%d), %s not capable\n", __func__, i, dev->name);
+        continue;
+      }
+      load = st22_encode_dev_load(dev_impl);
+      if (!best || load < best_load ||
+          (load == best_load &&
+           rte_atomic32_read(&dev_impl->ref_cnt) < rte_atomic32_read(&best->ref_cnt))) {
+        best = dev_impl;
+        best_load = load;
+      }
     }
+    if (!best) break;
+    tried[best->idx] = true;
 
-    dbg("%s(%d), try to find one session\n", __func__, i);
-    session_impl = st22_get_encoder_session(dev_impl, req);
+    dbg("%s(%d), try to find one session, load %" PRIu64 "\n", __func__, best->idx,
+        best_load);
+    session_impl = st22_get_encoder_session(best, req);
     if (session_impl) {
-      rte_atomic32_inc(&dev_impl->ref_cnt);
+      rte_atomic32_inc(&best->ref_cnt);
       mt_pthread_mutex_unlock(&mgr->lock);
       return session_impl;
     }
@@ -218,6 +313,7 @@ static struct st22_decode_session_impl* st22_get_decoder_session(
     if (session) {
       session_impl->session = session;
       session_impl->req = *req;
+      memset(&session_impl->cost, 0, sizeof(session_impl->cost));
       session_impl->type = MT_ST22_HANDLE_PIPELINE_DECODE;
       info("%s(%d), get one session at %d on dev %s\n", __func__, idx, i, dev->name);
       info("%s(%d), input fmt: %s, output fmt: %s\n", __func__, idx,
@@ -247,25 +343,65 @@ static bool st22_decoder_is_capable(struct st22_decoder_dev* dev,
   return true;
 }
 
+static uint64_t st22_decode_dev_load(struct st22_decode_dev_impl* dev_impl) {
+  struct st22_decode_session_impl* session;
+  uint64_t cost_sum = 0, load = 0;
+  int measured = 0;
+
+  /* the sessions just created cost as much as the average of this dev */
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_DECODER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session || !session->cost.frames) continue;
+    cost_sum += session->cost.cost_ns;
+    measured++;
+  }
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_DECODER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session) continue;
+    load += st_plugin_cost_load(&session->cost, session->req.req.fps,
+                                measured ? cost_sum / measured : 0);
+  }
+
+  return load;
+}
+
 struct st22_decode_session_impl* st22_get_decoder(struct mtl_main_impl* impl,
                                                   struct st22_get_decoder_request* req) {
   struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
   struct st22_decoder_dev* dev;
   struct st22_decode_dev_impl* dev_impl;
+  struct st22_decode_dev_impl* best;
   struct st22_decode_session_impl* session_impl;
+  bool tried[ST_MAX_DECODER_DEV];
+  uint64_t load, best_load;
 
+  memset(tried, 0, sizeof(tried));
   mt_pthread_mutex_lock(&mgr->lock);
-  for (int i = 0; i < ST_MAX_DECODER_DEV; i++) {
-    dev_impl = mgr->decode_devs[i];
-    if (!dev_impl) continue;
-    dbg("%s(%d), try to find one dev\n", __func__, i);
-    dev = &mgr->decode_devs[i]->dev;
-    if (!st22_decoder_is_capable(dev, req)) continue;
-
-    dbg("%s(%d), try to find one session\n", __func__, i);
-    session_impl = st22_get_decoder_session(dev_impl, req);
+  /* least loaded capable dev first, then the next one if it has no free slot */
+  while (true) {
+    best = NULL;
+    best_load = UINT64_MAX;
+    for (int i = 0; i < ST_MAX_DECODER_DEV; i++) {
+      dev_impl = mgr->decode_devs[i];
+      if (!dev_impl || tried[i]) continue;
+      dev = &dev_impl->dev;
+      if (!st22_decoder_is_capable(dev, req)) continue;
+      load = st22_decode_dev_load(dev_impl);
+      if (!best || load < best_load ||
+          (load == best_load &&
+           rte_atomic32_read(&dev_impl->ref_cnt) < rte_atomic32_read(&best->ref_cnt))) {
+        best = dev_impl;
+        best_load = load;
+      }
+    }
+    if (!best) break;
+    tried[best->idx] = true;
+
+    dbg("%s(%d), try to find one session, load %" PRIu64 "\n", __func__, best->idx,
+        best_load);
+    session_impl = st22_get_decoder_session(best, req);
     if (session_impl) {
-      rte_atomic32_inc(&dev_impl->ref_cnt);
+      rte_atomic32_inc(&best->ref_cnt);
       mt_pthread_mutex_unlock(&mgr->lock);
       return session_impl;
     }
@@ -319,6 +455,7 @@ static struct st20_convert_session_impl* st20_get_converter_session(
     if (session) {
       session_impl->session = session;
       session_impl->req = *req;
+      memset(&session_impl->cost, 0, sizeof(session_impl->cost));
       session_impl->type = MT_ST20_HANDLE_PIPELINE_CONVERT;
       info("%s(%d), get one session at %d on dev %s\n", __func__, idx, i, dev->name);
       info("%s(%d), input fmt: %s, output fmt: %s\n", __func__, idx,
@@ -348,25 +485,65 @@ static bool st20_converter_is_capable(struct st20_converter_dev* dev,
   return true;
 }
 
+static uint64_t st20_convert_dev_load(struct st20_convert_dev_impl* dev_impl) {
+  struct st20_convert_session_impl* session;
+  uint64_t cost_sum = 0, load = 0;
+  int measured = 0;
+
+  /* the sessions just created cost as much as the average of this dev */
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_CONVERTER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session || !session->cost.frames) continue;
+    cost_sum += session->cost.cost_ns;
+    measured++;
+  }
+  for (int i = 0; i < ST_MAX_SESSIIONS_PER_CONVERTER; i++) {
+    session = &dev_impl->sessions[i];
+    if (!session->session) continue;
+    load += st_plugin_cost_load(&session->cost, session->req.req.fps,
+                                measured ? cost_sum / measured : 0);
+  }
+
+  return load;
+}
+
 struct st20_convert_session_impl* st20_get_converter(
     struct mtl_main_impl* impl, struct st20_get_converter_request* req) {
   struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
   struct st20_converter_dev* dev;
   struct st20_convert_dev_impl* dev_impl;
+  struct st20_convert_dev_impl* best;
   struct st20_convert_session_impl* session_impl;
+  bool tried[ST_MAX_CONVERTER_DEV];
+  uint64_t load, best_load;
 
+  memset(tried, 0, sizeof(tried));
   mt_pthread_mutex_lock(&mgr->lock);
-  for (int i = 0; i < ST_MAX_CONVERTER_DEV; i++) {
-    dev_impl = mgr->convert_devs[i];
-    if (!dev_impl) continue;
-    dbg("%s(%d), try to find one dev\n", __func__, i);
-    dev = &mgr->convert_devs[i]->dev;
-    if (!st20_converter_is_capable(dev, req)) continue;
-
-    dbg("%s(%d), try to find one session\n", __func__, i);
-    session_impl = st20_get_converter_session(dev_impl, req);
+  /* least loaded capable dev first, then the next one if it has no free slot */
+  while (true) {
+    best = NULL;
+    best_load = UINT64_MAX;
+    for (int i = 0; i < ST_MAX_CONVERTER_DEV; i++) {
+      dev_impl = mgr->convert_devs[i];
+      if (!dev_impl || tried[i]) continue;
+      dev = &dev_impl->dev;
+      if (!st20_converter_is_capable(dev, req)) continue;
+      load = st20_convert_dev_load(dev_impl);
+      if (!best || load < best_load ||
+          (load == best_load &&
+           rte_atomic32_read(&dev_impl->ref_cnt) < rte_atomic32_read(&best->ref_cnt))) {
+        best = dev_impl;
+        best_load = load;
+      }
+    }
+    if (!best) break;
+    tried[best->idx] = true;
+
+    dbg("%s(%d), try to find one session, load %" PRIu64 "\n", __func__, best->idx,
+        best_load);
+    session_impl = st20_get_converter_session(best, req);
     if (session_impl) {
-      rte_atomic32_inc(&dev_impl->ref_cnt);
+      rte_atomic32_inc(&best->ref_cnt);
       mt_pthread_mutex_unlock(&mgr->lock);
       return session_impl;
     }
@@ -387,6 +564,7 @@ static int st22_encode_dev_dump(struct st22_encode_dev_impl* encode) {
     session = &encode->sessions[i];
     if (!session->session) continue;
     if (session->req.dump) session->req.dump(session->req.priv);
+    st_plugin_cost_dump(encode->name, i, &session->cost, session->req.req.fps);
   }
 
   return 0;
@@ -401,6 +579,7 @@ static int st22_decode_dev_dump(struct st22_decode_dev_impl* decode) {
     session = &decode->sessions[i];
     if (!session->session) continue;
     if (session->req.dump) session->req.dump(session->req.priv);
+    st_plugin_cost_dump(decode->name, i, &session->cost, session->req.req.fps);
   }
 
   return 0;
@@ -415,11 +594,39 @@ static int st20_convert_dev_dump(struct st20_convert_dev_impl* convert) {
     session = &convert->sessions[i];
     if (!session->session) continue;
     if (session->req.dump) session->req.dump(session->req.priv);
+    st_plugin_cost_dump(convert->name, i, &session->cost, session->req.req.fps);
   }
 
   return 0;
 }
 
+static int st_plugin_workers_dump(struct mtl_main_impl* impl) {
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+  struct st_plugin_job_impl* job;
+
+  if (!wmgr->started) return 0;
+
+  mt_pthread_mutex_lock(&mgr->workers_lock);
+  notice("PLUGIN workers: %d workers, %d jobs, %u queued\n", wmgr->nb_workers,
+         wmgr->nb_jobs, rte_ring_count(wmgr->ring));
+  for (int i = 0; i < ST_MAX_PLUGIN_JOBS; i++) {
+    job = wmgr->jobs[i];
+    if (!job || !job->stat_frames) continue;
+    notice("PLUGIN job(%d,%s), frames %u idle %u, avg %.2fus, max wait %.2fus\n", i,
+           job->name, job->stat_frames, job->stat_idle,
+           (float)job->stat_process_ns / job->stat_frames / NS_PER_US,
+           (float)job->stat_wait_max_ns / NS_PER_US);
+    job->stat_frames = 0;
+    job->stat_idle = 0;
+    job->stat_process_ns = 0;
+    job->stat_wait_max_ns = 0;
+  }
+  mt_pthread_mutex_unlock(&mgr->workers_lock);
+
+  return 0;
+}
+
 int st_plugins_dump(struct mtl_main_impl* impl) {
   struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
   struct st22_encode_dev_impl* encode;
@@ -444,6 +651,7 @@ int st_plugins_dump(struct mtl_main_impl* impl) {
   }
   mt_pthread_mutex_unlock(&mgr->lock);
 
+  st_plugin_workers_dump(impl);
   return 0;
 }
 
@@ -720,7 +928,10 @@ struct st22_encode_frame_meta* st22_encoder_get_frame(st22p_encode_session sessi
     return NULL;
   }
 
-  return session_impl->req.get_frame(session_impl->req.priv);
+  struct st22_encode_frame_meta* frame =
+      session_impl->req.get_frame(session_impl->req.priv);
+  if (frame) st_plugin_cost_get(&session_impl->cost, frame);
+  return frame;
 }
 
 int st22_encoder_put_frame(st22p_encode_session session,
@@ -732,6 +943,7 @@ int st22_encoder_put_frame(st22p_encode_session session,
     return -EIO;
   }
 
+  st_plugin_cost_put(&session_impl->cost, frame);
   return session_impl->req.put_frame(session_impl->req.priv, frame, result);
 }
 
@@ -743,7 +955,10 @@ struct st22_decode_frame_meta* st22_decoder_get_frame(st22p_decode_session sessi
     return NULL;
   }
 
-  return session_impl->req.get_frame(session_impl->req.priv);
+  struct st22_decode_frame_meta* frame =
+      session_impl->req.get_frame(session_impl->req.priv);
+  if (frame) st_plugin_cost_get(&session_impl->cost, frame);
+  return frame;
 }
 
 int st22_decoder_put_frame(st22p_decode_session session,
@@ -755,6 +970,7 @@ int st22_decoder_put_frame(st22p_decode_session session,
     return -EIO;
   }
 
+  st_plugin_cost_put(&session_impl->cost, frame);
   return session_impl->req.put_frame(session_impl->req.priv, frame, result);
 }
 
@@ -766,7 +982,10 @@ struct st20_convert_frame_meta* st20_converter_get_frame(st20p_convert_session s
     return NULL;
   }
 
-  return session_impl->req.get_frame(session_impl->req.priv);
+  struct st20_convert_frame_meta* frame =
+      session_impl->req.get_frame(session_impl->req.priv);
+  if (frame) st_plugin_cost_get(&session_impl->cost, frame);
+  return frame;
 }
 
 int st20_converter_put_frame(st20p_convert_session session,
@@ -778,6 +997,7 @@ int st20_converter_put_frame(st20p_convert_session session,
     return -EIO;
   }
 
+  st_plugin_cost_put(&session_impl->cost, frame);
   return session_impl->req.put_frame(session_impl->req.priv, frame, result);
 }
 
@@ -940,3 +1160,388 @@ int st_plugin_unregister(mtl_handle mt, const char* path) {
   err("%s, can not find %s\n", __func__, path);
   return -EIO;
 }
+
+static int st_plugin_job_enqueue(struct st_plugin_worker_mgr* wmgr,
+                                 struct st_plugin_job_impl* job) {
+  int ret;
+  uint32_t queued;
+
+  job->enqueue_ns = mt_get_monotonic_time();
+  /* never full, each job is in the ring once at most by the pending flag */
+  ret = rte_ring_mp_enqueue(wmgr->ring, job);
+  if (ret < 0) {
+    err("%s(%d), enqueue fail %d\n", __func__, job->idx, ret);
+    rte_atomic32_set(&job->pending, 0);
+    return ret;
+  }
+  queued = rte_ring_count(wmgr->ring);
+  if (queued > (uint32_t)rte_atomic32_read(&wmgr->stat_queued_max))
+    rte_atomic32_set(&wmgr->stat_queued_max, queued);
+
+  /* pair with the empty check of the sleeping worker */
+  rte_smp_mb();
+  if (wmgr->nb_sleeping) {
+    mt_pthread_mutex_lock(&wmgr->wake_mutex);
+    mt_pthread_cond_signal(&wmgr->wake_cond);
+    mt_pthread_mutex_unlock(&wmgr->wake_mutex);
+  }
+
+  return 0;
+}
+
+static void st_plugin_job_release(struct st_plugin_job_impl* job) {
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(job->parnet);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+  rte_atomic32_t* freed = job->freed;
+  int idx = job->idx;
+
+  mt_pthread_mutex_lock(&mgr->workers_lock);
+  wmgr->jobs[idx] = NULL;
+  wmgr->nb_jobs--;
+  mt_pthread_mutex_unlock(&mgr->workers_lock);
+
+  /* a notify which passed the freeing check may still touch the job */
+  rte_smp_mb();
+  while (rte_atomic32_read(&job->ref_cnt)) rte_pause();
+  info("%s(%d), %s detached\n", __func__, idx, job->name);
+  mt_rte_free(job);
+  /* the job is gone, wake up st_plugin_job_free */
+  rte_atomic32_set(freed, 1);
+}
+
+static void* st_plugin_worker_thread(void* arg) {
+  struct st_plugin_worker* worker = arg;
+  struct st_plugin_worker_mgr* wmgr = worker->parnet;
+  struct st_plugin_job_impl* job;
+  void* obj;
+  uint64_t start_ns, wait_ns;
+  uint32_t notified;
+  int ret;
+
+  info("%s(%d), start on cpu %d\n", __func__, worker->idx, worker->cpu);
+  while (!wmgr->stop) {
+    if (rte_ring_mc_dequeue(wmgr->ring, &obj) < 0) {
+      mt_pthread_mutex_lock(&wmgr->wake_mutex);
+      wmgr->nb_sleeping++;
+      rte_smp_mb();
+      if (!wmgr->stop && rte_ring_empty(wmgr->ring))
+        mt_pthread_cond_wait(&wmgr->wake_cond, &wmgr->wake_mutex);
+      wmgr->nb_sleeping--;
+      mt_pthread_mutex_unlock(&wmgr->wake_mutex);
+      continue;
+    }
+
+    job = obj;
+    /* read before the freeing check, a free after it fails the cmpset below */
+    notified = rte_atomic32_read(&job->pending);
+    if (rte_atomic32_read(&job->freeing)) {
+      st_plugin_job_release(job);
+      continue;
+    }
+    start_ns = mt_get_monotonic_time();
+    wait_ns = start_ns - job->enqueue_ns;
+    if (wait_ns > job->stat_wait_max_ns) job->stat_wait_max_ns = wait_ns;
+    if (wait_ns > worker->stat_wait_max_ns) worker->stat_wait_max_ns = wait_ns;
+
+    ret = job->ops.process(job->ops.priv);
+    uint64_t process_ns = mt_get_monotonic_time() - start_ns;
+    worker->stat_busy_ns += process_ns;
+    if (ret >= 0) {
+      job->stat_frames++;
+      job->stat_process_ns += process_ns;
+      worker->stat_frames++;
+    } else {
+      job->stat_idle++;
+    }
+
+    /* idle and no notify or free since the dequeue, the job is not touched after */
+    if ((ret < 0) &&
+        rte_atomic32_cmpset((volatile uint32_t*)&job->pending.cnt, notified, 0))
+      continue;
+    if (rte_atomic32_read(&job->freeing)) {
+      st_plugin_job_release(job);
+      continue;
+    }
+    /* back to the tail for one more frame, other jobs are served in between */
+    st_plugin_job_enqueue(wmgr, job);
+  }
+  info("%s(%d), stop\n", __func__, worker->idx);
+
+  return NULL;
+}
+
+/* parse cpu list like "28,29,30-31" */
+static int st_plugin_parse_cpus(const char* list, int* cpus, int max) {
+  int nb = 0;
+  const char* p = list;
+  char* end;
+  long start, last;
+
+  while (*p && nb < max) {
+    start = strtol(p, &end, 10);
+    if (end == p || start < 0) return -EINVAL;
+    last = start;
+    p = end;
+    if (*p == '-') {
+      p++;
+      last = strtol(p, &end, 10);
+      if (end == p || last < start) return -EINVAL;
+      p = end;
+    }
+    for (long cpu = start; cpu <= last && nb < max; cpu++) cpus[nb++] = cpu;
+    if (*p == ',') p++;
+    else if (*p) return -EINVAL;
+  }
+
+  return nb;
+}
+
+/* call with workers_lock held */
+static int st_plugin_workers_start(struct mtl_main_impl* impl) {
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+  struct mtl_init_params* p = mt_get_user_params(impl);
+  struct st_plugin_worker* worker;
+  int cpus[ST_MAX_PLUGIN_WORKERS];
+  int nb_cpus = 0;
+  char ring_name[32];
+  int ret;
+
+  int nb_workers = p->plugin_workers ? p->plugin_workers : ST_PLUGIN_WORKERS_DEFAULT;
+  if (nb_workers > ST_MAX_PLUGIN_WORKERS) {
+    warn("%s, %d workers exceed max %d\n", __func__, nb_workers, ST_MAX_PLUGIN_WORKERS);
+    nb_workers = ST_MAX_PLUGIN_WORKERS;
+  }
+  if (p->plugin_worker_cores) {
+    nb_cpus = st_plugin_parse_cpus(p->plugin_worker_cores, cpus, ST_MAX_PLUGIN_WORKERS);
+    if (nb_cpus < 0) {
+      err("%s, invalid plugin_worker_cores %s\n", __func__, p->plugin_worker_cores);
+      return nb_cpus;
+    }
+  }
+
+  snprintf(ring_name, 32, "PLUGIN-JOBS-%p", impl);
+  /* multi-producer and multi-consumer */
+  wmgr->ring =
+      rte_ring_create(ring_name, ST_MAX_PLUGIN_JOBS, mt_socket_id(impl, MTL_PORT_P), 0);
+  if (!wmgr->ring) {
+    err("%s, rte_ring_create fail\n", __func__);
+    return -ENOMEM;
+  }
+  mt_pthread_mutex_init(&wmgr->wake_mutex, NULL);
+  mt_pthread_cond_init(&wmgr->wake_cond, NULL);
+  wmgr->stop = false;
+  wmgr->nb_sleeping = 0;
+  wmgr->stat_start_ns = mt_get_monotonic_time();
+  rte_atomic32_set(&wmgr->stat_queued_max, 0);
+
+  for (int i = 0; i < nb_workers; i++) {
+    worker = &wmgr->workers[i];
+    memset(worker, 0, sizeof(*worker));
+    worker->idx = i;
+    worker->parnet = wmgr;
+    worker->cpu = nb_cpus ? cpus[i % nb_cpus] : -1;
+    ret = pthread_create(&worker->tid, NULL, st_plugin_worker_thread, worker);
+    if (ret) {
+      err("%s(%d), thread create fail %d\n", __func__, i, ret);
+      break;
+    }
+    if (worker->cpu >= 0) {
+      cpu_set_t mask;
+      CPU_ZERO(&mask);
+      CPU_SET(worker->cpu, &mask);
+      pthread_setaffinity_np(worker->tid, sizeof(mask), &mask);
+    }
+    wmgr->nb_workers++;
+  }
+  if (!wmgr->nb_workers) {
+    mt_pthread_mutex_destroy(&wmgr->wake_mutex);
+    mt_pthread_cond_destroy(&wmgr->wake_cond);
+    rte_ring_free(wmgr->ring);
+    wmgr->ring = NULL;
+    return -EIO;
+  }
+
+  wmgr->started = true;
+  info("%s, %d workers, cpus %s\n", __func__, wmgr->nb_workers,
+       p->plugin_worker_cores ? p->plugin_worker_cores : "not pinned");
+  return 0;
+}
+
+static int st_plugin_workers_stop(struct mtl_main_impl* impl) {
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+
+  if (!wmgr->started) return 0;
+
+  mt_pthread_mutex_lock(&wmgr->wake_mutex);
+  wmgr->stop = true;
+  mt_pthread_cond_broadcast(&wmgr->wake_cond);
+  mt_pthread_mutex_unlock(&wmgr->wake_mutex);
+  for (int i = 0; i < wmgr->nb_workers; i++) pthread_join(wmgr->workers[i].tid, NULL);
+  for (int i = 0; i < ST_MAX_PLUGIN_JOBS; i++) {
+    if (wmgr->jobs[i]) {
+      warn("%s, job %d(%s) still attached\n", __func__, i, wmgr->jobs[i]->name);
+      mt_rte_free(wmgr->jobs[i]);
+      wmgr->jobs[i] = NULL;
+    }
+  }
+  wmgr->nb_workers = 0;
+  wmgr->nb_jobs = 0;
+
+  mt_pthread_mutex_destroy(&wmgr->wake_mutex);
+  mt_pthread_cond_destroy(&wmgr->wake_cond);
+  rte_ring_free(wmgr->ring);
+  wmgr->ring = NULL;
+  wmgr->started = false;
+
+  return 0;
+}
+
+st_plugin_job_handle st_plugin_job_create(mtl_handle mt, struct st_plugin_job_ops* ops) {
+  struct mtl_main_impl* impl = mt;
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+  struct st_plugin_job_impl* job;
+  int ret;
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return NULL;
+  }
+
+  if (!ops->process) {
+    err("%s, pls set process\n", __func__);
+    return NULL;
+  }
+
+  mt_pthread_mutex_lock(&mgr->workers_lock);
+  if (!wmgr->started) {
+    ret = st_plugin_workers_start(impl);
+    if (ret < 0) {
+      mt_pthread_mutex_unlock(&mgr->workers_lock);
+      err("%s, workers start fail %d\n", __func__, ret);
+      return NULL;
+    }
+  }
+  for (int i = 0; i < ST_MAX_PLUGIN_JOBS; i++) {
+    if (wmgr->jobs[i]) continue;
+    job = mt_rte_zmalloc_socket(sizeof(*job), mt_socket_id(impl, MTL_PORT_P));
+    if (!job) {
+      err("%s, job malloc fail\n", __func__);
+      mt_pthread_mutex_unlock(&mgr->workers_lock);
+      return NULL;
+    }
+    job->type = MT_ST_HANDLE_PLUGIN_JOB;
+    job->parnet = impl;
+    job->idx = i;
+    if (ops->name) strncpy(job->name, ops->name, ST_MAX_NAME_LEN - 1);
+    job->ops = *ops;
+    rte_atomic32_set(&job->pending, 0);
+    rte_atomic32_set(&job->freeing, 0);
+    rte_atomic32_set(&job->ref_cnt, 0);
+    job->freed = NULL;
+    wmgr->jobs[i] = job;
+    wmgr->nb_jobs++;
+    mt_pthread_mutex_unlock(&mgr->workers_lock);
+    info("%s(%d), %s attached\n", __func__, i, job->name);
+    return job;
+  }
+  mt_pthread_mutex_unlock(&mgr->workers_lock);
+
+  err("%s, no space, all items are used\n", __func__);
+  return NULL;
+}
+
+int st_plugin_job_free(st_plugin_job_handle handle) {
+  struct st_plugin_job_impl* job = handle;
+
+  if (job->type != MT_ST_HANDLE_PLUGIN_JOB) {
+    err("%s, invalid type %d\n", __func__, job->type);
+    return -EIO;
+  }
+
+  rte_atomic32_t freed;
+
+  rte_atomic32_set(&freed, 0);
+  job->freed = &freed;
+  rte_atomic32_set(&job->freeing, 1);
+  /* idle, no worker holds it and no notify can queue it any more */
+  if (rte_atomic32_add_return(&job->pending, 1) == 1) {
+    st_plugin_job_release(job);
+    return 0;
+  }
+
+  /* queued or running, the worker which holds it releases it */
+  while (!rte_atomic32_read(&freed)) mt_sleep_ms(1);
+  return 0;
+}
+
+int st_plugin_job_notify(st_plugin_job_handle handle) {
+  struct st_plugin_job_impl* job = handle;
+
+  if (job->type != MT_ST_HANDLE_PLUGIN_JOB) {
+    err("%s, invalid type %d\n", __func__, job->type);
+    return -EIO;
+  }
+
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(job->parnet);
+  int ret = 0;
+
+  /* take the ref before the freeing check, the job is not released until it drops */
+  rte_atomic32_inc(&job->ref_cnt);
+  if (rte_atomic32_read(&job->freeing)) {
+    rte_atomic32_dec(&job->ref_cnt);
+    return -EBUSY;
+  }
+
+  /* already queued or running, the worker sees the count changed and runs again */
+  if (rte_atomic32_add_return(&job->pending, 1) == 1)
+    ret = st_plugin_job_enqueue(&mgr->workers, job);
+  rte_atomic32_dec(&job->ref_cnt);
+
+  return ret;
+}
+
+int st_plugin_worker_get_stats(mtl_handle mt, struct st_plugin_worker_stats* stats) {
+  struct mtl_main_impl* impl = mt;
+  struct st_plugin_mgr* mgr = st_get_plugins_mgr(impl);
+  struct st_plugin_worker_mgr* wmgr = &mgr->workers;
+  struct st_plugin_worker* worker;
+  uint64_t busy_ns = 0, now;
+
+  if (impl->type != MT_HANDLE_MAIN) {
+    err("%s, invalid type %d\n", __func__, impl->type);
+    return -EIO;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  mt_pthread_mutex_lock(&mgr->workers_lock);
+  if (!wmgr->started) {
+    mt_pthread_mutex_unlock(&mgr->workers_lock);
+    return 0;
+  }
+  stats->nb_workers = wmgr->nb_workers;
+  stats->nb_jobs = wmgr->nb_jobs;
+  stats->queued = rte_ring_count(wmgr->ring);
+  stats->queued_max = rte_atomic32_read(&wmgr->stat_queued_max);
+  rte_atomic32_set(&wmgr->stat_queued_max, 0);
+  for (int i = 0; i < wmgr->nb_workers; i++) {
+    worker = &wmgr->workers[i];
+    busy_ns += worker->stat_busy_ns;
+    stats->frames += worker->stat_frames;
+    if (worker->stat_wait_max_ns > stats->wait_max_ns)
+      stats->wait_max_ns = worker->stat_wait_max_ns;
+    worker->stat_busy_ns = 0;
+    worker->stat_frames = 0;
+    worker->stat_wait_max_ns = 0;
+  }
+  now = mt_get_monotonic_time();
+  if (now > wmgr->stat_start_ns)
+    stats->busy_ratio =
+        (float)busy_ns * 100 / (now - wmgr->stat_start_ns) / wmgr->nb_workers;
+  wmgr->stat_start_ns = now;
+  mt_pthread_mutex_unlock(&mgr->workers_lock);
+
+  return 0;
+}
@@ -2120,5 +2120,28 @@ int st20_y210_to_rfc4175_422be10_avx512_dma(struct mtl_dma_lender_dev* dma,
 }
 /* end st20_y210_to_rfc4175_422be10_avx512 */
 
+int st20_fec_xor_avx512(uint8_t* dst, const uint8_t* src, size_t len) {
+  size_t batch = len / 64;
+  size_t left = len % 64;
+
+  for (size_t i = 0; i < batch; i++) {
+    __m512i d = _mm512_loadu_si512((__m512i*)dst);
+    __m512i s = _mm512_loadu_si512((__m512i*)src);
+    _mm512_storeu_si512((__m512i*)dst, _mm512_xor_si512(d, s));
+    dst += 64;
+    src += 64;
+  }
+
+  if (left) {
+    __mmask64 k = (1ULL << left) - 1;
+    __m512i d = _mm512_maskz_loadu_epi8(k, dst);
+    __m512i s = _mm512_maskz_loadu_epi8(k, src);
+    _mm512_mask_storeu_epi8(dst, k, _mm512_xor_si512(d, s));
+  }
+
+  return 0;
+}
+/* end st20_fec_xor_avx512 */
+
 MT_TARGET_CODE_STOP
 #endif
@@ -92,4 +92,7 @@ int st20_y210_to_rfc4175_422be10_avx512_dma(struct mtl_dma_lender_dev* dma,
                                             uint16_t* pg_y210, mtl_iova_t pg_y210_iova,
                                             struct st20_rfc4175_422_10_pg2_be* pg_be,
                                             uint32_t w, uint32_t h);
+
+int st20_fec_xor_avx512(uint8_t* dst, const uint8_t* src, size_t len);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+#include "st_ebu.h"
+
+#include <math.h>
+
+const char* st_ebu_grade_str(enum st_ebu_grade grade) {
+  switch (grade) {
+    case ST_EBU_GRADE_NARROW:
+      return ST_EBU_PASS_NARROW;
+    case ST_EBU_GRADE_WIDE:
+      return ST_EBU_PASS_WIDE;
+    case ST_EBU_GRADE_WIDE_WA:
+      return ST_EBU_PASS_WIDE_WA;
+    default:
+      return ST_EBU_FAIL;
+  }
+}
+
+void st_ebu_video_pass_init(struct st_ebu_video_pass* pass, int total_pkts,
+                            double frame_time, double sampling_clock_rate, int height,
+                            bool interlaced) {
+  double frame_time_s = frame_time / 1000000000.0;
+  double ractive = 1080.0 / 1125.0;
+
+  if (interlaced && height <= 576) {
+    ractive = (height == 480) ? 487.0 / 525.0 : 576.0 / 625.0;
+  }
+
+  pass->trs = frame_time * ractive / total_pkts;
+  if (!interlaced) {
+    pass->tr_offset =
+        height >= 1080 ? frame_time * (43.0 / 1125.0) : frame_time * (28.0 / 750.0);
+  } else {
+    if (height == 480) {
+      pass->tr_offset = frame_time * (20.0 / 525.0) * 2;
+    } else if (height == 576) {
+      pass->tr_offset = frame_time * (26.0 / 625.0) * 2;
+    } else {
+      pass->tr_offset = frame_time * (22.0 / 1125.0) * 2;
+    }
+  }
+
+  pass->c_max_narrow_pass =
+      fmax(4, (double)total_pkts / (43200 * ractive * frame_time_s));
+  pass->c_max_wide_pass = fmax(16, (double)total_pkts / (21600 * frame_time_s));
+  pass->vrx_full_narrow_pass = fmax(8, total_pkts / (27000 * frame_time_s));
+  pass->vrx_full_wide_pass = fmax(720, total_pkts / (300 * frame_time_s));
+  pass->rtp_offset_max_pass =
+      ceil((pass->tr_offset / 1000000000.0) * sampling_clock_rate) + 1;
+}
+
+void st_ebu_epoch_calc(struct st_ebu_epoch* e, uint64_t pkt_tmstamp, uint32_t rtp_tmstamp,
+                       double frame_time, double frame_time_sampling) {
+  uint64_t epochs = (double)pkt_tmstamp / frame_time;
+  uint64_t epoch_tmstamp = (double)epochs * frame_time;
+  uint64_t tmstamp64 = epochs * frame_time_sampling;
+  uint32_t tmstamp32 = tmstamp64;
+
+  e->epochs = epochs;
+  e->fpt = (double)pkt_tmstamp - epoch_tmstamp;
+  e->rtp_offset = (double)rtp_tmstamp - tmstamp32;
+  e->latency = e->fpt - e->rtp_offset * frame_time / frame_time_sampling;
+}
+
+/* the vrx after this packet, drained_prev is updated to the drained pkts */
+int32_t st_ebu_vrx(uint64_t pkt_tmstamp, uint64_t epochs, double frame_time,
+                   struct st_ebu_video_pass* pass, int32_t vrx_prev,
+                   int32_t* drained_prev) {
+  uint64_t epoch_tmstamp = (uint64_t)(epochs * frame_time);
+  double tvd = epoch_tmstamp + pass->tr_offset;
+  double packet_delta_ns = (double)pkt_tmstamp - tvd;
+  int32_t drained = (packet_delta_ns + pass->trs) / pass->trs;
+  int32_t vrx_cur = vrx_prev + 1 - (drained - *drained_prev);
+
+  *drained_prev = drained;
+  return vrx_cur;
+}
+
+int st_ebu_cinst(uint64_t pkt_tmstamp, uint64_t initial_time, double trs, int pkt_idx) {
+  int exp_cin_pkts = ((pkt_tmstamp - initial_time) / trs) * ST_EBU_CINST_DRAIN_FACTOR;
+  int cinst = pkt_idx - exp_cin_pkts;
+
+  return cinst > 0 ? cinst : 0;
+}
+
+/* wa: extend the wide band as the rx time is not from the hw */
+enum st_ebu_grade st_ebu_cinst_grade(struct st_ebu_video_pass* pass, int32_t cinst_max,
+                                     bool wa) {
+  if (cinst_max <= (int32_t)pass->c_max_narrow_pass) return ST_EBU_GRADE_NARROW;
+  if (cinst_max <= (int32_t)pass->c_max_wide_pass) return ST_EBU_GRADE_WIDE;
+  if (wa && (cinst_max <= (int32_t)(pass->c_max_wide_pass * 16)))
+    return ST_EBU_GRADE_WIDE_WA;
+  return ST_EBU_GRADE_FAIL;
+}
+
+enum st_ebu_grade st_ebu_vrx_grade(struct st_ebu_video_pass* pass, int32_t vrx_min,
+                                   int32_t vrx_max) {
+  if ((vrx_min > 0) && (vrx_max <= (int32_t)pass->vrx_full_narrow_pass))
+    return ST_EBU_GRADE_NARROW;
+  if ((vrx_min > 0) && (vrx_max <= (int32_t)pass->vrx_full_wide_pass))
+    return ST_EBU_GRADE_WIDE;
+  return ST_EBU_GRADE_FAIL;
+}
+
+/* NARROW for pass, WIDE_WA for the pass only with the wa band */
+enum st_ebu_grade st_ebu_fpt_grade(struct st_ebu_video_pass* pass, int32_t fpt_max,
+                                   bool wa) {
+  if (fpt_max <= pass->tr_offset) return ST_EBU_GRADE_NARROW;
+  if (wa && (fpt_max <= (pass->tr_offset * 2))) return ST_EBU_GRADE_WIDE_WA;
+  return ST_EBU_GRADE_FAIL;
+}
+
+bool st_ebu_latency_pass(int32_t latency_min, int32_t latency_max) {
+  return (latency_min >= 0) && (latency_max <= ST_EBU_LATENCY_MAX_NS);
+}
+
+bool st_ebu_rtp_offset_pass(struct st_ebu_video_pass* pass, int32_t rtp_offset_min,
+                            int32_t rtp_offset_max) {
+  return (rtp_offset_min >= ST_EBU_RTP_OFFSET_MIN) &&
+         (rtp_offset_max <= (int32_t)pass->rtp_offset_max_pass);
+}
+
+bool st_ebu_rtp_ts_delta_pass(double frame_time_sampling, int32_t delta_min,
+                              int32_t delta_max) {
+  int32_t rtd = frame_time_sampling;
+
+  return (delta_min >= rtd) && (delta_max <= (rtd + 1));
+}
+
+/* the criteria are based on the 1ms packet time */
+void st_ebu_audio_pass_init(struct st_ebu_audio_pass* pass) {
+  pass->dpvr_max_pass_narrow = 3 * 1000;
+  pass->dpvr_max_pass_wide = 20 * 1000;
+  pass->dpvr_avg_pass_wide = 2.5 * 1000;
+  pass->tsdf_max_pass = 17 * 1000;
+}
+
+enum st_ebu_grade st_ebu_dpvr_grade(struct st_ebu_audio_pass* pass, int64_t dpvr_max,
+                                    float dpvr_avg) {
+  if (dpvr_max >= 0 && dpvr_max < pass->dpvr_max_pass_narrow) return ST_EBU_GRADE_NARROW;
+  if (dpvr_max >= 0 && dpvr_max < pass->dpvr_max_pass_wide && dpvr_avg >= 0 &&
+      dpvr_avg < pass->dpvr_avg_pass_wide)
+    return ST_EBU_GRADE_WIDE;
+  return ST_EBU_GRADE_FAIL;
+}
+
+/* Maximum Timestamped Delay Factor of one result */
+int64_t st_ebu_tsdf(int64_t dpvr_min, int64_t dpvr_max, int64_t dpvr_first) {
+  return (dpvr_max - dpvr_first) - (dpvr_min - dpvr_first);
+}
@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+/*
+ * The ST2110-21 video and ST2110-30 audio pass criteria and timing math of the rx ebu
+ * check. tools/readpcap/pcap_analyzer builds st_ebu.c too, so the offline and the
+ * online check grade a flow the same way. The callers keep their own stat and result.
+ */
+
+#ifndef _ST_LIB_EBU_HEAD_H_
+#define _ST_LIB_EBU_HEAD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ST_EBU_CINST_DRAIN_FACTOR (1.1f) /* Drain factor */
+
+#define ST_EBU_LATENCY_MAX_US (1000)                         /* Latency in us */
+#define ST_EBU_LATENCY_MAX_NS (1000 * ST_EBU_LATENCY_MAX_US) /* Latency in ns */
+
+#define ST_EBU_RTP_OFFSET_MIN (-1) /* MIN RTP Offset */
+
+#define ST_EBU_RTP_WRAP_AROUND (0x100000000)
+
+#define ST_EBU_PASS_NARROW "PASSED NARROW"
+#define ST_EBU_PASS_WIDE "FAILED with WIDE"
+/* Extend WA WIDE as no hw rx time */
+#define ST_EBU_PASS_WIDE_WA "FAILED with WIDE WA error"
+#define ST_EBU_PASS "PASSED"
+#define ST_EBU_FAIL "FAILED"
+
+enum st_ebu_grade {
+  ST_EBU_GRADE_NARROW = 0,
+  ST_EBU_GRADE_WIDE,
+  ST_EBU_GRADE_WIDE_WA, /* only if the rx time is inaccurate, no hw rx timestamp */
+  ST_EBU_GRADE_FAIL,
+};
+
+/* the ST2110-21 timing and pass criteria of one video flow */
+struct st_ebu_video_pass {
+  double trs;       /* in ns for of 2 consecutive packets, T-Frame / N-Packets */
+  double tr_offset; /* in ns, tr offset time of each frame */
+  uint32_t c_max_narrow_pass;
+  uint32_t c_max_wide_pass;
+  uint32_t vrx_full_narrow_pass;
+  uint32_t vrx_full_wide_pass;
+  uint32_t rtp_offset_max_pass;
+};
+
+/* the frame(or audio packet) level values against the epoch of the packet time */
+struct st_ebu_epoch {
+  uint64_t epochs;
+  double fpt;        /* in ns, the packet time from the epoch start */
+  double rtp_offset; /* in sampling, the rtp timestamp from the epoch one */
+  double latency;    /* in ns */
+};
+
+const char* st_ebu_grade_str(enum st_ebu_grade grade);
+
+void st_ebu_video_pass_init(struct st_ebu_video_pass* pass, int total_pkts,
+                            double frame_time, double sampling_clock_rate, int height,
+                            bool interlaced);
+
+void st_ebu_epoch_calc(struct st_ebu_epoch* e, uint64_t pkt_tmstamp, uint32_t rtp_tmstamp,
+                       double frame_time, double frame_time_sampling);
+
+/* the vrx after this packet, drained_prev is updated to the drained pkts */
+int32_t st_ebu_vrx(uint64_t pkt_tmstamp, uint64_t epochs, double frame_time,
+                   struct st_ebu_video_pass* pass, int32_t vrx_prev,
+                   int32_t* drained_prev);
+
+int st_ebu_cinst(uint64_t pkt_tmstamp, uint64_t initial_time, double trs, int pkt_idx);
+
+/* wa: extend the wide band as the rx time is not from the hw */
+enum st_ebu_grade st_ebu_cinst_grade(struct st_ebu_video_pass* pass, int32_t cinst_max,
+                                     bool wa);
+
+enum st_ebu_grade st_ebu_vrx_grade(struct st_ebu_video_pass* pass, int32_t vrx_min,
+                                   int32_t vrx_max);
+
+/* NARROW for pass, WIDE_WA for the pass only with the wa band */
+enum st_ebu_grade st_ebu_fpt_grade(struct st_ebu_video_pass* pass, int32_t fpt_max,
+                                   bool wa);
+
+bool st_ebu_latency_pass(int32_t latency_min, int32_t latency_max);
+
+bool st_ebu_rtp_offset_pass(struct st_ebu_video_pass* pass, int32_t rtp_offset_min,
+                            int32_t rtp_offset_max);
+
+bool st_ebu_rtp_ts_delta_pass(double frame_time_sampling, int32_t delta_min,
+                              int32_t delta_max);
+
+/* the ST2110-30 pass criteria, in us */
+struct st_ebu_audio_pass {
+  int32_t dpvr_max_pass_narrow;
+  int32_t dpvr_max_pass_wide;
+  float dpvr_avg_pass_wide;
+  int32_t tsdf_max_pass;
+};
+
+/* the criteria are based on the 1ms packet time */
+void st_ebu_audio_pass_init(struct st_ebu_audio_pass* pass);
+
+enum st_ebu_grade st_ebu_dpvr_grade(struct st_ebu_audio_pass* pass, int64_t dpvr_max,
+                                    float dpvr_avg);
+
+/* Maximum Timestamped Delay Factor of one result */
+int64_t st_ebu_tsdf(int64_t dpvr_min, int64_t dpvr_max, int64_t dpvr_first);
+
+#endif
@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st_fec.h"
+
+#include "../mt_log.h"
+
+#ifdef MTL_HAS_AVX512
+#include "st_avx512.h"
+#endif
+
+static void st20_fec_xor_scalar(uint8_t* dst, const uint8_t* src, size_t len) {
+  size_t i = 0;
+  uint64_t d, s;
+
+  for (; i + sizeof(d) <= len; i += sizeof(d)) {
+    memcpy(&d, dst + i, sizeof(d));
+    memcpy(&s, src + i, sizeof(s));
+    d ^= s;
+    memcpy(dst + i, &d, sizeof(d));
+  }
+  for (; i < len; i++) dst[i] ^= src[i];
+}
+
+void st20_fec_xor(uint8_t* dst, const uint8_t* src, size_t len,
+                  enum mtl_simd_level level) {
+#ifdef MTL_HAS_AVX512
+  if (level >= MTL_SIMD_LEVEL_AVX512) {
+    st20_fec_xor_avx512(dst, src, len);
+    return;
+  }
+#endif
+  MT_MAY_UNUSED(level);
+
+  st20_fec_xor_scalar(dst, src, len);
+}
+
+int st20_fec_frame_pkts(int total, int cols, int rows) {
+  int matrix_pkts = cols * rows;
+  int matrix_fec = 0;
+  int fec_pkts;
+
+  if (cols > 1) matrix_fec += rows;
+  if (rows > 1) matrix_fec += cols;
+  fec_pkts = total / matrix_pkts * matrix_fec;
+
+  /* the last matrix of the frame is partial */
+  int left = total % matrix_pkts;
+  if (left) {
+    if (cols > 1) fec_pkts += (left + cols - 1) / cols;
+    if (rows > 1) fec_pkts += RTE_MIN(left, cols);
+  }
+
+  return fec_pkts;
+}
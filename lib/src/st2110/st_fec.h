@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_FEC_HEAD_H_
+#define _ST_LIB_FEC_HEAD_H_
+
+#include "st_main.h"
+
+/* dst ^= src for len bytes, level is the cpu simd level resolved at session init */
+void st20_fec_xor(uint8_t* dst, const uint8_t* src, size_t len,
+                  enum mtl_simd_level level);
+
+/* number of the FEC pkts for a frame with total media pkts and a L x D matrix */
+int st20_fec_frame_pkts(int total, int cols, int rows);
+
+#endif
@@ -357,6 +357,13 @@ static const struct st_frame_fmt_desc st_frame_fmt_descs[] = {
         .planes = 1,
         .sampling = ST_FRAME_SAMPLING_MAX,
     },
+    {
+        /* ST_FRAME_FMT_H265_CBR_CODESTREAM */
+        .fmt = ST_FRAME_FMT_H265_CBR_CODESTREAM,
+        .name = "H265_CBR_CODESTREAM",
+        .planes = 1,
+        .sampling = ST_FRAME_SAMPLING_MAX,
+    },
 };
 
 static const char* st_pacing_way_names[ST21_TX_PACING_WAY_MAX] = {
@@ -722,6 +729,9 @@ uint64_t st10_media_clk_to_ns(uint32_t media_ts, uint32_t sampling_rate) {
 }
 
 enum mtl_pmd_type mtl_pmd_by_port_name(const char* port) {
+  if (!strncmp(port, MT_MEMIF_PORT_PREFIX, strlen(MT_MEMIF_PORT_PREFIX)))
+    return MTL_PMD_DPDK_MEMIF;
+
   char* bdf = strstr(port, ":");
   return bdf ? MTL_PMD_DPDK_USER : MTL_PMD_DPDK_AF_XDP;
 }
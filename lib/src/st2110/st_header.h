@@ -41,6 +41,10 @@
 #define ST_VIDEO_RX_SLICE_NUM (32)
 /* sync to atomic if reach this threshold */
 #define ST_VIDEO_STAT_UPDATE_INTERVAL (1000)
+/* number of submitted dma batches tracked for the completion latency */
+#define ST_VIDEO_RX_DMA_BATCH_NUM (64)
+/* number of fec pkts held per slot waiting more media pkts for the recovery */
+#define ST_VIDEO_RX_FEC_PENDING_NUM (32)
 /* data size for each pkt in block packing mode */
 #define ST_VIDEO_BPM_SIZE (1260)
 
@@ -67,6 +71,14 @@
 #define ST_MAX_SESSIIONS_PER_DECODER (16)
 /* max sessions number per converter */
 #define ST_MAX_SESSIIONS_PER_CONVERTER (16)
+/* frames in flight tracked per plugin session for the per-frame cost */
+#define ST_PLUGIN_COST_SLOTS (8)
+/* max jobs of the shared plugin worker pool */
+#define ST_MAX_PLUGIN_JOBS (64)
+/* max threads of the shared plugin worker pool */
+#define ST_MAX_PLUGIN_WORKERS (32)
+/* default threads of the shared plugin worker pool */
+#define ST_PLUGIN_WORKERS_DEFAULT (2)
 
 #define ST_TX_DUMMY_PKT_IDX (0xFFFFFFFF)
 
@@ -114,7 +126,7 @@ struct st_frame_trans {
   int idx;
   void* addr;            /* virtual address */
   rte_iova_t iova;       /* iova for hw */
-  rte_atomic32_t refcnt; /* 0 means it's free */
+  rte_atomic32_t ref_cnt; /* 0 means it's free */
   void* priv;            /* private data for lib */
 
   uint32_t flags;                          /* ST_FT_FLAG_* */
@@ -229,6 +241,61 @@ struct st_vsync_info {
   bool init;
 };
 
+/* SMPTE 2022-5 style row/column xor fec of one tx video session */
+/* rows with the first pkt lost for each frame, MTL_FLAG_TX_VIDEO_FEC_TEST_DROP */
+#define ST_TX_VIDEO_FEC_TEST_DROP_ROWS (3)
+
+struct st_tx_video_fec {
+  uint8_t cols;          /* L, media pkts in one row of the matrix */
+  uint8_t rows;          /* D, rows of the matrix */
+  uint16_t row_units;    /* row fec units per matrix, 0 if cols <= 1 */
+  uint16_t col_units;    /* column fec units per matrix, 0 if rows <= 1 */
+  uint16_t unit_size;    /* max xor len of one unit, srd included */
+  uint32_t matrix_pkts;  /* media pkts per matrix, L x D */
+  uint32_t nb_units;     /* units per frame, the unused of last matrix included */
+  int total_pkts;        /* fec pkts per frame */
+  uint8_t* units;        /* xor data of all units for current frame */
+  uint16_t* units_len;   /* xor len of each unit for current frame */
+  uint8_t* units_count;  /* media pkts protected by each unit, 0 if not used */
+  uint32_t unit_cursor;  /* next unit to send */
+  uint16_t seq_id;       /* seq id for each fec pkt */
+  uint32_t frame_seq;    /* media seq id of the first pkt of current frame */
+  enum mtl_simd_level simd_level;
+  uint8_t test_drop;     /* rows with the first pkt lost, debug only */
+  /* single segment mbuf for fec pkts */
+  struct rte_mempool* mbuf_mempool;
+};
+
+/* one rtp pkt of the replay flow, indexed from the capture file */
+struct st_tx_video_replay_pkt {
+  size_t offset;    /* offset of the rtp pkt(udp payload) in the capture */
+  uint64_t time_ns; /* send time since the start of the pass, speed applied */
+  uint16_t len;     /* rtp pkt len */
+};
+
+/* pcap/pcapng replay of one tx video session */
+struct st_tx_video_replay {
+  struct mtl_main_impl* impl;
+  void* addr;      /* private mapping of the capture, aligned to map_align */
+  size_t size;     /* size of the capture */
+  size_t map_size; /* size of the mapping, aligned to map_align */
+  mtl_iova_t iova; /* MTL_BAD_IOVA if not dma mapped, the pkts are copied then */
+  struct rte_mbuf_ext_shared_info sh_info; /* for the payload attached as extbuf */
+  struct st_tx_video_replay_pkt* pkts;
+  uint32_t nb_pkts;
+  uint32_t cursor;   /* next pkt to build */
+  uint64_t loop_ns;  /* time of one pass */
+  uint64_t base_tsc; /* start time of current pass */
+  uint64_t base_ptp;
+  /* the rtp seq(with the rfc4175 ext seq) and timestamp advance of one pass */
+  uint32_t seq_loop;
+  uint32_t tmstamp_loop;
+  /* added to the recorded seq and timestamp, the receiver sees no jump back */
+  uint32_t seq_offset;
+  uint32_t tmstamp_offset;
+  uint32_t stat_loops;
+};
+
 struct st_tx_video_session_impl {
   enum mtl_port port_maps[MT_SESSION_PORT_MAX];
   struct rte_mempool* mbuf_mempool_hdr[MT_SESSION_PORT_MAX];
@@ -239,6 +306,8 @@ struct st_tx_video_session_impl {
   bool eth_has_chain[MT_SESSION_PORT_MAX];
   /* if the eth dev support ipv4 checksum offload */
   bool eth_ipv4_cksum_offload[MT_SESSION_PORT_MAX];
+  /* if the eth dev support udp checksum offload, only for the ipv6 pkts now */
+  bool eth_udp_cksum_offload[MT_SESSION_PORT_MAX];
   unsigned int ring_count;
   struct rte_ring* ring[MT_SESSION_PORT_MAX];
   struct rte_ring* packet_ring; /* rtp ring */
@@ -254,6 +323,16 @@ struct st_tx_video_session_impl {
   uint16_t st20_src_port[MT_SESSION_PORT_MAX]; /* udp port */
   uint16_t st20_dst_port[MT_SESSION_PORT_MAX]; /* udp port */
   struct st_rfc4175_video_hdr s_hdr[MT_SESSION_PORT_MAX];
+  /* ST20_TX_FLAG_IPV6, the pkts are built from s_hdr6 */
+  bool ipv6;
+  struct st_rfc4175_video_hdr6 s_hdr6[MT_SESSION_PORT_MAX];
+  /* pseudo hdr sum without the length of each port, from s_hdr6 */
+  uint32_t st20_udp6_phdr_sum[MT_SESSION_PORT_MAX];
+  bool st20_udp6_sw_sum; /* one port without the udp cksum offload */
+  uint32_t st20_udp6_payload_sum; /* raw cksum of the payload, shared with the r pkt */
+  rte_atomic32_t mac_pending; /* ports still wait the dst mac from arp */
+  /* the arp fail result of each port, the tasklet resolve it again */
+  rte_atomic32_t mac_fail[MT_SESSION_PORT_MAX];
 
   struct st_tx_video_pacing pacing;
   enum st21_tx_pacing_way pacing_way[MT_SESSION_PORT_MAX];
@@ -304,7 +383,9 @@ struct st_tx_video_session_impl {
   uint16_t rtp_pkt_max_size; /* max size for user rtp pkt */
   int st20_total_pkts;       /* total pkts in one frame, ex: 4320 for 1080p */
   int st20_pkt_idx;          /* pkt index in current frame, start from zero */
+  uint32_t st20_frame_crc;   /* running crc of current frame */
   uint32_t st20_seq_id;      /* seq id for each pkt */
+  uint32_t st20_seq_id_r;    /* r link seq for the port stripe, p frame head based */
   uint32_t st20_rtp_time;    /* keep track of rtp time */
   int st21_vrx_narrow;       /* pass criteria for narrow */
   int st21_vrx_wide;         /* pass criteria for wide */
@@ -324,10 +405,17 @@ struct st_tx_video_session_impl {
   uint16_t st22_box_hdr_length;
   size_t st22_codestream_size;
 
+  /* fec info, NULL if not enabled */
+  struct st_tx_video_fec* fec;
+  /* pcap replay info, NULL if not enabled */
+  struct st_tx_video_replay* replay;
+
   /* stat */
   rte_atomic32_t stat_frame_cnt;
   int stat_pkts_build;
   int stat_pkts_dummy;
+  int stat_pkts_fec;
+  float stat_numa_remote_est_mbs; /* estimated from the frames of the stat period */
   int stat_pkts_burst;
   int stat_pkts_burst_dummy;
   int stat_trs_ret_code[MT_SESSION_PORT_MAX];
@@ -346,13 +434,17 @@ struct st_tx_video_session_impl {
 
 struct st_tx_video_sessions_mgr {
   struct mtl_main_impl* parnet;
-  int idx;     /* index for current session mgr */
+  struct mt_sch_impl* sch; /* the sch runs this mgr */
+  int idx;                 /* index for current session mgr */
   int max_idx; /* max session index */
   struct mt_sch_tasklet_impl* tasklet;
 
   struct st_tx_video_session_impl* sessions[ST_SCH_MAX_TX_VIDEO_SESSIONS];
   /* protect session, spin(fast) lock as it call from tasklet aslo */
   rte_spinlock_t mutex[ST_SCH_MAX_TX_VIDEO_SESSIONS];
+
+  /* sum of the sessions in the last stat period, read by mtl_sch_get_stats */
+  float stat_numa_remote_est_mbs;
 };
 
 struct st_video_transmitter_impl {
@@ -379,6 +471,9 @@ struct st_rx_video_slot_impl {
   uint16_t seq_id_base;     /* seq id for the first packt */
   uint32_t seq_id_base_u32; /* seq id for the first packt with u32 */
   bool seq_id_got;
+  /* fec or port stripe, the first pkt lost and the base is taken from a later pkt, fixed
+   * by the fec pkt or an earlier pkt of the frame */
+  bool seq_id_guess;
   void* frame; /* only for frame type */
   rte_iova_t frame_iova;
   uint8_t* frame_bitmap;
@@ -394,21 +489,22 @@ struct st_rx_video_slot_impl {
   /* payload len for codestream packetization mode */
   uint16_t st22_payload_length;
   uint16_t st22_box_hdr_length;
+  /* fec, the srd of each received pkt and fec pkts waiting more media pkts */
+  uint8_t* fec_srd;
+  struct rte_mbuf* fec_pending[ST_VIDEO_RX_FEC_PENDING_NUM];
+  uint16_t fec_pending_cnt;
+  /* running crc of the in order payload, crc_size is the bytes chained */
+  uint32_t crc;
+  size_t crc_size;
 };
 
 struct st_rx_video_ebu_info {
-  double trs;        /* in ns for of 2 consecutive packets, T-Frame / N-Packets */
-  double tr_offset;  /* in ns, tr offset time of each frame */
-  double frame_time; /* time of the frame in nanoseconds */
+  double frame_time;          /* time of the frame in nanoseconds */
   double frame_time_sampling; /* time of the frame in sampling(90k) */
   int dropped_results;        /* number of results to drop at the beginning */
 
-  // pass criteria
-  uint32_t c_max_narrow_pass;
-  uint32_t c_max_wide_pass;
-  uint32_t vrx_full_narrow_pass;
-  uint32_t vrx_full_wide_pass;
-  uint32_t rtp_offset_max_pass;
+  /* trs, tr offset and the pass criteria */
+  struct st_ebu_video_pass pass;
 
   bool init;
 };
@@ -552,6 +648,8 @@ struct st_rx_video_session_impl {
   uint16_t port_id[MT_SESSION_PORT_MAX];
   uint16_t st20_src_port[MT_SESSION_PORT_MAX]; /* udp port */
   uint16_t st20_dst_port[MT_SESSION_PORT_MAX]; /* udp port */
+  bool ipv6;                                   /* ST20_RX_FLAG_IPV6 */
+  size_t rtp_offset; /* offset of the rtp hdr in the st20 pkt, bigger for ipv6 */
 
   struct st_rx_video_session_handle_impl* st20_handle;
   struct st22_rx_video_session_handle_impl* st22_handle;
@@ -596,6 +694,27 @@ struct st_rx_video_session_impl {
   struct mtl_dma_lender_dev* dma_dev;
   uint16_t dma_nb_desc;
   struct st_rx_video_slot_impl* dma_slot;
+  /* adaptive dma/cpu copy split */
+  uint32_t dma_min_size;     /* payload size threshold for dma copy */
+  uint16_t dma_target_depth; /* max inflight dma copies */
+  float dma_bytes_per_ns;    /* the stream bandwidth */
+  float dma_cpu_ns_per_kb;   /* ewma of the cpu copy cost */
+  float dma_enq_ns;          /* ewma of the cpu cost to enqueue one dma copy */
+  float dma_latency_ns;      /* ewma of the dma completion latency */
+  uint32_t dma_probe_frame_cnt;
+  bool dma_probe; /* force one dma copy in current frame */
+  uint32_t dma_cpu_sample_cnt;
+  uint32_t dma_enq_sample_cnt;
+  uint16_t dma_batch_nb; /* dma copies not submitted */
+  uint64_t dma_batch_tsc[ST_VIDEO_RX_DMA_BATCH_NUM];
+  uint16_t dma_batch_cnt[ST_VIDEO_RX_DMA_BATCH_NUM];
+  uint16_t dma_batch_head;
+  uint16_t dma_batch_tail;
+  uint16_t dma_batch_done; /* completed copies of the head batch */
+
+  /* fec recovery, enabled if ops.fec_payload_type is set */
+  uint8_t* fec_unit; /* scratch to rebuild one lost pkt */
+  enum mtl_simd_level fec_simd_level;
 #ifdef ST_PCAPNG_ENABLED
   /* pcap dumper */
   uint32_t pcapng_dumped_pkts;
@@ -632,6 +751,10 @@ struct st_rx_video_session_impl {
   int stat_pkts_received;
   int stat_pkts_multi_segments_received;
   int stat_pkts_dma;
+  int stat_pkts_cpu_small; /* cpu copy as payload below dma_min_size */
+  int stat_pkts_cpu_depth; /* cpu copy as dma reach the target depth */
+  int stat_pkts_cpu_tail;  /* cpu copy for frame tail within dma latency */
+  int stat_pkts_dma_probe; /* forced dma copy to re-probe the cost */
   int stat_pkts_rtp_ring_full;
   int stat_pkts_no_slot;
   int stat_pkts_not_bpm;
@@ -640,6 +763,7 @@ struct st_rx_video_session_impl {
   int stat_mismatch_hdr_split_frame;
   int stat_frames_dropped;
   rte_atomic32_t stat_frames_received;
+  float stat_numa_remote_est_mbs; /* estimated from the frames of the stat period */
   int stat_slices_received;
   int stat_pkts_slice_fail;
   int stat_pkts_slice_merged;
@@ -647,6 +771,10 @@ struct st_rx_video_session_impl {
   uint32_t stat_vsync_mismatch;
   uint32_t stat_slot_get_frame_fail;
   uint32_t stat_slot_query_ext_fail;
+  int stat_pkts_fec_received;
+  int stat_pkts_fec_recovered;
+  int stat_pkts_fec_unrecoverable;
+  int stat_frames_crc_fallback;
 
   struct st_rx_video_ebu_info ebu_info;
   struct st_rx_video_ebu_stat ebu;
@@ -659,13 +787,17 @@ struct st_rx_video_session_impl {
 
 struct st_rx_video_sessions_mgr {
   struct mtl_main_impl* parnet;
-  int idx;     /* index for current session mgr */
+  struct mt_sch_impl* sch; /* the sch runs this mgr */
+  int idx;                 /* index for current session mgr */
   int max_idx; /* max session index */
   struct mt_sch_tasklet_impl* tasklet;
 
   struct st_rx_video_session_impl* sessions[ST_SCH_MAX_RX_VIDEO_SESSIONS];
   /* protect session, spin(fast) lock as it call from tasklet aslo */
   rte_spinlock_t mutex[ST_SCH_MAX_RX_VIDEO_SESSIONS];
+
+  /* sum of the sessions in the last stat period, read by mtl_sch_get_stats */
+  float stat_numa_remote_est_mbs;
 };
 
 struct st_tx_audio_session_pacing {
@@ -708,6 +840,9 @@ struct st_tx_audio_session_impl {
   uint16_t st30_src_port[MT_SESSION_PORT_MAX]; /* udp port */
   uint16_t st30_dst_port[MT_SESSION_PORT_MAX]; /* udp port */
   struct st_rfc3550_audio_hdr hdr[MT_SESSION_PORT_MAX];
+  rte_atomic32_t mac_pending; /* ports still wait the dst mac from arp */
+  /* the arp fail result of each port, the tasklet resolve it again */
+  rte_atomic32_t mac_fail[MT_SESSION_PORT_MAX];
 
   struct st_tx_audio_session_pacing pacing;
 
@@ -767,10 +902,7 @@ struct st_rx_audio_ebu_info {
   int dropped_results;        /* number of results to drop at the beginning */
 
   /* Pass Criteria */
-  int32_t dpvr_max_pass_narrow;
-  int32_t dpvr_max_pass_wide;
-  float dpvr_avg_pass_wide;
-  int32_t tsdf_max_pass;
+  struct st_ebu_audio_pass pass;
 };
 
 struct st_rx_audio_ebu_stat {
@@ -894,6 +1026,9 @@ struct st_tx_ancillary_session_impl {
   uint16_t st40_src_port[MT_SESSION_PORT_MAX]; /* udp port */
   uint16_t st40_dst_port[MT_SESSION_PORT_MAX]; /* udp port */
   struct st_rfc8331_anc_hdr hdr[MT_SESSION_PORT_MAX];
+  rte_atomic32_t mac_pending; /* ports still wait the dst mac from arp */
+  /* the arp fail result of each port, the tasklet resolve it again */
+  rte_atomic32_t mac_fail[MT_SESSION_PORT_MAX];
 
   struct st_tx_ancillary_session_pacing pacing;
   struct st_fps_timing fps_tm;
@@ -1011,6 +1146,16 @@ struct st20_get_converter_request {
   int (*dump)(void* priv);
 };
 
+/* get to put time of the frames, the cost used for the device load */
+struct st_plugin_session_cost {
+  uint64_t metas[ST_PLUGIN_COST_SLOTS]; /* frame meta pointer, 0 for free slot */
+  uint64_t get_ns[ST_PLUGIN_COST_SLOTS];
+  uint64_t cost_ns; /* ewma */
+  uint32_t frames;
+  uint32_t stat_frames;
+  uint64_t stat_cost_ns;
+};
+
 struct st22_encode_session_impl {
   int idx;
   void* parnet; /* point to struct st22_encode_dev_impl */
@@ -1020,6 +1165,7 @@ struct st22_encode_session_impl {
   size_t codestream_max_size;
 
   struct st22_get_encoder_request req;
+  struct st_plugin_session_cost cost;
 };
 
 struct st22_encode_dev_impl {
@@ -1039,6 +1185,7 @@ struct st22_decode_session_impl {
   enum mt_handle_type type; /* for sanity check */
 
   struct st22_get_decoder_request req;
+  struct st_plugin_session_cost cost;
 };
 
 struct st22_decode_dev_impl {
@@ -1058,6 +1205,7 @@ struct st20_convert_session_impl {
   enum mt_handle_type type; /* for sanity check */
 
   struct st20_get_converter_request req;
+  struct st_plugin_session_cost cost;
 };
 
 struct st20_convert_dev_impl {
@@ -1080,6 +1228,60 @@ struct st_dl_plugin_impl {
   struct st_plugin_meta meta;
 };
 
+struct st_plugin_job_impl {
+  enum mt_handle_type type; /* for sanity check */
+  struct mtl_main_impl* parnet;
+  int idx;
+  char name[ST_MAX_NAME_LEN];
+  struct st_plugin_job_ops ops;
+  /*
+   * 0 when idle, else the job is in the queue or running on a worker and it counts
+   * the notifies. Only the holder(the worker or the free on an idle job) touches the job.
+   */
+  rte_atomic32_t pending;
+  rte_atomic32_t freeing;
+  /* held by st_plugin_job_notify across the freeing check, the release waits it */
+  rte_atomic32_t ref_cnt;
+  /* set by st_plugin_job_free, the worker which holds the job releases it */
+  rte_atomic32_t* freed;
+  uint64_t enqueue_ns;
+
+  /* stat, updated by the worker which holds the job */
+  uint32_t stat_frames;
+  uint32_t stat_idle;
+  uint64_t stat_process_ns;
+  uint64_t stat_wait_max_ns;
+};
+
+struct st_plugin_worker {
+  int idx;
+  void* parnet; /* point to struct st_plugin_worker_mgr */
+  pthread_t tid;
+  int cpu; /* -1 if not pinned */
+
+  /* stat, reset by st_plugin_worker_get_stats */
+  uint64_t stat_busy_ns;
+  uint64_t stat_frames;
+  uint64_t stat_wait_max_ns;
+};
+
+struct st_plugin_worker_mgr {
+  bool started;
+  bool stop;
+  struct rte_ring* ring; /* lock-free mp/mc queue of the ready jobs */
+  struct st_plugin_job_impl* jobs[ST_MAX_PLUGIN_JOBS];
+  int nb_jobs;
+  struct st_plugin_worker workers[ST_MAX_PLUGIN_WORKERS];
+  int nb_workers;
+  /* workers sleep here when the queue is empty */
+  pthread_mutex_t wake_mutex;
+  pthread_cond_t wake_cond;
+  int nb_sleeping;
+
+  uint64_t stat_start_ns;
+  rte_atomic32_t stat_queued_max;
+};
+
 struct st_plugin_mgr {
   pthread_mutex_t lock; /* lock for encode_devs/decode_devs */
   struct st22_encode_dev_impl* encode_devs[ST_MAX_ENCODER_DEV];
@@ -1088,6 +1290,8 @@ struct st_plugin_mgr {
   pthread_mutex_t plugins_lock; /* lock for plugins */
   struct st_dl_plugin_impl* plugins[ST_MAX_DL_PLUGINS];
   int plugins_nb;
+  pthread_mutex_t workers_lock; /* lock for workers */
+  struct st_plugin_worker_mgr workers;
 };
 
 struct st_tx_video_session_handle_impl {
@@ -13,21 +13,7 @@
 #define ST_RARTP_PAYLOAD_TYPE_PCM_AUDIO (111)
 #define ST_RANCRTP_PAYLOAD_TYPE_ANCILLARY (113)
 
-#define ST_EBU_CINST_DRAIN_FACTOR (1.1f) /* Drain factor */
-
-#define ST_EBU_LATENCY_MAX_US (1000)                         /* Latency in us */
-#define ST_EBU_LATENCY_MAX_NS (1000 * ST_EBU_LATENCY_MAX_US) /* Latency in ns */
-
-#define ST_EBU_RTP_OFFSET_MIN (-1) /* MIN RTP Offset */
-
-#define ST_EBU_RTP_WRAP_AROUND (0x100000000)
-
-#define ST_EBU_PASS_NARROW "PASSED NARROW"
-#define ST_EBU_PASS_WIDE "FAILED with WIDE"
-/* Extend WA WIDE as no hw rx time */
-#define ST_EBU_PASS_WIDE_WA "FAILED with WIDE WA error"
-#define ST_EBU_PASS "PASSED"
-#define ST_EBU_FAIL "FAILED"
+#include "st_ebu.h" /* the ST_EBU_* defines */
 
 /* total size: 54 */
 struct st_rfc3550_hdr {
@@ -45,6 +31,25 @@ struct st_rfc4175_video_hdr {
   struct st20_rfc4175_rtp_hdr rtp; /* size: 20 */
 } __attribute__((__packed__)) __rte_aligned(2);
 
+/* total size: 82 */
+struct st_rfc4175_video_hdr6 {
+  struct rte_ether_hdr eth;        /* size: 14 */
+  struct rte_ipv6_hdr ipv6;        /* size: 40 */
+  struct rte_udp_hdr udp;          /* size: 8 */
+  struct st20_rfc4175_rtp_hdr rtp; /* size: 20 */
+} __attribute__((__packed__)) __rte_aligned(2);
+
+/* the ipv6 header is 20 bytes more than the ipv4 one */
+#define ST_PKT_IP6_EXTRA_BYTES (sizeof(struct rte_ipv6_hdr) - sizeof(struct rte_ipv4_hdr))
+
+/* total size: 70 */
+struct st20_fec_video_hdr {
+  struct rte_ether_hdr eth;    /* size: 14 */
+  struct rte_ipv4_hdr ipv4;    /* size: 20 */
+  struct rte_udp_hdr udp;      /* size: 8 */
+  struct st20_fec_rtp_hdr rtp; /* size: 28 */
+} __attribute__((__packed__)) __rte_aligned(2);
+
 /* total size: 58 */
 struct st22_rfc9134_video_hdr {
   struct rte_ether_hdr eth;        /* size: 14 */
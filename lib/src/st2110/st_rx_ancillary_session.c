@@ -167,6 +167,7 @@ static int rx_ancillary_session_uinit_hw(struct mtl_main_impl* impl,
 }
 
 static int rx_ancillary_session_init_hw(struct mtl_main_impl* impl,
+                                        struct st_rx_ancillary_sessions_mgr* mgr,
                                         struct st_rx_ancillary_session_impl* s) {
   int idx = s->idx, num_port = s->ops.num_port;
   struct mt_rx_flow flow;
@@ -179,6 +180,7 @@ static int rx_ancillary_session_init_hw(struct mtl_main_impl* impl,
     memset(&flow, 0, sizeof(flow));
     rte_memcpy(flow.dip_addr, s->ops.sip_addr[i], MTL_IP_ADDR_LEN);
     rte_memcpy(flow.sip_addr, mt_sip_addr(impl, port), MTL_IP_ADDR_LEN);
+    rte_memcpy(flow.ssm_addr, s->ops.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     flow.port_flow = true;
     flow.dst_port = s->st40_dst_port[i];
 
@@ -194,6 +196,8 @@ static int rx_ancillary_session_init_hw(struct mtl_main_impl* impl,
 
     info("%s(%d), port(l:%d,p:%d), queue %d udp %d\n", __func__, idx, i, port,
          mt_dev_rx_queue_id(s->queue[i]), flow.dst_port);
+    /* wake the sch by the rx interrupt when the stream is quiet */
+    mt_sch_add_rx_intr(mgr->tasklet->sch, s->queue[i]);
   }
 
   return 0;
@@ -206,6 +210,7 @@ static int rx_ancillary_session_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -226,7 +231,7 @@ static int rx_ancillary_session_init_mcast(struct mtl_main_impl* impl,
       return 0;
     }
     ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
-                        mt_port_logic2phy(s->port_maps, i));
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -296,7 +301,7 @@ static int rx_ancillary_session_attach(struct mtl_main_impl* impl,
   s->st40_stat_last_time = mt_get_monotonic_time();
   rte_atomic32_set(&s->st40_stat_frames_received, 0);
 
-  ret = rx_ancillary_session_init_hw(impl, s);
+  ret = rx_ancillary_session_init_hw(impl, mgr, s);
   if (ret < 0) {
     err("%s(%d), rx_audio_session_init_hw fail %d\n", __func__, idx, ret);
     return -EIO;
@@ -356,6 +361,7 @@ static int rx_ancillary_session_detach(struct mtl_main_impl* impl,
 }
 
 static int rx_ancillary_session_update_src(struct mtl_main_impl* impl,
+                                           struct st_rx_ancillary_sessions_mgr* mgr,
                                            struct st_rx_ancillary_session_impl* s,
                                            struct st_rx_source_info* src) {
   int ret = -EIO;
@@ -375,7 +381,7 @@ static int rx_ancillary_session_update_src(struct mtl_main_impl* impl,
   /* reset seq id */
   s->st40_seq_id = -1;
 
-  ret = rx_ancillary_session_init_hw(impl, s);
+  ret = rx_ancillary_session_init_hw(impl, mgr, s);
   if (ret < 0) {
     err("%s(%d), init hw fail %d\n", __func__, idx, ret);
     return ret;
@@ -401,7 +407,7 @@ static int rx_ancillary_sessions_mgr_update_src(struct st_rx_ancillary_sessions_
     return -EIO;
   }
 
-  ret = rx_ancillary_session_update_src(mgr->parnet, s, src);
+  ret = rx_ancillary_session_update_src(mgr->parnet, mgr, s, src);
   rx_ancillary_session_put(mgr, idx);
   if (ret < 0) {
     err("%s(%d,%d), fail %d\n", __func__, midx, idx, ret);
@@ -430,6 +436,7 @@ static int rx_ancillary_sessions_mgr_init(struct mtl_main_impl* impl,
   ops.start = rx_ancillary_sessions_tasklet_start;
   ops.stop = rx_ancillary_sessions_tasklet_stop;
   ops.handler = rx_ancillary_sessions_tasklet_handler;
+  ops.intr_rx = mt_has_rx_intr(impl);
 
   mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!mgr->tasklet) {
@@ -757,6 +764,33 @@ void st40_rx_put_mbuf(st40_rx_handle handle, void* mbuf) {
   if (pkt) rte_pktmbuf_free(pkt);
 }
 
+uint16_t st40_rx_get_mbufs(st40_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_ancillary_session_handle_impl* s_impl = handle;
+  struct st_rx_ancillary_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_RX_ANC) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), rtp ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_rx_get_mbufs(s->packet_ring, bufs, nb);
+}
+
+void st40_rx_put_mbufs(st40_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_ancillary_session_handle_impl* s_impl = handle;
+
+  if (s_impl->type != MT_HANDLE_RX_ANC)
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+
+  mt_rtp_free_mbufs(bufs, nb);
+}
+
 int st40_rx_get_queue_meta(st40_rx_handle handle, struct st_queue_meta* meta) {
   struct st_rx_ancillary_session_handle_impl* s_impl = handle;
   struct st_rx_ancillary_session_impl* s;
@@ -58,21 +58,18 @@ static char* ra_ebu_dpvr_result(struct st_rx_audio_session_impl* s) {
   struct st_rx_audio_ebu_stat* ebu = &s->ebu;
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
+  enum st_ebu_grade grade =
+      st_ebu_dpvr_grade(&ebu_info->pass, ebu->dpvr_max, ebu->dpvr_avg);
 
-  if (ebu->dpvr_max >= 0 && ebu->dpvr_max < ebu_info->dpvr_max_pass_narrow) {
+  if (grade == ST_EBU_GRADE_NARROW) {
     ebu_result->dpvr_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
-  }
-
-  if (ebu->dpvr_max >= 0 && ebu->dpvr_max < ebu_info->dpvr_max_pass_wide &&
-      ebu->dpvr_avg >= 0 && ebu->dpvr_avg < ebu_info->dpvr_avg_pass_wide) {
+  } else if (grade == ST_EBU_GRADE_WIDE) {
     ebu_result->dpvr_pass_wide++;
-    return ST_EBU_PASS_WIDE;
+  } else {
+    ebu_result->dpvr_fail++;
+    ebu->compliant = false;
   }
-
-  ebu_result->dpvr_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
+  return (char*)st_ebu_grade_str(grade);
 }
 
 static char* ra_ebu_tsdf_result(struct st_rx_audio_session_impl* s) {
@@ -80,7 +77,7 @@ static char* ra_ebu_tsdf_result(struct st_rx_audio_session_impl* s) {
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
 
-  if (ebu->tsdf_max < ebu_info->tsdf_max_pass) {
+  if (ebu->tsdf_max < ebu_info->pass.tsdf_max_pass) {
     ebu_result->tsdf_pass++;
     return ST_EBU_PASS;
   }
@@ -95,7 +92,7 @@ static void ra_ebu_result(struct st_rx_audio_session_impl* s) {
   int idx = s->idx;
 
   /* Maximum Timestamped Delay Factor */
-  int64_t tsdf = (ebu->dpvr_max - ebu->dpvr_first) - (ebu->dpvr_min - ebu->dpvr_first);
+  int64_t tsdf = st_ebu_tsdf(ebu->dpvr_min, ebu->dpvr_max, ebu->dpvr_first);
   ebu->tsdf_max = RTE_MAX(tsdf, ebu->tsdf_max);
   ebu->dpvr_first = 0;
 
@@ -120,17 +117,11 @@ static void ra_ebu_on_packet(struct st_rx_audio_session_impl* s, uint32_t rtp_tm
   struct st_rx_audio_ebu_stat* ebu = &s->ebu;
   struct st_rx_audio_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_audio_ebu_result* ebu_result = &s->ebu_result;
+  struct st_ebu_epoch epoch;
 
-  uint64_t epochs = (double)pkt_tmstamp / ebu_info->frame_time;
-  uint64_t epoch_tmstamp = (double)epochs * ebu_info->frame_time;
-  double fpt_delta = (double)pkt_tmstamp - epoch_tmstamp;
-  uint64_t tmstamp64 = epochs * ebu_info->frame_time_sampling;
-  uint32_t tmstamp32 = tmstamp64;
-  double diff_rtp_ts = (double)rtp_tmstamp - tmstamp32;
-  double diff_rtp_ts_ns =
-      diff_rtp_ts * ebu_info->frame_time / ebu_info->frame_time_sampling;
-  double latency = fpt_delta - diff_rtp_ts_ns;
-  double dpvr = latency / 1000;
+  st_ebu_epoch_calc(&epoch, pkt_tmstamp, rtp_tmstamp, ebu_info->frame_time,
+                    ebu_info->frame_time_sampling);
+  double dpvr = epoch.latency / 1000;
 
   ebu->pkt_num++;
 
@@ -161,19 +152,17 @@ static int ra_ebu_init(struct mtl_main_impl* impl, struct st_rx_audio_session_im
   ebu_info->frame_time = (double)1000000000.0 * 1 / 1000; /* 1ms, in ns */
   ebu_info->frame_time_sampling = (double)(sampling * 1000) * 1 / 1000;
 
-  ebu_info->dpvr_max_pass_narrow = 3 * ebu_info->frame_time / 1000; /* in us */
-  ebu_info->dpvr_max_pass_wide = 20 * ebu_info->frame_time / 1000;  /* in us */
-  ebu_info->dpvr_avg_pass_wide = 2.5 * ebu_info->frame_time / 1000; /* in us */
-  ebu_info->tsdf_max_pass = 17 * ebu_info->frame_time / 1000;       /* in us */
+  st_ebu_audio_pass_init(&ebu_info->pass);
 
   ebu_info->dropped_results = 10; /* we drop first 10 results */
 
   info("%s[%02d], Delta Packet vs RTP Pass Criteria(narrow) min %d (us) max %d (us)\n",
-       __func__, idx, 0, ebu_info->dpvr_max_pass_narrow);
+       __func__, idx, 0, ebu_info->pass.dpvr_max_pass_narrow);
   info("%s[%02d], Delta Packet vs RTP Pass Criteria(wide) max %d (us) avg %.2f (us)\n",
-       __func__, idx, ebu_info->dpvr_max_pass_wide, ebu_info->dpvr_avg_pass_wide);
+       __func__, idx, ebu_info->pass.dpvr_max_pass_wide,
+       ebu_info->pass.dpvr_avg_pass_wide);
   info("%s[%02d], Maximum Timestamped Delay Factor Pass Criteria %d (us)\n", __func__,
-       idx, ebu_info->tsdf_max_pass);
+       idx, ebu_info->pass.tsdf_max_pass);
 
   return 0;
 }
@@ -562,6 +551,7 @@ static int rx_audio_session_uinit_hw(struct mtl_main_impl* impl,
 }
 
 static int rx_audio_session_init_hw(struct mtl_main_impl* impl,
+                                    struct st_rx_audio_sessions_mgr* mgr,
                                     struct st_rx_audio_session_impl* s) {
   int idx = s->idx, num_port = s->ops.num_port;
   struct mt_rx_flow flow;
@@ -574,6 +564,7 @@ static int rx_audio_session_init_hw(struct mtl_main_impl* impl,
     memset(&flow, 0, sizeof(flow));
     rte_memcpy(flow.dip_addr, s->ops.sip_addr[i], MTL_IP_ADDR_LEN);
     rte_memcpy(flow.sip_addr, mt_sip_addr(impl, port), MTL_IP_ADDR_LEN);
+    rte_memcpy(flow.ssm_addr, s->ops.mcast_sip_addr[i], MTL_IP_ADDR_LEN);
     flow.port_flow = true;
     flow.dst_port = s->st30_dst_port[i];
 
@@ -589,6 +580,8 @@ static int rx_audio_session_init_hw(struct mtl_main_impl* impl,
 
     info("%s(%d), port(l:%d,p:%d), queue %d udp %d\n", __func__, idx, i, port,
          mt_dev_rx_queue_id(s->queue[i]), flow.dst_port);
+    /* wake the sch by the rx interrupt when the stream is quiet */
+    mt_sch_add_rx_intr(mgr->tasklet->sch, s->queue[i]);
   }
 
   return 0;
@@ -601,6 +594,7 @@ static int rx_audio_session_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -621,7 +615,7 @@ static int rx_audio_session_init_mcast(struct mtl_main_impl* impl,
       return 0;
     }
     ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
-                        mt_port_logic2phy(s->port_maps, i));
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -712,7 +706,7 @@ static int rx_audio_session_attach(struct mtl_main_impl* impl,
     }
   }
 
-  ret = rx_audio_session_init_hw(impl, s);
+  ret = rx_audio_session_init_hw(impl, mgr, s);
   if (ret < 0) {
     err("%s(%d), rx_audio_session_init_hw fail %d\n", __func__, idx, ret);
     return -EIO;
@@ -775,6 +769,7 @@ static int rx_audio_session_detach(struct mtl_main_impl* impl,
 }
 
 static int rx_audio_session_update_src(struct mtl_main_impl* impl,
+                                       struct st_rx_audio_sessions_mgr* mgr,
                                        struct st_rx_audio_session_impl* s,
                                        struct st_rx_source_info* src) {
   int ret = -EIO;
@@ -794,7 +789,7 @@ static int rx_audio_session_update_src(struct mtl_main_impl* impl,
   /* reset seq id */
   s->st30_seq_id = -1;
 
-  ret = rx_audio_session_init_hw(impl, s);
+  ret = rx_audio_session_init_hw(impl, mgr, s);
   if (ret < 0) {
     err("%s(%d), init hw fail %d\n", __func__, idx, ret);
     return ret;
@@ -820,7 +815,7 @@ static int rx_audio_sessions_mgr_update_src(struct st_rx_audio_sessions_mgr* mgr
     return -EIO;
   }
 
-  ret = rx_audio_session_update_src(mgr->parnet, s, src);
+  ret = rx_audio_session_update_src(mgr->parnet, mgr, s, src);
   rx_audio_session_put(mgr, idx);
   if (ret < 0) {
     err("%s(%d,%d), fail %d\n", __func__, midx, idx, ret);
@@ -848,6 +843,7 @@ static int rx_audio_sessions_mgr_init(struct mtl_main_impl* impl, struct mt_sch_
   ops.start = rx_audio_sessions_tasklet_start;
   ops.stop = rx_audio_sessions_tasklet_stop;
   ops.handler = rx_audio_sessions_tasklet_handler;
+  ops.intr_rx = mt_has_rx_intr(impl);
 
   mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!mgr->tasklet) {
@@ -1212,6 +1208,33 @@ void st30_rx_put_mbuf(st30_rx_handle handle, void* mbuf) {
   if (pkt) rte_pktmbuf_free(pkt);
 }
 
+uint16_t st30_rx_get_mbufs(st30_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_audio_session_handle_impl* s_impl = handle;
+  struct st_rx_audio_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_RX_AUDIO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->st30_rtps_ring) {
+    err("%s(%d), rtp ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_rx_get_mbufs(s->st30_rtps_ring, bufs, nb);
+}
+
+void st30_rx_put_mbufs(st30_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_audio_session_handle_impl* s_impl = handle;
+
+  if (s_impl->type != MT_HANDLE_RX_AUDIO)
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+
+  mt_rtp_free_mbufs(bufs, nb);
+}
+
 int st30_rx_get_queue_meta(st30_rx_handle handle, struct st_queue_meta* meta) {
   struct st_rx_audio_session_handle_impl* s_impl = handle;
   struct st_rx_audio_session_impl* s;
@@ -6,7 +6,10 @@
 
 #include <math.h>
 
+#include "../mt_ip6.h"
 #include "../mt_log.h"
+#include "../mt_ndp.h"
+#include "st_fec.h"
 #include "st_fmt.h"
 
 #define RV_PKT_NOT_FREE (1)
@@ -88,50 +91,41 @@ static inline float rv_ebu_calculate_avg(uint32_t cnt, int64_t sum) {
 static char* rv_ebu_cinst_result(struct st_rx_video_ebu_stat* ebu,
                                  struct st_rx_video_ebu_info* ebu_info,
                                  struct st_rx_video_ebu_result* ebu_result) {
-  if (ebu->cinst_max <= ebu_info->c_max_narrow_pass) {
-    ebu_result->cinst_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
-  }
-
-  if (ebu->cinst_max <= ebu_info->c_max_wide_pass) {
-    ebu_result->cinst_pass_wide++;
-    ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE;
-  }
+  /* WA band as the RX time inaccurate */
+  enum st_ebu_grade grade = st_ebu_cinst_grade(&ebu_info->pass, ebu->cinst_max, true);
 
-  if (ebu->cinst_max <= (ebu_info->c_max_wide_pass * 16)) {
+  if (grade == ST_EBU_GRADE_NARROW) {
+    ebu_result->cinst_pass_narrow++;
+  } else if (grade == ST_EBU_GRADE_FAIL) {
+    ebu_result->cinst_fail++;
+    ebu->compliant = false;
+  } else {
     ebu_result->cinst_pass_wide++;
     ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE_WA; /* WA, the RX time inaccurate */
   }
-
-  ebu_result->cinst_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
+  return (char*)st_ebu_grade_str(grade);
 }
 
 static char* rv_ebu_vrx_result(struct st_rx_video_ebu_stat* ebu,
                                struct st_rx_video_ebu_info* ebu_info,
                                struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->vrx_min > 0) && (ebu->vrx_max <= ebu_info->vrx_full_narrow_pass)) {
-    ebu_result->vrx_pass_narrow++;
-    return ST_EBU_PASS_NARROW;
-  }
+  enum st_ebu_grade grade = st_ebu_vrx_grade(&ebu_info->pass, ebu->vrx_min, ebu->vrx_max);
 
-  if ((ebu->vrx_min > 0) && (ebu->vrx_max <= ebu_info->vrx_full_wide_pass)) {
+  if (grade == ST_EBU_GRADE_NARROW) {
+    ebu_result->vrx_pass_narrow++;
+  } else if (grade == ST_EBU_GRADE_WIDE) {
     ebu_result->vrx_pass_wide++;
     ebu->compliant_narrow = false;
-    return ST_EBU_PASS_WIDE;
+  } else {
+    ebu_result->vrx_fail++;
+    ebu->compliant = false;
   }
-
-  ebu_result->vrx_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
+  return (char*)st_ebu_grade_str(grade);
 }
 
 static char* rv_ebu_latency_result(struct st_rx_video_ebu_stat* ebu,
                                    struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->latency_min < 0) || (ebu->latency_max > ST_EBU_LATENCY_MAX_NS)) {
+  if (!st_ebu_latency_pass(ebu->latency_min, ebu->latency_max)) {
     ebu_result->latency_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -144,8 +138,8 @@ static char* rv_ebu_latency_result(struct st_rx_video_ebu_stat* ebu,
 static char* rv_ebu_rtp_offset_result(struct st_rx_video_ebu_stat* ebu,
                                       struct st_rx_video_ebu_info* ebu_info,
                                       struct st_rx_video_ebu_result* ebu_result) {
-  if ((ebu->rtp_offset_min < ST_EBU_RTP_OFFSET_MIN) ||
-      (ebu->rtp_offset_max > ebu_info->rtp_offset_max_pass)) {
+  if (!st_ebu_rtp_offset_pass(&ebu_info->pass, ebu->rtp_offset_min,
+                              ebu->rtp_offset_max)) {
     ebu_result->rtp_offset_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -158,9 +152,8 @@ static char* rv_ebu_rtp_offset_result(struct st_rx_video_ebu_stat* ebu,
 static char* rv_ebu_rtp_ts_delta_result(struct st_rx_video_ebu_stat* ebu,
                                         struct st_rx_video_ebu_info* ebu_info,
                                         struct st_rx_video_ebu_result* ebu_result) {
-  int32_t rtd = ebu_info->frame_time_sampling;
-
-  if ((ebu->rtp_ts_delta_min < rtd) || (ebu->rtp_ts_delta_max > (rtd + 1))) {
+  if (!st_ebu_rtp_ts_delta_pass(ebu_info->frame_time_sampling, ebu->rtp_ts_delta_min,
+                                ebu->rtp_ts_delta_max)) {
     ebu_result->rtp_ts_delta_fail++;
     ebu->compliant = false;
     return ST_EBU_FAIL;
@@ -170,21 +163,20 @@ static char* rv_ebu_rtp_ts_delta_result(struct st_rx_video_ebu_stat* ebu,
   return ST_EBU_PASS;
 }
 
-static char* rv_ebu_fpt_result(struct st_rx_video_ebu_stat* ebu, uint32_t tr_offset,
+static char* rv_ebu_fpt_result(struct st_rx_video_ebu_stat* ebu,
+                               struct st_rx_video_ebu_info* ebu_info,
                                struct st_rx_video_ebu_result* ebu_result) {
-  if (ebu->fpt_max <= tr_offset) {
-    ebu_result->fpt_pass++;
-    return ST_EBU_PASS;
-  }
+  /* WA band as no HW RX time */
+  enum st_ebu_grade grade = st_ebu_fpt_grade(&ebu_info->pass, ebu->fpt_max, true);
 
-  if (ebu->fpt_max <= (tr_offset * 2)) { /* WA as no HW RX time */
-    ebu_result->fpt_pass++;
-    return ST_EBU_PASS_WIDE_WA;
+  if (grade == ST_EBU_GRADE_FAIL) {
+    ebu_result->fpt_fail++;
+    ebu->compliant = false;
+    return ST_EBU_FAIL;
   }
 
-  ebu_result->fpt_fail++;
-  ebu->compliant = false;
-  return ST_EBU_FAIL;
+  ebu_result->fpt_pass++;
+  return grade == ST_EBU_GRADE_NARROW ? ST_EBU_PASS : ST_EBU_PASS_WIDE_WA;
 }
 
 static void rv_ebu_result(struct st_rx_video_session_impl* s) {
@@ -207,8 +199,8 @@ static void rv_ebu_result(struct st_rx_video_session_impl* s) {
   info("%s(%d), VRX AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx, ebu->vrx_avg,
        ebu->vrx_min, ebu->vrx_max, rv_ebu_vrx_result(ebu, ebu_info, ebu_result));
   info("%s(%d), TRO %.2f TPRS %.2f FPT AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx,
-       ebu_info->tr_offset, ebu_info->trs, ebu->fpt_avg, ebu->fpt_min, ebu->fpt_max,
-       rv_ebu_fpt_result(ebu, ebu_info->tr_offset, ebu_result));
+       ebu_info->pass.tr_offset, ebu_info->pass.trs, ebu->fpt_avg, ebu->fpt_min,
+       ebu->fpt_max, rv_ebu_fpt_result(ebu, ebu_info, ebu_result));
   info("%s(%d), LATENCY AVG %.2f MIN %d MAX %d test %s!\n", __func__, idx,
        ebu->latency_avg, ebu->latency_min, ebu->latency_max,
        rv_ebu_latency_result(ebu, ebu_result));
@@ -232,9 +224,11 @@ static void rv_ebu_on_frame(struct st_rx_video_session_impl* s, uint32_t rtp_tms
   struct st_rx_video_ebu_stat* ebu = &s->ebu;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
   struct st_rx_video_ebu_result* ebu_result = &s->ebu_result;
-  uint64_t epochs = (double)pkt_tmstamp / ebu_info->frame_time;
-  uint64_t epoch_tmstamp = (double)epochs * ebu_info->frame_time;
-  double fpt_delta = (double)pkt_tmstamp - epoch_tmstamp;
+  struct st_ebu_epoch epoch;
+
+  st_ebu_epoch_calc(&epoch, pkt_tmstamp, rtp_tmstamp, ebu_info->frame_time,
+                    ebu_info->frame_time_sampling);
+  double fpt_delta = epoch.fpt;
 
   ebu->frame_idx++;
   if (ebu->frame_idx % (60 * 5) == 0) { /* every 5(60fps)/10(30fps) seconds */
@@ -255,7 +249,7 @@ static void rv_ebu_on_frame(struct st_rx_video_session_impl* s, uint32_t rtp_tms
     rv_ebu_clear_result(ebu);
   }
 
-  ebu->cur_epochs = epochs;
+  ebu->cur_epochs = epoch.epochs;
   ebu->vrx_drained_prev = 0;
   ebu->vrx_prev = 0;
   ebu->cinmtl_initial_time = pkt_tmstamp;
@@ -267,12 +261,8 @@ static void rv_ebu_on_frame(struct st_rx_video_session_impl* s, uint32_t rtp_tms
   ebu->fpt_max = RTE_MAX(fpt_delta, ebu->fpt_max);
   ebu->fpt_cnt++;
 
-  uint64_t tmstamp64 = epochs * ebu_info->frame_time_sampling;
-  uint32_t tmstamp32 = tmstamp64;
-  double diff_rtp_ts = (double)rtp_tmstamp - tmstamp32;
-  double diff_rtp_ts_ns =
-      diff_rtp_ts * ebu_info->frame_time / ebu_info->frame_time_sampling;
-  double latency = fpt_delta - diff_rtp_ts_ns;
+  double diff_rtp_ts = epoch.rtp_offset;
+  double latency = epoch.latency;
 
   /* calculate latency */
   ebu->latency_sum += latency;
@@ -302,33 +292,25 @@ static void rv_ebu_on_packet(struct st_rx_video_session_impl* s, uint32_t rtp_tm
                              uint64_t pkt_tmstamp, int pkt_idx) {
   struct st_rx_video_ebu_stat* ebu = &s->ebu;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
-  uint64_t epoch_tmstamp;
-  double tvd, packet_delta_ns, trs = ebu_info->trs;
 
   if (!ebu_info->init) return;
 
   if (!pkt_idx) /* start of new frame */
     rv_ebu_on_frame(s, rtp_tmstamp, pkt_tmstamp);
 
-  epoch_tmstamp = (uint64_t)(ebu->cur_epochs * ebu_info->frame_time);
-  tvd = epoch_tmstamp + ebu_info->tr_offset;
-
   /* Calculate vrx */
-  packet_delta_ns = (double)pkt_tmstamp - tvd;
-  int32_t drained = (packet_delta_ns + trs) / trs;
-  int32_t vrx_cur = ebu->vrx_prev + 1 - (drained - ebu->vrx_drained_prev);
+  int32_t vrx_cur = st_ebu_vrx(pkt_tmstamp, ebu->cur_epochs, ebu_info->frame_time,
+                               &ebu_info->pass, ebu->vrx_prev, &ebu->vrx_drained_prev);
 
   ebu->vrx_sum += vrx_cur;
   ebu->vrx_min = RTE_MIN(vrx_cur, ebu->vrx_min);
   ebu->vrx_max = RTE_MAX(vrx_cur, ebu->vrx_max);
   ebu->vrx_cnt++;
   ebu->vrx_prev = vrx_cur;
-  ebu->vrx_drained_prev = drained;
 
   /* Calculate C-inst */
-  int exp_cin_pkts =
-      ((pkt_tmstamp - ebu->cinmtl_initial_time) / trs) * ST_EBU_CINST_DRAIN_FACTOR;
-  int cinst = RTE_MAX(0, pkt_idx - exp_cin_pkts);
+  int cinst = st_ebu_cinst(pkt_tmstamp, ebu->cinmtl_initial_time, ebu_info->pass.trs,
+                           pkt_idx);
 
   ebu->cinst_sum += cinst;
   ebu->cinst_min = RTE_MIN(cinst, ebu->cinst_min);
@@ -351,7 +333,7 @@ static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_im
   int idx = s->idx, ret;
   struct st_rx_video_ebu_info* ebu_info = &s->ebu_info;
   struct st20_rx_ops* ops = &s->ops;
-  double frame_time, frame_time_s;
+  double frame_time;
   struct st_fps_timing fps_tm;
 
   rv_ebu_clear_result(&s->ebu);
@@ -362,7 +344,6 @@ static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_im
     return ret;
   }
 
-  frame_time_s = (double)fps_tm.den / fps_tm.mul;
   frame_time = (double)1000000000.0 * fps_tm.den / fps_tm.mul;
 
   int st20_total_pkts = s->detector.pkt_per_frame;
@@ -372,49 +353,22 @@ static int rv_ebu_init(struct mtl_main_impl* impl, struct st_rx_video_session_im
     return -EINVAL;
   }
 
-  double ractive = 1080.0 / 1125.0;
-  if (ops->interlaced && ops->height <= 576) {
-    ractive = (ops->height == 480) ? 487.0 / 525.0 : 576.0 / 625.0;
-  }
-
   ebu_info->frame_time = frame_time;
   ebu_info->frame_time_sampling =
       (double)(fps_tm.sampling_clock_rate) * fps_tm.den / fps_tm.mul;
-  ebu_info->trs = frame_time * ractive / st20_total_pkts;
-  if (!ops->interlaced) {
-    ebu_info->tr_offset =
-        ops->height >= 1080 ? frame_time * (43.0 / 1125.0) : frame_time * (28.0 / 750.0);
-  } else {
-    if (ops->height == 480) {
-      ebu_info->tr_offset = frame_time * (20.0 / 525.0) * 2;
-    } else if (ops->height == 576) {
-      ebu_info->tr_offset = frame_time * (26.0 / 625.0) * 2;
-    } else {
-      ebu_info->tr_offset = frame_time * (22.0 / 1125.0) * 2;
-    }
-  }
-
-  ebu_info->c_max_narrow_pass =
-      RTE_MAX(4, (double)st20_total_pkts / (43200 * ractive * frame_time_s));
-  ebu_info->c_max_wide_pass =
-      RTE_MAX(16, (double)st20_total_pkts / (21600 * frame_time_s));
-
-  ebu_info->vrx_full_narrow_pass = RTE_MAX(8, st20_total_pkts / (27000 * frame_time_s));
-  ebu_info->vrx_full_wide_pass = RTE_MAX(720, st20_total_pkts / (300 * frame_time_s));
-
-  ebu_info->rtp_offset_max_pass =
-      ceil((ebu_info->tr_offset / NS_PER_S) * fps_tm.sampling_clock_rate) + 1;
+  st_ebu_video_pass_init(&ebu_info->pass, st20_total_pkts, frame_time,
+                         fps_tm.sampling_clock_rate, ops->height, ops->interlaced);
 
   ebu_info->dropped_results = 4; /* we drop the first 4 results */
 
-  info("%s[%02d], trs %f tr offset %f sampling %f\n", __func__, idx, ebu_info->trs,
-       ebu_info->tr_offset, ebu_info->frame_time_sampling);
+  info("%s[%02d], trs %f tr offset %f sampling %f\n", __func__, idx, ebu_info->pass.trs,
+       ebu_info->pass.tr_offset, ebu_info->frame_time_sampling);
   info(
       "%s[%02d], cmax_narrow %d cmax_wide %d vrx_full_narrow %d vrx_full_wide %d "
       "rtp_offset_max %d\n",
-      __func__, idx, ebu_info->c_max_narrow_pass, ebu_info->c_max_wide_pass,
-      ebu_info->vrx_full_narrow_pass, ebu_info->vrx_full_wide_pass,
-      ebu_info->rtp_offset_max_pass);
+      __func__, idx, ebu_info->pass.c_max_narrow_pass, ebu_info->pass.c_max_wide_pass,
+      ebu_info->pass.vrx_full_narrow_pass, ebu_info->pass.vrx_full_wide_pass,
+      ebu_info->pass.rtp_offset_max_pass);
   ebu_info->init = true;
   return 0;
 }
@@ -828,6 +782,8 @@ static inline void rv_slot_init_frame_size(struct st_rx_video_session_impl* s,
                                            struct st_rx_video_slot_impl* slot) {
   slot->frame_recv_size = 0;
   slot->pkt_lcore_frame_recv_size = 0;
+  slot->crc = MT_CRC32C_INIT;
+  slot->crc_size = 0;
 }
 
 static inline size_t rv_slot_get_frame_size(struct st_rx_video_session_impl* s,
@@ -864,11 +820,52 @@ static int rv_init(struct mtl_main_impl* impl, struct st_rx_video_sessions_mgr*
   return 0;
 }
 
+static inline struct st20_fec_rtp_hdr* rv_fec_rtp_hdr(struct rte_mbuf* mbuf) {
+  size_t hdr_offset =
+      sizeof(struct st20_fec_video_hdr) - sizeof(struct st20_fec_rtp_hdr);
+  return rte_pktmbuf_mtod_offset(mbuf, struct st20_fec_rtp_hdr*, hdr_offset);
+}
+
+/* pkt index in the frame of the member j protected by the fec pkt */
+static inline int rv_fec_member_idx(struct st20_fec_rtp_hdr* rtp, int j) {
+  int base = ntohl(rtp->base_idx);
+
+  if (rtp->type == ST20_FEC_TYPE_ROW) return base + rtp->index * rtp->cols + j;
+  return base + rtp->index + j * rtp->cols;
+}
+
+static inline uint8_t* rv_fec_srd(struct st_rx_video_slot_impl* slot, int pkt_idx) {
+  return slot->fec_srd + (size_t)pkt_idx * ST20_FEC_SRD_LEN;
+}
+
+/* free the fec pkts held by the slot, count the pkts lost if the frame is dropped */
+static void rv_fec_slot_drop(struct st_rx_video_session_impl* s,
+                             struct st_rx_video_slot_impl* slot, bool frame_drop) {
+  for (uint16_t i = 0; i < slot->fec_pending_cnt; i++) {
+    struct rte_mbuf* mbuf = slot->fec_pending[i];
+    if (frame_drop) {
+      struct st20_fec_rtp_hdr* rtp = rv_fec_rtp_hdr(mbuf);
+      for (int j = 0; j < rtp->count; j++) {
+        /* mark it in the bitmap to count once only */
+        if (!mt_bitmap_test_and_set(slot->frame_bitmap, rv_fec_member_idx(rtp, j)))
+          s->stat_pkts_fec_unrecoverable++;
+      }
+    }
+    rte_pktmbuf_free(mbuf);
+  }
+  slot->fec_pending_cnt = 0;
+}
+
 static int rv_uinit_slot(struct st_rx_video_session_impl* s) {
   struct st_rx_video_slot_impl* slot;
 
   for (int i = 0; i < ST_VIDEO_RX_REC_NUM_OFO; i++) {
     slot = &s->slots[i];
+    rv_fec_slot_drop(s, slot, false);
+    if (slot->fec_srd) {
+      mt_rte_free(slot->fec_srd);
+      slot->fec_srd = NULL;
+    }
     if (slot->frame_bitmap) {
       mt_rte_free(slot->frame_bitmap);
       slot->frame_bitmap = NULL;
@@ -882,6 +879,10 @@ static int rv_uinit_slot(struct st_rx_video_session_impl* s) {
       slot->frame = NULL;
     }
   }
+  if (s->fec_unit) {
+    mt_rte_free(s->fec_unit);
+    s->fec_unit = NULL;
+  }
 
   dbg("%s(%d), succ\n", __func__, s->idx);
   return 0;
@@ -908,6 +909,7 @@ static int rv_init_slot(struct mtl_main_impl* impl, struct st_rx_video_session_i
     slot->pkts_redunant_received = 0;
     slot->tmstamp = 0;
     slot->seq_id_got = false;
+    slot->seq_id_guess = false;
     frame_bitmap = mt_rte_zmalloc_socket(bitmap_size, soc_id);
     if (!frame_bitmap) {
       err("%s(%d), bitmap malloc %" PRIu64 " fail\n", __func__, idx, bitmap_size);
@@ -915,6 +917,16 @@ static int rv_init_slot(struct mtl_main_impl* impl, struct st_rx_video_session_i
     }
     slot->frame_bitmap = frame_bitmap;
 
+    if (s->ops.fec_payload_type) {
+      /* srd of each pkt for the fec recovery */
+      slot->fec_srd = mt_rte_zmalloc_socket(bitmap_size * 8 * ST20_FEC_SRD_LEN, soc_id);
+      if (!slot->fec_srd) {
+        err("%s(%d), fec srd malloc fail\n", __func__, idx);
+        return -ENOMEM;
+      }
+      slot->fec_pending_cnt = 0;
+    }
+
     if (ST20_TYPE_SLICE_LEVEL == type) {
       slice_info = mt_rte_zmalloc_socket(sizeof(*slice_info), soc_id);
       if (!slice_info) {
@@ -924,6 +936,14 @@ static int rv_init_slot(struct mtl_main_impl* impl, struct st_rx_video_session_i
       slot->slice_info = slice_info;
     }
   }
+  if (s->ops.fec_payload_type) {
+    s->fec_unit = mt_rte_zmalloc_socket(ST_PKT_MAX_ETHER_BYTES, soc_id);
+    if (!s->fec_unit) {
+      err("%s(%d), fec unit malloc fail\n", __func__, idx);
+      return -ENOMEM;
+    }
+    s->fec_simd_level = mtl_get_simd_level();
+  }
   s->slot_idx = -1;
   s->slot_max = 1; /* default only one slot */
 
@@ -931,6 +951,28 @@ static int rv_init_slot(struct mtl_main_impl* impl, struct st_rx_video_session_i
   return 0;
 }
 
+static uint32_t rv_slot_crc(struct st_rx_video_session_impl* s,
+                            struct st_rx_video_slot_impl* slot) {
+  uint32_t crc = slot->crc;
+
+  if (slot->crc_size < s->st20_frame_size) {
+    /* out of order, pkt lcore or fec recovered pkts, crc the frame lines again */
+    uint32_t lines = s->st20_frame_size / s->st20_bytes_in_line;
+
+    s->stat_frames_crc_fallback++;
+    crc = MT_CRC32C_INIT;
+    if (s->st20_linesize > s->st20_bytes_in_line) {
+      for (uint32_t line = 0; line < lines; line++)
+        crc = mt_crc32c_update(crc, slot->frame + line * s->st20_linesize,
+                               s->st20_bytes_in_line);
+    } else {
+      crc = mt_crc32c_update(crc, slot->frame, s->st20_frame_size);
+    }
+  }
+
+  return mt_crc32c_final(crc);
+}
+
 static void rv_frame_notify(struct st_rx_video_session_impl* s,
                             struct st_rx_video_slot_impl* slot) {
   struct st20_rx_ops* ops = &s->ops;
@@ -949,13 +991,15 @@ static void rv_frame_notify(struct st_rx_video_session_impl* s,
   meta->frame_recv_size = rv_slot_get_frame_size(s, slot);
   if (meta->frame_recv_size >= s->st20_frame_size) {
     meta->status = ST_FRAME_STATUS_COMPLETE;
-    if (ops->num_port > 1) {
+    /* a striped stream needs the pkts of both ports, nothing to reconstruct */
+    if ((ops->num_port > 1) && !(ops->flags & ST20_RX_FLAG_PORT_STRIPE)) {
       dbg("%s(%d): pks redunant %u received %u\n", __func__, s->idx,
           slot->pkts_redunant_received, slot->pkts_received);
       if ((slot->pkts_redunant_received + 16) < slot->pkts_received)
         meta->status = ST_FRAME_STATUS_RECONSTRUCTED;
     }
     rte_atomic32_inc(&s->stat_frames_received);
+    if (ops->flags & ST20_RX_FLAG_ENABLE_CRC) meta->crc = rv_slot_crc(s, slot);
 
     /* notify frame */
     int ret = -EIO;
@@ -1123,6 +1167,7 @@ static struct st_rx_video_slot_impl* rv_slot_by_tmstamp(
 
   /* drop frame if any previous */
   if (slot->frame) {
+    rv_fec_slot_drop(s, slot, true);
     if (s->st22_info)
       rv_st22_frame_notify(s, slot, ST_FRAME_STATUS_CORRUPTED);
     else
@@ -1133,6 +1178,7 @@ static struct st_rx_video_slot_impl* rv_slot_by_tmstamp(
   rv_slot_init_frame_size(s, slot);
   slot->tmstamp = tmstamp;
   slot->seq_id_got = false;
+  slot->seq_id_guess = false;
   slot->pkts_received = 0;
   slot->pkts_redunant_received = 0;
   s->slot_idx = slot_idx;
@@ -1174,6 +1220,10 @@ static struct st_rx_video_slot_impl* rv_slot_by_tmstamp(
   slot->frame_iova = frame_info->iova;
 
   s->dma_slot = slot;
+  if (s->dma_dev) {
+    s->dma_probe_frame_cnt++;
+    if (!(s->dma_probe_frame_cnt % ST_RX_VIDEO_DMA_PROBE_INTERVAL)) s->dma_probe = true;
+  }
 
   /* clear bitmap */
   memset(slot->frame_bitmap, 0x0, s->st20_frame_bitmap_size);
@@ -1205,6 +1255,7 @@ static struct st_rx_video_slot_impl* rv_rtp_slot_by_tmstamp(
 
   slot->tmstamp = tmstamp;
   slot->seq_id_got = false;
+  slot->seq_id_guess = false;
   s->slot_idx = slot_idx;
 
   /* clear bitmap */
@@ -1217,6 +1268,7 @@ static struct st_rx_video_slot_impl* rv_rtp_slot_by_tmstamp(
 static void rv_slot_full_frame(struct st_rx_video_session_impl* s,
                                struct st_rx_video_slot_impl* slot) {
   /* end of frame */
+  rv_fec_slot_drop(s, slot, false);
   rv_frame_notify(s, slot);
   rv_slot_init_frame_size(s, slot);
   slot->pkts_received = 0;
@@ -1284,11 +1336,144 @@ static int rv_init_dma(struct mtl_main_impl* impl, struct st_rx_video_session_im
 
   s->dma_dev = dma_dev;
 
+  /* init the adaptive split, no depth limit before the latency got sampled */
+  s->dma_min_size = ST_RX_VIDEO_DMA_MIN_SIZE;
+  s->dma_target_depth = s->dma_nb_desc;
+  s->dma_bytes_per_ns = (double)s->st20_frame_size * st_frame_rate(s->ops.fps) / NS_PER_S;
+  s->dma_cpu_ns_per_kb = 0;
+  s->dma_enq_ns = 0;
+  s->dma_latency_ns = 0;
+  s->dma_probe_frame_cnt = 0;
+  s->dma_probe = false;
+  s->dma_cpu_sample_cnt = 0;
+  s->dma_enq_sample_cnt = 0;
+  s->dma_batch_nb = 0;
+  s->dma_batch_head = 0;
+  s->dma_batch_tail = 0;
+  s->dma_batch_done = 0;
+
   info("%s(%d), succ, dma %d lender id %u\n", __func__, idx, mt_dma_dev_id(dma_dev),
        mt_dma_lender_id(dma_dev));
   return 0;
 }
 
+static inline float rv_dma_ewma(float old, float sample) {
+  if (!old) return sample;
+  return old * 7 / 8 + sample / 8;
+}
+
+/* re-calculate the dma/cpu split from the sampled cost and latency */
+static void rv_dma_policy_update(struct st_rx_video_session_impl* s) {
+  /* break even size: cpu cost to copy the payload equals the cost to enqueue a dma */
+  if (s->dma_cpu_ns_per_kb && s->dma_enq_ns) {
+    uint32_t min_size = s->dma_enq_ns * 1024 / s->dma_cpu_ns_per_kb;
+    s->dma_min_size = RTE_MAX(RTE_MIN(min_size, ST_RX_VIDEO_DMA_MIN_SIZE_HIGH),
+                              ST_RX_VIDEO_DMA_MIN_SIZE_LOW);
+  }
+
+  /* depth to cover the completion latency at the stream rate, 2x for burst */
+  if (s->dma_latency_ns) {
+    uint32_t depth =
+        s->dma_latency_ns * s->dma_bytes_per_ns * 2 / RTE_MAX(s->dma_min_size, 1);
+    depth = RTE_MAX(depth, ST_RX_VIDEO_DMA_DEPTH_MIN);
+    s->dma_target_depth = RTE_MIN(depth, s->dma_nb_desc);
+  }
+}
+
+/* decide if the payload goes to dma or cpu copy */
+static inline bool rv_dma_copy_select(struct st_rx_video_session_impl* s,
+                                      struct st_rx_video_slot_impl* slot,
+                                      size_t payload_length) {
+  struct mtl_dma_lender_dev* dma_dev = s->dma_dev;
+
+  if (s->dma_probe && !mt_dma_full(dma_dev)) {
+    s->dma_probe = false;
+    s->dma_enq_sample_cnt = 0; /* sample the enqueue cost of this probe */
+    s->stat_pkts_dma_probe++;
+    return true;
+  }
+  if (payload_length <= s->dma_min_size) {
+    s->stat_pkts_cpu_small++;
+    return false;
+  }
+  if ((dma_dev->nb_borrowed >= s->dma_target_depth) || mt_dma_full(dma_dev)) {
+    s->stat_pkts_cpu_depth++;
+    return false;
+  }
+  /* frame tail arrives within the dma latency, cpu copy to avoid the end of frame wait */
+  size_t recv = rv_slot_get_frame_size(s, slot);
+  size_t left = (recv < s->st20_frame_size) ? (s->st20_frame_size - recv) : 0;
+  if (left < (s->dma_latency_ns * s->dma_bytes_per_ns)) {
+    s->stat_pkts_cpu_tail++;
+    return false;
+  }
+
+  return true;
+}
+
+static inline void rv_cpu_copy(struct st_rx_video_session_impl* s, void* dst,
+                               const void* src, size_t len) {
+  if (!s->dma_dev) {
+    rte_memcpy(dst, src, len);
+    return;
+  }
+
+  s->dma_cpu_sample_cnt++;
+  if ((s->dma_cpu_sample_cnt % ST_RX_VIDEO_DMA_SAMPLE_INTERVAL) || !len) {
+    rte_memcpy(dst, src, len);
+    return;
+  }
+  uint64_t tsc_start = rte_get_tsc_cycles();
+  rte_memcpy(dst, src, len);
+  float ns = (float)(rte_get_tsc_cycles() - tsc_start) * NS_PER_S /
+             rv_get_impl(s)->tsc_hz;
+  s->dma_cpu_ns_per_kb = rv_dma_ewma(s->dma_cpu_ns_per_kb, ns * 1024 / len);
+  rv_dma_policy_update(s);
+}
+
+static void rv_dma_submit(struct st_rx_video_session_impl* s) {
+  uint16_t next = (s->dma_batch_tail + 1) % ST_VIDEO_RX_DMA_BATCH_NUM;
+
+  mt_dma_submit(s->dma_dev);
+  if (!s->dma_batch_nb) return;
+
+  if (next == s->dma_batch_head) {
+    /* no space, merge to the last batch */
+    uint16_t last = (s->dma_batch_tail + ST_VIDEO_RX_DMA_BATCH_NUM - 1) %
+                    ST_VIDEO_RX_DMA_BATCH_NUM;
+    s->dma_batch_cnt[last] += s->dma_batch_nb;
+  } else {
+    s->dma_batch_tsc[s->dma_batch_tail] = rte_get_tsc_cycles();
+    s->dma_batch_cnt[s->dma_batch_tail] = s->dma_batch_nb;
+    s->dma_batch_tail = next;
+  }
+  s->dma_batch_nb = 0;
+}
+
+/* the completion latency of the submitted batches */
+static void rv_dma_completed(struct st_rx_video_session_impl* s, uint16_t nb_dq) {
+  uint64_t tsc = rte_get_tsc_cycles();
+  uint64_t tsc_hz = rv_get_impl(s)->tsc_hz;
+  bool updated = false;
+
+  while (nb_dq && (s->dma_batch_head != s->dma_batch_tail)) {
+    uint16_t head = s->dma_batch_head;
+    uint16_t need = s->dma_batch_cnt[head] - s->dma_batch_done;
+    if (nb_dq < need) {
+      s->dma_batch_done += nb_dq;
+      break;
+    }
+    nb_dq -= need;
+    float ns = (float)(tsc - s->dma_batch_tsc[head]) * NS_PER_S / tsc_hz;
+    s->dma_latency_ns = rv_dma_ewma(s->dma_latency_ns, ns);
+    updated = true;
+    s->dma_batch_done = 0;
+    s->dma_batch_head = (head + 1) % ST_VIDEO_RX_DMA_BATCH_NUM;
+  }
+
+  if (updated) rv_dma_policy_update(s);
+}
+
 #ifdef ST_PCAPNG_ENABLED
 static int rv_start_pcapng(struct mtl_main_impl* impl, struct st_rx_video_session_impl* s,
                            uint32_t max_dump_packets, bool sync,
@@ -1437,6 +1622,7 @@ static int rv_dma_dequeue(struct mtl_main_impl* impl,
   if (nb_dq) {
     dbg("%s(%d), nb_dq %u\n", __func__, s->idx, nb_dq);
     mt_dma_drop_mbuf(dma_dev, nb_dq);
+    rv_dma_completed(s, nb_dq);
   }
 
   /* all dma action finished */
@@ -1461,12 +1647,286 @@ static inline uint32_t rfc4175_rtp_seq_id(struct st20_rfc4175_rtp_hdr* rtp) {
   return seq_id;
 }
 
+/* frame offset and length of the two lines of one pkt parsed from the srd */
+static int rv_fec_srd_parse(struct st_rx_video_session_impl* s, uint8_t* srd,
+                            uint32_t* offset, uint16_t* len) {
+  struct st20_rfc4175_extra_rtp_hdr* row = (struct st20_rfc4175_extra_rtp_hdr*)srd;
+  bool extra = ntohs(row[0].row_offset) & ST20_SRD_OFFSET_CONTINUATION;
+
+  offset[1] = 0;
+  len[1] = 0;
+  for (int i = 0; i < (extra ? 2 : 1); i++) {
+    uint16_t row_number = ntohs(row[i].row_number) & ~ST20_SECOND_FIELD;
+    uint16_t row_offset = ntohs(row[i].row_offset) & ~ST20_SRD_OFFSET_CONTINUATION;
+    len[i] = ntohs(row[i].row_length);
+    offset[i] = row_number * s->st20_linesize +
+                row_offset / s->st20_pg.coverage * s->st20_pg.size;
+    if (offset[i] + len[i] > s->st20_fb_size) return -EIO;
+  }
+
+  return 0;
+}
+
+/* rebuild the lost pkt if only one lost in the pkts protected, ret > 0 if recovered */
+static int rv_fec_recover(struct st_rx_video_session_impl* s,
+                          struct st_rx_video_slot_impl* slot, struct rte_mbuf* mbuf) {
+  struct st20_fec_rtp_hdr* rtp = rv_fec_rtp_hdr(mbuf);
+  uint16_t length = ntohs(rtp->length);
+  uint8_t* unit = s->fec_unit;
+  enum mtl_simd_level level = s->fec_simd_level;
+  uint32_t offset[2];
+  uint16_t len[2];
+  int lost = 0, lost_idx = -1, ret;
+
+  for (int j = 0; j < rtp->count; j++) {
+    int idx = rv_fec_member_idx(rtp, j);
+    if (!mt_bitmap_test(slot->frame_bitmap, idx)) {
+      lost++;
+      lost_idx = idx;
+    }
+  }
+  if (!lost) return 0;
+  if (lost > 1) return -EAGAIN;
+
+  /* xor the fec payload with the srd and payload of all pkts received */
+  rte_memcpy(unit, &rtp[1], length);
+  for (int j = 0; j < rtp->count; j++) {
+    int idx = rv_fec_member_idx(rtp, j);
+    if (idx == lost_idx) continue;
+    uint8_t* srd = rv_fec_srd(slot, idx);
+    ret = rv_fec_srd_parse(s, srd, offset, len);
+    if (ret < 0) return ret;
+    st20_fec_xor(unit, srd, ST20_FEC_SRD_LEN, level);
+    uint16_t pos = ST20_FEC_SRD_LEN;
+    for (int l = 0; l < 2 && pos < length; l++) {
+      uint16_t xor_len = RTE_MIN(len[l], length - pos);
+      st20_fec_xor(unit + pos, slot->frame + offset[l], xor_len, level);
+      pos += xor_len;
+    }
+  }
+
+  /* the unit is the lost pkt now, place it as rv_handle_frame_pkt */
+  ret = rv_fec_srd_parse(s, unit, offset, len);
+  if (ret < 0) return ret;
+  size_t payload_length = len[0] + len[1];
+  if (ST20_FEC_SRD_LEN + payload_length > length) return -EIO;
+  rte_memcpy(slot->frame + offset[0], unit + ST20_FEC_SRD_LEN, len[0]);
+  if (len[1])
+    rte_memcpy(slot->frame + offset[1], unit + ST20_FEC_SRD_LEN + len[0], len[1]);
+  rte_memcpy(rv_fec_srd(slot, lost_idx), unit, ST20_FEC_SRD_LEN);
+  mt_bitmap_test_and_set(slot->frame_bitmap, lost_idx);
+  dbg("%s(%d), pkt %d recovered, offset %u len %" PRIu64 "\n", __func__, s->idx,
+      lost_idx, offset[0], payload_length);
+
+  rv_slot_add_frame_size(s, slot, payload_length);
+  s->stat_pkts_fec_recovered++;
+  slot->pkts_received++;
+  if (slot->slice_info) rv_slice_add(s, slot, offset[0], payload_length);
+  if (rv_slot_get_frame_size(s, slot) >= s->st20_frame_size) {
+    /* end of frame */
+    rv_slot_full_frame(s, slot);
+  }
+
+  return 1;
+}
+
+/* move the pkts recorded against a guessed seq base to the lower base */
+static int rv_fec_rebase(struct st_rx_video_session_impl* s,
+                         struct st_rx_video_slot_impl* slot, uint32_t base) {
+  uint32_t delta = slot->seq_id_base_u32 - base;
+  uint32_t bits = s->st20_frame_bitmap_size * 8;
+  uint8_t* bitmap = slot->frame_bitmap;
+
+  if (!delta) return 0;
+  if (delta >= bits) { /* also for a base later than the guessed one */
+    dbg("%s(%d), invalid base %u, guessed %u\n", __func__, s->idx, base,
+        slot->seq_id_base_u32);
+    return -EIO;
+  }
+
+  for (uint32_t i = bits; i-- > 0;) {
+    bool set = (i >= delta) && mt_bitmap_test(bitmap, i - delta);
+    if (set)
+      bitmap[i / 8] |= (0x1 << (i % 8));
+    else
+      bitmap[i / 8] &= ~(0x1 << (i % 8));
+  }
+  memmove(rv_fec_srd(slot, delta), slot->fec_srd, (bits - delta) * ST20_FEC_SRD_LEN);
+  memset(slot->fec_srd, 0, delta * ST20_FEC_SRD_LEN);
+  dbg("%s(%d), base %u, guessed %u\n", __func__, s->idx, base, slot->seq_id_base_u32);
+  slot->seq_id_base_u32 = base;
+  return 0;
+}
+
+/* retry the fec pkts held as other lost pkts may be recovered */
+static void rv_fec_retry_pending(struct st_rx_video_session_impl* s,
+                                 struct st_rx_video_slot_impl* slot) {
+  struct rte_mbuf* pending[ST_VIDEO_RX_FEC_PENDING_NUM];
+  bool recovered = true;
+  uint16_t cnt;
+  int ret;
+
+  while (recovered && slot->fec_pending_cnt) {
+    recovered = false;
+    /* take all out, the slot releases its list once the frame is full */
+    cnt = slot->fec_pending_cnt;
+    rte_memcpy(pending, slot->fec_pending, sizeof(*pending) * cnt);
+    slot->fec_pending_cnt = 0;
+    for (uint16_t i = 0; i < cnt; i++) {
+      ret = slot->frame ? rv_fec_recover(s, slot, pending[i]) : 0;
+      if (ret > 0) recovered = true;
+      if ((ret == -EAGAIN) && slot->frame)
+        slot->fec_pending[slot->fec_pending_cnt++] = pending[i];
+      else
+        rte_pktmbuf_free(pending[i]);
+    }
+  }
+}
+
+static int rv_handle_fec_pkt(struct st_rx_video_session_impl* s, struct rte_mbuf* mbuf,
+                             enum mt_session_port s_port) {
+  struct st20_fec_rtp_hdr* rtp = rv_fec_rtp_hdr(mbuf);
+  uint32_t tmstamp = ntohl(rtp->base.tmstamp);
+  uint16_t length = ntohs(rtp->length);
+  struct st_rx_video_slot_impl* slot = NULL;
+  int ret;
+
+  s->stat_pkts_fec_received++;
+
+  /* check the fec hdr */
+  bool row = (rtp->type == ST20_FEC_TYPE_ROW);
+  if ((rtp->type > ST20_FEC_TYPE_COL) || !rtp->cols || !rtp->rows ||
+      (rtp->cols > ST20_FEC_MAX_DIM) || (rtp->rows > ST20_FEC_MAX_DIM) || !rtp->count ||
+      (rtp->count > (row ? rtp->cols : rtp->rows)) ||
+      (rtp->index >= (row ? rtp->rows : rtp->cols)) || (length < ST20_FEC_SRD_LEN) ||
+      (length > ST_PKT_MAX_ETHER_BYTES) ||
+      (sizeof(struct st20_fec_video_hdr) + length > mbuf->data_len) ||
+      ((size_t)rv_fec_member_idx(rtp, rtp->count - 1) >= s->st20_frame_bitmap_size * 8)) {
+    dbg("%s(%d,%d), invalid fec hdr, type %u idx %u count %u len %u\n", __func__, s->idx,
+        s_port, rtp->type, rtp->index, rtp->count, length);
+    s->stat_pkts_wrong_hdr_dropped++;
+    return -EINVAL;
+  }
+
+  /* only the slot of the frame, no new slot started by fec pkt */
+  for (int i = 0; i < s->slot_max; i++) {
+    if (s->slots[i].tmstamp == tmstamp) {
+      slot = &s->slots[i];
+      break;
+    }
+  }
+  /* frame done already or no media pkt got */
+  if (!slot || !slot->frame || !slot->seq_id_got) return 0;
+  if (slot->seq_id_guess) {
+    /* the first pkt lost, the media seq of base_idx gives the seq base of the frame */
+    ret = rv_fec_rebase(s, slot, ntohl(rtp->base_seq) - ntohl(rtp->base_idx));
+    if (ret < 0) {
+      s->stat_pkts_wrong_hdr_dropped++;
+      return ret;
+    }
+    slot->seq_id_guess = false;
+  }
+
+  ret = rv_fec_recover(s, slot, mbuf);
+  if (ret == -EAGAIN) {
+    /* more than one lost, wait other lost pkts recovered by other fec pkts */
+    if (slot->fec_pending_cnt >= ST_VIDEO_RX_FEC_PENDING_NUM) return -EIO;
+    slot->fec_pending[slot->fec_pending_cnt++] = mbuf;
+    return RV_PKT_NOT_FREE;
+  }
+  if (ret > 0) rv_fec_retry_pending(s, slot);
+
+  return 0;
+}
+
+/* move the pkts recorded against a guessed stripe base to the lower base */
+static int rv_stripe_rebase(struct st_rx_video_session_impl* s,
+                            struct st_rx_video_slot_impl* slot, uint32_t base) {
+  uint32_t delta = (slot->seq_id_base_u32 - base) * 2; /* two pkts for each link seq */
+  uint32_t bits = s->st20_frame_bitmap_size * 8;
+  uint8_t* bitmap = slot->frame_bitmap;
+
+  if (!delta) return 0;
+  if (delta >= bits) {
+    dbg("%s(%d), invalid base %u, guessed %u\n", __func__, s->idx, base,
+        slot->seq_id_base_u32);
+    return -EIO;
+  }
+
+  for (uint32_t i = bits; i-- > 0;) {
+    bool set = (i >= delta) && mt_bitmap_test(bitmap, i - delta);
+    if (set)
+      bitmap[i / 8] |= (0x1 << (i % 8));
+    else
+      bitmap[i / 8] &= ~(0x1 << (i % 8));
+  }
+  dbg("%s(%d), base %u, guessed %u\n", __func__, s->idx, base, slot->seq_id_base_u32);
+  slot->seq_id_base_u32 = base;
+  return 0;
+}
+
+/*
+ * The striped sender has one rtp seq on each link, the P link carries the even pkts of
+ * the frame and the R link the odd ones. The R link restarts each frame at the seq of
+ * the P frame head, so pkt 2k on P and pkt 2k + 1 on R both have the seq base + k.
+ * Before the P head the base is guessed from the lowest seq got, an R loss or an R pkt
+ * ahead of the head doesn't shift the idx.
+ */
+static int rv_stripe_pkt_idx(struct st_rx_video_session_impl* s,
+                             struct st_rx_video_slot_impl* slot,
+                             enum mt_session_port s_port, uint32_t seq_id_u32,
+                             bool frame_head, bool ctrl_thread) {
+  bool r_link = (s_port == MT_SESSION_PORT_R);
+  uint32_t link_idx;
+  int pkt_idx;
+
+  if (!slot->seq_id_got) {
+    /* the base should always be set by the control thread */
+    if (!ctrl_thread) {
+      dbg("%s(%d,%d), drop seq_id %u as base seq id not got\n", __func__, s->idx,
+          s_port, seq_id_u32);
+      s->stat_pkts_idx_dropped++;
+      return -EIO;
+    }
+    slot->seq_id_base_u32 = seq_id_u32;
+    slot->seq_id_got = true;
+    slot->seq_id_guess = !frame_head;
+    dbg("%s(%d,%d), seq_id_base %u guess %d\n", __func__, s->idx, s_port, seq_id_u32,
+        slot->seq_id_guess);
+  } else if (slot->seq_id_guess) {
+    /* an earlier pkt of the frame, move the guessed base back to it */
+    if (((int32_t)(seq_id_u32 - slot->seq_id_base_u32) < 0) &&
+        (rv_stripe_rebase(s, slot, seq_id_u32) < 0)) {
+      s->stat_pkts_idx_oo_bitmap++;
+      return -EIO;
+    }
+    if (frame_head) slot->seq_id_guess = false;
+  }
+
+  link_idx = seq_id_u32 - slot->seq_id_base_u32; /* wrap safe */
+  if (link_idx >= (s->st20_frame_bitmap_size * 8 / 2)) {
+    dbg("%s(%d,%d), drop as invalid link idx %u base %u\n", __func__, s->idx, s_port,
+        link_idx, slot->seq_id_base_u32);
+    s->stat_pkts_idx_oo_bitmap++;
+    return -EIO;
+  }
+  pkt_idx = link_idx * 2 + (r_link ? 1 : 0);
+  if (mt_bitmap_test_and_set(slot->frame_bitmap, pkt_idx)) {
+    dbg("%s(%d,%d), drop as pkt %d already received\n", __func__, s->idx, s_port,
+        pkt_idx);
+    s->stat_pkts_redunant_dropped++;
+    slot->pkts_redunant_received++;
+    return -EIO;
+  }
+
+  return pkt_idx;
+}
+
 static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mbuf* mbuf,
                                enum mt_session_port s_port, bool ctrl_thread) {
   struct st20_rx_ops* ops = &s->ops;
   // size_t hdr_offset = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
-  size_t hdr_offset =
-      sizeof(struct st_rfc4175_video_hdr) - sizeof(struct st20_rfc4175_rtp_hdr);
+  size_t hdr_offset = s->rtp_offset;
   struct st20_rfc4175_rtp_hdr* rtp =
       rte_pktmbuf_mtod_offset(mbuf, struct st20_rfc4175_rtp_hdr*, hdr_offset);
   void* payload = &rtp[1];
@@ -1486,6 +1946,8 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
   struct rte_mbuf* mbuf_next = mbuf->next;
 
   if (payload_type != ops->payload_type) {
+    if (ops->fec_payload_type && (payload_type == ops->fec_payload_type))
+      return rv_handle_fec_pkt(s, mbuf, s_port);
     s->stat_pkts_wrong_hdr_dropped++;
     return -EINVAL;
   }
@@ -1507,7 +1969,20 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
   line1_number &= ~ST20_SECOND_FIELD;
 
   /* check if the same pkt got already */
-  if (slot->seq_id_got) {
+  if (ops->flags & ST20_RX_FLAG_PORT_STRIPE) {
+    pkt_idx = rv_stripe_pkt_idx(s, slot, s_port, seq_id_u32,
+                                !line1_number && !line1_offset, ctrl_thread);
+    if (pkt_idx < 0) return pkt_idx;
+  } else if (slot->seq_id_got) {
+    if (slot->seq_id_guess) {
+      /* an earlier pkt of the frame, move the guessed base back to it */
+      if (((int32_t)(seq_id_u32 - slot->seq_id_base_u32) < 0) &&
+          (rv_fec_rebase(s, slot, seq_id_u32) < 0)) {
+        s->stat_pkts_idx_oo_bitmap++;
+        return -EIO;
+      }
+      if (!line1_number && !line1_offset) slot->seq_id_guess = false;
+    }
     if (seq_id_u32 >= slot->seq_id_base_u32)
       pkt_idx = seq_id_u32 - slot->seq_id_base_u32;
     else
@@ -1535,6 +2010,15 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
       pkt_idx = 0;
       dbg("%s(%d,%d), seq_id_base %d tmstamp %u\n", __func__, s->idx, s_port, seq_id_u32,
           tmstamp);
+    } else if (slot->fec_srd && ctrl_thread) {
+      /* the first pkt may be lost, guess the base until a fec pkt tells the real one */
+      slot->seq_id_base_u32 = seq_id_u32;
+      slot->seq_id_got = true;
+      slot->seq_id_guess = true;
+      mt_bitmap_test_and_set(bitmap, 0);
+      pkt_idx = 0;
+      dbg("%s(%d,%d), guess seq_id_base %d tmstamp %u\n", __func__, s->idx, s_port,
+          seq_id_u32, tmstamp);
     } else {
       dbg("%s(%d,%d), drop seq_id %d as base seq id not got, %u %u\n", __func__, s->idx,
           s_port, seq_id_u32, line1_number, line1_offset);
@@ -1559,6 +2043,28 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
     return -EIO;
   }
 
+  if (slot->fec_srd) {
+    /* the two srd of the pkt in network order for the fec recovery */
+    uint8_t* srd = rv_fec_srd(slot, pkt_idx);
+    size_t srd_len = sizeof(struct st20_rfc4175_extra_rtp_hdr);
+    rte_memcpy(srd, (uint8_t*)rtp + offsetof(struct st20_rfc4175_rtp_hdr, row_length),
+               srd_len);
+    if (extra_rtp)
+      rte_memcpy(srd + srd_len, extra_rtp, srd_len);
+    else
+      memset(srd + srd_len, 0, srd_len);
+  }
+
+  if ((ops->flags & ST20_RX_FLAG_ENABLE_CRC) && ctrl_thread) {
+    /* chain the crc if the pkt follows the previous one in the frame */
+    uint32_t pkt_pos = line1_number * s->st20_bytes_in_line +
+                       line1_offset / s->st20_pg.coverage * s->st20_pg.size;
+    if (pkt_pos == slot->crc_size) {
+      slot->crc = mt_crc32c_update(slot->crc, payload, payload_length);
+      slot->crc_size += payload_length;
+    }
+  }
+
   bool need_copy = true;
   bool dma_copy = false;
   struct mtl_dma_lender_dev* dma_dev = s->dma_dev;
@@ -1598,15 +2104,15 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
       rte_memcpy(slot->frame + offset, payload, line1_length);
       rte_memcpy(slot->frame + (line1_number + 1) * s->st20_linesize,
                  payload + line1_length, payload_length - line1_length);
-    } else if (dma_dev && (payload_length > ST_RX_VIDEO_DMA_MIN_SIZE) &&
-               !mt_dma_full(dma_dev)) {
-      rte_iova_t payload_iova =
-          rte_pktmbuf_iova_offset(mbuf, sizeof(struct st_rfc4175_video_hdr));
+    } else if (dma_dev && rv_dma_copy_select(s, slot, payload_length)) {
+      rte_iova_t payload_iova = rte_pktmbuf_iova_offset(mbuf, hdr_offset + sizeof(*rtp));
       if (extra_rtp) payload_iova += sizeof(*extra_rtp);
+      bool sample = !(s->dma_enq_sample_cnt++ % ST_RX_VIDEO_DMA_SAMPLE_INTERVAL);
+      uint64_t tsc_start = sample ? rte_get_tsc_cycles() : 0;
       ret = mt_dma_copy(dma_dev, slot->frame_iova + offset, payload_iova, payload_length);
       if (ret < 0) {
         /* use cpu copy if dma copy fail */
-        rte_memcpy(slot->frame + offset, payload, payload_length);
+        rv_cpu_copy(s, slot->frame + offset, payload, payload_length);
       } else {
         /* abstrct dma dev takes ownership of this mbuf */
         st_rx_mbuf_set_offset(mbuf, offset);
@@ -1618,10 +2124,15 @@ static int rv_handle_frame_pkt(struct st_rx_video_session_impl* s, struct rte_mb
           rte_pktmbuf_free(mbuf);
         }
         dma_copy = true;
+        s->dma_batch_nb++;
         s->stat_pkts_dma++;
+        if (sample) {
+          float ns = (float)(rte_get_tsc_cycles() - tsc_start) * NS_PER_S / impl->tsc_hz;
+          s->dma_enq_ns = rv_dma_ewma(s->dma_enq_ns, ns);
+        }
       }
     } else {
-      rte_memcpy(slot->frame + offset, payload, payload_length);
+      rv_cpu_copy(s, slot->frame + offset, payload, payload_length);
     }
   }
 
@@ -2273,9 +2784,11 @@ static int rv_init_sw(struct mtl_main_impl* impl, struct st_rx_video_sessions_mg
     info("%s(%d), uframe size %" PRIu64 "\n", __func__, idx, s->st20_uframe_size);
   }
 
-  /* try to request dma dev */
-  if (st20_is_frame_type(type) && (ops->flags & ST20_RX_FLAG_DMA_OFFLOAD) &&
-      !s->st20_uframe_size && !rv_is_hdr_split(s)) {
+  /* try to request dma dev, hw dma first then the cpu dma engine */
+  bool dma_offload = (ops->flags & ST20_RX_FLAG_DMA_OFFLOAD) ? true : false;
+  /* the fec recovery reads back the frame, no async dma copy */
+  if (st20_is_frame_type(type) && dma_offload && !s->st20_uframe_size &&
+      !rv_is_hdr_split(s) && !ops->fec_payload_type) {
     rv_init_dma(impl, s);
   }
 
@@ -2300,6 +2813,8 @@ static int rv_init_sw(struct mtl_main_impl* impl, struct st_rx_video_sessions_mg
 
   /* only one core for hdr split mode */
   if (rv_is_hdr_split(s)) pkt_handle_lcore = false;
+  /* the fec recovery needs all pkts of the frame on one core */
+  if (ops->fec_payload_type) pkt_handle_lcore = false;
 
   if (pkt_handle_lcore) {
     if (type == ST20_TYPE_SLICE_LEVEL) {
@@ -2547,7 +3062,7 @@ static int rv_tasklet(struct mtl_main_impl* impl, struct st_rx_video_session_imp
   }
 
   /* submit if any */
-  if (dma_copy && s->dma_dev) mt_dma_submit(s->dma_dev);
+  if (dma_copy && s->dma_dev) rv_dma_submit(s);
 
   return done ? MT_TASKLET_ALL_DONE : MT_TASKLET_HAS_PENDING;
 }
@@ -2577,6 +3092,19 @@ static int rv_init_hw(struct mtl_main_impl* impl, struct st_rx_video_session_imp
     memset(&flow, 0, sizeof(flow));
     rte_memcpy(flow.dip_addr, ops->sip_addr[i], MTL_IP_ADDR_LEN);
     rte_memcpy(flow.sip_addr, mt_sip_addr(impl, port), MTL_IP_ADDR_LEN);
+    rte_memcpy(flow.ssm_addr, ops->mcast_sip_addr[i], MTL_IP_ADDR_LEN);
+    if (s->ipv6) {
+      const uint8_t* dst6 = mt_ndp_sip6(impl, port, ops->sip6_addr[i]);
+      /* no NDP on the kernel and memif pmd, and no flow for memif */
+      if (!dst6 || mt_pmd_is_memif(impl, port)) {
+        err("%s(%d), no ipv6 on port %d\n", __func__, idx, i);
+        rv_uinit_hw(impl, s);
+        return -ENOTSUP;
+      }
+      flow.ipv6 = true;
+      rte_memcpy(flow.src6_addr, ops->sip6_addr[i], MTL_IP6_ADDR_LEN);
+      rte_memcpy(flow.dst6_addr, dst6, MTL_IP6_ADDR_LEN);
+    }
     flow.port_flow = true;
     flow.dst_port = s->st20_dst_port[i];
     if (rv_is_hdr_split(s)) {
@@ -2605,6 +3133,8 @@ static int rv_init_hw(struct mtl_main_impl* impl, struct st_rx_video_session_imp
     s->port_id[i] = mt_port_id(impl, port);
     info("%s(%d), port(l:%d,p:%d), queue %d udp %d\n", __func__, idx, i, port,
          mt_dev_rx_queue_id(s->queue[i]), flow.dst_port);
+    /* wake the sch by the rx interrupt when the stream is quiet */
+    mt_sch_add_rx_intr(s->parnet->tasklet->sch, s->queue[i]);
   }
 
   return 0;
@@ -2617,6 +3147,7 @@ static int rv_uinit_mcast(struct mtl_main_impl* impl,
   for (int i = 0; i < ops->num_port; i++) {
     if (mt_is_multicast_ip(ops->sip_addr[i]))
       mt_mcast_leave(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                     mt_ip_to_u32(ops->mcast_sip_addr[i]),
                      mt_port_logic2phy(s->port_maps, i));
   }
 
@@ -2635,7 +3166,8 @@ static int rv_init_mcast(struct mtl_main_impl* impl, struct st_rx_video_session_
       info("%s(%d), skip mcast join for port %d\n", __func__, s->idx, i);
       return 0;
     }
-    ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]), port);
+    ret = mt_mcast_join(impl, mt_ip_to_u32(ops->sip_addr[i]),
+                        mt_ip_to_u32(ops->mcast_sip_addr[i]), port);
     if (ret < 0) return ret;
   }
 
@@ -2720,6 +3252,13 @@ static int rv_attach(struct mtl_main_impl* impl, struct st_rx_video_sessions_mgr
     s->st20_src_port[i] = (ops->udp_port[i]) ? (ops->udp_port[i]) : (10000 + idx);
     s->st20_dst_port[i] = s->st20_src_port[i];
   }
+  s->ipv6 = (ops->flags & ST20_RX_FLAG_IPV6) ? true : false;
+  if (s->ipv6)
+    s->rtp_offset =
+        sizeof(struct st_rfc4175_video_hdr6) - sizeof(struct st20_rfc4175_rtp_hdr);
+  else
+    s->rtp_offset =
+        sizeof(struct st_rfc4175_video_hdr) - sizeof(struct st20_rfc4175_rtp_hdr);
 
   s->stat_pkts_idx_dropped = 0;
   s->stat_pkts_idx_oo_bitmap = 0;
@@ -2729,6 +3268,10 @@ static int rv_attach(struct mtl_main_impl* impl, struct st_rx_video_sessions_mgr
   s->stat_pkts_wrong_hdr_dropped = 0;
   s->stat_pkts_received = 0;
   s->stat_pkts_dma = 0;
+  s->stat_pkts_cpu_small = 0;
+  s->stat_pkts_cpu_depth = 0;
+  s->stat_pkts_cpu_tail = 0;
+  s->stat_pkts_dma_probe = 0;
   s->stat_pkts_rtp_ring_full = 0;
   s->stat_frames_dropped = 0;
   rte_atomic32_set(&s->stat_frames_received, 0);
@@ -2907,6 +3450,24 @@ static void rv_stat(struct st_rx_video_sessions_mgr* mgr,
   s->stat_slices_received = 0;
   s->stat_last_time = cur_time_ns;
 
+  int sch_socket = mgr ? mt_sch_socket_id(mgr->sch) : SOCKET_ID_ANY;
+  s->stat_numa_remote_est_mbs = 0;
+  if (frames_received && (sch_socket != SOCKET_ID_ANY)) {
+    int socket =
+        mt_socket_id(mgr->parnet, mt_port_logic2phy(s->port_maps, MT_SESSION_PORT_P));
+    /*
+     * the mbufs and frames live on the port socket, the lcore copies cross socket.
+     * An estimate by the frame bytes, no uncore counters read.
+     */
+    if (!mt_socket_match(sch_socket, socket)) {
+      s->stat_numa_remote_est_mbs =
+          (double)frames_received * s->st20_frame_size / time_sec / (1000 * 1000);
+      notice(
+          "RX_VIDEO_SESSION(%d,%d): numa remote est %f MB/s, lcore socket %d port %d\n",
+          m_idx, idx, s->stat_numa_remote_est_mbs, sch_socket, socket);
+    }
+  }
+
   if (s->stat_frames_dropped || s->stat_pkts_idx_dropped || s->stat_pkts_offset_dropped) {
     notice(
         "RX_VIDEO_SESSION(%d,%d): incomplete frames %d, pkts (idx error: %d, offset "
@@ -2937,6 +3498,19 @@ static void rv_stat(struct st_rx_video_sessions_mgr* mgr,
            s->stat_pkts_wrong_hdr_dropped);
     s->stat_pkts_wrong_hdr_dropped = 0;
   }
+  if (s->stat_pkts_fec_received) {
+    notice("RX_VIDEO_SESSION(%d,%d): fec pkts %d, recovered %d unrecoverable %d\n",
+           m_idx, idx, s->stat_pkts_fec_received, s->stat_pkts_fec_recovered,
+           s->stat_pkts_fec_unrecoverable);
+    s->stat_pkts_fec_received = 0;
+    s->stat_pkts_fec_recovered = 0;
+    s->stat_pkts_fec_unrecoverable = 0;
+  }
+  if (s->stat_frames_crc_fallback) {
+    notice("RX_VIDEO_SESSION(%d,%d): crc fallback to full frame %d\n", m_idx, idx,
+           s->stat_frames_crc_fallback);
+    s->stat_frames_crc_fallback = 0;
+  }
   if (s->stat_pkts_enqueue_fallback) {
     notice("RX_VIDEO_SESSION(%d,%d): lcore enqueue fallback pkts %d\n", m_idx, idx,
            s->stat_pkts_enqueue_fallback);
@@ -2945,7 +3519,18 @@ static void rv_stat(struct st_rx_video_sessions_mgr* mgr,
   if (s->dma_dev) {
     notice("RX_VIDEO_SESSION(%d,%d): pkts %d by dma copy, dma busy %f\n", m_idx, idx,
            s->stat_pkts_dma, s->dma_busy_score);
+    notice("RX_VIDEO_SESSION(%d,%d): cpu copy pkts small %d depth %d tail %d, probe %d\n",
+           m_idx, idx, s->stat_pkts_cpu_small, s->stat_pkts_cpu_depth,
+           s->stat_pkts_cpu_tail, s->stat_pkts_dma_probe);
+    notice("RX_VIDEO_SESSION(%d,%d): dma min size %u depth %u, latency %fus, cpu %fns/kb "
+           "enq %fns\n",
+           m_idx, idx, s->dma_min_size, s->dma_target_depth, s->dma_latency_ns / 1000,
+           s->dma_cpu_ns_per_kb, s->dma_enq_ns);
     s->stat_pkts_dma = 0;
+    s->stat_pkts_cpu_small = 0;
+    s->stat_pkts_cpu_depth = 0;
+    s->stat_pkts_cpu_tail = 0;
+    s->stat_pkts_dma_probe = 0;
   }
   if (s->stat_pkts_slice_fail) {
     notice("RX_VIDEO_SESSION(%d,%d): pkts %d drop as slice add fail\n", m_idx, idx,
@@ -3036,6 +3621,12 @@ static int rv_update_src(struct mtl_main_impl* impl, struct st_rx_video_session_
   int idx = s->idx, num_port = s->ops.num_port;
   struct st20_rx_ops* ops = &s->ops;
 
+  if (s->ipv6) {
+    /* st_rx_source_info has the ipv4 address only */
+    err("%s(%d), not support for ipv6 session\n", __func__, idx);
+    return -ENOTSUP;
+  }
+
   rv_uinit_mcast(impl, s);
   rv_uinit_hw(impl, s);
 
@@ -3089,6 +3680,7 @@ static int rvs_mgr_init(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
   struct mt_sch_tasklet_ops ops;
 
   mgr->parnet = impl;
+  mgr->sch = sch;
   mgr->idx = idx;
 
   for (int i = 0; i < ST_SCH_MAX_RX_VIDEO_SESSIONS; i++) {
@@ -3101,6 +3693,7 @@ static int rvs_mgr_init(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
   ops.start = rvs_tasklet_start;
   ops.stop = rvs_tasklet_stop;
   ops.handler = rvs_tasklet_handler;
+  ops.intr_rx = mt_has_rx_intr(impl);
 
   mgr->tasklet = mt_sch_register_tasklet(sch, &ops);
   if (!mgr->tasklet) {
@@ -3154,7 +3747,7 @@ static struct st_rx_video_session_impl* rv_mgr_attach(
   for (int i = 0; i < ST_SCH_MAX_RX_VIDEO_SESSIONS; i++) {
     if (!rx_video_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), mt_port_socket_id(impl, ops->port[MTL_PORT_P]));
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       rx_video_session_put(mgr, i);
@@ -3226,17 +3819,21 @@ void st_rx_video_sessions_stat(struct mtl_main_impl* impl) {
   struct mt_sch_impl* sch;
   struct st_rx_video_sessions_mgr* mgr;
   struct st_rx_video_session_impl* s;
+  float remote_mbs;
 
   for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
     sch = mt_sch_instance(impl, sch_idx);
     if (!mt_sch_is_active(sch)) continue;
     mgr = &sch->rx_video_mgr;
+    remote_mbs = 0;
     for (int j = 0; j < mgr->max_idx; j++) {
       s = rx_video_session_get(mgr, j);
       if (!s) continue;
       rv_stat(mgr, s);
+      remote_mbs += s->stat_numa_remote_est_mbs;
       rx_video_session_put(mgr, j);
     }
+    mgr->stat_numa_remote_est_mbs = remote_mbs;
   }
 }
 
@@ -3270,6 +3867,44 @@ int st_rx_video_session_migrate(struct mtl_main_impl* impl,
                                 struct st_rx_video_session_impl* s, int idx) {
   rv_init(impl, mgr, s, idx);
   if (s->dma_dev) rv_migrate_dma(impl, s);
+  for (int i = 0; i < s->ops.num_port; i++) {
+    if (!s->queue[i]) continue;
+    mt_sch_del_rx_intr(s->queue[i]);
+    mt_sch_add_rx_intr(mgr->tasklet->sch, s->queue[i]);
+  }
+  return 0;
+}
+
+static int rv_ops_check6(struct st20_rx_ops* ops) {
+  int num_ports = ops->num_port;
+
+  for (int i = 0; i < num_ports; i++) {
+    if (mt_ip6_is_zero(ops->sip6_addr[i])) {
+      err("%s(%d), no sip6_addr\n", __func__, i);
+      return -EINVAL;
+    }
+    if (mt_ip6_is_multicast(ops->sip6_addr[i])) {
+      err("%s(%d), ipv6 multicast not support, no MLDv2 yet\n", __func__, i);
+      return -ENOTSUP;
+    }
+  }
+  if ((num_ports > 1) && mt_ip6_equal(ops->sip6_addr[0], ops->sip6_addr[1])) {
+    err("%s, same sip6_addr for both ports\n", __func__);
+    return -EINVAL;
+  }
+  if (!st20_is_frame_type(ops->type)) {
+    err("%s, ipv6 only for frame type, type %d\n", __func__, ops->type);
+    return -EINVAL;
+  }
+  if (ops->flags & (ST20_RX_FLAG_AUTO_DETECT | ST20_RX_FLAG_HDR_SPLIT)) {
+    err("%s, no auto detect or hdr split for ipv6, flags 0x%x\n", __func__, ops->flags);
+    return -EINVAL;
+  }
+  if (ops->fec_payload_type) {
+    err("%s, fec not support ipv6\n", __func__);
+    return -EINVAL;
+  }
+
   return 0;
 }
 
@@ -3283,19 +3918,25 @@ static int rv_ops_check(struct st20_rx_ops* ops) {
     return -EINVAL;
   }
 
-  for (int i = 0; i < num_ports; i++) {
-    ip = ops->sip_addr[i];
-    ret = mt_ip_addr_check(ip);
-    if (ret < 0) {
-      err("%s(%d), invalid ip %d.%d.%d.%d\n", __func__, i, ip[0], ip[1], ip[2], ip[3]);
-      return -EINVAL;
+  if (ops->flags & ST20_RX_FLAG_IPV6) {
+    /* the ipv4 sip_addr is not used */
+    ret = rv_ops_check6(ops);
+    if (ret < 0) return ret;
+  } else {
+    for (int i = 0; i < num_ports; i++) {
+      ip = ops->sip_addr[i];
+      ret = mt_ip_addr_check(ip);
+      if (ret < 0) {
+        err("%s(%d), invalid ip %d.%d.%d.%d\n", __func__, i, ip[0], ip[1], ip[2], ip[3]);
+        return -EINVAL;
+      }
     }
-  }
 
-  if (num_ports > 1) {
-    if (0 == memcmp(ops->sip_addr[0], ops->sip_addr[1], MTL_IP_ADDR_LEN)) {
-      err("%s, same %d.%d.%d.%d for both ip\n", __func__, ip[0], ip[1], ip[2], ip[3]);
-      return -EINVAL;
+    if (num_ports > 1) {
+      if (0 == memcmp(ops->sip_addr[0], ops->sip_addr[1], MTL_IP_ADDR_LEN)) {
+        err("%s, same %d.%d.%d.%d for both ip\n", __func__, ip[0], ip[1], ip[2], ip[3]);
+        return -EINVAL;
+      }
     }
   }
 
@@ -3367,6 +4008,41 @@ static int rv_ops_check(struct st20_rx_ops* ops) {
     return -EINVAL;
   }
 
+  if (ops->flags & ST20_RX_FLAG_ENABLE_CRC) {
+    if (!st20_is_frame_type(type) || ops->uframe_size) {
+      err("%s, crc only for frame type without uframe, type %d\n", __func__, type);
+      return -EINVAL;
+    }
+  }
+
+  if (ops->flags & ST20_RX_FLAG_PORT_STRIPE) {
+    if (!st20_is_frame_type(type) || (num_ports != 2)) {
+      err("%s, stripe only over the P/R pair of frame type, type %d ports %d\n",
+          __func__, type, num_ports);
+      return -EINVAL;
+    }
+  }
+
+  if (ops->fec_payload_type) {
+    if (!st20_is_frame_type(type) || ops->uframe_size) {
+      err("%s, fec only for frame type without uframe, type %d\n", __func__, type);
+      return -EINVAL;
+    }
+    if (num_ports > 1) {
+      err("%s, fec not support redundant ports\n", __func__);
+      return -EINVAL;
+    }
+    if (ops->flags & ST20_RX_FLAG_HDR_SPLIT) {
+      err("%s, fec not support hdr split\n", __func__);
+      return -EINVAL;
+    }
+    if (!st_is_valid_payload_type(ops->fec_payload_type) ||
+        (ops->fec_payload_type == ops->payload_type)) {
+      err("%s, invalid fec_payload_type %d\n", __func__, ops->fec_payload_type);
+      return -EINVAL;
+    }
+  }
+
   return 0;
 }
 
@@ -3470,7 +4146,9 @@ st20_rx_handle st20_rx_create_with_mask(struct mtl_main_impl* impl,
     }
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  /* sch lcore and session memory local to the port */
+  int socket = mt_port_socket_id(impl, ops->port[MTL_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -3478,7 +4156,7 @@ st20_rx_handle st20_rx_create_with_mask(struct mtl_main_impl* impl,
 
   enum mt_sch_type type =
       mt_has_rxv_separate_sch(impl) ? MT_SCH_TYPE_RX_VIDEO_ONLY : MT_SCH_TYPE_DEFAULT;
-  sch = mt_sch_get(impl, quota_mbs, type, sch_mask);
+  sch = mt_sch_get(impl, quota_mbs, type, sch_mask, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -3707,6 +4385,33 @@ void st20_rx_put_mbuf(st20_rx_handle handle, void* mbuf) {
   if (pkt) rte_pktmbuf_free(pkt);
 }
 
+uint16_t st20_rx_get_mbufs(st20_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_video_session_handle_impl* s_impl = handle;
+  struct st_rx_video_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_RX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->rtps_ring) {
+    err("%s(%d), rtp ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_rx_get_mbufs(s->rtps_ring, bufs, nb);
+}
+
+void st20_rx_put_mbufs(st20_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_rx_video_session_handle_impl* s_impl = handle;
+
+  if (s_impl->type != MT_HANDLE_RX_VIDEO)
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+
+  mt_rtp_free_mbufs(bufs, nb);
+}
+
 bool st20_rx_dma_enabled(st20_rx_handle handle) {
   struct st_rx_video_session_handle_impl* s_impl = handle;
   struct st_rx_video_session_impl* s;
@@ -3791,7 +4496,9 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
     quota_mbs *= ops->num_port;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  /* sch lcore and session memory local to the port */
+  int socket = mt_port_socket_id(impl, ops->port[MTL_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
@@ -3799,7 +4506,7 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
 
   enum mt_sch_type type =
       mt_has_rxv_separate_sch(impl) ? MT_SCH_TYPE_RX_VIDEO_ONLY : MT_SCH_TYPE_DEFAULT;
-  sch = mt_sch_get(impl, quota_mbs, type, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, type, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -3822,10 +4529,14 @@ st22_rx_handle st22_rx_create(mtl_handle mt, struct st22_rx_ops* ops) {
   st20_ops.priv = ops->priv;
   st20_ops.num_port = ops->num_port;
   memcpy(st20_ops.sip_addr[MTL_PORT_P], ops->sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  memcpy(st20_ops.mcast_sip_addr[MTL_PORT_P], ops->mcast_sip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
   strncpy(st20_ops.port[MTL_PORT_P], ops->port[MTL_PORT_P], MTL_PORT_MAX_LEN);
   st20_ops.udp_port[MTL_PORT_P] = ops->udp_port[MTL_PORT_P];
   if (ops->num_port > 1) {
     memcpy(st20_ops.sip_addr[MTL_PORT_R], ops->sip_addr[MTL_PORT_R], MTL_IP_ADDR_LEN);
+    memcpy(st20_ops.mcast_sip_addr[MTL_PORT_R], ops->mcast_sip_addr[MTL_PORT_R],
+           MTL_IP_ADDR_LEN);
     strncpy(st20_ops.port[MTL_PORT_R], ops->port[MTL_PORT_R], MTL_PORT_MAX_LEN);
     st20_ops.udp_port[MTL_PORT_R] = ops->udp_port[MTL_PORT_R];
   }
@@ -4005,6 +4716,33 @@ void st22_rx_put_mbuf(st22_rx_handle handle, void* mbuf) {
   if (pkt) rte_pktmbuf_free(pkt);
 }
 
+uint16_t st22_rx_get_mbufs(st22_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st22_rx_video_session_handle_impl* s_impl = handle;
+  struct st_rx_video_session_impl* s;
+
+  if (s_impl->type != MT_ST22_HANDLE_RX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->rtps_ring) {
+    err("%s(%d), rtp ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_rx_get_mbufs(s->rtps_ring, bufs, nb);
+}
+
+void st22_rx_put_mbufs(st22_rx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st22_rx_video_session_handle_impl* s_impl = handle;
+
+  if (s_impl->type != MT_ST22_HANDLE_RX_VIDEO)
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+
+  mt_rtp_free_mbufs(bufs, nb);
+}
+
 int st22_rx_put_framebuff(st22_rx_handle handle, void* frame) {
   struct st22_rx_video_session_handle_impl* s_impl = handle;
   struct st_rx_video_session_impl* s;
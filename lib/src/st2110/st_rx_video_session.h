@@ -9,7 +9,17 @@
 
 #define ST_RX_VIDEO_BURTS_SIZE (128)
 
+/* the initial payload size threshold for dma copy, adjusted online */
 #define ST_RX_VIDEO_DMA_MIN_SIZE (1024)
+/* the range of the adaptive dma copy threshold */
+#define ST_RX_VIDEO_DMA_MIN_SIZE_LOW (256)
+#define ST_RX_VIDEO_DMA_MIN_SIZE_HIGH (4096)
+/* the min of the adaptive dma inflight depth */
+#define ST_RX_VIDEO_DMA_DEPTH_MIN (16)
+/* force one dma copy every n frames to re-probe the cost when the cpu takes all */
+#define ST_RX_VIDEO_DMA_PROBE_INTERVAL (64)
+/* sample the copy cost every n copies */
+#define ST_RX_VIDEO_DMA_SAMPLE_INTERVAL (64)
 
 #define ST_RV_EBU_TSC_SYNC_MS (100) /* sync tsc with ptp period(ms) */
 #define ST_RV_EBU_TSC_SYNC_NS (ST_RV_EBU_TSC_SYNC_MS * 1000 * 1000)
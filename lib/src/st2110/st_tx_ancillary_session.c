@@ -4,6 +4,7 @@
 
 #include "st_tx_ancillary_session.h"
 
+#include "../mt_arp.h"
 #include "../mt_log.h"
 #include "st_ancillary_transmitter.h"
 #include "st_err.h"
@@ -108,6 +109,63 @@ static int tx_ancillary_session_alloc_frames(struct mtl_main_impl* impl,
   return 0;
 }
 
+static void tx_ancillary_session_arp_done(void* priv, enum mtl_port port, uint32_t ip,
+                                          struct rte_ether_addr* ea, int result) {
+  struct st_tx_ancillary_session_impl* s = priv;
+  int idx = s->idx;
+
+  for (int i = 0; i < s->ops.num_port; i++) {
+    if (mt_port_logic2phy(s->port_maps, i) != port) continue;
+    if (mt_ip_to_u32(s->ops.dip_addr[i]) != ip) continue;
+    if (result < 0) {
+      err("%s(%d), get mac fail %d for port %d\n", __func__, idx, result, i);
+      rte_atomic32_set(&s->mac_fail[i], result);
+    } else {
+      rte_ether_addr_copy(ea, mt_eth_d_addr(&s->hdr[i].eth));
+      info("%s(%d), mac: %02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx for port %d\n",
+           __func__, idx, ea->addr_bytes[0], ea->addr_bytes[1], ea->addr_bytes[2],
+           ea->addr_bytes[3], ea->addr_bytes[4], ea->addr_bytes[5], i);
+    }
+    rte_atomic32_dec(&s->mac_pending);
+  }
+}
+
+/* the arp fail, resolve again in the tasklet */
+static bool tx_ancillary_session_arp_retry(struct mtl_main_impl* impl,
+                                           struct st_tx_ancillary_session_impl* s) {
+  int idx = s->idx;
+  bool retry = false;
+  enum mtl_port port;
+  struct rte_ether_addr* d_addr;
+  int ret;
+
+  for (int i = 0; i < s->ops.num_port; i++) {
+    int result = rte_atomic32_read(&s->mac_fail[i]);
+    if (!result) continue;
+    rte_atomic32_set(&s->mac_fail[i], 0);
+    retry = true;
+    info("%s(%d), resolve the mac again for port %d\n", __func__, idx, i);
+    rte_atomic32_inc(&s->mac_pending);
+    port = mt_port_logic2phy(s->port_maps, i);
+    d_addr = mt_eth_d_addr(&s->hdr[i].eth);
+    ret = mt_dev_dst_ip_mac_async(impl, s->ops.dip_addr[i], d_addr, port,
+                                  MT_ARP_ASYNC_TIMEOUT_MS, tx_ancillary_session_arp_done,
+                                  s);
+    if (ret != -EINPROGRESS) {
+      rte_atomic32_dec(&s->mac_pending);
+      if (ret < 0) rte_atomic32_set(&s->mac_fail[i], ret);
+    }
+  }
+
+  return retry;
+}
+
+static void tx_ancillary_session_uinit_arp(struct mtl_main_impl* impl,
+                                           struct st_tx_ancillary_session_impl* s) {
+  for (int i = 0; i < s->ops.num_port; i++)
+    mt_dev_dst_ip_mac_cancel(impl, mt_port_logic2phy(s->port_maps, i), s);
+}
+
 static int tx_ancillary_session_init_hdr(struct mtl_main_impl* impl,
                                          struct st_tx_ancillary_sessions_mgr* mgr,
                                          struct st_tx_ancillary_session_impl* s,
@@ -124,6 +182,7 @@ static int tx_ancillary_session_init_hdr(struct mtl_main_impl* impl,
   uint8_t* dip = ops->dip_addr[s_port];
   uint8_t* sip = mt_sip_addr(impl, port);
   struct rte_ether_addr* d_addr = mt_eth_d_addr(eth);
+  bool mac_pending = false;
 
   /* ether hdr */
   if ((s_port == MT_SESSION_PORT_P) && (ops->flags & ST40_TX_FLAG_USER_P_MAC)) {
@@ -133,11 +192,19 @@ static int tx_ancillary_session_init_hdr(struct mtl_main_impl* impl,
     rte_memcpy(d_addr, &ops->tx_dst_mac[s_port][0], RTE_ETHER_ADDR_LEN);
     info("%s, USER_R_TX_MAC\n", __func__);
   } else {
-    ret = mt_dev_dst_ip_mac(impl, dip, d_addr, port, 0);
-    if (ret < 0) {
-      err("%s(%d), get mac fail %d for %d.%d.%d.%d\n", __func__, idx, ret, dip[0], dip[1],
-          dip[2], dip[3]);
-      return ret;
+    /* the tasklet skip this session until tx_ancillary_session_arp_done fill the mac */
+    rte_atomic32_inc(&s->mac_pending);
+    ret = mt_dev_dst_ip_mac_async(impl, dip, d_addr, port, MT_ARP_ASYNC_TIMEOUT_MS,
+                                  tx_ancillary_session_arp_done, s);
+    if (ret == -EINPROGRESS) {
+      mac_pending = true;
+    } else {
+      rte_atomic32_dec(&s->mac_pending);
+      if (ret < 0) {
+        err("%s(%d), get mac fail %d for %d.%d.%d.%d\n", __func__, idx, ret, dip[0],
+            dip[1], dip[2], dip[3]);
+        return ret;
+      }
     }
   }
 
@@ -179,6 +246,10 @@ static int tx_ancillary_session_init_hdr(struct mtl_main_impl* impl,
 
   info("%s(%d), succ, dst ip:port %d.%d.%d.%d:%d, s_port %d\n", __func__, idx, dip[0],
        dip[1], dip[2], dip[3], s->st40_dst_port[s_port], s_port);
+  if (mac_pending) {
+    info("%s(%d), mac pending on arp\n", __func__, idx);
+    return 0;
+  }
   info("%s(%d), mac: %02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx\n", __func__, idx,
        d_addr->addr_bytes[0], d_addr->addr_bytes[1], d_addr->addr_bytes[2],
        d_addr->addr_bytes[3], d_addr->addr_bytes[4], d_addr->addr_bytes[5]);
@@ -777,6 +848,12 @@ static int tx_ancillary_sessions_tasklet_handler(void* priv) {
     s = tx_ancillary_session_try_get(mgr, sidx);
     if (!s) continue;
 
+    /* dst mac not resolved yet */
+    if (rte_atomic32_read(&s->mac_pending) || tx_ancillary_session_arp_retry(impl, s)) {
+      tx_ancillary_session_put(mgr, sidx);
+      continue;
+    }
+
     s->stat_build_ret_code = 0;
     if (s->ops.type == ST40_TYPE_FRAME_LEVEL)
       pending += tx_ancillary_session_tasklet_frame(impl, mgr, s);
@@ -1100,10 +1177,13 @@ static int tx_ancillary_session_attach(struct mtl_main_impl* impl,
     return ret;
   }
 
+  rte_atomic32_set(&s->mac_pending, 0);
+  for (int i = 0; i < MT_SESSION_PORT_MAX; i++) rte_atomic32_set(&s->mac_fail[i], 0);
   for (int i = 0; i < num_port; i++) {
     ret = tx_ancillary_session_init_hdr(impl, mgr, s, i);
     if (ret < 0) {
       err("%s(%d), port(%d) init hdr fail %d\n", __func__, idx, i, ret);
+      tx_ancillary_session_uinit_arp(impl, s);
       return ret;
     }
   }
@@ -1111,6 +1191,7 @@ static int tx_ancillary_session_attach(struct mtl_main_impl* impl,
   ret = tx_ancillary_session_init_sw(impl, mgr, s);
   if (ret < 0) {
     err("%s(%d), init sw fail %d\n", __func__, idx, ret);
+    tx_ancillary_session_uinit_arp(impl, s);
     return ret;
   }
 
@@ -1146,6 +1227,7 @@ static void tx_ancillary_session_stat(struct st_tx_ancillary_session_impl* s) {
 int tx_ancillary_session_detach(struct st_tx_ancillary_sessions_mgr* mgr,
                                 struct st_tx_ancillary_session_impl* s) {
   tx_ancillary_session_stat(s);
+  tx_ancillary_session_uinit_arp(mgr->parnet, s);
   tx_ancillary_session_uinit_sw(mgr, s);
   return 0;
 }
@@ -1507,6 +1589,44 @@ int st40_tx_put_mbuf(st40_tx_handle handle, void* mbuf, uint16_t len) {
   return 0;
 }
 
+uint16_t st40_tx_get_mbufs(st40_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_tx_ancillary_session_handle_impl* s_impl = handle;
+  struct st_tx_ancillary_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_TX_ANC) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_tx_get_mbufs(s->mbuf_mempool_chain, s->packet_ring, bufs, nb);
+}
+
+uint16_t st40_tx_put_mbufs(st40_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_tx_ancillary_session_handle_impl* s_impl = handle;
+  struct st_tx_ancillary_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_TX_ANC) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  return mt_rtp_tx_put_mbufs(s->packet_ring, bufs, nb, 0);
+}
+
 int st40_tx_free(st40_tx_handle handle) {
   struct st_tx_ancillary_session_handle_impl* s_impl = handle;
   struct st_tx_ancillary_session_impl* s;
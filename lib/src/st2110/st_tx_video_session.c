@@ -6,8 +6,13 @@
 
 #include <math.h>
 
+#include "../mt_arp.h"
+#include "../mt_ip6.h"
 #include "../mt_log.h"
+#include "../mt_ndp.h"
 #include "st_err.h"
+#include "st_fec.h"
+#include "st_video_replay.h"
 #include "st_video_transmitter.h"
 
 static inline double pacing_tr_offset_time(struct st_tx_video_pacing* pacing,
@@ -301,7 +306,9 @@ static int tv_init_pacing(struct mtl_main_impl* impl,
       pacing->tr_offset = frame_time * (22.0 / 1125.0) * 2;
     }
   }
-  pacing->trs = frame_time * ractive / s->st20_total_pkts;
+  int frame_pkts = s->st20_total_pkts;
+  if (s->fec) frame_pkts += s->fec->total_pkts; /* fec pkts share the frame time */
+  pacing->trs = frame_time * ractive / frame_pkts;
   /* always use MTL_PORT_P for ptp now */
   pacing->cur_epochs = mt_get_ptp_time(impl, MTL_PORT_P) / frame_time;
   pacing->tsc_time_cursor = mt_get_tsc(impl);
@@ -337,6 +344,22 @@ static int tv_init_pacing(struct mtl_main_impl* impl,
     port = mt_port_logic2phy(s->port_maps, i);
     /* use system pacing way now */
     s->pacing_way[i] = st_tx_pacing_way(impl, port);
+    if (s->fec && (s->pacing_way[i] == ST21_TX_PACING_WAY_RL)) {
+      /* the rl pad is trained with the media pkts only */
+      info("%s(%d), fec enabled, use tsc pacing\n", __func__, idx);
+      s->pacing_way[i] = ST21_TX_PACING_WAY_TSC;
+    }
+    if ((s->ops.flags & ST20_TX_FLAG_PORT_STRIPE) &&
+        (s->pacing_way[i] == ST21_TX_PACING_WAY_RL)) {
+      /* rl is trained for the full stream, a striped link sends every other slot */
+      info("%s(%d), port stripe, use tsc pacing\n", __func__, idx);
+      s->pacing_way[i] = ST21_TX_PACING_WAY_TSC;
+    }
+    if (s->replay && (s->pacing_way[i] == ST21_TX_PACING_WAY_RL)) {
+      /* rl is a constant rate, the recorded gaps need a per pkt target time */
+      info("%s(%d), pcap replay, use tsc pacing\n", __func__, idx);
+      s->pacing_way[i] = ST21_TX_PACING_WAY_TSC;
+    }
     if (s->pacing_way[i] == ST21_TX_PACING_WAY_RL) {
       ret = tv_train_pacing(impl, s, i);
       if (ret < 0) {
@@ -499,6 +522,130 @@ static int tv_init_st22_boxes(struct mtl_main_impl* impl,
   return 0;
 }
 
+static void tv_arp_done(void* priv, enum mtl_port port, uint32_t ip,
+                        struct rte_ether_addr* ea, int result) {
+  struct st_tx_video_session_impl* s = priv;
+  int idx = s->idx;
+
+  for (int i = 0; i < s->ops.num_port; i++) {
+    if (mt_port_logic2phy(s->port_maps, i) != port) continue;
+    if (mt_ip_to_u32(s->ops.dip_addr[i]) != ip) continue;
+    if (result < 0) {
+      err("%s(%d), get mac fail %d for port %d\n", __func__, idx, result, i);
+      rte_atomic32_set(&s->mac_fail[i], result);
+    } else {
+      rte_ether_addr_copy(ea, mt_eth_d_addr(&s->s_hdr[i].eth));
+      info("%s(%d), mac: %02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx for port %d\n",
+           __func__, idx, ea->addr_bytes[0], ea->addr_bytes[1], ea->addr_bytes[2],
+           ea->addr_bytes[3], ea->addr_bytes[4], ea->addr_bytes[5], i);
+    }
+    rte_atomic32_dec(&s->mac_pending);
+  }
+}
+
+static void tv_ndp_done(void* priv, enum mtl_port port, const uint8_t* ip,
+                        struct rte_ether_addr* ea, int result) {
+  struct st_tx_video_session_impl* s = priv;
+  int idx = s->idx;
+
+  for (int i = 0; i < s->ops.num_port; i++) {
+    if (mt_port_logic2phy(s->port_maps, i) != port) continue;
+    if (memcmp(s->ops.dip6_addr[i], ip, MTL_IP6_ADDR_LEN)) continue;
+    if (result < 0) {
+      err("%s(%d), get mac fail %d for port %d\n", __func__, idx, result, i);
+      rte_atomic32_set(&s->mac_fail[i], result);
+    } else {
+      rte_ether_addr_copy(ea, mt_eth_d_addr(&s->s_hdr6[i].eth));
+      info("%s(%d), mac: %02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx for port %d\n",
+           __func__, idx, ea->addr_bytes[0], ea->addr_bytes[1], ea->addr_bytes[2],
+           ea->addr_bytes[3], ea->addr_bytes[4], ea->addr_bytes[5], i);
+    }
+    rte_atomic32_dec(&s->mac_pending);
+  }
+}
+
+/* resolve the dst mac by arp, or by NDP for ipv6 */
+static int tv_dst_mac_async(struct mtl_main_impl* impl,
+                            struct st_tx_video_session_impl* s,
+                            enum mt_session_port s_port, struct rte_ether_addr* d_addr) {
+  enum mtl_port port = mt_port_logic2phy(s->port_maps, s_port);
+
+  if (s->ipv6)
+    return mt_dev_dst_ip6_mac_async(impl, s->ops.dip6_addr[s_port], d_addr, port,
+                                    MT_NDP_ASYNC_TIMEOUT_MS, tv_ndp_done, s);
+  return mt_dev_dst_ip_mac_async(impl, s->ops.dip_addr[s_port], d_addr, port,
+                                 MT_ARP_ASYNC_TIMEOUT_MS, tv_arp_done, s);
+}
+
+/* the arp fail, resolve again in the tasklet */
+static bool tv_arp_retry(struct mtl_main_impl* impl, struct st_tx_video_session_impl* s) {
+  int idx = s->idx;
+  bool retry = false;
+  struct rte_ether_addr* d_addr;
+  int ret;
+
+  for (int i = 0; i < s->ops.num_port; i++) {
+    int result = rte_atomic32_read(&s->mac_fail[i]);
+    if (!result) continue;
+    rte_atomic32_set(&s->mac_fail[i], 0);
+    retry = true;
+    if (s->ops.notify_event) s->ops.notify_event(s->ops.priv, ST_EVENT_ARP_FAIL, &result);
+    info("%s(%d), resolve the mac again for port %d\n", __func__, idx, i);
+    rte_atomic32_inc(&s->mac_pending);
+    d_addr = mt_eth_d_addr(s->ipv6 ? &s->s_hdr6[i].eth : &s->s_hdr[i].eth);
+    ret = tv_dst_mac_async(impl, s, i, d_addr);
+    if (ret != -EINPROGRESS) {
+      rte_atomic32_dec(&s->mac_pending);
+      if (ret < 0) rte_atomic32_set(&s->mac_fail[i], ret);
+    }
+  }
+
+  return retry;
+}
+
+static void tv_uinit_arp(struct mtl_main_impl* impl, struct st_tx_video_session_impl* s) {
+  for (int i = 0; i < s->ops.num_port; i++)
+    mt_dev_dst_ip_mac_cancel(impl, mt_port_logic2phy(s->port_maps, i), s);
+}
+
+/* the ipv6 template from the eth, udp and rtp of the ipv4 one */
+static int tv_init_hdr6(struct mtl_main_impl* impl, struct st_tx_video_session_impl* s,
+                        enum mt_session_port s_port) {
+  int idx = s->idx;
+  enum mtl_port port = mt_port_logic2phy(s->port_maps, s_port);
+  struct st_rfc4175_video_hdr* hdr = &s->s_hdr[s_port];
+  struct st_rfc4175_video_hdr6* hdr6 = &s->s_hdr6[s_port];
+  struct rte_ipv6_hdr* ipv6 = &hdr6->ipv6;
+  uint8_t* dip = s->ops.dip6_addr[s_port];
+  const uint8_t* sip = mt_ndp_sip6(impl, port, dip);
+
+  if (!sip) {
+    err("%s(%d), no ipv6 address on port %d\n", __func__, idx, s_port);
+    return -EINVAL;
+  }
+
+  /* the d_addr is filled by the mac resolve already */
+  rte_ether_addr_copy(mt_eth_s_addr(&hdr->eth), mt_eth_s_addr(&hdr6->eth));
+  hdr6->eth.ether_type = htons(RTE_ETHER_TYPE_IPV6);
+
+  memset(ipv6, 0x0, sizeof(*ipv6));
+  ipv6->vtc_flow = htonl(6 << 28);
+  ipv6->proto = IPPROTO_UDP;
+  ipv6->hop_limits = 64;
+  mtl_memcpy(ipv6->src_addr, sip, MTL_IP6_ADDR_LEN);
+  mtl_memcpy(ipv6->dst_addr, dip, MTL_IP6_ADDR_LEN);
+
+  rte_memcpy(&hdr6->udp, &hdr->udp, sizeof(hdr6->udp));
+  rte_memcpy(&hdr6->rtp, &hdr->rtp, sizeof(hdr6->rtp));
+  /* the addresses are fixed, only the length is added for each pkt */
+  s->st20_udp6_phdr_sum[s_port] = mt_udp6_phdr_sum(ipv6);
+
+  info("%s(%d), dst ip6 %02x%02x:%02x%02x::%02x%02x:%02x%02x, udp %d, port %d\n",
+       __func__, idx, dip[0], dip[1], dip[2], dip[3], dip[12], dip[13], dip[14], dip[15],
+       s->st20_dst_port[s_port], s_port);
+  return 0;
+}
+
 static int tv_init_hdr(struct mtl_main_impl* impl, struct st_tx_video_session_impl* s,
                        enum mt_session_port s_port) {
   int idx = s->idx;
@@ -512,7 +659,10 @@ static int tv_init_hdr(struct mtl_main_impl* impl, struct st_tx_video_session_im
   struct st20_tx_ops* ops = &s->ops;
   uint8_t* dip = ops->dip_addr[s_port];
   uint8_t* sip = mt_sip_addr(impl, port);
-  struct rte_ether_addr* d_addr = mt_eth_d_addr(eth);
+  /* the ipv6 pkts carry the eth hdr of s_hdr6 */
+  struct rte_ether_addr* d_addr =
+      mt_eth_d_addr(s->ipv6 ? &s->s_hdr6[s_port].eth : eth);
+  bool mac_pending = false;
 
   /* ether hdr */
   if ((s_port == MT_SESSION_PORT_P) && (ops->flags & ST20_TX_FLAG_USER_P_MAC)) {
@@ -522,11 +672,17 @@ static int tv_init_hdr(struct mtl_main_impl* impl, struct st_tx_video_session_im
     rte_memcpy(d_addr, &ops->tx_dst_mac[s_port][0], RTE_ETHER_ADDR_LEN);
     info("%s, USER_R_TX_MAC\n", __func__);
   } else {
-    ret = mt_dev_dst_ip_mac(impl, dip, d_addr, port, 0);
-    if (ret < 0) {
-      err("%s(%d), get mac fail %d for %d.%d.%d.%d\n", __func__, idx, ret, dip[0], dip[1],
-          dip[2], dip[3]);
-      return ret;
+    /* the tasklet skip this session until tv_arp_done fill the mac */
+    rte_atomic32_inc(&s->mac_pending);
+    ret = tv_dst_mac_async(impl, s, s_port, d_addr);
+    if (ret == -EINPROGRESS) {
+      mac_pending = true;
+    } else {
+      rte_atomic32_dec(&s->mac_pending);
+      if (ret < 0) {
+        err("%s(%d), get mac fail %d for port %d\n", __func__, idx, ret, s_port);
+        return ret;
+      }
     }
   }
 
@@ -578,18 +734,152 @@ static int tv_init_hdr(struct mtl_main_impl* impl, struct st_tx_video_session_im
     st22_hdr->f_counter_lo = 0;
   }
 
-  info("%s(%d), dst ip:port %d.%d.%d.%d:%d, port %d\n", __func__, idx, dip[0], dip[1],
-       dip[2], dip[3], s->st20_dst_port[s_port], s_port);
+  if (s->ipv6) {
+    ret = tv_init_hdr6(impl, s, s_port);
+    if (ret < 0) return ret;
+  } else {
+    info("%s(%d), dst ip:port %d.%d.%d.%d:%d, port %d\n", __func__, idx, dip[0], dip[1],
+         dip[2], dip[3], s->st20_dst_port[s_port], s_port);
+  }
+  if (mac_pending) {
+    info("%s(%d), mac pending on arp\n", __func__, idx);
+    return 0;
+  }
   info("%s(%d), mac: %02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx\n", __func__, idx,
        d_addr->addr_bytes[0], d_addr->addr_bytes[1], d_addr->addr_bytes[2],
        d_addr->addr_bytes[3], d_addr->addr_bytes[4], d_addr->addr_bytes[5]);
   return 0;
 }
 
+static void tv_fec_unit_add(struct st_tx_video_fec* fec, uint32_t unit_idx,
+                            uint8_t* srd, uint8_t* payload, uint16_t len) {
+  uint8_t* unit = fec->units + (size_t)unit_idx * fec->unit_size;
+  uint16_t unit_len = fec->units_len[unit_idx];
+  uint16_t xor_len = ST20_FEC_SRD_LEN + len;
+
+  if (!unit_len) { /* first pkt of the unit */
+    rte_memcpy(unit, srd, ST20_FEC_SRD_LEN);
+    rte_memcpy(unit + ST20_FEC_SRD_LEN, payload, len);
+    fec->units_len[unit_idx] = xor_len;
+    return;
+  }
+
+  st20_fec_xor(unit, srd, ST20_FEC_SRD_LEN, fec->simd_level);
+  uint16_t common_len = RTE_MIN(xor_len, unit_len) - ST20_FEC_SRD_LEN;
+  st20_fec_xor(unit + ST20_FEC_SRD_LEN, payload, common_len, fec->simd_level);
+  if (xor_len > unit_len) {
+    /* longer than the previous pkts, the tail is xor with zero */
+    rte_memcpy(unit + unit_len, payload + common_len, xor_len - unit_len);
+    fec->units_len[unit_idx] = xor_len;
+  }
+}
+
+static void tv_fec_add_pkt(struct st_tx_video_session_impl* s,
+                           struct st20_rfc4175_rtp_hdr* rtp,
+                           struct st20_rfc4175_extra_rtp_hdr* e_rtp, void* payload,
+                           uint16_t len) {
+  struct st_tx_video_fec* fec = s->fec;
+  uint32_t pkt_idx = s->st20_pkt_idx;
+  uint32_t matrix_units = fec->row_units + fec->col_units;
+  uint32_t base = pkt_idx / fec->matrix_pkts * matrix_units;
+  uint32_t k = pkt_idx % fec->matrix_pkts;
+  uint8_t srd[ST20_FEC_SRD_LEN];
+  size_t srd_len = sizeof(struct st20_rfc4175_extra_rtp_hdr);
+
+  if (!pkt_idx) { /* start of a new frame */
+    memset(fec->units_len, 0, sizeof(*fec->units_len) * fec->nb_units);
+    fec->unit_cursor = 0;
+    fec->frame_seq = (uint32_t)ntohs(rtp->base.seq_number) |
+                     ((uint32_t)ntohs(rtp->seq_number_ext) << 16);
+  }
+
+  /* the srd of the pkt in network order, zero for the second if not cross lines */
+  rte_memcpy(srd, (uint8_t*)rtp + offsetof(struct st20_rfc4175_rtp_hdr, row_length),
+             srd_len);
+  if (e_rtp)
+    rte_memcpy(srd + srd_len, e_rtp, srd_len);
+  else
+    memset(srd + srd_len, 0, srd_len);
+
+  if (fec->row_units) tv_fec_unit_add(fec, base + k / fec->cols, srd, payload, len);
+  if (fec->col_units)
+    tv_fec_unit_add(fec, base + fec->row_units + k % fec->cols, srd, payload, len);
+}
+
+static int tv_fec_build_pkt(struct st_tx_video_session_impl* s, struct rte_mbuf* pkt) {
+  struct st_tx_video_fec* fec = s->fec;
+  uint32_t matrix_units = fec->row_units + fec->col_units;
+  struct st20_fec_video_hdr* hdr = rte_pktmbuf_mtod(pkt, struct st20_fec_video_hdr*);
+  struct rte_ipv4_hdr* ipv4 = &hdr->ipv4;
+  struct rte_udp_hdr* udp = &hdr->udp;
+  struct st20_fec_rtp_hdr* rtp = &hdr->rtp;
+  struct st_rfc4175_video_hdr* s_hdr = &s->s_hdr[MT_SESSION_PORT_P];
+
+  /* skip the units not used in the last matrix */
+  while ((fec->unit_cursor < fec->nb_units) && !fec->units_len[fec->unit_cursor])
+    fec->unit_cursor++;
+  if (fec->unit_cursor >= fec->nb_units) return -EIO;
+
+  uint32_t unit_idx = fec->unit_cursor++;
+  uint32_t unit_in_matrix = unit_idx % matrix_units;
+  uint16_t len = fec->units_len[unit_idx];
+
+  /* copy the hdr: eth, ip, udp, rtp base */
+  rte_memcpy(&hdr->eth, &s_hdr->eth, sizeof(hdr->eth));
+  rte_memcpy(ipv4, &s_hdr->ipv4, sizeof(*ipv4));
+  rte_memcpy(udp, &s_hdr->udp, sizeof(*udp));
+  rte_memcpy(&rtp->base, &s_hdr->rtp.base, sizeof(rtp->base));
+
+  /* update ipv4 hdr */
+  ipv4->packet_id = htons(s->st20_ipv4_packet_id);
+  s->st20_ipv4_packet_id++;
+
+  /* update rtp */
+  rtp->base.payload_type = s->ops.fec_payload_type;
+  rtp->base.marker = 0;
+  rtp->base.seq_number = htons(fec->seq_id);
+  fec->seq_id++;
+  rtp->base.tmstamp = htonl(s->pacing.rtp_time_stamp);
+  uint32_t base_idx = unit_idx / matrix_units * fec->matrix_pkts;
+  rtp->base_idx = htonl(base_idx);
+  rtp->base_seq = htonl(fec->frame_seq + base_idx);
+  rtp->length = htons(len);
+  if (unit_in_matrix < fec->row_units) {
+    rtp->type = ST20_FEC_TYPE_ROW;
+    rtp->index = unit_in_matrix;
+  } else {
+    rtp->type = ST20_FEC_TYPE_COL;
+    rtp->index = unit_in_matrix - fec->row_units;
+  }
+  rtp->cols = fec->cols;
+  rtp->rows = fec->rows;
+  rtp->count = fec->units_count[unit_idx];
+  rtp->reserved = 0;
+  rte_memcpy(&hdr[1], fec->units + (size_t)unit_idx * fec->unit_size, len);
+
+  /* update mbuf */
+  mt_mbuf_init_ipv4(pkt);
+  pkt->data_len = sizeof(*hdr) + len;
+  pkt->pkt_len = pkt->data_len;
+
+  udp->dgram_len = htons(pkt->pkt_len - pkt->l2_len - pkt->l3_len);
+  ipv4->total_length = htons(pkt->pkt_len - pkt->l2_len);
+  if (!s->eth_ipv4_cksum_offload[MT_SESSION_PORT_P]) {
+    /* generate cksum if no offload */
+    ipv4->hdr_checksum = rte_ipv4_cksum(ipv4);
+  }
+
+  s->stat_pkts_fec++;
+  return 0;
+}
+
 static int tv_build_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_impl* s,
-                        struct rte_mbuf* pkt, struct rte_mbuf* pkt_chain) {
+                        struct rte_mbuf* pkt, struct rte_mbuf* pkt_chain,
+                        enum mt_session_port s_port) {
   struct st_rfc4175_video_hdr* hdr;
-  struct rte_ipv4_hdr* ipv4;
+  struct st_rfc4175_video_hdr6* hdr6;
+  struct rte_ipv4_hdr* ipv4 = NULL;
+  struct rte_ipv6_hdr* ipv6 = NULL;
   struct rte_udp_hdr* udp;
   struct st20_rfc4175_rtp_hdr* rtp;
   struct st20_rfc4175_extra_rtp_hdr* e_rtp = NULL;
@@ -597,20 +887,33 @@ static int tv_build_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_i
   uint32_t offset;
   uint16_t line1_number, line1_offset;
   uint16_t line1_length, line2_length;
+  uint16_t hdr_len, l4_len;
   bool single_line = (ops->packing == ST20_PACKING_GPM_SL);
   struct st_frame_trans* frame_info = &s->st20_frames[s->st20_frame_idx];
 
-  hdr = rte_pktmbuf_mtod(pkt, struct st_rfc4175_video_hdr*);
-  ipv4 = &hdr->ipv4;
-  rtp = &hdr->rtp;
-  udp = &hdr->udp;
+  if (s->ipv6) {
+    hdr6 = rte_pktmbuf_mtod(pkt, struct st_rfc4175_video_hdr6*);
+    ipv6 = &hdr6->ipv6;
+    rtp = &hdr6->rtp;
+    udp = &hdr6->udp;
+    hdr_len = sizeof(*hdr6);
 
-  /* copy the hdr: eth, ip, udp, rtp */
-  rte_memcpy(hdr, &s->s_hdr[MT_SESSION_PORT_P], sizeof(*hdr));
+    /* copy the hdr: eth, ip, udp, rtp */
+    rte_memcpy(hdr6, &s->s_hdr6[s_port], sizeof(*hdr6));
+  } else {
+    hdr = rte_pktmbuf_mtod(pkt, struct st_rfc4175_video_hdr*);
+    ipv4 = &hdr->ipv4;
+    rtp = &hdr->rtp;
+    udp = &hdr->udp;
+    hdr_len = sizeof(*hdr);
 
-  /* update ipv4 hdr */
-  ipv4->packet_id = htons(s->st20_ipv4_packet_id);
-  s->st20_ipv4_packet_id++;
+    /* copy the hdr: eth, ip, udp, rtp */
+    rte_memcpy(hdr, &s->s_hdr[s_port], sizeof(*hdr));
+
+    /* update ipv4 hdr */
+    ipv4->packet_id = htons(s->st20_ipv4_packet_id);
+    s->st20_ipv4_packet_id++;
+  }
 
   if (single_line) {
     line1_number = s->st20_pkt_idx / s->st20_pkts_in_line;
@@ -625,15 +928,19 @@ static int tv_build_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_i
         (offset % s->st20_bytes_in_line) * s->st20_pg.coverage / s->st20_pg.size;
     if ((offset + s->st20_pkt_len > (line1_number + 1) * s->st20_bytes_in_line) &&
         (offset + s->st20_pkt_len < s->st20_frame_size))
-      e_rtp =
-          rte_pktmbuf_mtod_offset(pkt, struct st20_rfc4175_extra_rtp_hdr*, sizeof(*hdr));
+      e_rtp = rte_pktmbuf_mtod_offset(pkt, struct st20_rfc4175_extra_rtp_hdr*, hdr_len);
   }
 
-  /* update rtp */
+  /*
+   * update rtp, the r link of the port stripe is a rtp stream with its own seq which
+   * restarts each frame at the seq of the p frame head, the rx places it by the seq.
+   */
+  if (!s->st20_pkt_idx) s->st20_seq_id_r = s->st20_seq_id;
+  uint32_t* seq_id = (s_port == MT_SESSION_PORT_R) ? &s->st20_seq_id_r : &s->st20_seq_id;
   if (s->st20_pkt_idx >= (s->st20_total_pkts - 1)) rtp->base.marker = 1;
-  rtp->base.seq_number = htons((uint16_t)s->st20_seq_id);
-  rtp->seq_number_ext = htons((uint16_t)(s->st20_seq_id >> 16));
-  s->st20_seq_id++;
+  rtp->base.seq_number = htons((uint16_t)*seq_id);
+  rtp->seq_number_ext = htons((uint16_t)(*seq_id >> 16));
+  (*seq_id)++;
   uint16_t field = frame_info->tv_meta.second_field ? ST20_SECOND_FIELD : 0x0000;
   rtp->row_number = htons(line1_number | field);
   rtp->row_offset = htons(line1_offset);
@@ -656,39 +963,76 @@ static int tv_build_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_i
   }
 
   /* update mbuf */
-  mt_mbuf_init_ipv4(pkt);
-  pkt->data_len = sizeof(struct st_rfc4175_video_hdr);
+  if (ipv6)
+    mt_mbuf_init_ipv6(pkt);
+  else
+    mt_mbuf_init_ipv4(pkt);
+  pkt->data_len = hdr_len;
   if (e_rtp) pkt->data_len += sizeof(*e_rtp);
   pkt->pkt_len = pkt->data_len;
+  l4_len = pkt->data_len - pkt->l2_len - pkt->l3_len; /* udp and rtp hdrs */
 
   if (!single_line && s->st20_linesize > s->st20_bytes_in_line)
     /* update offset with line padding for copying */
     offset = offset % s->st20_bytes_in_line + line1_number * s->st20_linesize;
 
+  void* payload;
   if (e_rtp && s->st20_linesize > s->st20_bytes_in_line) {
     /* cross lines with padding case */
     /* do not attach extbuf, copy to data room */
-    void* payload = rte_pktmbuf_mtod(pkt_chain, void*);
+    payload = rte_pktmbuf_mtod(pkt_chain, void*);
     mtl_memcpy(payload, frame_info->addr + offset, line1_length);
     mtl_memcpy(payload + line1_length,
                frame_info->addr + s->st20_linesize * (line1_number + 1), line2_length);
   } else {
     /* attach payload to chainbuf */
+    payload = frame_info->addr + offset;
     rte_pktmbuf_attach_extbuf(pkt_chain, frame_info->addr + offset,
                               frame_info->iova + offset, left_len, &frame_info->sh_info);
     rte_mbuf_ext_refcnt_update(&frame_info->sh_info, 1);
   }
   pkt_chain->data_len = pkt_chain->pkt_len = left_len;
+  if (ipv6 && s->st20_udp6_sw_sum)
+    s->st20_udp6_payload_sum = __rte_raw_cksum(payload, left_len, 0);
+  if (s->fec) {
+    tv_fec_add_pkt(s, rtp, e_rtp, payload, left_len);
+    /* test only, lose the first pkt of the first rows for the rx recovery */
+    uint32_t row = s->st20_pkt_idx / s->fec->cols;
+    if ((row < s->fec->test_drop) && !(s->st20_pkt_idx % s->fec->cols))
+      udp->dst_port = htons(ntohs(udp->dst_port) + 1);
+  }
+  if (ops->flags & ST20_TX_FLAG_ENABLE_CRC) {
+    /*
+     * pkts are built in order, chain the payload. It's hot for the padding copy and
+     * the fec xor above, an extra read of the frame for the zero copy extbuf.
+     */
+    if (!s->st20_pkt_idx) s->st20_frame_crc = MT_CRC32C_INIT;
+    s->st20_frame_crc = mt_crc32c_update(s->st20_frame_crc, payload, left_len);
+    if (s->st20_pkt_idx >= (s->st20_total_pkts - 1))
+      frame_info->tv_meta.crc = mt_crc32c_final(s->st20_frame_crc);
+  }
 
   /* chain the pkt */
   rte_pktmbuf_chain(pkt, pkt_chain);
-  if (!s->eth_has_chain[MT_SESSION_PORT_P]) {
+  if (!s->eth_has_chain[s_port]) {
     mt_mbuf_chain_sw(pkt, pkt_chain);
   }
 
   udp->dgram_len = htons(pkt->pkt_len - pkt->l2_len - pkt->l3_len);
+  if (ipv6) {
+    ipv6->payload_len = udp->dgram_len;
+    uint32_t phdr_sum = s->st20_udp6_phdr_sum[s_port];
+    if (s->eth_udp_cksum_offload[s_port]) {
+      mt_mbuf_init_udp_cksum(pkt);
+      udp->dgram_cksum = mt_udp6_phdr_cksum(phdr_sum, udp->dgram_len);
+    } else {
+      udp->dgram_cksum = mt_udp6_cksum(phdr_sum, udp->dgram_len, udp, l4_len,
+                                       s->st20_udp6_payload_sum);
+    }
+    return 0;
+  }
   ipv4->total_length = htons(pkt->pkt_len - pkt->l2_len);
-  if (!s->eth_ipv4_cksum_offload[MT_SESSION_PORT_P]) {
+  if (!s->eth_ipv4_cksum_offload[s_port]) {
     /* generate cksum if no offload */
     ipv4->hdr_checksum = rte_ipv4_cksum(ipv4);
   }
@@ -795,6 +1139,56 @@ static int tv_build_redundant_rtp(struct st_tx_video_session_impl* s,
   return 0;
 }
 
+/* the ipv6 r pkt, the udp cksum reuses the payload sum of the base pkt */
+static int tv_build_redundant6(struct st_tx_video_session_impl* s,
+                               struct rte_mbuf* pkt_r, struct rte_mbuf* pkt_base,
+                               struct rte_mbuf* pkt_chain) {
+  struct st_rfc4175_video_hdr6* hdr;
+  struct st_rfc4175_video_hdr6* hdr_base;
+  struct st20_rfc4175_rtp_hdr* rtp;
+  uint16_t l4_len = sizeof(hdr->udp) + sizeof(*rtp);
+
+  hdr = rte_pktmbuf_mtod(pkt_r, struct st_rfc4175_video_hdr6*);
+  hdr_base = rte_pktmbuf_mtod(pkt_base, struct st_rfc4175_video_hdr6*);
+  rtp = &hdr->rtp;
+
+  /* copy the hdr: eth, ip, udp, rtp */
+  rte_memcpy(hdr, &s->s_hdr6[MT_SESSION_PORT_R], sizeof(*hdr));
+  rte_memcpy(rtp, &hdr_base->rtp, sizeof(*rtp));
+
+  /* copy extra if Continuation */
+  if (ntohs(rtp->row_offset) & ST20_SRD_OFFSET_CONTINUATION) {
+    rte_memcpy(&rtp[1], &hdr_base->rtp + 1, sizeof(struct st20_rfc4175_extra_rtp_hdr));
+    l4_len += sizeof(struct st20_rfc4175_extra_rtp_hdr);
+  }
+
+  if (!s->eth_has_chain[MT_SESSION_PORT_R]) {
+    mt_mbuf_chain_sw_copy(pkt_r, pkt_chain);
+  }
+
+  /* update mbuf, the r port may differ from the base on the udp cksum offload */
+  pkt_r->data_len = pkt_base->data_len;
+  pkt_r->pkt_len = pkt_base->pkt_len;
+  mt_mbuf_init_ipv6(pkt_r);
+  pkt_r->nb_segs = 2;
+  /* chain mbuf */
+  pkt_r->next = pkt_chain;
+
+  rte_mbuf_refcnt_update(pkt_chain, 1);
+  hdr->udp.dgram_len = htons(pkt_r->pkt_len - pkt_r->l2_len - pkt_r->l3_len);
+  hdr->ipv6.payload_len = hdr->udp.dgram_len;
+  uint32_t phdr_sum = s->st20_udp6_phdr_sum[MT_SESSION_PORT_R];
+  if (s->eth_udp_cksum_offload[MT_SESSION_PORT_R]) {
+    mt_mbuf_init_udp_cksum(pkt_r);
+    hdr->udp.dgram_cksum = mt_udp6_phdr_cksum(phdr_sum, hdr->udp.dgram_len);
+  } else {
+    hdr->udp.dgram_cksum = mt_udp6_cksum(phdr_sum, hdr->udp.dgram_len, &hdr->udp, l4_len,
+                                         s->st20_udp6_payload_sum);
+  }
+
+  return 0;
+}
+
 static int tv_build_redundant(struct st_tx_video_session_impl* s, struct rte_mbuf* pkt_r,
                               struct rte_mbuf* pkt_base, struct rte_mbuf* pkt_chain) {
   struct st_rfc4175_video_hdr* hdr;
@@ -1028,6 +1422,7 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
   struct st_tx_video_pacing* pacing = &s->pacing;
   int ret;
   bool send_r = false;
+  bool stripe = (ops->flags & ST20_TX_FLAG_PORT_STRIPE) ? true : false;
   struct rte_mempool* hdr_pool_p = s->mbuf_mempool_hdr[MT_SESSION_PORT_P];
   struct rte_mempool* hdr_pool_r = NULL;
   struct rte_mempool* chain_pool = s->mbuf_mempool_chain;
@@ -1148,6 +1543,7 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
   struct rte_mbuf* pkts[bulk];
   struct rte_mbuf* pkts_r[bulk];
   struct rte_mbuf* pkts_chain[bulk];
+  struct rte_mbuf* pkts_chain_r[bulk]; /* payload of the striped r pkts */
 
   ret = rte_pktmbuf_alloc_bulk(chain_pool, pkts_chain, bulk);
   if (ret < 0) {
@@ -1175,22 +1571,81 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
     }
   }
 
+  if (stripe) {
+    ret = rte_pktmbuf_alloc_bulk(chain_pool, pkts_chain_r, bulk);
+    if (ret < 0) {
+      dbg("%s(%d), pkts chain_r alloc fail %d\n", __func__, idx, ret);
+      rte_pktmbuf_free_bulk(pkts, bulk);
+      rte_pktmbuf_free_bulk(pkts_r, bulk);
+      rte_pktmbuf_free_bulk(pkts_chain, bulk);
+      s->stat_build_ret_code = -STI_FRAME_PKT_ALLOC_FAIL;
+      return MT_TASKLET_ALL_DONE;
+    }
+  }
+
+  /* the fec pkts follow the media pkts of the frame */
+  int frame_pkts = s->st20_total_pkts;
+  unsigned int fec_bulk = 0, fec_idx = 0;
+  struct rte_mbuf* pkts_fec[bulk];
+  if (s->fec) {
+    frame_pkts += s->fec->total_pkts;
+    int fec_start = RTE_MAX(s->st20_pkt_idx, s->st20_total_pkts);
+    int fec_end = RTE_MIN(s->st20_pkt_idx + (int)bulk, frame_pkts);
+    if (fec_end > fec_start) fec_bulk = fec_end - fec_start;
+  }
+  if (fec_bulk) {
+    ret = rte_pktmbuf_alloc_bulk(s->fec->mbuf_mempool, pkts_fec, fec_bulk);
+    if (ret < 0) {
+      dbg("%s(%d), pkts_fec alloc fail %d\n", __func__, idx, ret);
+      rte_pktmbuf_free_bulk(pkts, bulk);
+      rte_pktmbuf_free_bulk(pkts_chain, bulk);
+      if (send_r) rte_pktmbuf_free_bulk(pkts_r, bulk);
+      s->stat_build_ret_code = -STI_FRAME_PKT_ALLOC_FAIL;
+      return MT_TASKLET_ALL_DONE;
+    }
+  }
+
   for (unsigned int i = 0; i < bulk; i++) {
-    if (s->st20_pkt_idx >= s->st20_total_pkts) {
+    if (s->st20_pkt_idx >= frame_pkts) {
       s->stat_pkts_dummy++;
       rte_pktmbuf_free(pkts_chain[i]);
       st_tx_mbuf_set_idx(pkts[i], ST_TX_DUMMY_PKT_IDX);
+    } else if (s->st20_pkt_idx >= s->st20_total_pkts) {
+      /* fec pkt, single segment */
+      rte_pktmbuf_free(pkts_chain[i]);
+      rte_pktmbuf_free(pkts[i]);
+      pkts[i] = pkts_fec[fec_idx++];
+      if (tv_fec_build_pkt(s, pkts[i]) < 0)
+        st_tx_mbuf_set_idx(pkts[i], ST_TX_DUMMY_PKT_IDX);
+      else
+        st_tx_mbuf_set_idx(pkts[i], s->st20_pkt_idx);
     } else {
-      tv_build_pkt(impl, s, pkts[i], pkts_chain[i]);
+      tv_build_pkt(impl, s, pkts[i], pkts_chain[i], MT_SESSION_PORT_P);
       st_tx_mbuf_set_idx(pkts[i], s->st20_pkt_idx);
     }
     pacing_set_mbuf_time_stamp(pkts[i], pacing);
 
-    if (send_r) {
+    if (stripe) {
+      /* the odd pkt on the r port, each link carries half of the frame */
+      pacing_foward_cursor(pacing);
+      s->st20_pkt_idx++;
+      s->stat_pkts_build++;
+      if (s->st20_pkt_idx >= s->st20_total_pkts) {
+        rte_pktmbuf_free(pkts_chain_r[i]);
+        st_tx_mbuf_set_idx(pkts_r[i], ST_TX_DUMMY_PKT_IDX);
+      } else {
+        tv_build_pkt(impl, s, pkts_r[i], pkts_chain_r[i], MT_SESSION_PORT_R);
+        st_tx_mbuf_set_idx(pkts_r[i], s->st20_pkt_idx);
+      }
+      pacing_set_mbuf_time_stamp(pkts_r[i], pacing);
+    } else if (send_r) {
       if (s->st20_pkt_idx >= s->st20_total_pkts) {
         st_tx_mbuf_set_idx(pkts_r[i], ST_TX_DUMMY_PKT_IDX);
       } else {
-        tv_build_redundant(s, pkts_r[i], pkts[i], pkts_chain[i]);
+        if (s->ipv6)
+          tv_build_redundant6(s, pkts_r[i], pkts[i], pkts_chain[i]);
+        else
+          tv_build_redundant(s, pkts_r[i], pkts[i], pkts_chain[i]);
         st_tx_mbuf_set_idx(pkts_r[i], s->st20_pkt_idx);
       }
       pacing_set_mbuf_time_stamp(pkts_r[i], pacing);
@@ -1222,7 +1677,7 @@ static int tv_tasklet_frame(struct mtl_main_impl* impl,
     }
   }
 
-  if (s->st20_pkt_idx >= s->st20_total_pkts) {
+  if (s->st20_pkt_idx >= frame_pkts) {
     dbg("%s(%d), frame %d done with %d pkts\n", __func__, idx, s->st20_frame_idx,
         s->st20_pkt_idx);
     /* end of current frame */
@@ -1385,6 +1840,187 @@ static int tv_tasklet_rtp(struct mtl_main_impl* impl,
   return done ? MT_TASKLET_ALL_DONE : MT_TASKLET_HAS_PENDING;
 }
 
+static void tv_replay_free_cb(void* addr, void* opaque) {
+  /* the mapping lives until the session is freed, the refcnt is checked at free */
+}
+
+/* pkt_chain is NULL if the capture is not dma mapped, the payload is copied then */
+static int tv_build_replay(struct st_tx_video_session_impl* s, struct rte_mbuf* pkt,
+                           struct rte_mbuf* pkt_chain,
+                           struct st_tx_video_replay_pkt* rpkt,
+                           enum mt_session_port s_port) {
+  struct st_tx_video_replay* replay = s->replay;
+  struct st_rfc4175_video_hdr* s_hdr = &s->s_hdr[s_port];
+  struct mt_udp_hdr* hdr;
+  struct rte_ipv4_hdr* ipv4;
+  struct rte_udp_hdr* udp;
+  struct st20_rfc4175_rtp_hdr* rtp;
+  uint8_t* payload = (uint8_t*)replay->addr + rpkt->offset;
+  uint16_t hdr_len = pkt_chain ? sizeof(*rtp) : rpkt->len;
+
+  hdr = rte_pktmbuf_mtod(pkt, struct mt_udp_hdr*);
+  ipv4 = &hdr->ipv4;
+  udp = &hdr->udp;
+  rtp = (struct st20_rfc4175_rtp_hdr*)&hdr[1];
+
+  /* rewrite the hdr: eth, ip, udp to this session */
+  rte_memcpy(&hdr->eth, &s_hdr->eth, sizeof(hdr->eth));
+  rte_memcpy(ipv4, &s_hdr->ipv4, sizeof(hdr->ipv4));
+  rte_memcpy(udp, &s_hdr->udp, sizeof(hdr->udp));
+  ipv4->packet_id = htons(s->st20_ipv4_packet_id);
+
+  /* the recorded rtp hdr, the seq and timestamp continue across the passes */
+  rte_memcpy(rtp, payload, hdr_len);
+  uint32_t seq =
+      ((uint32_t)ntohs(rtp->seq_number_ext) << 16) | ntohs(rtp->base.seq_number);
+  seq += replay->seq_offset;
+  rtp->base.seq_number = htons((uint16_t)seq);
+  rtp->seq_number_ext = htons((uint16_t)(seq >> 16));
+  rtp->base.tmstamp = htonl(ntohl(rtp->base.tmstamp) + replay->tmstamp_offset);
+  rtp->base.ssrc = s_hdr->rtp.base.ssrc;
+
+  /* update mbuf */
+  mt_mbuf_init_ipv4(pkt);
+  pkt->data_len = sizeof(struct mt_udp_hdr) + hdr_len;
+  pkt->pkt_len = pkt->data_len;
+
+  if (pkt_chain) {
+    /* attach the recorded payload to chainbuf */
+    uint16_t left_len = rpkt->len - hdr_len;
+    size_t offset = rpkt->offset + hdr_len;
+    rte_pktmbuf_attach_extbuf(pkt_chain, payload + hdr_len, replay->iova + offset,
+                              left_len, &replay->sh_info);
+    rte_mbuf_ext_refcnt_update(&replay->sh_info, 1);
+    pkt_chain->data_len = pkt_chain->pkt_len = left_len;
+
+    /* chain the pkt */
+    rte_pktmbuf_chain(pkt, pkt_chain);
+    if (!s->eth_has_chain[s_port]) mt_mbuf_chain_sw(pkt, pkt_chain);
+  }
+
+  udp->dgram_len = htons(pkt->pkt_len - pkt->l2_len - pkt->l3_len);
+  ipv4->total_length = htons(pkt->pkt_len - pkt->l2_len);
+  if (!s->eth_ipv4_cksum_offload[s_port]) {
+    /* generate cksum if no offload */
+    ipv4->hdr_checksum = rte_ipv4_cksum(ipv4);
+  }
+  return 0;
+}
+
+static void tv_replay_new_pass(struct mtl_main_impl* impl,
+                               struct st_tx_video_session_impl* s) {
+  struct st_tx_video_replay* replay = s->replay;
+  uint64_t cur_tsc = mt_get_tsc(impl);
+
+  if (replay->base_tsc) {
+    /* no jump back of the seq and timestamp for the receiver */
+    replay->seq_offset += replay->seq_loop;
+    replay->tmstamp_offset += replay->tmstamp_loop;
+  }
+
+  if (replay->base_tsc && (replay->base_tsc + replay->loop_ns + NS_PER_MS > cur_tsc)) {
+    /* back to back with the last pass */
+    replay->base_tsc += replay->loop_ns;
+    replay->base_ptp += replay->loop_ns;
+    replay->stat_loops++;
+  } else {
+    /* first pass or the session was stalled, restart the timing from now */
+    replay->base_tsc = cur_tsc;
+    /* always use MTL_PORT_P for ptp now */
+    replay->base_ptp = mt_get_ptp_time(impl, MTL_PORT_P);
+  }
+}
+
+static int tv_tasklet_replay(struct mtl_main_impl* impl,
+                             struct st_tx_video_session_impl* s) {
+  struct st_tx_video_replay* replay = s->replay;
+  unsigned int bulk = s->bulk;
+  int num_port = s->ops.num_port;
+  struct rte_mbuf* pkts[MT_SESSION_PORT_MAX][bulk];
+  struct rte_mbuf* pkts_chain[MT_SESSION_PORT_MAX][bulk];
+  bool zero_copy = replay->iova != MTL_BAD_IOVA;
+  struct st_tx_video_replay_pkt* rpkt;
+  struct st_rfc3550_rtp_hdr* rtp;
+  unsigned int n;
+  int ret;
+
+  /* check if any inflight pkts */
+  for (int i = 0; i < num_port; i++) {
+    if (!s->has_inflight[i]) continue;
+    n = rte_ring_sp_enqueue_bulk(s->ring[i], (void**)&s->inflight[i][0], bulk, NULL);
+    if (n > 0) {
+      s->has_inflight[i] = false;
+    } else {
+      s->stat_build_ret_code = -STI_RTP_INFLIGHT_ENQUEUE_FAIL;
+      return MT_TASKLET_ALL_DONE;
+    }
+  }
+
+  if (rte_ring_full(s->ring[MT_SESSION_PORT_P])) {
+    s->stat_build_ret_code = -STI_RTP_RING_FULL;
+    return MT_TASKLET_ALL_DONE;
+  }
+
+  for (int i = 0; i < num_port; i++) {
+    ret = rte_pktmbuf_alloc_bulk(s->mbuf_mempool_hdr[i], pkts[i], bulk);
+    if (ret < 0) {
+      dbg("%s(%d), pkts alloc fail %d\n", __func__, s->idx, ret);
+      for (int j = 0; j < i; j++) rte_pktmbuf_free_bulk(pkts[j], bulk);
+      s->stat_build_ret_code = -STI_RTP_PKT_ALLOC_FAIL;
+      return MT_TASKLET_ALL_DONE;
+    }
+  }
+  if (zero_copy) {
+    for (int i = 0; i < num_port; i++) {
+      ret = rte_pktmbuf_alloc_bulk(s->mbuf_mempool_chain, pkts_chain[i], bulk);
+      if (ret < 0) {
+        dbg("%s(%d), pkts chain alloc fail %d\n", __func__, s->idx, ret);
+        for (int j = 0; j < num_port; j++) rte_pktmbuf_free_bulk(pkts[j], bulk);
+        for (int j = 0; j < i; j++) rte_pktmbuf_free_bulk(pkts_chain[j], bulk);
+        s->stat_build_ret_code = -STI_RTP_PKT_ALLOC_FAIL;
+        return MT_TASKLET_ALL_DONE;
+      }
+    }
+  }
+
+  /* no dummy pkts as the capture loops, always full bulk */
+  for (unsigned int i = 0; i < bulk; i++) {
+    if (!replay->cursor) tv_replay_new_pass(impl, s);
+    rpkt = &replay->pkts[replay->cursor];
+
+    for (int port = 0; port < num_port; port++) {
+      tv_build_replay(s, pkts[port][i], zero_copy ? pkts_chain[port][i] : NULL, rpkt,
+                      port);
+      st_tx_mbuf_set_idx(pkts[port][i], replay->cursor);
+      st_tx_mbuf_set_tsc(pkts[port][i], replay->base_tsc + rpkt->time_ns);
+      st_tx_mbuf_set_ptp(pkts[port][i], replay->base_ptp + rpkt->time_ns);
+    }
+    s->st20_ipv4_packet_id++;
+
+    rtp = rte_pktmbuf_mtod_offset(pkts[MT_SESSION_PORT_P][i],
+                                  struct st_rfc3550_rtp_hdr*, sizeof(struct mt_udp_hdr));
+    if (rtp->marker) rte_atomic32_inc(&s->stat_frame_cnt);
+
+    replay->cursor++;
+    if (replay->cursor >= replay->nb_pkts) replay->cursor = 0;
+    s->stat_pkts_build++;
+  }
+
+  bool done = false;
+  for (int i = 0; i < num_port; i++) {
+    n = rte_ring_sp_enqueue_bulk(s->ring[i], (void**)&pkts[i][0], bulk, NULL);
+    if (n == 0) {
+      for (unsigned int j = 0; j < bulk; j++) s->inflight[i][j] = pkts[i][j];
+      s->has_inflight[i] = true;
+      s->inflight_cnt[i]++;
+      s->stat_build_ret_code = -STI_RTP_PKT_ENQUEUE_FAIL;
+      done = true;
+    }
+  }
+
+  return done ? MT_TASKLET_ALL_DONE : MT_TASKLET_HAS_PENDING;
+}
+
 static int tv_tasklet_st22(struct mtl_main_impl* impl,
                            struct st_tx_video_session_impl* s) {
   unsigned int bulk = s->bulk;
@@ -1641,11 +2277,19 @@ static int tvs_tasklet_handler(void* priv) {
     /* check vsync if it has vsync enabled */
     if (s->ops.flags & ST20_TX_FLAG_ENABLE_VSYNC) tv_poll_vsync(impl, s);
 
+    /* dst mac not resolved yet */
+    if (rte_atomic32_read(&s->mac_pending) || tv_arp_retry(impl, s)) {
+      tx_video_session_put(mgr, sidx);
+      continue;
+    }
+
     s->stat_build_ret_code = 0;
     if (s->st22_info)
       pending = tv_tasklet_st22(impl, s);
     else if (st20_is_frame_type(s->ops.type))
       pending = tv_tasklet_frame(impl, s);
+    else if (s->replay)
+      pending = tv_tasklet_replay(impl, s);
     else
       pending = tv_tasklet_rtp(impl, s);
 
@@ -1727,7 +2371,7 @@ static int tv_init_hw(struct mtl_main_impl* impl, struct st_tx_video_sessions_mg
             mgr_idx, idx, i);
       } else {
         /* reuse rx mempool for zero copy */
-        if (mt_has_rx_mono_pool(impl))
+        if (mt_has_rx_mono_pool(impl) || mt_has_af_xdp_shared_umem(impl, port))
           s->mbuf_mempool_hdr[i] = mt_get_rx_mempool(impl, port);
         else
           s->mbuf_mempool_hdr[i] = mt_if(impl, port)->rx_queues[queue_id].mbuf_pool;
@@ -1744,7 +2388,8 @@ static int tv_init_hw(struct mtl_main_impl* impl, struct st_tx_video_sessions_mg
     }
     for (int j = 0; j < ST20_PKT_TYPE_MAX; j++) {
       if (!s->st20_pkt_info[j].number) continue;
-      pad = mt_build_pad(impl, pad_mempool, port_id, RTE_ETHER_TYPE_IPV4,
+      pad = mt_build_pad(impl, pad_mempool, port_id,
+                         s->ipv6 ? RTE_ETHER_TYPE_IPV6 : RTE_ETHER_TYPE_IPV4,
                          s->st20_pkt_info[j].size);
       if (!pad) {
         tv_uinit_hw(impl, s);
@@ -1800,7 +2445,15 @@ static int tv_mempool_init(struct mtl_main_impl* impl,
   uint16_t hdr_room_size = 0;
   uint16_t chain_room_size = 0;
 
-  if (!tv_has_chain_buf(s)) {
+  if (s->replay && (s->replay->iova != MTL_BAD_IOVA)) {
+    /* the rewritten rtp hdr, attach extbuf used for the recorded payload */
+    hdr_room_size = sizeof(struct mt_udp_hdr) + sizeof(struct st20_rfc4175_rtp_hdr);
+    chain_room_size = 0;
+  } else if (s->replay) {
+    /* the recorded pkt is copied into one single segment mbuf */
+    hdr_room_size = s->st20_pkt_size;
+    chain_room_size = 0;
+  } else if (!tv_has_chain_buf(s)) {
     /* no chain buffer support in the driver */
     hdr_room_size = s->st20_pkt_size;
     if (ops->type == ST20_TYPE_RTP_LEVEL)
@@ -1815,7 +2468,8 @@ static int tv_mempool_init(struct mtl_main_impl* impl,
     hdr_room_size = sizeof(struct mt_udp_hdr);
     chain_room_size = s->rtp_pkt_max_size;
   } else { /* frame level */
-    hdr_room_size = sizeof(struct st_rfc4175_video_hdr);
+    hdr_room_size = s->ipv6 ? sizeof(struct st_rfc4175_video_hdr6)
+                            : sizeof(struct st_rfc4175_video_hdr);
     if (ops->packing != ST20_PACKING_GPM_SL)
       hdr_room_size += sizeof(struct st20_rfc4175_extra_rtp_hdr);
     /* attach extbuf used, only placeholder mbuf */
@@ -1898,6 +2552,186 @@ static int tv_init_packet_ring(struct mtl_main_impl* impl,
   return 0;
 }
 
+static int tv_uinit_fec(struct st_tx_video_session_impl* s) {
+  struct st_tx_video_fec* fec = s->fec;
+
+  if (!fec) return 0;
+
+  if (fec->mbuf_mempool) {
+    mt_mempool_free(fec->mbuf_mempool);
+    fec->mbuf_mempool = NULL;
+  }
+  if (fec->units) {
+    mt_rte_free(fec->units);
+    fec->units = NULL;
+  }
+  if (fec->units_len) {
+    mt_rte_free(fec->units_len);
+    fec->units_len = NULL;
+  }
+  if (fec->units_count) {
+    mt_rte_free(fec->units_count);
+    fec->units_count = NULL;
+  }
+  mt_rte_free(fec);
+  s->fec = NULL;
+
+  return 0;
+}
+
+static int tv_init_fec(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr* mgr,
+                       struct st_tx_video_session_impl* s) {
+  struct st20_tx_ops* ops = &s->ops;
+  int idx = s->idx;
+  enum mtl_port port = mt_port_logic2phy(s->port_maps, MT_SESSION_PORT_P);
+  int soc_id = mt_socket_id(impl, port);
+  struct st_tx_video_fec* fec;
+
+  if (!ops->fec_cols && !ops->fec_rows) return 0; /* fec disabled */
+
+  if (s->mbuf_mempool_reuse_rx[MT_SESSION_PORT_P]) {
+    err("%s(%d), fec not support af_xdp zero copy\n", __func__, idx);
+    return -ENOTSUP;
+  }
+  uint16_t unit_size = ST20_FEC_SRD_LEN + s->st20_pkt_len;
+  uint16_t fec_pkt_size = sizeof(struct st20_fec_video_hdr) + unit_size;
+  if (fec_pkt_size > ST_PKT_MAX_ETHER_BYTES) {
+    err("%s(%d), invalid fec pkt size %u\n", __func__, idx, fec_pkt_size);
+    return -EINVAL;
+  }
+
+  fec = mt_rte_zmalloc_socket(sizeof(*fec), soc_id);
+  if (!fec) {
+    err("%s(%d), fec malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  s->fec = fec;
+
+  fec->cols = RTE_MAX(ops->fec_cols, 1);
+  fec->rows = RTE_MAX(ops->fec_rows, 1);
+  fec->row_units = (fec->cols > 1) ? fec->rows : 0;
+  fec->col_units = (fec->rows > 1) ? fec->cols : 0;
+  fec->unit_size = unit_size;
+  fec->matrix_pkts = fec->cols * fec->rows;
+  uint32_t matrix_units = fec->row_units + fec->col_units;
+  uint32_t nb_matrix = (s->st20_total_pkts + fec->matrix_pkts - 1) / fec->matrix_pkts;
+  fec->nb_units = nb_matrix * matrix_units;
+  fec->total_pkts = st20_fec_frame_pkts(s->st20_total_pkts, fec->cols, fec->rows);
+  fec->simd_level = mtl_get_simd_level();
+  if (mt_has_tx_video_fec_test_drop(impl) && (fec->cols > 1)) {
+    fec->test_drop = ST_TX_VIDEO_FEC_TEST_DROP_ROWS;
+    warn("%s(%d), test only, lose the first pkt of the first %u rows\n", __func__, idx,
+         fec->test_drop);
+  }
+
+  fec->units = mt_rte_zmalloc_socket((size_t)fec->nb_units * unit_size, soc_id);
+  fec->units_len = mt_rte_zmalloc_socket(sizeof(*fec->units_len) * fec->nb_units, soc_id);
+  fec->units_count =
+      mt_rte_zmalloc_socket(sizeof(*fec->units_count) * fec->nb_units, soc_id);
+  if (!fec->units || !fec->units_len || !fec->units_count) {
+    err("%s(%d), fec units malloc fail, nb %u\n", __func__, idx, fec->nb_units);
+    tv_uinit_fec(s);
+    return -ENOMEM;
+  }
+  /* the pkts protected by each unit, the last matrix may be partial */
+  for (int i = 0; i < s->st20_total_pkts; i++) {
+    uint32_t base = i / fec->matrix_pkts * matrix_units;
+    uint32_t k = i % fec->matrix_pkts;
+    if (fec->row_units) fec->units_count[base + k / fec->cols]++;
+    if (fec->col_units) fec->units_count[base + fec->row_units + k % fec->cols]++;
+  }
+
+  char pool_name[32];
+  unsigned int n = mt_if_nb_tx_desc(impl, port) + s->ring_count;
+  snprintf(pool_name, 32, "TXVIDEOFEC-M%d-R%d", mgr->idx, idx);
+  fec->mbuf_mempool = mt_mempool_create(impl, port, pool_name, n, MT_MBUF_CACHE_SIZE,
+                                        sizeof(struct mt_muf_priv_data), fec_pkt_size);
+  if (!fec->mbuf_mempool) {
+    tv_uinit_fec(s);
+    return -ENOMEM;
+  }
+
+  info("%s(%d), L %u D %u, fec pkts %d for %d media pkts, pt %u\n", __func__, idx,
+       fec->cols, fec->rows, fec->total_pkts, s->st20_total_pkts, ops->fec_payload_type);
+  return 0;
+}
+
+static int tv_uinit_replay(struct st_tx_video_session_impl* s) {
+  struct st_tx_video_replay* replay = s->replay;
+
+  if (!replay) return 0;
+
+  uint16_t refcnt = rte_mbuf_ext_refcnt_read(&replay->sh_info);
+  if (refcnt) {
+    /* never unmap the pages still in the nic queue */
+    warn("%s(%d), sh_info still active, refcnt %u, leak the mapping\n", __func__, s->idx,
+         refcnt);
+    replay->addr = NULL;
+  } else if (replay->iova != MTL_BAD_IOVA) {
+    mtl_dma_unmap(replay->impl, replay->addr, replay->iova, replay->map_size);
+  }
+  replay->iova = MTL_BAD_IOVA;
+
+  st_video_replay_close(replay);
+  mt_rte_free(replay);
+  s->replay = NULL;
+
+  return 0;
+}
+
+static int tv_init_replay(struct mtl_main_impl* impl,
+                          struct st_tx_video_session_impl* s) {
+  struct st20_tx_ops* ops = &s->ops;
+  int idx = s->idx, ret;
+  enum mtl_port port = mt_port_logic2phy(s->port_maps, MT_SESSION_PORT_P);
+  struct st_tx_video_replay* replay;
+
+  if (!ops->replay_url) return 0; /* replay disabled */
+
+  for (int i = 0; i < ops->num_port; i++) {
+    if (s->mbuf_mempool_reuse_rx[i]) {
+      err("%s(%d), replay not support af_xdp zero copy\n", __func__, idx);
+      return -ENOTSUP;
+    }
+  }
+
+  replay = mt_rte_zmalloc_socket(sizeof(*replay), mt_socket_id(impl, port));
+  if (!replay) {
+    err("%s(%d), replay malloc fail\n", __func__, idx);
+    return -ENOMEM;
+  }
+  s->replay = replay;
+  replay->impl = impl;
+  replay->iova = MTL_BAD_IOVA;
+  replay->sh_info.free_cb = tv_replay_free_cb;
+  replay->sh_info.fcb_opaque = replay;
+  rte_mbuf_ext_refcnt_set(&replay->sh_info, 0);
+
+  uint32_t frame_tmstamp =
+      (uint64_t)s->fps_tm.sampling_clock_rate * s->fps_tm.den / s->fps_tm.mul;
+  ret = st_video_replay_open(replay, ops->replay_url, ops->replay_udp_port,
+                             ops->replay_speed, s->rtp_pkt_max_size, mtl_page_size(impl),
+                             frame_tmstamp, idx);
+  if (ret < 0) {
+    err("%s(%d), open %s fail %d\n", __func__, idx, ops->replay_url, ret);
+    tv_uinit_replay(s);
+    return ret;
+  }
+
+  /* attach the payload in the mapping to the chain mbuf, no copy */
+  if (tv_has_chain_buf(s) && (impl->iova_mode == RTE_IOVA_VA) &&
+      !mt_pmd_is_kernel(impl, port)) {
+    replay->iova = mtl_dma_map(impl, replay->addr, replay->map_size);
+    if (replay->iova == MTL_BAD_IOVA)
+      warn("%s(%d), dma map fail, copy the pkts\n", __func__, idx);
+  }
+
+  info("%s(%d), %u pkts, speed %u%%, %s\n", __func__, idx, replay->nb_pkts,
+       ops->replay_speed ? ops->replay_speed : 100,
+       (replay->iova != MTL_BAD_IOVA) ? "zero copy" : "copy");
+  return 0;
+}
+
 static int tv_uinit_sw(struct st_tx_video_session_impl* s) {
   int num_port = s->ops.num_port;
 
@@ -1929,6 +2763,10 @@ static int tv_uinit_sw(struct st_tx_video_session_impl* s) {
 
   tv_free_frames(s);
 
+  tv_uinit_fec(s);
+
+  tv_uinit_replay(s);
+
   if (s->st22_info) {
     mt_rte_free(s->st22_info);
     s->st22_info = NULL;
@@ -1971,6 +2809,14 @@ static int tv_init_sw(struct mtl_main_impl* impl, struct st_tx_video_sessions_mg
     tv_init_st22_boxes(impl, s);
   }
 
+  /* the mempool depends on the replay is dma mapped or not */
+  ret = tv_init_replay(impl, s);
+  if (ret < 0) {
+    err("%s(%d), replay init fail %d\n", __func__, idx, ret);
+    tv_uinit_sw(s);
+    return ret;
+  }
+
   /* free the pool if any in previous session */
   tv_mempool_free(s);
   ret = tv_mempool_init(impl, mgr, s);
@@ -1980,7 +2826,9 @@ static int tv_init_sw(struct mtl_main_impl* impl, struct st_tx_video_sessions_mg
     return ret;
   }
 
-  if (type == ST20_TYPE_RTP_LEVEL)
+  if (s->replay)
+    ret = 0;
+  else if (type == ST20_TYPE_RTP_LEVEL)
     ret = tv_init_packet_ring(impl, mgr, s);
   else
     ret = tv_alloc_frames(impl, s);
@@ -1990,6 +2838,13 @@ static int tv_init_sw(struct mtl_main_impl* impl, struct st_tx_video_sessions_mg
     return ret;
   }
 
+  ret = tv_init_fec(impl, mgr, s);
+  if (ret < 0) {
+    err("%s(%d), fec init fail %d\n", __func__, idx, ret);
+    tv_uinit_sw(s);
+    return ret;
+  }
+
   return 0;
 }
 
@@ -1999,6 +2854,12 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
   int idx = s->idx;
   uint32_t height = ops->interlaced ? (ops->height >> 1) : ops->height;
   enum st20_type type = ops->type;
+  /* same udp payload for ipv6, only the ip hdr is bigger */
+  size_t hdr_size = s->ipv6 ? sizeof(struct st_rfc4175_video_hdr6)
+                            : sizeof(struct st_rfc4175_video_hdr);
+  uint32_t max_ether_bytes = ST_PKT_MAX_ETHER_BYTES;
+
+  if (s->ipv6) max_ether_bytes += ST_PKT_IP6_EXTRA_BYTES;
 
   /* clear pkt info */
   memset(&s->st20_pkt_info[0], 0,
@@ -2036,14 +2897,13 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
     int pixel_in_pkt = (ops->width + s->st20_pkts_in_line - 1) / s->st20_pkts_in_line;
     s->st20_pkt_len =
         (pixel_in_pkt + s->st20_pg.coverage - 1) / s->st20_pg.coverage * s->st20_pg.size;
-    s->st20_pkt_size = s->st20_pkt_len + sizeof(struct st_rfc4175_video_hdr);
+    s->st20_pkt_size = s->st20_pkt_len + hdr_size;
     s->st20_total_pkts = height * s->st20_pkts_in_line;
 
     int line_last_len = s->st20_bytes_in_line % s->st20_pkt_len;
     if (line_last_len) {
       s->st20_pkt_info[ST20_PKT_TYPE_LINE_TAIL].number = height;
-      s->st20_pkt_info[ST20_PKT_TYPE_LINE_TAIL].size =
-          line_last_len + sizeof(struct st_rfc4175_video_hdr);
+      s->st20_pkt_info[ST20_PKT_TYPE_LINE_TAIL].size = line_last_len + hdr_size;
     }
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].size = s->st20_pkt_size;
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].number =
@@ -2052,7 +2912,7 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
   } else if (ops->packing == ST20_PACKING_BPM) {
     s->st20_pkt_len = ST_VIDEO_BPM_SIZE;
     int last_pkt_len = s->st20_frame_size % s->st20_pkt_len;
-    s->st20_pkt_size = s->st20_pkt_len + sizeof(struct st_rfc4175_video_hdr);
+    s->st20_pkt_size = s->st20_pkt_len + hdr_size;
     s->st20_total_pkts = ceil((double)s->st20_frame_size / s->st20_pkt_len);
     int bytes_per_pkt = s->st20_pkt_len;
     int temp = s->st20_bytes_in_line;
@@ -2068,8 +2928,7 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
     }
     if (last_pkt_len) {
       s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].number = 1;
-      s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].size =
-          last_pkt_len + sizeof(struct st_rfc4175_video_hdr);
+      s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].size = last_pkt_len + hdr_size;
     }
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].size = s->st20_pkt_size;
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].number =
@@ -2087,7 +2946,7 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
         (ceil)((double)ops->width * height / (s->st20_pg.coverage * pg_per_pkt));
     s->st20_pkt_len = pg_per_pkt * s->st20_pg.size;
     int last_pkt_len = s->st20_frame_size % s->st20_pkt_len;
-    s->st20_pkt_size = s->st20_pkt_len + sizeof(struct st_rfc4175_video_hdr);
+    s->st20_pkt_size = s->st20_pkt_len + hdr_size;
     int bytes_per_pkt = s->st20_pkt_len;
     int temp = s->st20_bytes_in_line;
     while (temp % bytes_per_pkt != 0 && temp <= s->st20_frame_size) {
@@ -2102,8 +2961,7 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
     }
     if (last_pkt_len) {
       s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].number = 1;
-      s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].size =
-          last_pkt_len + sizeof(struct st_rfc4175_video_hdr);
+      s->st20_pkt_info[ST20_PKT_TYPE_FRAME_TAIL].size = last_pkt_len + hdr_size;
     }
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].size = s->st20_pkt_size;
     s->st20_pkt_info[ST20_PKT_TYPE_NORMAL].number =
@@ -2115,7 +2973,7 @@ static int tv_init_pkt(struct mtl_main_impl* impl, struct st_tx_video_session_im
     return -EIO;
   }
 
-  if (s->st20_pkt_size > ST_PKT_MAX_ETHER_BYTES) {
+  if (s->st20_pkt_size > max_ether_bytes) {
     err("%s(%d), invalid st20 pkt size %d\n", __func__, idx, s->st20_pkt_size);
     return -EIO;
   }
@@ -2168,6 +3026,8 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
     s->st20_fb_size = s->st20_linesize * height;
   }
   s->st20_frames_cnt = ops->framebuff_cnt;
+  s->ipv6 = (ops->flags & ST20_TX_FLAG_IPV6) ? true : false;
+  s->st20_udp6_sw_sum = false;
 
   ret = tv_init_pkt(impl, s, ops, s_type, st22_frame_ops);
   if (ret < 0) {
@@ -2184,6 +3044,7 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
 
   s->st20_pkt_idx = 0;
   s->st20_seq_id = 0;
+  s->st20_seq_id_r = 0;
   s->st20_rtp_time = UINT32_MAX;
   s->st20_frame_stat = ST21_TX_STAT_WAIT_FRAME;
   s->bulk = RTE_MIN(4, ST_SESSION_MAX_BULK);
@@ -2196,6 +3057,8 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
     s->st20_dst_port[i] = s->st20_src_port[i];
     enum mtl_port port = mt_port_logic2phy(s->port_maps, i);
     s->eth_ipv4_cksum_offload[i] = mt_if_has_offload_ipv4_cksum(impl, port);
+    s->eth_udp_cksum_offload[i] = mt_if_has_offload_udp_cksum(impl, port);
+    if (s->ipv6 && !s->eth_udp_cksum_offload[i]) s->st20_udp6_sw_sum = true;
     s->eth_has_chain[i] = mt_if_has_chain_buff(impl, port);
     if (mt_pmd_is_kernel(impl, port) && mt_has_af_xdp_zc(impl)) {
       /* enable zero copy for tx */
@@ -2226,10 +3089,13 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
     return -EIO;
   }
 
+  rte_atomic32_set(&s->mac_pending, 0);
+  for (int i = 0; i < MT_SESSION_PORT_MAX; i++) rte_atomic32_set(&s->mac_fail[i], 0);
   for (int i = 0; i < num_port; i++) {
     ret = tv_init_hdr(impl, s, i);
     if (ret < 0) {
       err("%s(%d), tx_session_init_hdr fail %d prot %d\n", __func__, idx, ret, i);
+      tv_uinit_arp(impl, s);
       tv_uinit_hw(impl, s);
       tv_uinit_sw(s);
       return ret;
@@ -2239,6 +3105,7 @@ static int tv_attach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr
   ret = tv_init_pacing(impl, s);
   if (ret < 0) {
     err("%s(%d), tx_session_init_pacing fail %d\n", __func__, idx, ret);
+    tv_uinit_arp(impl, s);
     tv_uinit_hw(impl, s);
     tv_uinit_sw(s);
     return ret;
@@ -2335,6 +3202,33 @@ static void tv_stat(struct st_tx_video_sessions_mgr* mgr,
     s->stat_pkts_burst_dummy = 0;
   }
 
+  if (s->stat_pkts_fec) {
+    notice("TX_VIDEO_SESSION(%d,%d): fec pkts %u\n", m_idx, idx, s->stat_pkts_fec);
+    s->stat_pkts_fec = 0;
+  }
+  if (s->replay && s->replay->stat_loops) {
+    notice("TX_VIDEO_SESSION(%d,%d): replay loops %u\n", m_idx, idx,
+           s->replay->stat_loops);
+    s->replay->stat_loops = 0;
+  }
+  int sch_socket = mt_sch_socket_id(mgr->sch);
+  s->stat_numa_remote_est_mbs = 0;
+  if (frame_cnt && (sch_socket != SOCKET_ID_ANY)) {
+    int socket =
+        mt_socket_id(mgr->parnet, mt_port_logic2phy(s->port_maps, MT_SESSION_PORT_P));
+    /*
+     * the frames and mbufs live on the port socket, the lcore reads them cross socket.
+     * An estimate by the frame bytes, no uncore counters read.
+     */
+    if (!mt_socket_match(sch_socket, socket)) {
+      s->stat_numa_remote_est_mbs =
+          (double)frame_cnt * s->st20_frame_size / time_sec / (1000 * 1000);
+      notice(
+          "TX_VIDEO_SESSION(%d,%d): numa remote est %f MB/s, lcore socket %d port %d\n",
+          m_idx, idx, s->stat_numa_remote_est_mbs, sch_socket, socket);
+    }
+  }
+
   if (s->stat_epoch_troffset_mismatch) {
     notice("TX_VIDEO_SESSION(%d,%d): mismatch epoch troffset %u\n", m_idx, idx,
            s->stat_epoch_troffset_mismatch);
@@ -2399,6 +3293,7 @@ static void tv_stat(struct st_tx_video_sessions_mgr* mgr,
 static int tv_detach(struct mtl_main_impl* impl, struct st_tx_video_sessions_mgr* mgr,
                      struct st_tx_video_session_impl* s) {
   tv_stat(mgr, s);
+  tv_uinit_arp(impl, s);
   /* must uinit hw firstly as frame use shared external buffer */
   tv_uinit_hw(impl, s);
   tv_uinit_sw(s);
@@ -2423,7 +3318,7 @@ static struct st_tx_video_session_impl* tv_mgr_attach(
   for (int i = 0; i < ST_SCH_MAX_TX_VIDEO_SESSIONS; i++) {
     if (!tx_video_session_get_empty(mgr, i)) continue;
 
-    s = mt_rte_zmalloc_socket(sizeof(*s), mt_socket_id(impl, MTL_PORT_P));
+    s = mt_rte_zmalloc_socket(sizeof(*s), mt_port_socket_id(impl, ops->port[MTL_PORT_P]));
     if (!s) {
       err("%s(%d), session malloc fail on %d\n", __func__, midx, i);
       tx_video_session_put(mgr, i);
@@ -2480,11 +3375,13 @@ static int tv_mgr_init(struct mtl_main_impl* impl, struct mt_sch_impl* sch,
   int i;
 
   RTE_BUILD_BUG_ON(sizeof(struct st_rfc4175_video_hdr) != 62);
+  RTE_BUILD_BUG_ON(sizeof(struct st_rfc4175_video_hdr6) != 82);
   RTE_BUILD_BUG_ON(sizeof(struct st_rfc3550_hdr) != 54);
   RTE_BUILD_BUG_ON(sizeof(struct st22_rfc9134_video_hdr) != 58);
   RTE_BUILD_BUG_ON(sizeof(struct st22_boxes) != 60);
 
   mgr->parnet = impl;
+  mgr->sch = sch;
   mgr->idx = idx;
 
   for (i = 0; i < ST_SCH_MAX_TX_VIDEO_SESSIONS; i++) {
@@ -2554,17 +3451,21 @@ void st_tx_video_sessions_stat(struct mtl_main_impl* impl) {
   struct mt_sch_impl* sch;
   struct st_tx_video_sessions_mgr* mgr;
   struct st_tx_video_session_impl* s;
+  float remote_mbs;
 
   for (int sch_idx = 0; sch_idx < MT_MAX_SCH_NUM; sch_idx++) {
     sch = mt_sch_instance(impl, sch_idx);
     if (!mt_sch_started(sch)) continue;
     mgr = &sch->tx_video_mgr;
+    remote_mbs = 0;
     for (int j = 0; j < mgr->max_idx; j++) {
       s = tx_video_session_get(mgr, j);
       if (!s) continue;
       tv_stat(mgr, s);
+      remote_mbs += s->stat_numa_remote_est_mbs;
       tx_video_session_put(mgr, j);
     }
+    mgr->stat_numa_remote_est_mbs = remote_mbs;
   }
 }
 
@@ -2609,6 +3510,31 @@ int st_tx_video_session_migrate(struct mtl_main_impl* impl,
   return 0;
 }
 
+static int tv_ops_check6(struct st20_tx_ops* ops) {
+  int num_ports = ops->num_port;
+
+  for (int i = 0; i < num_ports; i++) {
+    if (mt_ip6_is_zero(ops->dip6_addr[i])) {
+      err("%s(%d), no dip6_addr\n", __func__, i);
+      return -EINVAL;
+    }
+  }
+  if ((num_ports > 1) && mt_ip6_equal(ops->dip6_addr[0], ops->dip6_addr[1])) {
+    err("%s, same dip6_addr for both ports\n", __func__);
+    return -EINVAL;
+  }
+  if (ops->type != ST20_TYPE_FRAME_LEVEL) {
+    err("%s, ipv6 only for frame type, type %d\n", __func__, ops->type);
+    return -EINVAL;
+  }
+  if (ops->fec_cols || ops->fec_rows) {
+    err("%s, fec not support ipv6\n", __func__);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
 static int tv_ops_check(struct st20_tx_ops* ops) {
   int num_ports = ops->num_port, ret;
   uint8_t* ip;
@@ -2618,19 +3544,25 @@ static int tv_ops_check(struct st20_tx_ops* ops) {
     return -EINVAL;
   }
 
-  for (int i = 0; i < num_ports; i++) {
-    ip = ops->dip_addr[i];
-    ret = mt_ip_addr_check(ip);
-    if (ret < 0) {
-      err("%s(%d), invalid ip %d.%d.%d.%d\n", __func__, i, ip[0], ip[1], ip[2], ip[3]);
-      return -EINVAL;
+  if (ops->flags & ST20_TX_FLAG_IPV6) {
+    /* the ipv4 dip_addr is not used */
+    ret = tv_ops_check6(ops);
+    if (ret < 0) return ret;
+  } else {
+    for (int i = 0; i < num_ports; i++) {
+      ip = ops->dip_addr[i];
+      ret = mt_ip_addr_check(ip);
+      if (ret < 0) {
+        err("%s(%d), invalid ip %d.%d.%d.%d\n", __func__, i, ip[0], ip[1], ip[2], ip[3]);
+        return -EINVAL;
+      }
     }
-  }
 
-  if (num_ports > 1) {
-    if (0 == memcmp(ops->dip_addr[0], ops->dip_addr[1], MTL_IP_ADDR_LEN)) {
-      err("%s, same %d.%d.%d.%d for both ip\n", __func__, ip[0], ip[1], ip[2], ip[3]);
-      return -EINVAL;
+    if (num_ports > 1) {
+      if (0 == memcmp(ops->dip_addr[0], ops->dip_addr[1], MTL_IP_ADDR_LEN)) {
+        err("%s, same %d.%d.%d.%d for both ip\n", __func__, ip[0], ip[1], ip[2], ip[3]);
+        return -EINVAL;
+      }
     }
   }
 
@@ -2651,7 +3583,12 @@ static int tv_ops_check(struct st20_tx_ops* ops) {
       }
     }
   } else if (ops->type == ST20_TYPE_RTP_LEVEL) {
-    if (ops->rtp_ring_size <= 0) {
+    if (ops->flags & ST20_TX_FLAG_ENABLE_CRC) {
+      err("%s, crc only for frame type\n", __func__);
+      return -EINVAL;
+    }
+    /* no rtp ring for replay, the lib feeds the pkts from the capture */
+    if (!ops->replay_url && (ops->rtp_ring_size <= 0)) {
       err("%s, invalid rtp_ring_size %d\n", __func__, ops->rtp_ring_size);
       return -EINVAL;
     }
@@ -2663,17 +3600,51 @@ static int tv_ops_check(struct st20_tx_ops* ops) {
       err("%s, invalid rtp_pkt_size %d\n", __func__, ops->rtp_pkt_size);
       return -EINVAL;
     }
-    if (!ops->notify_rtp_done) {
+    if (!ops->replay_url && !ops->notify_rtp_done) {
       err("%s, pls set notify_rtp_done\n", __func__);
       return -EINVAL;
     }
   }
 
+  if (ops->flags & ST20_TX_FLAG_PORT_STRIPE) {
+    if ((ops->type != ST20_TYPE_FRAME_LEVEL) || (num_ports != 2)) {
+      err("%s, stripe only over the P/R pair of frame type, type %d ports %d\n",
+          __func__, ops->type, num_ports);
+      return -EINVAL;
+    }
+  }
+
+  if (ops->replay_url && (ops->type != ST20_TYPE_RTP_LEVEL)) {
+    err("%s, replay only for rtp type, type %d\n", __func__, ops->type);
+    return -EINVAL;
+  }
+
   if (!st_is_valid_payload_type(ops->payload_type)) {
     err("%s, invalid payload_type %d\n", __func__, ops->payload_type);
     return -EINVAL;
   }
 
+  if (ops->fec_cols || ops->fec_rows) {
+    if (!st20_is_frame_type(ops->type)) {
+      err("%s, fec only for frame type, type %d\n", __func__, ops->type);
+      return -EINVAL;
+    }
+    if (num_ports > 1) {
+      err("%s, fec not support redundant ports\n", __func__);
+      return -EINVAL;
+    }
+    if ((ops->fec_cols > ST20_FEC_MAX_DIM) || (ops->fec_rows > ST20_FEC_MAX_DIM) ||
+        ((ops->fec_cols <= 1) && (ops->fec_rows <= 1))) {
+      err("%s, invalid fec matrix %ux%u\n", __func__, ops->fec_cols, ops->fec_rows);
+      return -EINVAL;
+    }
+    if (!st_is_valid_payload_type(ops->fec_payload_type) ||
+        (ops->fec_payload_type == ops->payload_type)) {
+      err("%s, invalid fec_payload_type %d\n", __func__, ops->fec_payload_type);
+      return -EINVAL;
+    }
+  }
+
   return 0;
 }
 
@@ -2777,13 +3748,15 @@ st20_tx_handle st20_tx_create(mtl_handle mt, struct st20_tx_ops* ops) {
     }
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  /* sch lcore and session memory local to the port */
+  int socket = mt_port_socket_id(impl, ops->port[MTL_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
   }
 
-  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -3025,6 +3998,44 @@ int st20_tx_put_mbuf(st20_tx_handle handle, void* mbuf, uint16_t len) {
   return 0;
 }
 
+uint16_t st20_tx_get_mbufs(st20_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_tx_video_session_handle_impl* s_impl = handle;
+  struct st_tx_video_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_TX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_tx_get_mbufs(s->mbuf_mempool_chain, s->packet_ring, bufs, nb);
+}
+
+uint16_t st20_tx_put_mbufs(st20_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st_tx_video_session_handle_impl* s_impl = handle;
+  struct st_tx_video_session_impl* s;
+
+  if (s_impl->type != MT_HANDLE_TX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  return mt_rtp_tx_put_mbufs(s->packet_ring, bufs, nb, s->rtp_pkt_max_size);
+}
+
 int st20_tx_get_sch_idx(st20_tx_handle handle) {
   struct st_tx_video_session_handle_impl* s_impl = handle;
 
@@ -3117,13 +4128,15 @@ st22_tx_handle st22_tx_create(mtl_handle mt, struct st22_tx_ops* ops) {
     quota_mbs *= ops->num_port;
   }
 
-  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), mt_socket_id(impl, MTL_PORT_P));
+  /* sch lcore and session memory local to the port */
+  int socket = mt_port_socket_id(impl, ops->port[MTL_PORT_P]);
+  s_impl = mt_rte_zmalloc_socket(sizeof(*s_impl), socket);
   if (!s_impl) {
     err("%s, s_impl malloc fail\n", __func__);
     return NULL;
   }
 
-  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL);
+  sch = mt_sch_get(impl, quota_mbs, MT_SCH_TYPE_DEFAULT, MT_SCH_MASK_ALL, socket);
   if (!sch) {
     mt_rte_free(s_impl);
     err("%s, get sch fail\n", __func__);
@@ -3327,6 +4340,44 @@ int st22_tx_put_mbuf(st22_tx_handle handle, void* mbuf, uint16_t len) {
   return 0;
 }
 
+uint16_t st22_tx_get_mbufs(st22_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st22_tx_video_session_handle_impl* s_impl = handle;
+  struct st_tx_video_session_impl* s;
+
+  if (s_impl->type != MT_ST22_HANDLE_TX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    return 0;
+  }
+
+  return mt_rtp_tx_get_mbufs(s->mbuf_mempool_chain, s->packet_ring, bufs, nb);
+}
+
+uint16_t st22_tx_put_mbufs(st22_tx_handle handle, struct st_rtp_buf* bufs, uint16_t nb) {
+  struct st22_tx_video_session_handle_impl* s_impl = handle;
+  struct st_tx_video_session_impl* s;
+
+  if (s_impl->type != MT_ST22_HANDLE_TX_VIDEO) {
+    err("%s, invalid type %d\n", __func__, s_impl->type);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  s = s_impl->impl;
+  if (!s->packet_ring) {
+    err("%s(%d), packet ring is not created\n", __func__, s->idx);
+    mt_rtp_free_mbufs(bufs, nb);
+    return 0;
+  }
+
+  return mt_rtp_tx_put_mbufs(s->packet_ring, bufs, nb, s->rtp_pkt_max_size);
+}
+
 int st22_tx_get_sch_idx(st22_tx_handle handle) {
   struct st22_tx_video_session_handle_impl* s_impl = handle;
 
@@ -0,0 +1,414 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#include "st_video_replay.h"
+
+#ifndef WINDOWSENV
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../mt_log.h"
+
+#define ST_PCAP_MAGIC_US (0xa1b2c3d4)
+#define ST_PCAP_MAGIC_NS (0xa1b23c4d)
+#define ST_PCAP_FILE_HDR_LEN (24)
+#define ST_PCAP_PKT_HDR_LEN (16)
+#define ST_PCAP_LINKTYPE_ETHERNET (1)
+
+#define ST_PCAPNG_BLOCK_SHB (0x0a0d0d0a)
+#define ST_PCAPNG_BLOCK_IDB (0x00000001)
+#define ST_PCAPNG_BLOCK_EPB (0x00000006)
+#define ST_PCAPNG_BYTE_ORDER_MAGIC (0x1a2b3c4d)
+#define ST_PCAPNG_OPT_END (0)
+#define ST_PCAPNG_OPT_TSRESOL (9)
+#define ST_PCAPNG_MAX_IF (16)
+
+/* idle gaps in the capture are cut to this, the transmitter only waits within 1s */
+#define ST_REPLAY_MAX_GAP_NS (NS_PER_S / 10)
+
+struct st_replay_parser {
+  struct st_tx_video_replay* replay;
+  const uint8_t* addr;
+  size_t size;
+  bool swap; /* capture in the other byte order */
+  uint16_t udp_port;
+  uint16_t max_len;
+  uint16_t speed;
+  int idx;
+
+  /* the flow to replay, locked by the first matched pkt */
+  bool flow_locked;
+  uint32_t flow_ip;
+  uint16_t flow_port;
+
+  /* pcapng interfaces of current section */
+  int nb_if;
+  uint16_t if_link[ST_PCAPNG_MAX_IF];
+  uint64_t if_units[ST_PCAPNG_MAX_IF]; /* timestamp units per second */
+
+  uint32_t nb_pkts;
+  uint32_t skipped;
+  uint64_t last_ts_ns; /* capture time of the last indexed pkt */
+  uint64_t time_ns;    /* send time of the last indexed pkt, speed applied */
+
+  /* rtp seq and timestamp of the flow, for the advance of one pass */
+  uint32_t first_seq;
+  uint32_t last_seq;
+  uint32_t first_tmstamp;
+  uint32_t last_tmstamp;
+  uint32_t tmstamp_step; /* the first timestamp change, one frame time */
+};
+
+static inline uint16_t rp_u16(struct st_replay_parser* p, const uint8_t* addr) {
+  uint16_t v;
+
+  memcpy(&v, addr, sizeof(v));
+  return p->swap ? rte_bswap16(v) : v;
+}
+
+static inline uint32_t rp_u32(struct st_replay_parser* p, const uint8_t* addr) {
+  uint32_t v;
+
+  memcpy(&v, addr, sizeof(v));
+  return p->swap ? rte_bswap32(v) : v;
+}
+
+static inline uint16_t rp_be16(const uint8_t* addr) {
+  uint16_t v;
+
+  memcpy(&v, addr, sizeof(v));
+  return ntohs(v);
+}
+
+static uint64_t rp_units_to_ns(uint64_t ts, uint64_t units) {
+  return ts / units * NS_PER_S + ts % units * NS_PER_S / units;
+}
+
+static void rp_add_frame(struct st_replay_parser* p, const uint8_t* frame, uint32_t len,
+                         uint64_t ts_ns) {
+  size_t l2 = sizeof(struct rte_ether_hdr);
+  uint16_t ether_type;
+  const uint8_t* ip;
+  const uint8_t* udp;
+  size_t ihl;
+  uint16_t dst_port, dgram_len, rtp_len;
+  uint32_t dst_ip;
+
+  if (len < l2) return;
+  ether_type = rp_be16(frame + l2 - 2);
+  if (ether_type == RTE_ETHER_TYPE_VLAN) { /* one vlan tag */
+    l2 += sizeof(struct rte_vlan_hdr);
+    if (len < l2) return;
+    ether_type = rp_be16(frame + l2 - 2);
+  }
+  if (ether_type != RTE_ETHER_TYPE_IPV4) return;
+  if (len < l2 + sizeof(struct rte_ipv4_hdr)) return;
+
+  ip = frame + l2;
+  ihl = (ip[0] & 0xf) * 4;
+  if (((ip[0] >> 4) != 4) || (ihl < sizeof(struct rte_ipv4_hdr))) return;
+  if (ip[9] != IPPROTO_UDP) return;
+  /* no reassembly for the fragments */
+  if (rp_be16(ip + 6) & (RTE_IPV4_HDR_MF_FLAG | RTE_IPV4_HDR_OFFSET_MASK)) return;
+  if (len < l2 + ihl + sizeof(struct rte_udp_hdr)) return;
+
+  udp = ip + ihl;
+  dst_port = rp_be16(udp + 2);
+  if (p->udp_port && (dst_port != p->udp_port)) return;
+  memcpy(&dst_ip, ip + 16, sizeof(dst_ip));
+  if (!p->flow_locked) {
+    p->flow_locked = true;
+    p->flow_ip = dst_ip;
+    p->flow_port = dst_port;
+  } else if ((dst_ip != p->flow_ip) || (dst_port != p->flow_port)) {
+    return;
+  }
+
+  dgram_len = rp_be16(udp + 4);
+  if ((dgram_len < sizeof(struct rte_udp_hdr)) || (l2 + ihl + dgram_len > len)) {
+    p->skipped++; /* truncated by the snaplen */
+    return;
+  }
+  rtp_len = dgram_len - sizeof(struct rte_udp_hdr);
+  /* a st2110-20 flow, the rfc4175 hdr is rewritten in the hdr mbuf */
+  if ((rtp_len < sizeof(struct st20_rfc4175_rtp_hdr)) || (rtp_len > p->max_len)) {
+    p->skipped++;
+    return;
+  }
+
+  const struct st20_rfc4175_rtp_hdr* rtp =
+      (const struct st20_rfc4175_rtp_hdr*)(udp + sizeof(struct rte_udp_hdr));
+  uint32_t seq =
+      ((uint32_t)ntohs(rtp->seq_number_ext) << 16) | ntohs(rtp->base.seq_number);
+  uint32_t tmstamp = ntohl(rtp->base.tmstamp);
+  if (!p->nb_pkts) {
+    p->first_seq = seq;
+    p->first_tmstamp = tmstamp;
+  } else if (!p->tmstamp_step && (tmstamp != p->last_tmstamp)) {
+    p->tmstamp_step = tmstamp - p->last_tmstamp;
+  }
+  p->last_seq = seq;
+  p->last_tmstamp = tmstamp;
+
+  if (p->nb_pkts) {
+    uint64_t gap = (ts_ns > p->last_ts_ns) ? (ts_ns - p->last_ts_ns) : 0;
+    gap = gap * 100 / p->speed;
+    p->time_ns += RTE_MIN(gap, ST_REPLAY_MAX_GAP_NS);
+  }
+  p->last_ts_ns = ts_ns;
+
+  if (p->replay->pkts) {
+    struct st_tx_video_replay_pkt* pkt = &p->replay->pkts[p->nb_pkts];
+    pkt->offset = udp + sizeof(struct rte_udp_hdr) - p->addr;
+    pkt->len = rtp_len;
+    pkt->time_ns = p->time_ns;
+  }
+  p->nb_pkts++;
+}
+
+static int rp_parse_pcap(struct st_replay_parser* p, bool ns) {
+  size_t offset = ST_PCAP_FILE_HDR_LEN;
+  uint32_t link = rp_u32(p, p->addr + 20);
+  const uint8_t* hdr;
+  uint32_t cap_len;
+  uint64_t ts_ns;
+
+  if (link != ST_PCAP_LINKTYPE_ETHERNET) {
+    err("%s(%d), not support link type %u\n", __func__, p->idx, link);
+    return -ENOTSUP;
+  }
+
+  while (offset + ST_PCAP_PKT_HDR_LEN <= p->size) {
+    hdr = p->addr + offset;
+    cap_len = rp_u32(p, hdr + 8);
+    offset += ST_PCAP_PKT_HDR_LEN;
+    if (offset + cap_len > p->size) {
+      warn("%s(%d), truncated pkt at %" PRIu64 "\n", __func__, p->idx, (uint64_t)offset);
+      break;
+    }
+    ts_ns = (uint64_t)rp_u32(p, hdr) * NS_PER_S;
+    ts_ns += (uint64_t)rp_u32(p, hdr + 4) * (ns ? 1 : NS_PER_US);
+    rp_add_frame(p, hdr + ST_PCAP_PKT_HDR_LEN, cap_len, ts_ns);
+    offset += cap_len;
+  }
+
+  return 0;
+}
+
+static void rp_pcapng_idb(struct st_replay_parser* p, const uint8_t* block,
+                          uint32_t block_len) {
+  size_t offset = 16; /* type, len, link, reserved, snaplen */
+  uint64_t units = 1000 * 1000; /* default 10^-6 */
+  uint16_t code, len;
+
+  if (p->nb_if >= ST_PCAPNG_MAX_IF) {
+    warn("%s(%d), too many interfaces, ignore the left\n", __func__, p->idx);
+    p->nb_if++;
+    return;
+  }
+
+  while (offset + 4 <= block_len - 4) {
+    code = rp_u16(p, block + offset);
+    len = rp_u16(p, block + offset + 2);
+    if (code == ST_PCAPNG_OPT_END) break;
+    if ((code == ST_PCAPNG_OPT_TSRESOL) && (len >= 1)) {
+      uint8_t resol = block[offset + 4];
+      if (resol & 0x80) {
+        units = 1ULL << RTE_MIN(resol & 0x7f, 63);
+      } else {
+        units = 1;
+        for (int i = 0; i < RTE_MIN(resol, 19); i++) units *= 10;
+      }
+    }
+    offset += 4 + RTE_ALIGN_CEIL(len, 4);
+  }
+
+  p->if_link[p->nb_if] = rp_u16(p, block + 8);
+  p->if_units[p->nb_if] = units;
+  p->nb_if++;
+}
+
+static int rp_parse_pcapng(struct st_replay_parser* p) {
+  size_t offset = 0;
+  const uint8_t* block;
+  uint32_t type, block_len, if_id, cap_len, magic;
+  uint64_t ts;
+
+  while (offset + 12 <= p->size) {
+    block = p->addr + offset;
+    type = rp_u32(p, block);
+    if (type == ST_PCAPNG_BLOCK_SHB) { /* new section, may change the byte order */
+      memcpy(&magic, block + 8, sizeof(magic));
+      if (magic == ST_PCAPNG_BYTE_ORDER_MAGIC) {
+        p->swap = false;
+      } else if (rte_bswap32(magic) == ST_PCAPNG_BYTE_ORDER_MAGIC) {
+        p->swap = true;
+      } else {
+        err("%s(%d), invalid byte order magic 0x%x\n", __func__, p->idx, magic);
+        return -EINVAL;
+      }
+      p->nb_if = 0;
+    }
+    block_len = rp_u32(p, block + 4);
+    if ((block_len < 12) || (offset + block_len > p->size)) {
+      warn("%s(%d), truncated block at %" PRIu64 "\n", __func__, p->idx,
+           (uint64_t)offset);
+      break;
+    }
+
+    if ((type == ST_PCAPNG_BLOCK_IDB) && (block_len >= 20)) {
+      rp_pcapng_idb(p, block, block_len);
+    } else if ((type == ST_PCAPNG_BLOCK_EPB) && (block_len >= 32)) {
+      if_id = rp_u32(p, block + 8);
+      cap_len = rp_u32(p, block + 20);
+      if ((if_id < RTE_MIN(p->nb_if, ST_PCAPNG_MAX_IF)) &&
+          (p->if_link[if_id] == ST_PCAP_LINKTYPE_ETHERNET) &&
+          ((uint64_t)cap_len + 28 <= block_len)) {
+        ts = ((uint64_t)rp_u32(p, block + 12) << 32) | rp_u32(p, block + 16);
+        rp_add_frame(p, block + 28, cap_len, rp_units_to_ns(ts, p->if_units[if_id]));
+      }
+    }
+    offset += block_len;
+  }
+
+  return 0;
+}
+
+static int rp_parse(struct st_replay_parser* p) {
+  uint32_t magic;
+
+  memcpy(&magic, p->addr, sizeof(magic));
+  if ((magic == ST_PCAP_MAGIC_US) || (magic == ST_PCAP_MAGIC_NS))
+    return rp_parse_pcap(p, magic == ST_PCAP_MAGIC_NS);
+  magic = rte_bswap32(magic);
+  if ((magic == ST_PCAP_MAGIC_US) || (magic == ST_PCAP_MAGIC_NS)) {
+    p->swap = true;
+    return rp_parse_pcap(p, magic == ST_PCAP_MAGIC_NS);
+  }
+  if (magic == ST_PCAPNG_BLOCK_SHB) return rp_parse_pcapng(p);
+
+  err("%s(%d), unknown file magic 0x%x\n", __func__, p->idx, magic);
+  return -EINVAL;
+}
+
+#ifndef WINDOWSENV
+/* private mapping at an aligned va, the tail after the file is anonymous memory */
+static void* rp_map(int fd, size_t size, size_t map_size, size_t align) {
+  uint8_t* va;
+  uint8_t* addr;
+  void* ret;
+
+  va = mmap(NULL, map_size + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0);
+  if (va == MAP_FAILED) return MAP_FAILED;
+  addr = RTE_PTR_ALIGN_CEIL(va, align);
+  if (addr > va) munmap(va, addr - va);
+  munmap(addr + map_size, va + align - addr);
+
+  /* writable for the dma pin, never written as the pkts are rewritten in the hdr */
+  ret = mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_POPULATE,
+             fd, 0);
+  if (ret == MAP_FAILED) {
+    munmap(addr, map_size);
+    return MAP_FAILED;
+  }
+  return addr;
+}
+
+int st_video_replay_open(struct st_tx_video_replay* replay, const char* url,
+                         uint16_t udp_port, uint16_t speed, uint16_t max_len,
+                         size_t map_align, uint32_t frame_tmstamp, int idx) {
+  struct st_replay_parser p;
+  struct stat i;
+  void* addr;
+  int fd, ret;
+
+  fd = open(url, O_RDONLY);
+  if (fd < 0) {
+    err("%s(%d), open %s fail\n", __func__, idx, url);
+    return -EIO;
+  }
+  if ((fstat(fd, &i) < 0) || (i.st_size <= ST_PCAP_FILE_HDR_LEN)) {
+    err("%s(%d), invalid file %s\n", __func__, idx, url);
+    close(fd);
+    return -EINVAL;
+  }
+  /* populate all pages, no fault on the tasklet */
+  replay->map_size = RTE_ALIGN_CEIL((size_t)i.st_size, map_align);
+  addr = rp_map(fd, i.st_size, replay->map_size, map_align);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    err("%s(%d), mmap %s fail\n", __func__, idx, url);
+    return -EIO;
+  }
+  replay->addr = addr;
+  replay->size = i.st_size;
+  replay->iova = MTL_BAD_IOVA;
+
+  /* two passes, count the pkts then fill the index */
+  for (int pass = 0; pass < 2; pass++) {
+    memset(&p, 0, sizeof(p));
+    p.replay = replay;
+    p.addr = addr;
+    p.size = replay->size;
+    p.udp_port = udp_port;
+    p.max_len = max_len;
+    p.speed = speed ? speed : 100;
+    p.idx = idx;
+    ret = rp_parse(&p);
+    if (ret < 0) {
+      st_video_replay_close(replay);
+      return ret;
+    }
+    if (!p.nb_pkts) {
+      err("%s(%d), no rtp pkt for udp port %u in %s\n", __func__, idx, udp_port, url);
+      st_video_replay_close(replay);
+      return -EINVAL;
+    }
+    if (replay->pkts) break;
+    replay->pkts = mt_zmalloc(sizeof(*replay->pkts) * p.nb_pkts);
+    if (!replay->pkts) {
+      err("%s(%d), index malloc fail, nb %u\n", __func__, idx, p.nb_pkts);
+      st_video_replay_close(replay);
+      return -ENOMEM;
+    }
+  }
+  replay->nb_pkts = p.nb_pkts;
+  /* next pass starts one mean gap after the last pkt */
+  replay->loop_ns = p.time_ns;
+  if (p.nb_pkts > 1) replay->loop_ns += p.time_ns / (p.nb_pkts - 1);
+  /* next pass continues the seq, and the timestamp one frame after the last */
+  replay->seq_loop = p.last_seq - p.first_seq + 1;
+  if (!p.tmstamp_step) p.tmstamp_step = frame_tmstamp;
+  replay->tmstamp_loop = p.last_tmstamp - p.first_tmstamp + p.tmstamp_step;
+
+  uint8_t* ip = (uint8_t*)&p.flow_ip;
+  info("%s(%d), %s flow %u.%u.%u.%u:%u, pkts %u skipped %u, pass %" PRIu64 "ns\n",
+       __func__, idx, url, ip[0], ip[1], ip[2], ip[3], p.flow_port, p.nb_pkts, p.skipped,
+       replay->loop_ns);
+  return 0;
+}
+
+void st_video_replay_close(struct st_tx_video_replay* replay) {
+  if (replay->pkts) {
+    mt_free(replay->pkts);
+    replay->pkts = NULL;
+  }
+  if (replay->addr) {
+    munmap(replay->addr, replay->map_size);
+    replay->addr = NULL;
+  }
+}
+#else
+int st_video_replay_open(struct st_tx_video_replay* replay, const char* url,
+                         uint16_t udp_port, uint16_t speed, uint16_t max_len,
+                         size_t map_align, uint32_t frame_tmstamp, int idx) {
+  MT_MAY_UNUSED(rp_parse);
+  err("%s(%d), pcap replay not support on this platform\n", __func__, idx);
+  return -ENOTSUP;
+}
+
+void st_video_replay_close(struct st_tx_video_replay* replay) {}
+#endif
@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2023 Intel Corporation
+ */
+
+#ifndef _ST_LIB_VIDEO_REPLAY_HEAD_H_
+#define _ST_LIB_VIDEO_REPLAY_HEAD_H_
+
+#include "st_main.h"
+
+/*
+ * Map the pcap/pcapng capture and index the rtp pkts of one udp flow, the flow with
+ * udp_port as dst port or the first udp flow if udp_port is 0. speed is the percent
+ * of the recorded timing, rtp pkts larger than max_len are skipped. The mapping is
+ * aligned to map_align for the dma map, frame_tmstamp is the timestamp advance of a
+ * capture with only one frame.
+ */
+int st_video_replay_open(struct st_tx_video_replay* replay, const char* url,
+                         uint16_t udp_port, uint16_t speed, uint16_t max_len,
+                         size_t map_align, uint32_t frame_tmstamp, int idx);
+
+void st_video_replay_close(struct st_tx_video_replay* replay);
+
+#endif
@@ -225,7 +225,7 @@ static int udp_uinit_rxq(struct mtl_main_impl* impl, struct mudp_impl* s) {
   if (udp_get_flag(s, MUDP_RX_MCAST_JOINED)) {
     struct sockaddr_in* addr_in = &s->bind_addr;
     uint8_t* ip = (uint8_t*)&addr_in->sin_addr;
-    mt_mcast_leave(impl, mt_ip_to_u32(ip), s->port);
+    mt_mcast_leave(impl, mt_ip_to_u32(ip), 0, s->port);
     udp_clear_flag(s, MUDP_RX_MCAST_JOINED);
   }
 
@@ -278,7 +278,7 @@ static int udp_init_rxq(struct mtl_main_impl* impl, struct mudp_impl* s) {
   s->rx_ring = ring;
 
   if (mt_is_multicast_ip(ip)) {
-    int ret = mt_mcast_join(impl, mt_ip_to_u32(ip), port);
+    int ret = mt_mcast_join(impl, mt_ip_to_u32(ip), 0, port);
     if (ret < 0) {
       err("%s(%d), mcast join fail\n", __func__, idx);
       udp_uinit_rxq(impl, s);
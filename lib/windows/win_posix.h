@@ -122,6 +122,7 @@ typedef rte_cpuset_t cpu_set_t;
 #endif
 #define localtime_r(T, Tm) (localtime_s(Tm, T) ? NULL : Tm)
 int pthread_cond_signal(pthread_cond_t* cv);
+int pthread_cond_broadcast(pthread_cond_t* cv);
 int pthread_cond_init(pthread_cond_t* cv, const pthread_condattr_t* a);
 int pthread_cond_wait(pthread_cond_t* cv, pthread_mutex_t* external_mutex);
 int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex,
@@ -12,7 +12,9 @@ build_ffmpeg(){
     git checkout 4.4
     git reset --hard aa28df74ab197c49a05fecc40c81e0f8ec4ad0c3
     cp -f ../kahawai.c ./libavdevice/
+    cp -f ../kahawai_mux.c ./libavdevice/
     git am --whitespace=fix ../0001-avdevice-kahawai-Add-the-kahawai-input-device-plugin.patch
+    git am --whitespace=fix ../0002-avdevice-kahawai-Add-the-kahawai-output-device-plugin.patch
     ./configure --enable-shared --disable-static --enable-nonfree --enable-pic --enable-gpl --enable-mtl
     make clean
     make -j32
@@ -17,8 +17,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
-#include <mtl/st_convert_api.h>
 #include <mtl/st_pipeline_api.h>
+#include <stdatomic.h>
 
 #include "libavformat/avformat.h"
 #include "libavformat/internal.h"
@@ -55,38 +55,106 @@ typedef struct KahawaiDemuxerContext {
   char* dma_dev;
 
   mtl_handle dev_handle;
+  struct KahawaiRxSession* rx;
+
+  int64_t frame_counter;
+  size_t output_frame_size;
+} KahawaiDemuxerContext;
+
+/*
+ * The rx session, it outlives the demuxer context if FFmpeg still holds some frames
+ * on close, the last frame released frees the session and the device.
+ */
+typedef struct KahawaiRxSession {
   st20p_rx_handle rx_handle;
+  /* one for the demuxer plus one for each frame wrapped in an AVPacket */
+  atomic_int refcnt;
+  /* frames wrapped in the AVPackets and not yet returned to the lib */
+  atomic_int frames_inflight;
 
   pthread_cond_t get_frame_cond;
   pthread_mutex_t get_frame_mutex;
 
-  int64_t frame_counter;
-  struct st_frame* frame;
-  size_t output_frame_size;
-
   /* The below session is for ext frames only */
+  int fb_cnt;
   struct st_ext_frame* ext_frames;
   AVBufferRef** av_buffers;
-  AVBufferRef** av_buffers_keepers;
-  int last_frame_num;
-  struct st_frame* last_frame;
-} KahawaiDemuxerContext;
+} KahawaiRxSession;
+
+typedef struct KahawaiFrameRef {
+  KahawaiRxSession* rx;
+  struct st_frame* frame;
+} KahawaiFrameRef;
 
 static mtl_handle shared_st_handle = NULL;
 static unsigned int active_session_cnt = 0;
+/* the device may be released from the thread which frees the last AVPacket */
+static pthread_mutex_t shared_st_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void kahawai_dev_put(void) {
+  pthread_mutex_lock(&shared_st_mutex);
+  if (--active_session_cnt == 0) {
+    if (shared_st_handle) {
+      mtl_uninit(shared_st_handle);
+      shared_st_handle = NULL;
+      av_log(NULL, AV_LOG_VERBOSE, "mtl_uninit finished\n");
+    } else {
+      av_log(NULL, AV_LOG_ERROR, "missing st_handle\n");
+    }
+  } else {
+    av_log(NULL, AV_LOG_VERBOSE, "no need to do st_uninit yet\n");
+  }
+  pthread_mutex_unlock(&shared_st_mutex);
+}
+
+static void kahawai_rx_put(KahawaiRxSession* rx) {
+  if (atomic_fetch_sub(&rx->refcnt, 1) != 1) return;
+
+  if (rx->rx_handle) {
+    st20p_rx_free(rx->rx_handle);
+    rx->rx_handle = NULL;
+    av_log(NULL, AV_LOG_VERBOSE, "st20p_rx_free finished\n");
+  }
+
+  pthread_mutex_destroy(&rx->get_frame_mutex);
+  pthread_cond_destroy(&rx->get_frame_cond);
+
+  // Destroy device
+  kahawai_dev_put();
+
+  /* the lib receives into the ext frames until st20p_rx_free */
+  if (rx->ext_frames) free(rx->ext_frames);
+  if (rx->av_buffers) {
+    for (int i = 0; i < rx->fb_cnt; ++i) av_buffer_unref(&(rx->av_buffers[i]));
+    free(rx->av_buffers);
+  }
+  av_free(rx);
+}
 
 static int rx_st20p_frame_available(void* priv) {
-  KahawaiDemuxerContext* s = priv;
+  KahawaiRxSession* rx = priv;
 
-  pthread_mutex_lock(&(s->get_frame_mutex));
-  pthread_cond_signal(&(s->get_frame_cond));
-  pthread_mutex_unlock(&(s->get_frame_mutex));
+  pthread_mutex_lock(&(rx->get_frame_mutex));
+  pthread_cond_signal(&(rx->get_frame_cond));
+  pthread_mutex_unlock(&(rx->get_frame_mutex));
 
   return 0;
 }
 
+/* AVBufferRef free callback, return the frame to the lib once FFmpeg is done with it */
+static void kahawai_frame_free(void* opaque, uint8_t* data) {
+  KahawaiFrameRef* ref = opaque;
+  KahawaiRxSession* rx = ref->rx;
+
+  st20p_rx_put_frame(rx->rx_handle, ref->frame);
+  atomic_fetch_sub(&rx->frames_inflight, 1);
+  av_free(ref);
+  kahawai_rx_put(rx);
+}
+
 static int kahawai_read_header(AVFormatContext* ctx) {
   KahawaiDemuxerContext* s = ctx->priv_data;
+  KahawaiRxSession* rx = NULL;
 
   AVStream* st = NULL;
 
@@ -171,12 +239,8 @@ static int kahawai_read_header(AVFormatContext* ctx) {
   }
 
   ops_rx.transport_fmt = ST20_FMT_YUV_422_10BIT;
-
-  if (s->ext_frames_mode) {
-    ops_rx.output_fmt = ST_FRAME_FMT_YUV422PLANAR10LE;
-  } else {
-    ops_rx.output_fmt = ST_FRAME_FMT_YUV422RFC4175PG2BE10;
-  }
+  /* the frames are handed to FFmpeg as is, let the pipeline do the conversion */
+  ops_rx.output_fmt = ST_FRAME_FMT_YUV422PLANAR10LE;
 
   packet_size = av_image_get_buffer_size(pix_fmt, s->width, s->height, 1);
   if (packet_size < 0) {
@@ -226,9 +290,11 @@ static int kahawai_read_header(AVFormatContext* ctx) {
       av_rescale_q(ctx->packet_size, (AVRational){8, 1}, st->time_base);
 
   // Create device
+  pthread_mutex_lock(&shared_st_mutex);
   if (!shared_st_handle) {
     s->dev_handle = mtl_init(&param);
     if (!s->dev_handle) {
+      pthread_mutex_unlock(&shared_st_mutex);
       av_log(ctx, AV_LOG_ERROR, "mtl_init failed\n");
       return AVERROR(EIO);
     }
@@ -241,91 +307,80 @@ static int kahawai_read_header(AVFormatContext* ctx) {
            (unsigned long)shared_st_handle);
   }
   ++active_session_cnt;
+  pthread_mutex_unlock(&shared_st_mutex);
+
+  /* the device is released with the session from now on */
+  rx = av_mallocz(sizeof(*rx));
+  if (!rx) {
+    kahawai_dev_put();
+    s->dev_handle = NULL;
+    return AVERROR(ENOMEM);
+  }
+  atomic_init(&rx->refcnt, 1);
+  atomic_init(&rx->frames_inflight, 0);
+  pthread_mutex_init(&(rx->get_frame_mutex), NULL);
+  pthread_cond_init(&(rx->get_frame_cond), NULL);
+  rx->fb_cnt = s->fb_cnt;
+  s->rx = rx;
 
   ops_rx.name = "st20p";
-  ops_rx.priv = s;                 // Handle of priv_data registered to lib
+  ops_rx.priv = rx;                // Handle of the rx session registered to lib
   ops_rx.port.payload_type = 112;  // RX_ST20_PAYLOAD_TYPE
   ops_rx.device = ST_PLUGIN_DEVICE_AUTO;
   ops_rx.notify_frame_available = rx_st20p_frame_available;
   ops_rx.framebuff_cnt = s->fb_cnt;
 
   if (s->ext_frames_mode) {
-    s->ext_frames = malloc(sizeof(struct st_ext_frame) * s->fb_cnt);
-    if (!s->ext_frames) {
+    rx->ext_frames = malloc(sizeof(struct st_ext_frame) * s->fb_cnt);
+    if (!rx->ext_frames) {
       av_log(ctx, AV_LOG_ERROR, "Allocation of ext_frames failed\n");
       return AVERROR(ENOMEM);
     }
-    memset(s->ext_frames, 0, sizeof(struct st_ext_frame) * s->fb_cnt);
+    memset(rx->ext_frames, 0, sizeof(struct st_ext_frame) * s->fb_cnt);
 
-    s->av_buffers = malloc(sizeof(AVBufferRef*) * s->fb_cnt);
-    if (!s->av_buffers) {
+    rx->av_buffers = malloc(sizeof(AVBufferRef*) * s->fb_cnt);
+    if (!rx->av_buffers) {
       av_log(ctx, AV_LOG_ERROR, "Allocation of av_buffers failed\n");
       return AVERROR(ENOMEM);
     }
     for (int i = 0; i < s->fb_cnt; ++i) {
-      s->av_buffers[i] = NULL;
+      rx->av_buffers[i] = NULL;
     }
 
-    s->av_buffers_keepers = malloc(sizeof(AVBufferRef*) * s->fb_cnt);
-    if (!s->av_buffers_keepers) {
-      av_log(ctx, AV_LOG_ERROR, "Allocation of av_buffers_keepers failed\n");
-      return AVERROR(ENOMEM);
-    }
     for (int i = 0; i < s->fb_cnt; ++i) {
-      s->av_buffers_keepers[i] = NULL;
-    }
-
-    for (int i = 0; i < s->fb_cnt; ++i) {
-      s->av_buffers[i] = av_buffer_allocz(ctx->packet_size);
-      if (!s->av_buffers[i]) {
+      rx->av_buffers[i] = av_buffer_allocz(ctx->packet_size);
+      if (!rx->av_buffers[i]) {
         av_log(ctx, AV_LOG_ERROR, "av_buffer_allocz failed\n");
         return AVERROR(ENOMEM);
       }
 
-      s->av_buffers_keepers[i] = av_buffer_ref(s->av_buffers[i]);
-      if (!s->av_buffers_keepers[i]) {
-        av_log(ctx, AV_LOG_ERROR, "av_buffer_ref failed\n");
-
-        for (int j = 0; j < i; ++j) {
-          av_buffer_unref(&s->av_buffers_keepers[j]);
-          av_buffer_unref(&s->av_buffers[j]);
-        }
-        av_buffer_unref(&s->av_buffers[i]);
-      }
-
-      s->ext_frames[i].addr[0] = s->av_buffers[i]->data;
-      s->ext_frames[i].linesize[0] = s->width * 2;
-      s->ext_frames[i].addr[1] =
-          (void*)((unsigned long)s->ext_frames[i].addr[0] + (s->width * s->height * 2));
-      s->ext_frames[i].linesize[1] = s->width;
-      s->ext_frames[i].addr[2] =
-          (void*)((unsigned long)s->ext_frames[i].addr[1] + (s->width * s->height));
-      s->ext_frames[i].linesize[2] = s->width;
-      s->ext_frames[i].size = ctx->packet_size;
+      rx->ext_frames[i].addr[0] = rx->av_buffers[i]->data;
+      rx->ext_frames[i].linesize[0] = s->width * 2;
+      rx->ext_frames[i].addr[1] =
+          (void*)((unsigned long)rx->ext_frames[i].addr[0] + (s->width * s->height * 2));
+      rx->ext_frames[i].linesize[1] = s->width;
+      rx->ext_frames[i].addr[2] =
+          (void*)((unsigned long)rx->ext_frames[i].addr[1] + (s->width * s->height));
+      rx->ext_frames[i].linesize[2] = s->width;
+      rx->ext_frames[i].size = ctx->packet_size;
 
       av_log(ctx, AV_LOG_VERBOSE, "Allocated Framebuf[%d]: 0x%lx\n", i,
-             (unsigned long)s->av_buffers[i]->data);
+             (unsigned long)rx->av_buffers[i]->data);
     }
-    ops_rx.ext_frames = s->ext_frames;
-  } else {
-    s->ext_frames = NULL;
-    s->av_buffers = s->av_buffers_keepers = NULL;
+    ops_rx.ext_frames = rx->ext_frames;
   }
 
-  pthread_mutex_init(&(s->get_frame_mutex), NULL);
-  pthread_cond_init(&(s->get_frame_cond), NULL);
-
   av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_create st_handle 0x%lx\n",
          (unsigned long)s->dev_handle);
   av_log(ctx, AV_LOG_VERBOSE, "udp_port %d\n", s->udp_port);
 
-  s->rx_handle = st20p_rx_create(s->dev_handle, &ops_rx);
-  if (!s->rx_handle) {
+  rx->rx_handle = st20p_rx_create(s->dev_handle, &ops_rx);
+  if (!rx->rx_handle) {
     av_log(ctx, AV_LOG_ERROR, "st20p_rx_create failed\n");
     return AVERROR(EIO);
   }
 
-  s->output_frame_size = st20p_rx_frame_size(s->rx_handle);
+  s->output_frame_size = st20p_rx_frame_size(rx->rx_handle);
   if (s->output_frame_size <= 0) {
     av_log(ctx, AV_LOG_ERROR, "st20p_rx_frame_size failed\n");
     return AVERROR(EINVAL);
@@ -334,113 +389,79 @@ static int kahawai_read_header(AVFormatContext* ctx) {
   av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_create finished\n");
 
   s->frame_counter = 0;
-  s->frame = NULL;
-  s->last_frame_num = -1;
-  s->last_frame = NULL;
 
   return 0;
 }
 
 static int kahawai_read_packet(AVFormatContext* ctx, AVPacket* pkt) {
   KahawaiDemuxerContext* s = ctx->priv_data;
-  int frame_num = 0;
+  KahawaiRxSession* rx = s->rx;
+  struct st_frame* frame;
+  KahawaiFrameRef* ref;
   int ret = 0;
 
   av_log(ctx, AV_LOG_VERBOSE, "kahawai_read_packet triggered\n");
 
-  if (s->ext_frames_mode) {
-    if (s->last_frame) {
-      av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_put_frame: 0x%lx\n",
-             (unsigned long)(s->last_frame->addr[0]));
-      st20p_rx_put_frame(s->rx_handle, s->last_frame);
-      s->last_frame = NULL;
-
-      if ((s->last_frame_num >= 0) && (s->last_frame_num < s->fb_cnt)) {
-        s->av_buffers[s->last_frame_num] =
-            av_buffer_ref(s->av_buffers_keepers[s->last_frame_num]);
-        if (!s->av_buffers[s->last_frame_num]) {
-          av_log(ctx, AV_LOG_ERROR, "av_buffer_ref failed\n");
-          return AVERROR(ENOMEM);
-        }
-      }
-    }
-  }
-
-  s->frame = st20p_rx_get_frame(s->rx_handle);
-  if (!s->frame) {
-    pthread_mutex_lock(&(s->get_frame_mutex));
-    pthread_cond_wait(&(s->get_frame_cond), &(s->get_frame_mutex));
-    pthread_mutex_unlock(&(s->get_frame_mutex));
+  frame = st20p_rx_get_frame(rx->rx_handle);
+  if (!frame) {
+    pthread_mutex_lock(&(rx->get_frame_mutex));
+    pthread_cond_wait(&(rx->get_frame_cond), &(rx->get_frame_mutex));
+    pthread_mutex_unlock(&(rx->get_frame_mutex));
 
-    s->frame = st20p_rx_get_frame(s->rx_handle);
-    if (!s->frame) {
+    frame = st20p_rx_get_frame(rx->rx_handle);
+    if (!frame) {
       av_log(ctx, AV_LOG_ERROR, "st20p_rx_get_frame failed\n");
       return AVERROR(EIO);
     }
   }
   av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_get_frame: 0x%lx\n",
-         (unsigned long)(s->frame->addr[0]));
+         (unsigned long)(frame->addr[0]));
 
-  if (s->ext_frames_mode) {
-    s->last_frame = s->frame;
-  }
-
-  if (s->frame->data_size != s->output_frame_size) {
+  if (frame->data_size != s->output_frame_size) {
     av_log(ctx, AV_LOG_ERROR, "Unexpected frame size received: %lu (%lu expected)\n",
-           s->frame->data_size, s->output_frame_size);
-    // s->stopped = true;
-    // pthread_mutex_unlock(&(s->read_packet_mutex));
+           frame->data_size, s->output_frame_size);
+    st20p_rx_put_frame(rx->rx_handle, frame);
     return AVERROR(EIO);
   }
 
-  if (s->ext_frames_mode) {
-    while (frame_num < s->fb_cnt) {
-      av_log(ctx, AV_LOG_VERBOSE, "Checked Framebuf[%d]: 0x%lx\n", frame_num,
-             (unsigned long)s->av_buffers[frame_num]->data);
-      if (s->av_buffers[frame_num]->data == s->frame->addr[0]) {
-        break;
-      }
-      ++frame_num;
-    }
-
-    if (frame_num >= s->fb_cnt) {
-      av_log(ctx, AV_LOG_ERROR, "Failed to match the received frame\n");
-      return AVERROR(EIO);
-    }
-    s->last_frame_num = frame_num;
-
-    pkt->buf = s->av_buffers[frame_num];
-    pkt->data = s->av_buffers[frame_num]->data;
-    pkt->size = s->av_buffers[frame_num]->size;
-    av_log(ctx, AV_LOG_DEBUG, "pkt data 0x%lx size %d data[0]=%u\n",
-           (unsigned long)pkt->data, pkt->size, pkt->data[0]);
-  } else {
+  /*
+   * Always keep one frame for the lib to receive into, same as the v4l2 indev,
+   * copy the frame if all the others are still held by FFmpeg.
+   */
+  if (atomic_load(&rx->frames_inflight) + 1 >= rx->fb_cnt) {
     ret = av_new_packet(pkt, ctx->packet_size);
     if (ret != 0) {
       av_log(ctx, AV_LOG_ERROR, "av_new_packet failed with %d\n", ret);
-      // s->stopped = true;
-      // pthread_mutex_unlock(&(s->read_packet_mutex));
+      st20p_rx_put_frame(rx->rx_handle, frame);
       return ret;
     }
-
-    ret = st20_rfc4175_422be10_to_yuv422p10le(
-        (struct st20_rfc4175_422_10_pg2_be*)(s->frame->addr[0]), (uint16_t*)pkt->data,
-        (uint16_t*)(pkt->data + (s->width * s->height * 2)),
-        (uint16_t*)(pkt->data + (s->width * s->height * 3)), s->width, s->height);
-    if (ret != 0) {
-      av_log(ctx, AV_LOG_ERROR, "st20_rfc4175_422be10_to_yuv422p10le failed with %d\n",
-             ret);
-      // s->stopped = true;
-      // pthread_mutex_unlock(&(s->read_packet_mutex));
-      return ret;
+    memcpy(pkt->data, frame->addr[0], ctx->packet_size);
+    st20p_rx_put_frame(rx->rx_handle, frame);
+    av_log(ctx, AV_LOG_VERBOSE, "Copied frame as %d frames in flight\n",
+           atomic_load(&rx->frames_inflight));
+  } else {
+    ref = av_malloc(sizeof(*ref));
+    if (!ref) {
+      st20p_rx_put_frame(rx->rx_handle, frame);
+      return AVERROR(ENOMEM);
     }
-    st20p_rx_put_frame(s->rx_handle, s->frame);
-    av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_put_frame: 0x%lx\n",
-           (unsigned long)(s->frame->addr[0]));
-    // pthread_mutex_unlock(&(s->read_packet_mutex));
+    ref->rx = rx;
+    ref->frame = frame;
+    pkt->buf = av_buffer_create(frame->addr[0], ctx->packet_size, kahawai_frame_free,
+                                ref, 0);
+    if (!pkt->buf) {
+      av_log(ctx, AV_LOG_ERROR, "av_buffer_create failed\n");
+      av_free(ref);
+      st20p_rx_put_frame(rx->rx_handle, frame);
+      return AVERROR(ENOMEM);
+    }
+    atomic_fetch_add(&rx->refcnt, 1);
+    atomic_fetch_add(&rx->frames_inflight, 1);
+    pkt->data = frame->addr[0];
+    pkt->size = ctx->packet_size;
   }
+
   pkt->pts = pkt->dts = s->frame_counter++;
-  s->frame = NULL;
   av_log(ctx, AV_LOG_VERBOSE, "Got POC %ld\n", pkt->pts);
 
   return 0;
@@ -448,68 +469,20 @@ static int kahawai_read_packet(AVFormatContext* ctx, AVPacket* pkt) {
 
 static int kahawai_read_close(AVFormatContext* ctx) {
   KahawaiDemuxerContext* s = ctx->priv_data;
+  KahawaiRxSession* rx = s->rx;
 
   av_log(ctx, AV_LOG_VERBOSE, "kahawai_read_close triggered\n");
 
-  if (s->frame) {
-    av_log(ctx, AV_LOG_VERBOSE, "Put a frame: 0x%lx\n",
-           (unsigned long)(s->frame->addr[0]));
-    st20p_rx_put_frame(s->rx_handle, s->frame);
-    s->frame = NULL;
-  }
+  if (!rx) return 0;
 
-  if (s->ext_frames_mode) {
-    if (s->last_frame) {
-      av_log(ctx, AV_LOG_VERBOSE, "Put a frame: 0x%lx\n",
-             (unsigned long)(s->last_frame->addr[0]));
-      st20p_rx_put_frame(s->rx_handle, s->last_frame);
-      s->last_frame = NULL;
-    }
-  }
-  if (s->rx_handle) {
-    st20p_rx_free(s->rx_handle);
-    s->rx_handle = NULL;
-  }
-  av_log(ctx, AV_LOG_VERBOSE, "st20p_rx_free finished\n");
-
-  pthread_mutex_destroy(&s->get_frame_mutex);
-  pthread_cond_destroy(&s->get_frame_cond);
+  /* the frames held by the caller keep the session, freed with the last one */
+  if (atomic_load(&rx->frames_inflight))
+    av_log(ctx, AV_LOG_WARNING, "%d frames are still owned by the caller on close\n",
+           atomic_load(&rx->frames_inflight));
 
-  // Destroy device
-  if (--active_session_cnt == 0) {
-    if (shared_st_handle) {
-      mtl_uninit(shared_st_handle);
-      shared_st_handle = NULL;
-      av_log(ctx, AV_LOG_VERBOSE, "mtl_uninit finished\n");
-    } else {
-      av_log(ctx, AV_LOG_ERROR, "missing st_handle\n");
-    }
-  } else {
-    av_log(ctx, AV_LOG_VERBOSE, "no need to do st_uninit yet\n");
-  }
+  s->rx = NULL;
   s->dev_handle = NULL;
-
-  if (s->ext_frames_mode) {
-    if (s->ext_frames) {
-      free(s->ext_frames);
-      s->ext_frames = NULL;
-    }
-
-    for (int i = 0; i < s->fb_cnt; ++i) {
-      if (i != s->last_frame_num) av_buffer_unref(&(s->av_buffers[i]));
-      av_buffer_unref(&(s->av_buffers_keepers[i]));
-    }
-
-    if (s->av_buffers) {
-      free(s->av_buffers);
-      s->av_buffers = NULL;
-    }
-
-    if (s->av_buffers_keepers) {
-      free(s->av_buffers_keepers);
-      s->av_buffers_keepers = NULL;
-    }
-  }
+  kahawai_rx_put(rx);
 
   return 0;
 }
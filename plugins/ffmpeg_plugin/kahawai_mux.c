@@ -0,0 +1,416 @@
+/*
+ * Kahawai raw video muxer
+ * Copyright (c) 2022 Intel
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <mtl/st_pipeline_api.h>
+#include <stdatomic.h>
+
+#include "libavformat/avformat.h"
+#include "libavformat/internal.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/opt.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
+
+/* max wait time for the in flight frames on close */
+#define KAHAWAI_CLOSE_WAIT_US (1000 * 1000)
+
+typedef struct KahawaiFpsDecs {
+  enum st_fps st_fps;
+  unsigned int min;
+  unsigned int max;
+} KahawaiFpsDecs;
+
+const static KahawaiFpsDecs fps_table[] = {
+    {ST_FPS_P59_94, 5994 - 100, 5994 + 100},    {ST_FPS_P50, 5000 - 100, 5000 + 100},
+    {ST_FPS_P29_97, 2997 - 100, 2997 + 100},    {ST_FPS_P25, 2500 - 100, 2500 + 100},
+    {ST_FPS_P119_88, 11988 - 100, 11988 + 100},
+};
+
+typedef struct KahawaiMuxerContext {
+  const AVClass* class; /**< Class for private options. */
+
+  char* port;
+  char* local_addr;
+  char* dst_addr;
+  int udp_port;
+  int fb_cnt;
+  int session_cnt;
+
+  mtl_handle dev_handle;
+  st20p_tx_handle tx_handle;
+
+  pthread_cond_t get_frame_cond;
+  pthread_mutex_t get_frame_mutex;
+
+  int width;
+  int height;
+  int64_t frame_counter;
+  size_t frame_size;
+  /* AVBufferRefs handed to the lib and not yet released by notify_frame_done */
+  atomic_int frames_inflight;
+} KahawaiMuxerContext;
+
+static mtl_handle shared_st_handle = NULL;
+static unsigned int active_session_cnt = 0;
+
+static int tx_st20p_frame_available(void* priv) {
+  KahawaiMuxerContext* s = priv;
+
+  pthread_mutex_lock(&(s->get_frame_mutex));
+  pthread_cond_signal(&(s->get_frame_cond));
+  pthread_mutex_unlock(&(s->get_frame_mutex));
+
+  return 0;
+}
+
+/* the lib is done with the ext frame, release the AVPacket buffer */
+static int tx_st20p_frame_done(void* priv, struct st_frame* frame) {
+  KahawaiMuxerContext* s = priv;
+  AVBufferRef* buf = frame->opaque;
+
+  if (buf) {
+    frame->opaque = NULL;
+    av_buffer_unref(&buf);
+    atomic_fetch_sub(&s->frames_inflight, 1);
+  }
+
+  return 0;
+}
+
+static int kahawai_write_header(AVFormatContext* ctx) {
+  KahawaiMuxerContext* s = ctx->priv_data;
+  AVStream* st = NULL;
+  AVRational framerate;
+  unsigned int fps = 0;
+  int ret = 0;
+
+  struct mtl_init_params param;
+  struct st20p_tx_ops ops_tx;
+
+  av_log(ctx, AV_LOG_VERBOSE, "kahawai_write_header triggered\n");
+
+  memset(&param, 0, sizeof(param));
+  memset(&ops_tx, 0, sizeof(ops_tx));
+
+  if ((ctx->nb_streams != 1) ||
+      (ctx->streams[0]->codecpar->codec_type != AVMEDIA_TYPE_VIDEO) ||
+      (ctx->streams[0]->codecpar->codec_id != AV_CODEC_ID_RAWVIDEO)) {
+    av_log(ctx, AV_LOG_ERROR, "Only one rawvideo stream is supported\n");
+    return AVERROR(EINVAL);
+  }
+  st = ctx->streams[0];
+
+  if (st->codecpar->format != AV_PIX_FMT_YUV422P10LE) {
+    av_log(ctx, AV_LOG_ERROR, "Only yuv422p10le is supported\n");
+    return AVERROR(EINVAL);
+  }
+
+  if ((NULL == s->port) || (strlen(s->port) > MTL_PORT_MAX_LEN)) {
+    av_log(ctx, AV_LOG_ERROR, "Invalid port info\n");
+    return AVERROR(EINVAL);
+  }
+  param.num_ports = 1;
+  strncpy(param.port[MTL_PORT_P], s->port, MTL_PORT_MAX_LEN);
+  ops_tx.port.num_port = 1;
+  strncpy(ops_tx.port.port[MTL_PORT_P], s->port, MTL_PORT_MAX_LEN);
+
+  if (NULL == s->local_addr) {
+    av_log(ctx, AV_LOG_ERROR, "Invalid local IP address\n");
+    return AVERROR(EINVAL);
+  } else if (sscanf(s->local_addr, "%hhu.%hhu.%hhu.%hhu", &param.sip_addr[MTL_PORT_P][0],
+                    &param.sip_addr[MTL_PORT_P][1], &param.sip_addr[MTL_PORT_P][2],
+                    &param.sip_addr[MTL_PORT_P][3]) != MTL_IP_ADDR_LEN) {
+    av_log(ctx, AV_LOG_ERROR, "Failed to parse local IP address: %s\n", s->local_addr);
+    return AVERROR(EINVAL);
+  }
+
+  param.rx_sessions_cnt_max = 0;
+  param.tx_sessions_cnt_max = s->session_cnt;
+  param.flags = MTL_FLAG_BIND_NUMA | MTL_FLAG_DEV_AUTO_START_STOP;
+  param.log_level = MTL_LOG_LEVEL_DEBUG;  // log level. ERROR, INFO, WARNING
+  param.priv = NULL;                      // usr crx pointer
+  param.ptp_get_time_fn = NULL;
+  param.lcores = NULL;
+
+  if (NULL == s->dst_addr) {
+    av_log(ctx, AV_LOG_ERROR, "Invalid destination IP address\n");
+    return AVERROR(EINVAL);
+  } else if (sscanf(s->dst_addr, "%hhu.%hhu.%hhu.%hhu",
+                    &ops_tx.port.dip_addr[MTL_PORT_P][0],
+                    &ops_tx.port.dip_addr[MTL_PORT_P][1],
+                    &ops_tx.port.dip_addr[MTL_PORT_P][2],
+                    &ops_tx.port.dip_addr[MTL_PORT_P][3]) != MTL_IP_ADDR_LEN) {
+    av_log(ctx, AV_LOG_ERROR, "Failed to parse destination IP address: %s\n",
+           s->dst_addr);
+    return AVERROR(EINVAL);
+  }
+
+  if ((s->udp_port < 0) || (s->udp_port > 0xFFFF)) {
+    av_log(ctx, AV_LOG_ERROR, "Invalid UDP port: %d\n", s->udp_port);
+    return AVERROR(EINVAL);
+  }
+  ops_tx.port.udp_port[MTL_PORT_P] = s->udp_port;
+
+  s->width = st->codecpar->width;
+  s->height = st->codecpar->height;
+  ops_tx.width = s->width;
+  ops_tx.height = s->height;
+  ops_tx.transport_fmt = ST20_FMT_YUV_422_10BIT;
+  ops_tx.input_fmt = ST_FRAME_FMT_YUV422PLANAR10LE;
+
+  framerate = st->avg_frame_rate;
+  if (!framerate.num || !framerate.den) framerate = av_inv_q(st->time_base);
+  fps = framerate.num * 100 / framerate.den;
+  for (ret = 0; ret < FF_ARRAY_ELEMS(fps_table); ++ret) {
+    if ((fps >= fps_table[ret].min) && (fps <= fps_table[ret].max)) {
+      ops_tx.fps = fps_table[ret].st_fps;
+      break;
+    }
+  }
+  if (ret >= FF_ARRAY_ELEMS(fps_table)) {
+    av_log(ctx, AV_LOG_ERROR, "Frame rate %0.2f is not supported\n", ((float)fps / 100));
+    return AVERROR(EINVAL);
+  }
+
+  // Create device
+  if (!shared_st_handle) {
+    s->dev_handle = mtl_init(&param);
+    if (!s->dev_handle) {
+      av_log(ctx, AV_LOG_ERROR, "mtl_init failed\n");
+      return AVERROR(EIO);
+    }
+    shared_st_handle = s->dev_handle;
+    av_log(ctx, AV_LOG_VERBOSE, "mtl_init finished: st_handle 0x%lx\n",
+           (unsigned long)shared_st_handle);
+  } else {
+    s->dev_handle = shared_st_handle;
+    av_log(ctx, AV_LOG_VERBOSE, "use shared st_handle 0x%lx\n",
+           (unsigned long)shared_st_handle);
+  }
+  ++active_session_cnt;
+
+  ops_tx.name = "st20p";
+  ops_tx.priv = s;                 // Handle of priv_data registered to lib
+  ops_tx.port.payload_type = 112;  // TX_ST20_PAYLOAD_TYPE
+  ops_tx.device = ST_PLUGIN_DEVICE_AUTO;
+  ops_tx.notify_frame_available = tx_st20p_frame_available;
+  ops_tx.notify_frame_done = tx_st20p_frame_done;
+  ops_tx.framebuff_cnt = s->fb_cnt;
+  /* the AVPacket buffers are put to the lib directly */
+  ops_tx.flags = ST20P_TX_FLAG_EXT_FRAME;
+
+  pthread_mutex_init(&(s->get_frame_mutex), NULL);
+  pthread_cond_init(&(s->get_frame_cond), NULL);
+
+  s->tx_handle = st20p_tx_create(s->dev_handle, &ops_tx);
+  if (!s->tx_handle) {
+    av_log(ctx, AV_LOG_ERROR, "st20p_tx_create failed\n");
+    return AVERROR(EIO);
+  }
+
+  s->frame_size = st20p_tx_frame_size(s->tx_handle);
+  if (s->frame_size <= 0) {
+    av_log(ctx, AV_LOG_ERROR, "st20p_tx_frame_size failed\n");
+    return AVERROR(EINVAL);
+  }
+
+  av_log(ctx, AV_LOG_VERBOSE, "st20p_tx_create finished\n");
+
+  s->frame_counter = 0;
+  atomic_init(&s->frames_inflight, 0);
+
+  return 0;
+}
+
+static int kahawai_write_packet(AVFormatContext* ctx, AVPacket* pkt) {
+  KahawaiMuxerContext* s = ctx->priv_data;
+  struct st_frame* frame;
+  struct st_ext_frame ext_frame;
+  AVBufferRef* buf;
+  uint8_t* data;
+  int ret;
+
+  av_log(ctx, AV_LOG_VERBOSE, "kahawai_write_packet triggered\n");
+
+  if (pkt->size != s->frame_size) {
+    av_log(ctx, AV_LOG_ERROR, "Unexpected packet size: %d (%lu expected)\n", pkt->size,
+           s->frame_size);
+    return AVERROR(EINVAL);
+  }
+
+  frame = st20p_tx_get_frame(s->tx_handle);
+  if (!frame) {
+    pthread_mutex_lock(&(s->get_frame_mutex));
+    pthread_cond_wait(&(s->get_frame_cond), &(s->get_frame_mutex));
+    pthread_mutex_unlock(&(s->get_frame_mutex));
+
+    frame = st20p_tx_get_frame(s->tx_handle);
+    if (!frame) {
+      av_log(ctx, AV_LOG_ERROR, "st20p_tx_get_frame failed\n");
+      return AVERROR(EIO);
+    }
+  }
+
+  if (pkt->buf) {
+    /* hold a reference until notify_frame_done, no copy */
+    buf = av_buffer_ref(pkt->buf);
+    data = pkt->data;
+  } else {
+    /* not a refcounted packet, it's only valid in this call */
+    buf = av_buffer_alloc(pkt->size);
+    data = buf ? buf->data : NULL;
+    if (data) memcpy(data, pkt->data, pkt->size);
+  }
+  if (!buf) {
+    av_log(ctx, AV_LOG_ERROR, "Failed to reference the packet buffer\n");
+    return AVERROR(ENOMEM);
+  }
+
+  memset(&ext_frame, 0, sizeof(ext_frame));
+  ext_frame.addr[0] = data;
+  ext_frame.linesize[0] = st_frame_least_linesize(frame->fmt, s->width, 0);
+  uint8_t planes = st_frame_fmt_planes(frame->fmt);
+  for (uint8_t plane = 1; plane < planes; plane++) { /* planes continous in AVPacket */
+    ext_frame.linesize[plane] = st_frame_least_linesize(frame->fmt, s->width, plane);
+    ext_frame.addr[plane] =
+        (uint8_t*)ext_frame.addr[plane - 1] + ext_frame.linesize[plane - 1] * s->height;
+  }
+  ext_frame.size = s->frame_size;
+  ext_frame.opaque = buf;
+
+  atomic_fetch_add(&s->frames_inflight, 1);
+  ret = st20p_tx_put_ext_frame(s->tx_handle, frame, &ext_frame);
+  if (ret < 0) {
+    av_log(ctx, AV_LOG_ERROR, "st20p_tx_put_ext_frame failed with %d\n", ret);
+    atomic_fetch_sub(&s->frames_inflight, 1);
+    av_buffer_unref(&buf);
+    return AVERROR(EIO);
+  }
+  av_log(ctx, AV_LOG_VERBOSE, "st20p_tx_put_ext_frame: 0x%lx\n", (unsigned long)data);
+
+  s->frame_counter++;
+  return 0;
+}
+
+static int kahawai_write_trailer(AVFormatContext* ctx) {
+  KahawaiMuxerContext* s = ctx->priv_data;
+  int wait_us = 0;
+
+  av_log(ctx, AV_LOG_VERBOSE, "kahawai_write_trailer triggered\n");
+
+  /* let the lib finish the frames which still point to the AVPacket buffers */
+  while (atomic_load(&s->frames_inflight) && (wait_us < KAHAWAI_CLOSE_WAIT_US)) {
+    av_usleep(1000);
+    wait_us += 1000;
+  }
+  if (atomic_load(&s->frames_inflight))
+    av_log(ctx, AV_LOG_WARNING, "%d frames still in flight on close\n",
+           atomic_load(&s->frames_inflight));
+
+  if (s->tx_handle) {
+    st20p_tx_free(s->tx_handle);
+    s->tx_handle = NULL;
+  }
+  av_log(ctx, AV_LOG_VERBOSE, "st20p_tx_free finished, %ld frames sent\n",
+         s->frame_counter);
+
+  pthread_mutex_destroy(&s->get_frame_mutex);
+  pthread_cond_destroy(&s->get_frame_cond);
+
+  // Destroy device
+  if (--active_session_cnt == 0) {
+    if (shared_st_handle) {
+      mtl_uninit(shared_st_handle);
+      shared_st_handle = NULL;
+      av_log(ctx, AV_LOG_VERBOSE, "mtl_uninit finished\n");
+    } else {
+      av_log(ctx, AV_LOG_ERROR, "missing st_handle\n");
+    }
+  } else {
+    av_log(ctx, AV_LOG_VERBOSE, "no need to do st_uninit yet\n");
+  }
+  s->dev_handle = NULL;
+
+  return 0;
+}
+
+#define OFFSET(x) offsetof(KahawaiMuxerContext, x)
+#define ENC AV_OPT_FLAG_ENCODING_PARAM
+static const AVOption kahawai_options[] = {
+    {"port", "ST port", OFFSET(port), AV_OPT_TYPE_STRING, {.str = NULL}, .flags = ENC},
+    {"local_addr",
+     "Local IP address",
+     OFFSET(local_addr),
+     AV_OPT_TYPE_STRING,
+     {.str = NULL},
+     .flags = ENC},
+    {"dst_addr",
+     "Destination IP address",
+     OFFSET(dst_addr),
+     AV_OPT_TYPE_STRING,
+     {.str = NULL},
+     .flags = ENC},
+    {"udp_port",
+     "UDP port",
+     OFFSET(udp_port),
+     AV_OPT_TYPE_INT,
+     {.i64 = -1},
+     -1,
+     INT_MAX,
+     ENC},
+    {"fb_cnt",
+     "Frame buffer count",
+     OFFSET(fb_cnt),
+     AV_OPT_TYPE_INT,
+     {.i64 = 3},
+     3,
+     8,
+     ENC},
+    {"total_sessions",
+     "Total sessions count",
+     OFFSET(session_cnt),
+     AV_OPT_TYPE_INT,
+     {.i64 = 1},
+     1,
+     INT_MAX,
+     ENC},
+    {NULL},
+};
+
+static const AVClass kahawai_muxer_class = {
+    .class_name = "kahawai muxer",
+    .item_name = av_default_item_name,
+    .option = kahawai_options,
+    .version = LIBAVUTIL_VERSION_INT,
+    .category = AV_CLASS_CATEGORY_DEVICE_VIDEO_OUTPUT,
+};
+
+AVOutputFormat ff_kahawai_muxer = {
+    .name = "kahawai",
+    .long_name = NULL_IF_CONFIG_SMALL("kahawai output device"),
+    .priv_data_size = sizeof(KahawaiMuxerContext),
+    .audio_codec = AV_CODEC_ID_NONE,
+    .video_codec = AV_CODEC_ID_RAWVIDEO,
+    .write_header = kahawai_write_header,
+    .write_packet = kahawai_write_packet,
+    .write_trailer = kahawai_write_trailer,
+    .flags = AVFMT_NOFILE,
+    .priv_class = &kahawai_muxer_class,
+};
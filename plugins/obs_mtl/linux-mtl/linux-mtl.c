@@ -11,15 +11,11 @@ MODULE_EXPORT const char* obs_module_description(void) {
 }
 
 extern struct obs_source_info mtl_input;
-#if TODO_OUTPUT
 extern struct obs_output_info mtl_output;
-#endif
 
 bool obs_module_load(void) {
   obs_register_source(&mtl_input);
-#if TODO_OUTPUT
   obs_register_output(&mtl_output);
-#endif
 
   obs_data_t* obs_settings = obs_data_create();
 
@@ -33,6 +29,10 @@ enum st_frame_fmt obs_to_mtl_format(enum video_format fmt) {
   switch (fmt) {
     case VIDEO_FORMAT_UYVY: /* UYVY can be converted from YUV422BE10 */
       return ST_FRAME_FMT_UYVY;
+#if MTL_OBS_HAS_I210
+    case VIDEO_FORMAT_I210: /* I210 can be converted from/to YUV422BE10 */
+      return ST_FRAME_FMT_YUV422PLANAR10LE;
+#endif
     case VIDEO_FORMAT_NV12:
     case VIDEO_FORMAT_I420:
       return ST_FRAME_FMT_YUV420CUSTOM8;
@@ -44,6 +44,21 @@ enum st_frame_fmt obs_to_mtl_format(enum video_format fmt) {
   }
 }
 
+enum video_format mtl_to_obs_format(enum st20_fmt t_fmt) {
+  switch (t_fmt) {
+#if MTL_OBS_HAS_I210
+    case ST20_FMT_YUV_422_10BIT:
+      return VIDEO_FORMAT_I210;
+#endif
+    case ST20_FMT_YUV_422_8BIT:
+      return VIDEO_FORMAT_UYVY;
+    case ST20_FMT_YUV_420_8BIT:
+      return VIDEO_FORMAT_I420;
+    default:
+      return VIDEO_FORMAT_NONE;
+  }
+}
+
 enum st_fps obs_to_mtl_fps(uint32_t fps_num, uint32_t fps_den) {
   switch (fps_num) {
     case 30000:
@@ -16,14 +16,19 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <time.h>
 #include <unistd.h>
 
+/* planar 4:2:2 10bit (I210) is available since libobs 28 */
+#define MTL_OBS_HAS_I210 (LIBOBS_API_MAJOR_VER >= 28)
+
 #define timeval2ns(tv) \
   (((uint64_t)tv.tv_sec * 1000000000) + ((uint64_t)tv.tv_usec * 1000))
 
 #define blog(level, msg, ...) blog(level, "mtl-input: " msg, ##__VA_ARGS__)
 
 enum st_frame_fmt obs_to_mtl_format(enum video_format fmt);
+enum video_format mtl_to_obs_format(enum st20_fmt t_fmt);
 enum st_fps obs_to_mtl_fps(uint32_t fps_num, uint32_t fps_den);
 
 #endif
\ No newline at end of file
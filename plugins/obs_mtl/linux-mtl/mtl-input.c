@@ -31,6 +31,9 @@ struct mtl_rx_session {
 
   int idx;
   st20p_rx_handle handle;
+  /* the lib converts into this buffer by st20p_rx_get_ext_frame, no dst frames */
+  bool ext_frame;
+  struct st_ext_frame ext;
 
   bool stop;
   pthread_t thread;
@@ -77,6 +80,10 @@ static void mtl_prep_obs_frame(struct mtl_rx_session* s, struct obs_source_frame
     case VIDEO_FORMAT_YVYU:
       frame->linesize[0] = s->width * 2;
       break;
+#if MTL_OBS_HAS_I210
+    case VIDEO_FORMAT_I210: /* planes come from the st_frame */
+      break;
+#endif
     default:
       frame->linesize[0] = s->width * 2;
       break;
@@ -115,19 +122,30 @@ static void* mtl_thread(void* vptr) {
   blog(LOG_DEBUG, "%s: obs frame prepared", s->port);
 
   while (!s->stop) {
-    frame = st20p_rx_get_frame(handle);
+    if (s->ext_frame)
+      frame = st20p_rx_get_ext_frame(handle, &s->ext);
+    else
+      frame = st20p_rx_get_frame(handle);
     if (!frame) { /* no frame */
       pthread_mutex_lock(&s->wake_mutex);
       if (!s->stop) pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
       pthread_mutex_unlock(&s->wake_mutex);
       continue;
     }
-    pthread_mutex_unlock(&s->wake_mutex);
 
-    for (uint_fast32_t i = 0; i < MAX_AV_PLANES; ++i)
-      out.data[i] = frame->addr[0] + plane_offsets[i];
+    uint8_t planes = st_frame_fmt_planes(frame->fmt);
+    if (planes > 1) {
+      for (uint8_t plane = 0; plane < planes; plane++) {
+        out.data[plane] = frame->addr[plane];
+        out.linesize[plane] = frame->linesize[plane];
+      }
+    } else {
+      for (uint_fast32_t i = 0; i < MAX_AV_PLANES; ++i)
+        out.data[i] = (uint8_t*)frame->addr[0] + plane_offsets[i];
+    }
     out.timestamp = frame->timestamp;
 
+    /* obs copies the async frame into its own cache, the ext buffer is free after */
     obs_source_output_video(s->source, &out);
     st20p_rx_put_frame(handle, frame);
     frames++;
@@ -259,6 +277,9 @@ static obs_properties_t* mtl_input_properties(void* vptr) {
   obs_property_list_add_int(v_fmt_list, obs_module_text("YVYU"), VIDEO_FORMAT_YVYU);
   obs_property_list_add_int(v_fmt_list, obs_module_text("I420"), VIDEO_FORMAT_I420);
   obs_property_list_add_int(v_fmt_list, obs_module_text("NV12"), VIDEO_FORMAT_NV12);
+#if MTL_OBS_HAS_I210
+  obs_property_list_add_int(v_fmt_list, obs_module_text("I210"), VIDEO_FORMAT_I210);
+#endif
 
   obs_property_t* log_level_list =
       obs_properties_add_list(props, "log_level", obs_module_text("LogLevel"),
@@ -298,12 +319,37 @@ static void mtl_input_terminate(struct mtl_rx_session* s) {
   pthread_mutex_destroy(&s->wake_mutex);
   pthread_cond_destroy(&s->wake_cond);
 
+  if (s->ext.addr[0]) {
+    bfree(s->ext.addr[0]);
+    memset(&s->ext, 0, sizeof(s->ext));
+  }
+
   if (s->dev_handle) {
     mtl_uninit(s->dev_handle);
     s->dev_handle = NULL;
   }
 }
 
+/* one obs owned buffer for the internal SIMD converter to write into */
+static int mtl_input_ext_init(struct mtl_rx_session* s, enum st_frame_fmt fmt) {
+  size_t size = st_frame_size(fmt, s->width, s->height);
+  uint8_t planes = st_frame_fmt_planes(fmt);
+  uint8_t* addr;
+
+  if (!size) return -EINVAL;
+  addr = bzalloc(size);
+  if (!addr) return -ENOMEM;
+
+  memset(&s->ext, 0, sizeof(s->ext));
+  for (uint8_t plane = 0; plane < planes; plane++) {
+    s->ext.linesize[plane] = st_frame_least_linesize(fmt, s->width, plane);
+    s->ext.addr[plane] = addr;
+    addr += s->ext.linesize[plane] * s->height;
+  }
+  s->ext.size = size;
+  return 0;
+}
+
 static void mtl_input_destroy(void* vptr) {
   MTL_RX_SESSION(vptr);
 
@@ -356,6 +402,19 @@ static void mtl_input_init(struct mtl_rx_session* s) {
   ops_rx.transport_fmt = s->t_fmt;
   ops_rx.framebuff_cnt = s->framebuffer_cnt;
   ops_rx.port.payload_type = s->payload_type;
+  /*
+   * Formats the lib has to convert go through st20p_rx_get_ext_frame, the internal
+   * SIMD converter reads the transport frame and writes the obs layout in one pass.
+   * Derived formats hand the transport frame to obs as is.
+   */
+  s->ext_frame = !st_frame_fmt_equal_transport(ops_rx.output_fmt, s->t_fmt);
+  if (s->ext_frame) {
+    if (mtl_input_ext_init(s, ops_rx.output_fmt) < 0) {
+      blog(LOG_ERROR, "ext frame alloc fail\n");
+      goto error;
+    }
+    ops_rx.flags |= ST20P_RX_FLAG_EXT_FRAME;
+  }
   // app regist non-block func, app get a frame ready notification info by this cb
   ops_rx.notify_frame_available = notify_frame_available;
 
@@ -4,8 +4,6 @@
 
 #include "linux-mtl.h"
 
-#if TODO_OUTPUT
-
 #define MTL_TX_SESSION(voidptr) struct mtl_tx_session* s = voidptr;
 
 /**
@@ -29,12 +27,19 @@ struct mtl_tx_session {
 
   int idx;
   st20p_tx_handle handle;
+  /* obs frames are handed to lib by st20p_tx_put_ext_frame, no copy */
+  bool ext_frame;
+  uint64_t ext_frames_put;
+  uint64_t ext_frames_done;
+
+  bool stop;
+  pthread_cond_t wake_cond;
+  pthread_mutex_t wake_mutex;
 
   uint64_t total_bytes;
 };
 
 /* forward declarations */
-static void mtl_output_init(struct mtl_tx_session* s);
 static void mtl_output_terminate(struct mtl_tx_session* s);
 static void mtl_output_update(void* vptr, obs_data_t* settings);
 
@@ -50,7 +55,7 @@ static void mtl_output_defaults(obs_data_t* settings) {
   obs_data_set_default_string(settings, "ip", "192.168.96.1");
   obs_data_set_default_int(settings, "udp_port", 20000);
   obs_data_set_default_int(settings, "payload_type", 112);
-  obs_data_set_default_int(settings, "t_fmt", ST20_FMT_YUV_420_10BIT);
+  obs_data_set_default_int(settings, "t_fmt", ST20_FMT_YUV_422_8BIT);
   obs_data_set_default_int(settings, "framebuffer_cnt", 3);
   obs_data_set_default_int(settings, "log_level", MTL_LOG_LEVEL_ERROR);
 }
@@ -98,6 +103,11 @@ static obs_properties_t* mtl_output_properties(void* vptr) {
 }
 
 static void mtl_output_terminate(struct mtl_tx_session* s) {
+  pthread_mutex_lock(&s->wake_mutex);
+  s->stop = true;
+  pthread_cond_signal(&s->wake_cond);
+  pthread_mutex_unlock(&s->wake_mutex);
+
   if (s->dev_handle) {
     mtl_stop(s->dev_handle);
   }
@@ -119,11 +129,29 @@ static void mtl_output_destroy(void* vptr) {
   if (!s) return;
 
   mtl_output_terminate(s);
+  pthread_mutex_destroy(&s->wake_mutex);
+  pthread_cond_destroy(&s->wake_cond);
 
   bfree(s);
 }
 
-static void mtl_output_init(struct mtl_tx_session* s) {
+static int mtl_output_frame_done(void* priv, struct st_frame* frame) {
+  MTL_TX_SESSION(priv);
+  uint64_t seq = (uint64_t)(uintptr_t)frame->opaque;
+
+  if (!s->ext_frame || !seq) return 0;
+
+  /* the internal converter calls this inside st20p_tx_put_ext_frame */
+  pthread_mutex_lock(&s->wake_mutex);
+  if (seq > s->ext_frames_done) s->ext_frames_done = seq;
+  pthread_cond_signal(&s->wake_cond);
+  pthread_mutex_unlock(&s->wake_mutex);
+
+  return 0;
+}
+
+static int mtl_output_init(struct mtl_tx_session* s, const struct video_scale_info* vs,
+                           const struct video_output_info* vo_info) {
   struct mtl_init_params param;
 
   memset(&param, 0, sizeof(param));
@@ -138,36 +166,44 @@ static void mtl_output_init(struct mtl_tx_session* s) {
   param.priv = s;                    // usr ctx pointer
   // user regist ptp func, if not regist, the internal ptp will be used
   param.ptp_get_time_fn = NULL;
-  param.tx_sessions_cnt_max = 0;
-  param.rx_sessions_cnt_max = 1;
+  param.tx_sessions_cnt_max = 1;
+  param.rx_sessions_cnt_max = 0;
   param.lcores = s->lcores;
   // create device
   mtl_handle dev_handle = mtl_init(&param);
   if (!dev_handle) {
     blog(LOG_ERROR, "mtl_init fail\n");
-    return;
+    return -EIO;
   }
   s->dev_handle = dev_handle;
   s->idx = 0;
 
-  video_t* video = obs_output_video(s->output);
-  const struct video_output_info* vo_info = video_output_get_info(video);
-
   struct st20p_tx_ops ops_tx;
   memset(&ops_tx, 0, sizeof(ops_tx));
-  ops_tx.name = "mtl-input";
+  ops_tx.name = "mtl-output";
   ops_tx.priv = s;  // app handle register to lib
   ops_tx.port.num_port = 1;
   inet_pton(AF_INET, s->ip, ops_tx.port.dip_addr[MTL_PORT_P]);
   strncpy(ops_tx.port.port[MTL_PORT_P], s->port, MTL_PORT_MAX_LEN);
   ops_tx.port.udp_port[MTL_PORT_P] = s->udp_port;  // user config the udp port.
-  ops_tx.width = vo_info->width;
-  ops_tx.height = vo_info->height;
+  ops_tx.width = vs->width;
+  ops_tx.height = vs->height;
   ops_tx.fps = obs_to_mtl_fps(vo_info->fps_num, vo_info->fps_den);
-  ops_tx.input_fmt = obs_to_mtl_format(vo_info->format);
+  ops_tx.input_fmt = obs_to_mtl_format(vs->format);
   ops_tx.transport_fmt = s->t_fmt;
   ops_tx.framebuff_cnt = s->framebuffer_cnt;
   ops_tx.port.payload_type = s->payload_type;
+  /*
+   * Formats the lib has to convert read the obs planes directly, the transport
+   * frame is the only copy. Derived formats still copy as the obs frame is
+   * recycled once the raw_video callback returns.
+   */
+  s->ext_frame = !st_frame_fmt_equal_transport(ops_tx.input_fmt, s->t_fmt);
+  if (s->ext_frame) ops_tx.flags |= ST20P_TX_FLAG_EXT_FRAME;
+  ops_tx.notify_frame_done = mtl_output_frame_done;
+  s->ext_frames_put = 0;
+  s->ext_frames_done = 0;
+  s->stop = false;
 
   s->handle = st20p_tx_create(dev_handle, &ops_tx);
   if (!s->handle) {
@@ -176,11 +212,12 @@ static void mtl_output_init(struct mtl_tx_session* s) {
   }
 
   mtl_start(s->dev_handle);
-  return;
+  return 0;
 
 error:
   blog(LOG_ERROR, "Initialization failed, errno: %s", strerror(errno));
   mtl_output_terminate(s);
+  return -EIO;
 }
 
 static void mtl_output_update(void* vptr, obs_data_t* settings) {
@@ -195,19 +232,95 @@ static void mtl_output_update(void* vptr, obs_data_t* settings) {
   s->t_fmt = obs_data_get_int(settings, "t_fmt");
   s->framebuffer_cnt = obs_data_get_int(settings, "framebuffer_cnt");
   s->log_level = obs_data_get_int(settings, "log_level");
-
-  mtl_output_init(s);
 }
 
 static void* mtl_output_create(obs_data_t* settings, obs_output_t* output) {
   struct mtl_tx_session* s = bzalloc(sizeof(struct mtl_tx_session));
   s->output = output;
+  pthread_mutex_init(&s->wake_mutex, NULL);
+  pthread_cond_init(&s->wake_cond, NULL);
 
   mtl_output_update(s, settings);
 
   return s;
 }
 
+static bool mtl_output_start(void* vptr) {
+  MTL_TX_SESSION(vptr);
+
+  if (!obs_output_can_begin_data_capture(s->output, 0)) return false;
+
+  video_t* video = obs_output_video(s->output);
+  const struct video_output_info* vo_info = video_output_get_info(video);
+
+  /* let obs render straight into the layout the session sends */
+  struct video_scale_info vs;
+  memset(&vs, 0, sizeof(vs));
+  vs.format = mtl_to_obs_format(s->t_fmt);
+  vs.width = vo_info->width;
+  vs.height = vo_info->height;
+  vs.range = VIDEO_RANGE_PARTIAL;
+  vs.colorspace = VIDEO_CS_709;
+  if (vs.format == VIDEO_FORMAT_NONE) {
+    blog(LOG_ERROR, "transport format %d not supported\n", s->t_fmt);
+    return false;
+  }
+  obs_output_set_video_conversion(s->output, &vs);
+
+  if (mtl_output_init(s, &vs, vo_info) < 0) return false;
+
+  obs_output_begin_data_capture(s->output, 0);
+  return true;
+}
+
+static void mtl_output_stop(void* vptr, uint64_t ts) {
+  MTL_TX_SESSION(vptr);
+  UNUSED_PARAMETER(ts);
+
+  obs_output_end_data_capture(s->output);
+  mtl_output_terminate(s);
+}
+
+static void mtl_output_put_ext_frame(struct mtl_tx_session* s, struct st_frame* frame,
+                                     struct video_data* obs_frame) {
+  struct st_ext_frame ext_frame;
+  uint8_t planes = st_frame_fmt_planes(frame->fmt);
+
+  memset(&ext_frame, 0, sizeof(ext_frame));
+  for (uint8_t plane = 0; plane < planes; plane++) {
+    ext_frame.addr[plane] = obs_frame->data[plane];
+    ext_frame.linesize[plane] = obs_frame->linesize[plane];
+    ext_frame.size += (size_t)obs_frame->linesize[plane] * frame->height;
+  }
+  ext_frame.opaque = (void*)(uintptr_t)(++s->ext_frames_put);
+
+  frame->tfmt = ST10_TIMESTAMP_FMT_MEDIA_CLK;
+  frame->timestamp = obs_frame->timestamp;
+  if (st20p_tx_put_ext_frame(s->handle, frame, &ext_frame) < 0) {
+    blog(LOG_WARNING, "put ext frame %" PRIu64 " fail\n", s->ext_frames_put);
+    return;
+  }
+
+  /*
+   * The internal converter is done before st20p_tx_put_ext_frame returns, a
+   * plugin converter is not, and obs reuses the planes after this callback.
+   */
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += 1;
+  pthread_mutex_lock(&s->wake_mutex);
+  while (!s->stop && s->ext_frames_done < s->ext_frames_put) {
+    if (pthread_cond_timedwait(&s->wake_cond, &s->wake_mutex, &deadline)) {
+      blog(LOG_WARNING, "ext frame %" PRIu64 " not converted in 1s\n",
+           s->ext_frames_put);
+      break;
+    }
+  }
+  pthread_mutex_unlock(&s->wake_mutex);
+
+  s->total_bytes += ext_frame.size;
+}
+
 static void mtl_output_video_frame(void* vptr, struct video_data* obs_frame) {
   MTL_TX_SESSION(vptr);
   st20p_tx_handle handle = s->handle;
@@ -216,6 +329,11 @@ static void mtl_output_video_frame(void* vptr, struct video_data* obs_frame) {
   frame = st20p_tx_get_frame(handle);
   if (!frame) return;
 
+  if (s->ext_frame) {
+    mtl_output_put_ext_frame(s, frame, obs_frame);
+    return;
+  }
+
   uint8_t planes = st_frame_fmt_planes(frame->fmt);
   for (uint8_t plane = 0; plane < planes; plane++) { /* assume planes continous */
     size_t plane_size =
@@ -242,11 +360,11 @@ struct obs_output_info mtl_output = {
     .get_name = mtl_output_getname,
     .create = mtl_output_create,
     .destroy = mtl_output_destroy,
+    .start = mtl_output_start,
+    .stop = mtl_output_stop,
     .raw_video = mtl_output_video_frame,
     .get_total_bytes = mtl_output_total_bytes,
     .update = mtl_output_update,
     .get_defaults = mtl_output_defaults,
     .get_properties = mtl_output_properties,
 };
-
-#endif
\ No newline at end of file
@@ -43,6 +43,19 @@ static inline int st_pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mu
   return pthread_cond_wait(cond, mutex);
 }
 
+/* wait for a signal or the timeout, the cond is on the default CLOCK_REALTIME */
+static inline int st_pthread_cond_timedwait_ns(pthread_cond_t* cond,
+                                               pthread_mutex_t* mutex,
+                                               uint64_t timeout_ns) {
+  struct timespec time;
+
+  clock_gettime(CLOCK_REALTIME, &time);
+  uint64_t ns = (uint64_t)time.tv_nsec + timeout_ns;
+  time.tv_sec += ns / NS_PER_S;
+  time.tv_nsec = ns % NS_PER_S;
+  return pthread_cond_timedwait(cond, mutex, &time);
+}
+
 static inline int st_pthread_cond_destroy(pthread_cond_t* cond) {
   return pthread_cond_destroy(cond);
 }
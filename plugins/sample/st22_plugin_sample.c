@@ -30,34 +30,25 @@ static int encode_frame(struct st22_encoder_session* s,
   return 0;
 }
 
-static void* encode_thread(void* arg) {
-  struct st22_encoder_session* s = arg;
-  st22p_encode_session session_p = s->session_p;
+/* one frame each call from a pool worker, never run concurrently for the session */
+static int encode_process(void* priv) {
+  struct st22_encoder_session* s = priv;
   struct st22_encode_frame_meta* frame;
   int result;
 
-  info("%s(%d), start\n", __func__, s->idx);
-  while (!s->stop) {
-    frame = st22_encoder_get_frame(session_p);
-    if (!frame) { /* no frame */
-      st_pthread_mutex_lock(&s->wake_mutex);
-      if (!s->stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
-      st_pthread_mutex_unlock(&s->wake_mutex);
-      continue;
-    }
-    result = encode_frame(s, frame);
-    st22_encoder_put_frame(session_p, frame, result);
-  }
-  info("%s(%d), stop\n", __func__, s->idx);
+  frame = st22_encoder_get_frame(s->session_p);
+  if (!frame) return -EBUSY; /* no frame */
 
-  return NULL;
+  result = encode_frame(s, frame);
+  st22_encoder_put_frame(s->session_p, frame, result);
+  return 0;
 }
 
 static st22_encode_priv encoder_create_session(void* priv, st22p_encode_session session_p,
                                                struct st22_encoder_create_req* req) {
   struct st22_sample_ctx* ctx = priv;
   struct st22_encoder_session* session = NULL;
-  int ret;
+  struct st_plugin_job_ops job_ops;
 
   for (int i = 0; i < MAX_SAMPLE_ENCODER_SESSIONS; i++) {
     if (ctx->encoder_sessions[i]) continue;
@@ -65,19 +56,19 @@ static st22_encode_priv encoder_create_session(void* priv, st22p_encode_session
     if (!session) return NULL;
     memset(session, 0, sizeof(*session));
     session->idx = i;
-    st_pthread_mutex_init(&session->wake_mutex, NULL);
-    st_pthread_cond_init(&session->wake_cond, NULL);
 
     req->max_codestream_size = req->codestream_size;
 
     session->req = *req;
     session->session_p = session_p;
 
-    ret = pthread_create(&session->encode_thread, NULL, encode_thread, session);
-    if (ret < 0) {
-      err("%s(%d), thread create fail %d\n", __func__, i, ret);
-      st_pthread_mutex_destroy(&session->wake_mutex);
-      st_pthread_cond_destroy(&session->wake_cond);
+    memset(&job_ops, 0, sizeof(job_ops));
+    job_ops.name = "st22_encoder_sample";
+    job_ops.priv = session;
+    job_ops.process = encode_process;
+    session->job = st_plugin_job_create(ctx->st, &job_ops);
+    if (!session->job) {
+      err("%s(%d), job create fail\n", __func__, i);
       free(session);
       return NULL;
     }
@@ -99,14 +90,8 @@ static int encoder_free_session(void* priv, st22_encode_priv session) {
   struct st22_encoder_session* encoder_session = session;
   int idx = encoder_session->idx;
 
-  encoder_session->stop = true;
-  st_pthread_mutex_lock(&encoder_session->wake_mutex);
-  st_pthread_cond_signal(&encoder_session->wake_cond);
-  st_pthread_mutex_unlock(&encoder_session->wake_mutex);
-  pthread_join(encoder_session->encode_thread, NULL);
-
-  st_pthread_mutex_destroy(&encoder_session->wake_mutex);
-  st_pthread_cond_destroy(&encoder_session->wake_cond);
+  /* no process call after it returns */
+  st_plugin_job_free(encoder_session->job);
 
   info("%s(%d), total %d encode frames\n", __func__, idx, encoder_session->frame_cnt);
   free(encoder_session);
@@ -118,11 +103,7 @@ static int encoder_frame_available(void* priv) {
   struct st22_encoder_session* s = priv;
 
   dbg("%s(%d)\n", __func__, s->idx);
-  st_pthread_mutex_lock(&s->wake_mutex);
-  st_pthread_cond_signal(&s->wake_cond);
-  st_pthread_mutex_unlock(&s->wake_mutex);
-
-  return 0;
+  return st_plugin_job_notify(s->job);
 }
 
 static int decode_frame(struct st22_decoder_session* s,
@@ -138,34 +119,25 @@ static int decode_frame(struct st22_decoder_session* s,
   return 0;
 }
 
-static void* decode_thread(void* arg) {
-  struct st22_decoder_session* s = arg;
-  st22p_decode_session session_p = s->session_p;
+/* one frame each call from a pool worker, never run concurrently for the session */
+static int decode_process(void* priv) {
+  struct st22_decoder_session* s = priv;
   struct st22_decode_frame_meta* frame;
   int result;
 
-  info("%s(%d), start\n", __func__, s->idx);
-  while (!s->stop) {
-    frame = st22_decoder_get_frame(session_p);
-    if (!frame) { /* no frame */
-      st_pthread_mutex_lock(&s->wake_mutex);
-      if (!s->stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
-      st_pthread_mutex_unlock(&s->wake_mutex);
-      continue;
-    }
-    result = decode_frame(s, frame);
-    st22_decoder_put_frame(session_p, frame, result);
-  }
-  info("%s(%d), stop\n", __func__, s->idx);
+  frame = st22_decoder_get_frame(s->session_p);
+  if (!frame) return -EBUSY; /* no frame */
 
-  return NULL;
+  result = decode_frame(s, frame);
+  st22_decoder_put_frame(s->session_p, frame, result);
+  return 0;
 }
 
 static st22_decode_priv decoder_create_session(void* priv, st22p_decode_session session_p,
                                                struct st22_decoder_create_req* req) {
   struct st22_sample_ctx* ctx = priv;
   struct st22_decoder_session* session = NULL;
-  int ret;
+  struct st_plugin_job_ops job_ops;
 
   for (int i = 0; i < MAX_SAMPLE_DECODER_SESSIONS; i++) {
     if (ctx->decoder_sessions[i]) continue;
@@ -173,17 +145,17 @@ static st22_decode_priv decoder_create_session(void* priv, st22p_decode_session
     if (!session) return NULL;
     memset(session, 0, sizeof(*session));
     session->idx = i;
-    st_pthread_mutex_init(&session->wake_mutex, NULL);
-    st_pthread_cond_init(&session->wake_cond, NULL);
 
     session->req = *req;
     session->session_p = session_p;
 
-    ret = pthread_create(&session->decode_thread, NULL, decode_thread, session);
-    if (ret < 0) {
-      err("%s(%d), thread create fail %d\n", __func__, i, ret);
-      st_pthread_mutex_destroy(&session->wake_mutex);
-      st_pthread_cond_destroy(&session->wake_cond);
+    memset(&job_ops, 0, sizeof(job_ops));
+    job_ops.name = "st22_decoder_sample";
+    job_ops.priv = session;
+    job_ops.process = decode_process;
+    session->job = st_plugin_job_create(ctx->st, &job_ops);
+    if (!session->job) {
+      err("%s(%d), job create fail\n", __func__, i);
       free(session);
       return NULL;
     }
@@ -203,14 +175,8 @@ static int decoder_free_session(void* priv, st22_decode_priv session) {
   struct st22_decoder_session* decoder_session = session;
   int idx = decoder_session->idx;
 
-  decoder_session->stop = true;
-  st_pthread_mutex_lock(&decoder_session->wake_mutex);
-  st_pthread_cond_signal(&decoder_session->wake_cond);
-  st_pthread_mutex_unlock(&decoder_session->wake_mutex);
-  pthread_join(decoder_session->decode_thread, NULL);
-
-  st_pthread_mutex_destroy(&decoder_session->wake_mutex);
-  st_pthread_cond_destroy(&decoder_session->wake_cond);
+  /* no process call after it returns */
+  st_plugin_job_free(decoder_session->job);
 
   info("%s(%d), total %d decode frames\n", __func__, idx, decoder_session->frame_cnt);
   free(decoder_session);
@@ -222,11 +188,7 @@ static int decoder_frame_available(void* priv) {
   struct st22_decoder_session* s = priv;
 
   dbg("%s(%d)\n", __func__, s->idx);
-  st_pthread_mutex_lock(&s->wake_mutex);
-  st_pthread_cond_signal(&s->wake_cond);
-  st_pthread_mutex_unlock(&s->wake_mutex);
-
-  return 0;
+  return st_plugin_job_notify(s->job);
 }
 
 st_plugin_priv st_plugin_create(mtl_handle st) {
@@ -235,6 +197,7 @@ st_plugin_priv st_plugin_create(mtl_handle st) {
   ctx = malloc(sizeof(*ctx));
   if (!ctx) return NULL;
   memset(ctx, 0, sizeof(*ctx));
+  ctx->st = st;
 
   struct st22_decoder_dev d_dev;
   memset(&d_dev, 0, sizeof(d_dev));
@@ -285,11 +248,13 @@ int st_plugin_free(st_plugin_priv handle) {
 
   for (int i = 0; i < MAX_SAMPLE_DECODER_SESSIONS; i++) {
     if (ctx->decoder_sessions[i]) {
+      st_plugin_job_free(ctx->decoder_sessions[i]->job);
       free(ctx->decoder_sessions[i]);
     }
   }
   for (int i = 0; i < MAX_SAMPLE_ENCODER_SESSIONS; i++) {
     if (ctx->encoder_sessions[i]) {
+      st_plugin_job_free(ctx->encoder_sessions[i]->job);
       free(ctx->encoder_sessions[i]);
     }
   }
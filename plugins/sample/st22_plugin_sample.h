@@ -15,10 +15,8 @@ struct st22_encoder_session {
 
   struct st22_encoder_create_req req;
   st22p_encode_session session_p;
-  bool stop;
-  pthread_t encode_thread;
-  pthread_cond_t wake_cond;
-  pthread_mutex_t wake_mutex;
+  /* the frames are processed by the shared plugin worker pool of the lib */
+  st_plugin_job_handle job;
 
   int frame_cnt;
 };
@@ -28,15 +26,14 @@ struct st22_decoder_session {
 
   struct st22_decoder_create_req req;
   st22p_decode_session session_p;
-  bool stop;
-  pthread_t decode_thread;
-  pthread_cond_t wake_cond;
-  pthread_mutex_t wake_mutex;
+  /* the frames are processed by the shared plugin worker pool of the lib */
+  st_plugin_job_handle job;
 
   int frame_cnt;
 };
 
 struct st22_sample_ctx {
+  mtl_handle st;
   st22_encoder_dev_handle encoder_dev_handle;
   st22_decoder_dev_handle decoder_dev_handle;
   struct st22_encoder_session* encoder_sessions[MAX_SAMPLE_ENCODER_SESSIONS];
@@ -15,89 +15,326 @@
 #include "../log.h"
 #include "../plugin_platform.h"
 
-static int encode_frame(struct st22_encoder_session* s,
-                        struct st22_encode_frame_meta* frame) {
+static const AVCodec* st22_ffmpeg_find_codec(enum st_frame_fmt fmt, bool encoder) {
+  switch (fmt) {
+    case ST_FRAME_FMT_H264_CBR_CODESTREAM:
+      return encoder ? avcodec_find_encoder(AV_CODEC_ID_H264)
+                     : avcodec_find_decoder(AV_CODEC_ID_H264);
+    case ST_FRAME_FMT_H265_CBR_CODESTREAM:
+      return encoder ? avcodec_find_encoder(AV_CODEC_ID_HEVC)
+                     : avcodec_find_decoder(AV_CODEC_ID_HEVC);
+    case ST_FRAME_FMT_JPEGXS_CODESTREAM:
+      /* only the ffmpeg build with svt-jpegxs has the jpegxs codec */
+      return encoder ? avcodec_find_encoder_by_name(ST22_FFMPEG_JPEGXS_CODEC_NAME)
+                     : avcodec_find_decoder_by_name(ST22_FFMPEG_JPEGXS_CODEC_NAME);
+    default:
+      return NULL;
+  }
+}
+
+/* the codestream caps of the codecs available in this ffmpeg build */
+static uint64_t st22_ffmpeg_codestream_caps(bool encoder) {
+  enum st_frame_fmt fmts[] = {
+      ST_FRAME_FMT_H264_CBR_CODESTREAM,
+      ST_FRAME_FMT_H265_CBR_CODESTREAM,
+      ST_FRAME_FMT_JPEGXS_CODESTREAM,
+  };
+  uint64_t caps = 0;
+
+  for (int i = 0; i < (int)(sizeof(fmts) / sizeof(fmts[0])); i++) {
+    if (st22_ffmpeg_find_codec(fmts[i], encoder)) {
+      caps |= MTL_BIT64(fmts[i]);
+      info("%s, %s %s\n", __func__, encoder ? "encoder" : "decoder",
+           st_frame_fmt_name(fmts[i]));
+    }
+  }
+  return caps;
+}
+
+static inline struct st22_encoder_inflight* encoder_inflight(
+    struct st22_encoder_session* s, int i) {
+  return &s->inflight[(s->inflight_head + i) % ST22_ENCODER_MAX_INFLIGHT];
+}
+
+/* called by the codec(may from its threads) once the wrapped src frame is released */
+static void encoder_buf_free(void* opaque, uint8_t* data) {
+  struct st22_encoder_inflight* slot = opaque;
+  struct st22_encoder_session* s = slot->parent;
+
+  st_pthread_mutex_lock(&s->wake_mutex);
+  slot->buf_released = true;
+  st_pthread_cond_signal(&s->wake_cond);
+  st_pthread_mutex_unlock(&s->wake_mutex);
+}
+
+static bool encoder_can_zero_copy(struct st22_encoder_session* s, struct st_frame* src) {
+  if (!s->zero_copy) return false;
+
+  for (int plane = 0; plane < 3; plane++) {
+    if (((uintptr_t)src->addr[plane] | src->linesize[plane]) %
+        ST22_FFMPEG_ZERO_COPY_ALIGN)
+      return false;
+  }
+  return true;
+}
+
+static int encoder_send_frame(struct st22_encoder_session* s,
+                              struct st22_encode_frame_meta* frame) {
   int idx = s->idx;
-  int f_idx = s->frame_idx;
-  AVFrame* f = s->codec_frame;
-  AVPacket* p = s->codec_pkt;
+  struct st22_encoder_inflight* slot = encoder_inflight(s, s->inflight_cnt);
   AVCodecContext* ctx = s->codec_ctx;
-  size_t data_size = 0;
+  struct st_frame* src = frame->src;
+  AVFrame* f;
   int ret;
-  bool measure_time = false;
-  uint64_t start_time = 0, end_time = 0;
-
-  if (measure_time) {
-    start_time = st_get_monotonic_time();
-  }
 
+  slot->meta = frame;
+  slot->pts = s->frame_idx;
+  slot->pkt_done = false;
+  slot->buf_released = false;
+  slot->result = 0;
+  slot->data_size = 0;
   frame->dst->data_size = 0;
+  s->inflight_cnt++;
+  s->frame_idx++;
 
-  /* prepare src */
-  f->pict_type = AV_PICTURE_TYPE_I; /* all are i frame */
-  f->pts = f_idx;
-  /* only YUV422P now */
-  mtl_memcpy(f->data[0], frame->src->addr[0], st_frame_plane_size(frame->src, 0));
-  mtl_memcpy(f->data[1], frame->src->addr[1], st_frame_plane_size(frame->src, 1));
-  mtl_memcpy(f->data[2], frame->src->addr[2], st_frame_plane_size(frame->src, 2));
+  if (encoder_can_zero_copy(s, src)) {
+    f = s->codec_wrap_frame;
+    f->format = ctx->pix_fmt;
+    f->width = ctx->width;
+    f->height = ctx->height;
+    /* one ref for all planes, the lib frame is put back after the codec release it */
+    f->buf[0] = av_buffer_create(src->addr[0], src->buffer_size, encoder_buf_free, slot,
+                                 AV_BUFFER_FLAG_READONLY);
+    if (!f->buf[0]) {
+      err("%s(%d), buffer create fail on frame %" PRId64 "\n", __func__, idx, slot->pts);
+      slot->buf_released = true;
+      ret = AVERROR(ENOMEM);
+      goto fail;
+    }
+    for (int plane = 0; plane < 3; plane++) {
+      f->data[plane] = src->addr[plane];
+      f->linesize[plane] = src->linesize[plane];
+    }
+  } else {
+    f = s->codec_frame;
+    /* the codec may still hold a ref to the last copy */
+    ret = av_frame_make_writable(f);
+    if (ret < 0) {
+      err("%s(%d), frame writable fail %s\n", __func__, idx, av_err2str(ret));
+      slot->buf_released = true;
+      goto fail;
+    }
+    /* only YUV422P now */
+    for (int plane = 0; plane < 3; plane++) {
+      int w = plane ? ctx->width / 2 : ctx->width;
+      av_image_copy_plane(f->data[plane], f->linesize[plane], src->addr[plane],
+                          src->linesize[plane], w, ctx->height);
+    }
+    slot->buf_released = true;
+    s->copy_cnt++;
+  }
 
+  f->pict_type = AV_PICTURE_TYPE_I; /* all are i frame */
+  f->pts = slot->pts;
   ret = avcodec_send_frame(ctx, f);
-  s->frame_idx++;
+  /* drop the wrap ref, the codec keep its own ref until the frame is consumed */
+  if (f == s->codec_wrap_frame) av_frame_unref(f);
   if (ret < 0) {
-    err("%s(%d), send frame(%d) fail %s\n", __func__, idx, f_idx, av_err2str(ret));
-    return ret;
+    err("%s(%d), send frame(%" PRId64 ") fail %s\n", __func__, idx, slot->pts,
+        av_err2str(ret));
+    goto fail;
   }
 
-  while (ret >= 0) {
-    ret = avcodec_receive_packet(ctx, p);
+  return 0;
+
+fail:
+  slot->pkt_done = true;
+  slot->result = ret;
+  return ret;
+}
+
+static struct st22_encoder_inflight* encoder_inflight_find(
+    struct st22_encoder_session* s, int64_t pts) {
+  struct st22_encoder_inflight* slot;
+
+  for (int i = 0; i < s->inflight_cnt; i++) {
+    slot = encoder_inflight(s, i);
+    if (slot->pts == pts) return slot;
+  }
+  return NULL;
+}
+
+/* return the number of packets received */
+static int encoder_receive_packets(struct st22_encoder_session* s) {
+  int idx = s->idx;
+  AVPacket* p = s->codec_pkt;
+  struct st22_encoder_inflight* slot;
+  struct st_frame* dst;
+  int cnt = 0;
+  int ret;
+
+  while (1) {
+    ret = avcodec_receive_packet(s->codec_ctx, p);
     if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-      dbg("%s(%d), receive packet fail %s on frame %d\n", __func__, idx, av_err2str(ret),
-          f_idx);
-      goto exit;
+      break;
     } else if (ret < 0) {
-      err("%s(%d), receive packet fail %s on frame %d\n", __func__, idx, av_err2str(ret),
-          f_idx);
-      return ret;
+      err("%s(%d), receive packet fail %s\n", __func__, idx, av_err2str(ret));
+      /* fail all the frames still waiting for the codestream */
+      for (int i = 0; i < s->inflight_cnt; i++) {
+        slot = encoder_inflight(s, i);
+        if (slot->pkt_done) continue;
+        slot->pkt_done = true;
+        slot->result = ret;
+      }
+      break;
     }
 
-    dbg("%s, receive packet %" PRId64 " size %d on frame %d\n", __func__, p->pts, p->size,
-        f_idx);
-    mtl_memcpy(frame->dst->addr[0] + data_size, p->data, p->size);
-    data_size += p->size;
+    slot = encoder_inflight_find(s, p->pts);
+    if (!slot) {
+      err("%s(%d), no frame for packet %" PRId64 "\n", __func__, idx, p->pts);
+      av_packet_unref(p);
+      continue;
+    }
+    dbg("%s(%d), receive packet %" PRId64 " size %d\n", __func__, idx, p->pts, p->size);
+    dst = slot->meta->dst;
+    if ((slot->data_size + p->size) > dst->buffer_size) {
+      err("%s(%d), packet %" PRId64 " size %d exceed the frame size %" PRIu64 "\n",
+          __func__, idx, p->pts, p->size, dst->buffer_size);
+      slot->result = -ENOSPC;
+    } else {
+      mtl_memcpy((uint8_t*)dst->addr[0] + slot->data_size, p->data, p->size);
+      slot->data_size += p->size;
+    }
+    slot->pkt_done = true;
     av_packet_unref(p);
+    cnt++;
   }
 
-exit:
-  if (measure_time) {
-    end_time = st_get_monotonic_time();
-    info("%s(%d), consume time %" PRIu64 "us for frame %d\n", __func__, idx,
-         (end_time - start_time) / 1000, f_idx);
+  return cnt;
+}
+
+/* the head slot is done, call with wake_mutex locked */
+static bool encoder_head_ready(struct st22_encoder_session* s) {
+  struct st22_encoder_inflight* slot;
+
+  if (!s->inflight_cnt) return false;
+  slot = encoder_inflight(s, 0);
+  return slot->pkt_done && slot->buf_released;
+}
+
+/* put back the done frames in the submission order, return the number of frames */
+static int encoder_complete_frames(struct st22_encoder_session* s) {
+  struct st22_encoder_inflight* slot;
+  int cnt = 0;
+  int result;
+  bool ready;
+
+  while (s->inflight_cnt) {
+    st_pthread_mutex_lock(&s->wake_mutex);
+    ready = encoder_head_ready(s);
+    st_pthread_mutex_unlock(&s->wake_mutex);
+    if (!ready) break;
+
+    slot = encoder_inflight(s, 0);
+    result = slot->result;
+    if (!result && !slot->data_size) result = -EIO;
+    slot->meta->dst->data_size = slot->data_size;
+    dbg("%s(%d), bitstream data size %" PRIu64 " on frame %" PRId64 "\n", __func__,
+        s->idx, slot->data_size, slot->pts);
+    st22_encoder_put_frame(s->session_p, slot->meta, result);
+    slot->meta = NULL;
+    s->inflight_head = (s->inflight_head + 1) % ST22_ENCODER_MAX_INFLIGHT;
+    s->inflight_cnt--;
+    s->frame_cnt++;
+    s->stat_frame_cnt++;
+    cnt++;
+  }
+
+  return cnt;
+}
+
+/* drain the codec and put back all the frames still in flight */
+static void encoder_drain(struct st22_encoder_session* s) {
+  struct st22_encoder_inflight* slot;
+
+  if (!s->inflight_cnt) return;
+
+  avcodec_send_frame(s->codec_ctx, NULL);
+  encoder_receive_packets(s);
+  st_pthread_mutex_lock(&s->wake_mutex);
+  for (int i = 0; i < s->inflight_cnt; i++) {
+    slot = encoder_inflight(s, i);
+    if (!slot->pkt_done) {
+      slot->pkt_done = true;
+      slot->result = -EIO;
+    }
+    /* no more access to the src after the codec is drained */
+    slot->buf_released = true;
   }
-  s->frame_cnt++;
-  frame->dst->data_size = data_size;
-  dbg("%s(%d), bitstream data size %" PRIu64 " on frame %d\n", __func__, idx, data_size,
-      f_idx);
-  return data_size > 0 ? 0 : -EIO;
+  st_pthread_mutex_unlock(&s->wake_mutex);
+  encoder_complete_frames(s);
+}
+
+static void encoder_stat(struct st22_encoder_session* s) {
+  uint64_t cur_ns = st_get_monotonic_time();
+  uint64_t time_ns = cur_ns - s->stat_start_ns;
+
+  if (time_ns < (uint64_t)ST22_FFMPEG_STAT_INTERVAL_S * NS_PER_S) return;
+
+  double fps = (double)s->stat_frame_cnt * NS_PER_S / time_ns;
+  info("%s(%d), encode fps %f, frames %d, depth %d, copy %d\n", __func__, s->idx, fps,
+       s->stat_frame_cnt, s->depth, s->copy_cnt);
+  s->stat_frame_cnt = 0;
+  s->copy_cnt = 0;
+  s->stat_start_ns = cur_ns;
 }
 
 static void* encode_thread(void* arg) {
   struct st22_encoder_session* s = arg;
   st22p_encode_session session_p = s->session_p;
   struct st22_encode_frame_meta* frame;
-  int result;
+  bool busy;
 
   info("%s(%d), start\n", __func__, s->idx);
+  s->start_ns = st_get_monotonic_time();
+  s->stat_start_ns = s->start_ns;
   while (!s->stop) {
-    frame = st22_encoder_get_frame(session_p);
-    if (!frame) { /* no frame */
-      st_pthread_mutex_lock(&s->wake_mutex);
-      if (!s->stop) st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
-      st_pthread_mutex_unlock(&s->wake_mutex);
+    busy = false;
+    if (s->inflight_cnt < s->depth) {
+      frame = st22_encoder_get_frame(session_p);
+      if (frame) {
+        encoder_send_frame(s, frame);
+        busy = true;
+      }
+    }
+    if (s->inflight_cnt) {
+      if (encoder_receive_packets(s) > 0) busy = true;
+      if (encoder_complete_frames(s) > 0) busy = true;
+    }
+    encoder_stat(s);
+    if (busy) continue;
+
+    /* the codec delay is longer than the depth, it needs more frames to output */
+    if ((s->inflight_cnt >= s->depth) && !encoder_inflight(s, 0)->pkt_done &&
+        (s->depth < ST22_ENCODER_MAX_INFLIGHT)) {
+      s->depth++;
+      warn("%s(%d), codec need more frames, increase depth to %d\n", __func__, s->idx,
+           s->depth);
       continue;
     }
-    result = encode_frame(s, frame);
-    st22_encoder_put_frame(session_p, frame, result);
+
+    st_pthread_mutex_lock(&s->wake_mutex);
+    if (!s->stop && !encoder_head_ready(s)) {
+      /* nothing signals the codec output, poll it while a frame waits for it */
+      if (s->inflight_cnt && !encoder_inflight(s, 0)->pkt_done)
+        st_pthread_cond_timedwait_ns(&s->wake_cond, &s->wake_mutex,
+                                     ST22_ENCODER_POLL_US * 1000);
+      else
+        st_pthread_cond_wait(&s->wake_cond, &s->wake_mutex);
+    }
+    st_pthread_mutex_unlock(&s->wake_mutex);
   }
+  encoder_drain(s);
   info("%s(%d), stop\n", __func__, s->idx);
 
   return NULL;
@@ -126,6 +363,11 @@ static int encoder_uinit_session(struct st22_encoder_session* session) {
     session->codec_frame = NULL;
   }
 
+  if (session->codec_wrap_frame) {
+    av_frame_free(&session->codec_wrap_frame);
+    session->codec_wrap_frame = NULL;
+  }
+
   if (session->codec_pkt) {
     av_packet_free(&session->codec_pkt);
     session->codec_pkt = NULL;
@@ -146,10 +388,22 @@ static int encoder_init_session(struct st22_encoder_session* session,
 
   req->max_codestream_size = req->codestream_size;
   session->req = *req;
-
-  AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+  for (int i = 0; i < ST22_ENCODER_MAX_INFLIGHT; i++) {
+    session->inflight[i].parent = session;
+  }
+  session->zero_copy = true;
+  /* frame threads of codec, leave two frames for the app and the transmitter */
+  session->depth = req->codec_thread_cnt;
+  if (session->depth > ((int)req->framebuff_cnt - 2))
+    session->depth = (int)req->framebuff_cnt - 2;
+  if (session->depth > ST22_ENCODER_MAX_INFLIGHT)
+    session->depth = ST22_ENCODER_MAX_INFLIGHT;
+  if (session->depth < 1) session->depth = 1;
+
+  const AVCodec* codec = st22_ffmpeg_find_codec(req->output_fmt, true);
   if (!codec) {
-    err("%s(%d), codec create fail\n", __func__, idx);
+    err("%s(%d), codec create fail for %s\n", __func__, idx,
+        st_frame_fmt_name(req->output_fmt));
     encoder_uinit_session(session);
     return -EIO;
   }
@@ -173,9 +427,24 @@ static int encoder_init_session(struct st22_encoder_session* session,
   c->height = req->height;
   c->time_base = (AVRational){1, fps};
   c->pix_fmt = AV_PIX_FMT_YUV422P;
-  av_opt_set(c->priv_data, "fast", "preset", 0);
-  av_opt_set(c->priv_data, "tune", "zerolatency", 0);
+  c->max_b_frames = 0;
+  av_opt_set(c->priv_data, "preset", "fast", 0);
   av_opt_set(c->priv_data, "nal-hrd", "cbr", 0);
+  if (session->depth > 1) {
+    /* frame threading, no lookahead to keep the codec delay within the depth */
+    char params[64];
+
+    c->thread_count = session->depth;
+    c->thread_type = FF_THREAD_FRAME;
+    av_opt_set(c->priv_data, "x264-params", "rc-lookahead=0:sync-lookahead=0", 0);
+    snprintf(params, sizeof(params), "frame-threads=%d:rc-lookahead=0:bframes=0",
+             session->depth);
+    av_opt_set(c->priv_data, "x265-params", params, 0);
+  } else {
+    c->thread_count = req->codec_thread_cnt;
+    c->thread_type = FF_THREAD_SLICE;
+    av_opt_set(c->priv_data, "tune", "zerolatency", 0);
+  }
 
   ret = avcodec_open2(c, codec, NULL);
   if (ret < 0) {
@@ -201,6 +470,13 @@ static int encoder_init_session(struct st22_encoder_session* session,
     return -EIO;
   }
 
+  session->codec_wrap_frame = av_frame_alloc();
+  if (!session->codec_wrap_frame) {
+    err("%s(%d), wrap frame alloc fail\n", __func__, idx);
+    encoder_uinit_session(session);
+    return -EIO;
+  }
+
   AVPacket* p = av_packet_alloc();
   if (!p) {
     err("%s(%d), pkt alloc fail\n", __func__, idx);
@@ -216,6 +492,8 @@ static int encoder_init_session(struct st22_encoder_session* session,
     return ret;
   }
 
+  info("%s(%d), codec %s, depth %d, threads %d\n", __func__, idx, codec->name,
+       session->depth, c->thread_count);
   return 0;
 }
 
@@ -256,10 +534,13 @@ static int encoder_free_session(void* priv, st22_encode_priv session) {
   struct st22_encoder_session* encoder_session = session;
   int idx = encoder_session->idx;
 
-  info("%s(%d), total %d encode frames\n", __func__, idx, encoder_session->frame_cnt);
-
   encoder_uinit_session(encoder_session);
 
+  uint64_t time_ns = st_get_monotonic_time() - encoder_session->start_ns;
+  double fps = time_ns ? ((double)encoder_session->frame_cnt * NS_PER_S / time_ns) : 0;
+  info("%s(%d), total %d encode frames, avg fps %f\n", __func__, idx,
+       encoder_session->frame_cnt, fps);
+
   free(encoder_session);
   ctx->encoder_sessions[idx] = NULL;
   return 0;
@@ -396,20 +677,16 @@ static int decoder_init_session(struct st22_decoder_session* session,
 
   session->req = *req;
 
-  AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+  const AVCodec* codec = st22_ffmpeg_find_codec(req->input_fmt, false);
   if (!codec) {
-    err("%s(%d), codec create fail\n", __func__, idx);
+    err("%s(%d), codec create fail for %s\n", __func__, idx,
+        st_frame_fmt_name(req->input_fmt));
     decoder_uinit_session(session);
     return -EIO;
   }
 
-  AVCodecParserContext* parser = av_parser_init(codec->id);
-  if (!parser) {
-    err("%s(%d), parser create fail\n", __func__, idx);
-    decoder_uinit_session(session);
-    return -EIO;
-  }
-  session->codec_parser = parser;
+  /* not all codecs have a parser, ex: jpegxs */
+  session->codec_parser = av_parser_init(codec->id);
 
   AVCodecContext* c = avcodec_alloc_context3(codec);
   if (!c) {
@@ -424,6 +701,9 @@ static int decoder_init_session(struct st22_decoder_session* session,
   c->time_base = (AVRational){1, 60};
   c->framerate = (AVRational){60, 1};
   c->pix_fmt = AV_PIX_FMT_YUV422P;
+  /* slice threading only, frame threading delay the output of one packet */
+  c->thread_count = req->codec_thread_cnt;
+  c->thread_type = FF_THREAD_SLICE;
 
   ret = avcodec_open2(c, codec, NULL);
   if (ret < 0) {
@@ -531,7 +811,7 @@ st_plugin_priv st_plugin_create(mtl_handle st) {
   d_dev.name = "st22_ffmpeg_plugin_decoder";
   d_dev.priv = ctx;
   d_dev.target_device = ST_PLUGIN_DEVICE_CPU;
-  d_dev.input_fmt_caps = ST_FMT_CAP_H264_CBR_CODESTREAM;
+  d_dev.input_fmt_caps = st22_ffmpeg_codestream_caps(false);
   d_dev.output_fmt_caps = ST_FMT_CAP_YUV422PLANAR8;
   d_dev.create_session = decoder_create_session;
   d_dev.free_session = decoder_free_session;
@@ -549,7 +829,7 @@ st_plugin_priv st_plugin_create(mtl_handle st) {
   e_dev.priv = ctx;
   e_dev.target_device = ST_PLUGIN_DEVICE_CPU;
   e_dev.input_fmt_caps = ST_FMT_CAP_YUV422PLANAR8;
-  e_dev.output_fmt_caps = ST_FMT_CAP_H264_CBR_CODESTREAM;
+  e_dev.output_fmt_caps = st22_ffmpeg_codestream_caps(true);
   e_dev.create_session = encoder_create_session;
   e_dev.free_session = encoder_free_session;
   e_dev.notify_frame_available = encoder_frame_available;
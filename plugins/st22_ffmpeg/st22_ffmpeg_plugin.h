@@ -6,12 +6,39 @@
 #define _ST22_FFMPEG_PLUGIN_HEAD_H_
 
 #include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 #include <mtl/st_pipeline_api.h>
 
 #define MAX_ST22_ENCODER_SESSIONS (8)
 #define MAX_ST22_DECODER_SESSIONS (8)
 
+/* max frames in flight for one encoder session */
+#define ST22_ENCODER_MAX_INFLIGHT (8)
+/* the interval to poll the codec output when frames wait for it */
+#define ST22_ENCODER_POLL_US (1000)
+/* the interval for the per session fps report */
+#define ST22_FFMPEG_STAT_INTERVAL_S (10)
+/* the ffmpeg encoder/decoder name for jpegxs */
+#define ST22_FFMPEG_JPEGXS_CODEC_NAME "libsvtjpegxs"
+/* the plane align required to feed the src frame to codec without copy */
+#define ST22_FFMPEG_ZERO_COPY_ALIGN (32)
+
+struct st22_encoder_session;
+
+/* one frame handed to the codec but not yet put back to the lib */
+struct st22_encoder_inflight {
+  struct st22_encoder_session* parent;
+  struct st22_encode_frame_meta* meta;
+  int64_t pts;
+  /* the codestream of this frame is received */
+  bool pkt_done;
+  /* the codec released the src buffer wrapped by av_buffer_create */
+  bool buf_released;
+  int result;
+  size_t data_size;
+};
+
 struct st22_encoder_session {
   int idx;
 
@@ -20,14 +47,31 @@ struct st22_encoder_session {
   bool stop;
   pthread_t encode_thread;
   pthread_cond_t wake_cond;
+  /* also protect the buf_released of inflight */
   pthread_mutex_t wake_mutex;
 
   int frame_cnt;
   int frame_idx;
 
+  /* frames in flight, a fifo in the submission order */
+  struct st22_encoder_inflight inflight[ST22_ENCODER_MAX_INFLIGHT];
+  int inflight_head;
+  int inflight_cnt;
+  /* max frames in flight */
+  int depth;
+  /* wrap the src frame to AVFrame without copy */
+  bool zero_copy;
+  int copy_cnt;
+
+  uint64_t stat_start_ns;
+  int stat_frame_cnt;
+  uint64_t start_ns;
+
   /* AVCodec info */
   AVCodecContext* codec_ctx;
   AVFrame* codec_frame;
+  /* the AVFrame which wrap the src frame of lib */
+  AVFrame* codec_wrap_frame;
   AVPacket* codec_pkt;
 };
 
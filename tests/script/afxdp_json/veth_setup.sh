@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright 2022 Intel Corporation
+
+# Create a veth pair with one end inside a local network namespace, for the AF_XDP
+# test without a physical NIC. The tx runs in the namespace and the rx on the host:
+# sudo ip netns exec ${NETNS} ./build/app/RxTxApp --config_file <tx json> ...
+
+set -e
+
+NETNS=mtl_xdp
+VETH_HOST=veth_mtl0
+VETH_NS=veth_mtl1
+QUEUES=4
+
+if [ "$1" == "clean" ]; then
+    sudo ip netns del ${NETNS} || true
+    sudo ip link del ${VETH_HOST} || true
+    exit 0
+fi
+
+echo "Create ${VETH_HOST} <-> ${VETH_NS}(${NETNS})"
+sudo ip netns add ${NETNS}
+sudo ip link add ${VETH_HOST} numtxqueues ${QUEUES} numrxqueues ${QUEUES} type veth \
+    peer name ${VETH_NS} numtxqueues ${QUEUES} numrxqueues ${QUEUES}
+sudo ip link set ${VETH_NS} netns ${NETNS}
+
+sudo ip addr add 192.168.108.101/24 dev ${VETH_HOST}
+sudo ip link set ${VETH_HOST} up
+sudo ip netns exec ${NETNS} ip addr add 192.168.108.102/24 dev ${VETH_NS}
+sudo ip netns exec ${NETNS} ip link set ${VETH_NS} up
+sudo ip netns exec ${NETNS} ip link set lo up
+
+echo "Config busy poll"
+# veth has no hw irq, gro is required for the napi context used by busy poll
+sudo ethtool -K ${VETH_HOST} gro on
+sudo ip netns exec ${NETNS} ethtool -K ${VETH_NS} gro on
+echo 2 | sudo tee /sys/class/net/${VETH_HOST}/napi_defer_hard_irqs
+echo 200000 | sudo tee /sys/class/net/${VETH_HOST}/gro_flush_timeout
+sudo ip netns exec ${NETNS} sh -c "echo 2 > /sys/class/net/${VETH_NS}/napi_defer_hard_irqs"
+sudo ip netns exec ${NETNS} sh -c "echo 200000 > /sys/class/net/${VETH_NS}/gro_flush_timeout"
+
+echo "Disable rp_filter"
+sudo sysctl -w net.ipv4.conf.all.rp_filter=0
+sudo ip netns exec ${NETNS} sysctl -w net.ipv4.conf.all.rp_filter=0
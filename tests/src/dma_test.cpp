@@ -377,6 +377,40 @@ TEST(Dma, map_fail) {
   free(p);
 }
 
+static bool test_dma_range_overlap(uint64_t a, size_t a_sz, uint64_t b, size_t b_sz) {
+  return (a < (b + b_sz)) && (b < (a + a_sz));
+}
+
+TEST(Dma, map_iova_range) {
+  struct st_tests_context* ctx = st_test_ctx();
+  auto st = ctx->handle;
+  size_t pg_sz = mtl_page_size(st);
+  size_t size = 64 * pg_sz;
+  uint8_t* p[2];
+  uint8_t* align[2];
+  mtl_iova_t iova[2];
+
+  /* a hugepage buffer, the mapped iova should never fall into the memseg va */
+  void* hp = mtl_hp_malloc(st, pg_sz, MTL_PORT_P);
+  ASSERT_TRUE(hp != NULL);
+
+  for (int i = 0; i < 2; i++) {
+    p[i] = (uint8_t*)malloc(size + 2 * pg_sz);
+    ASSERT_TRUE(p[i] != NULL);
+    align[i] = (uint8_t*)MTL_ALIGN((uint64_t)p[i], pg_sz);
+    iova[i] = mtl_dma_map(st, align[i], size);
+    EXPECT_TRUE(iova[i] != MTL_BAD_IOVA);
+    EXPECT_FALSE(test_dma_range_overlap(iova[i], size, (uint64_t)hp, pg_sz));
+  }
+  EXPECT_FALSE(test_dma_range_overlap(iova[0], size, iova[1], size));
+
+  for (int i = 0; i < 2; i++) {
+    if (iova[i] != MTL_BAD_IOVA) EXPECT_GE(mtl_dma_unmap(st, align[i], iova[i], size), 0);
+    free(p[i]);
+  }
+  mtl_hp_free(st, hp);
+}
+
 static void test_dma_remap(struct st_tests_context* ctx, size_t size) {
   auto st = ctx->handle;
   size_t pg_sz = mtl_page_size(st);
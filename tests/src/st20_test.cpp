@@ -10,6 +10,8 @@
 #define ST20_TRAIN_TIME_S (0) /* 0 for runtime rl */
 
 #define ST20_TEST_PAYLOAD_TYPE (112)
+#define ST20_TEST_FEC_PAYLOAD_TYPE (113)
+#define ST20_TEST_CRC_RX_MAX (1024)
 
 static int tx_next_video_frame(void* priv, uint16_t* next_frame_idx,
                                struct st20_tx_frame_meta* meta) {
@@ -4558,4 +4560,1109 @@ TEST(St20_rx, linesize_digest_ext_s3) {
                           ST20_FMT_YUV_422_10BIT};
   st20_linesize_digest_test(packing, fps, width, height, linesize, interlaced, fmt, true,
                             ST_TEST_LEVEL_MANDATORY, 3, true);
-}
\ No newline at end of file
+}
+/* each rx session on its own xsk queue, all the queues share one umem */
+TEST(St20_rx, digest_frame_afxdp_shared_umem_s4) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+
+  if ((ctx->para.pmd[MTL_PORT_R] != MTL_PMD_DPDK_AF_XDP) ||
+      !(ctx->para.flags & MTL_FLAG_AF_XDP_SHARED_UMEM)) {
+    info("%s, only for af_xdp port with --afxdp_shared_umem\n", __func__);
+    return;
+  }
+
+  enum st20_type type[4] = {ST20_TYPE_FRAME_LEVEL, ST20_TYPE_FRAME_LEVEL,
+                            ST20_TYPE_FRAME_LEVEL, ST20_TYPE_FRAME_LEVEL};
+  enum st20_packing packing[4] = {ST20_PACKING_BPM, ST20_PACKING_GPM, ST20_PACKING_BPM,
+                                  ST20_PACKING_GPM_SL};
+  enum st_fps fps[4] = {ST_FPS_P59_94, ST_FPS_P50, ST_FPS_P29_97, ST_FPS_P59_94};
+  int width[4] = {1920, 1280, 1920, 1280};
+  int height[4] = {1080, 720, 1080, 720};
+  bool interlaced[4] = {false, false, false, false};
+  enum st20_fmt fmt[4] = {ST20_FMT_YUV_422_10BIT, ST20_FMT_YUV_422_10BIT,
+                          ST20_FMT_YUV_422_10BIT, ST20_FMT_YUV_422_10BIT};
+  st20_rx_digest_test(type, type, packing, fps, width, height, interlaced, fmt, true,
+                      ST_TEST_LEVEL_MANDATORY, 4);
+}
+
+/* hooks of st20_rx_loop_test to adjust the ops and check the result of one feature */
+struct st20_loop_hooks {
+  void (*tx_ops)(tests_context* s, struct st20_tx_ops* ops);
+  void (*rx_ops)(tests_context* s, struct st20_rx_ops* ops);
+  void (*check)(tests_context* tx, tests_context* rx);
+  /* run between the start and stop, replace the sleep of duration_s */
+  void (*run)(tests_context* tx, tests_context* rx);
+  int duration_s; /* 0 for 10s */
+};
+
+/*
+ * One 1080p frame level session, tx on port P and rx on port R. The complete frames are
+ * checked against the sha of the tx frames, the incomplete ones are counted only.
+ */
+static void st20_rx_loop_test(struct st20_loop_hooks* hooks) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops_tx;
+  struct st20_rx_ops ops_rx;
+  struct st20_pgroup st20_pg;
+  int ret;
+
+  if (ctx->para.num_ports != 2) {
+    info("%s, dual port should be enabled, one for tx and one for rx\n", __func__);
+    return;
+  }
+
+  auto tx = new tests_context();
+  ASSERT_TRUE(tx != NULL);
+  tx->idx = 0;
+  tx->ctx = ctx;
+  tx->fb_cnt = TEST_SHA_HIST_NUM;
+  tx->fb_idx = 0;
+  st20_tx_ops_init(tx, &ops_tx);
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_R], MTL_IP_ADDR_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = 10100;
+  ops_tx.packing = ST20_PACKING_BPM;
+  if (hooks->tx_ops) hooks->tx_ops(tx, &ops_tx);
+  st20_tx_handle tx_handle = st20_tx_create(m_handle, &ops_tx);
+  ASSERT_TRUE(tx_handle != NULL);
+
+  st20_get_pgroup(ops_tx.fmt, &st20_pg);
+  size_t frame_size = ops_tx.width * ops_tx.height * st20_pg.size / st20_pg.coverage;
+  tx->frame_size = frame_size;
+  for (int frame = 0; frame < TEST_SHA_HIST_NUM; frame++) {
+    uint8_t* fb = (uint8_t*)st20_tx_get_framebuffer(tx_handle, frame);
+    ASSERT_TRUE(fb != NULL);
+    st_test_rand_data(fb, frame_size, frame);
+    SHA256((unsigned char*)fb, frame_size, tx->shas[frame]);
+  }
+  tx->handle = tx_handle;
+
+  auto rx = new tests_context();
+  ASSERT_TRUE(rx != NULL);
+  rx->idx = 0;
+  rx->ctx = ctx;
+  rx->fb_cnt = 3;
+  rx->fb_idx = 0;
+  rx->frame_size = frame_size;
+  rx->fb_size = frame_size;
+  memcpy(rx->shas, tx->shas, TEST_SHA_HIST_NUM * SHA256_DIGEST_LENGTH);
+  st20_rx_ops_init(rx, &ops_rx);
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], ctx->para.port[MTL_PORT_R], MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = 10100;
+  ops_rx.notify_frame_ready = st20_digest_rx_frame_ready;
+  if (hooks->rx_ops) hooks->rx_ops(rx, &ops_rx);
+  st20_rx_handle rx_handle = st20_rx_create(m_handle, &ops_rx);
+  ASSERT_TRUE(rx_handle != NULL);
+  rx->handle = rx_handle;
+  rx->stop = false;
+  std::thread sha_check = std::thread(st20_digest_rx_frame_check, rx);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  if (hooks->run)
+    hooks->run(tx, rx);
+  else
+    sleep(hooks->duration_s ? hooks->duration_s : 10);
+
+  rx->stop = true;
+  {
+    std::unique_lock<std::mutex> lck(rx->mtx);
+    rx->cv.notify_all();
+  }
+  sha_check.join();
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+
+  info("%s, fb_send %d fb_rec %d incomplete %d sha checked %d fail %d\n", __func__,
+       tx->fb_send, rx->fb_rec, rx->incomplete_frame_cnt, rx->check_sha_frame_cnt,
+       rx->fail_cnt);
+  if (hooks->check) hooks->check(tx, rx);
+
+  ret = st20_tx_free(tx_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_rx_free(rx_handle);
+  EXPECT_GE(ret, 0);
+  tests_context_unit(tx);
+  tests_context_unit(rx);
+  delete tx;
+  delete rx;
+}
+
+static void st20_memif_impair_check(tests_context* tx, tests_context* rx) {
+  /* the reordered frames are rebuilt, only the lost pkts make a frame incomplete */
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+  EXPECT_GT(rx->incomplete_frame_cnt, 0);
+  EXPECT_LT(rx->fb_rec + rx->incomplete_frame_cnt, tx->fb_send + 1);
+}
+
+/* run with --memif_rx_loss and --memif_rx_reorder(and --memif_rx_jitter optional) */
+TEST(St20_rx, memif_impair_loss_reorder) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct mtl_memif_params* impair = &ctx->para.memif_info[MTL_PORT_R];
+  struct st20_loop_hooks hooks;
+
+  if ((ctx->para.pmd[MTL_PORT_P] != MTL_PMD_DPDK_MEMIF) ||
+      (ctx->para.pmd[MTL_PORT_R] != MTL_PMD_DPDK_MEMIF) || !impair->rx_loss_ppm ||
+      !impair->rx_reorder_ppm) {
+    info("%s, only for memif ports with the rx loss and reorder\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.check = st20_memif_impair_check;
+  st20_rx_loop_test(&hooks);
+}
+
+static void st20_ssm_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  memcpy(ops->dip_addr[MTL_PORT_P], s->ctx->mcast_ip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+}
+
+static void st20_ssm_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  memcpy(ops->sip_addr[MTL_PORT_P], s->ctx->mcast_ip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  /* only the group from the tx port */
+  memcpy(ops->mcast_sip_addr[MTL_PORT_P], s->ctx->para.sip_addr[MTL_PORT_P],
+         MTL_IP_ADDR_LEN);
+}
+
+static void st20_ssm_check(tests_context* tx, tests_context* rx) {
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+/* the source filtered multicast join, the group is received from the allowed source */
+TEST(St20_rx, mcast_ssm) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_ssm_tx_ops;
+  hooks.rx_ops = st20_ssm_rx_ops;
+  hooks.check = st20_ssm_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+static void st20_ssm_deny_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  st20_ssm_rx_ops(s, ops);
+  /* a source other than the tx port */
+  ops->mcast_sip_addr[MTL_PORT_P][3] ^= 0x80;
+}
+
+static void st20_ssm_deny_check(tests_context* tx, tests_context* rx) {
+  EXPECT_GT(tx->fb_send, 0);
+  EXPECT_EQ(rx->fb_rec, 0);
+  EXPECT_EQ(rx->incomplete_frame_cnt, 0);
+}
+
+/* the group from a source not allowed by the join is dropped */
+TEST(St20_rx, mcast_ssm_deny) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_ssm_tx_ops;
+  hooks.rx_ops = st20_ssm_deny_rx_ops;
+  hooks.check = st20_ssm_deny_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+static void st20_ebu_check(tests_context* tx, tests_context* rx) {
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+/* run with --ebu, the compliance check runs on every pkt and prints the result */
+TEST(St20_rx, ebu_check) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct st20_loop_hooks hooks;
+
+  if (!(ctx->para.flags & MTL_FLAG_RX_VIDEO_EBU)) {
+    info("%s, only with the rx video ebu\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.check = st20_ebu_check;
+  /* one ebu result every 300 frames */
+  hooks.duration_s = 12;
+  st20_rx_loop_test(&hooks);
+}
+
+static void st20_dma_offload_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  ops->flags |= ST20_RX_FLAG_DMA_OFFLOAD;
+}
+
+static void st20_dma_offload_check(tests_context* tx, tests_context* rx) {
+  EXPECT_TRUE(st20_rx_dma_enabled((st20_rx_handle)rx->handle));
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+static void st20_dma_no_offload_check(tests_context* tx, tests_context* rx) {
+  /* the cpu engine is opt-in, no dma without ST20_RX_FLAG_DMA_OFFLOAD */
+  EXPECT_FALSE(st20_rx_dma_enabled((st20_rx_handle)rx->handle));
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+/* run with --dma_cpu_engine and without --dma_dev */
+TEST(St20_rx, dma_cpu_engine) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct st20_loop_hooks hooks;
+
+  if (!(ctx->para.flags & MTL_FLAG_DMA_CPU_ENGINE) || ctx->para.num_dma_dev_port) {
+    info("%s, only for the cpu dma engine without dma dev\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.rx_ops = st20_dma_offload_rx_ops;
+  hooks.check = st20_dma_offload_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.check = st20_dma_no_offload_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+/* the tx is paused when the priv is set, the rx queue goes quiet then */
+static int st20_rx_intr_next_frame(void* priv, uint16_t* next_frame_idx,
+                                   struct st20_tx_frame_meta* meta) {
+  auto ctx = (tests_context*)priv;
+
+  if (ctx->priv) return -EIO;
+  return tx_next_video_frame(priv, next_frame_idx, meta);
+}
+
+static void st20_rx_intr_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  ops->get_next_frame = st20_rx_intr_next_frame;
+}
+
+static void st20_rx_intr_run(tests_context* tx, tests_context* rx) {
+  auto m_handle = rx->ctx->handle;
+  int sch_idx = st20_rx_get_sch_idx((st20_rx_handle)rx->handle);
+  struct mtl_sch_stats stats;
+  int ret;
+
+  ASSERT_GE(sch_idx, 0);
+  sleep(2);
+  /* pause the tx, the rx queue is quiet longer than rx_intr_idle_us */
+  tx->priv = tx;
+  sleep(2);
+  int fb_rec_quiet = rx->fb_rec;
+  ret = mtl_sch_get_stats(m_handle, sch_idx, &stats);
+  EXPECT_GE(ret, 0);
+  uint64_t wakeups = stats.rx_intr_wakeups;
+  /* resume, the first packet wakes the sch from the rx interrupt */
+  tx->priv = NULL;
+  sleep(2);
+
+  ret = mtl_sch_get_stats(m_handle, sch_idx, &stats);
+  EXPECT_GE(ret, 0);
+  info("%s, sch %d wakeups %" PRIu64 ", max %uus avg %fus\n", __func__, sch_idx,
+       stats.rx_intr_wakeups, stats.rx_intr_wake_max_us, stats.rx_intr_wake_avg_us);
+  EXPECT_GT(stats.rx_intr_wakeups, wakeups);
+  EXPECT_GT(stats.rx_intr_wake_avg_us, 0.0);
+  EXPECT_LE(stats.rx_intr_wake_avg_us, (float)stats.rx_intr_wake_max_us + 1);
+  /* the rx is back to polling after the wakeup */
+  EXPECT_GT(rx->fb_rec, fb_rec_quiet + 30);
+}
+
+static void st20_rx_intr_check(tests_context* tx, tests_context* rx) {
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+/* run with --rx_intr --tasklet_sleep on the ports which support the rx interrupt */
+TEST(St20_rx, rx_intr_wakeup) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct st20_loop_hooks hooks;
+
+  if (!(ctx->para.flags & MTL_FLAG_RX_INTR) ||
+      !(ctx->para.flags & MTL_FLAG_TASKLET_SLEEP)) {
+    info("%s, only for the rx intr with the tasklet sleep\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_rx_intr_tx_ops;
+  hooks.run = st20_rx_intr_run;
+  hooks.check = st20_rx_intr_check;
+  st20_rx_loop_test(&hooks);
+}
+
+static void st20_fec_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  ops->fec_cols = 8;
+  ops->fec_rows = 4;
+  ops->fec_payload_type = ST20_TEST_FEC_PAYLOAD_TYPE;
+}
+
+static void st20_fec_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  ops->fec_payload_type = ST20_TEST_FEC_PAYLOAD_TYPE;
+}
+
+static void st20_fec_check(tests_context* tx, tests_context* rx) {
+  /* every frame lost pkts, all rebuilt by the row fec */
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+  /* the first frame may start before the rx is ready */
+  EXPECT_LE(rx->incomplete_frame_cnt, 1);
+}
+
+/* run with --fec_test_drop, the tx loses the first pkt of the first rows */
+TEST(St20_rx, fec_recover_lost_pkts) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct st20_loop_hooks hooks;
+
+  if (!(ctx->para.flags & MTL_FLAG_TX_VIDEO_FEC_TEST_DROP)) {
+    info("%s, only with the fec test drop\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_fec_tx_ops;
+  hooks.rx_ops = st20_fec_rx_ops;
+  hooks.check = st20_fec_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+/* the crc reported by the lib, checked against the tx frames once stopped */
+static struct {
+  uint32_t tx[TEST_SHA_HIST_NUM];
+  bool tx_got[TEST_SHA_HIST_NUM];
+  int tx_mismatch; /* one frame with different crc on the sends */
+  uint32_t rx[ST20_TEST_CRC_RX_MAX];
+  int rx_cnt;
+} st20_crc_seen;
+
+/* the reference crc32c(castagnoli), bit by bit */
+static uint32_t st20_test_crc32c(const uint8_t* p, size_t len) {
+  uint32_t crc = 0xFFFFFFFF;
+
+  for (size_t i = 0; i < len; i++) {
+    crc ^= p[i];
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+static int st20_crc_tx_frame_done(void* priv, uint16_t frame_idx,
+                                  struct st20_tx_frame_meta* meta) {
+  if (frame_idx >= TEST_SHA_HIST_NUM) return -EIO;
+  if (st20_crc_seen.tx_got[frame_idx] && (st20_crc_seen.tx[frame_idx] != meta->crc))
+    st20_crc_seen.tx_mismatch++;
+  st20_crc_seen.tx[frame_idx] = meta->crc;
+  st20_crc_seen.tx_got[frame_idx] = true;
+  return 0;
+}
+
+static int st20_crc_rx_frame_ready(void* priv, void* frame,
+                                   struct st20_rx_frame_meta* meta) {
+  if (st_is_frame_complete(meta->status) &&
+      (meta->frame_recv_size == meta->frame_total_size) &&
+      (st20_crc_seen.rx_cnt < ST20_TEST_CRC_RX_MAX))
+    st20_crc_seen.rx[st20_crc_seen.rx_cnt++] = meta->crc;
+  return st20_digest_rx_frame_ready(priv, frame, meta);
+}
+
+static void st20_crc_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  ops->flags |= ST20_TX_FLAG_ENABLE_CRC;
+  ops->notify_frame_done = st20_crc_tx_frame_done;
+}
+
+static void st20_crc_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  ops->flags |= ST20_RX_FLAG_ENABLE_CRC;
+  ops->notify_frame_ready = st20_crc_rx_frame_ready;
+}
+
+/* pkts lost and rebuilt by the fec, the rx crc is from the full frame pass then */
+static void st20_crc_lossy_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  st20_fec_tx_ops(s, ops);
+  st20_crc_tx_ops(s, ops);
+}
+
+static void st20_crc_lossy_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  st20_fec_rx_ops(s, ops);
+  st20_crc_rx_ops(s, ops);
+}
+
+static void st20_crc_check(tests_context* tx, tests_context* rx) {
+  uint32_t expect[TEST_SHA_HIST_NUM];
+  int rx_fail = 0;
+
+  for (int i = 0; i < TEST_SHA_HIST_NUM; i++) {
+    uint8_t* fb = (uint8_t*)st20_tx_get_framebuffer((st20_tx_handle)tx->handle, i);
+    ASSERT_TRUE(fb != NULL);
+    expect[i] = st20_test_crc32c(fb, tx->frame_size);
+    if (st20_crc_seen.tx_got[i]) EXPECT_EQ(st20_crc_seen.tx[i], expect[i]);
+  }
+  EXPECT_TRUE(st20_crc_seen.tx_got[0]);
+  EXPECT_EQ(st20_crc_seen.tx_mismatch, 0);
+
+  /* each complete rx frame has the crc of one tx frame */
+  EXPECT_GT(st20_crc_seen.rx_cnt, 0);
+  for (int i = 0; i < st20_crc_seen.rx_cnt; i++) {
+    int j;
+    for (j = 0; j < TEST_SHA_HIST_NUM; j++) {
+      if (st20_crc_seen.rx[i] == expect[j]) break;
+    }
+    if (j >= TEST_SHA_HIST_NUM) rx_fail++;
+  }
+  EXPECT_EQ(rx_fail, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+TEST(St20_rx, crc_tx_rx) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_crc_tx_ops;
+  hooks.rx_ops = st20_crc_rx_ops;
+  hooks.check = st20_crc_check;
+  hooks.duration_s = 5;
+  memset(&st20_crc_seen, 0, sizeof(st20_crc_seen));
+  st20_rx_loop_test(&hooks);
+
+  hooks.tx_ops = st20_crc_lossy_tx_ops;
+  hooks.rx_ops = st20_crc_lossy_rx_ops;
+  memset(&st20_crc_seen, 0, sizeof(st20_crc_seen));
+  st20_rx_loop_test(&hooks);
+}
+
+/* the tx of port R loops back to the rx of port P, the P link as st20_rx_loop_test */
+static void st20_stripe_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  struct st_tests_context* ctx = s->ctx;
+
+  ops->flags |= ST20_TX_FLAG_PORT_STRIPE;
+  ops->num_port = 2;
+  memcpy(ops->dip_addr[MTL_PORT_R], ctx->para.sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  strncpy(ops->port[MTL_PORT_R], ctx->para.port[MTL_PORT_R], MTL_PORT_MAX_LEN);
+  ops->udp_port[MTL_PORT_R] = ops->udp_port[MTL_PORT_P];
+}
+
+static void st20_stripe_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  struct st_tests_context* ctx = s->ctx;
+
+  ops->flags |= ST20_RX_FLAG_PORT_STRIPE;
+  ops->num_port = 2;
+  memcpy(ops->sip_addr[MTL_PORT_R], ctx->para.sip_addr[MTL_PORT_R], MTL_IP_ADDR_LEN);
+  strncpy(ops->port[MTL_PORT_R], ctx->para.port[MTL_PORT_P], MTL_PORT_MAX_LEN);
+  ops->udp_port[MTL_PORT_R] = ops->udp_port[MTL_PORT_P];
+}
+
+static void st20_stripe_check(tests_context* tx, tests_context* rx) {
+  /* the two half streams merge into the tx frames */
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+  /* the first frame may start before the rx is ready */
+  EXPECT_LE(rx->incomplete_frame_cnt, 1);
+}
+
+/* the R link is down, the odd pkts of every frame go to a port nobody receives */
+static void st20_stripe_link_down_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  st20_stripe_tx_ops(s, ops);
+  ops->udp_port[MTL_PORT_R] = ops->udp_port[MTL_PORT_P] + 1;
+}
+
+static void st20_stripe_link_down_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  st20_stripe_rx_ops(s, ops);
+  ops->flags |= ST20_RX_FLAG_RECEIVE_INCOMPLETE_FRAME;
+}
+
+static void st20_stripe_link_down_check(tests_context* tx, tests_context* rx) {
+  /* half of each frame got, all reported as incomplete */
+  EXPECT_GT(tx->fb_send, 0);
+  EXPECT_GT(rx->incomplete_frame_cnt, 0);
+  EXPECT_EQ(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fb_rec, 0);
+}
+
+/* the R link is lost for a while, the frames after it are placed by the P frame head */
+static void st20_stripe_r_loss_run(tests_context* tx, tests_context* rx) {
+  struct st_tests_context* ctx = rx->ctx;
+  st20_rx_handle rx_handle = (st20_rx_handle)rx->handle;
+  struct st_rx_source_info src;
+  int ret;
+
+  memset(&src, 0, sizeof(src));
+  memcpy(src.sip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  memcpy(src.sip_addr[MTL_PORT_R], ctx->para.sip_addr[MTL_PORT_R], MTL_IP_ADDR_LEN);
+  src.udp_port[MTL_PORT_P] = 10100;
+  src.udp_port[MTL_PORT_R] = 10100 + 1; /* the tx sends nothing to it */
+
+  sleep(2);
+  ret = st20_rx_update_source(rx_handle, &src);
+  EXPECT_GE(ret, 0);
+  sleep(1);
+  src.udp_port[MTL_PORT_R] = 10100;
+  ret = st20_rx_update_source(rx_handle, &src);
+  EXPECT_GE(ret, 0);
+  int fb_rec = rx->fb_rec;
+  sleep(2);
+  /* complete again once the R link is back */
+  EXPECT_GT(rx->fb_rec, fb_rec);
+}
+
+static void st20_stripe_r_loss_check(tests_context* tx, tests_context* rx) {
+  /* the frames without the odd pkts are incomplete, the others match the tx */
+  EXPECT_GT(rx->incomplete_frame_cnt, 0);
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+}
+
+TEST(St20_rx, port_stripe) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_stripe_tx_ops;
+  hooks.rx_ops = st20_stripe_rx_ops;
+  hooks.check = st20_stripe_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+TEST(St20_rx, port_stripe_link_down) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_stripe_link_down_tx_ops;
+  hooks.rx_ops = st20_stripe_link_down_rx_ops;
+  hooks.check = st20_stripe_link_down_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+TEST(St20_rx, port_stripe_r_loss) {
+  struct st20_loop_hooks hooks;
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_stripe_tx_ops;
+  /* the incomplete frames are passed to the app */
+  hooks.rx_ops = st20_stripe_link_down_rx_ops;
+  hooks.run = st20_stripe_r_loss_run;
+  hooks.check = st20_stripe_r_loss_check;
+  st20_rx_loop_test(&hooks);
+}
+
+/* the unicast loop over ipv6, the tx resolves the mac of port R by NDP */
+static void st20_ipv6_tx_ops(tests_context* s, struct st20_tx_ops* ops) {
+  struct st_tests_context* ctx = s->ctx;
+
+  ops->flags |= ST20_TX_FLAG_IPV6;
+  memcpy(ops->dip6_addr[MTL_PORT_P], ctx->para.sip6_addr[MTL_PORT_R], MTL_IP6_ADDR_LEN);
+}
+
+static void st20_ipv6_rx_ops(tests_context* s, struct st20_rx_ops* ops) {
+  struct st_tests_context* ctx = s->ctx;
+
+  ops->flags |= ST20_RX_FLAG_IPV6;
+  memcpy(ops->sip6_addr[MTL_PORT_P], ctx->para.sip6_addr[MTL_PORT_P], MTL_IP6_ADDR_LEN);
+}
+
+static void st20_ipv6_check(tests_context* tx, tests_context* rx) {
+  EXPECT_GT(rx->check_sha_frame_cnt, 0);
+  EXPECT_EQ(rx->fail_cnt, 0);
+  /* the first frame may start before the neighbor is resolved */
+  EXPECT_LE(rx->incomplete_frame_cnt, 1);
+}
+
+TEST(St20_rx, ipv6) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  struct st20_loop_hooks hooks;
+
+  if ((ctx->para.pmd[MTL_PORT_P] != MTL_PMD_DPDK_USER) ||
+      (ctx->para.pmd[MTL_PORT_R] != MTL_PMD_DPDK_USER)) {
+    info("%s, only for the dpdk user ports, no NDP on the others\n", __func__);
+    return;
+  }
+
+  memset(&hooks, 0, sizeof(hooks));
+  hooks.tx_ops = st20_ipv6_tx_ops;
+  hooks.rx_ops = st20_ipv6_rx_ops;
+  hooks.check = st20_ipv6_check;
+  hooks.duration_s = 5;
+  st20_rx_loop_test(&hooks);
+}
+
+TEST(St20_tx, create_expect_fail_ipv6) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops;
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_tx_ops_init(test_ctx, &ops);
+  ops.num_port = 1;
+  ops.flags |= ST20_TX_FLAG_IPV6;
+  /* no dip6_addr */
+  EXPECT_TRUE(st20_tx_create(m_handle, &ops) == NULL);
+  /* only the frame type */
+  memcpy(ops.dip6_addr[MTL_PORT_P], ctx->para.sip6_addr[MTL_PORT_R], MTL_IP6_ADDR_LEN);
+  ops.type = ST20_TYPE_RTP_LEVEL;
+  EXPECT_TRUE(st20_tx_create(m_handle, &ops) == NULL);
+  delete test_ctx;
+}
+
+TEST(St20_rx, create_expect_fail_ipv6) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_rx_ops ops;
+  uint8_t mcast6[MTL_IP6_ADDR_LEN] = {0xff, 0x1e, 0, 0, 0, 0, 0, 0,
+                                      0,    0,    0, 0, 0, 0, 0, 1};
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_rx_ops_init(test_ctx, &ops);
+  ops.num_port = 1;
+  ops.flags |= ST20_RX_FLAG_IPV6;
+  /* no sip6_addr */
+  EXPECT_TRUE(st20_rx_create(m_handle, &ops) == NULL);
+  /* no MLDv2 for the ipv6 multicast */
+  memcpy(ops.sip6_addr[MTL_PORT_P], mcast6, MTL_IP6_ADDR_LEN);
+  EXPECT_TRUE(st20_rx_create(m_handle, &ops) == NULL);
+  /* no auto detect */
+  memcpy(ops.sip6_addr[MTL_PORT_P], ctx->para.sip6_addr[MTL_PORT_P], MTL_IP6_ADDR_LEN);
+  ops.flags |= ST20_RX_FLAG_AUTO_DETECT;
+  EXPECT_TRUE(st20_rx_create(m_handle, &ops) == NULL);
+  delete test_ctx;
+}
+
+/* run with --migrate_enable, the admin drains the light sch into the other one */
+TEST(St20_tx, migrate_consolidate) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  const int max_sessions = 32;
+  tests_context* test_ctx[max_sessions];
+  st20_tx_handle handle[max_sessions];
+  struct st20_tx_ops ops;
+  int sch[max_sessions];
+  int num = 0, second = -1;
+  int ret;
+
+  if (!(ctx->para.flags & MTL_FLAG_TX_VIDEO_MIGRATE)) {
+    info("%s, only with the tx video migrate\n", __func__);
+    return;
+  }
+
+  /* fill the first sch until one session lands on another sch */
+  for (num = 0; num < max_sessions; num++) {
+    test_ctx[num] = new tests_context();
+    ASSERT_TRUE(test_ctx[num] != NULL);
+    test_ctx[num]->idx = num;
+    test_ctx[num]->ctx = ctx;
+    test_ctx[num]->fb_cnt = 2;
+    test_ctx[num]->fb_idx = 0;
+    st20_tx_ops_init(test_ctx[num], &ops);
+    ops.num_port = 1;
+    handle[num] = st20_tx_create(m_handle, &ops);
+    ASSERT_TRUE(handle[num] != NULL);
+    test_ctx[num]->handle = handle[num];
+    sch[num] = st20_tx_get_sch_idx(handle[num]);
+    if (sch[num] != sch[0]) {
+      second = num++;
+      break;
+    }
+  }
+  /* keep one session on each sch */
+  for (int i = 1; i < num; i++) {
+    if (i == second) continue;
+    ret = st20_tx_free(handle[i]);
+    EXPECT_GE(ret, 0);
+    delete test_ctx[i];
+    handle[i] = NULL;
+  }
+
+  if (second > 0) {
+    ret = mtl_start(m_handle);
+    EXPECT_GE(ret, 0);
+    /* the admin period is 5s, and the cpu busy need one period to settle */
+    sleep(16);
+    EXPECT_EQ(st20_tx_get_sch_idx(handle[0]), st20_tx_get_sch_idx(handle[second]));
+    ret = mtl_stop(m_handle);
+    EXPECT_GE(ret, 0);
+  } else {
+    info("%s, all sessions on one sch, skip\n", __func__);
+  }
+
+  for (int i = 0; i < num; i++) {
+    if (!handle[i]) continue;
+    ret = st20_tx_free(handle[i]);
+    EXPECT_GE(ret, 0);
+    delete test_ctx[i];
+  }
+}
+
+/* a unicast peer nobody answers, the arp waiter times out and the session retries */
+TEST(St20_tx, arp_fail_event) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops;
+  int ret;
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_tx_ops_init(test_ctx, &ops);
+  ops.num_port = 1;
+  /* same subnet as the port, an address not used by the test setup */
+  memcpy(ops.dip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  ops.dip_addr[MTL_PORT_P][3] = 253;
+  ops.notify_event = test_ctx_notify_event;
+  st20_tx_handle handle = st20_tx_create(m_handle, &ops);
+  ASSERT_TRUE(handle != NULL);
+  test_ctx->handle = handle;
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  /* two rounds of the async arp timeout */
+  sleep(12);
+
+  EXPECT_GE(test_ctx->arp_fail_cnt, 1);
+  EXPECT_EQ(test_ctx->fb_send, 0);
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_tx_free(handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx;
+}
+
+TEST(St20_tx, sch_stats) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops;
+  struct mtl_sch_stats stats;
+  int ret;
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_tx_ops_init(test_ctx, &ops);
+  st20_tx_handle handle = st20_tx_create(m_handle, &ops);
+  ASSERT_TRUE(handle != NULL);
+  test_ctx->handle = handle;
+  int sch_idx = st20_tx_get_sch_idx(handle);
+  EXPECT_GE(sch_idx, 0);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  sleep(2);
+
+  ret = mtl_sch_get_stats(m_handle, sch_idx, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_GE(stats.tasklet_cnt, 1);
+  EXPECT_GE(stats.busy_ratio, 0.0);
+  EXPECT_LE(stats.busy_ratio, 100.0);
+  /* -1 for the sch in thread, else the lcore socket */
+  EXPECT_GE(stats.socket_id, -1);
+  EXPECT_GE(stats.numa_remote_est_mbs, 0.0);
+  /* invalid index */
+  ret = mtl_sch_get_stats(m_handle, -1, &stats);
+  EXPECT_LT(ret, 0);
+  ret = mtl_sch_get_stats(m_handle, 1000, &stats);
+  EXPECT_LT(ret, 0);
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_tx_free(handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx;
+}
+
+/* the remote traffic estimate is updated by the stat dump of each period */
+TEST(St20_tx, sch_stats_numa_remote_est) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops;
+  struct mtl_sch_stats stats;
+  int ret;
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_tx_ops_init(test_ctx, &ops);
+  st20_tx_handle handle = st20_tx_create(m_handle, &ops);
+  ASSERT_TRUE(handle != NULL);
+  test_ctx->handle = handle;
+  int sch_idx = st20_tx_get_sch_idx(handle);
+  EXPECT_GE(sch_idx, 0);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  /* wait one default stat period(10s) */
+  sleep(12);
+
+  ret = mtl_sch_get_stats(m_handle, sch_idx, &stats);
+  EXPECT_GE(ret, 0);
+  EXPECT_GE(stats.numa_remote_est_mbs, 0.0);
+  /* a sch in thread has no socket, nothing is counted as remote */
+  if (stats.socket_id < 0) EXPECT_EQ(stats.numa_remote_est_mbs, 0.0);
+  /* one 1080p frame per period at least, if the lcore is not local to the port */
+  if (stats.numa_remote_est_mbs > 0.0) EXPECT_GT(stats.numa_remote_est_mbs, 0.1);
+  info("%s, sch %d socket %d numa remote est %f MB/s\n", __func__, sch_idx,
+       stats.socket_id, stats.numa_remote_est_mbs);
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_tx_free(handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx;
+}
+
+/* run with --sch_elastic, the busy ratio is measured with or without the tasklet sleep */
+TEST(St20_tx, sch_elastic_busy_ratio) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops;
+  struct mtl_sch_stats stats;
+  int ret;
+
+  if (!(ctx->para.flags & MTL_FLAG_SCH_ELASTIC)) {
+    info("%s, only for the elastic sch pool\n", __func__);
+    return;
+  }
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 2;
+  test_ctx->fb_idx = 0;
+  st20_tx_ops_init(test_ctx, &ops);
+  st20_tx_handle handle = st20_tx_create(m_handle, &ops);
+  ASSERT_TRUE(handle != NULL);
+  test_ctx->handle = handle;
+  int sch_idx = st20_tx_get_sch_idx(handle);
+  EXPECT_GE(sch_idx, 0);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  /* wait the first 5s busy ratio period */
+  sleep(7);
+
+  ret = mtl_sch_get_stats(m_handle, sch_idx, &stats);
+  EXPECT_GE(ret, 0);
+  /*
+   * the sch is sending, it's neither idle nor reported as full busy, also for the busy
+   * polling sch without MTL_FLAG_TASKLET_SLEEP.
+   */
+  EXPECT_GT(stats.busy_ratio, 0.0);
+  EXPECT_LT(stats.busy_ratio, 100.0);
+  info("%s, sch %d busy ratio %f\n", __func__, sch_idx, stats.busy_ratio);
+
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_tx_free(handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx;
+}
+
+#define ST20_TEST_REPLAY_FILE "st20_replay_test.pcap"
+#define ST20_TEST_REPLAY_FRAMES (2)
+#define ST20_TEST_REPLAY_PKTS (64)      /* pkts in one frame */
+#define ST20_TEST_REPLAY_PAYLOAD (1200) /* bytes after the rfc4175 hdr */
+#define ST20_TEST_REPLAY_SSRC (0x5eed)
+/* crosses the 16 bits seq wrap in the first pass */
+#define ST20_TEST_REPLAY_SEQ_BASE (0xfff0)
+
+static struct {
+  uint32_t pkts;
+  uint32_t seq_back; /* seq not after the last one */
+  uint32_t tmstamp_back;
+  uint32_t ssrc_recorded; /* the ssrc of the capture is not rewritten */
+  bool has_last;
+  uint32_t last_seq;
+  uint32_t last_tmstamp;
+} st20_replay_seen;
+
+static void st20_replay_put_be16(uint8_t* p, uint16_t v) {
+  p[0] = v >> 8;
+  p[1] = v;
+}
+
+/* a classic pcap, us timestamp, of one rfc4175 flow with 10us between the pkts */
+static int st20_replay_write_pcap(const char* file) {
+  uint32_t file_hdr[6] = {0xa1b2c3d4, 0x00040002, 0, 0, 65535, 1};
+  uint16_t udp_len = 8 + sizeof(struct st20_rfc4175_rtp_hdr) + ST20_TEST_REPLAY_PAYLOAD;
+  uint8_t frame[14 + 20 + 8 + sizeof(struct st20_rfc4175_rtp_hdr) +
+                ST20_TEST_REPLAY_PAYLOAD];
+  uint32_t seq = ST20_TEST_REPLAY_SEQ_BASE;
+  uint32_t usec = 0;
+
+  FILE* fp = fopen(file, "wb");
+  if (!fp) return -EIO;
+  fwrite(file_hdr, sizeof(file_hdr), 1, fp);
+
+  memset(frame, 0, sizeof(frame));
+  uint8_t* ip = frame + 14;
+  uint8_t* udp = ip + 20;
+  auto rtp = (struct st20_rfc4175_rtp_hdr*)(udp + 8);
+  st20_replay_put_be16(frame + 12, 0x0800);
+  ip[0] = 0x45;
+  st20_replay_put_be16(ip + 2, 20 + udp_len);
+  ip[8] = 64;
+  ip[9] = 17; /* udp */
+  uint8_t src_ip[4] = {192, 168, 96, 1}, dst_ip[4] = {239, 96, 0, 1};
+  memcpy(ip + 12, src_ip, 4);
+  memcpy(ip + 16, dst_ip, 4);
+  st20_replay_put_be16(udp, 20000);
+  st20_replay_put_be16(udp + 2, 20000);
+  st20_replay_put_be16(udp + 4, udp_len);
+  rtp->base.version = 2;
+  rtp->base.payload_type = ST20_TEST_PAYLOAD_TYPE;
+  rtp->base.ssrc = htonl(ST20_TEST_REPLAY_SSRC);
+  rtp->row_length = htons(ST20_TEST_REPLAY_PAYLOAD);
+
+  for (int f = 0; f < ST20_TEST_REPLAY_FRAMES; f++) {
+    rtp->base.tmstamp = htonl(1000 + f * 1501);
+    for (int i = 0; i < ST20_TEST_REPLAY_PKTS; i++) {
+      uint32_t pkt_hdr[4] = {1, usec, sizeof(frame), sizeof(frame)};
+      rtp->base.seq_number = htons((uint16_t)seq);
+      rtp->seq_number_ext = htons((uint16_t)(seq >> 16));
+      rtp->base.marker = (i == ST20_TEST_REPLAY_PKTS - 1) ? 1 : 0;
+      rtp->row_number = htons(i);
+      memset(rtp + 1, seq, ST20_TEST_REPLAY_PAYLOAD);
+      fwrite(pkt_hdr, sizeof(pkt_hdr), 1, fp);
+      fwrite(frame, sizeof(frame), 1, fp);
+      seq++;
+      usec += 10;
+    }
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+static void st20_replay_rx_packets(tests_context* s) {
+  void* mbuf;
+  void* usrptr = NULL;
+  uint16_t mbuf_len = 0;
+  std::unique_lock<std::mutex> lck(s->mtx, std::defer_lock);
+
+  while (!s->stop) {
+    mbuf = st20_rx_get_mbuf((st20_rx_handle)s->handle, &usrptr, &mbuf_len);
+    if (!mbuf) {
+      lck.lock();
+      if (!s->stop) s->cv.wait(lck);
+      lck.unlock();
+      continue;
+    }
+    auto hdr = (struct st20_rfc4175_rtp_hdr*)usrptr;
+    uint32_t seq = ((uint32_t)ntohs(hdr->seq_number_ext) << 16) |
+                   ntohs(hdr->base.seq_number);
+    uint32_t tmstamp = ntohl(hdr->base.tmstamp);
+    if (st20_replay_seen.has_last) {
+      /* lost pkts are a jump forward, a new pass must not go back */
+      if ((int32_t)(seq - st20_replay_seen.last_seq) <= 0) st20_replay_seen.seq_back++;
+      if ((int32_t)(tmstamp - st20_replay_seen.last_tmstamp) < 0)
+        st20_replay_seen.tmstamp_back++;
+    }
+    if (hdr->base.ssrc == htonl(ST20_TEST_REPLAY_SSRC)) st20_replay_seen.ssrc_recorded++;
+    st20_replay_seen.has_last = true;
+    st20_replay_seen.last_seq = seq;
+    st20_replay_seen.last_tmstamp = tmstamp;
+    st20_replay_seen.pkts++;
+    st20_rx_put_mbuf((st20_rx_handle)s->handle, mbuf);
+  }
+}
+
+/* the lib replays the capture in a loop, the seq and timestamp never go back */
+TEST(St20_rx, replay_pcap_loop) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st20_tx_ops ops_tx;
+  struct st20_rx_ops ops_rx;
+  int ret;
+
+  if (ctx->para.num_ports != 2) {
+    info("%s, dual port should be enabled, one for tx and one for rx\n", __func__);
+    return;
+  }
+  ASSERT_GE(st20_replay_write_pcap(ST20_TEST_REPLAY_FILE), 0);
+  memset(&st20_replay_seen, 0, sizeof(st20_replay_seen));
+
+  auto tx = new tests_context();
+  ASSERT_TRUE(tx != NULL);
+  tx->idx = 0;
+  tx->ctx = ctx;
+  tx->fb_cnt = 2;
+  st20_tx_ops_init(tx, &ops_tx);
+  ops_tx.num_port = 1;
+  memcpy(ops_tx.dip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_R], MTL_IP_ADDR_LEN);
+  ops_tx.udp_port[MTL_PORT_P] = 10100;
+  ops_tx.type = ST20_TYPE_RTP_LEVEL;
+  ops_tx.rtp_frame_total_pkts = ST20_TEST_REPLAY_PKTS;
+  ops_tx.rtp_pkt_size = sizeof(struct st20_rfc4175_rtp_hdr) + ST20_TEST_REPLAY_PAYLOAD;
+  ops_tx.replay_url = ST20_TEST_REPLAY_FILE;
+  st20_tx_handle tx_handle = st20_tx_create(m_handle, &ops_tx);
+  ASSERT_TRUE(tx_handle != NULL);
+  tx->handle = tx_handle;
+
+  auto rx = new tests_context();
+  ASSERT_TRUE(rx != NULL);
+  rx->idx = 0;
+  rx->ctx = ctx;
+  rx->fb_cnt = 2;
+  st20_rx_ops_init(rx, &ops_rx);
+  ops_rx.num_port = 1;
+  memcpy(ops_rx.sip_addr[MTL_PORT_P], ctx->para.sip_addr[MTL_PORT_P], MTL_IP_ADDR_LEN);
+  strncpy(ops_rx.port[MTL_PORT_P], ctx->para.port[MTL_PORT_R], MTL_PORT_MAX_LEN);
+  ops_rx.udp_port[MTL_PORT_P] = 10100;
+  ops_rx.type = ST20_TYPE_RTP_LEVEL;
+  st20_rx_handle rx_handle = st20_rx_create(m_handle, &ops_rx);
+  ASSERT_TRUE(rx_handle != NULL);
+  rx->handle = rx_handle;
+  rx->stop = false;
+  std::thread rx_thread = std::thread(st20_replay_rx_packets, rx);
+
+  ret = mtl_start(m_handle);
+  EXPECT_GE(ret, 0);
+  sleep(5);
+  rx->stop = true;
+  {
+    std::unique_lock<std::mutex> lck(rx->mtx);
+    rx->cv.notify_all();
+  }
+  rx_thread.join();
+  ret = mtl_stop(m_handle);
+  EXPECT_GE(ret, 0);
+
+  info("%s, pkts %u seq back %u tmstamp back %u\n", __func__, st20_replay_seen.pkts,
+       st20_replay_seen.seq_back, st20_replay_seen.tmstamp_back);
+  /* many passes of the capture */
+  EXPECT_GT(st20_replay_seen.pkts, ST20_TEST_REPLAY_FRAMES * ST20_TEST_REPLAY_PKTS * 4);
+  EXPECT_EQ(st20_replay_seen.seq_back, 0);
+  EXPECT_EQ(st20_replay_seen.tmstamp_back, 0);
+  EXPECT_EQ(st20_replay_seen.ssrc_recorded, 0);
+
+  ret = st20_tx_free(tx_handle);
+  EXPECT_GE(ret, 0);
+  ret = st20_rx_free(rx_handle);
+  EXPECT_GE(ret, 0);
+  remove(ST20_TEST_REPLAY_FILE);
+  delete tx;
+  delete rx;
+}
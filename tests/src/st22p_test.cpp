@@ -2,6 +2,7 @@
  * Copyright(c) 2022 Intel Corporation
  */
 
+#include <atomic>
 #include <thread>
 
 #include "log.h"
@@ -369,6 +370,71 @@ TEST(St22p, plugin_register_fail) {
                        false);
 }
 
+struct plugin_job_test_ctx {
+  std::atomic<int> ready;
+  std::atomic<int> processed;
+  std::atomic<bool> freed;
+  std::atomic<int> process_after_free;
+  int process_us;
+};
+
+static int plugin_job_test_process(void* priv) {
+  auto s = (struct plugin_job_test_ctx*)priv;
+
+  if (s->freed) s->process_after_free++;
+  if (s->ready <= 0) return -EBUSY;
+  s->ready--;
+  if (s->process_us) st_usleep(s->process_us);
+  s->processed++;
+  return 0;
+}
+
+/* free the job while it is queued, running or idle, the process never runs after */
+static void plugin_job_notify_free_test(int repeat) {
+  auto ctx = st_test_ctx();
+  auto st = ctx->handle;
+  struct st_plugin_worker_stats stats;
+  struct plugin_job_test_ctx s;
+  struct st_plugin_job_ops ops;
+  st_plugin_job_handle job;
+  int nb_jobs;
+
+  memset(&ops, 0, sizeof(ops));
+  ops.name = "job_test";
+  ops.priv = &s;
+  ops.process = plugin_job_test_process;
+
+  for (int i = 0; i < repeat; i++) {
+    s.ready = 0;
+    s.processed = 0;
+    s.freed = false;
+    s.process_after_free = 0;
+    s.process_us = (i % 4) * 100;
+
+    job = st_plugin_job_create(st, &ops);
+    ASSERT_TRUE(job != NULL);
+    st_plugin_worker_get_stats(st, &stats);
+    nb_jobs = stats.nb_jobs;
+
+    int notifies = i % 8;
+    for (int n = 0; n < notifies; n++) {
+      s.ready++;
+      EXPECT_GE(st_plugin_job_notify(job), 0);
+    }
+    if (i % 3) st_usleep((i % 5) * 50);
+    EXPECT_GE(st_plugin_job_free(job), 0);
+    s.freed = true;
+
+    st_usleep(2 * 1000);
+    EXPECT_EQ(s.process_after_free.load(), 0);
+    EXPECT_LE(s.processed.load(), notifies);
+    st_plugin_worker_get_stats(st, &stats);
+    EXPECT_EQ(stats.nb_jobs, nb_jobs - 1);
+  }
+}
+
+TEST(St22p, plugin_job_notify_free) { plugin_job_notify_free_test(64); }
+
 static void frame_draw_logo_test(enum st_frame_fmt fmt, uint32_t w, uint32_t h,
                                  uint32_t logo_w, uint32_t logo_h, uint32_t x, uint32_t y,
                                  bool expect) {
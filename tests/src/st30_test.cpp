@@ -8,6 +8,8 @@
 #include "tests.h"
 
 #define ST30_TEST_PAYLOAD_TYPE (111)
+/* more than the bulk size of the lib to check the split */
+#define ST30_TEST_RTP_BULK_NB (128)
 
 static int tx_audio_next_frame(void* priv, uint16_t* next_frame_idx,
                                struct st30_tx_frame_meta* meta) {
@@ -85,6 +87,36 @@ static void tx_feed_packet(void* args) {
   }
 }
 
+static void tx_feed_packets(void* args) {
+  auto ctx = (tests_context*)args;
+  std::vector<struct st_rtp_buf> bufs(ST30_TEST_RTP_BULK_NB);
+  uint16_t nb;
+  std::unique_lock<std::mutex> lck(ctx->mtx, std::defer_lock);
+  while (!ctx->stop) {
+    /* get available buffers */
+    nb = st30_tx_get_mbufs((st30_tx_handle)ctx->handle, bufs.data(), bufs.size());
+    if (!nb) {
+      lck.lock();
+      /* try again */
+      nb = st30_tx_get_mbufs((st30_tx_handle)ctx->handle, bufs.data(), bufs.size());
+      if (nb) {
+        lck.unlock();
+      } else {
+        if (!ctx->stop) ctx->cv.wait(lck);
+        lck.unlock();
+        continue;
+      }
+    }
+
+    /* build the rtp pkts */
+    for (uint16_t i = 0; i < nb; i++)
+      tx_audio_build_rtp_packet(ctx, (struct st_rfc3550_rtp_hdr*)bufs[i].usrptr,
+                                &bufs[i].len);
+    uint16_t put = st30_tx_put_mbufs((st30_tx_handle)ctx->handle, bufs.data(), nb);
+    EXPECT_EQ(put, nb);
+  }
+}
+
 static int tx_rtp_done(void* args) {
   auto ctx = (tests_context*)args;
 
@@ -108,6 +140,26 @@ static int rx_rtp_ready(void* args) {
   return 0;
 }
 
+static void rx_handle_packet(tests_context* ctx, void* usrptr) {
+  if (ctx->check_sha) {
+    struct st_rfc3550_rtp_hdr* hdr = (struct st_rfc3550_rtp_hdr*)usrptr;
+    uint8_t* payload = (uint8_t*)hdr + sizeof(*hdr);
+    unsigned char result[SHA256_DIGEST_LENGTH];
+    SHA256((unsigned char*)payload, ctx->frame_size, result);
+    int i;
+    for (i = 0; i < TEST_SHA_HIST_NUM; i++) {
+      unsigned char* target_sha = ctx->shas[i];
+      if (!memcmp(result, target_sha, SHA256_DIGEST_LENGTH)) break;
+    }
+    if (i >= TEST_SHA_HIST_NUM) {
+      test_sha_dump("st30_rx_error_sha", result);
+      ctx->fail_cnt++;
+    }
+    ctx->check_sha_frame_cnt++;
+  }
+  ctx->fb_rec++;
+}
+
 static void rx_get_packet(void* args) {
   auto ctx = (tests_context*)args;
   void* mbuf;
@@ -129,24 +181,33 @@ static void rx_get_packet(void* args) {
         continue;
       }
     }
-    if (ctx->check_sha) {
-      struct st_rfc3550_rtp_hdr* hdr = (struct st_rfc3550_rtp_hdr*)usrptr;
-      uint8_t* payload = (uint8_t*)hdr + sizeof(*hdr);
-      unsigned char result[SHA256_DIGEST_LENGTH];
-      SHA256((unsigned char*)payload, ctx->frame_size, result);
-      int i;
-      for (i = 0; i < TEST_SHA_HIST_NUM; i++) {
-        unsigned char* target_sha = ctx->shas[i];
-        if (!memcmp(result, target_sha, SHA256_DIGEST_LENGTH)) break;
-      }
-      if (i >= TEST_SHA_HIST_NUM) {
-        test_sha_dump("st30_rx_error_sha", result);
-        ctx->fail_cnt++;
+    rx_handle_packet(ctx, usrptr);
+    st30_rx_put_mbuf((st30_rx_handle)ctx->handle, mbuf);
+  }
+}
+
+static void rx_get_packets(void* args) {
+  auto ctx = (tests_context*)args;
+  std::vector<struct st_rtp_buf> bufs(ST30_TEST_RTP_BULK_NB);
+  uint16_t nb;
+  std::unique_lock<std::mutex> lck(ctx->mtx, std::defer_lock);
+  while (!ctx->stop) {
+    /* get available buffers */
+    nb = st30_rx_get_mbufs((st30_rx_handle)ctx->handle, bufs.data(), bufs.size());
+    if (!nb) {
+      lck.lock();
+      /* try again */
+      nb = st30_rx_get_mbufs((st30_rx_handle)ctx->handle, bufs.data(), bufs.size());
+      if (nb) {
+        lck.unlock();
+      } else {
+        if (!ctx->stop) ctx->cv.wait(lck);
+        lck.unlock();
+        continue;
       }
-      ctx->check_sha_frame_cnt++;
     }
-    ctx->fb_rec++;
-    st30_rx_put_mbuf((st30_rx_handle)ctx->handle, mbuf);
+    for (uint16_t i = 0; i < nb; i++) rx_handle_packet(ctx, bufs[i].usrptr);
+    st30_rx_put_mbufs((st30_rx_handle)ctx->handle, bufs.data(), nb);
   }
 }
 
@@ -387,7 +448,8 @@ static void st30_tx_fps_test(enum st30_type type[], enum st30_sampling sample[],
 static void st30_rx_fps_test(enum st30_type type[], enum st30_sampling sample[],
                              enum st30_ptime ptime[], uint16_t channel[],
                              enum st30_fmt fmt[], enum st_test_level level,
-                             int sessions = 1, bool check_sha = false) {
+                             int sessions = 1, bool check_sha = false,
+                             bool bulk = false) {
   auto ctx = (struct st_tests_context*)st_test_ctx();
   auto m_handle = ctx->handle;
   int ret;
@@ -480,7 +542,8 @@ static void st30_rx_fps_test(enum st30_type type[], enum st30_sampling sample[],
 
     if (type[i] == ST30_TYPE_RTP_LEVEL) {
       test_ctx_tx[i]->stop = false;
-      rtp_thread_tx[i] = std::thread(tx_feed_packet, test_ctx_tx[i]);
+      rtp_thread_tx[i] =
+          std::thread(bulk ? tx_feed_packets : tx_feed_packet, test_ctx_tx[i]);
     }
   }
 
@@ -530,7 +593,8 @@ static void st30_rx_fps_test(enum st30_type type[], enum st30_sampling sample[],
     }
     if (type[i] == ST30_TYPE_RTP_LEVEL) {
       test_ctx_rx[i]->stop = false;
-      rtp_thread_rx[i] = std::thread(rx_get_packet, test_ctx_rx[i]);
+      rtp_thread_rx[i] =
+          std::thread(bulk ? rx_get_packets : rx_get_packet, test_ctx_rx[i]);
     }
 
     test_ctx_rx[i]->handle = rx_handle[i];
@@ -698,6 +762,56 @@ TEST(St30_rx, rtp_digest_48k_96_mix) {
   enum st30_fmt f[2] = {ST30_FMT_PCM16, ST30_FMT_PCM8};
   st30_rx_fps_test(type, s, pt, c, f, ST_TEST_LEVEL_ALL, 2, true);
 }
+TEST(St30_rx, rtp_bulk_digest_48k_96_mix) {
+  enum st30_type type[2] = {ST30_TYPE_RTP_LEVEL, ST30_TYPE_RTP_LEVEL};
+  enum st30_sampling s[2] = {ST30_SAMPLING_96K, ST30_SAMPLING_48K};
+  enum st30_ptime pt[2] = {ST30_PTIME_1MS, ST30_PTIME_1MS};
+  uint16_t c[2] = {1, 4};
+  enum st30_fmt f[2] = {ST30_FMT_PCM16, ST30_FMT_PCM8};
+  st30_rx_fps_test(type, s, pt, c, f, ST_TEST_LEVEL_ALL, 2, true, true);
+}
+TEST(St30_tx, rtp_bulk_get_put) {
+  auto ctx = (struct st_tests_context*)st_test_ctx();
+  auto m_handle = ctx->handle;
+  struct st30_tx_ops ops;
+  std::vector<struct st_rtp_buf> bufs(ST30_TEST_RTP_BULK_NB);
+  int ret;
+
+  auto test_ctx = new tests_context();
+  ASSERT_TRUE(test_ctx != NULL);
+  test_ctx->idx = 0;
+  test_ctx->ctx = ctx;
+  test_ctx->fb_cnt = 3;
+  st30_tx_ops_init(test_ctx, &ops);
+  ops.type = ST30_TYPE_RTP_LEVEL;
+  ops.rtp_ring_size = ST30_TEST_RTP_BULK_NB * 2;
+  st30_tx_handle handle = st30_tx_create(m_handle, &ops);
+  ASSERT_TRUE(handle != NULL);
+  test_ctx->handle = handle;
+
+  /* not started, the pkts stay in the ring */
+  uint16_t nb = st30_tx_get_mbufs(handle, bufs.data(), bufs.size());
+  EXPECT_EQ(nb, ST30_TEST_RTP_BULK_NB);
+  for (uint16_t i = 0; i < nb; i++) {
+    EXPECT_TRUE(bufs[i].mbuf != NULL);
+    EXPECT_TRUE(bufs[i].usrptr != NULL);
+    /* the last ones with an invalid len are freed by the lib */
+    if (i < nb - 8)
+      tx_audio_build_rtp_packet(test_ctx, (struct st_rfc3550_rtp_hdr*)bufs[i].usrptr,
+                                &bufs[i].len);
+  }
+  EXPECT_EQ(st30_tx_put_mbufs(handle, bufs.data(), nb), nb - 8);
+  /* capped by the room left in the ring */
+  nb = st30_tx_get_mbufs(handle, bufs.data(), bufs.size());
+  EXPECT_GT(nb, 0);
+  EXPECT_LE(nb, ST30_TEST_RTP_BULK_NB + 8);
+  for (uint16_t i = 0; i < nb; i++) bufs[i].len = 0;
+  EXPECT_EQ(st30_tx_put_mbufs(handle, bufs.data(), nb), 0);
+
+  ret = st30_tx_free(handle);
+  EXPECT_GE(ret, 0);
+  delete test_ctx;
+}
 TEST(St30_rx, digest_mix) {
   enum st30_type type[2] = {ST30_TYPE_RTP_LEVEL, ST30_TYPE_FRAME_LEVEL};
   enum st30_sampling s[2] = {ST30_SAMPLING_96K, ST30_SAMPLING_48K};
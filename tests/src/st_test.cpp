@@ -95,6 +95,31 @@ static void reinit_expect_fail_test(void) {
 
 TEST(Main, re_init_fail) { reinit_expect_fail_test(); }
 
+/* run with --state_file <path> for the save, it fails without the state_file */
+TEST(Main, state_save) {
+  struct st_tests_context* ctx = st_test_ctx();
+  const char* path = ctx->para.state_file;
+  char buf[4096];
+  size_t len;
+  FILE* fp;
+
+  if (!path) {
+    EXPECT_LT(mtl_state_save(ctx->handle), 0);
+    return;
+  }
+
+  remove(path);
+  EXPECT_GE(mtl_state_save(ctx->handle), 0);
+  fp = fopen(path, "r");
+  ASSERT_TRUE(fp != NULL);
+  len = fread(buf, 1, sizeof(buf) - 1, fp);
+  fclose(fp);
+  buf[len] = 0;
+  EXPECT_TRUE(strstr(buf, "\"version\"") != NULL);
+  EXPECT_TRUE(strstr(buf, "\"tsc_hz\"") != NULL);
+  EXPECT_TRUE(strstr(buf, ctx->para.port[MTL_PORT_P]) != NULL);
+}
+
 static void start_stop_test(int repeat) {
   struct st_tests_context* ctx = st_test_ctx();
   mtl_handle handle = ctx->handle;
@@ -36,9 +36,23 @@ enum test_args_cmd {
   TEST_ARG_R_START_QUEUE,
   TEST_ARG_HDR_SPLIT,
   TEST_ARG_TASKLET_THREAD,
+  TEST_ARG_TASKLET_SLEEP,
   TEST_ARG_TSC_PACING,
   TEST_ARG_RXTX_SIMD_512,
   TEST_ARG_PACING_WAY,
+  TEST_ARG_AF_XDP_SHARED_UMEM,
+  TEST_ARG_AF_XDP_BUSY_BUDGET,
+  TEST_ARG_AF_XDP_RING_SIZE,
+  TEST_ARG_MEMIF_RX_LOSS,
+  TEST_ARG_MEMIF_RX_REORDER,
+  TEST_ARG_MEMIF_RX_JITTER,
+  TEST_ARG_DMA_CPU_ENGINE,
+  TEST_ARG_SCH_ELASTIC,
+  TEST_ARG_RX_INTR,
+  TEST_ARG_RX_INTR_IDLE_US,
+  TEST_ARG_RX_EBU,
+  TEST_ARG_FEC_TEST_DROP,
+  TEST_ARG_STATE_FILE,
 };
 
 static struct option test_args_options[] = {
@@ -67,9 +81,23 @@ static struct option test_args_options[] = {
     {"r_start_queue", required_argument, 0, TEST_ARG_R_START_QUEUE},
     {"hdr_split", no_argument, 0, TEST_ARG_HDR_SPLIT},
     {"tasklet_thread", no_argument, 0, TEST_ARG_TASKLET_THREAD},
+    {"tasklet_sleep", no_argument, 0, TEST_ARG_TASKLET_SLEEP},
     {"tsc", no_argument, 0, TEST_ARG_TSC_PACING},
     {"rxtx_simd_512", no_argument, 0, TEST_ARG_RXTX_SIMD_512},
     {"pacing_way", required_argument, 0, TEST_ARG_PACING_WAY},
+    {"afxdp_shared_umem", no_argument, 0, TEST_ARG_AF_XDP_SHARED_UMEM},
+    {"afxdp_busy_budget", required_argument, 0, TEST_ARG_AF_XDP_BUSY_BUDGET},
+    {"afxdp_ring_size", required_argument, 0, TEST_ARG_AF_XDP_RING_SIZE},
+    {"memif_rx_loss", required_argument, 0, TEST_ARG_MEMIF_RX_LOSS},
+    {"memif_rx_reorder", required_argument, 0, TEST_ARG_MEMIF_RX_REORDER},
+    {"memif_rx_jitter", required_argument, 0, TEST_ARG_MEMIF_RX_JITTER},
+    {"dma_cpu_engine", no_argument, 0, TEST_ARG_DMA_CPU_ENGINE},
+    {"sch_elastic", no_argument, 0, TEST_ARG_SCH_ELASTIC},
+    {"rx_intr", no_argument, 0, TEST_ARG_RX_INTR},
+    {"rx_intr_idle_us", required_argument, 0, TEST_ARG_RX_INTR_IDLE_US},
+    {"ebu", no_argument, 0, TEST_ARG_RX_EBU},
+    {"fec_test_drop", no_argument, 0, TEST_ARG_FEC_TEST_DROP},
+    {"state_file", required_argument, 0, TEST_ARG_STATE_FILE},
 
     {0, 0, 0, 0}};
 
@@ -204,6 +232,9 @@ static int test_parse_args(struct st_tests_context* ctx, struct mtl_init_params*
       case TEST_ARG_TASKLET_THREAD:
         p->flags |= MTL_FLAG_TASKLET_THREAD;
         break;
+      case TEST_ARG_TASKLET_SLEEP:
+        p->flags |= MTL_FLAG_TASKLET_SLEEP;
+        break;
       case TEST_ARG_TSC_PACING:
         p->pacing = ST21_TX_PACING_WAY_TSC;
         break;
@@ -224,6 +255,58 @@ static int test_parse_args(struct st_tests_context* ctx, struct mtl_init_params*
         else
           err("%s, unknow pacing way %s\n", __func__, optarg);
         break;
+      case TEST_ARG_AF_XDP_SHARED_UMEM:
+        p->flags |= MTL_FLAG_AF_XDP_SHARED_UMEM;
+        break;
+      case TEST_ARG_AF_XDP_BUSY_BUDGET:
+        nb = atoi(optarg);
+        if (nb > 0) {
+          p->xdp_info[MTL_PORT_P].busy_budget = nb;
+          p->xdp_info[MTL_PORT_R].busy_budget = nb;
+        } else {
+          p->flags |= MTL_FLAG_AF_XDP_BUSY_POLL_DISABLE;
+        }
+        break;
+      case TEST_ARG_AF_XDP_RING_SIZE:
+        nb = atoi(optarg);
+        for (int i = 0; i < MTL_PORT_MAX; i++) {
+          p->xdp_info[i].rx_ring_size = nb;
+          p->xdp_info[i].tx_ring_size = nb;
+        }
+        break;
+      case TEST_ARG_MEMIF_RX_LOSS:
+        for (int i = 0; i < MTL_PORT_MAX; i++)
+          p->memif_info[i].rx_loss_ppm = atoi(optarg);
+        break;
+      case TEST_ARG_MEMIF_RX_REORDER:
+        for (int i = 0; i < MTL_PORT_MAX; i++)
+          p->memif_info[i].rx_reorder_ppm = atoi(optarg);
+        break;
+      case TEST_ARG_MEMIF_RX_JITTER:
+        for (int i = 0; i < MTL_PORT_MAX; i++)
+          p->memif_info[i].rx_jitter_us = atoi(optarg);
+        break;
+      case TEST_ARG_DMA_CPU_ENGINE:
+        p->flags |= MTL_FLAG_DMA_CPU_ENGINE;
+        break;
+      case TEST_ARG_SCH_ELASTIC:
+        p->flags |= MTL_FLAG_SCH_ELASTIC;
+        break;
+      case TEST_ARG_RX_INTR:
+        p->flags |= MTL_FLAG_RX_INTR;
+        break;
+      case TEST_ARG_RX_INTR_IDLE_US:
+        p->rx_intr_idle_us = atoi(optarg);
+        break;
+      case TEST_ARG_RX_EBU:
+        p->flags |= MTL_FLAG_RX_VIDEO_EBU;
+        break;
+      case TEST_ARG_FEC_TEST_DROP:
+        p->flags |= MTL_FLAG_TX_VIDEO_FEC_TEST_DROP;
+        break;
+      case TEST_ARG_STATE_FILE:
+        p->state_file = optarg;
+        break;
       default:
         break;
     }
@@ -258,6 +341,14 @@ static void test_random_ip(struct st_tests_context* ctx) {
   r_ip[1] = p_ip[1];
   r_ip[2] = p_ip[2];
   r_ip[3] = p_ip[3] + 1;
+
+  /* fd00::/8 unique local address for the ipv6 tests */
+  p_ip = p->sip6_addr[MTL_PORT_P];
+  r_ip = p->sip6_addr[MTL_PORT_R];
+  p_ip[0] = 0xfd;
+  for (int i = 1; i < MTL_IP6_ADDR_LEN; i++) p_ip[i] = rand() % 0xFF;
+  memcpy(r_ip, p_ip, MTL_IP6_ADDR_LEN);
+  r_ip[MTL_IP6_ADDR_LEN - 1] = p_ip[MTL_IP6_ADDR_LEN - 1] + 1;
 }
 
 static uint64_t temt_ptp_from_real_time(void* priv) {
@@ -496,13 +587,13 @@ GTEST_API_ int main(int argc, char** argv) {
   /* parse af xdp pmd info */
   for (int i = 0; i < ctx->para.num_ports; i++) {
     ctx->para.pmd[i] = mtl_pmd_by_port_name(ctx->para.port[i]);
-    if (ctx->para.pmd[i] != MTL_PMD_DPDK_USER) {
+    if (ctx->para.pmd[i] == MTL_PMD_DPDK_AF_XDP) {
       mtl_get_if_ip(ctx->para.port[i], ctx->para.sip_addr[i]);
       ctx->para.flags |= MTL_FLAG_RX_SEPARATE_VIDEO_LCORE;
       ctx->para.tx_sessions_cnt_max = 8;
       ctx->para.rx_sessions_cnt_max = 8;
       ctx->para.xdp_info[i].queue_count = 8;
-    } else {
+    } else if (ctx->para.pmd[i] == MTL_PMD_DPDK_USER) {
       link_flap_wa = true;
     }
   }
@@ -658,6 +749,10 @@ int test_ctx_notify_event(void* priv, enum st_event event, void* args) {
     dbg("%s(%d,%p), epoch %lu vsync_cnt %d\n", __func__, s->idx, s, meta->epoch,
         s->vsync_cnt);
 #endif
+  } else if (event == ST_EVENT_ARP_FAIL) {
+    tests_context* s = (tests_context*)priv;
+    s->arp_fail_cnt++;
+    dbg("%s(%d,%p), arp fail %d\n", __func__, s->idx, s, *(int*)args);
   }
   return 0;
 }
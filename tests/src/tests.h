@@ -205,6 +205,7 @@ class tests_context {
   int fb_send = 0;
   int fb_rec = 0;
   int vsync_cnt = 0;
+  int arp_fail_cnt = 0;
   uint64_t first_vsync_time = 0;
   int packet_rec = 0;
   uint64_t start_time = 0;
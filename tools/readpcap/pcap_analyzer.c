@@ -0,0 +1,1465 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2022 Intel Corporation
+ */
+
+/*
+ * Offline ST2110 compliance analyzer for pcap/pcapng captures.
+ *
+ * The capture is mmap'd and walked once by the main thread, it parses every record
+ * and dispatches the rtp packets to the worker owning the flow through a single
+ * producer/single consumer ring, so per flow packets are always handled in capture
+ * order without any locking. Flows are auto detected as st20/st22/st30/st40 from the
+ * rtp pattern, the video and audio checks use the same math as the rx ebu check of
+ * the library from lib/src/st2110/st_ebu.c.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "st_ebu.h"
+
+#define NS_PER_S (1000000000ULL)
+
+#define PA_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define PA_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+#define PA_WORKERS_MAX (64)
+/* pkts in the ring from the reader to one worker, power of 2 */
+#define PA_RING_SIZE (4096)
+#define PA_FLOWS_INIT_CAP (64)
+#define PA_NG_IF_MAX (32)
+/* rtp timestamp groups used to detect the flow type, the first one may be partial */
+#define PA_DETECT_GROUPS (6)
+/* a flow with at least this pkts for one rtp timestamp is a video flow */
+#define PA_DETECT_VIDEO_PKTS (8)
+/* a flow with a rtp timestamp interval below this is an audio flow */
+#define PA_DETECT_AUDIO_INTERVAL_NS (5 * 1000 * 1000)
+/* one video result every 300 frames, same as the library */
+#define PA_VIDEO_RESULT_FRAMES (60 * 5)
+
+enum pa_flow_type {
+  PA_FLOW_UNKNOWN = 0,
+  PA_FLOW_ST20,
+  PA_FLOW_ST22,
+  PA_FLOW_ST30,
+  PA_FLOW_ST40,
+};
+
+static const char* pa_flow_type_names[] = {"unknown", "st20", "st22", "st30", "st40"};
+
+struct pa_fps {
+  const char* name;
+  double sampling; /* 90k rtp ticks per frame */
+};
+
+static const struct pa_fps pa_fps_table[] = {
+    {"23.98", 3753.75},
+    {"24", 3750},
+    {"25", 3600},
+    {"29.97", 3003},
+    {"30", 3000},
+    {"50", 1800},
+    {"59.94", 1501.5},
+    {"60", 1500},
+    {"100", 900},
+    {"119.88", 750.75},
+    {"120", 750},
+};
+
+struct pa_video_info {
+  double frame_time;
+  double frame_time_sampling;
+  const char* fps;
+  int height;
+  bool interlaced;
+  int pkt_per_frame;
+
+  struct st_ebu_video_pass pass;
+};
+
+struct pa_video_stat {
+  uint64_t cur_epochs;
+  int frame_idx;
+  bool compliant;
+  bool compliant_narrow;
+
+  uint64_t cinmtl_initial_time;
+  int32_t cinst_max;
+  int32_t cinst_min;
+  uint32_t cinst_cnt;
+  int64_t cinst_sum;
+
+  int32_t vrx_drained_prev;
+  int32_t vrx_prev;
+  int32_t vrx_max;
+  int32_t vrx_min;
+  uint32_t vrx_cnt;
+  int64_t vrx_sum;
+
+  int32_t fpt_max;
+  int32_t fpt_min;
+  uint32_t fpt_cnt;
+  int64_t fpt_sum;
+
+  int32_t latency_max;
+  int32_t latency_min;
+  uint32_t latency_cnt;
+  int64_t latency_sum;
+
+  int32_t rtp_offset_max;
+  int32_t rtp_offset_min;
+  uint32_t rtp_offset_cnt;
+  int64_t rtp_offset_sum;
+
+  uint32_t prev_rtp_ts;
+  int32_t rtp_ts_delta_max;
+  int32_t rtp_ts_delta_min;
+  uint32_t rtp_ts_delta_cnt;
+  int64_t rtp_ts_delta_sum;
+
+  uint64_t prev_rtp_ipt_ts;
+  int32_t rtp_ipt_max;
+  int32_t rtp_ipt_min;
+  uint32_t rtp_ipt_cnt;
+  int64_t rtp_ipt_sum;
+};
+
+struct pa_video_result {
+  int ebu_result_num;
+  int cinst_pass_narrow;
+  int cinst_pass_wide;
+  int cinst_fail;
+  int vrx_pass_narrow;
+  int vrx_pass_wide;
+  int vrx_fail;
+  int latency_pass;
+  int latency_fail;
+  int rtp_offset_pass;
+  int rtp_offset_fail;
+  int rtp_ts_delta_pass;
+  int rtp_ts_delta_fail;
+  int fpt_pass;
+  int fpt_fail;
+  int compliance;
+  int compliance_narrow;
+
+  /* worst values over all results */
+  int32_t cinst_max;
+  int32_t vrx_min;
+  int32_t vrx_max;
+  int32_t fpt_max;
+  int32_t latency_min;
+  int32_t latency_max;
+  int32_t rtp_offset_min;
+  int32_t rtp_offset_max;
+  int32_t rtp_ts_delta_min;
+  int32_t rtp_ts_delta_max;
+  int32_t rtp_ipt_min;
+  int32_t rtp_ipt_max;
+};
+
+struct pa_video {
+  struct pa_video_info info;
+  struct pa_video_stat stat;
+  struct pa_video_result result;
+  bool started; /* wait the first full frame after detection */
+};
+
+struct pa_audio_info {
+  double frame_time;
+  double frame_time_sampling;
+  int clock_rate;
+  int pkts_per_result;
+
+  struct st_ebu_audio_pass pass;
+};
+
+struct pa_audio_stat {
+  uint32_t pkt_num;
+  bool compliant;
+
+  int64_t dpvr_max;
+  int64_t dpvr_min;
+  uint32_t dpvr_cnt;
+  int64_t dpvr_sum;
+  float dpvr_avg;
+  int64_t dpvr_first;
+
+  int64_t tsdf_max;
+};
+
+struct pa_audio_result {
+  int ebu_result_num;
+  int dpvr_pass_narrow;
+  int dpvr_pass_wide;
+  int dpvr_fail;
+  int tsdf_pass;
+  int tsdf_fail;
+  int compliance;
+
+  /* worst values over all results */
+  int64_t dpvr_min;
+  int64_t dpvr_max;
+  int64_t tsdf_max;
+};
+
+struct pa_audio {
+  struct pa_audio_info info;
+  struct pa_audio_stat stat;
+  struct pa_audio_result result;
+};
+
+struct pa_anc {
+  const char* fps;
+  double frame_time_sampling;
+  uint64_t frames;
+  int pkts_per_frame_max;
+  uint32_t prev_rtp_ts;
+  bool prev_valid;
+  int32_t rtp_ts_delta_min;
+  int32_t rtp_ts_delta_max;
+  uint64_t rtp_ts_delta_fail;
+};
+
+struct pa_detector {
+  int groups;
+  int max_group_pkts;
+  uint32_t first_ts;
+  uint64_t first_ns;
+  uint32_t st20_ok;
+  uint32_t st20_checked;
+  int max_row;
+  bool interlaced;
+};
+
+struct pa_flow {
+  uint32_t sip;
+  uint32_t dip;
+  uint16_t sport;
+  uint16_t dport;
+  uint32_t hash;
+
+  enum pa_flow_type type;
+  uint8_t payload_type;
+  uint64_t pkts;
+  uint64_t bytes;
+  uint64_t first_ns;
+  uint64_t last_ns;
+
+  bool seq_init;
+  uint16_t prev_seq;
+  uint64_t seq_lost;
+  uint64_t seq_ooo;
+
+  bool rtp_init;
+  uint32_t cur_rtp_ts;
+  int pkt_idx; /* pkt index for current rtp timestamp */
+
+  struct pa_detector det;
+  union {
+    struct pa_video video;
+    struct pa_audio audio;
+    struct pa_anc anc;
+  };
+};
+
+struct pa_pkt {
+  uint32_t sip;
+  uint32_t dip;
+  uint16_t sport;
+  uint16_t dport;
+  const uint8_t* rtp;
+  uint32_t rtp_len;   /* rtp header and payload */
+  const uint8_t* pl;  /* payload after the rtp header */
+  uint32_t pl_len;
+  uint8_t payload_type;
+  bool marker;
+  uint16_t seq;
+  uint32_t tmstamp;
+};
+
+enum pa_fmt {
+  PA_FMT_PCAP = 0,
+  PA_FMT_PCAPNG,
+};
+
+struct pa_file {
+  const uint8_t* base;
+  size_t size;
+  enum pa_fmt fmt;
+  bool swap;         /* pcap only, pcapng has per section order */
+  uint64_t ts_mul;   /* pcap only, 1000 for us or 1 for ns */
+  uint32_t linktype; /* pcap only */
+};
+
+/* one parsed rtp packet from the reader to the worker */
+struct pa_item {
+  struct pa_pkt pkt;
+  uint32_t hash;
+  uint64_t ts_ns;
+};
+
+/* single producer(the reader) single consumer(the worker) ring */
+struct pa_ring {
+  struct pa_item* items;
+  uint32_t head __attribute__((aligned(64))); /* consumer index */
+  uint32_t tail __attribute__((aligned(64))); /* producer index */
+};
+
+struct pa_ctx;
+
+struct pa_worker {
+  int idx;
+  struct pa_ctx* ctx;
+  pthread_t tid;
+  struct pa_ring ring;
+
+  struct pa_flow** flows; /* open addressing hash table */
+  uint32_t flows_cap;
+  uint32_t flows_num;
+
+  uint64_t stat_ring_full;
+  int ret;
+};
+
+struct pa_ctx {
+  struct pa_file file;
+  int workers_num;
+  int height;     /* user provided video height, 0 for auto */
+  bool read_done; /* the reader has dispatched all records */
+  struct pa_worker workers[PA_WORKERS_MAX];
+
+  /* capture level stat by the reader */
+  uint64_t stat_records;
+  uint64_t stat_non_rtp;
+};
+
+static inline uint16_t pa_be16(const uint8_t* p) { return (uint16_t)p[0] << 8 | p[1]; }
+
+static inline uint32_t pa_be32(const uint8_t* p) {
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static inline uint16_t pa_rd16(const uint8_t* p, bool swap) {
+  uint16_t v;
+  memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap16(v) : v;
+}
+
+static inline uint32_t pa_rd32(const uint8_t* p, bool swap) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return swap ? __builtin_bswap32(v) : v;
+}
+
+static inline uint32_t pa_flow_hash(uint32_t sip, uint32_t dip, uint16_t sport,
+                                    uint16_t dport) {
+  uint64_t h = ((uint64_t)dip << 32 | ((uint32_t)dport << 16 | sport)) ^
+               ((uint64_t)sip * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (uint32_t)h;
+}
+
+static const char* pa_ip_str(uint32_t ip, char* buf, size_t sz) {
+  snprintf(buf, sz, "%u.%u.%u.%u", ip >> 24, (ip >> 16) & 0xff, (ip >> 8) & 0xff,
+           ip & 0xff);
+  return buf;
+}
+
+static const struct pa_fps* pa_fps_match(double sampling) {
+  const struct pa_fps* best = &pa_fps_table[0];
+
+  for (size_t i = 1; i < sizeof(pa_fps_table) / sizeof(pa_fps_table[0]); i++) {
+    if (fabs(pa_fps_table[i].sampling - sampling) < fabs(best->sampling - sampling))
+      best = &pa_fps_table[i];
+  }
+  return best;
+}
+
+/* eth(with vlan)/ipv4/udp/rtp, return false if not a rtp packet */
+static bool pa_parse_pkt(const uint8_t* p, uint32_t len, struct pa_pkt* pkt) {
+  uint32_t off = 12;
+  uint16_t ether_type;
+
+  if (len < 14) return false;
+  ether_type = pa_be16(p + off);
+  off += 2;
+  while (ether_type == 0x8100 || ether_type == 0x88a8) {
+    if (len < off + 4) return false;
+    ether_type = pa_be16(p + off + 2);
+    off += 4;
+  }
+  if (ether_type != 0x0800) return false;
+
+  /* ipv4 */
+  if (len < off + 20) return false;
+  const uint8_t* ip = p + off;
+  uint32_t ihl = (ip[0] & 0xf) * 4;
+  if ((ip[0] >> 4) != 4 || ihl < 20 || len < off + ihl) return false;
+  if (ip[9] != 17) return false;                /* not udp */
+  if (pa_be16(ip + 6) & 0x3fff) return false; /* fragment */
+  pkt->sip = pa_be32(ip + 12);
+  pkt->dip = pa_be32(ip + 16);
+  off += ihl;
+
+  /* udp */
+  if (len < off + 8) return false;
+  const uint8_t* udp = p + off;
+  uint32_t udp_len = pa_be16(udp + 4);
+  pkt->sport = pa_be16(udp);
+  pkt->dport = pa_be16(udp + 2);
+  off += 8;
+  if (udp_len < 8 + 12) return false;
+  udp_len = PA_MIN(udp_len - 8, len - off);
+
+  /* rtp */
+  const uint8_t* rtp = p + off;
+  uint32_t rtp_hdr_len;
+  if (udp_len < 12 || (rtp[0] >> 6) != 2) return false;
+  rtp_hdr_len = 12 + (rtp[0] & 0xf) * 4;
+  if (rtp[0] & 0x10) { /* extension */
+    if (udp_len < rtp_hdr_len + 4) return false;
+    rtp_hdr_len += 4 + pa_be16(rtp + rtp_hdr_len + 2) * 4;
+  }
+  if (udp_len < rtp_hdr_len) return false;
+  pkt->rtp = rtp;
+  pkt->rtp_len = udp_len;
+  pkt->pl = rtp + rtp_hdr_len;
+  pkt->pl_len = udp_len - rtp_hdr_len;
+  pkt->payload_type = rtp[1] & 0x7f;
+  pkt->marker = rtp[1] >> 7;
+  pkt->seq = pa_be16(rtp + 2);
+  pkt->tmstamp = pa_be32(rtp + 4);
+  return true;
+}
+
+/* check if the payload is a consistent rfc4175 one: ext seq and srd headers */
+static bool pa_st20_check(struct pa_detector* det, struct pa_pkt* pkt) {
+  const uint8_t* srd = pkt->pl + 2;
+  uint32_t hdr_len = 2, data_len = 0;
+
+  for (int i = 0; i < 3; i++) {
+    hdr_len += 6;
+    if (pkt->pl_len < hdr_len) return false;
+    uint16_t srd_len = pa_be16(srd);
+    uint16_t row = pa_be16(srd + 2);
+    uint16_t offset = pa_be16(srd + 4);
+
+    if (!srd_len) return false;
+    data_len += srd_len;
+    det->max_row = PA_MAX(det->max_row, row & 0x7fff);
+    if (row & 0x8000) det->interlaced = true;
+    if (!(offset & 0x8000)) break; /* no continuation */
+    srd += 6;
+  }
+  return (hdr_len + data_len) == pkt->pl_len;
+}
+
+static void pa_video_clear_stat(struct pa_video_stat* ebu) {
+  memset(ebu, 0, sizeof(*ebu));
+
+  ebu->cinst_max = INT_MIN;
+  ebu->cinst_min = INT_MAX;
+  ebu->vrx_max = INT_MIN;
+  ebu->vrx_min = INT_MAX;
+  ebu->fpt_max = INT_MIN;
+  ebu->fpt_min = INT_MAX;
+  ebu->latency_max = INT_MIN;
+  ebu->latency_min = INT_MAX;
+  ebu->rtp_offset_max = INT_MIN;
+  ebu->rtp_offset_min = INT_MAX;
+  ebu->rtp_ts_delta_max = INT_MIN;
+  ebu->rtp_ts_delta_min = INT_MAX;
+  ebu->rtp_ipt_max = INT_MIN;
+  ebu->rtp_ipt_min = INT_MAX;
+
+  ebu->compliant = true;
+  ebu->compliant_narrow = true;
+}
+
+static void pa_video_init(struct pa_ctx* ctx, struct pa_flow* flow,
+                          double ts_per_frame) {
+  struct pa_detector* det = &flow->det;
+  struct pa_video* video = &flow->video;
+  struct pa_video_info* ebu_info = &video->info;
+  struct pa_video_result* ebu_result = &video->result;
+  const struct pa_fps* fps = pa_fps_match(ts_per_frame);
+  int total_pkts = det->max_group_pkts;
+  double frame_time;
+  int height;
+
+  memset(video, 0, sizeof(*video));
+  pa_video_clear_stat(&video->stat);
+  ebu_result->cinst_max = INT_MIN;
+  ebu_result->vrx_min = INT_MAX;
+  ebu_result->vrx_max = INT_MIN;
+  ebu_result->fpt_max = INT_MIN;
+  ebu_result->latency_min = INT_MAX;
+  ebu_result->latency_max = INT_MIN;
+  ebu_result->rtp_offset_min = INT_MAX;
+  ebu_result->rtp_offset_max = INT_MIN;
+  ebu_result->rtp_ts_delta_min = INT_MAX;
+  ebu_result->rtp_ts_delta_max = INT_MIN;
+  ebu_result->rtp_ipt_min = INT_MAX;
+  ebu_result->rtp_ipt_max = INT_MIN;
+
+  if (ctx->height)
+    height = ctx->height;
+  else if (flow->type == PA_FLOW_ST20)
+    height = det->interlaced ? (det->max_row + 1) * 2 : det->max_row + 1;
+  else
+    height = 1080; /* no line info in st22 */
+
+  frame_time = fps->sampling / 90000 * NS_PER_S;
+
+  ebu_info->fps = fps->name;
+  ebu_info->height = height;
+  ebu_info->interlaced = det->interlaced;
+  ebu_info->pkt_per_frame = total_pkts;
+  ebu_info->frame_time = frame_time;
+  ebu_info->frame_time_sampling = fps->sampling;
+  st_ebu_video_pass_init(&ebu_info->pass, total_pkts, frame_time, 90000, height,
+                         det->interlaced);
+}
+
+static void pa_video_result(struct pa_video* video) {
+  struct pa_video_stat* ebu = &video->stat;
+  struct pa_video_info* ebu_info = &video->info;
+  struct pa_video_result* ebu_result = &video->result;
+
+  if (!ebu->cinst_cnt) return;
+  ebu_result->ebu_result_num++;
+
+  /* no WA band as the capture time is from the capture device */
+  switch (st_ebu_cinst_grade(&ebu_info->pass, ebu->cinst_max, false)) {
+    case ST_EBU_GRADE_NARROW:
+      ebu_result->cinst_pass_narrow++;
+      break;
+    case ST_EBU_GRADE_WIDE:
+      ebu_result->cinst_pass_wide++;
+      ebu->compliant_narrow = false;
+      break;
+    default:
+      ebu_result->cinst_fail++;
+      ebu->compliant = false;
+      break;
+  }
+
+  switch (st_ebu_vrx_grade(&ebu_info->pass, ebu->vrx_min, ebu->vrx_max)) {
+    case ST_EBU_GRADE_NARROW:
+      ebu_result->vrx_pass_narrow++;
+      break;
+    case ST_EBU_GRADE_WIDE:
+      ebu_result->vrx_pass_wide++;
+      ebu->compliant_narrow = false;
+      break;
+    default:
+      ebu_result->vrx_fail++;
+      ebu->compliant = false;
+      break;
+  }
+
+  if (st_ebu_fpt_grade(&ebu_info->pass, ebu->fpt_max, false) == ST_EBU_GRADE_NARROW) {
+    ebu_result->fpt_pass++;
+  } else {
+    ebu_result->fpt_fail++;
+    ebu->compliant = false;
+  }
+
+  if (st_ebu_latency_pass(ebu->latency_min, ebu->latency_max)) {
+    ebu_result->latency_pass++;
+  } else {
+    ebu_result->latency_fail++;
+    ebu->compliant = false;
+  }
+
+  if (st_ebu_rtp_offset_pass(&ebu_info->pass, ebu->rtp_offset_min,
+                             ebu->rtp_offset_max)) {
+    ebu_result->rtp_offset_pass++;
+  } else {
+    ebu_result->rtp_offset_fail++;
+    ebu->compliant = false;
+  }
+
+  /* rtp ts delta, skip if only one frame in this result */
+  if (ebu->rtp_ts_delta_cnt) {
+    if (!st_ebu_rtp_ts_delta_pass(ebu_info->frame_time_sampling, ebu->rtp_ts_delta_min,
+                                  ebu->rtp_ts_delta_max)) {
+      ebu_result->rtp_ts_delta_fail++;
+      ebu->compliant = false;
+    } else {
+      ebu_result->rtp_ts_delta_pass++;
+    }
+    ebu_result->rtp_ts_delta_min =
+        PA_MIN(ebu_result->rtp_ts_delta_min, ebu->rtp_ts_delta_min);
+    ebu_result->rtp_ts_delta_max =
+        PA_MAX(ebu_result->rtp_ts_delta_max, ebu->rtp_ts_delta_max);
+  } else {
+    ebu_result->rtp_ts_delta_pass++;
+  }
+
+  if (ebu->compliant) {
+    ebu_result->compliance++;
+    if (ebu->compliant_narrow) ebu_result->compliance_narrow++;
+  }
+
+  ebu_result->cinst_max = PA_MAX(ebu_result->cinst_max, ebu->cinst_max);
+  ebu_result->vrx_min = PA_MIN(ebu_result->vrx_min, ebu->vrx_min);
+  ebu_result->vrx_max = PA_MAX(ebu_result->vrx_max, ebu->vrx_max);
+  ebu_result->fpt_max = PA_MAX(ebu_result->fpt_max, ebu->fpt_max);
+  ebu_result->latency_min = PA_MIN(ebu_result->latency_min, ebu->latency_min);
+  ebu_result->latency_max = PA_MAX(ebu_result->latency_max, ebu->latency_max);
+  ebu_result->rtp_offset_min = PA_MIN(ebu_result->rtp_offset_min, ebu->rtp_offset_min);
+  ebu_result->rtp_offset_max = PA_MAX(ebu_result->rtp_offset_max, ebu->rtp_offset_max);
+  if (ebu->rtp_ipt_cnt) {
+    ebu_result->rtp_ipt_min = PA_MIN(ebu_result->rtp_ipt_min, ebu->rtp_ipt_min);
+    ebu_result->rtp_ipt_max = PA_MAX(ebu_result->rtp_ipt_max, ebu->rtp_ipt_max);
+  }
+}
+
+static void pa_video_on_frame(struct pa_video* video, uint32_t rtp_tmstamp,
+                              uint64_t pkt_tmstamp) {
+  struct pa_video_stat* ebu = &video->stat;
+  struct pa_video_info* ebu_info = &video->info;
+  struct st_ebu_epoch epoch;
+
+  st_ebu_epoch_calc(&epoch, pkt_tmstamp, rtp_tmstamp, ebu_info->frame_time,
+                    ebu_info->frame_time_sampling);
+  double fpt_delta = epoch.fpt;
+
+  ebu->frame_idx++;
+  if (ebu->frame_idx % PA_VIDEO_RESULT_FRAMES == 0) {
+    uint32_t prev_rtp_ts = ebu->prev_rtp_ts;
+
+    pa_video_result(video);
+    pa_video_clear_stat(ebu);
+    /* keep the rtp ts delta check continuous across results */
+    ebu->prev_rtp_ts = prev_rtp_ts;
+  }
+
+  ebu->cur_epochs = epoch.epochs;
+  ebu->vrx_drained_prev = 0;
+  ebu->vrx_prev = 0;
+  ebu->cinmtl_initial_time = pkt_tmstamp;
+  ebu->prev_rtp_ipt_ts = 0;
+
+  /* calculate fpt */
+  ebu->fpt_sum += fpt_delta;
+  ebu->fpt_min = PA_MIN(fpt_delta, ebu->fpt_min);
+  ebu->fpt_max = PA_MAX(fpt_delta, ebu->fpt_max);
+  ebu->fpt_cnt++;
+
+  double diff_rtp_ts = epoch.rtp_offset;
+  double latency = epoch.latency;
+
+  /* calculate latency */
+  ebu->latency_sum += latency;
+  ebu->latency_min = PA_MIN(latency, ebu->latency_min);
+  ebu->latency_max = PA_MAX(latency, ebu->latency_max);
+  ebu->latency_cnt++;
+
+  /* calculate rtp offset */
+  ebu->rtp_offset_sum += diff_rtp_ts;
+  ebu->rtp_offset_min = PA_MIN(diff_rtp_ts, ebu->rtp_offset_min);
+  ebu->rtp_offset_max = PA_MAX(diff_rtp_ts, ebu->rtp_offset_max);
+  ebu->rtp_offset_cnt++;
+
+  /* calculate rtp ts dleta */
+  if (ebu->prev_rtp_ts) {
+    int rtp_ts_delta = rtp_tmstamp - ebu->prev_rtp_ts;
+    ebu->rtp_ts_delta_sum += rtp_ts_delta;
+    ebu->rtp_ts_delta_min = PA_MIN(rtp_ts_delta, ebu->rtp_ts_delta_min);
+    ebu->rtp_ts_delta_max = PA_MAX(rtp_ts_delta, ebu->rtp_ts_delta_max);
+    ebu->rtp_ts_delta_cnt++;
+  }
+  ebu->prev_rtp_ts = rtp_tmstamp;
+}
+
+static void pa_video_on_packet(struct pa_video* video, uint32_t rtp_tmstamp,
+                               uint64_t pkt_tmstamp, int pkt_idx) {
+  struct pa_video_stat* ebu = &video->stat;
+  struct pa_video_info* ebu_info = &video->info;
+
+  if (!pkt_idx) { /* start of new frame */
+    video->started = true;
+    pa_video_on_frame(video, rtp_tmstamp, pkt_tmstamp);
+  }
+  if (!video->started) return;
+
+  /* Calculate vrx */
+  int32_t vrx_cur = st_ebu_vrx(pkt_tmstamp, ebu->cur_epochs, ebu_info->frame_time,
+                               &ebu_info->pass, ebu->vrx_prev, &ebu->vrx_drained_prev);
+  ebu->vrx_sum += vrx_cur;
+  ebu->vrx_min = PA_MIN(vrx_cur, ebu->vrx_min);
+  ebu->vrx_max = PA_MAX(vrx_cur, ebu->vrx_max);
+  ebu->vrx_cnt++;
+  ebu->vrx_prev = vrx_cur;
+
+  /* Calculate C-inst */
+  int cinst = st_ebu_cinst(pkt_tmstamp, ebu->cinmtl_initial_time, ebu_info->pass.trs,
+                           pkt_idx);
+  ebu->cinst_sum += cinst;
+  ebu->cinst_min = PA_MIN(cinst, ebu->cinst_min);
+  ebu->cinst_max = PA_MAX(cinst, ebu->cinst_max);
+  ebu->cinst_cnt++;
+
+  /* calculate Inter-packet time */
+  if (ebu->prev_rtp_ipt_ts) {
+    double ipt = (double)pkt_tmstamp - ebu->prev_rtp_ipt_ts;
+    ebu->rtp_ipt_sum += ipt;
+    ebu->rtp_ipt_min = PA_MIN(ipt, ebu->rtp_ipt_min);
+    ebu->rtp_ipt_max = PA_MAX(ipt, ebu->rtp_ipt_max);
+    ebu->rtp_ipt_cnt++;
+  }
+  ebu->prev_rtp_ipt_ts = pkt_tmstamp;
+}
+
+static void pa_audio_clear_stat(struct pa_audio_stat* ebu) {
+  memset(ebu, 0, sizeof(*ebu));
+
+  ebu->dpvr_max = INT_MIN;
+  ebu->dpvr_min = INT_MAX;
+  ebu->tsdf_max = INT_MIN;
+
+  ebu->compliant = true;
+}
+
+static void pa_audio_init(struct pa_flow* flow, double ts_per_pkt,
+                          double ns_per_pkt) {
+  static const int clock_rates[] = {44100, 48000, 96000};
+  struct pa_audio* audio = &flow->audio;
+  struct pa_audio_info* ebu_info = &audio->info;
+  double clock = ts_per_pkt * NS_PER_S / ns_per_pkt;
+  int clock_rate = clock_rates[0];
+  double samples = round(ts_per_pkt);
+
+  for (size_t i = 1; i < sizeof(clock_rates) / sizeof(clock_rates[0]); i++) {
+    if (fabs(clock_rates[i] - clock) < fabs(clock_rate - clock))
+      clock_rate = clock_rates[i];
+  }
+  if (samples < 1) samples = 1;
+
+  memset(audio, 0, sizeof(*audio));
+  pa_audio_clear_stat(&audio->stat);
+  audio->result.dpvr_min = INT64_MAX;
+  audio->result.dpvr_max = INT64_MIN;
+  audio->result.tsdf_max = INT64_MIN;
+
+  /* the epoch is the packet time, equal to the library for the 1ms ptime */
+  ebu_info->clock_rate = clock_rate;
+  ebu_info->frame_time = samples * NS_PER_S / clock_rate;
+  ebu_info->frame_time_sampling = samples;
+  ebu_info->pkts_per_result = PA_MAX(1, round(NS_PER_S / ebu_info->frame_time));
+
+  /* pass criteria are the same as the library, based on 1ms */
+  st_ebu_audio_pass_init(&ebu_info->pass);
+}
+
+static void pa_audio_result(struct pa_audio* audio) {
+  struct pa_audio_stat* ebu = &audio->stat;
+  struct pa_audio_info* ebu_info = &audio->info;
+  struct pa_audio_result* ebu_result = &audio->result;
+
+  if (!ebu->dpvr_cnt) return;
+  ebu_result->ebu_result_num++;
+
+  /* Maximum Timestamped Delay Factor */
+  int64_t tsdf = st_ebu_tsdf(ebu->dpvr_min, ebu->dpvr_max, ebu->dpvr_first);
+  ebu->tsdf_max = PA_MAX(tsdf, ebu->tsdf_max);
+  ebu->dpvr_first = 0;
+  ebu->dpvr_avg = (float)ebu->dpvr_sum / ebu->dpvr_cnt;
+
+  switch (st_ebu_dpvr_grade(&ebu_info->pass, ebu->dpvr_max, ebu->dpvr_avg)) {
+    case ST_EBU_GRADE_NARROW:
+      ebu_result->dpvr_pass_narrow++;
+      break;
+    case ST_EBU_GRADE_WIDE:
+      ebu_result->dpvr_pass_wide++;
+      break;
+    default:
+      ebu_result->dpvr_fail++;
+      ebu->compliant = false;
+      break;
+  }
+
+  if (ebu->tsdf_max < ebu_info->pass.tsdf_max_pass) {
+    ebu_result->tsdf_pass++;
+  } else {
+    ebu_result->tsdf_fail++;
+    ebu->compliant = false;
+  }
+
+  if (ebu->compliant) ebu_result->compliance++;
+
+  ebu_result->dpvr_min = PA_MIN(ebu_result->dpvr_min, ebu->dpvr_min);
+  ebu_result->dpvr_max = PA_MAX(ebu_result->dpvr_max, ebu->dpvr_max);
+  ebu_result->tsdf_max = PA_MAX(ebu_result->tsdf_max, ebu->tsdf_max);
+}
+
+static void pa_audio_on_packet(struct pa_audio* audio, uint32_t rtp_tmstamp,
+                               uint64_t pkt_tmstamp) {
+  struct pa_audio_stat* ebu = &audio->stat;
+  struct pa_audio_info* ebu_info = &audio->info;
+  struct st_ebu_epoch epoch;
+
+  st_ebu_epoch_calc(&epoch, pkt_tmstamp, rtp_tmstamp, ebu_info->frame_time,
+                    ebu_info->frame_time_sampling);
+  double dpvr = epoch.latency / 1000;
+
+  ebu->pkt_num++;
+  if (ebu->pkt_num % ebu_info->pkts_per_result == 0) {
+    pa_audio_result(audio);
+    pa_audio_clear_stat(ebu);
+  }
+
+  /* calculate Delta Packet vs RTP */
+  ebu->dpvr_sum += dpvr;
+  ebu->dpvr_min = PA_MIN(dpvr, ebu->dpvr_min);
+  ebu->dpvr_max = PA_MAX(dpvr, ebu->dpvr_max);
+  ebu->dpvr_cnt++;
+
+  if (!ebu->dpvr_first) ebu->dpvr_first = dpvr;
+}
+
+static void pa_anc_init(struct pa_flow* flow, double ts_per_frame) {
+  struct pa_anc* anc = &flow->anc;
+  const struct pa_fps* fps = pa_fps_match(ts_per_frame);
+
+  memset(anc, 0, sizeof(*anc));
+  anc->fps = fps->name;
+  anc->frame_time_sampling = fps->sampling;
+  anc->rtp_ts_delta_min = INT_MAX;
+  anc->rtp_ts_delta_max = INT_MIN;
+}
+
+static void pa_anc_on_packet(struct pa_anc* anc, uint32_t rtp_tmstamp, int pkt_idx) {
+  anc->pkts_per_frame_max = PA_MAX(anc->pkts_per_frame_max, pkt_idx + 1);
+  if (pkt_idx) return;
+
+  anc->frames++;
+  if (anc->prev_valid) {
+    int32_t rtd = anc->frame_time_sampling;
+    int32_t delta = rtp_tmstamp - anc->prev_rtp_ts;
+
+    anc->rtp_ts_delta_min = PA_MIN(anc->rtp_ts_delta_min, delta);
+    anc->rtp_ts_delta_max = PA_MAX(anc->rtp_ts_delta_max, delta);
+    if (delta < rtd || delta > (rtd + 1)) anc->rtp_ts_delta_fail++;
+  }
+  anc->prev_rtp_ts = rtp_tmstamp;
+  anc->prev_valid = true;
+}
+
+static void pa_detect(struct pa_ctx* ctx, struct pa_flow* flow, struct pa_pkt* pkt,
+                      uint64_t ts_ns, bool new_group) {
+  struct pa_detector* det = &flow->det;
+
+  if (pkt->pl_len >= 8) {
+    det->st20_checked++;
+    if (pa_st20_check(det, pkt)) det->st20_ok++;
+  }
+  if (!new_group) return;
+  if (det->groups >= 2) /* the previous group is a complete one */
+    det->max_group_pkts = PA_MAX(det->max_group_pkts, flow->pkt_idx + 1);
+  det->groups++;
+  if (det->groups == 2) {
+    det->first_ts = pkt->tmstamp;
+    det->first_ns = ts_ns;
+  }
+  if (det->groups < PA_DETECT_GROUPS) return;
+
+  int intervals = det->groups - 2;
+  double ts_per_group = (double)(uint32_t)(pkt->tmstamp - det->first_ts) / intervals;
+  double ns_per_group = (double)(ts_ns - det->first_ns) / intervals;
+
+  if (det->max_group_pkts >= PA_DETECT_VIDEO_PKTS) {
+    /* the same st20 check pass on most of pkts */
+    if (det->st20_ok * 10 >= det->st20_checked * 9) {
+      flow->type = PA_FLOW_ST20;
+    } else {
+      flow->type = PA_FLOW_ST22;
+      det->interlaced = false;
+      /* st22 interlaced bits in the payload header */
+      if (pkt->pl_len >= 4 && ((pkt->pl[0] >> 3) & 0x3)) det->interlaced = true;
+    }
+    pa_video_init(ctx, flow, ts_per_group);
+  } else if (ns_per_group > 0 && ns_per_group < PA_DETECT_AUDIO_INTERVAL_NS) {
+    flow->type = PA_FLOW_ST30;
+    pa_audio_init(flow, ts_per_group, ns_per_group);
+  } else {
+    flow->type = PA_FLOW_ST40;
+    pa_anc_init(flow, ts_per_group);
+  }
+}
+
+static void pa_flow_on_pkt(struct pa_ctx* ctx, struct pa_flow* flow, struct pa_pkt* pkt,
+                           uint64_t ts_ns) {
+  bool new_group;
+
+  flow->pkts++;
+  flow->bytes += pkt->rtp_len;
+  if (!flow->first_ns) flow->first_ns = ts_ns;
+  flow->last_ns = ts_ns;
+  flow->payload_type = pkt->payload_type;
+
+  if (flow->seq_init) {
+    uint16_t delta = pkt->seq - flow->prev_seq;
+
+    if (!delta || delta > 0x8000) {
+      flow->seq_ooo++; /* duplicated or late pkt, keep the prev seq */
+    } else {
+      flow->seq_lost += delta - 1;
+      flow->prev_seq = pkt->seq;
+    }
+  } else {
+    flow->prev_seq = pkt->seq;
+    flow->seq_init = true;
+  }
+
+  new_group = !flow->rtp_init || (pkt->tmstamp != flow->cur_rtp_ts);
+  switch (flow->type) {
+    case PA_FLOW_UNKNOWN:
+      pa_detect(ctx, flow, pkt, ts_ns, new_group);
+      break;
+    case PA_FLOW_ST20:
+    case PA_FLOW_ST22:
+      pa_video_on_packet(&flow->video, pkt->tmstamp, ts_ns,
+                         new_group ? 0 : flow->pkt_idx + 1);
+      break;
+    case PA_FLOW_ST30:
+      pa_audio_on_packet(&flow->audio, pkt->tmstamp, ts_ns);
+      break;
+    case PA_FLOW_ST40:
+      pa_anc_on_packet(&flow->anc, pkt->tmstamp, new_group ? 0 : flow->pkt_idx + 1);
+      break;
+  }
+
+  flow->pkt_idx = new_group ? 0 : flow->pkt_idx + 1;
+  flow->cur_rtp_ts = pkt->tmstamp;
+  flow->rtp_init = true;
+}
+
+static int pa_flows_grow(struct pa_worker* w) {
+  uint32_t cap = w->flows_cap ? w->flows_cap * 2 : PA_FLOWS_INIT_CAP;
+  struct pa_flow** flows = calloc(cap, sizeof(*flows));
+
+  if (!flows) return -ENOMEM;
+  for (uint32_t i = 0; i < w->flows_cap; i++) {
+    struct pa_flow* flow = w->flows[i];
+    if (!flow) continue;
+    uint32_t pos = flow->hash & (cap - 1);
+    while (flows[pos]) pos = (pos + 1) & (cap - 1);
+    flows[pos] = flow;
+  }
+  free(w->flows);
+  w->flows = flows;
+  w->flows_cap = cap;
+  return 0;
+}
+
+static struct pa_flow* pa_flow_get(struct pa_worker* w, struct pa_pkt* pkt,
+                                   uint32_t hash) {
+  struct pa_flow* flow;
+  uint32_t pos;
+
+  if (w->flows_cap) {
+    pos = hash & (w->flows_cap - 1);
+    while ((flow = w->flows[pos])) {
+      if (flow->hash == hash && flow->dip == pkt->dip && flow->dport == pkt->dport &&
+          flow->sip == pkt->sip && flow->sport == pkt->sport)
+        return flow;
+      pos = (pos + 1) & (w->flows_cap - 1);
+    }
+  }
+
+  /* keep the load factor below 0.5 */
+  if ((w->flows_num + 1) * 2 > w->flows_cap) {
+    if (pa_flows_grow(w) < 0) return NULL;
+  }
+  flow = calloc(1, sizeof(*flow));
+  if (!flow) return NULL;
+  flow->sip = pkt->sip;
+  flow->dip = pkt->dip;
+  flow->sport = pkt->sport;
+  flow->dport = pkt->dport;
+  flow->hash = hash;
+  pos = hash & (w->flows_cap - 1);
+  while (w->flows[pos]) pos = (pos + 1) & (w->flows_cap - 1);
+  w->flows[pos] = flow;
+  w->flows_num++;
+  return flow;
+}
+
+static void pa_ring_push(struct pa_worker* w, struct pa_item* item) {
+  struct pa_ring* r = &w->ring;
+  uint32_t tail = r->tail;
+
+  while (tail - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) >= PA_RING_SIZE) {
+    w->stat_ring_full++;
+    sched_yield(); /* the worker is behind */
+  }
+  r->items[tail & (PA_RING_SIZE - 1)] = *item;
+  __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/* the reader side, parse the record and dispatch it to the worker of the flow */
+static void pa_on_pkt(struct pa_ctx* ctx, const uint8_t* data, uint32_t len,
+                      uint64_t ts_ns) {
+  struct pa_item item;
+
+  ctx->stat_records++;
+  if (!pa_parse_pkt(data, len, &item.pkt)) {
+    ctx->stat_non_rtp++;
+    return;
+  }
+
+  item.hash = pa_flow_hash(item.pkt.sip, item.pkt.dip, item.pkt.sport, item.pkt.dport);
+  item.ts_ns = ts_ns;
+  pa_ring_push(&ctx->workers[item.hash % ctx->workers_num], &item);
+}
+
+static int pa_walk_pcap(struct pa_ctx* ctx) {
+  struct pa_file* f = &ctx->file;
+  size_t off = 24;
+
+  while (off + 16 <= f->size) {
+    const uint8_t* rec = f->base + off;
+    uint32_t sec = pa_rd32(rec, f->swap);
+    uint32_t frac = pa_rd32(rec + 4, f->swap);
+    uint32_t caplen = pa_rd32(rec + 8, f->swap);
+
+    off += 16;
+    if (caplen > f->size - off) return -EIO; /* truncated */
+    pa_on_pkt(ctx, f->base + off, caplen, (uint64_t)sec * NS_PER_S + frac * f->ts_mul);
+    off += caplen;
+  }
+  return 0;
+}
+
+struct pa_ng_if {
+  bool ether;
+  uint64_t num; /* ns = ts * num / den */
+  uint64_t den;
+};
+
+static void pa_ng_parse_idb(const uint8_t* blk, uint32_t blk_len, bool swap,
+                            struct pa_ng_if* intf) {
+  uint32_t off = 16;
+
+  intf->ether = (pa_rd16(blk + 8, swap) == 1);
+  intf->num = 1000; /* default resolution is us */
+  intf->den = 1;
+
+  while (off + 4 <= blk_len - 4) {
+    uint16_t code = pa_rd16(blk + off, swap);
+    uint16_t len = pa_rd16(blk + off + 2, swap);
+
+    if (!code || off + 4 + len > blk_len - 4) break;
+    if (code == 9 && len >= 1) { /* if_tsresol */
+      uint8_t v = blk[off + 4];
+      if (v & 0x80) {
+        intf->num = NS_PER_S;
+        intf->den = 1ULL << PA_MIN(v & 0x7f, 63);
+      } else {
+        intf->num = 1;
+        intf->den = 1;
+        for (int i = v; i < 9; i++) intf->num *= 10;
+        for (int i = 9; i < v && i < 27; i++) intf->den *= 10;
+      }
+    }
+    off += 4 + ((len + 3) & ~3);
+  }
+}
+
+static int pa_walk_pcapng(struct pa_ctx* ctx) {
+  struct pa_file* f = &ctx->file;
+  struct pa_ng_if ifs[PA_NG_IF_MAX];
+  int if_num = 0;
+  bool swap = false;
+  size_t off = 0;
+
+  while (off + 12 <= f->size) {
+    const uint8_t* blk = f->base + off;
+    uint32_t type = pa_rd32(blk, false);
+    uint32_t blk_len;
+
+    if (type == 0x0a0d0d0a) { /* section header, endian may change */
+      uint32_t magic = pa_rd32(blk + 8, false);
+      if (magic == 0x1a2b3c4d)
+        swap = false;
+      else if (magic == 0x4d3c2b1a)
+        swap = true;
+      else
+        return -EIO;
+      if_num = 0;
+    } else {
+      type = pa_rd32(blk, swap);
+    }
+    blk_len = pa_rd32(blk + 4, swap);
+    if (blk_len < 12 || (blk_len & 3) || blk_len > f->size - off) return -EIO;
+
+    if (type == 1) { /* interface description */
+      if (if_num < PA_NG_IF_MAX && blk_len >= 20) {
+        pa_ng_parse_idb(blk, blk_len, swap, &ifs[if_num]);
+        if_num++;
+      }
+    } else if (type == 6 && blk_len >= 32) { /* enhanced packet */
+      int if_id = pa_rd32(blk + 8, swap);
+      uint64_t ts = (uint64_t)pa_rd32(blk + 12, swap) << 32 | pa_rd32(blk + 16, swap);
+      uint32_t caplen = pa_rd32(blk + 20, swap);
+
+      if (if_id >= 0 && if_id < if_num && ifs[if_id].ether && caplen <= blk_len - 32) {
+        uint64_t ns = (unsigned __int128)ts * ifs[if_id].num / ifs[if_id].den;
+        pa_on_pkt(ctx, blk + 28, caplen, ns);
+      }
+    }
+    off += blk_len;
+  }
+  return 0;
+}
+
+static void pa_worker_on_item(struct pa_worker* w, struct pa_item* item) {
+  struct pa_flow* flow;
+
+  if (w->ret < 0) return; /* keep draining so the reader never blocks */
+  flow = pa_flow_get(w, &item->pkt, item->hash);
+  if (!flow) {
+    w->ret = -ENOMEM;
+    return;
+  }
+  pa_flow_on_pkt(w->ctx, flow, &item->pkt, item->ts_ns);
+}
+
+static void* pa_worker_thread(void* arg) {
+  struct pa_worker* w = arg;
+  struct pa_ring* r = &w->ring;
+  uint32_t head = r->head;
+
+  while (true) {
+    uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+      /* the tail is final once the reader is done */
+      if (__atomic_load_n(&w->ctx->read_done, __ATOMIC_ACQUIRE) &&
+          (__atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) == head))
+        break;
+      sched_yield();
+      continue;
+    }
+    while (head != tail) {
+      pa_worker_on_item(w, &r->items[head & (PA_RING_SIZE - 1)]);
+      head++;
+    }
+    __atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+  }
+
+  return NULL;
+}
+
+/* the reader, run on the main thread */
+static int pa_read(struct pa_ctx* ctx) {
+  int ret;
+
+  if (ctx->file.fmt == PA_FMT_PCAPNG)
+    ret = pa_walk_pcapng(ctx);
+  else
+    ret = pa_walk_pcap(ctx);
+  if (ret == -EIO) {
+    printf("warn: capture truncated or corrupted, stop at last record\n");
+    ret = 0;
+  }
+  __atomic_store_n(&ctx->read_done, true, __ATOMIC_RELEASE);
+  return ret;
+}
+
+static int pa_file_open(struct pa_file* f, const char* path) {
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    printf("open %s fail %s\n", path, strerror(errno));
+    return -EIO;
+  }
+  if (fstat(fd, &st) < 0 || st.st_size < 24) {
+    printf("%s is not a valid capture\n", path);
+    close(fd);
+    return -EIO;
+  }
+  f->size = st.st_size;
+  f->base = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (f->base == MAP_FAILED) {
+    printf("mmap %s fail %s\n", path, strerror(errno));
+    return -EIO;
+  }
+  madvise((void*)f->base, f->size, MADV_SEQUENTIAL);
+
+  uint32_t magic = pa_rd32(f->base, false);
+  switch (magic) {
+    case 0xa1b2c3d4:
+      f->ts_mul = 1000;
+      break;
+    case 0xa1b23c4d:
+      f->ts_mul = 1;
+      break;
+    case 0xd4c3b2a1:
+      f->swap = true;
+      f->ts_mul = 1000;
+      break;
+    case 0x4d3cb2a1:
+      f->swap = true;
+      f->ts_mul = 1;
+      break;
+    case 0x0a0d0d0a:
+      f->fmt = PA_FMT_PCAPNG;
+      return 0;
+    default:
+      printf("%s unknown capture format, magic 0x%08x\n", path, magic);
+      munmap((void*)f->base, f->size);
+      return -EINVAL;
+  }
+  f->fmt = PA_FMT_PCAP;
+  f->linktype = pa_rd32(f->base + 20, f->swap) & 0xffff;
+  if (f->linktype != 1) {
+    printf("%s linktype %u not supported, only ethernet\n", path, f->linktype);
+    munmap((void*)f->base, f->size);
+    return -EINVAL;
+  }
+  return 0;
+}
+
+static int pa_flow_cmp(const void* a, const void* b) {
+  const struct pa_flow* fa = *(struct pa_flow* const*)a;
+  const struct pa_flow* fb = *(struct pa_flow* const*)b;
+
+  if (fa->dip != fb->dip) return fa->dip < fb->dip ? -1 : 1;
+  if (fa->dport != fb->dport) return fa->dport < fb->dport ? -1 : 1;
+  if (fa->sip != fb->sip) return fa->sip < fb->sip ? -1 : 1;
+  if (fa->sport != fb->sport) return fa->sport < fb->sport ? -1 : 1;
+  return 0;
+}
+
+static inline double pa_rate(int num, int pass) {
+  return num ? (double)pass * 100 / num : 0;
+}
+
+static void pa_video_report(struct pa_video* video) {
+  struct pa_video_info* info = &video->info;
+  struct pa_video_result* r = &video->result;
+  int n = r->ebu_result_num;
+
+  printf("  %dp%s%s, pkt_per_frame %d, trs %.2fns, tr_offset %.2fns\n", info->height,
+         info->fps, info->interlaced ? " interlaced" : "", info->pkt_per_frame,
+         info->pass.trs, info->pass.tr_offset);
+  printf("  cmax_narrow %u cmax_wide %u vrx_full_narrow %u vrx_full_wide %u "
+         "rtp_offset_max %u\n",
+         info->pass.c_max_narrow_pass, info->pass.c_max_wide_pass,
+         info->pass.vrx_full_narrow_pass, info->pass.vrx_full_wide_pass,
+         info->pass.rtp_offset_max_pass);
+  if (!n) {
+    printf("  not enough frames for a result\n");
+    return;
+  }
+  printf("  [ --- Total %d ---  Compliance Rate Narrow %.2f%%  Wide %.2f%% ] %s\n", n,
+         pa_rate(n, r->compliance_narrow),
+         pa_rate(n, r->compliance - r->compliance_narrow),
+         r->compliance_narrow == n
+             ? ST_EBU_PASS_NARROW
+             : (r->compliance == n ? ST_EBU_PASS_WIDE : ST_EBU_FAIL));
+  printf("  [ Cinst ]\t| Narrow %.2f%% | Wide %.2f%% | Fail %.2f%% | MAX %d\n",
+         pa_rate(n, r->cinst_pass_narrow), pa_rate(n, r->cinst_pass_wide),
+         pa_rate(n, r->cinst_fail), r->cinst_max);
+  printf("  [ VRX ]\t| Narrow %.2f%% | Wide %.2f%% | Fail %.2f%% | MIN %d MAX %d\n",
+         pa_rate(n, r->vrx_pass_narrow), pa_rate(n, r->vrx_pass_wide),
+         pa_rate(n, r->vrx_fail), r->vrx_min, r->vrx_max);
+  printf("  [ FPT ]\t| Pass %.2f%% | Fail %.2f%% | MAX %d\n", pa_rate(n, r->fpt_pass),
+         pa_rate(n, r->fpt_fail), r->fpt_max);
+  printf("  [ Latency ]\t| Pass %.2f%% | Fail %.2f%% | MIN %d MAX %d\n",
+         pa_rate(n, r->latency_pass), pa_rate(n, r->latency_fail), r->latency_min,
+         r->latency_max);
+  printf("  [ RTP Offset ]\t| Pass %.2f%% | Fail %.2f%% | MIN %d MAX %d\n",
+         pa_rate(n, r->rtp_offset_pass), pa_rate(n, r->rtp_offset_fail),
+         r->rtp_offset_min, r->rtp_offset_max);
+  printf("  [ RTP TS Delta ]\t| Pass %.2f%% | Fail %.2f%% | MIN %d MAX %d\n",
+         pa_rate(n, r->rtp_ts_delta_pass), pa_rate(n, r->rtp_ts_delta_fail),
+         r->rtp_ts_delta_min, r->rtp_ts_delta_max);
+  printf("  [ Inter-packet time(ns) ]\t| MIN %d MAX %d\n", r->rtp_ipt_min,
+         r->rtp_ipt_max);
+}
+
+static void pa_audio_report(struct pa_audio* audio) {
+  struct pa_audio_info* info = &audio->info;
+  struct pa_audio_result* r = &audio->result;
+  int n = r->ebu_result_num;
+
+  printf("  %dhz, ptime %.2fus, %d samples per pkt\n", info->clock_rate,
+         info->frame_time / 1000, (int)info->frame_time_sampling);
+  if (!n) {
+    printf("  not enough pkts for a result\n");
+    return;
+  }
+  printf("  [ --- Total %d ---  Compliance Rate %.2f%% ] %s\n", n,
+         pa_rate(n, r->compliance), r->compliance == n ? ST_EBU_PASS : ST_EBU_FAIL);
+  printf("  [ Delta Packet vs RTP ]\t| Narrow %.2f%% | Wide %.2f%% | Fail %.2f%% | "
+         "MIN %" PRId64 "us MAX %" PRId64 "us\n",
+         pa_rate(n, r->dpvr_pass_narrow), pa_rate(n, r->dpvr_pass_wide),
+         pa_rate(n, r->dpvr_fail), r->dpvr_min, r->dpvr_max);
+  printf("  [ Maximum Timestamped Delay Factor ]\t| Pass %.2f%% | Fail %.2f%% | "
+         "MAX %" PRId64 "us\n",
+         pa_rate(n, r->tsdf_pass), pa_rate(n, r->tsdf_fail), r->tsdf_max);
+}
+
+static void pa_anc_report(struct pa_anc* anc) {
+  printf("  %s fps, %" PRIu64 " frames, max %d pkts per frame\n", anc->fps, anc->frames,
+         anc->pkts_per_frame_max);
+  if (anc->frames < 2) return;
+  printf("  [ RTP TS Delta ]\t| Fail %" PRIu64 " | MIN %d MAX %d | %s\n",
+         anc->rtp_ts_delta_fail, anc->rtp_ts_delta_min, anc->rtp_ts_delta_max,
+         anc->rtp_ts_delta_fail ? ST_EBU_FAIL : ST_EBU_PASS);
+}
+
+static void pa_flow_report(int idx, struct pa_flow* flow) {
+  char sip[16], dip[16];
+  double duration_s = (double)(flow->last_ns - flow->first_ns) / NS_PER_S;
+
+  /* the trailing partial result */
+  if (flow->type == PA_FLOW_ST20 || flow->type == PA_FLOW_ST22)
+    pa_video_result(&flow->video);
+  else if (flow->type == PA_FLOW_ST30)
+    pa_audio_result(&flow->audio);
+
+  printf("flow %d: %s %s:%u <- %s:%u pt %u, pkts %" PRIu64 ", %.2fs, %.2fMb/s, "
+         "seq lost %" PRIu64 " ooo %" PRIu64 "\n",
+         idx, pa_flow_type_names[flow->type], pa_ip_str(flow->dip, dip, sizeof(dip)),
+         flow->dport, pa_ip_str(flow->sip, sip, sizeof(sip)), flow->sport,
+         flow->payload_type, flow->pkts, duration_s,
+         duration_s > 0 ? flow->bytes * 8 / duration_s / 1000 / 1000 : 0,
+         flow->seq_lost, flow->seq_ooo);
+  switch (flow->type) {
+    case PA_FLOW_ST20:
+    case PA_FLOW_ST22:
+      pa_video_report(&flow->video);
+      break;
+    case PA_FLOW_ST30:
+      pa_audio_report(&flow->audio);
+      break;
+    case PA_FLOW_ST40:
+      pa_anc_report(&flow->anc);
+      break;
+    default:
+      printf("  not enough pkts to detect the flow type\n");
+      break;
+  }
+}
+
+static void pa_usage(const char* app) {
+  printf("Usage: %s [-t threads] [-H height] <capture.pcap|capture.pcapng>\n", app);
+  printf("  -t threads: worker threads, default is the number of online cpus\n");
+  printf("  -H height: video height used for the tr offset, default auto detect\n");
+}
+
+int main(int argc, char** argv) {
+  static struct pa_ctx ctx;
+  struct pa_flow** flows;
+  uint32_t flows_num = 0;
+  uint64_t ring_full = 0;
+  int opt, ret = 0;
+
+  ctx.workers_num = sysconf(_SC_NPROCESSORS_ONLN);
+  while ((opt = getopt(argc, argv, "t:H:h")) != -1) {
+    switch (opt) {
+      case 't':
+        ctx.workers_num = atoi(optarg);
+        break;
+      case 'H':
+        ctx.height = atoi(optarg);
+        break;
+      default:
+        pa_usage(argv[0]);
+        return opt == 'h' ? 0 : -EINVAL;
+    }
+  }
+  if (optind >= argc) {
+    pa_usage(argv[0]);
+    return -EINVAL;
+  }
+  ctx.workers_num = PA_MAX(1, PA_MIN(ctx.workers_num, PA_WORKERS_MAX));
+
+  ret = pa_file_open(&ctx.file, argv[optind]);
+  if (ret < 0) return ret;
+
+  for (int i = 0; i < ctx.workers_num; i++) {
+    struct pa_worker* w = &ctx.workers[i];
+    w->idx = i;
+    w->ctx = &ctx;
+    w->ring.items = calloc(PA_RING_SIZE, sizeof(*w->ring.items));
+    if (!w->ring.items) {
+      printf("alloc ring %d fail\n", i);
+      ctx.workers_num = i;
+      break;
+    }
+    ret = pthread_create(&w->tid, NULL, pa_worker_thread, w);
+    if (ret) {
+      printf("create worker %d fail %d\n", i, ret);
+      free(w->ring.items);
+      ctx.workers_num = i;
+      break;
+    }
+  }
+  if (!ctx.workers_num) {
+    munmap((void*)ctx.file.base, ctx.file.size);
+    return -ENOMEM;
+  }
+  ret = pa_read(&ctx);
+  for (int i = 0; i < ctx.workers_num; i++) {
+    pthread_join(ctx.workers[i].tid, NULL);
+    if (ctx.workers[i].ret < 0) ret = ctx.workers[i].ret;
+    flows_num += ctx.workers[i].flows_num;
+    ring_full += ctx.workers[i].stat_ring_full;
+  }
+  if (ret) printf("analyze fail %d, the report may be incomplete\n", ret);
+
+  printf("%s: %s, %" PRIu64 " records, %" PRIu64 " non rtp, %u flows, %d workers\n",
+         argv[optind], ctx.file.fmt == PA_FMT_PCAPNG ? "pcapng" : "pcap",
+         ctx.stat_records, ctx.stat_non_rtp, flows_num, ctx.workers_num);
+  if (ring_full)
+    printf("the reader waited %" PRIu64 " times on the full worker rings\n", ring_full);
+
+  flows = calloc(flows_num ? flows_num : 1, sizeof(*flows));
+  if (flows) {
+    uint32_t n = 0;
+    for (int i = 0; i < ctx.workers_num; i++) {
+      struct pa_worker* w = &ctx.workers[i];
+      for (uint32_t j = 0; j < w->flows_cap; j++) {
+        if (w->flows[j]) flows[n++] = w->flows[j];
+      }
+    }
+    qsort(flows, n, sizeof(*flows), pa_flow_cmp);
+    for (uint32_t i = 0; i < n; i++) pa_flow_report(i, flows[i]);
+    free(flows);
+  }
+
+  for (int i = 0; i < ctx.workers_num; i++) {
+    struct pa_worker* w = &ctx.workers[i];
+    for (uint32_t j = 0; j < w->flows_cap; j++) free(w->flows[j]);
+    free(w->flows);
+    free(w->ring.items);
+  }
+  munmap((void*)ctx.file.base, ctx.file.size);
+  return ret;
+}